@@ -0,0 +1,96 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for Descriptors.c.
+ */
+
+#ifndef _DESCRIPTORS_H_
+#define _DESCRIPTORS_H_
+
+	/* Includes: */
+		#include <LUFA/Drivers/USB/USB.h>
+
+	/* Macros: */
+		/** Endpoint address of the Audio isochronous streaming data OUT endpoint. */
+		#define AUDIO_STREAM_OUT_EPADDR       (ENDPOINT_DIR_OUT | 1)
+
+		/** Endpoint address of the Audio isochronous rate feedback IN endpoint. */
+		#define AUDIO_FEEDBACK_EPADDR         (ENDPOINT_DIR_IN  | 2)
+
+		/** Endpoint address of the Audio isochronous streaming data IN endpoint. */
+		#define AUDIO_STREAM_IN_EPADDR        (ENDPOINT_DIR_IN  | 3)
+
+		/** Endpoint size in bytes of the Audio isochronous streaming data endpoints. */
+		#define AUDIO_STREAM_EPSIZE           64
+
+		/** Endpoint size in bytes of the Audio isochronous rate feedback endpoint. */
+		#define AUDIO_FEEDBACK_EPSIZE         3
+
+		/** Refresh period exponent of the Audio isochronous rate feedback endpoint, giving a 2^5 = 32ms period. */
+		#define AUDIO_FEEDBACK_REFRESH        5
+
+	/* Type Defines: */
+		/** Type define for the device configuration descriptor structure. This must be defined in the
+		 *  application code, as the configuration descriptor contains several sub-descriptors which
+		 *  vary between devices, and which describe the device's usage to the host.
+		 */
+		typedef struct
+		{
+			USB_Descriptor_Configuration_Header_t     Config;
+
+			// Audio Control Interface
+			USB_Descriptor_Interface_t                Audio_ControlInterface;
+			USB_Audio_Descriptor_Interface_AC_t       Audio_ControlInterface_SPC;
+			USB_Audio_Descriptor_InputTerminal_t      Audio_InputTerminal;
+			USB_Audio_Descriptor_OutputTerminal_t     Audio_OutputTerminal;
+
+			// Audio Streaming Interface
+			USB_Descriptor_Interface_t                Audio_StreamInterface_Alt0;
+			USB_Descriptor_Interface_t                Audio_StreamInterface_Alt1;
+			USB_Audio_Descriptor_Interface_AS_t       Audio_StreamInterface_SPC;
+			USB_Audio_Descriptor_Format_t             Audio_AudioFormat;
+			USB_Audio_SampleFreq_t                    Audio_AudioFormatSampleRates[1];
+			USB_Audio_Descriptor_StreamEndpoint_Std_t Audio_StreamOUTEndpoint;
+			USB_Audio_Descriptor_StreamEndpoint_Spc_t Audio_StreamOUTEndpoint_SPC;
+			USB_Audio_Descriptor_StreamEndpoint_Std_t Audio_FeedbackEndpoint;
+			USB_Audio_Descriptor_StreamEndpoint_Std_t Audio_StreamINEndpoint;
+			USB_Audio_Descriptor_StreamEndpoint_Spc_t Audio_StreamINEndpoint_SPC;
+		} USB_Descriptor_Configuration_t;
+
+	/* Function Prototypes: */
+		uint16_t CALLBACK_USB_GetDescriptor(const uint16_t wValue,
+		                                    const uint8_t wIndex,
+		                                    const void** const DescriptorAddress)
+		                                    ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(3);
+
+#endif
+
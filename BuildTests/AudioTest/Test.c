@@ -0,0 +1,452 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Functional test of the Audio class driver's packet and rate feedback functions, run on the simulated HOSTSIM USB
+ *  controller. The virtual host enables the streaming interface, then sends 8, 16 and 24-bit sample packets to the
+ *  device and checks the samples unpacked by the driver, including the sign extension of 24-bit samples and the
+ *  truncation of packets larger than the application's buffer. The device then packs samples of each width into
+ *  packets for the host. Finally Start Of Frame events are raised alongside a known sample count to check the 10.14
+ *  fixed point rate measured by the driver and sent to the host through the feedback endpoint.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Descriptors.h"
+
+#include <LUFA/Drivers/USB/USB.h>
+
+/** Nominal sampling frequency of the simulated stream, in Hz. */
+#define TEST_SAMPLE_RATE               48000
+
+/** Number of samples counted over one refresh period of the rate measurement, slightly slower than the nominal rate. */
+#define TEST_PERIOD_SAMPLES            1411
+
+/** Frame number at which the first rate measurement starts, so that the period wraps the 11-bit frame number. */
+#define TEST_PERIOD_START_FRAME        2040
+
+/** Refresh period exponent given to the driver beyond the full speed maximum, to check that it is clamped. */
+#define TEST_INVALID_REFRESH           12
+
+/** Number of elements in the given array. */
+#define ARRAY_LENGTH(Array)            (sizeof(Array) / sizeof(Array[0]))
+
+/** LUFA Audio Class driver interface configuration and state information. */
+static USB_ClassInfo_Audio_Device_t Test_Audio_Interface =
+	{
+		.Config =
+			{
+				.ControlInterfaceNumber   = 0,
+				.StreamingInterfaceNumber = 1,
+				.DataINEndpoint           =
+					{
+						.Address          = AUDIO_STREAM_IN_EPADDR,
+						.Size             = AUDIO_STREAM_EPSIZE,
+						.Banks            = 1,
+					},
+				.DataOUTEndpoint          =
+					{
+						.Address          = AUDIO_STREAM_OUT_EPADDR,
+						.Size             = AUDIO_STREAM_EPSIZE,
+						.Banks            = 1,
+					},
+				.FeedbackEndpoint         =
+					{
+						.Address          = AUDIO_FEEDBACK_EPADDR,
+						.Size             = AUDIO_FEEDBACK_EPSIZE,
+						.Banks            = 1,
+					},
+				.FeedbackRefresh          = AUDIO_FEEDBACK_REFRESH,
+			},
+	};
+
+/** Selects the given alternate setting of the streaming interface, enabling or disabling the stream. */
+static bool Host_SetStreamInterface(const uint8_t AlternateSetting)
+{
+	USB_Request_Header_t Request =
+		{
+			.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_STANDARD | REQREC_INTERFACE),
+			.bRequest      = REQ_SetInterface,
+			.wValue        = AlternateSetting,
+			.wIndex        = Test_Audio_Interface.Config.StreamingInterfaceNumber,
+			.wLength       = 0,
+		};
+
+	return (USB_VirtualHost_ControlRequest(&Request, NULL) == VHOST_CONTROL_NoError);
+}
+
+/** Advances the simulated bus by the given number of frames, counting the given number of samples in each. */
+static void Host_AdvanceFrames(const uint16_t TotalFrames,
+                               const uint32_t TotalSamples)
+{
+	uint32_t CountedSamples = 0;
+
+	for (uint16_t Frame = 1; Frame <= TotalFrames; Frame++)
+	{
+		/* Spread the samples evenly over the frames, as a sample clock ISR would count them */
+		uint32_t FrameSamples = ((TotalSamples * Frame) / TotalFrames);
+
+		Audio_Device_CountSamples(&Test_Audio_Interface, (uint8_t)(FrameSamples - CountedSamples));
+		CountedSamples = FrameSamples;
+
+		USB_VirtualHost_StartOfFrame();
+	}
+}
+
+/** Advances the simulated bus by the given number of frames with the device's Start Of Frame events disabled. */
+static void Host_SkipFrames(const uint16_t TotalFrames)
+{
+	USB_Device_DisableSOFEvents();
+
+	for (uint16_t Frame = 0; Frame < TotalFrames; Frame++)
+	  USB_VirtualHost_StartOfFrame();
+
+	USB_Device_EnableSOFEvents();
+}
+
+/** Runs the device's Audio task, and checks the feedback value received by the host against the expected value. */
+static bool Host_CheckFeedback(const uint32_t ExpectedValue)
+{
+	uint8_t  Feedback[AUDIO_FEEDBACK_EPSIZE + 1];
+	uint16_t FeedbackLength = sizeof(Feedback);
+
+	Audio_Device_USBTask(&Test_Audio_Interface);
+
+	if (!(USB_VirtualHost_ReceiveIN(AUDIO_FEEDBACK_EPADDR, Feedback, &FeedbackLength)))
+	{
+		printf("No feedback packet was sent for an expected value of 0x%06lX.\n", (unsigned long)ExpectedValue);
+		return false;
+	}
+
+	uint32_t FeedbackValue = (Feedback[0] | ((uint32_t)Feedback[1] << 8) | ((uint32_t)Feedback[2] << 16));
+
+	if ((FeedbackLength != AUDIO_FEEDBACK_EPSIZE) || (FeedbackValue != ExpectedValue))
+	{
+		printf("Feedback packet of %u bytes had value 0x%06lX, expected 0x%06lX.\n", FeedbackLength,
+		       (unsigned long)FeedbackValue, (unsigned long)ExpectedValue);
+		return false;
+	}
+
+	return true;
+}
+
+/** Tests the unpacking of received 8, 16 and 24-bit sample packets, and the truncation of oversized packets. */
+static bool Test_ReadPackets(void)
+{
+	static const uint8_t Packet8[]  = {0x01, 0x7F, 0x80, 0xFF};
+	static const int8_t  Expected8[] = {1, 127, -128, -1};
+
+	static const uint8_t Packet16[]  = {0x34, 0x12, 0xFE, 0xFF, 0xFF, 0x7F, 0x00, 0x80, 0x00, 0x00, 0xCD, 0xAB};
+	static const int16_t Expected16[] = {0x1234, -2, 32767, -32768, 0, (int16_t)0xABCD};
+
+	/* Includes a trailing partial sample, which must be ignored */
+	static const uint8_t Packet24[]  = {0xFF, 0xFF, 0x7F, 0x00, 0x00, 0x80, 0xFF, 0xFF, 0xFF, 0x56, 0x34, 0x12, 0xAA};
+	static const int32_t Expected24[] = {8388607, -8388608, -1, 0x123456};
+
+	int8_t   Samples8[ARRAY_LENGTH(Expected8) + 1];
+	int16_t  Samples16[ARRAY_LENGTH(Expected16) + 1];
+	int32_t  Samples24[ARRAY_LENGTH(Expected24) + 1];
+	uint16_t TotalSamples;
+
+	if (Audio_Device_ReadPacket16(&Test_Audio_Interface, Samples16, ARRAY_LENGTH(Samples16)))
+	{
+		printf("Samples were read before any packet was sent.\n");
+		return false;
+	}
+
+	USB_VirtualHost_SendOUT(AUDIO_STREAM_OUT_EPADDR, Packet8, sizeof(Packet8));
+	TotalSamples = Audio_Device_ReadPacket8(&Test_Audio_Interface, Samples8, ARRAY_LENGTH(Samples8));
+
+	if ((TotalSamples != ARRAY_LENGTH(Expected8)) || memcmp(Samples8, Expected8, sizeof(Expected8)))
+	{
+		printf("8-bit packet was unpacked incorrectly (%u samples).\n", TotalSamples);
+		return false;
+	}
+
+	USB_VirtualHost_SendOUT(AUDIO_STREAM_OUT_EPADDR, Packet16, sizeof(Packet16));
+	TotalSamples = Audio_Device_ReadPacket16(&Test_Audio_Interface, Samples16, ARRAY_LENGTH(Samples16));
+
+	if ((TotalSamples != ARRAY_LENGTH(Expected16)) || memcmp(Samples16, Expected16, sizeof(Expected16)))
+	{
+		printf("16-bit packet was unpacked incorrectly (%u samples).\n", TotalSamples);
+		return false;
+	}
+
+	USB_VirtualHost_SendOUT(AUDIO_STREAM_OUT_EPADDR, Packet24, sizeof(Packet24));
+	TotalSamples = Audio_Device_ReadPacket24(&Test_Audio_Interface, Samples24, ARRAY_LENGTH(Samples24));
+
+	if ((TotalSamples != ARRAY_LENGTH(Expected24)) || memcmp(Samples24, Expected24, sizeof(Expected24)))
+	{
+		printf("24-bit packet was unpacked incorrectly (%u samples).\n", TotalSamples);
+		return false;
+	}
+
+	/* Samples beyond the application's buffer must be discarded along with the rest of the packet */
+	USB_VirtualHost_SendOUT(AUDIO_STREAM_OUT_EPADDR, Packet16, sizeof(Packet16));
+	TotalSamples = Audio_Device_ReadPacket16(&Test_Audio_Interface, Samples16, 2);
+
+	if ((TotalSamples != 2) || memcmp(Samples16, Expected16, (2 * sizeof(int16_t))) ||
+	    Audio_Device_ReadPacket16(&Test_Audio_Interface, Samples16, ARRAY_LENGTH(Samples16)))
+	{
+		printf("Truncated 16-bit packet was not read and discarded correctly (%u samples).\n", TotalSamples);
+		return false;
+	}
+
+	return true;
+}
+
+/** Tests the packing of sent 8, 16 and 24-bit sample packets, and the limiting of each packet to the endpoint size. */
+static bool Test_WritePackets(void)
+{
+	static const int8_t  Samples8[]  = {1, 127, -128, -1};
+	static const uint8_t Expected8[] = {0x01, 0x7F, 0x80, 0xFF};
+
+	static const int16_t Samples16[]  = {0x1234, -2, 32767, -32768};
+	static const uint8_t Expected16[] = {0x34, 0x12, 0xFE, 0xFF, 0xFF, 0x7F, 0x00, 0x80};
+
+	static const int32_t Samples24[]  = {8388607, -8388608, -1, 0x123456};
+	static const uint8_t Expected24[] = {0xFF, 0xFF, 0x7F, 0x00, 0x00, 0x80, 0xFF, 0xFF, 0xFF, 0x56, 0x34, 0x12};
+
+	int32_t  LongSamples[AUDIO_STREAM_EPSIZE / 3 + 2];
+	uint8_t  Packet[AUDIO_STREAM_EPSIZE + 1];
+	uint16_t PacketLength;
+	uint16_t TotalSamples;
+
+	TotalSamples = Audio_Device_WritePacket8(&Test_Audio_Interface, Samples8, ARRAY_LENGTH(Samples8));
+	PacketLength = sizeof(Packet);
+
+	if ((TotalSamples != ARRAY_LENGTH(Samples8)) ||
+	    !(USB_VirtualHost_ReceiveIN(AUDIO_STREAM_IN_EPADDR, Packet, &PacketLength)) ||
+	    (PacketLength != sizeof(Expected8)) || memcmp(Packet, Expected8, sizeof(Expected8)))
+	{
+		printf("8-bit packet was packed incorrectly (%u samples, %u bytes).\n", TotalSamples, PacketLength);
+		return false;
+	}
+
+	TotalSamples = Audio_Device_WritePacket16(&Test_Audio_Interface, Samples16, ARRAY_LENGTH(Samples16));
+	PacketLength = sizeof(Packet);
+
+	if ((TotalSamples != ARRAY_LENGTH(Samples16)) ||
+	    !(USB_VirtualHost_ReceiveIN(AUDIO_STREAM_IN_EPADDR, Packet, &PacketLength)) ||
+	    (PacketLength != sizeof(Expected16)) || memcmp(Packet, Expected16, sizeof(Expected16)))
+	{
+		printf("16-bit packet was packed incorrectly (%u samples, %u bytes).\n", TotalSamples, PacketLength);
+		return false;
+	}
+
+	TotalSamples = Audio_Device_WritePacket24(&Test_Audio_Interface, Samples24, ARRAY_LENGTH(Samples24));
+	PacketLength = sizeof(Packet);
+
+	if ((TotalSamples != ARRAY_LENGTH(Samples24)) ||
+	    !(USB_VirtualHost_ReceiveIN(AUDIO_STREAM_IN_EPADDR, Packet, &PacketLength)) ||
+	    (PacketLength != sizeof(Expected24)) || memcmp(Packet, Expected24, sizeof(Expected24)))
+	{
+		printf("24-bit packet was packed incorrectly (%u samples, %u bytes).\n", TotalSamples, PacketLength);
+		return false;
+	}
+
+	/* Only as many whole samples as fit into the endpoint may be sent in a single packet */
+	for (uint8_t i = 0; i < ARRAY_LENGTH(LongSamples); i++)
+	  LongSamples[i] = (int32_t)(i * 0x010203L);
+
+	TotalSamples = Audio_Device_WritePacket24(&Test_Audio_Interface, LongSamples, ARRAY_LENGTH(LongSamples));
+	PacketLength = sizeof(Packet);
+
+	if ((TotalSamples != (AUDIO_STREAM_EPSIZE / 3)) ||
+	    !(USB_VirtualHost_ReceiveIN(AUDIO_STREAM_IN_EPADDR, Packet, &PacketLength)) ||
+	    (PacketLength != (TotalSamples * 3)) || (Packet[PacketLength - 1] != (uint8_t)(LongSamples[TotalSamples - 1] >> 16)))
+	{
+		printf("Oversized 24-bit write was not limited to the endpoint (%u samples, %u bytes).\n", TotalSamples, PacketLength);
+		return false;
+	}
+
+	/* No samples may be written while the previous packet is still waiting to be sent to the host */
+	Audio_Device_WritePacket8(&Test_Audio_Interface, Samples8, ARRAY_LENGTH(Samples8));
+
+	if (Audio_Device_WritePacket8(&Test_Audio_Interface, Samples8, ARRAY_LENGTH(Samples8)))
+	{
+		printf("Samples were written while the IN endpoint was busy.\n");
+		return false;
+	}
+
+	PacketLength = sizeof(Packet);
+	USB_VirtualHost_ReceiveIN(AUDIO_STREAM_IN_EPADDR, Packet, &PacketLength);
+
+	return true;
+}
+
+/** Tests the 10.14 fixed point stream rate measured from the counted samples and sent through the feedback endpoint. */
+static bool Test_Feedback(void)
+{
+	uint8_t  Feedback[AUDIO_FEEDBACK_EPSIZE];
+	uint16_t FeedbackLength = sizeof(Feedback);
+
+	/* Nothing may be sent until a rate is known */
+	Audio_Device_USBTask(&Test_Audio_Interface);
+
+	if (USB_VirtualHost_ReceiveIN(AUDIO_FEEDBACK_EPADDR, Feedback, &FeedbackLength))
+	{
+		printf("Feedback was sent before any rate was known.\n");
+		return false;
+	}
+
+	Audio_Device_SetNominalSampleRate(&Test_Audio_Interface, TEST_SAMPLE_RATE);
+
+	if (!(Host_CheckFeedback((uint32_t)TEST_SAMPLE_RATE * 16384 / 1000)))
+	  return false;
+
+	/* Start the measurement a few frames before the frame number wraps */
+	Host_SkipFrames((TEST_PERIOD_START_FRAME - USB_Device_GetFrameNumber()) & 0x07FF);
+	USB_VirtualHost_StartOfFrame();
+
+	/* The nominal rate must be kept until a full refresh period has elapsed */
+	Host_AdvanceFrames((1 << AUDIO_FEEDBACK_REFRESH) - 1, TEST_PERIOD_SAMPLES - 44);
+
+	if (!(Host_CheckFeedback((uint32_t)TEST_SAMPLE_RATE * 16384 / 1000)))
+	  return false;
+
+	Host_AdvanceFrames(1, 44);
+
+	if (!(Host_CheckFeedback(((uint32_t)TEST_PERIOD_SAMPLES << 14) >> AUDIO_FEEDBACK_REFRESH)))
+	  return false;
+
+	/* Missed Start Of Frame events must be accounted for by the frame number when the period completes */
+	Host_AdvanceFrames(20, 1000);
+	Host_SkipFrames(19);
+	Host_AdvanceFrames(1, 200);
+
+	if (!(Host_CheckFeedback((1200UL << 14) / 40)))
+	  return false;
+
+	/* A period which overran past twice the refresh period must be discarded */
+	Host_AdvanceFrames(10, 100);
+	Host_SkipFrames(60);
+	Host_AdvanceFrames(1, 0);
+
+	if (!(Host_CheckFeedback((1200UL << 14) / 40)))
+	  return false;
+
+	/* The refresh period must be clamped to the full speed range when the endpoints are configured */
+	Test_Audio_Interface.Config.FeedbackRefresh = TEST_INVALID_REFRESH;
+
+	if ((USB_VirtualHost_Enumerate(1) != VHOST_CONTROL_NoError) || !(Host_SetStreamInterface(1)) ||
+	    (Test_Audio_Interface.Config.FeedbackRefresh != 9))
+	{
+		printf("Feedback refresh exponent %d was not clamped to 9.\n", TEST_INVALID_REFRESH);
+		return false;
+	}
+
+	Audio_Device_SetNominalSampleRate(&Test_Audio_Interface, TEST_SAMPLE_RATE);
+	USB_VirtualHost_StartOfFrame();
+	Host_AdvanceFrames((1 << 9) - 1, (1 << 9) - 1);
+
+	if (!(Host_CheckFeedback((uint32_t)TEST_SAMPLE_RATE * 16384 / 1000)))
+	  return false;
+
+	Host_AdvanceFrames(1, 1);
+
+	if (!(Host_CheckFeedback(1UL << 14)))
+	  return false;
+
+	return true;
+}
+
+int main(void)
+{
+	USB_Init(USB_DEVICE_OPT_FULLSPEED);
+	GlobalInterruptEnable();
+
+	if ((USB_VirtualHost_Enumerate(1) != VHOST_CONTROL_NoError) || !(Host_SetStreamInterface(1)))
+	{
+		printf("Enumeration failed.\n");
+		return EXIT_FAILURE;
+	}
+
+	if (!(Test_ReadPackets()) || !(Test_WritePackets()) || !(Test_Feedback()))
+	  return EXIT_FAILURE;
+
+	printf("All Audio packet and feedback tests passed.\n");
+	return EXIT_SUCCESS;
+}
+
+void EVENT_USB_Device_ConfigurationChanged(void)
+{
+	Audio_Device_ConfigureEndpoints(&Test_Audio_Interface);
+	USB_Device_EnableSOFEvents();
+}
+
+void EVENT_USB_Device_ControlRequest(void)
+{
+	Audio_Device_ProcessControlRequest(&Test_Audio_Interface);
+}
+
+void EVENT_USB_Device_StartOfFrame(void)
+{
+	Audio_Device_ProcessStartOfFrame(&Test_Audio_Interface);
+}
+
+bool CALLBACK_Audio_Device_GetSetEndpointProperty(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+                                                  const uint8_t EndpointProperty,
+                                                  const uint8_t EndpointAddress,
+                                                  const uint8_t EndpointControl,
+                                                  uint16_t* const DataLength,
+                                                  uint8_t* Data)
+{
+	(void)AudioInterfaceInfo;
+	(void)EndpointProperty;
+	(void)EndpointAddress;
+	(void)EndpointControl;
+	(void)DataLength;
+	(void)Data;
+
+	/* No endpoint properties are needed by the test */
+	return false;
+}
+
+bool CALLBACK_Audio_Device_GetSetInterfaceProperty(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+                                                   const uint8_t Property,
+                                                   const uint8_t EntityAddress,
+                                                   const uint16_t Parameter,
+                                                   uint16_t* const DataLength,
+                                                   uint8_t* Data)
+{
+	(void)AudioInterfaceInfo;
+	(void)Property;
+	(void)EntityAddress;
+	(void)Parameter;
+	(void)DataLength;
+	(void)Data;
+
+	/* No interface entities are needed by the test */
+	return false;
+}
@@ -0,0 +1,355 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Corpus of HID report descriptors for the HID parser build test. The first entries are the report descriptors
+ *  produced by the library's HID device demos, built from the same HID class driver macros; the remainder are
+ *  representative of the larger descriptors found on commercial composite keyboards, gamepads and touch screens,
+ *  which exercise the parser's report ID, state table, usage list and collection limits.
+ */
+
+#include "Descriptors.h"
+
+/** Report descriptor of the Keyboard and KeyboardMouse demos. */
+static const uint8_t Keyboard_Report[] =
+{
+	HID_DESCRIPTOR_KEYBOARD(6)
+};
+
+/** Report descriptor of the Mouse and KeyboardMouse demos. */
+static const uint8_t Mouse_Report[] =
+{
+	HID_DESCRIPTOR_MOUSE(-1, 1, -1, 1, 3, false)
+};
+
+/** Report descriptor of the Joystick demo. */
+static const uint8_t Joystick_Report[] =
+{
+	HID_DESCRIPTOR_JOYSTICK(-100, 100, -1, 1, 2)
+};
+
+/** Report descriptor of the GenericHID demo. */
+static const uint8_t GenericHID_Report[] =
+{
+	HID_DESCRIPTOR_VENDOR(0x00, 0x01, 0x02, 0x03, 8)
+};
+
+/** Report descriptor of the KeyboardMouseMultiReport demo. */
+static const uint8_t KeyboardMouseMultiReport_Report[] =
+{
+	/* Mouse Report */
+	HID_RI_USAGE_PAGE(8, 0x01), /* Generic Desktop */
+	HID_RI_USAGE(8, 0x02), /* Mouse */
+	HID_RI_COLLECTION(8, 0x01), /* Application */
+		HID_RI_REPORT_ID(8, 0x01),
+		HID_RI_USAGE(8, 0x01), /* Pointer */
+		HID_RI_COLLECTION(8, 0x00), /* Physical */
+			HID_RI_USAGE_PAGE(8, 0x09), /* Button */
+			HID_RI_USAGE_MINIMUM(8, 0x01),
+			HID_RI_USAGE_MAXIMUM(8, 0x03),
+			HID_RI_LOGICAL_MINIMUM(8, 0x00),
+			HID_RI_LOGICAL_MAXIMUM(8, 0x01),
+			HID_RI_REPORT_COUNT(8, 0x03),
+			HID_RI_REPORT_SIZE(8, 0x01),
+			HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE),
+			HID_RI_REPORT_COUNT(8, 0x01),
+			HID_RI_REPORT_SIZE(8, 0x05),
+			HID_RI_INPUT(8, HID_IOF_CONSTANT),
+			HID_RI_USAGE_PAGE(8, 0x01), /* Generic Desktop */
+			HID_RI_USAGE(8, 0x30), /* Usage X */
+			HID_RI_USAGE(8, 0x31), /* Usage Y */
+			HID_RI_LOGICAL_MINIMUM(8, -1),
+			HID_RI_LOGICAL_MAXIMUM(8, 1),
+			HID_RI_PHYSICAL_MINIMUM(8, -1),
+			HID_RI_PHYSICAL_MAXIMUM(8, 1),
+			HID_RI_REPORT_COUNT(8, 0x02),
+			HID_RI_REPORT_SIZE(8, 0x08),
+			HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_RELATIVE),
+		HID_RI_END_COLLECTION(0),
+	HID_RI_END_COLLECTION(0),
+
+	/* Keyboard Report */
+	HID_RI_USAGE_PAGE(8, 0x01), /* Generic Desktop */
+	HID_RI_USAGE(8, 0x06), /* Keyboard */
+	HID_RI_COLLECTION(8, 0x01), /* Application */
+		HID_RI_REPORT_ID(8, 0x02),
+		HID_RI_USAGE_PAGE(8, 0x07), /* Key Codes */
+		HID_RI_USAGE_MINIMUM(8, 0xE0), /* Keyboard Left Control */
+		HID_RI_USAGE_MAXIMUM(8, 0xE7), /* Keyboard Right GUI */
+		HID_RI_LOGICAL_MINIMUM(8, 0x00),
+		HID_RI_LOGICAL_MAXIMUM(8, 0x01),
+		HID_RI_REPORT_SIZE(8, 0x01),
+		HID_RI_REPORT_COUNT(8, 0x08),
+		HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE),
+		HID_RI_REPORT_COUNT(8, 0x01),
+		HID_RI_REPORT_SIZE(8, 0x08),
+		HID_RI_INPUT(8, HID_IOF_CONSTANT),
+		HID_RI_USAGE_PAGE(8, 0x08), /* LEDs */
+		HID_RI_USAGE_MINIMUM(8, 0x01), /* Num Lock */
+		HID_RI_USAGE_MAXIMUM(8, 0x05), /* Kana */
+		HID_RI_REPORT_COUNT(8, 0x05),
+		HID_RI_REPORT_SIZE(8, 0x01),
+		HID_RI_OUTPUT(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE | HID_IOF_NON_VOLATILE),
+		HID_RI_REPORT_COUNT(8, 0x01),
+		HID_RI_REPORT_SIZE(8, 0x03),
+		HID_RI_OUTPUT(8, HID_IOF_CONSTANT),
+		HID_RI_LOGICAL_MINIMUM(8, 0x00),
+		HID_RI_LOGICAL_MAXIMUM(8, 0x65),
+		HID_RI_USAGE_PAGE(8, 0x07), /* Keyboard */
+		HID_RI_USAGE_MINIMUM(8, 0x00), /* Reserved (no event indicated) */
+		HID_RI_USAGE_MAXIMUM(8, 0x65), /* Keyboard Application */
+		HID_RI_REPORT_COUNT(8, 0x06),
+		HID_RI_REPORT_SIZE(8, 0x08),
+		HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_ARRAY | HID_IOF_ABSOLUTE),
+	HID_RI_END_COLLECTION(0),
+};
+
+/** Composite keyboard with separate boot keyboard, consumer control and system control reports, using
+ *  16-bit usage ranges for the consumer page.
+ */
+static const uint8_t CompositeKeyboard_Report[] =
+{
+	HID_RI_REPORT_ID(8, 0x01),
+	HID_DESCRIPTOR_KEYBOARD(6),
+
+	HID_RI_USAGE_PAGE(8, 0x0C), /* Consumer */
+	HID_RI_USAGE(8, 0x01), /* Consumer Control */
+	HID_RI_COLLECTION(8, 0x01), /* Application */
+		HID_RI_REPORT_ID(8, 0x02),
+		HID_RI_LOGICAL_MINIMUM(8, 0x00),
+		HID_RI_LOGICAL_MAXIMUM(16, 0x029C),
+		HID_RI_USAGE_MINIMUM(8, 0x00),
+		HID_RI_USAGE_MAXIMUM(16, 0x029C), /* AC Distribute Vertically */
+		HID_RI_REPORT_SIZE(8, 0x10),
+		HID_RI_REPORT_COUNT(8, 0x02),
+		HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_ARRAY | HID_IOF_ABSOLUTE),
+	HID_RI_END_COLLECTION(0),
+
+	HID_RI_USAGE_PAGE(8, 0x01), /* Generic Desktop */
+	HID_RI_USAGE(8, 0x80), /* System Control */
+	HID_RI_COLLECTION(8, 0x01), /* Application */
+		HID_RI_REPORT_ID(8, 0x03),
+		HID_RI_LOGICAL_MINIMUM(8, 0x00),
+		HID_RI_LOGICAL_MAXIMUM(8, 0x01),
+		HID_RI_USAGE(8, 0x81), /* System Power Down */
+		HID_RI_USAGE(8, 0x82), /* System Sleep */
+		HID_RI_USAGE(8, 0x83), /* System Wake Up */
+		HID_RI_REPORT_SIZE(8, 0x01),
+		HID_RI_REPORT_COUNT(8, 0x03),
+		HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE),
+		HID_RI_REPORT_SIZE(8, 0x05),
+		HID_RI_REPORT_COUNT(8, 0x01),
+		HID_RI_INPUT(8, HID_IOF_CONSTANT),
+	HID_RI_END_COLLECTION(0),
+};
+
+/** Media remote listing each of its buttons as an explicit usage, rather than as a usage range. */
+static const uint8_t MediaRemote_Report[] =
+{
+	HID_RI_USAGE_PAGE(8, 0x0C), /* Consumer */
+	HID_RI_USAGE(8, 0x01), /* Consumer Control */
+	HID_RI_COLLECTION(8, 0x01), /* Application */
+		HID_RI_LOGICAL_MINIMUM(8, 0x00),
+		HID_RI_LOGICAL_MAXIMUM(8, 0x01),
+		HID_RI_USAGE(8, 0xB0), /* Play */
+		HID_RI_USAGE(8, 0xB1), /* Pause */
+		HID_RI_USAGE(8, 0xB3), /* Fast Forward */
+		HID_RI_USAGE(8, 0xB4), /* Rewind */
+		HID_RI_USAGE(8, 0xB5), /* Scan Next Track */
+		HID_RI_USAGE(8, 0xB6), /* Scan Previous Track */
+		HID_RI_USAGE(8, 0xB7), /* Stop */
+		HID_RI_USAGE(8, 0xCD), /* Play/Pause */
+		HID_RI_USAGE(8, 0xE2), /* Mute */
+		HID_RI_USAGE(8, 0xE9), /* Volume Increment */
+		HID_RI_USAGE(8, 0xEA), /* Volume Decrement */
+		HID_RI_USAGE(16, 0x0223), /* AC Home */
+		HID_RI_REPORT_SIZE(8, 0x01),
+		HID_RI_REPORT_COUNT(8, 0x0C),
+		HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE),
+		HID_RI_REPORT_SIZE(8, 0x04),
+		HID_RI_REPORT_COUNT(8, 0x01),
+		HID_RI_INPUT(8, HID_IOF_CONSTANT),
+	HID_RI_END_COLLECTION(0),
+};
+
+/** Gamepad with a hat switch, whose physical range and units are described within a PUSH/POP pair. */
+static const uint8_t Gamepad_Report[] =
+{
+	HID_RI_USAGE_PAGE(8, 0x01), /* Generic Desktop */
+	HID_RI_USAGE(8, 0x05), /* Gamepad */
+	HID_RI_COLLECTION(8, 0x01), /* Application */
+		HID_RI_USAGE(8, 0x01), /* Pointer */
+		HID_RI_COLLECTION(8, 0x00), /* Physical */
+			HID_RI_USAGE(8, 0x30), /* Usage X */
+			HID_RI_USAGE(8, 0x31), /* Usage Y */
+			HID_RI_USAGE(8, 0x32), /* Usage Z */
+			HID_RI_USAGE(8, 0x35), /* Usage RZ */
+			HID_RI_LOGICAL_MINIMUM(8, 0x00),
+			HID_RI_LOGICAL_MAXIMUM(16, 0x00FF),
+			HID_RI_REPORT_SIZE(8, 0x08),
+			HID_RI_REPORT_COUNT(8, 0x04),
+			HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE),
+		HID_RI_END_COLLECTION(0),
+		HID_RI_PUSH(0),
+			HID_RI_USAGE(8, 0x39), /* Hat Switch */
+			HID_RI_LOGICAL_MINIMUM(8, 0x00),
+			HID_RI_LOGICAL_MAXIMUM(8, 0x07),
+			HID_RI_PHYSICAL_MINIMUM(8, 0x00),
+			HID_RI_PHYSICAL_MAXIMUM(16, 0x013B),
+			HID_RI_UNIT(8, 0x14), /* English Rotation, Degrees */
+			HID_RI_REPORT_SIZE(8, 0x04),
+			HID_RI_REPORT_COUNT(8, 0x01),
+			HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE | HID_IOF_NULLSTATE),
+		HID_RI_POP(0),
+		HID_RI_REPORT_SIZE(8, 0x04),
+		HID_RI_REPORT_COUNT(8, 0x01),
+		HID_RI_INPUT(8, HID_IOF_CONSTANT),
+		HID_RI_USAGE_PAGE(8, 0x09), /* Button */
+		HID_RI_USAGE_MINIMUM(8, 0x01),
+		HID_RI_USAGE_MAXIMUM(8, 0x0C),
+		HID_RI_LOGICAL_MINIMUM(8, 0x00),
+		HID_RI_LOGICAL_MAXIMUM(8, 0x01),
+		HID_RI_REPORT_SIZE(8, 0x01),
+		HID_RI_REPORT_COUNT(8, 0x0C),
+		HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE),
+		HID_RI_REPORT_SIZE(8, 0x04),
+		HID_RI_REPORT_COUNT(8, 0x01),
+		HID_RI_INPUT(8, HID_IOF_CONSTANT),
+	HID_RI_END_COLLECTION(0),
+};
+
+/** Describes a single touch screen contact, as repeated within the multi-touch digitizer report. */
+#define DIGITIZER_CONTACT                                          \
+	HID_RI_USAGE_PAGE(8, 0x0D), /* Digitizer */                    \
+	HID_RI_USAGE(8, 0x22), /* Finger */                            \
+	HID_RI_COLLECTION(8, 0x02), /* Logical */                      \
+		HID_RI_LOGICAL_MINIMUM(8, 0x00),                           \
+		HID_RI_LOGICAL_MAXIMUM(8, 0x01),                           \
+		HID_RI_USAGE(8, 0x42), /* Tip Switch */                    \
+		HID_RI_REPORT_SIZE(8, 0x01),                               \
+		HID_RI_REPORT_COUNT(8, 0x01),                              \
+		HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE), \
+		HID_RI_REPORT_SIZE(8, 0x07),                               \
+		HID_RI_INPUT(8, HID_IOF_CONSTANT),                         \
+		HID_RI_LOGICAL_MAXIMUM(8, 0x0F),                           \
+		HID_RI_USAGE(8, 0x51), /* Contact Identifier */            \
+		HID_RI_REPORT_SIZE(8, 0x08),                               \
+		HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE), \
+		HID_RI_USAGE_PAGE(8, 0x01), /* Generic Desktop */          \
+		HID_RI_LOGICAL_MAXIMUM(16, 0x0FFF),                        \
+		HID_RI_PHYSICAL_MINIMUM(8, 0x00),                          \
+		HID_RI_PHYSICAL_MAXIMUM(16, 0x0960),                       \
+		HID_RI_UNIT_EXPONENT(8, 0x0E),                             \
+		HID_RI_UNIT(8, 0x11), /* SI Linear, Centimeters */         \
+		HID_RI_USAGE(8, 0x30), /* Usage X */                       \
+		HID_RI_USAGE(8, 0x31), /* Usage Y */                       \
+		HID_RI_REPORT_SIZE(8, 0x10),                               \
+		HID_RI_REPORT_COUNT(8, 0x02),                              \
+		HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE), \
+		HID_RI_PHYSICAL_MAXIMUM(8, 0x00),                          \
+		HID_RI_UNIT(8, 0x00),                                      \
+	HID_RI_END_COLLECTION(0)
+
+/** Multi-touch digitizer reporting five contacts, each within its own logical collection, plus a feature
+ *  report giving the maximum number of supported contacts.
+ */
+static const uint8_t Digitizer_Report[] =
+{
+	HID_RI_USAGE_PAGE(8, 0x0D), /* Digitizer */
+	HID_RI_USAGE(8, 0x04), /* Touch Screen */
+	HID_RI_COLLECTION(8, 0x01), /* Application */
+		HID_RI_REPORT_ID(8, 0x01),
+		DIGITIZER_CONTACT,
+		DIGITIZER_CONTACT,
+		DIGITIZER_CONTACT,
+		DIGITIZER_CONTACT,
+		DIGITIZER_CONTACT,
+		HID_RI_USAGE_PAGE(8, 0x0D), /* Digitizer */
+		HID_RI_LOGICAL_MAXIMUM(8, 0x05),
+		HID_RI_USAGE(8, 0x54), /* Contact Count */
+		HID_RI_REPORT_SIZE(8, 0x08),
+		HID_RI_REPORT_COUNT(8, 0x01),
+		HID_RI_INPUT(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE),
+		HID_RI_REPORT_ID(8, 0x02),
+		HID_RI_USAGE(8, 0x55), /* Contact Count Maximum */
+		HID_RI_FEATURE(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE),
+	HID_RI_END_COLLECTION(0),
+};
+
+/** Describes a single vendor defined configuration feature report with the given report ID. */
+#define VENDOR_FEATURE_REPORT(ReportID)                            \
+	HID_RI_REPORT_ID(8, ReportID),                                 \
+	HID_RI_USAGE(8, ReportID),                                     \
+	HID_RI_FEATURE(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE | HID_IOF_BUFFERED_BYTES)
+
+/** Vendor defined configuration interface, exposing each of its settings as a separate feature report. */
+static const uint8_t VendorConfig_Report[] =
+{
+	HID_RI_USAGE_PAGE(16, 0xFF00), /* Vendor Page 0 */
+	HID_RI_USAGE(8, 0x01), /* Vendor Usage 1 */
+	HID_RI_COLLECTION(8, 0x01), /* Application */
+		HID_RI_LOGICAL_MINIMUM(8, 0x00),
+		HID_RI_LOGICAL_MAXIMUM(16, 0x00FF),
+		HID_RI_REPORT_SIZE(8, 0x08),
+		HID_RI_REPORT_COUNT(8, 0x3F),
+		VENDOR_FEATURE_REPORT(0x01),
+		VENDOR_FEATURE_REPORT(0x02),
+		VENDOR_FEATURE_REPORT(0x03),
+		VENDOR_FEATURE_REPORT(0x04),
+		VENDOR_FEATURE_REPORT(0x05),
+		VENDOR_FEATURE_REPORT(0x06),
+		VENDOR_FEATURE_REPORT(0x07),
+		VENDOR_FEATURE_REPORT(0x08),
+		VENDOR_FEATURE_REPORT(0x09),
+		VENDOR_FEATURE_REPORT(0x0A),
+		VENDOR_FEATURE_REPORT(0x0B),
+		VENDOR_FEATURE_REPORT(0x0C),
+	HID_RI_END_COLLECTION(0),
+};
+
+/** Table of all the report descriptors in the corpus. */
+const HID_CorpusDescriptor_t HID_Corpus[] =
+{
+	{.Name = "Keyboard demo",                 .Data = Keyboard_Report,                 .Size = sizeof(Keyboard_Report)},
+	{.Name = "Mouse demo",                    .Data = Mouse_Report,                    .Size = sizeof(Mouse_Report)},
+	{.Name = "Joystick demo",                 .Data = Joystick_Report,                 .Size = sizeof(Joystick_Report)},
+	{.Name = "GenericHID demo",               .Data = GenericHID_Report,               .Size = sizeof(GenericHID_Report)},
+	{.Name = "KeyboardMouseMultiReport demo", .Data = KeyboardMouseMultiReport_Report, .Size = sizeof(KeyboardMouseMultiReport_Report)},
+	{.Name = "Composite keyboard",            .Data = CompositeKeyboard_Report,        .Size = sizeof(CompositeKeyboard_Report)},
+	{.Name = "Media remote",                  .Data = MediaRemote_Report,              .Size = sizeof(MediaRemote_Report)},
+	{.Name = "Gamepad",                       .Data = Gamepad_Report,                  .Size = sizeof(Gamepad_Report)},
+	{.Name = "Multi-touch digitizer",         .Data = Digitizer_Report,                .Size = sizeof(Digitizer_Report)},
+	{.Name = "Vendor configuration",          .Data = VendorConfig_Report,             .Size = sizeof(VendorConfig_Report)},
+};
+
+/** Total number of report descriptors in the corpus. */
+const uint8_t HID_CorpusSize = (sizeof(HID_Corpus) / sizeof(HID_Corpus[0]));
+
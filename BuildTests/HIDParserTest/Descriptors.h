@@ -0,0 +1,56 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for Descriptors.c.
+ */
+
+#ifndef _DESCRIPTORS_H_
+#define _DESCRIPTORS_H_
+
+	/* Includes: */
+		#include <LUFA/Drivers/USB/USB.h>
+
+	/* Type Defines: */
+		/** Type define for a HID report descriptor in the parser test corpus. */
+		typedef struct
+		{
+			const char*    Name; /**< Human readable name of the descriptor, shown in the benchmark results. */
+			const uint8_t* Data; /**< Pointer to the raw HID report descriptor. */
+			uint16_t       Size; /**< Size of the HID report descriptor, in bytes. */
+		} HID_CorpusDescriptor_t;
+
+	/* External Variables: */
+		extern const HID_CorpusDescriptor_t HID_Corpus[];
+		extern const uint8_t                HID_CorpusSize;
+
+#endif
+
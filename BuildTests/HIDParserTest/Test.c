@@ -0,0 +1,516 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Host side benchmark and fuzz test of the HID report parser. Each report descriptor in the corpus (the descriptors
+ *  produced by the library's HID demos, a set of larger representative descriptors, plus any captured descriptor
+ *  files given on the command line) is parsed with the same keep-everything filter as the HIDReportViewer project,
+ *  and the time taken per descriptor and per byte is reported along with the parser's resource usage against each
+ *  of the HID_MAX_* style compile time limits. The corpus is then mutated into a long series of malformed
+ *  descriptors, checking that every parse terminates quickly, agrees between the full and streaming parsers and
+ *  never reads past the end of the descriptor.
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "Descriptors.h"
+
+/** Number of times each corpus descriptor is parsed when timing the parser. */
+#define TEST_BENCH_ITERATIONS      20000UL
+
+/** Number of malformed descriptors generated and parsed by the fuzz test. */
+#define TEST_FUZZ_ITERATIONS       2000000UL
+
+/** Largest report descriptor accepted into the corpus or generated by the fuzz test, in bytes. */
+#define TEST_MAX_DESCRIPTOR_SIZE   1024
+
+/** Longest time a single fuzzed descriptor may take to parse before it is reported as a parser blowup. */
+#define TEST_FUZZ_MAX_PARSE_TIME   (CLOCKS_PER_SEC / 100)
+
+/** Names of each of the \ref HID_Parse_ErrorCodes_t parser return codes, for display. */
+static const char* const ErrorCodeNames[] =
+{
+	[HID_PARSE_Successful]                  = "Successful",
+	[HID_PARSE_HIDStackOverflow]            = "HIDStackOverflow",
+	[HID_PARSE_HIDStackUnderflow]           = "HIDStackUnderflow",
+	[HID_PARSE_InsufficientReportItems]     = "InsufficientReportItems",
+	[HID_PARSE_UnexpectedEndCollection]     = "UnexpectedEndCollection",
+	[HID_PARSE_InsufficientCollectionPaths] = "InsufficientCollectionPaths",
+	[HID_PARSE_UsageListOverflow]           = "UsageListOverflow",
+	[HID_PARSE_InsufficientReportIDItems]   = "InsufficientReportIDItems",
+	[HID_PARSE_NoUnfilteredReportItems]     = "NoUnfilteredReportItems",
+	[HID_PARSE_TruncatedReportItem]         = "TruncatedReportItem",
+};
+
+/** Total number of distinct parser return codes. */
+#define TOTAL_ERROR_CODES          (sizeof(ErrorCodeNames) / sizeof(ErrorCodeNames[0]))
+
+static HID_ReportInfo_t        ReportInfo;
+
+static HID_CorpusDescriptor_t* Corpus;
+static uint8_t                 CorpusSize;
+
+static uint8_t*                GuardedBufferEnd;
+static const uint8_t*          CurrentDescriptor;
+static uint16_t                CurrentDescriptorSize;
+
+static uint32_t RandomState = 0x12345678;
+
+/** Simple xorshift pseudo-random generator, so that test runs are repeatable across hosts. */
+static uint32_t Random(void)
+{
+	RandomState ^= (RandomState << 13);
+	RandomState ^= (RandomState >> 17);
+	RandomState ^= (RandomState << 5);
+
+	return RandomState;
+}
+
+/** Keeps every parsed report item, in the same manner as the HIDReportViewer project. */
+bool CALLBACK_HIDParser_FilterHIDReportItem(HID_ReportItem_t* const CurrentItem)
+{
+	(void)CurrentItem;
+
+	return true;
+}
+
+/** Stream parser callback, counting the report items presented by the parser. */
+static void CountReportItem(void* const Context,
+                            const HID_ReportItem_t* const ReportItem)
+{
+	(void)ReportItem;
+
+	(*(uint32_t*)Context)++;
+}
+
+/** Prints the descriptor being parsed when the parser faults on the guard page, then aborts the test. */
+static void ParserFaultHandler(const int Signal)
+{
+	(void)Signal;
+
+	printf("\nParser read past the end of a %u byte descriptor:\n", CurrentDescriptorSize);
+
+	for (uint16_t i = 0; i < CurrentDescriptorSize; i++)
+	  printf("%02X%c", CurrentDescriptor[i], ((i % 16) == 15) ? '\n' : ' ');
+
+	printf("\n");
+	fflush(stdout);
+	_exit(EXIT_FAILURE);
+}
+
+/** Allocates the buffer parsed descriptors are copied into, which is immediately followed by an inaccessible guard
+ *  page so that any read past the end of a descriptor faults rather than silently parsing unrelated memory.
+ *
+ *  \return Boolean \c true if the buffer was allocated, \c false otherwise.
+ */
+static bool CreateGuardedBuffer(void)
+{
+	size_t PageSize   = sysconf(_SC_PAGESIZE);
+	size_t BufferSize = (((TEST_MAX_DESCRIPTOR_SIZE + PageSize - 1) / PageSize) * PageSize);
+
+	uint8_t* Buffer = mmap(NULL, (BufferSize + PageSize), (PROT_READ | PROT_WRITE), (MAP_PRIVATE | MAP_ANONYMOUS), -1, 0);
+
+	if ((Buffer == MAP_FAILED) || mprotect(&Buffer[BufferSize], PageSize, PROT_NONE))
+	{
+		printf("Could not create guarded descriptor buffer.\n");
+		return false;
+	}
+
+	GuardedBufferEnd = &Buffer[BufferSize];
+
+	signal(SIGSEGV, ParserFaultHandler);
+	signal(SIGBUS,  ParserFaultHandler);
+
+	return true;
+}
+
+/** Copies a descriptor into the end of the guarded buffer, so that it ends directly before the guard page.
+ *
+ *  \param[in] Data  Descriptor to copy.
+ *  \param[in] Size  Size of the descriptor in bytes.
+ *
+ *  \return Pointer to the guarded copy of the descriptor.
+ */
+static const uint8_t* GuardDescriptor(const uint8_t* const Data,
+                                      const uint16_t Size)
+{
+	uint8_t* Descriptor = (GuardedBufferEnd - Size);
+
+	memmove(Descriptor, Data, Size);
+
+	CurrentDescriptor     = Descriptor;
+	CurrentDescriptorSize = Size;
+
+	return Descriptor;
+}
+
+/** Loads each captured descriptor file given on the command line, such as a Linux
+ *  /sys/bus/hid/devices/.../report_descriptor file, into the corpus after the built in descriptors.
+ *
+ *  \return Boolean \c true if all the files were loaded, \c false otherwise.
+ */
+static bool LoadCorpus(const int TotalFiles,
+                       char* const Files[])
+{
+	Corpus = malloc((HID_CorpusSize + TotalFiles) * sizeof(HID_CorpusDescriptor_t));
+	memcpy(Corpus, HID_Corpus, (HID_CorpusSize * sizeof(HID_CorpusDescriptor_t)));
+	CorpusSize = HID_CorpusSize;
+
+	for (int i = 0; i < TotalFiles; i++)
+	{
+		FILE*    File = fopen(Files[i], "rb");
+		uint8_t* Data = malloc(TEST_MAX_DESCRIPTOR_SIZE + 1);
+		size_t   Size = 0;
+
+		if (File != NULL)
+		{
+			Size = fread(Data, 1, (TEST_MAX_DESCRIPTOR_SIZE + 1), File);
+			fclose(File);
+		}
+
+		if (!(Size) || (Size > TEST_MAX_DESCRIPTOR_SIZE))
+		{
+			printf("Could not load descriptor \"%s\" (empty, missing or larger than %u bytes).\n",
+			       Files[i], TEST_MAX_DESCRIPTOR_SIZE);
+			return false;
+		}
+
+		Corpus[CorpusSize++] = (HID_CorpusDescriptor_t){.Name = Files[i], .Data = Data, .Size = Size};
+	}
+
+	return true;
+}
+
+/** Parses a descriptor with both the full and streaming parsers, checking that their results agree.
+ *
+ *  \param[in]  Descriptor   Descriptor to parse.
+ *  \param[in]  Size         Size of the descriptor in bytes.
+ *  \param[out] ErrorCode    Result of the full parse, a value from the \ref HID_Parse_ErrorCodes_t enum.
+ *  \param[out] StreamError  Result of the streaming parse, a value from the \ref HID_Parse_ErrorCodes_t enum.
+ *  \param[out] Statistics   Statistics gathered by the streaming parse.
+ *
+ *  \return Boolean \c true if the parsers agreed, \c false otherwise.
+ */
+static bool ParseDescriptor(const uint8_t* const Descriptor,
+                            const uint16_t Size,
+                            uint8_t* const ErrorCode,
+                            uint8_t* const StreamError,
+                            HID_ParserStatistics_t* const Statistics)
+{
+	uint32_t StreamItems = 0;
+
+	*ErrorCode   = USB_ProcessHIDReport(Descriptor, Size, &ReportInfo);
+	*StreamError = USB_ProcessHIDReportStream(Descriptor, Size, CountReportItem, &StreamItems, Statistics);
+
+	if ((*ErrorCode >= TOTAL_ERROR_CODES) || (*StreamError >= TOTAL_ERROR_CODES))
+	{
+		printf("Parser returned unknown error code %u/%u.\n", *ErrorCode, *StreamError);
+		return false;
+	}
+
+	if ((uint16_t)StreamItems != Statistics->TotalReportItems)
+	{
+		printf("Stream parser presented %lu items but counted %u.\n", (unsigned long)StreamItems,
+		       Statistics->TotalReportItems);
+		return false;
+	}
+
+	/* The streaming parser has a subset of the full parser's limits, so must accept anything the full parser does */
+	if ((*ErrorCode == HID_PARSE_Successful) &&
+	    ((*StreamError != HID_PARSE_Successful) || (StreamItems != ReportInfo.TotalReportItems)))
+	{
+		printf("Full parser found %u items but stream parser returned %s with %lu items.\n",
+		       ReportInfo.TotalReportItems, ErrorCodeNames[*StreamError], (unsigned long)StreamItems);
+		return false;
+	}
+
+	return true;
+}
+
+/** Prints the HID parser compile time limits exceeded by a descriptor, given its parse results. */
+static void PrintExceededLimits(const uint8_t ErrorCode,
+                                const uint8_t StreamError,
+                                const HID_ParserStatistics_t* const Statistics)
+{
+	bool LimitsExceeded = false;
+
+	printf("  Limits exceeded:");
+
+	if (Statistics->TotalReportItems > HID_MAX_REPORTITEMS)
+	{
+		printf(" HID_MAX_REPORTITEMS");
+		LimitsExceeded = true;
+	}
+
+	if ((Statistics->TotalCollections > HID_MAX_COLLECTIONS) || (StreamError == HID_PARSE_InsufficientCollectionPaths))
+	{
+		printf(" HID_MAX_COLLECTIONS");
+		LimitsExceeded = true;
+	}
+
+	if ((ErrorCode == HID_PARSE_InsufficientReportIDItems) || (StreamError == HID_PARSE_InsufficientReportIDItems))
+	{
+		printf(" HID_MAX_REPORT_IDS");
+		LimitsExceeded = true;
+	}
+
+	if ((ErrorCode == HID_PARSE_HIDStackOverflow) || (StreamError == HID_PARSE_HIDStackOverflow))
+	{
+		printf(" HID_STATETABLE_STACK_DEPTH");
+		LimitsExceeded = true;
+	}
+
+	if ((ErrorCode == HID_PARSE_UsageListOverflow) || (StreamError == HID_PARSE_UsageListOverflow))
+	{
+		printf(" HID_USAGE_STACK_DEPTH");
+		LimitsExceeded = true;
+	}
+
+	printf("%s\n", (LimitsExceeded ? "" : " none"));
+}
+
+/** Times the full and streaming parsers on a single corpus descriptor, and prints the results along with the
+ *  descriptor's resource usage against each of the parser's compile time limits.
+ *
+ *  \return Boolean \c true if the descriptor parsed consistently, \c false otherwise.
+ */
+static bool BenchmarkDescriptor(const HID_CorpusDescriptor_t* const Entry)
+{
+	const uint8_t*         Descriptor = GuardDescriptor(Entry->Data, Entry->Size);
+	HID_ParserStatistics_t Statistics;
+	uint8_t                ErrorCode;
+	uint8_t                StreamError;
+	uint32_t               StreamItems;
+	clock_t                StartTime;
+
+	printf("%s (%u bytes)\n", Entry->Name, Entry->Size);
+
+	if (!(ParseDescriptor(Descriptor, Entry->Size, &ErrorCode, &StreamError, &Statistics)))
+	  return false;
+
+	StartTime = clock();
+
+	for (uint32_t i = 0; i < TEST_BENCH_ITERATIONS; i++)
+	  USB_ProcessHIDReport(Descriptor, Entry->Size, &ReportInfo);
+
+	double FullTime = ((double)(clock() - StartTime) / CLOCKS_PER_SEC / TEST_BENCH_ITERATIONS);
+
+	StartTime = clock();
+
+	for (uint32_t i = 0; i < TEST_BENCH_ITERATIONS; i++)
+	  USB_ProcessHIDReportStream(Descriptor, Entry->Size, CountReportItem, &StreamItems, NULL);
+
+	double StreamTime = ((double)(clock() - StartTime) / CLOCKS_PER_SEC / TEST_BENCH_ITERATIONS);
+
+	printf("  Full parse %s, %.0f ns (%.1f ns/byte); stream parse %s, %.0f ns (%.1f ns/byte)\n",
+	       ErrorCodeNames[ErrorCode], (FullTime * 1e9), (FullTime * 1e9 / Entry->Size),
+	       ErrorCodeNames[StreamError], (StreamTime * 1e9), (StreamTime * 1e9 / Entry->Size));
+	printf("  Items %u/%u, collections %u/%u, report IDs %u/%u, state table depth %u/%u, usage list %u/%u\n",
+	       Statistics.TotalReportItems, HID_MAX_REPORTITEMS,
+	       Statistics.TotalCollections, HID_MAX_COLLECTIONS,
+	       Statistics.TotalReportIDs, HID_MAX_REPORT_IDS,
+	       Statistics.MaxStateTableDepth, HID_STATETABLE_STACK_DEPTH,
+	       Statistics.MaxUsageListSize, HID_USAGE_STACK_DEPTH);
+	printf("  Collection depth %u, largest report %u bits", Statistics.MaxCollectionDepth,
+	       Statistics.LargestReportSizeBits);
+
+	/* The required table size is only known once the whole descriptor has been streamed */
+	if (StreamError == HID_PARSE_Successful)
+	  printf(", minimum table size %lu bytes", (unsigned long)Statistics.RequiredTableSize);
+
+	printf("\n");
+
+	PrintExceededLimits(ErrorCode, StreamError, &Statistics);
+
+	return true;
+}
+
+/** Applies a random series of mutations to a random corpus descriptor, to generate a malformed descriptor.
+ *
+ *  \param[out] Descriptor  Buffer of \ref TEST_MAX_DESCRIPTOR_SIZE bytes where the generated descriptor is stored.
+ *
+ *  \return Size of the generated descriptor, in bytes.
+ */
+static uint16_t MutateDescriptor(uint8_t* const Descriptor)
+{
+	const HID_CorpusDescriptor_t* Seed = &Corpus[Random() % CorpusSize];
+	uint16_t Size = Seed->Size;
+
+	memcpy(Descriptor, Seed->Data, Size);
+
+	for (uint8_t TotalMutations = (1 + (Random() % 4)); TotalMutations; TotalMutations--)
+	{
+		uint16_t Position = (Random() % (Size + 1));
+
+		switch (Random() % 6)
+		{
+			case 0:
+				/* Flip a random bit */
+				if (Position < Size)
+				  Descriptor[Position] ^= (1 << (Random() % 8));
+
+				break;
+			case 1:
+				/* Replace a random byte, which may change an item's type or data size */
+				if (Position < Size)
+				  Descriptor[Position] = Random();
+
+				break;
+			case 2:
+				/* Truncate the descriptor, possibly part way through an item */
+				Size = Position;
+				break;
+			case 3:
+				/* Insert a random item with a random amount of item data */
+				{
+					uint8_t ItemLength = (1 + (Random() % 5));
+
+					if ((Size + ItemLength) > TEST_MAX_DESCRIPTOR_SIZE)
+					  break;
+
+					memmove(&Descriptor[Position + ItemLength], &Descriptor[Position], (Size - Position));
+
+					for (uint8_t i = 0; i < ItemLength; i++)
+					  Descriptor[Position + i] = Random();
+
+					Size += ItemLength;
+				}
+
+				break;
+			case 4:
+				/* Repeat a random span, to deepen nesting and increase item, collection and report ID counts */
+				{
+					uint16_t SpanLength = (Random() % (Size - Position + 1));
+					uint8_t  Repeats    = (1 + (Random() % 8));
+
+					while (Repeats-- && ((Size + SpanLength) <= TEST_MAX_DESCRIPTOR_SIZE))
+					{
+						memmove(&Descriptor[Position + SpanLength], &Descriptor[Position], (Size - Position));
+						Size += SpanLength;
+					}
+				}
+
+				break;
+			default:
+				/* Replace the descriptor with random data */
+				Size = (Random() % 128);
+
+				for (uint16_t i = 0; i < Size; i++)
+				  Descriptor[i] = Random();
+
+				break;
+		}
+	}
+
+	return Size;
+}
+
+/** Parses a long series of malformed descriptors generated from the corpus, checking that each parse completes
+ *  promptly and consistently. Reads past the end of a descriptor are caught by the guard page.
+ *
+ *  \return Boolean \c true if all the malformed descriptors were handled correctly, \c false otherwise.
+ */
+static bool RunFuzzTest(void)
+{
+	uint8_t  Input[TEST_MAX_DESCRIPTOR_SIZE];
+	uint32_t ErrorCounts[TOTAL_ERROR_CODES] = {0};
+	clock_t  SlowestParse = 0;
+	clock_t  StartTime    = clock();
+
+	for (uint32_t Case = 0; Case < TEST_FUZZ_ITERATIONS; Case++)
+	{
+		uint16_t               Size       = MutateDescriptor(Input);
+		const uint8_t*         Descriptor = GuardDescriptor(Input, Size);
+		HID_ParserStatistics_t Statistics;
+		uint8_t                ErrorCode;
+		uint8_t                StreamError;
+
+		clock_t ParseStartTime = clock();
+		bool    Consistent     = ParseDescriptor(Descriptor, Size, &ErrorCode, &StreamError, &Statistics);
+		clock_t ParseTime      = (clock() - ParseStartTime);
+
+		if (ParseTime > TEST_FUZZ_MAX_PARSE_TIME)
+		{
+			printf("Fuzz case %lu (%u bytes) took %.3f seconds to parse.\n", (unsigned long)Case, Size,
+			       ((double)ParseTime / CLOCKS_PER_SEC));
+			Consistent = false;
+		}
+
+		if (!(Consistent))
+		{
+			printf("Fuzz case %lu failed.\n", (unsigned long)Case);
+			return false;
+		}
+
+		SlowestParse = MAX(SlowestParse, ParseTime);
+		ErrorCounts[ErrorCode]++;
+	}
+
+	printf("Fuzz test parsed %lu malformed descriptors in %.3f seconds (slowest %.3f ms):\n",
+	       (unsigned long)TEST_FUZZ_ITERATIONS, ((double)(clock() - StartTime) / CLOCKS_PER_SEC),
+	       ((double)SlowestParse * 1000 / CLOCKS_PER_SEC));
+
+	for (uint8_t i = 0; i < TOTAL_ERROR_CODES; i++)
+	  printf("  %-28s %lu\n", ErrorCodeNames[i], (unsigned long)ErrorCounts[i]);
+
+	return true;
+}
+
+int main(int argc,
+         char* argv[])
+{
+	if (!(CreateGuardedBuffer()) || !(LoadCorpus((argc - 1), &argv[1])))
+	  return EXIT_FAILURE;
+
+	printf("Parser limits: %u report items, %u collections, %u report IDs, %u state tables, %u usages "
+	       "(HID_ReportInfo_t is %u bytes).\n\n", HID_MAX_REPORTITEMS, HID_MAX_COLLECTIONS, HID_MAX_REPORT_IDS,
+	       HID_STATETABLE_STACK_DEPTH, HID_USAGE_STACK_DEPTH, (unsigned)sizeof(HID_ReportInfo_t));
+
+	for (uint8_t i = 0; i < CorpusSize; i++)
+	{
+		if (!(BenchmarkDescriptor(&Corpus[i])))
+		  return EXIT_FAILURE;
+	}
+
+	printf("\n");
+
+	if (!(RunFuzzTest()))
+	  return EXIT_FAILURE;
+
+	return EXIT_SUCCESS;
+}
+
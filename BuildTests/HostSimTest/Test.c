@@ -0,0 +1,918 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Functional test of the simulated HOSTSIM USB controller. A CDC class device is enumerated by the
+ *  virtual host, which first checks the completion of standard, class and vendor control requests
+ *  through the non-blocking control transfer functions and indexes the device's configuration
+ *  descriptor as a host mode class driver would, then streams a known data pattern through the
+ *  device's bulk endpoints and
+ *  checks the looped-back data, reporting the achieved throughput. The data is looped back first a
+ *  byte at a time through the CDC class driver, then in odd sized chunks through the endpoint stream
+ *  functions so that transfers straddle bank boundaries in both byte orders, then by copying each
+ *  packet directly between the endpoint banks, and finally through the CDC class driver's buffered
+ *  mode with the buffers serviced from the Start Of Frame interrupt. When built with USB event tracing
+ *  enabled, the trace records and endpoint statistics gathered along the way are also checked.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "Descriptors.h"
+
+#include <LUFA/Drivers/USB/USB.h>
+
+/** Total number of bytes to loop through the simulated device. */
+#define TEST_TOTAL_BYTES  (4UL * 1024 * 1024)
+
+/** Size of each chunk looped back through the endpoint stream functions. */
+#define TEST_STREAM_CHUNK  100
+
+/** Vendor request reading back the contents of the vendor data buffer. */
+#define TEST_VENDOR_REQ_Read   0x01
+
+/** Vendor request writing a short packet of data to the device. */
+#define TEST_VENDOR_REQ_Write  0x02
+
+/** Number of transfer requests kept in flight in each direction by the request loopback test. */
+#define TEST_REQUEST_COUNT     4
+
+/** Length of each request in the request loopback test, a whole number of packets so that each IN transfer
+ *  must be terminated with a zero length packet.
+ */
+#define TEST_REQUEST_LENGTH    256
+
+/** Number of interfaces in the synthetic configuration descriptor used to test indexing past the index table size. */
+#define TEST_LARGE_CONFIG_INTERFACES  (USB_HOST_CONFIG_INDEX_MAX_INTERFACES + 2)
+
+/** Type define for a synthetic configuration descriptor with more interfaces than an index can store. */
+typedef struct
+{
+	USB_Descriptor_Configuration_Header_t Config;
+
+	struct
+	{
+		USB_Descriptor_Interface_t Interface;
+		USB_Descriptor_Endpoint_t  Endpoints[2];
+	} ATTR_PACKED Interfaces[TEST_LARGE_CONFIG_INTERFACES];
+} ATTR_PACKED LargeConfigDescriptor_t;
+
+/** LUFA CDC Class driver interface configuration and state information. */
+static USB_ClassInfo_CDC_Device_t Test_CDC_Interface =
+	{
+		.Config =
+			{
+				.ControlInterfaceNumber   = 0,
+				.DataINEndpoint           =
+					{
+						.Address          = CDC_TX_EPADDR,
+						.Size             = CDC_TXRX_EPSIZE,
+						.Banks            = 2,
+					},
+				.DataOUTEndpoint =
+					{
+						.Address          = CDC_RX_EPADDR,
+						.Size             = CDC_TXRX_EPSIZE,
+						.Banks            = 2,
+					},
+				.NotificationEndpoint =
+					{
+						.Address          = CDC_NOTIFICATION_EPADDR,
+						.Size             = CDC_NOTIFICATION_EPSIZE,
+						.Banks            = 1,
+					},
+			},
+	};
+
+/** Ring buffers used by the CDC interface in the buffered loopback test. */
+static RingBuffer_t Test_CDC_TXBuffer;
+static RingBuffer_t Test_CDC_RXBuffer;
+static uint8_t      Test_CDC_TXBufferData[256];
+static uint8_t      Test_CDC_RXBufferData[256];
+
+static uint32_t TXBufferLowEvents;
+static uint32_t RXBufferHighEvents;
+
+static uint32_t BytesSent;
+static uint32_t BytesReceived;
+static bool     DataError;
+
+/** Vendor request data, a whole number of control endpoint packets in length. */
+static uint8_t  VendorData[64];
+static uint8_t  VendorReceived[USB_DEVICE_CONTROL_BUFFER_SIZE];
+static uint8_t  VendorCompletions;
+static uint8_t  VendorErrorCode;
+
+static USB_TransferRequest_t LoopbackOUTRequests[TEST_REQUEST_COUNT];
+static USB_TransferRequest_t LoopbackINRequests[TEST_REQUEST_COUNT];
+static uint8_t               LoopbackRequestData[TEST_REQUEST_COUNT][TEST_REQUEST_LENGTH];
+
+static uint8_t TestPattern(const uint32_t Offset)
+{
+	return (uint8_t)((Offset * 7) ^ (Offset >> 8));
+}
+
+/** Host side of the test, run by the virtual host whenever the device waits on the bus. */
+static void HostTask(void)
+{
+	static bool InHostTask;
+
+	uint8_t  Packet[CDC_TXRX_EPSIZE];
+	uint16_t PacketLength;
+
+	/* Endpoint interrupts raised by the host's own transfers may wait on the bus, re-entering the host task */
+	if (InHostTask)
+	  return;
+
+	InHostTask = true;
+
+	while (BytesSent < TEST_TOTAL_BYTES)
+	{
+		PacketLength = MIN(sizeof(Packet), TEST_TOTAL_BYTES - BytesSent);
+
+		for (uint16_t i = 0; i < PacketLength; i++)
+		  Packet[i] = TestPattern(BytesSent + i);
+
+		if (!(USB_VirtualHost_SendOUT(CDC_RX_EPADDR, Packet, PacketLength)))
+		  break;
+
+		BytesSent += PacketLength;
+	}
+
+	for (;;)
+	{
+		PacketLength = sizeof(Packet);
+
+		if (!(USB_VirtualHost_ReceiveIN(CDC_TX_EPADDR, Packet, &PacketLength)))
+		  break;
+
+		for (uint16_t i = 0; i < PacketLength; i++)
+		{
+			if (Packet[i] != TestPattern(BytesReceived + i))
+			  DataError = true;
+		}
+
+		BytesReceived += PacketLength;
+	}
+
+	InHostTask = false;
+}
+
+/** Device side of the byte loopback test, echoing received bytes through the CDC class driver. */
+static void ByteLoopbackTask(void)
+{
+	int16_t ReceivedByte = CDC_Device_ReceiveByte(&Test_CDC_Interface);
+
+	if (ReceivedByte >= 0)
+	  CDC_Device_SendByte(&Test_CDC_Interface, ReceivedByte);
+
+	CDC_Device_USBTask(&Test_CDC_Interface);
+}
+
+/** Device side of the stream loopback test, echoing chunks of data through the endpoint stream functions. As each
+ *  chunk is read and written back in the same byte order, the looped back data is identical to the sent data.
+ */
+static void StreamLoopbackTask(void)
+{
+	static uint8_t  Buffer[TEST_STREAM_CHUNK];
+	static uint32_t BytesLoopedBack;
+	static bool     BigEndian;
+
+	uint16_t ChunkLength = MIN(sizeof(Buffer), TEST_TOTAL_BYTES - BytesLoopedBack);
+
+	if (!(ChunkLength))
+	  return;
+
+	Endpoint_SelectEndpoint(CDC_RX_EPADDR);
+
+	if (BigEndian)
+	  Endpoint_Read_Stream_BE(Buffer, ChunkLength, NULL);
+	else
+	  Endpoint_Read_Stream_LE(Buffer, ChunkLength, NULL);
+
+	Endpoint_SelectEndpoint(CDC_TX_EPADDR);
+
+	if (BigEndian)
+	  Endpoint_Write_Stream_BE(Buffer, ChunkLength, NULL);
+	else
+	  Endpoint_Write_Stream_LE(Buffer, ChunkLength, NULL);
+
+	Endpoint_ClearIN();
+
+	BytesLoopedBack += ChunkLength;
+	BigEndian        = !(BigEndian);
+}
+
+/** Device side of the bank loopback test, copying each received packet directly from the OUT endpoint's bank
+ *  into the IN endpoint's bank without passing through an intermediate buffer.
+ */
+static void BankLoopbackTask(void)
+{
+	uint16_t OUTLength;
+	uint16_t INLength;
+
+	Endpoint_SelectEndpoint(CDC_RX_EPADDR);
+
+	if (!(Endpoint_IsOUTReceived()))
+	  return;
+
+	uint8_t* OUTData = Endpoint_AcquireBank(&OUTLength);
+
+	if (!(OUTLength))
+	{
+		Endpoint_ClearOUT();
+		return;
+	}
+
+	Endpoint_SelectEndpoint(CDC_TX_EPADDR);
+
+	if (!(Endpoint_IsINReady()))
+	  return;
+
+	uint8_t* INData      = Endpoint_AcquireBank(&INLength);
+	uint16_t BytesToCopy = MIN(OUTLength, INLength);
+
+	memcpy(INData, OUTData, BytesToCopy);
+	Endpoint_CommitBank(BytesToCopy);
+	Endpoint_ClearIN();
+
+	Endpoint_SelectEndpoint(CDC_RX_EPADDR);
+	Endpoint_CommitBank(BytesToCopy);
+
+	if (!(Endpoint_BytesInEndpoint()))
+	  Endpoint_ClearOUT();
+}
+
+/** Device side of the buffered loopback test, moving data between the CDC interface's receive and transmit buffers. The
+ *  buffers themselves are serviced by the CDC class driver from the Start Of Frame interrupt, generated here by the host.
+ */
+static void BufferedLoopbackTask(void)
+{
+	while (CDC_Device_BytesReceived(&Test_CDC_Interface) && !(RingBuffer_IsFull(&Test_CDC_TXBuffer)))
+	  CDC_Device_SendByte(&Test_CDC_Interface, CDC_Device_ReceiveByte(&Test_CDC_Interface));
+
+	USB_VirtualHost_StartOfFrame();
+}
+
+/** Completion callback for the request loopback test's OUT requests, sending the received data back to the host. */
+static void LoopbackOUTComplete(USB_TransferRequest_t* const Request)
+{
+	USB_TransferRequest_t* INRequest = (USB_TransferRequest_t*)Request->Context;
+
+	if (Request->Status == TRANSFER_STATUS_Complete)
+	{
+		INRequest->Length = Request->BytesTransferred;
+
+		if (!(Endpoint_SubmitRequest(CDC_TX_EPADDR, INRequest)))
+		  DataError = true;
+	}
+	else if (Request->Status != TRANSFER_STATUS_Cancelled)
+	{
+		DataError = true;
+	}
+}
+
+/** Completion callback for the request loopback test's IN requests, reusing the buffer for more received data. */
+static void LoopbackINComplete(USB_TransferRequest_t* const Request)
+{
+	if ((Request->Status != TRANSFER_STATUS_Complete) ||
+	    !(Endpoint_SubmitRequest(CDC_RX_EPADDR, (USB_TransferRequest_t*)Request->Context)))
+	{
+		DataError = true;
+	}
+}
+
+/** Device side of the request loopback test, keeping several OUT requests queued and looping each completed one
+ *  back to the host through an IN request from the transfer request completion callbacks.
+ */
+static void RequestLoopbackTask(void)
+{
+	static bool RequestsSubmitted;
+
+	if (RequestsSubmitted)
+	  return;
+
+	for (uint8_t i = 0; i < TEST_REQUEST_COUNT; i++)
+	{
+		LoopbackOUTRequests[i] = (USB_TransferRequest_t)
+			{
+				.Buffer   = LoopbackRequestData[i],
+				.Length   = TEST_REQUEST_LENGTH,
+				.Callback = LoopbackOUTComplete,
+				.Context  = &LoopbackINRequests[i],
+			};
+
+		LoopbackINRequests[i] = (USB_TransferRequest_t)
+			{
+				.Buffer   = LoopbackRequestData[i],
+				.Flags    = TRANSFER_FLAG_SendZLP,
+				.Callback = LoopbackINComplete,
+				.Context  = &LoopbackOUTRequests[i],
+			};
+
+		Endpoint_SubmitRequest(CDC_RX_EPADDR, &LoopbackOUTRequests[i]);
+	}
+
+	RequestsSubmitted = true;
+}
+
+static void VendorTransferComplete(void* const Context,
+                                   const uint8_t ErrorCode)
+{
+	if ((Context != NULL) && (ErrorCode == ENDPOINT_RWCSTREAM_NoError))
+	  memcpy(Context, USB_Device_GetControlData(), USB_ControlRequest.wLength);
+
+	VendorCompletions++;
+	VendorErrorCode = ErrorCode;
+}
+
+/** Issues a single control request through the virtual host, checking that it completes without error. */
+static bool RunControlRequest(const uint8_t bmRequestType,
+                              const uint8_t bRequest,
+                              const uint16_t wValue,
+                              const uint16_t wLength,
+                              void* const Data)
+{
+	USB_Request_Header_t Request =
+		{
+			.bmRequestType = bmRequestType,
+			.bRequest      = bRequest,
+			.wValue        = wValue,
+			.wIndex        = 0,
+			.wLength       = wLength,
+		};
+
+	return (USB_VirtualHost_ControlRequest(&Request, Data) == VHOST_CONTROL_NoError);
+}
+
+/** Checks the standard, class and vendor control requests completed through the non-blocking control transfers. */
+static bool RunControlTransferTest(void)
+{
+	uint8_t Response[100];
+
+	for (uint8_t i = 0; i < sizeof(VendorData); i++)
+	  VendorData[i] = TestPattern(i);
+
+	/* A response shorter than requested that ends on a packet boundary must be terminated with a zero length packet */
+	memset(Response, 0x00, sizeof(Response));
+
+	if (!(RunControlRequest((REQDIR_DEVICETOHOST | REQTYPE_VENDOR | REQREC_DEVICE), TEST_VENDOR_REQ_Read, 0,
+	                        sizeof(Response), Response)) ||
+	    memcmp(Response, VendorData, sizeof(VendorData)) || (Response[sizeof(VendorData)] != 0x00) ||
+	    (VendorCompletions != 1) || (VendorErrorCode != ENDPOINT_RWCSTREAM_NoError))
+	{
+		printf("Vendor read with zero length packet termination failed.\n");
+		return false;
+	}
+
+	/* A response longer than requested must be clipped to the requested length */
+	memset(Response, 0x00, sizeof(Response));
+
+	if (!(RunControlRequest((REQDIR_DEVICETOHOST | REQTYPE_VENDOR | REQREC_DEVICE), TEST_VENDOR_REQ_Read, 0,
+	                        20, Response)) ||
+	    memcmp(Response, VendorData, 20) || (Response[20] != 0x00) || (VendorCompletions != 2))
+	{
+		printf("Vendor read of a partial response failed.\n");
+		return false;
+	}
+
+	uint8_t WriteData[6] = {0xDE, 0xAD, 0xBE, 0xEF, 0x55, 0xAA};
+
+	if (!(RunControlRequest((REQDIR_HOSTTODEVICE | REQTYPE_VENDOR | REQREC_DEVICE), TEST_VENDOR_REQ_Write, 0,
+	                        sizeof(WriteData), WriteData)) ||
+	    memcmp(VendorReceived, WriteData, sizeof(WriteData)) || (VendorCompletions != 3))
+	{
+		printf("Vendor write failed.\n");
+		return false;
+	}
+
+	CDC_LineEncoding_t LineEncoding;
+
+	if (!(RunControlRequest((REQDIR_DEVICETOHOST | REQTYPE_CLASS | REQREC_INTERFACE), CDC_REQ_GetLineEncoding, 0,
+	                        sizeof(CDC_LineEncoding_t), &LineEncoding)) ||
+	    (le32_to_cpu(LineEncoding.BaudRateBPS) != 115200) || (LineEncoding.DataBits != 8))
+	{
+		printf("Class line encoding read failed.\n");
+		return false;
+	}
+
+	if (!(RunControlRequest((REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE), CDC_REQ_SetControlLineState,
+	                        (CDC_CONTROL_LINE_OUT_DTR | CDC_CONTROL_LINE_OUT_RTS), 0, NULL)) ||
+	    (Test_CDC_Interface.State.ControlLineStates.HostToDevice != (CDC_CONTROL_LINE_OUT_DTR | CDC_CONTROL_LINE_OUT_RTS)))
+	{
+		printf("Class control line state request failed.\n");
+		return false;
+	}
+
+	uint16_t DeviceStatus        = 0xFFFF;
+	uint8_t  ConfigurationNumber = 0;
+
+	if (!(RunControlRequest((REQDIR_DEVICETOHOST | REQTYPE_STANDARD | REQREC_DEVICE), REQ_GetStatus, 0,
+	                        sizeof(DeviceStatus), &DeviceStatus)) || (DeviceStatus != 0) ||
+	    !(RunControlRequest((REQDIR_DEVICETOHOST | REQTYPE_STANDARD | REQREC_DEVICE), REQ_GetConfiguration, 0,
+	                        sizeof(ConfigurationNumber), &ConfigurationNumber)) || (ConfigurationNumber != 1))
+	{
+		printf("Standard status and configuration requests failed.\n");
+		return false;
+	}
+
+	if (USB_Device_IsControlTransferActive())
+	{
+		printf("Control transfer left active after the host completed its requests.\n");
+		return false;
+	}
+
+	printf("All control transfer tests passed.\n");
+	return true;
+}
+
+/** Checks the indexing of the device's configuration descriptor, as fetched by the virtual host, by the host mode
+ *  configuration descriptor index functions.
+ */
+static bool RunConfigIndexTest(void)
+{
+	USB_Descriptor_Configuration_t ConfigDescriptor;
+	USB_ConfigIndex_t              ConfigIndex;
+
+	if (!(RunControlRequest((REQDIR_DEVICETOHOST | REQTYPE_STANDARD | REQREC_DEVICE), REQ_GetDescriptor,
+	                        (DTYPE_Configuration << 8), sizeof(ConfigDescriptor), &ConfigDescriptor)) ||
+	    !(USB_Host_IndexConfigDescriptor(&ConfigIndex, sizeof(ConfigDescriptor), &ConfigDescriptor)) ||
+	    (ConfigIndex.TotalInterfaces != 2) || ConfigIndex.OverflowOffset)
+	{
+		printf("Configuration descriptor indexing failed.\n");
+		return false;
+	}
+
+	USB_ConfigIndex_Interface_t ControlInterface;
+	USB_ConfigIndex_Interface_t DataInterface;
+	USB_ConfigIndex_Interface_t ExtraInterface;
+	uint8_t                     InterfaceIndex = 0;
+
+	if (!(USB_Host_FindIndexedInterface(&ConfigIndex, &InterfaceIndex, CDC_CSCP_CDCClass, CDC_CSCP_ACMSubclass,
+	                                    CDC_CSCP_ATCommandProtocol, &ControlInterface)) ||
+	    !(USB_Host_FindIndexedInterface(&ConfigIndex, &InterfaceIndex, CDC_CSCP_CDCDataClass, CDC_CSCP_NoDataSubclass,
+	                                    CDC_CSCP_NoDataProtocol, &DataInterface)) ||
+	    (ControlInterface.Descriptor != &ConfigDescriptor.CDC_CCI_Interface) ||
+	    (DataInterface.Descriptor    != &ConfigDescriptor.CDC_DCI_Interface) ||
+	    (USB_Host_GetNextIndexedEndpoint(&ControlInterface, NULL) != &ConfigDescriptor.CDC_NotificationEndpoint) ||
+	    USB_Host_GetNextIndexedEndpoint(&ControlInterface, &ConfigDescriptor.CDC_NotificationEndpoint) ||
+	    (USB_Host_GetNextIndexedEndpoint(&DataInterface, NULL) != &ConfigDescriptor.CDC_DataOutEndpoint) ||
+	    (USB_Host_GetNextIndexedEndpoint(&DataInterface, &ConfigDescriptor.CDC_DataOutEndpoint) != &ConfigDescriptor.CDC_DataInEndpoint) ||
+	    USB_Host_GetNextIndexedEndpoint(&DataInterface, &ConfigDescriptor.CDC_DataInEndpoint) ||
+	    (USB_Host_GetIndexedClassDescriptor(&ControlInterface, DTYPE_CSInterface) != &ConfigDescriptor.CDC_Functional_Header) ||
+	    USB_Host_GetIndexedClassDescriptor(&DataInterface, DTYPE_CSInterface) ||
+	    USB_Host_FindIndexedInterface(&ConfigIndex, &InterfaceIndex, CDC_CSCP_CDCClass, CDC_CSCP_ACMSubclass,
+	                                  CDC_CSCP_ATCommandProtocol, &ExtraInterface))
+	{
+		printf("Indexed descriptor lookup failed.\n");
+		return false;
+	}
+
+	/* Truncated and malformed descriptors must be rejected rather than indexed past their end */
+	if (USB_Host_IndexConfigDescriptor(&ConfigIndex, (sizeof(ConfigDescriptor) - 1), &ConfigDescriptor))
+	{
+		printf("Truncated configuration descriptor indexed.\n");
+		return false;
+	}
+
+	ConfigDescriptor.CDC_DCI_Interface.Header.Size = 0;
+
+	if (USB_Host_IndexConfigDescriptor(&ConfigIndex, sizeof(ConfigDescriptor), &ConfigDescriptor))
+	{
+		printf("Malformed configuration descriptor indexed.\n");
+		return false;
+	}
+
+	/* Descriptors with more interfaces than the index can hold must still be indexed, with the excess found by searching */
+	LargeConfigDescriptor_t LargeConfigDescriptor;
+
+	LargeConfigDescriptor.Config = (USB_Descriptor_Configuration_Header_t)
+		{
+			.Header                 = {.Size = sizeof(USB_Descriptor_Configuration_Header_t), .Type = DTYPE_Configuration},
+			.TotalConfigurationSize = sizeof(LargeConfigDescriptor),
+			.TotalInterfaces        = TEST_LARGE_CONFIG_INTERFACES,
+			.ConfigurationNumber    = 1,
+		};
+
+	for (uint8_t i = 0; i < TEST_LARGE_CONFIG_INTERFACES; i++)
+	{
+		LargeConfigDescriptor.Interfaces[i].Interface = (USB_Descriptor_Interface_t)
+			{
+				.Header           = {.Size = sizeof(USB_Descriptor_Interface_t), .Type = DTYPE_Interface},
+				.InterfaceNumber  = i,
+				.TotalEndpoints   = 2,
+				.Class            = 0xFF,
+				.Protocol         = i,
+			};
+
+		for (uint8_t j = 0; j < 2; j++)
+		{
+			LargeConfigDescriptor.Interfaces[i].Endpoints[j] = (USB_Descriptor_Endpoint_t)
+				{
+					.Header          = {.Size = sizeof(USB_Descriptor_Endpoint_t), .Type = DTYPE_Endpoint},
+					.EndpointAddress = ((j ? ENDPOINT_DIR_IN : ENDPOINT_DIR_OUT) | (i + 1)),
+					.Attributes      = EP_TYPE_BULK,
+					.EndpointSize    = 64,
+				};
+		}
+	}
+
+	if (!(USB_Host_IndexConfigDescriptor(&ConfigIndex, sizeof(LargeConfigDescriptor), &LargeConfigDescriptor)) ||
+	    (ConfigIndex.TotalInterfaces != USB_HOST_CONFIG_INDEX_MAX_INTERFACES) ||
+	    (ConfigIndex.OverflowOffset != ((uintptr_t)&LargeConfigDescriptor.Interfaces[USB_HOST_CONFIG_INDEX_MAX_INTERFACES] -
+	                                    (uintptr_t)&LargeConfigDescriptor)))
+	{
+		printf("Large configuration descriptor indexing failed.\n");
+		return false;
+	}
+
+	InterfaceIndex = 0;
+
+	for (uint8_t i = 0; i < TEST_LARGE_CONFIG_INTERFACES; i++)
+	{
+		uint8_t SearchIndex = 0;
+
+		if (!(USB_Host_GetIndexedInterface(&ConfigIndex, &InterfaceIndex, &ExtraInterface)) ||
+		    (ExtraInterface.Descriptor != &LargeConfigDescriptor.Interfaces[i].Interface) ||
+		    !(USB_Host_FindIndexedInterface(&ConfigIndex, &SearchIndex, 0xFF, 0x00, i, &DataInterface)) ||
+		    (DataInterface.Descriptor != &LargeConfigDescriptor.Interfaces[i].Interface) || (SearchIndex != (i + 1)) ||
+		    (USB_Host_GetNextIndexedEndpoint(&DataInterface, NULL) != &LargeConfigDescriptor.Interfaces[i].Endpoints[0]) ||
+		    (USB_Host_GetNextIndexedEndpoint(&DataInterface, &LargeConfigDescriptor.Interfaces[i].Endpoints[0]) !=
+		     &LargeConfigDescriptor.Interfaces[i].Endpoints[1]) ||
+		    USB_Host_GetNextIndexedEndpoint(&DataInterface, &LargeConfigDescriptor.Interfaces[i].Endpoints[1]))
+		{
+			printf("Large configuration descriptor lookup failed for interface %u.\n", i);
+			return false;
+		}
+	}
+
+	if (USB_Host_GetIndexedInterface(&ConfigIndex, &InterfaceIndex, &ExtraInterface))
+	{
+		printf("Large configuration descriptor lookup ran past the last interface.\n");
+		return false;
+	}
+
+	printf("All configuration descriptor index tests passed.\n");
+	return true;
+}
+
+/** Checks the packet boundary and cancellation handling of endpoint transfer requests. */
+static bool RunTransferRequestTest(void)
+{
+	uint8_t Packet[40];
+	uint8_t FullPacket[CDC_TXRX_EPSIZE];
+	uint8_t FirstData[10];
+	uint8_t SecondData[CDC_TXRX_EPSIZE];
+	uint8_t SplitData[CDC_TXRX_EPSIZE * 2];
+
+	for (uint8_t i = 0; i < sizeof(Packet); i++)
+	  Packet[i] = TestPattern(i);
+
+	for (uint8_t i = 0; i < sizeof(FullPacket); i++)
+	  FullPacket[i] = TestPattern(i + sizeof(Packet));
+
+	/* Outstanding loopback requests must be cancelled before the endpoints are reused */
+	Endpoint_AbortRequests(CDC_RX_EPADDR);
+
+	for (uint8_t i = 0; i < TEST_REQUEST_COUNT; i++)
+	{
+		if ((LoopbackOUTRequests[i].Status != TRANSFER_STATUS_Cancelled) ||
+		    (LoopbackINRequests[i].Status  != TRANSFER_STATUS_Complete))
+		{
+			printf("Loopback requests not completed or cancelled.\n");
+			return false;
+		}
+	}
+
+	/* A packet larger than the first request must complete it, with the remainder completing the second request as a short packet */
+	USB_TransferRequest_t FirstRequest  = {.Buffer = FirstData,  .Length = sizeof(FirstData)};
+	USB_TransferRequest_t SecondRequest = {.Buffer = SecondData, .Length = sizeof(SecondData)};
+
+	if (!(Endpoint_SubmitRequest(CDC_RX_EPADDR, &FirstRequest)) || !(Endpoint_SubmitRequest(CDC_RX_EPADDR, &SecondRequest)) ||
+	    Endpoint_SubmitRequest(CDC_RX_EPADDR, &SecondRequest) || !(USB_VirtualHost_SendOUT(CDC_RX_EPADDR, Packet, sizeof(Packet))))
+	{
+		printf("Transfer request submission failed.\n");
+		return false;
+	}
+
+	for (uint8_t i = 0; (i < 10) && (SecondRequest.Status == TRANSFER_STATUS_Pending); i++)
+	  USB_USBTask();
+
+	if ((FirstRequest.Status != TRANSFER_STATUS_Complete)  || (FirstRequest.BytesTransferred != sizeof(FirstData)) ||
+	    (SecondRequest.Status != TRANSFER_STATUS_Complete) || (SecondRequest.BytesTransferred != (sizeof(Packet) - sizeof(FirstData))) ||
+	    memcmp(FirstData, Packet, sizeof(FirstData)) || memcmp(SecondData, &Packet[sizeof(FirstData)], SecondRequest.BytesTransferred))
+	{
+		printf("Transfer request short packet handling failed.\n");
+		return false;
+	}
+
+	/* A full packet split across two requests must not complete the second request until a short packet arrives */
+	USB_TransferRequest_t SplitRequest = {.Buffer = SplitData, .Length = sizeof(SplitData)};
+	FirstRequest = (USB_TransferRequest_t){.Buffer = FirstData, .Length = sizeof(FirstData)};
+
+	if (!(Endpoint_SubmitRequest(CDC_RX_EPADDR, &FirstRequest)) || !(Endpoint_SubmitRequest(CDC_RX_EPADDR, &SplitRequest)) ||
+	    !(USB_VirtualHost_SendOUT(CDC_RX_EPADDR, FullPacket, sizeof(FullPacket))))
+	{
+		printf("Transfer request submission failed.\n");
+		return false;
+	}
+
+	for (uint8_t i = 0; i < 10; i++)
+	  USB_USBTask();
+
+	if ((FirstRequest.Status != TRANSFER_STATUS_Complete) || (FirstRequest.BytesTransferred != sizeof(FirstData)) ||
+	    (SplitRequest.Status != TRANSFER_STATUS_Pending)  || (SplitRequest.BytesTransferred != (sizeof(FullPacket) - sizeof(FirstData))))
+	{
+		printf("Transfer request split packet handling failed.\n");
+		return false;
+	}
+
+	if (!(USB_VirtualHost_SendOUT(CDC_RX_EPADDR, Packet, sizeof(Packet))))
+	{
+		printf("Transfer request submission failed.\n");
+		return false;
+	}
+
+	for (uint8_t i = 0; (i < 10) && (SplitRequest.Status == TRANSFER_STATUS_Pending); i++)
+	  USB_USBTask();
+
+	if ((SplitRequest.Status != TRANSFER_STATUS_Complete) ||
+	    (SplitRequest.BytesTransferred != (sizeof(FullPacket) - sizeof(FirstData) + sizeof(Packet))) ||
+	    memcmp(FirstData, FullPacket, sizeof(FirstData)) ||
+	    memcmp(SplitData, &FullPacket[sizeof(FirstData)], sizeof(FullPacket) - sizeof(FirstData)) ||
+	    memcmp(&SplitData[sizeof(FullPacket) - sizeof(FirstData)], Packet, sizeof(Packet)))
+	{
+		printf("Transfer request split packet handling failed.\n");
+		return false;
+	}
+
+	if (!(Endpoint_SubmitRequest(CDC_RX_EPADDR, &FirstRequest)) || !(Endpoint_CancelRequest(&FirstRequest)) ||
+	    (FirstRequest.Status != TRANSFER_STATUS_Cancelled) || Endpoint_CancelRequest(&FirstRequest))
+	{
+		printf("Transfer request cancellation failed.\n");
+		return false;
+	}
+
+	printf("All transfer request tests passed.\n");
+	return true;
+}
+
+#if defined(USB_ENABLE_TRACE)
+/** Checks the endpoint statistics and binary stream encoding of the USB event trace. */
+static bool RunTraceTest(void)
+{
+	const uint8_t       CounterFrameSize = (3 + sizeof(USB_TraceCounters_t));
+	uint8_t             Stream[64];
+	uint16_t            StreamLength;
+	USB_TraceCounters_t Counters;
+
+	if (!(USB_Trace_GetCounters(CDC_TX_EPADDR & ENDPOINT_EPNUM_MASK, &Counters)) ||
+	    (Counters.BytesSent < TEST_TOTAL_BYTES) || !(Counters.PacketsSent))
+	{
+		printf("Trace endpoint statistics incorrect.\n");
+		return false;
+	}
+
+	USB_Trace_Reset();
+
+	CDC_LineEncoding_t LineEncoding = Test_CDC_Interface.State.LineEncoding;
+
+	if (!(RunControlRequest((REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE), CDC_REQ_SetLineEncoding,
+	                        0, sizeof(LineEncoding), &LineEncoding)))
+	{
+		printf("Trace control request failed.\n");
+		return false;
+	}
+
+	StreamLength = USB_Trace_ReadStream(Stream, sizeof(Stream));
+
+	if ((StreamLength != (2 + sizeof(USB_TraceRecord_t))) || (Stream[0] != USB_TRACE_STREAM_SYNC) ||
+	    (Stream[1] != USB_TRACE_FRAME_Record) || (Stream[5] != TRACE_EVENT_DeviceControlRequest) ||
+	    (Stream[6] != (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE)) || (Stream[7] != CDC_REQ_SetLineEncoding))
+	{
+		printf("Trace control request record incorrect.\n");
+		return false;
+	}
+
+	/* Counter frames are split across reads of the stream when the buffer cannot hold them all */
+	USB_Trace_QueueCounters();
+
+	uint16_t TotalLength = 0;
+
+	while ((StreamLength = USB_Trace_ReadStream(Stream, 5)) != 0)
+	{
+		if ((TotalLength % CounterFrameSize) == 0)
+		{
+			if ((Stream[0] != USB_TRACE_STREAM_SYNC) || (Stream[1] != USB_TRACE_FRAME_Counters) ||
+			    (Stream[2] != (TotalLength / CounterFrameSize)))
+			{
+				printf("Trace counter frame incorrect.\n");
+				return false;
+			}
+		}
+
+		TotalLength += StreamLength;
+	}
+
+	if (TotalLength != (USB_TRACE_TOTAL_COUNTERS * CounterFrameSize))
+	{
+		printf("Trace counter stream length incorrect.\n");
+		return false;
+	}
+
+	printf("All trace tests passed.\n");
+	return true;
+}
+#endif
+
+/** Runs a single loopback test through the given device task, reporting the achieved throughput. */
+static bool RunLoopbackTest(const char* const Name,
+                            void (*const DeviceTask)(void))
+{
+	BytesSent     = 0;
+	BytesReceived = 0;
+
+	clock_t StartTime = clock();
+
+	while ((BytesReceived < TEST_TOTAL_BYTES) && !(DataError))
+	{
+		DeviceTask();
+		USB_USBTask();
+
+		HostTask();
+	}
+
+	double ElapsedTime = ((double)(clock() - StartTime) / CLOCKS_PER_SEC);
+
+	if (DataError)
+	{
+		printf("%s loopback data mismatch after %lu bytes.\n", Name, (unsigned long)BytesReceived);
+		return false;
+	}
+
+	printf("%s loopback of %lu bytes in %.3f seconds (%.1f KB/s).\n", Name, (unsigned long)BytesReceived, ElapsedTime,
+	       (BytesReceived / 1024.0) / ((ElapsedTime > 0) ? ElapsedTime : 1));
+
+	return true;
+}
+
+int main(void)
+{
+	USB_Init(USB_DEVICE_OPT_FULLSPEED);
+	GlobalInterruptEnable();
+
+	if (USB_VirtualHost_Enumerate(1) != VHOST_CONTROL_NoError)
+	{
+		printf("Enumeration failed.\n");
+		return EXIT_FAILURE;
+	}
+
+	USB_Request_Header_t SetLineEncoding =
+		{
+			.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE),
+			.bRequest      = CDC_REQ_SetLineEncoding,
+			.wValue        = 0,
+			.wIndex        = 0,
+			.wLength       = sizeof(CDC_LineEncoding_t),
+		};
+
+	CDC_LineEncoding_t LineEncoding =
+		{
+			.BaudRateBPS = cpu_to_le32(115200),
+			.CharFormat  = CDC_LINEENCODING_OneStopBit,
+			.ParityType  = CDC_PARITY_None,
+			.DataBits    = 8,
+		};
+
+	if ((USB_VirtualHost_ControlRequest(&SetLineEncoding, &LineEncoding) != VHOST_CONTROL_NoError) ||
+	    (Test_CDC_Interface.State.LineEncoding.BaudRateBPS != 115200))
+	{
+		printf("Class control request failed.\n");
+		return EXIT_FAILURE;
+	}
+
+	if (!(RunControlTransferTest()) || !(RunConfigIndexTest()))
+	  return EXIT_FAILURE;
+
+	USB_VirtualHost_SetIdleHandler(HostTask);
+
+	if (!(RunLoopbackTest("Byte", ByteLoopbackTask)) || !(RunLoopbackTest("Stream", StreamLoopbackTask)) ||
+	    !(RunLoopbackTest("Bank", BankLoopbackTask)) || !(RunLoopbackTest("Request", RequestLoopbackTask)) ||
+	    !(RunTransferRequestTest()))
+	{
+		return EXIT_FAILURE;
+	}
+
+	RingBuffer_InitBuffer(&Test_CDC_TXBuffer, Test_CDC_TXBufferData, sizeof(Test_CDC_TXBufferData));
+	RingBuffer_InitBuffer(&Test_CDC_RXBuffer, Test_CDC_RXBufferData, sizeof(Test_CDC_RXBufferData));
+
+	Test_CDC_Interface.Config.TXBuffer        = &Test_CDC_TXBuffer;
+	Test_CDC_Interface.Config.RXBuffer        = &Test_CDC_RXBuffer;
+	Test_CDC_Interface.Config.TXLowWatermark  = 32;
+	Test_CDC_Interface.Config.RXHighWatermark = 128;
+
+	USB_Device_EnableSOFEvents();
+
+	if (!(RunLoopbackTest("Buffered", BufferedLoopbackTask)))
+	  return EXIT_FAILURE;
+
+	if (!(TXBufferLowEvents))
+	{
+		printf("Transmit buffer low watermark event not fired.\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("Buffered loopback fired %lu TX low and %lu RX high watermark events.\n",
+	       (unsigned long)TXBufferLowEvents, (unsigned long)RXBufferHighEvents);
+
+	#if defined(USB_ENABLE_TRACE)
+	if (!(RunTraceTest()))
+	  return EXIT_FAILURE;
+	#endif
+
+	return EXIT_SUCCESS;
+}
+
+void EVENT_USB_Device_ConfigurationChanged(void)
+{
+	CDC_Device_ConfigureEndpoints(&Test_CDC_Interface);
+}
+
+void EVENT_USB_Device_ControlRequest(void)
+{
+	CDC_Device_ProcessControlRequest(&Test_CDC_Interface);
+
+	if (!(Endpoint_IsSETUPReceived()))
+	  return;
+
+	switch (USB_ControlRequest.bRequest)
+	{
+		case TEST_VENDOR_REQ_Read:
+			if (USB_ControlRequest.bmRequestType == (REQDIR_DEVICETOHOST | REQTYPE_VENDOR | REQREC_DEVICE))
+			{
+				Endpoint_ClearSETUP();
+				USB_Device_SendControlData(VendorData, sizeof(VendorData), VendorTransferComplete, NULL);
+			}
+
+			break;
+		case TEST_VENDOR_REQ_Write:
+			if ((USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_VENDOR | REQREC_DEVICE)) &&
+			    (USB_ControlRequest.wLength <= sizeof(VendorReceived)))
+			{
+				Endpoint_ClearSETUP();
+				USB_Device_ReceiveControlData(NULL, USB_ControlRequest.wLength, VendorTransferComplete, VendorReceived);
+			}
+
+			break;
+	}
+}
+
+void EVENT_USB_Device_StartOfFrame(void)
+{
+	if (Test_CDC_Interface.Config.TXBuffer)
+	  CDC_Device_USBTask(&Test_CDC_Interface);
+}
+
+void EVENT_CDC_Device_TXBufferLow(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+{
+	(void)CDCInterfaceInfo;
+
+	TXBufferLowEvents++;
+}
+
+void EVENT_CDC_Device_RXBufferHigh(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+{
+	(void)CDCInterfaceInfo;
+
+	RXBufferHighEvents++;
+}
+
@@ -0,0 +1,447 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Host side test of the MIDI stream converter. The parser and writer are first checked against a set of known
+ *  conversions covering running status, interleaved Real-Time messages, System Common messages and System Exclusive
+ *  messages of each possible final packet length. Long random MIDI streams are then converted into event packets
+ *  both a byte at a time and in random blocks, checking that both paths agree, and round tripped through the writer
+ *  to check that running status compression loses no events. Finally the conversion rate of a large System
+ *  Exclusive dump is measured for both paths.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <LUFA/Drivers/USB/USB.h>
+
+/** Length of each random MIDI stream generated for the round trip test, in bytes. */
+#define TEST_STREAM_LENGTH      (256UL * 1024)
+
+/** Number of random MIDI streams generated for the round trip test. */
+#define TEST_STREAM_ITERATIONS  16
+
+/** Length of the System Exclusive dump used by the throughput test, in bytes. */
+#define TEST_SYSEX_LENGTH       (4UL * 1024 * 1024)
+
+/** Largest number of event packets a stream can produce, one per byte plus slack for the generator overrun. */
+#define TEST_MAX_EVENTS         (TEST_STREAM_LENGTH + 16)
+
+/** Known conversion between a MIDI byte stream and the event packets it must produce. */
+typedef struct
+{
+	const char*        Name;
+	uint8_t            Cable;
+	uint8_t            Length;
+	uint8_t            Bytes[8];
+	uint8_t            TotalEvents;
+	MIDI_EventPacket_t Events[4];
+} KnownConversion_t;
+
+/** Known byte stream to event packet conversions checked by the parser test. */
+static const KnownConversion_t KnownConversions[] =
+{
+	{"Running status",     0, 5, {0x90, 0x3C, 0x40, 0x3E, 0x40}, 2,
+		{{0x09, 0x90, 0x3C, 0x40}, {0x09, 0x90, 0x3E, 0x40}}},
+	{"Interleaved clock",  0, 4, {0x90, 0x3C, 0xF8, 0x40}, 2,
+		{{0x0F, 0xF8, 0x00, 0x00}, {0x09, 0x90, 0x3C, 0x40}}},
+	{"Program change",     0, 3, {0xC0, 0x05, 0x06}, 2,
+		{{0x0C, 0xC0, 0x05, 0x00}, {0x0C, 0xC0, 0x06, 0x00}}},
+	{"SysEx end 1 byte",   0, 4, {0xF0, 0x7E, 0x7F, 0xF7}, 2,
+		{{0x04, 0xF0, 0x7E, 0x7F}, {0x05, 0xF7, 0x00, 0x00}}},
+	{"SysEx end 2 bytes",  0, 5, {0xF0, 0x01, 0x02, 0x03, 0xF7}, 2,
+		{{0x04, 0xF0, 0x01, 0x02}, {0x06, 0x03, 0xF7, 0x00}}},
+	{"SysEx end 3 bytes",  0, 6, {0xF0, 0x01, 0x02, 0x03, 0x04, 0xF7}, 2,
+		{{0x04, 0xF0, 0x01, 0x02}, {0x07, 0x03, 0x04, 0xF7}}},
+	{"Empty SysEx",        0, 2, {0xF0, 0xF7}, 1,
+		{{0x06, 0xF0, 0xF7, 0x00}}},
+	{"System Common",      0, 6, {0xF2, 0x10, 0x20, 0xF6, 0xF1, 0x05}, 3,
+		{{0x03, 0xF2, 0x10, 0x20}, {0x05, 0xF6, 0x00, 0x00}, {0x02, 0xF1, 0x05, 0x00}}},
+	{"Aborted SysEx",      0, 5, {0xF0, 0x01, 0x90, 0x3C, 0x40}, 1,
+		{{0x09, 0x90, 0x3C, 0x40}}},
+	{"Orphan data",        0, 3, {0x3C, 0x40, 0xF7}, 0,
+		{{0x00, 0x00, 0x00, 0x00}}},
+	{"Cable number",       3, 3, {0x80, 0x3C, 0x00}, 1,
+		{{0x38, 0x80, 0x3C, 0x00}}},
+};
+
+/** Event packets written by the writer test, and the running status compressed byte stream they must produce. */
+static const MIDI_EventPacket_t WriterEvents[] =
+{
+	{0x09, 0x90, 0x3C, 0x40},
+	{0x09, 0x90, 0x3E, 0x40},
+	{0x0F, 0xF8, 0x00, 0x00},
+	{0x09, 0x90, 0x40, 0x40},
+	{0x08, 0x80, 0x40, 0x00},
+	{0x04, 0xF0, 0x01, 0x02},
+	{0x05, 0xF7, 0x00, 0x00},
+	{0x08, 0x80, 0x40, 0x00},
+	{0x00, 0x12, 0x34, 0x56},
+};
+
+static const uint8_t WriterBytes[] =
+{
+	0x90, 0x3C, 0x40, 0x3E, 0x40, 0xF8, 0x40, 0x40, 0x80, 0x40, 0x00, 0xF0, 0x01, 0x02, 0xF7, 0x80, 0x40, 0x00,
+};
+
+static uint8_t            StreamData[TEST_STREAM_LENGTH + 16];
+static uint8_t            CompressedData[TEST_STREAM_LENGTH + 16];
+static MIDI_EventPacket_t ByteEvents[TEST_MAX_EVENTS];
+static MIDI_EventPacket_t BlockEvents[TEST_MAX_EVENTS];
+static MIDI_EventPacket_t RoundTripEvents[TEST_MAX_EVENTS];
+
+static uint32_t RandomState = 0x12345678;
+
+/** Simple xorshift pseudo-random generator, so that test runs are repeatable across hosts. */
+static uint32_t Random(void)
+{
+	RandomState ^= (RandomState << 13);
+	RandomState ^= (RandomState >> 17);
+	RandomState ^= (RandomState << 5);
+
+	return RandomState;
+}
+
+/** Converts a byte stream into event packets a byte at a time through \ref MIDI_ProcessStreamByte().
+ *
+ *  \return Number of event packets produced.
+ */
+static uint32_t ConvertByBytes(MIDI_StreamParser_t* const Parser,
+                               const uint8_t* const Bytes,
+                               const uint32_t Length,
+                               MIDI_EventPacket_t* const Events)
+{
+	uint32_t TotalEvents = 0;
+
+	for (uint32_t i = 0; i < Length; i++)
+	{
+		if (MIDI_ProcessStreamByte(Parser, Bytes[i], &Events[TotalEvents]))
+		  TotalEvents++;
+	}
+
+	return TotalEvents;
+}
+
+/** Converts a byte stream into event packets through \ref MIDI_ConvertStreamToEvents(), passing random sized blocks
+ *  of the stream and limiting each call to a random number of events.
+ *
+ *  \return Number of event packets produced.
+ */
+static uint32_t ConvertByBlocks(MIDI_StreamParser_t* const Parser,
+                                const uint8_t* Bytes,
+                                uint32_t Length,
+                                MIDI_EventPacket_t* const Events)
+{
+	uint32_t TotalEvents = 0;
+
+	while (Length)
+	{
+		uint16_t BlockLength = (1 + (Random() % 300));
+		uint16_t MaxEvents   = (1 + (Random() % 40));
+		uint16_t BytesProcessed;
+
+		if (BlockLength > Length)
+		  BlockLength = Length;
+
+		TotalEvents += MIDI_ConvertStreamToEvents(Parser, Bytes, BlockLength, &BytesProcessed,
+		                                          &Events[TotalEvents], MaxEvents);
+
+		Bytes  += BytesProcessed;
+		Length -= BytesProcessed;
+	}
+
+	return TotalEvents;
+}
+
+/** Prints an event packet, for the reporting of test failures. */
+static void PrintEvent(const char* Label,
+                       const MIDI_EventPacket_t* const Event)
+{
+	printf("  %s: %02X %02X %02X %02X\n", Label, Event->Event, Event->Data1, Event->Data2, Event->Data3);
+}
+
+/** Checks the parser and writer against the known conversion tables.
+ *
+ *  \return Boolean \c true if every conversion matched, \c false otherwise.
+ */
+static bool RunKnownConversionTest(void)
+{
+	bool Passed = true;
+
+	for (uint8_t i = 0; i < (sizeof(KnownConversions) / sizeof(KnownConversions[0])); i++)
+	{
+		const KnownConversion_t* Conversion = &KnownConversions[i];
+		MIDI_StreamParser_t      Parser;
+		MIDI_EventPacket_t       Events[8];
+		uint16_t                 BytesProcessed;
+
+		MIDI_InitStreamParser(&Parser, Conversion->Cable);
+		uint32_t TotalEvents = ConvertByBytes(&Parser, Conversion->Bytes, Conversion->Length, Events);
+
+		MIDI_InitStreamParser(&Parser, Conversion->Cable);
+		uint16_t TotalBlockEvents = MIDI_ConvertStreamToEvents(&Parser, Conversion->Bytes, Conversion->Length,
+		                                                       &BytesProcessed, &Events[4], 4);
+
+		if ((TotalEvents != Conversion->TotalEvents) || (TotalBlockEvents != Conversion->TotalEvents) ||
+		    (BytesProcessed != Conversion->Length) ||
+		    memcmp(Events, Conversion->Events, (TotalEvents * sizeof(MIDI_EventPacket_t))) ||
+		    memcmp(&Events[4], Conversion->Events, (TotalEvents * sizeof(MIDI_EventPacket_t))))
+		{
+			printf("Known conversion \"%s\" failed, %lu events produced.\n", Conversion->Name, (unsigned long)TotalEvents);
+
+			for (uint8_t j = 0; (j < TotalEvents) && (j < 4); j++)
+			  PrintEvent("Produced", &Events[j]);
+
+			Passed = false;
+		}
+	}
+
+	MIDI_StreamWriter_t Writer;
+	uint8_t             Bytes[sizeof(WriterBytes) + 3];
+	uint8_t             TotalBytes = 0;
+
+	MIDI_InitStreamWriter(&Writer);
+
+	for (uint8_t i = 0; i < (sizeof(WriterEvents) / sizeof(WriterEvents[0])); i++)
+	  TotalBytes += MIDI_ConvertEventToStream(&Writer, &WriterEvents[i], &Bytes[TotalBytes]);
+
+	if ((TotalBytes != sizeof(WriterBytes)) || memcmp(Bytes, WriterBytes, sizeof(WriterBytes)))
+	{
+		printf("Writer produced %u bytes, expected %u.\n", TotalBytes, (unsigned)sizeof(WriterBytes));
+		Passed = false;
+	}
+
+	if (Passed)
+	  printf("Known conversion test passed.\n");
+
+	return Passed;
+}
+
+/** Appends a random MIDI message to a byte stream, always including the status byte, and occasionally interleaving
+ *  Real-Time messages between its bytes.
+ *
+ *  \return Number of bytes appended.
+ */
+static uint32_t GenerateMessage(uint8_t* const Bytes)
+{
+	uint8_t  Message[64];
+	uint8_t  MessageLength;
+	uint32_t Length = 0;
+	uint32_t Type   = (Random() % 16);
+
+	if (Type < 10)
+	{
+		/* Channel messages, biased towards a few statuses so that running status is frequently applicable */
+		uint8_t Status = ((0x80 + ((Random() % 7) << 4)) | (Random() % 2));
+
+		Message[0]    = Status;
+		Message[1]    = (Random() & 0x7F);
+		Message[2]    = (Random() & 0x7F);
+		MessageLength = (((Status & 0xE0) == 0xC0) ? 2 : 3);
+	}
+	else if (Type < 13)
+	{
+		MessageLength = (2 + (Random() % (sizeof(Message) - 2)));
+
+		Message[0] = MIDI_COMMAND_SYSEX_START;
+		for (uint8_t i = 1; i < (MessageLength - 1); i++)
+		  Message[i] = (Random() & 0x7F);
+		Message[MessageLength - 1] = MIDI_COMMAND_SYSEX_END;
+	}
+	else
+	{
+		static const uint8_t SystemCommon[][2] = {{0xF1, 2}, {0xF2, 3}, {0xF3, 2}, {0xF6, 1}};
+		uint8_t              Index             = (Random() % 4);
+
+		Message[0]    = SystemCommon[Index][0];
+		Message[1]    = (Random() & 0x7F);
+		Message[2]    = (Random() & 0x7F);
+		MessageLength = SystemCommon[Index][1];
+	}
+
+	for (uint8_t i = 0; i < MessageLength; i++)
+	{
+		if (!(Random() % 8))
+		  Bytes[Length++] = (MIDI_COMMAND_REALTIME + (Random() % 8));
+
+		Bytes[Length++] = Message[i];
+	}
+
+	return Length;
+}
+
+/** Generates random MIDI streams and converts them both a byte and a block at a time, checking that both paths
+ *  produce the same event packets, then round trips the event packets through the writer and parser again.
+ *
+ *  \return Boolean \c true if all conversions agreed, \c false otherwise.
+ */
+static bool RunRoundTripTest(void)
+{
+	uint64_t TotalStreamBytes     = 0;
+	uint64_t TotalCompressedBytes = 0;
+	uint64_t TotalEventCount      = 0;
+
+	for (uint8_t Iteration = 0; Iteration < TEST_STREAM_ITERATIONS; Iteration++)
+	{
+		MIDI_StreamParser_t Parser;
+		MIDI_StreamWriter_t Writer;
+		uint32_t            StreamLength     = 0;
+		uint32_t            CompressedLength = 0;
+
+		while (StreamLength < (TEST_STREAM_LENGTH - 256))
+		  StreamLength += GenerateMessage(&StreamData[StreamLength]);
+
+		MIDI_InitStreamParser(&Parser, Iteration);
+		uint32_t TotalEvents = ConvertByBytes(&Parser, StreamData, StreamLength, ByteEvents);
+
+		MIDI_InitStreamParser(&Parser, Iteration);
+		uint32_t TotalBlockEvents = ConvertByBlocks(&Parser, StreamData, StreamLength, BlockEvents);
+
+		if (TotalBlockEvents != TotalEvents)
+		{
+			printf("Block conversion produced %lu events, byte conversion %lu.\n",
+			       (unsigned long)TotalBlockEvents, (unsigned long)TotalEvents);
+			return false;
+		}
+
+		for (uint32_t i = 0; i < TotalEvents; i++)
+		{
+			if (memcmp(&ByteEvents[i], &BlockEvents[i], sizeof(MIDI_EventPacket_t)))
+			{
+				printf("Block conversion mismatch at event %lu.\n", (unsigned long)i);
+				PrintEvent("Byte", &ByteEvents[i]);
+				PrintEvent("Block", &BlockEvents[i]);
+				return false;
+			}
+		}
+
+		MIDI_InitStreamWriter(&Writer);
+
+		for (uint32_t i = 0; i < TotalEvents; i++)
+		  CompressedLength += MIDI_ConvertEventToStream(&Writer, &ByteEvents[i], &CompressedData[CompressedLength]);
+
+		MIDI_InitStreamParser(&Parser, Iteration);
+		uint32_t TotalRoundTripEvents = ConvertByBytes(&Parser, CompressedData, CompressedLength, RoundTripEvents);
+
+		if ((TotalRoundTripEvents != TotalEvents) ||
+		    memcmp(ByteEvents, RoundTripEvents, (TotalEvents * sizeof(MIDI_EventPacket_t))))
+		{
+			printf("Round trip through the writer changed the event stream.\n");
+			return false;
+		}
+
+		TotalStreamBytes     += StreamLength;
+		TotalCompressedBytes += CompressedLength;
+		TotalEventCount      += TotalEvents;
+	}
+
+	printf("Round trip test passed %llu events, running status compressed %llu stream bytes to %llu.\n",
+	       (unsigned long long)TotalEventCount, (unsigned long long)TotalStreamBytes,
+	       (unsigned long long)TotalCompressedBytes);
+	return true;
+}
+
+/** Measures the rate at which a large System Exclusive dump is converted into event packets, a byte at a time and
+ *  through the block conversion fast path.
+ *
+ *  \return Boolean \c true if both paths produced the same packets, \c false otherwise.
+ */
+static bool RunThroughputTest(void)
+{
+	static uint8_t      SysExData[TEST_SYSEX_LENGTH];
+	MIDI_StreamParser_t Parser;
+	MIDI_EventPacket_t  Events[MIDI_STREAM_CHUNK_EVENTS];
+	uint32_t            ByteChecksum  = 0;
+	uint32_t            BlockChecksum = 0;
+	clock_t             StartTime;
+	double              ByteTime;
+	double              BlockTime;
+
+	SysExData[0] = MIDI_COMMAND_SYSEX_START;
+	for (uint32_t i = 1; i < (TEST_SYSEX_LENGTH - 1); i++)
+	  SysExData[i] = (Random() & 0x7F);
+	SysExData[TEST_SYSEX_LENGTH - 1] = MIDI_COMMAND_SYSEX_END;
+
+	MIDI_InitStreamParser(&Parser, 0);
+	StartTime = clock();
+
+	for (uint32_t i = 0; i < TEST_SYSEX_LENGTH; i++)
+	{
+		if (MIDI_ProcessStreamByte(&Parser, SysExData[i], &Events[0]))
+		  ByteChecksum += (Events[0].Event + Events[0].Data1 + Events[0].Data2 + Events[0].Data3);
+	}
+
+	ByteTime = ((double)(clock() - StartTime) / CLOCKS_PER_SEC);
+
+	MIDI_InitStreamParser(&Parser, 0);
+	StartTime = clock();
+
+	const uint8_t* Bytes  = SysExData;
+	uint32_t       Length = TEST_SYSEX_LENGTH;
+
+	while (Length)
+	{
+		uint16_t BytesProcessed;
+		uint16_t TotalEvents = MIDI_ConvertStreamToEvents(&Parser, Bytes, ((Length > 0xFFFF) ? 0xFFFF : Length),
+		                                                  &BytesProcessed, Events, MIDI_STREAM_CHUNK_EVENTS);
+
+		for (uint16_t i = 0; i < TotalEvents; i++)
+		  BlockChecksum += (Events[i].Event + Events[i].Data1 + Events[i].Data2 + Events[i].Data3);
+
+		Bytes  += BytesProcessed;
+		Length -= BytesProcessed;
+	}
+
+	BlockTime = ((double)(clock() - StartTime) / CLOCKS_PER_SEC);
+
+	printf("Byte conversion of a %lu byte SysEx dump took %.3f seconds (%.1f MB/s).\n",
+	       (unsigned long)TEST_SYSEX_LENGTH, ByteTime, ((TEST_SYSEX_LENGTH / 1048576.0) / ByteTime));
+	printf("Block conversion of a %lu byte SysEx dump took %.3f seconds (%.1f MB/s).\n",
+	       (unsigned long)TEST_SYSEX_LENGTH, BlockTime, ((TEST_SYSEX_LENGTH / 1048576.0) / BlockTime));
+
+	if (ByteChecksum != BlockChecksum)
+	{
+		printf("SysEx dump checksum mismatch between byte and block conversion.\n");
+		return false;
+	}
+
+	return true;
+}
+
+int main(void)
+{
+	if (!(RunKnownConversionTest()) || !(RunRoundTripTest()) || !(RunThroughputTest()))
+	  return EXIT_FAILURE;
+
+	return EXIT_SUCCESS;
+}
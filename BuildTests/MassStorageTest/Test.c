@@ -0,0 +1,829 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Functional test of the Mass Storage class driver's SCSI command layer, run on the simulated HOSTSIM USB
+ *  controller. The device presents three logical units: a RAM disk, a disk backed by a temporary file on the
+ *  host, and a read-only view of the upper half of the RAM disk. The virtual host acts as a Bulk-Only Transport
+ *  host, issuing SCSI commands to each unit and checking the returned data, status and sense codes, that
+ *  multiple block transfers reach the block device driver as a single request, and that UNMAP support is
+ *  advertised through the provisioning VPD pages and READ CAPACITY (16) only on units which can trim blocks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Descriptors.h"
+
+#include <LUFA/Drivers/USB/USB.h>
+
+/** Size of each block of the test logical units, in bytes. */
+#define TEST_BLOCK_SIZE       512
+
+/** Total number of blocks in the RAM disk. */
+#define TEST_RAMDISK_BLOCKS   256
+
+/** Total number of blocks in the file backed disk. */
+#define TEST_FILEDISK_BLOCKS  192
+
+/** Number of blocks transferred by each multiple block READ (10) and WRITE (10) command. */
+#define TEST_TRANSFER_BLOCKS  64
+
+/** Number of times the whole RAM disk is rewritten and read back in the throughput test. */
+#define TEST_THROUGHPUT_PASSES 256
+
+/** Logical unit numbers of the test device. */
+enum Test_LUNs_t
+{
+	TEST_LUN_RAMDisk     = 0,
+	TEST_LUN_FileDisk    = 1,
+	TEST_LUN_ReadOnly    = 2,
+	TEST_TOTAL_LUNS,
+};
+
+/** Phases of the Bulk-Only Transport command currently being issued by the virtual host. */
+enum Host_Phases_t
+{
+	HOST_PHASE_Idle,
+	HOST_PHASE_CommandBlock,
+	HOST_PHASE_Data,
+	HOST_PHASE_Status,
+};
+
+static uint8_t RAMDiskData[TEST_RAMDISK_BLOCKS * TEST_BLOCK_SIZE];
+
+static FILE*    DiskFile;
+static uint32_t FileDiskReadCalls;
+static uint32_t FileDiskWriteCalls;
+static uint32_t FileDiskFlushCalls;
+static uint32_t FileDiskTrimmedBlocks;
+
+static bool FileDisk_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                const MS_Device_LUN_t* const LUN,
+                                const uint32_t BlockAddress,
+                                const uint16_t TotalBlocks);
+static bool FileDisk_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                 const MS_Device_LUN_t* const LUN,
+                                 const uint32_t BlockAddress,
+                                 const uint16_t TotalBlocks);
+static bool FileDisk_Flush(const MS_Device_LUN_t* const LUN);
+static bool FileDisk_Trim(const MS_Device_LUN_t* const LUN,
+                          const uint32_t BlockAddress,
+                          const uint32_t TotalBlocks);
+static uint32_t FileDisk_GetTotalBlocks(const MS_Device_LUN_t* const LUN);
+
+/** Block device driver for a disk image held in a file on the host. */
+static const MS_Device_BlockDevice_t FileDiskBlockDevice =
+	{
+		.ReadBlocks     = FileDisk_ReadBlocks,
+		.WriteBlocks    = FileDisk_WriteBlocks,
+		.Flush          = FileDisk_Flush,
+		.Trim           = FileDisk_Trim,
+		.GetTotalBlocks = FileDisk_GetTotalBlocks,
+	};
+
+/** INQUIRY data reported by the file backed logical unit. */
+static const SCSI_Inquiry_Response_t FileDiskInquiryData =
+	{
+		.DeviceType          = 0x00,
+		.Removable           = true,
+		.ResponseDataFormat  = 2,
+		.AdditionalLength    = 0x1F,
+
+		.VendorID            = "LUFA",
+		.ProductID           = "Host File Disk",
+		.RevisionID          = {'0','.','0','0'},
+	};
+
+/** Logical units of the test device. */
+static const MS_Device_LUN_t Test_LUNs[TEST_TOTAL_LUNS] =
+	{
+		[TEST_LUN_RAMDisk] =
+			{
+				.BlockDevice = &MS_Device_RAMDiskBlockDevice,
+				.Context     = RAMDiskData,
+				.BlockOffset = 0,
+				.TotalBlocks = TEST_RAMDISK_BLOCKS,
+				.BlockSize   = TEST_BLOCK_SIZE,
+			},
+		[TEST_LUN_FileDisk] =
+			{
+				.BlockDevice = &FileDiskBlockDevice,
+				.TotalBlocks = 0,
+				.BlockSize   = TEST_BLOCK_SIZE,
+				.InquiryData = &FileDiskInquiryData,
+			},
+		[TEST_LUN_ReadOnly] =
+			{
+				.BlockDevice = &MS_Device_RAMDiskBlockDevice,
+				.Context     = RAMDiskData,
+				.BlockOffset = (TEST_RAMDISK_BLOCKS / 2),
+				.TotalBlocks = (TEST_RAMDISK_BLOCKS / 2),
+				.BlockSize   = TEST_BLOCK_SIZE,
+				.ReadOnly    = true,
+			},
+	};
+
+/** LUFA Mass Storage Class driver interface configuration and state information. */
+static USB_ClassInfo_MS_Device_t Test_MS_Interface =
+	{
+		.Config =
+			{
+				.InterfaceNumber           = 0,
+				.DataINEndpoint            =
+					{
+						.Address           = MASS_STORAGE_IN_EPADDR,
+						.Size              = MASS_STORAGE_IO_EPSIZE,
+						.Banks             = 2,
+					},
+				.DataOUTEndpoint           =
+					{
+						.Address           = MASS_STORAGE_OUT_EPADDR,
+						.Size              = MASS_STORAGE_IO_EPSIZE,
+						.Banks             = 2,
+					},
+				.TotalLUNs                 = TEST_TOTAL_LUNS,
+				.LUNs                      = Test_LUNs,
+			},
+	};
+
+/** State of the command currently being issued by the virtual host. */
+static struct
+{
+	uint8_t  Phase;
+
+	MS_CommandBlockWrapper_t  CommandBlock;
+	MS_CommandStatusWrapper_t CommandStatus;
+
+	uint8_t* Data;
+	uint32_t DataTransferred;
+} HostCommand;
+
+static uint8_t TestPattern(const uint8_t LUN,
+                           const uint32_t Offset)
+{
+	return (uint8_t)((Offset * 13) ^ (Offset >> 9) ^ (LUN << 4));
+}
+
+/** Host side of the test, run by the virtual host whenever the device waits on the bus. This moves the current
+ *  command through the command block, data and status phases of the Bulk-Only Transport protocol.
+ */
+static void HostTask(void)
+{
+	uint32_t DataLength = le32_to_cpu(HostCommand.CommandBlock.DataTransferLength);
+	uint16_t PacketLength;
+
+	for (;;)
+	{
+		switch (HostCommand.Phase)
+		{
+			case HOST_PHASE_CommandBlock:
+				if (!(USB_VirtualHost_SendOUT(MASS_STORAGE_OUT_EPADDR, &HostCommand.CommandBlock,
+				                              sizeof(MS_CommandBlockWrapper_t))))
+				{
+					return;
+				}
+
+				HostCommand.Phase = (DataLength) ? HOST_PHASE_Data : HOST_PHASE_Status;
+				break;
+			case HOST_PHASE_Data:
+				PacketLength = MIN(MASS_STORAGE_IO_EPSIZE, DataLength - HostCommand.DataTransferred);
+
+				if (HostCommand.CommandBlock.Flags & MS_COMMAND_DIR_DATA_IN)
+				{
+					if (!(USB_VirtualHost_ReceiveIN(MASS_STORAGE_IN_EPADDR, &HostCommand.Data[HostCommand.DataTransferred],
+					                                &PacketLength)))
+					{
+						return;
+					}
+
+					/* A short packet ends the data phase early */
+					if (PacketLength < MASS_STORAGE_IO_EPSIZE)
+					  HostCommand.Phase = HOST_PHASE_Status;
+				}
+				else
+				{
+					if (!(USB_VirtualHost_SendOUT(MASS_STORAGE_OUT_EPADDR, &HostCommand.Data[HostCommand.DataTransferred],
+					                              PacketLength)))
+					{
+						return;
+					}
+				}
+
+				HostCommand.DataTransferred += PacketLength;
+
+				if (HostCommand.DataTransferred == DataLength)
+				  HostCommand.Phase = HOST_PHASE_Status;
+
+				break;
+			case HOST_PHASE_Status:
+				PacketLength = sizeof(MS_CommandStatusWrapper_t);
+
+				if (!(USB_VirtualHost_ReceiveIN(MASS_STORAGE_IN_EPADDR, &HostCommand.CommandStatus, &PacketLength)))
+				  return;
+
+				HostCommand.Phase = HOST_PHASE_Idle;
+				break;
+			default:
+				return;
+		}
+	}
+}
+
+/** Issues a SCSI command to the given logical unit of the device, returning \c true if the device reported that the
+ *  command passed and the command status was valid.
+ */
+static bool SCSI_Command(const uint8_t LUN,
+                         const uint8_t* const CommandData,
+                         const uint8_t CommandLength,
+                         const bool IsDataIn,
+                         void* const Data,
+                         const uint32_t DataLength)
+{
+	static uint32_t Tag;
+
+	memset(&HostCommand, 0x00, sizeof(HostCommand));
+
+	HostCommand.CommandBlock.Signature          = CPU_TO_LE32(MS_CBW_SIGNATURE);
+	HostCommand.CommandBlock.Tag                = cpu_to_le32(++Tag);
+	HostCommand.CommandBlock.DataTransferLength = cpu_to_le32(DataLength);
+	HostCommand.CommandBlock.Flags              = (IsDataIn ? MS_COMMAND_DIR_DATA_IN : MS_COMMAND_DIR_DATA_OUT);
+	HostCommand.CommandBlock.LUN                = LUN;
+	HostCommand.CommandBlock.SCSICommandLength  = CommandLength;
+	memcpy(HostCommand.CommandBlock.SCSICommandData, CommandData, CommandLength);
+
+	HostCommand.Data  = Data;
+	HostCommand.Phase = HOST_PHASE_CommandBlock;
+
+	while (HostCommand.Phase != HOST_PHASE_Idle)
+	{
+		MS_Device_USBTask(&Test_MS_Interface);
+		USB_USBTask();
+
+		HostTask();
+	}
+
+	if ((HostCommand.CommandStatus.Signature != CPU_TO_LE32(MS_CSW_SIGNATURE)) ||
+	    (HostCommand.CommandStatus.Tag       != HostCommand.CommandBlock.Tag))
+	{
+		printf("Invalid command status for SCSI command 0x%02X.\n", CommandData[0]);
+		return false;
+	}
+
+	if (HostCommand.CommandStatus.Status != MS_SCSI_COMMAND_Pass)
+	  return false;
+
+	return (le32_to_cpu(HostCommand.CommandStatus.DataTransferResidue) == 0);
+}
+
+/** Issues a READ (10) or WRITE (10) command for the given block range. */
+static bool SCSI_ReadWrite10(const uint8_t LUN,
+                             const bool IsDataRead,
+                             const uint32_t BlockAddress,
+                             const uint16_t TotalBlocks,
+                             void* const Data,
+                             const uint32_t DataLength)
+{
+	uint8_t CommandData[10] =
+		{
+			(IsDataRead ? SCSI_CMD_READ_10 : SCSI_CMD_WRITE_10), 0x00,
+			(BlockAddress >> 24), (BlockAddress >> 16), (BlockAddress >> 8), BlockAddress,
+			0x00,
+			(TotalBlocks >> 8), TotalBlocks,
+			0x00
+		};
+
+	return SCSI_Command(LUN, CommandData, sizeof(CommandData), IsDataRead, Data, DataLength);
+}
+
+/** Checks that the sense data reported by the device for the last command matches the given values. */
+static bool SCSI_CheckSense(const uint8_t LUN,
+                            const uint8_t SenseKey,
+                            const uint8_t AdditionalSenseCode)
+{
+	uint8_t CommandData[6] = {SCSI_CMD_REQUEST_SENSE, 0x00, 0x00, 0x00, sizeof(SCSI_Request_Sense_Response_t), 0x00};
+	SCSI_Request_Sense_Response_t SenseData;
+
+	if (!(SCSI_Command(LUN, CommandData, sizeof(CommandData), true, &SenseData, sizeof(SenseData))))
+	  return false;
+
+	return ((SenseData.ResponseCode == 0x70) && (SenseData.SenseKey == SenseKey) &&
+	        (SenseData.AdditionalSenseCode == AdditionalSenseCode));
+}
+
+static bool Test_Identification(void)
+{
+	uint8_t InquiryCommand[6]      = {SCSI_CMD_INQUIRY, 0x00, 0x00, 0x00, sizeof(SCSI_Inquiry_Response_t), 0x00};
+	uint8_t TestUnitReadyCommand[6] = {SCSI_CMD_TEST_UNIT_READY};
+	uint8_t ReadCapacityCommand[10] = {SCSI_CMD_READ_CAPACITY_10};
+	uint8_t ModeSenseCommand[6]     = {SCSI_CMD_MODE_SENSE_6, 0x00, 0x3F, 0x00, 4, 0x00};
+
+	const uint32_t ExpectedBlocks[TEST_TOTAL_LUNS] =
+		{
+			[TEST_LUN_RAMDisk]  = TEST_RAMDISK_BLOCKS,
+			[TEST_LUN_FileDisk] = TEST_FILEDISK_BLOCKS,
+			[TEST_LUN_ReadOnly] = (TEST_RAMDISK_BLOCKS / 2),
+		};
+
+	for (uint8_t LUN = 0; LUN < TEST_TOTAL_LUNS; LUN++)
+	{
+		SCSI_Inquiry_Response_t InquiryData;
+		uint8_t                 Capacity[8];
+		uint8_t                 ModeHeader[4];
+
+		if (!(SCSI_Command(LUN, InquiryCommand, sizeof(InquiryCommand), true, &InquiryData, sizeof(InquiryData))) ||
+		    memcmp(InquiryData.VendorID, "LUFA", 4) ||
+		    memcmp(InquiryData.ProductID, ((LUN == TEST_LUN_FileDisk) ? "Host File Disk" : "Block Device"), 12))
+		{
+			printf("INQUIRY failed on LUN %u.\n", LUN);
+			return false;
+		}
+
+		if (!(SCSI_Command(LUN, TestUnitReadyCommand, sizeof(TestUnitReadyCommand), false, NULL, 0)))
+		{
+			printf("TEST UNIT READY failed on LUN %u.\n", LUN);
+			return false;
+		}
+
+		if (!(SCSI_Command(LUN, ReadCapacityCommand, sizeof(ReadCapacityCommand), true, Capacity, sizeof(Capacity))) ||
+		    (((uint32_t)Capacity[0] << 24 | (uint32_t)Capacity[1] << 16 | Capacity[2] << 8 | Capacity[3]) != (ExpectedBlocks[LUN] - 1)) ||
+		    ((Capacity[6] << 8 | Capacity[7]) != TEST_BLOCK_SIZE))
+		{
+			printf("READ CAPACITY (10) failed on LUN %u.\n", LUN);
+			return false;
+		}
+
+		if (!(SCSI_Command(LUN, ModeSenseCommand, sizeof(ModeSenseCommand), true, ModeHeader, sizeof(ModeHeader))) ||
+		    ((ModeHeader[2] & 0x80) != ((LUN == TEST_LUN_ReadOnly) ? 0x80 : 0x00)))
+		{
+			printf("MODE SENSE (6) failed on LUN %u.\n", LUN);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool Test_MultipleBlockTransfers(void)
+{
+	static uint8_t WriteData[TEST_TRANSFER_BLOCKS * TEST_BLOCK_SIZE];
+	static uint8_t ReadData[TEST_TRANSFER_BLOCKS * TEST_BLOCK_SIZE];
+
+	for (uint8_t LUN = TEST_LUN_RAMDisk; LUN <= TEST_LUN_FileDisk; LUN++)
+	{
+		for (uint32_t i = 0; i < sizeof(WriteData); i++)
+		  WriteData[i] = TestPattern(LUN, i);
+
+		FileDiskReadCalls  = 0;
+		FileDiskWriteCalls = 0;
+
+		if (!(SCSI_ReadWrite10(LUN, false, 16, TEST_TRANSFER_BLOCKS, WriteData, sizeof(WriteData))) ||
+		    !(SCSI_ReadWrite10(LUN, true, 16, TEST_TRANSFER_BLOCKS, ReadData, sizeof(ReadData))) ||
+		    memcmp(WriteData, ReadData, sizeof(ReadData)))
+		{
+			printf("Multiple block transfer failed on LUN %u.\n", LUN);
+			return false;
+		}
+
+		if ((LUN == TEST_LUN_FileDisk) && ((FileDiskWriteCalls != 1) || (FileDiskReadCalls != 1)))
+		{
+			printf("Multiple block transfer split into %lu writes and %lu reads.\n",
+			       (unsigned long)FileDiskWriteCalls, (unsigned long)FileDiskReadCalls);
+			return false;
+		}
+	}
+
+	/* The read-only unit maps onto the upper half of the RAM disk, so must see data written there via the RAM disk unit */
+	for (uint32_t i = 0; i < (4 * TEST_BLOCK_SIZE); i++)
+	  WriteData[i] = TestPattern(TEST_LUN_ReadOnly, i);
+
+	if (!(SCSI_ReadWrite10(TEST_LUN_RAMDisk, false, (TEST_RAMDISK_BLOCKS / 2), 4, WriteData, (4 * TEST_BLOCK_SIZE))) ||
+	    !(SCSI_ReadWrite10(TEST_LUN_ReadOnly, true, 0, 4, ReadData, (4 * TEST_BLOCK_SIZE))) ||
+	    memcmp(WriteData, ReadData, (4 * TEST_BLOCK_SIZE)))
+	{
+		printf("Logical unit block offset not applied.\n");
+		return false;
+	}
+
+	return true;
+}
+
+static bool Test_ErrorHandling(void)
+{
+	uint8_t UnknownCommand[6] = {0xFF};
+
+	if (SCSI_ReadWrite10(TEST_LUN_ReadOnly, false, 0, 1, NULL, 0) ||
+	    !(SCSI_CheckSense(TEST_LUN_ReadOnly, SCSI_SENSE_KEY_DATA_PROTECT, SCSI_ASENSE_WRITE_PROTECTED)))
+	{
+		printf("Write to read-only LUN not rejected.\n");
+		return false;
+	}
+
+	if (SCSI_ReadWrite10(TEST_LUN_RAMDisk, true, (TEST_RAMDISK_BLOCKS - 1), 2, NULL, 0) ||
+	    !(SCSI_CheckSense(TEST_LUN_RAMDisk, SCSI_SENSE_KEY_ILLEGAL_REQUEST, SCSI_ASENSE_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE)))
+	{
+		printf("Out of range read not rejected.\n");
+		return false;
+	}
+
+	if (SCSI_ReadWrite10(TEST_LUN_RAMDisk, true, 0, 2, NULL, 0) ||
+	    !(SCSI_CheckSense(TEST_LUN_RAMDisk, SCSI_SENSE_KEY_ILLEGAL_REQUEST, SCSI_ASENSE_INVALID_FIELD_IN_CDB)))
+	{
+		printf("Read larger than the host transfer length not rejected.\n");
+		return false;
+	}
+
+	if (SCSI_Command(TEST_LUN_FileDisk, UnknownCommand, sizeof(UnknownCommand), false, NULL, 0) ||
+	    !(SCSI_CheckSense(TEST_LUN_FileDisk, SCSI_SENSE_KEY_ILLEGAL_REQUEST, SCSI_ASENSE_INVALID_COMMAND)))
+	{
+		printf("Unsupported command not rejected.\n");
+		return false;
+	}
+
+	if (!(SCSI_CheckSense(TEST_LUN_FileDisk, SCSI_SENSE_KEY_GOOD, SCSI_ASENSE_NO_ADDITIONAL_INFORMATION)))
+	{
+		printf("Sense data not cleared after a successful command.\n");
+		return false;
+	}
+
+	return true;
+}
+
+static bool Test_CacheAndTrim(void)
+{
+	static uint8_t BlockData[4 * TEST_BLOCK_SIZE];
+
+	uint8_t SynchronizeCacheCommand[10] = {SCSI_CMD_SYNCHRONIZE_CACHE_10};
+	uint8_t WriteFUACommand[10]         = {SCSI_CMD_WRITE_10, (1 << 3), 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 4, 0x00};
+	uint8_t UnmapCommand[10]            = {SCSI_CMD_UNMAP, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 40, 0x00};
+	uint8_t UnmapParameters[40]         =
+		{
+			0x00, 38, 0x00, 32, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+		};
+
+	FileDiskFlushCalls = 0;
+
+	if (!(SCSI_Command(TEST_LUN_FileDisk, SynchronizeCacheCommand, sizeof(SynchronizeCacheCommand), false, NULL, 0)) ||
+	    !(SCSI_Command(TEST_LUN_RAMDisk, SynchronizeCacheCommand, sizeof(SynchronizeCacheCommand), false, NULL, 0)) ||
+	    (FileDiskFlushCalls != 1))
+	{
+		printf("SYNCHRONIZE CACHE (10) failed.\n");
+		return false;
+	}
+
+	memset(BlockData, 0xA5, sizeof(BlockData));
+
+	if (!(SCSI_Command(TEST_LUN_FileDisk, WriteFUACommand, sizeof(WriteFUACommand), false, BlockData, sizeof(BlockData))) ||
+	    (FileDiskFlushCalls != 2))
+	{
+		printf("Force Unit Access write not flushed.\n");
+		return false;
+	}
+
+	if (!(SCSI_Command(TEST_LUN_FileDisk, UnmapCommand, sizeof(UnmapCommand), false, UnmapParameters, sizeof(UnmapParameters))) ||
+	    (FileDiskTrimmedBlocks != 3) ||
+	    !(SCSI_ReadWrite10(TEST_LUN_FileDisk, true, 0x20, 4, BlockData, sizeof(BlockData))))
+	{
+		printf("UNMAP failed.\n");
+		return false;
+	}
+
+	for (uint16_t i = 0; i < sizeof(BlockData); i++)
+	{
+		if (BlockData[i] != (((i / TEST_BLOCK_SIZE) == 3) ? 0xA5 : 0x00))
+		{
+			printf("UNMAP discarded the wrong blocks.\n");
+			return false;
+		}
+	}
+
+	if (SCSI_Command(TEST_LUN_RAMDisk, UnmapCommand, sizeof(UnmapCommand), false, NULL, 0) ||
+	    !(SCSI_CheckSense(TEST_LUN_RAMDisk, SCSI_SENSE_KEY_ILLEGAL_REQUEST, SCSI_ASENSE_INVALID_COMMAND)))
+	{
+		printf("UNMAP not rejected by a block device without trim support.\n");
+		return false;
+	}
+
+	return true;
+}
+
+static bool Test_Provisioning(void)
+{
+	uint8_t SupportedPagesCommand[6]        = {SCSI_CMD_INQUIRY, 0x01, SCSI_VPD_PAGE_SUPPORTED_PAGES, 0x00, 7, 0x00};
+	uint8_t BlockLimitsCommand[6]           = {SCSI_CMD_INQUIRY, 0x01, SCSI_VPD_PAGE_BLOCK_LIMITS, 0x00, 64, 0x00};
+	uint8_t ProvisioningCommand[6]          = {SCSI_CMD_INQUIRY, 0x01, SCSI_VPD_PAGE_LOGICAL_BLOCK_PROVISIONING, 0x00, 8, 0x00};
+	uint8_t UnsupportedPageCommand[6]       = {SCSI_CMD_INQUIRY, 0x01, 0x83, 0x00, 0, 0x00};
+	uint8_t StandardPageCodeCommand[6]      = {SCSI_CMD_INQUIRY, 0x00, SCSI_VPD_PAGE_BLOCK_LIMITS, 0x00, 0, 0x00};
+	uint8_t ReadCapacity16Command[16]       = {SCSI_CMD_SERVICE_ACTION_IN_16, SCSI_SERVICE_ACTION_READ_CAPACITY_16,
+	                                           0, 0, 0, 0, 0, 0, 0, 0, 0x00, 0x00, 0x00, 32, 0x00, 0x00};
+	uint8_t UnknownServiceActionCommand[16] = {SCSI_CMD_SERVICE_ACTION_IN_16, 0x11};
+
+	static const uint8_t ExpectedSupportedPages[7] =
+		{0x00, SCSI_VPD_PAGE_SUPPORTED_PAGES, 0x00, 3,
+		 SCSI_VPD_PAGE_SUPPORTED_PAGES, SCSI_VPD_PAGE_BLOCK_LIMITS, SCSI_VPD_PAGE_LOGICAL_BLOCK_PROVISIONING};
+
+	const uint32_t ExpectedBlocks[TEST_TOTAL_LUNS] =
+		{
+			[TEST_LUN_RAMDisk]  = TEST_RAMDISK_BLOCKS,
+			[TEST_LUN_FileDisk] = TEST_FILEDISK_BLOCKS,
+			[TEST_LUN_ReadOnly] = (TEST_RAMDISK_BLOCKS / 2),
+		};
+
+	/* Only writable units whose block device can trim blocks may advertise UNMAP support to the host */
+	for (uint8_t LUN = 0; LUN < TEST_TOTAL_LUNS; LUN++)
+	{
+		bool    SupportsUnmap = (LUN == TEST_LUN_FileDisk);
+		uint8_t SupportedPages[7];
+		uint8_t BlockLimits[64];
+		uint8_t Provisioning[8];
+		uint8_t Capacity[32];
+
+		if (!(SCSI_Command(LUN, SupportedPagesCommand, sizeof(SupportedPagesCommand), true, SupportedPages, sizeof(SupportedPages))) ||
+		    memcmp(SupportedPages, ExpectedSupportedPages, sizeof(ExpectedSupportedPages)))
+		{
+			printf("Supported VPD Pages page incorrect on LUN %u.\n", LUN);
+			return false;
+		}
+
+		if (!(SCSI_Command(LUN, BlockLimitsCommand, sizeof(BlockLimitsCommand), true, BlockLimits, sizeof(BlockLimits))) ||
+		    (BlockLimits[1] != SCSI_VPD_PAGE_BLOCK_LIMITS) || (BlockLimits[3] != 0x3C) ||
+		    ((((uint32_t)BlockLimits[20] << 24) | ((uint32_t)BlockLimits[21] << 16) | (BlockLimits[22] << 8) | BlockLimits[23]) !=
+		     (SupportsUnmap ? 0xFFFFFFFF : 0)) ||
+		    ((((uint32_t)BlockLimits[24] << 24) | ((uint32_t)BlockLimits[25] << 16) | (BlockLimits[26] << 8) | BlockLimits[27]) !=
+		     (SupportsUnmap ? ((0xFFFF - 8) / 16) : 0)))
+		{
+			printf("Block Limits VPD page incorrect on LUN %u.\n", LUN);
+			return false;
+		}
+
+		if (!(SCSI_Command(LUN, ProvisioningCommand, sizeof(ProvisioningCommand), true, Provisioning, sizeof(Provisioning))) ||
+		    (Provisioning[1] != SCSI_VPD_PAGE_LOGICAL_BLOCK_PROVISIONING) || (Provisioning[3] != 4) ||
+		    ((Provisioning[5] & 0x80) != (SupportsUnmap ? 0x80 : 0x00)))
+		{
+			printf("Logical Block Provisioning VPD page incorrect on LUN %u.\n", LUN);
+			return false;
+		}
+
+		if (!(SCSI_Command(LUN, ReadCapacity16Command, sizeof(ReadCapacity16Command), true, Capacity, sizeof(Capacity))) ||
+		    (((uint32_t)Capacity[0] | Capacity[1] | Capacity[2] | Capacity[3]) != 0) ||
+		    ((((uint32_t)Capacity[4] << 24) | ((uint32_t)Capacity[5] << 16) | (Capacity[6] << 8) | Capacity[7]) != (ExpectedBlocks[LUN] - 1)) ||
+		    ((((uint32_t)Capacity[8] << 24) | ((uint32_t)Capacity[9] << 16) | (Capacity[10] << 8) | Capacity[11]) != TEST_BLOCK_SIZE) ||
+		    ((Capacity[14] & 0x80) != (SupportsUnmap ? 0x80 : 0x00)))
+		{
+			printf("READ CAPACITY (16) failed on LUN %u.\n", LUN);
+			return false;
+		}
+	}
+
+	if (SCSI_Command(TEST_LUN_FileDisk, UnsupportedPageCommand, sizeof(UnsupportedPageCommand), true, NULL, 0) ||
+	    !(SCSI_CheckSense(TEST_LUN_FileDisk, SCSI_SENSE_KEY_ILLEGAL_REQUEST, SCSI_ASENSE_INVALID_FIELD_IN_CDB)))
+	{
+		printf("Unsupported VPD page not rejected.\n");
+		return false;
+	}
+
+	if (SCSI_Command(TEST_LUN_FileDisk, StandardPageCodeCommand, sizeof(StandardPageCodeCommand), true, NULL, 0) ||
+	    !(SCSI_CheckSense(TEST_LUN_FileDisk, SCSI_SENSE_KEY_ILLEGAL_REQUEST, SCSI_ASENSE_INVALID_FIELD_IN_CDB)))
+	{
+		printf("Page code without EVPD not rejected.\n");
+		return false;
+	}
+
+	if (SCSI_Command(TEST_LUN_FileDisk, UnknownServiceActionCommand, sizeof(UnknownServiceActionCommand), true, NULL, 0) ||
+	    !(SCSI_CheckSense(TEST_LUN_FileDisk, SCSI_SENSE_KEY_ILLEGAL_REQUEST, SCSI_ASENSE_INVALID_FIELD_IN_CDB)))
+	{
+		printf("Unsupported SERVICE ACTION IN (16) action not rejected.\n");
+		return false;
+	}
+
+	return true;
+}
+
+static bool Test_Throughput(void)
+{
+	static uint8_t TransferData[TEST_TRANSFER_BLOCKS * TEST_BLOCK_SIZE];
+	uint32_t BytesTransferred = 0;
+
+	clock_t StartTime = clock();
+
+	for (uint16_t Pass = 0; Pass < TEST_THROUGHPUT_PASSES; Pass++)
+	{
+		for (uint32_t BlockAddress = 0; BlockAddress < TEST_RAMDISK_BLOCKS; BlockAddress += TEST_TRANSFER_BLOCKS)
+		{
+			if (!(SCSI_ReadWrite10(TEST_LUN_RAMDisk, (Pass & 1), BlockAddress, TEST_TRANSFER_BLOCKS,
+			                       TransferData, sizeof(TransferData))))
+			{
+				printf("Throughput test transfer failed.\n");
+				return false;
+			}
+
+			BytesTransferred += sizeof(TransferData);
+		}
+	}
+
+	double ElapsedTime = ((double)(clock() - StartTime) / CLOCKS_PER_SEC);
+
+	printf("Transferred %lu bytes through READ (10) and WRITE (10) in %.3f seconds (%.1f KB/s).\n",
+	       (unsigned long)BytesTransferred, ElapsedTime, (BytesTransferred / 1024.0) / ((ElapsedTime > 0) ? ElapsedTime : 1));
+
+	return true;
+}
+
+int main(void)
+{
+	static uint8_t EmptyBlock[TEST_BLOCK_SIZE];
+
+	DiskFile = tmpfile();
+
+	for (uint16_t Block = 0; DiskFile && (Block < TEST_FILEDISK_BLOCKS); Block++)
+	  fwrite(EmptyBlock, sizeof(EmptyBlock), 1, DiskFile);
+
+	if (!(DiskFile) || fflush(DiskFile))
+	{
+		printf("Could not create disk image file.\n");
+		return EXIT_FAILURE;
+	}
+
+	USB_Init(USB_DEVICE_OPT_FULLSPEED);
+	GlobalInterruptEnable();
+
+	if (USB_VirtualHost_Enumerate(1) != VHOST_CONTROL_NoError)
+	{
+		printf("Enumeration failed.\n");
+		return EXIT_FAILURE;
+	}
+
+	USB_Request_Header_t GetMaxLUN =
+		{
+			.bmRequestType = (REQDIR_DEVICETOHOST | REQTYPE_CLASS | REQREC_INTERFACE),
+			.bRequest      = MS_REQ_GetMaxLUN,
+			.wValue        = 0,
+			.wIndex        = 0,
+			.wLength       = 1,
+		};
+
+	uint8_t MaxLUN;
+
+	if ((USB_VirtualHost_ControlRequest(&GetMaxLUN, &MaxLUN) != VHOST_CONTROL_NoError) ||
+	    (MaxLUN != (TEST_TOTAL_LUNS - 1)))
+	{
+		printf("Class control request failed.\n");
+		return EXIT_FAILURE;
+	}
+
+	USB_VirtualHost_SetIdleHandler(HostTask);
+
+	if (!(Test_Identification()) || !(Test_MultipleBlockTransfers()) || !(Test_ErrorHandling()) ||
+	    !(Test_CacheAndTrim()) || !(Test_Provisioning()) || !(Test_Throughput()))
+	{
+		return EXIT_FAILURE;
+	}
+
+	printf("All SCSI command tests passed.\n");
+
+	fclose(DiskFile);
+	return EXIT_SUCCESS;
+}
+
+void EVENT_USB_Device_ConfigurationChanged(void)
+{
+	MS_Device_ConfigureEndpoints(&Test_MS_Interface);
+}
+
+void EVENT_USB_Device_ControlRequest(void)
+{
+	MS_Device_ProcessControlRequest(&Test_MS_Interface);
+}
+
+bool CALLBACK_MS_Device_SCSICommandReceived(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
+{
+	return MS_Device_ProcessSCSICommand(MSInterfaceInfo);
+}
+
+static bool FileDisk_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                const MS_Device_LUN_t* const LUN,
+                                const uint32_t BlockAddress,
+                                const uint16_t TotalBlocks)
+{
+	uint8_t BlockData[TEST_BLOCK_SIZE];
+
+	FileDiskReadCalls++;
+
+	if (fseek(DiskFile, ((long)BlockAddress * LUN->BlockSize), SEEK_SET))
+	  return false;
+
+	for (uint16_t BlockIndex = 0; BlockIndex < TotalBlocks; BlockIndex++)
+	{
+		if (fread(BlockData, sizeof(BlockData), 1, DiskFile) != 1)
+		  return false;
+
+		if (Endpoint_Write_Stream_LE(BlockData, sizeof(BlockData), NULL) != ENDPOINT_RWSTREAM_NoError)
+		  return false;
+
+		if (MSInterfaceInfo->State.IsMassStoreReset)
+		  return false;
+	}
+
+	if (Endpoint_BytesInEndpoint())
+	  Endpoint_ClearIN();
+
+	return true;
+}
+
+static bool FileDisk_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                 const MS_Device_LUN_t* const LUN,
+                                 const uint32_t BlockAddress,
+                                 const uint16_t TotalBlocks)
+{
+	uint8_t BlockData[TEST_BLOCK_SIZE];
+
+	FileDiskWriteCalls++;
+
+	if (fseek(DiskFile, ((long)BlockAddress * LUN->BlockSize), SEEK_SET))
+	  return false;
+
+	for (uint16_t BlockIndex = 0; BlockIndex < TotalBlocks; BlockIndex++)
+	{
+		if (Endpoint_Read_Stream_LE(BlockData, sizeof(BlockData), NULL) != ENDPOINT_RWSTREAM_NoError)
+		  return false;
+
+		if (fwrite(BlockData, sizeof(BlockData), 1, DiskFile) != 1)
+		  return false;
+
+		if (MSInterfaceInfo->State.IsMassStoreReset)
+		  return false;
+	}
+
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearOUT();
+
+	return true;
+}
+
+static bool FileDisk_Flush(const MS_Device_LUN_t* const LUN)
+{
+	(void)LUN;
+
+	FileDiskFlushCalls++;
+
+	return (fflush(DiskFile) == 0);
+}
+
+static bool FileDisk_Trim(const MS_Device_LUN_t* const LUN,
+                          const uint32_t BlockAddress,
+                          const uint32_t TotalBlocks)
+{
+	static const uint8_t EmptyBlock[TEST_BLOCK_SIZE];
+
+	if (fseek(DiskFile, ((long)BlockAddress * LUN->BlockSize), SEEK_SET))
+	  return false;
+
+	for (uint32_t BlockIndex = 0; BlockIndex < TotalBlocks; BlockIndex++)
+	{
+		if (fwrite(EmptyBlock, sizeof(EmptyBlock), 1, DiskFile) != 1)
+		  return false;
+	}
+
+	FileDiskTrimmedBlocks += TotalBlocks;
+	return true;
+}
+
+static uint32_t FileDisk_GetTotalBlocks(const MS_Device_LUN_t* const LUN)
+{
+	if (fseek(DiskFile, 0, SEEK_END))
+	  return 0;
+
+	return (ftell(DiskFile) / LUN->BlockSize);
+}
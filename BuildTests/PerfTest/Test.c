@@ -0,0 +1,708 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Cycle counting micro-benchmarks of the library's most frequently executed code paths, run under an AVR
+ *  simulator. Each benchmark is timed with the 16-bit Timer 1 clocked directly from the CPU clock, extended to
+ *  32 bits by counting its overflows, and the overhead of an empty benchmark is subtracted from each result.
+ *  One line is written per benchmark to the simulator console register, giving the benchmark name, the number
+ *  of CPU cycles taken and the number of data bytes processed.
+ *
+ *  The endpoint and pipe stream benchmarks rely on the simulator treating the USB controller registers as plain
+ *  memory, as is the case when the simulator has no model of the USB controller. Each endpoint or pipe is set up
+ *  with a full (or empty) bank that never needs to be released, so that the benchmark measures only the cost of
+ *  moving the data through the stream functions.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <LUFA/Drivers/USB/USB.h>
+#include <LUFA/Drivers/USB/Class/HIDClass.h>
+#include <LUFA/Drivers/USB/Class/MassStorageClass.h>
+#include <LUFA/Drivers/Misc/RingBuffer.h>
+#include <LUFA/Drivers/Misc/SPSCRingBuffer.h>
+
+#include "Lib/Ethernet.h"
+
+/** Register written with each character of the benchmark results, read by the simulator as its console. */
+#define PERF_CONSOLE_REG      GPIOR0
+
+/** Size of the device's internal SRAM, in bytes. */
+#define PERF_RAM_SIZE         (RAMEND - RAMSTART + 1)
+
+/** Number of bytes transferred by each stream and ring buffer benchmark. */
+#define PERF_DATA_SIZE        64
+
+/** Size of the single block of the RAM disk read by the SCSI benchmark, reduced on devices with little RAM. */
+#if (PERF_RAM_SIZE >= 4096)
+	#define PERF_BLOCK_SIZE   512
+#else
+	#define PERF_BLOCK_SIZE   64
+#endif
+
+/** Maximum length of a benchmark name, in characters. */
+#define PERF_MAX_NAME_LENGTH  27
+
+/** Indicates if the device has enough RAM for the full HID parser's report item table. */
+#define PERF_FULL_HID_PARSER  (PERF_RAM_SIZE >= 2048)
+
+#if defined(PERF_SIMAVR)
+	#include <avr_mcu_section.h>
+
+	AVR_MCU(F_CPU, PERF_MCU_NAME);
+	AVR_MCU_SIMAVR_CONSOLE(&PERF_CONSOLE_REG);
+#endif
+
+/** Type define for a benchmark in the benchmark table. */
+typedef struct
+{
+	char Name[PERF_MAX_NAME_LENGTH + 1]; /**< Name of the benchmark, as reported in the results. */
+	void (*Setup)(void); /**< Optional function to prepare the benchmark, not included in the timing. */
+	bool (*Run)(void); /**< Function to time, returning \c true if the benchmarked code completed successfully. */
+	uint16_t Bytes; /**< Number of data bytes processed by each run, for calculating the per-byte cost. */
+} Perf_Benchmark_t;
+
+/** Number of Timer 1 overflows since the current measurement was started. */
+static volatile uint16_t TimerOverflows;
+
+/** Number of cycles taken by an empty benchmark, subtracted from each result. */
+static uint32_t Perf_Overhead;
+
+/** Source and destination buffer for the stream, checksum and ring buffer benchmarks. */
+static uint8_t PerfData[PERF_DATA_SIZE];
+
+/** Storage for the ring buffer benchmarks. */
+static uint8_t RingBufferData[PERF_DATA_SIZE];
+
+/** Ring buffer used by the \ref RingBuffer_t benchmarks. */
+static RingBuffer_t PerfRingBuffer;
+
+/** Ring buffer used by the \ref SPSCRingBuffer_t benchmarks. */
+static SPSCRingBuffer_t PerfSPSCRingBuffer;
+
+/** Report descriptor of the Keyboard demo. */
+static const uint8_t Keyboard_Report[] =
+{
+	HID_DESCRIPTOR_KEYBOARD(6)
+};
+
+/** Report descriptor of the Mouse demo. */
+static const uint8_t Mouse_Report[] =
+{
+	HID_DESCRIPTOR_MOUSE(-1, 1, -1, 1, 3, false)
+};
+
+#if PERF_FULL_HID_PARSER
+/** Report item table filled by the full HID parser benchmarks. */
+static HID_ReportInfo_t HIDReportInfo;
+#endif
+
+/** Number of report items passed to the stream HID parser's callback. */
+static uint8_t HIDStreamItems;
+
+/** Result of the last Ethernet checksum benchmark. */
+static volatile uint16_t EthernetChecksum;
+
+/** Storage of the single block RAM disk read by the SCSI benchmarks. */
+static uint8_t RAMDiskData[PERF_BLOCK_SIZE];
+
+/** Logical unit of the Mass Storage interface used by the SCSI benchmarks. */
+static const MS_Device_LUN_t Perf_LUNs[] =
+	{
+		{
+			.BlockDevice = &MS_Device_RAMDiskBlockDevice,
+			.Context     = RAMDiskData,
+			.BlockOffset = 0,
+			.TotalBlocks = 1,
+			.BlockSize   = PERF_BLOCK_SIZE,
+		},
+	};
+
+/** LUFA Mass Storage Class driver interface configuration and state information for the SCSI benchmarks. */
+static USB_ClassInfo_MS_Device_t Perf_MS_Interface =
+	{
+		.Config =
+			{
+				.InterfaceNumber           = 0,
+				.DataINEndpoint            =
+					{
+						.Address           = (ENDPOINT_DIR_IN  | 1),
+						.Size              = 64,
+						.Banks             = 1,
+					},
+				.DataOUTEndpoint           =
+					{
+						.Address           = (ENDPOINT_DIR_OUT | 2),
+						.Size              = 64,
+						.Banks             = 1,
+					},
+				.TotalLUNs                 = 1,
+				.LUNs                      = Perf_LUNs,
+			},
+	};
+
+/** Timer 1 overflow ISR, extending the 16-bit cycle count of the current measurement. */
+ISR(TIMER1_OVF_vect, ISR_BLOCK)
+{
+	TimerOverflows++;
+}
+
+/** Starts a new cycle count measurement. */
+static inline void Perf_StartCount(void)
+{
+	TimerOverflows = 0;
+	TCNT1          = 0;
+	TIFR1          = (1 << TOV1);
+	TCCR1B         = (1 << CS10);
+}
+
+/** Stops the current cycle count measurement.
+ *
+ *  \return Total number of CPU cycles since the measurement was started.
+ */
+static inline uint32_t Perf_StopCount(void)
+{
+	TCCR1B = 0;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	uint32_t Cycles = (((uint32_t)TimerOverflows << 16) | TCNT1);
+
+	/* Account for an overflow that occurred while interrupts were disabled, and has not yet been serviced */
+	if (TIFR1 & (1 << TOV1))
+	{
+		TIFR1   = (1 << TOV1);
+		Cycles += 0x10000UL;
+	}
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	return Cycles;
+}
+
+/** Writes a string stored in FLASH to the simulator console.
+ *
+ *  \param[in] String  Pointer to the string in FLASH.
+ */
+static void Perf_PrintString_P(const char* String)
+{
+	char CurrentChar;
+
+	while ((CurrentChar = pgm_read_byte(String++)))
+	  PERF_CONSOLE_REG = CurrentChar;
+}
+
+/** Writes a string stored in RAM to the simulator console.
+ *
+ *  \param[in] String  Pointer to the string in RAM.
+ */
+static void Perf_PrintString(const char* String)
+{
+	while (*String)
+	  PERF_CONSOLE_REG = *(String++);
+}
+
+/** Writes a decimal number to the simulator console, followed by the given separator.
+ *
+ *  \param[in] Value      Value to print.
+ *  \param[in] Separator  Character to print after the value.
+ */
+static void Perf_PrintNumber(const uint32_t Value,
+                             const char Separator)
+{
+	char Buffer[11];
+
+	ultoa(Value, Buffer, 10);
+
+	Perf_PrintString(Buffer);
+	PERF_CONSOLE_REG = Separator;
+}
+
+/** Halts the CPU with interrupts disabled, which ends the simulation. */
+static void Perf_Exit(void) ATTR_NO_RETURN;
+static void Perf_Exit(void)
+{
+	GlobalInterruptDisable();
+
+	set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+	sleep_enable();
+
+	for (;;)
+	  sleep_cpu();
+}
+
+/** Empty benchmark, used to measure the overhead of the measurement itself. */
+static bool Perf_Empty(void)
+{
+	return true;
+}
+
+#if defined(USB_CAN_BE_DEVICE)
+/** Sets the number of bytes reported as stored in the selected endpoint's bank.
+ *
+ *  \param[in] Bytes  Number of bytes to report.
+ */
+static void Perf_SetBytesInEndpoint(const uint16_t Bytes)
+{
+	#if (defined(USB_SERIES_6_AVR) || defined(USB_SERIES_7_AVR)) && !defined(__AVR_ATmega32U6__)
+		UEBCX  = Bytes;
+	#elif defined(USB_SERIES_4_AVR) || defined(__AVR_ATmega32U6__)
+		UEBCHX = (Bytes >> 8);
+		UEBCLX = (Bytes & 0xFF);
+	#elif defined(USB_SERIES_2_AVR)
+		UEBCLX = Bytes;
+	#endif
+}
+
+/** Selects a 64 byte endpoint in the given direction, with a bank that always has space or data available.
+ *
+ *  \param[in] Address  Address of the endpoint to prepare, including the direction in the MSB.
+ */
+static void Perf_PrepareEndpoint(const uint8_t Address)
+{
+	USB_DeviceState = DEVICE_STATE_Configured;
+
+	Endpoint_SelectEndpoint(Address);
+
+	UECONX  = (1 << EPEN);
+	UECFG1X = (3 << EPSIZE0);
+
+	if (Address & ENDPOINT_DIR_IN)
+	{
+		UECFG0X = (1 << EPDIR);
+		UEINTX  = ((1 << TXINI) | (1 << RWAL));
+		Perf_SetBytesInEndpoint(0);
+	}
+	else
+	{
+		UECFG0X = 0;
+		UEINTX  = ((1 << RXOUTI) | (1 << RWAL));
+		Perf_SetBytesInEndpoint(PERF_DATA_SIZE);
+	}
+}
+
+static void Perf_SetupEndpointIN(void)
+{
+	Perf_PrepareEndpoint(ENDPOINT_DIR_IN | 1);
+}
+
+static void Perf_SetupEndpointOUT(void)
+{
+	Perf_PrepareEndpoint(ENDPOINT_DIR_OUT | 2);
+}
+
+static bool Perf_EndpointWriteStream(void)
+{
+	return (Endpoint_Write_Stream_LE(PerfData, PERF_DATA_SIZE, NULL) == ENDPOINT_RWSTREAM_NoError);
+}
+
+static bool Perf_EndpointWriteStreamBE(void)
+{
+	return (Endpoint_Write_Stream_BE(PerfData, PERF_DATA_SIZE, NULL) == ENDPOINT_RWSTREAM_NoError);
+}
+
+static bool Perf_EndpointReadStream(void)
+{
+	return (Endpoint_Read_Stream_LE(PerfData, PERF_DATA_SIZE, NULL) == ENDPOINT_RWSTREAM_NoError);
+}
+
+static bool Perf_EndpointReadStreamBE(void)
+{
+	return (Endpoint_Read_Stream_BE(PerfData, PERF_DATA_SIZE, NULL) == ENDPOINT_RWSTREAM_NoError);
+}
+
+/** Prepares the Mass Storage interface's data IN endpoint, with a command block for the given SCSI command.
+ *
+ *  \param[in] Command             SCSI command to place in the command block.
+ *  \param[in] DataTransferLength  Length of the command's data stage, in bytes.
+ */
+static void Perf_PrepareSCSICommand(const uint8_t Command,
+                                    const uint32_t DataTransferLength)
+{
+	MS_CommandBlockWrapper_t* CommandBlock = &Perf_MS_Interface.State.CommandBlock;
+
+	memset(CommandBlock, 0x00, sizeof(MS_CommandBlockWrapper_t));
+
+	CommandBlock->Signature          = CPU_TO_LE32(MS_CBW_SIGNATURE);
+	CommandBlock->DataTransferLength = CPU_TO_LE32(DataTransferLength);
+	CommandBlock->Flags              = (DataTransferLength ? MS_COMMAND_DIR_DATA_IN : 0);
+	CommandBlock->LUN                = 0;
+	CommandBlock->SCSICommandLength  = 10;
+	CommandBlock->SCSICommandData[0] = Command;
+
+	Perf_PrepareEndpoint(Perf_MS_Interface.Config.DataINEndpoint.Address);
+}
+
+static void Perf_SetupSCSITestUnitReady(void)
+{
+	Perf_PrepareSCSICommand(SCSI_CMD_TEST_UNIT_READY, 0);
+}
+
+static void Perf_SetupSCSIRead10(void)
+{
+	Perf_PrepareSCSICommand(SCSI_CMD_READ_10, PERF_BLOCK_SIZE);
+
+	/* Read the single block at address zero */
+	Perf_MS_Interface.State.CommandBlock.SCSICommandData[8] = 1;
+}
+
+static bool Perf_SCSICommand(void)
+{
+	return MS_Device_ProcessSCSICommand(&Perf_MS_Interface);
+}
+#endif
+
+#if defined(USB_CAN_BE_HOST)
+/** Selects a 64 byte pipe with the given token, with a bank that always has space or data available.
+ *
+ *  \param[in] Token  Token of the pipe to prepare, a \c PIPE_TOKEN_* mask.
+ */
+static void Perf_PreparePipe(const uint8_t Token)
+{
+	USB_HostState = HOST_STATE_Configured;
+
+	Pipe_SelectPipe(1);
+
+	UPCONX  = (1 << PEN);
+	UPCFG0X = Token;
+	UPCFG1X = (3 << EPSIZE0);
+	UPINTX  = ((1 << RXINI) | (1 << TXOUTI) | (1 << RWAL));
+	UPBCX   = ((Token == PIPE_TOKEN_IN) ? PERF_DATA_SIZE : 0);
+}
+
+static void Perf_SetupPipeIN(void)
+{
+	Perf_PreparePipe(PIPE_TOKEN_IN);
+}
+
+static void Perf_SetupPipeOUT(void)
+{
+	Perf_PreparePipe(PIPE_TOKEN_OUT);
+}
+
+static bool Perf_PipeWriteStream(void)
+{
+	return (Pipe_Write_Stream_LE(PerfData, PERF_DATA_SIZE, NULL) == PIPE_RWSTREAM_NoError);
+}
+
+static bool Perf_PipeReadStream(void)
+{
+	return (Pipe_Read_Stream_LE(PerfData, PERF_DATA_SIZE, NULL) == PIPE_RWSTREAM_NoError);
+}
+#endif
+
+static void Perf_SetupRingBufferEmpty(void)
+{
+	RingBuffer_InitBuffer(&PerfRingBuffer, RingBufferData, sizeof(RingBufferData));
+}
+
+static void Perf_SetupRingBufferFull(void)
+{
+	RingBuffer_InitBuffer(&PerfRingBuffer, RingBufferData, sizeof(RingBufferData));
+
+	for (uint8_t i = 0; i < PERF_DATA_SIZE; i++)
+	  RingBuffer_Insert(&PerfRingBuffer, i);
+}
+
+static bool Perf_RingBufferInsert(void)
+{
+	for (uint8_t i = 0; i < PERF_DATA_SIZE; i++)
+	  RingBuffer_Insert(&PerfRingBuffer, PerfData[i]);
+
+	return RingBuffer_IsFull(&PerfRingBuffer);
+}
+
+static bool Perf_RingBufferRemove(void)
+{
+	for (uint8_t i = 0; i < PERF_DATA_SIZE; i++)
+	  PerfData[i] = RingBuffer_Remove(&PerfRingBuffer);
+
+	return RingBuffer_IsEmpty(&PerfRingBuffer);
+}
+
+static void Perf_SetupSPSCRingBufferEmpty(void)
+{
+	SPSCRingBuffer_InitBuffer(&PerfSPSCRingBuffer, RingBufferData, sizeof(RingBufferData));
+}
+
+static void Perf_SetupSPSCRingBufferFull(void)
+{
+	SPSCRingBuffer_InitBuffer(&PerfSPSCRingBuffer, RingBufferData, sizeof(RingBufferData));
+	SPSCRingBuffer_InsertBlock(&PerfSPSCRingBuffer, PerfData, PERF_DATA_SIZE);
+}
+
+static bool Perf_SPSCRingBufferInsert(void)
+{
+	for (uint8_t i = 0; i < PERF_DATA_SIZE; i++)
+	  SPSCRingBuffer_Insert(&PerfSPSCRingBuffer, PerfData[i]);
+
+	return SPSCRingBuffer_IsFull(&PerfSPSCRingBuffer);
+}
+
+static bool Perf_SPSCRingBufferRemove(void)
+{
+	for (uint8_t i = 0; i < PERF_DATA_SIZE; i++)
+	  PerfData[i] = SPSCRingBuffer_Remove(&PerfSPSCRingBuffer);
+
+	return SPSCRingBuffer_IsEmpty(&PerfSPSCRingBuffer);
+}
+
+static bool Perf_SPSCRingBufferInsertBlock(void)
+{
+	return (SPSCRingBuffer_InsertBlock(&PerfSPSCRingBuffer, PerfData, PERF_DATA_SIZE) == PERF_DATA_SIZE);
+}
+
+static bool Perf_SPSCRingBufferRemoveBlock(void)
+{
+	return (SPSCRingBuffer_RemoveBlock(&PerfSPSCRingBuffer, PerfData, PERF_DATA_SIZE) == PERF_DATA_SIZE);
+}
+
+/** Keeps every parsed report item, in the same manner as the HIDReportViewer project. */
+bool CALLBACK_HIDParser_FilterHIDReportItem(HID_ReportItem_t* const CurrentItem)
+{
+	(void)CurrentItem;
+
+	return true;
+}
+
+/** Stream parser callback, counting the report items presented by the parser. */
+static void Perf_CountReportItem(void* const Context,
+                                 const HID_ReportItem_t* const ReportItem)
+{
+	(void)ReportItem;
+
+	(*(uint8_t*)Context)++;
+}
+
+#if PERF_FULL_HID_PARSER
+static bool Perf_HIDParseKeyboard(void)
+{
+	return (USB_ProcessHIDReport(Keyboard_Report, sizeof(Keyboard_Report), &HIDReportInfo) == HID_PARSE_Successful);
+}
+
+static bool Perf_HIDParseMouse(void)
+{
+	return (USB_ProcessHIDReport(Mouse_Report, sizeof(Mouse_Report), &HIDReportInfo) == HID_PARSE_Successful);
+}
+#endif
+
+static bool Perf_HIDStreamParseKeyboard(void)
+{
+	HIDStreamItems = 0;
+
+	return (USB_ProcessHIDReportStream(Keyboard_Report, sizeof(Keyboard_Report), Perf_CountReportItem,
+	                                   &HIDStreamItems, NULL) == HID_PARSE_Successful) && HIDStreamItems;
+}
+
+static bool Perf_HIDStreamParseMouse(void)
+{
+	HIDStreamItems = 0;
+
+	return (USB_ProcessHIDReportStream(Mouse_Report, sizeof(Mouse_Report), Perf_CountReportItem,
+	                                   &HIDStreamItems, NULL) == HID_PARSE_Successful) && HIDStreamItems;
+}
+
+static bool Perf_EthernetChecksumIPHeader(void)
+{
+	/* Checksumming a header with its checksum field included gives zero when the checksum is correct */
+	return (Ethernet_Checksum16(PerfData, sizeof(IP_Header_t)) == 0);
+}
+
+static bool Perf_EthernetChecksum(void)
+{
+	EthernetChecksum = Ethernet_Checksum16(PerfData, PERF_DATA_SIZE);
+
+	return true;
+}
+
+static void Perf_SetupIPHeader(void)
+{
+	IP_Header_t* IPHeader = (IP_Header_t*)PerfData;
+
+	memset(PerfData, 0x00, sizeof(PerfData));
+
+	IPHeader->Version            = 4;
+	IPHeader->HeaderLength       = (sizeof(IP_Header_t) / sizeof(uint32_t));
+	IPHeader->TotalLength        = SwapEndian_16(PERF_DATA_SIZE);
+	IPHeader->TTL                = DEFAULT_TTL;
+	IPHeader->Protocol           = PROTOCOL_UDP;
+	IPHeader->SourceAddress      = ClientIPAddress;
+	IPHeader->DestinationAddress = ServerIPAddress;
+
+	IPHeader->HeaderChecksum = Ethernet_Checksum16(IPHeader, sizeof(IP_Header_t));
+}
+
+static void Perf_SetupDataPattern(void)
+{
+	for (uint8_t i = 0; i < PERF_DATA_SIZE; i++)
+	  PerfData[i] = (uint8_t)((i * 13) ^ 0x5A);
+}
+
+/** Table of the benchmarks to run, in the order that the results are reported. */
+static const Perf_Benchmark_t Perf_Benchmarks[] PROGMEM =
+	{
+		#if defined(USB_CAN_BE_DEVICE)
+		{.Name = "endpoint_write_stream_le",   .Setup = Perf_SetupEndpointIN,    .Run = Perf_EndpointWriteStream,   .Bytes = PERF_DATA_SIZE},
+		{.Name = "endpoint_write_stream_be",   .Setup = Perf_SetupEndpointIN,    .Run = Perf_EndpointWriteStreamBE, .Bytes = PERF_DATA_SIZE},
+		{.Name = "endpoint_read_stream_le",    .Setup = Perf_SetupEndpointOUT,   .Run = Perf_EndpointReadStream,    .Bytes = PERF_DATA_SIZE},
+		{.Name = "endpoint_read_stream_be",    .Setup = Perf_SetupEndpointOUT,   .Run = Perf_EndpointReadStreamBE,  .Bytes = PERF_DATA_SIZE},
+		#endif
+		#if defined(USB_CAN_BE_HOST)
+		{.Name = "pipe_write_stream_le",       .Setup = Perf_SetupPipeOUT,       .Run = Perf_PipeWriteStream,       .Bytes = PERF_DATA_SIZE},
+		{.Name = "pipe_read_stream_le",        .Setup = Perf_SetupPipeIN,        .Run = Perf_PipeReadStream,        .Bytes = PERF_DATA_SIZE},
+		#endif
+		{.Name = "ringbuffer_insert",          .Setup = Perf_SetupRingBufferEmpty,     .Run = Perf_RingBufferInsert,          .Bytes = PERF_DATA_SIZE},
+		{.Name = "ringbuffer_remove",          .Setup = Perf_SetupRingBufferFull,      .Run = Perf_RingBufferRemove,          .Bytes = PERF_DATA_SIZE},
+		{.Name = "spsc_ringbuffer_insert",     .Setup = Perf_SetupSPSCRingBufferEmpty, .Run = Perf_SPSCRingBufferInsert,      .Bytes = PERF_DATA_SIZE},
+		{.Name = "spsc_ringbuffer_remove",     .Setup = Perf_SetupSPSCRingBufferFull,  .Run = Perf_SPSCRingBufferRemove,      .Bytes = PERF_DATA_SIZE},
+		{.Name = "spsc_ringbuffer_insert_blk", .Setup = Perf_SetupSPSCRingBufferEmpty, .Run = Perf_SPSCRingBufferInsertBlock, .Bytes = PERF_DATA_SIZE},
+		{.Name = "spsc_ringbuffer_remove_blk", .Setup = Perf_SetupSPSCRingBufferFull,  .Run = Perf_SPSCRingBufferRemoveBlock, .Bytes = PERF_DATA_SIZE},
+		#if PERF_FULL_HID_PARSER
+		{.Name = "hid_parse_keyboard",         .Setup = NULL,                    .Run = Perf_HIDParseKeyboard,       .Bytes = sizeof(Keyboard_Report)},
+		{.Name = "hid_parse_mouse",            .Setup = NULL,                    .Run = Perf_HIDParseMouse,          .Bytes = sizeof(Mouse_Report)},
+		#endif
+		{.Name = "hid_stream_parse_keyboard",  .Setup = NULL,                    .Run = Perf_HIDStreamParseKeyboard, .Bytes = sizeof(Keyboard_Report)},
+		{.Name = "hid_stream_parse_mouse",     .Setup = NULL,                    .Run = Perf_HIDStreamParseMouse,    .Bytes = sizeof(Mouse_Report)},
+		{.Name = "ethernet_checksum16_iphdr",  .Setup = Perf_SetupIPHeader,      .Run = Perf_EthernetChecksumIPHeader, .Bytes = sizeof(IP_Header_t)},
+		{.Name = "ethernet_checksum16",        .Setup = Perf_SetupDataPattern,   .Run = Perf_EthernetChecksum,       .Bytes = PERF_DATA_SIZE},
+		#if defined(USB_CAN_BE_DEVICE)
+		{.Name = "scsi_test_unit_ready",       .Setup = Perf_SetupSCSITestUnitReady, .Run = Perf_SCSICommand,        .Bytes = 0},
+		{.Name = "scsi_read_10",               .Setup = Perf_SetupSCSIRead10,    .Run = Perf_SCSICommand,            .Bytes = PERF_BLOCK_SIZE},
+		#endif
+	};
+
+/** Times a single run of the given benchmark.
+ *
+ *  \param[in]  Benchmark  Benchmark to run, copied out of FLASH.
+ *  \param[out] Cycles     Number of CPU cycles taken by the benchmark, excluding the measurement overhead.
+ *
+ *  \return Boolean \c true if the benchmark completed successfully, \c false otherwise.
+ */
+static bool Perf_RunBenchmark(const Perf_Benchmark_t* const Benchmark,
+                              uint32_t* const Cycles)
+{
+	if (Benchmark->Setup != NULL)
+	  Benchmark->Setup();
+
+	Perf_StartCount();
+	bool Success = Benchmark->Run();
+	uint32_t MeasuredCycles = Perf_StopCount();
+
+	*Cycles = ((MeasuredCycles > Perf_Overhead) ? (MeasuredCycles - Perf_Overhead) : 0);
+
+	return Success;
+}
+
+/** Measures the overhead of timing a benchmark, taking the lowest of several runs of an empty benchmark. */
+static void Perf_Calibrate(void)
+{
+	const Perf_Benchmark_t EmptyBenchmark = {.Name = "", .Setup = NULL, .Run = Perf_Empty, .Bytes = 0};
+
+	Perf_Overhead = 0;
+
+	uint32_t LowestCycles = UINT32_MAX;
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		uint32_t Cycles;
+		Perf_RunBenchmark(&EmptyBenchmark, &Cycles);
+
+		LowestCycles = MIN(LowestCycles, Cycles);
+	}
+
+	Perf_Overhead = LowestCycles;
+}
+
+/** Main program entry point. This routine configures the cycle counter, runs each benchmark in turn and reports
+ *  the results, then ends the simulation.
+ */
+int main(void)
+{
+	bool AllSuccessful = true;
+
+	MCUSR &= ~(1 << WDRF);
+	wdt_disable();
+
+	TCCR1A = 0;
+	TCCR1B = 0;
+	TIMSK1 = (1 << TOIE1);
+
+	GlobalInterruptEnable();
+
+	Perf_Calibrate();
+
+	for (uint8_t BenchmarkIndex = 0; BenchmarkIndex < (sizeof(Perf_Benchmarks) / sizeof(Perf_Benchmarks[0])); BenchmarkIndex++)
+	{
+		Perf_Benchmark_t Benchmark;
+		uint32_t         Cycles;
+
+		memcpy_P(&Benchmark, &Perf_Benchmarks[BenchmarkIndex], sizeof(Perf_Benchmark_t));
+
+		bool Success = Perf_RunBenchmark(&Benchmark, &Cycles);
+
+		Perf_PrintString_P(Success ? PSTR("PERF_RESULT ") : PSTR("PERF_FAILED "));
+		Perf_PrintString(Benchmark.Name);
+		PERF_CONSOLE_REG = ' ';
+		Perf_PrintNumber(Cycles, ' ');
+		Perf_PrintNumber(Benchmark.Bytes, '\n');
+
+		AllSuccessful &= Success;
+	}
+
+	Perf_PrintString_P(AllSuccessful ? PSTR("PERF_COMPLETE\n") : PSTR("PERF_INCOMPLETE\n"));
+
+	Perf_Exit();
+}
+
+/** Descriptor callback required by the USB device stack; the benchmarks never enumerate, so no descriptors exist. */
+uint16_t CALLBACK_USB_GetDescriptor(const uint16_t wValue,
+                                    const uint8_t wIndex,
+                                    const void** const DescriptorAddress)
+{
+	(void)wValue;
+	(void)wIndex;
+
+	*DescriptorAddress = NULL;
+	return NO_DESCRIPTOR;
+}
+
+/** Mass Storage class driver callback function, required by the class driver's SCSI command processing. */
+bool CALLBACK_MS_Device_SCSICommandReceived(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
+{
+	return MS_Device_ProcessSCSICommand(MSInterfaceInfo);
+}
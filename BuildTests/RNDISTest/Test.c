@@ -0,0 +1,626 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Functional test of the RNDIS class driver's data path, run on the simulated HOSTSIM USB controller. The
+ *  virtual host initializes the RNDIS adapter through its encapsulated control messages, then sends Ethernet
+ *  frames to the device both one per bulk transfer and combined into multiple packet transfers, including
+ *  transfers ending on a packet boundary and packet messages with non-default data offsets. The device then
+ *  sends frames back to the host through the combining transmit path, and the virtual host checks that each
+ *  bulk transfer respects the negotiated limits and is correctly terminated.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Descriptors.h"
+
+#include <LUFA/Drivers/USB/USB.h>
+
+/** Maximum number of RNDIS packet messages the device may combine into a single bulk transfer. */
+#define TEST_MAX_PACKETS_PER_TRANSFER  4
+
+/** Maximum bulk transfer size the virtual host advertises to the device during initialization. */
+#define TEST_HOST_MAX_TRANSFER_SIZE    2048
+
+/** Size of the virtual host's buffers for the bulk data sent to and received from the device. */
+#define TEST_HOST_BUFFER_SIZE          16384
+
+/** Maximum number of bulk packets and transfers the virtual host can hold in each direction. */
+#define TEST_HOST_MAX_PACKETS          (TEST_HOST_BUFFER_SIZE / 8)
+
+/** Number of elements in the given array. */
+#define ARRAY_LENGTH(Array)            (sizeof(Array) / sizeof(Array[0]))
+
+/** Vendor description string reported by the test adapter, held in a writable array to match the driver's configuration field. */
+static char AdapterVendorDescription[] = "LUFA RNDIS Test Adapter";
+
+/** LUFA RNDIS Class driver interface configuration and state information. */
+static USB_ClassInfo_RNDIS_Device_t Test_RNDIS_Interface =
+	{
+		.Config =
+			{
+				.ControlInterfaceNumber         = 0,
+				.DataINEndpoint                 =
+					{
+						.Address                = CDC_TX_EPADDR,
+						.Size                   = CDC_TXRX_EPSIZE,
+						.Banks                  = 1,
+					},
+				.DataOUTEndpoint                =
+					{
+						.Address                = CDC_RX_EPADDR,
+						.Size                   = CDC_TXRX_EPSIZE,
+						.Banks                  = 1,
+					},
+				.NotificationEndpoint           =
+					{
+						.Address                = CDC_NOTIFICATION_EPADDR,
+						.Size                   = CDC_NOTIFICATION_EPSIZE,
+						.Banks                  = 1,
+					},
+				.AdapterVendorDescription       = AdapterVendorDescription,
+				.AdapterMACAddress              = {{0x02, 0x00, 0x02, 0x00, 0x02, 0x00}},
+				.MaxPacketsPerTransfer          = TEST_MAX_PACKETS_PER_TRANSFER,
+			},
+	};
+
+/** Bulk packets queued by the virtual host for the device's data OUT endpoint. */
+static struct
+{
+	uint8_t  Data[TEST_HOST_BUFFER_SIZE];
+	uint16_t PacketLengths[TEST_HOST_MAX_PACKETS];
+
+	uint16_t TotalPackets;
+	uint16_t NextPacket;
+	uint16_t QueuedBytes;
+	uint16_t SentBytes;
+} HostOUT;
+
+/** Bulk data received by the virtual host from the device's data IN endpoint. */
+static struct
+{
+	uint8_t  Data[TEST_HOST_BUFFER_SIZE];
+	uint16_t Length;
+
+	uint16_t TransferEnds[TEST_HOST_MAX_PACKETS];
+	uint16_t TotalTransfers;
+} HostIN;
+
+/** Buffer for the Ethernet frames read by the device. */
+static uint8_t FrameBuffer[ETHERNET_FRAME_SIZE_MAX];
+
+static uint8_t TestPattern(const uint8_t Frame,
+                           const uint16_t Offset)
+{
+	return (uint8_t)((Offset * 7) ^ (Offset >> 8) ^ (Frame * 29));
+}
+
+/** Host side of the test, run by the virtual host whenever the device waits on the bus. This sends the queued OUT
+ *  packets to the device as it accepts them, and collects the packets sent by the device on its IN endpoints.
+ */
+static void HostTask(void)
+{
+	while (HostOUT.NextPacket < HostOUT.TotalPackets)
+	{
+		uint16_t PacketLength = HostOUT.PacketLengths[HostOUT.NextPacket];
+
+		if (!(USB_VirtualHost_SendOUT(CDC_RX_EPADDR, &HostOUT.Data[HostOUT.SentBytes], PacketLength)))
+		  break;
+
+		HostOUT.SentBytes += PacketLength;
+		HostOUT.NextPacket++;
+	}
+
+	for (;;)
+	{
+		uint16_t PacketLength = CDC_TXRX_EPSIZE;
+
+		if ((HostIN.Length + CDC_TXRX_EPSIZE) > (uint16_t)sizeof(HostIN.Data))
+		  break;
+
+		if (!(USB_VirtualHost_ReceiveIN(CDC_TX_EPADDR, &HostIN.Data[HostIN.Length], &PacketLength)))
+		  break;
+
+		HostIN.Length += PacketLength;
+
+		/* A short packet ends the bulk transfer */
+		if (PacketLength < CDC_TXRX_EPSIZE)
+		  HostIN.TransferEnds[HostIN.TotalTransfers++] = HostIN.Length;
+	}
+
+	uint16_t NotificationLength = 0;
+	USB_VirtualHost_ReceiveIN(CDC_NOTIFICATION_EPADDR, NULL, &NotificationLength);
+}
+
+/** Appends a RNDIS packet message containing the given test frame to a bulk transfer being built by the host.
+ *
+ *  \param[out] Transfer       Pointer to the location in the transfer where the message is to be written.
+ *  \param[in]  Frame          Index of the test frame, used to generate its contents.
+ *  \param[in]  FrameLength    Length of the test frame.
+ *  \param[in]  ExtraOffset    Number of additional bytes to place between the message header and the frame.
+ *  \param[in]  TrailerLength  Number of additional bytes to place after the frame.
+ *
+ *  \return Length of the written packet message.
+ */
+static uint16_t Host_BuildPacketMessage(uint8_t* const Transfer,
+                                        const uint8_t Frame,
+                                        const uint16_t FrameLength,
+                                        const uint16_t ExtraOffset,
+                                        const uint16_t TrailerLength)
+{
+	RNDIS_Packet_Message_t* Message = (RNDIS_Packet_Message_t*)Transfer;
+	uint16_t MessageLength = (sizeof(RNDIS_Packet_Message_t) + ExtraOffset + FrameLength + TrailerLength);
+
+	memset(Transfer, 0xA5, MessageLength);
+	memset(Message, 0x00, sizeof(RNDIS_Packet_Message_t));
+
+	Message->MessageType   = CPU_TO_LE32(REMOTE_NDIS_PACKET_MSG);
+	Message->MessageLength = cpu_to_le32(MessageLength);
+	Message->DataOffset    = cpu_to_le32(sizeof(RNDIS_Packet_Message_t) - sizeof(RNDIS_Message_Header_t) + ExtraOffset);
+	Message->DataLength    = cpu_to_le32(FrameLength);
+
+	for (uint16_t Offset = 0; Offset < FrameLength; Offset++)
+	  Transfer[sizeof(RNDIS_Packet_Message_t) + ExtraOffset + Offset] = TestPattern(Frame, Offset);
+
+	return MessageLength;
+}
+
+/** Queues a bulk transfer built by the host for sending to the device, split into endpoint sized packets. A transfer
+ *  ending on a packet boundary is terminated with either a zero length packet, or the single byte of padding used by
+ *  some hosts in its place.
+ */
+static void Host_QueueTransfer(const uint8_t* const Transfer,
+                               const uint16_t Length,
+                               const bool PadWithByte)
+{
+	memcpy(&HostOUT.Data[HostOUT.QueuedBytes], Transfer, Length);
+	HostOUT.QueuedBytes += Length;
+
+	for (uint16_t Offset = 0; Offset < Length; Offset += CDC_TXRX_EPSIZE)
+	  HostOUT.PacketLengths[HostOUT.TotalPackets++] = MIN(CDC_TXRX_EPSIZE, Length - Offset);
+
+	if (!(Length % CDC_TXRX_EPSIZE))
+	{
+		if (PadWithByte)
+		  HostOUT.Data[HostOUT.QueuedBytes++] = 0x00;
+
+		HostOUT.PacketLengths[HostOUT.TotalPackets++] = (PadWithByte ? 1 : 0);
+	}
+}
+
+/** Runs the device's receive path until the given test frames have been read and all queued host data consumed. */
+static bool Device_ReceiveFrames(const uint8_t FirstFrame,
+                                 const uint8_t TotalFrames,
+                                 const uint16_t* const FrameLengths,
+                                 const bool SplitReads)
+{
+	uint8_t  Frame     = FirstFrame;
+	uint16_t IdlePolls = 0;
+
+	Endpoint_SelectEndpoint(CDC_RX_EPADDR);
+
+	while ((Frame < (FirstFrame + TotalFrames)) || (HostOUT.NextPacket < HostOUT.TotalPackets) ||
+	       Endpoint_IsOUTReceived())
+	{
+		if (++IdlePolls > 1000)
+		{
+			printf("Timed out waiting for frame %u.\n", Frame);
+			return false;
+		}
+
+		HostTask();
+		RNDIS_Device_USBTask(&Test_RNDIS_Interface);
+
+		uint16_t PacketLength;
+		uint8_t  ErrorCode;
+
+		if (SplitReads)
+		{
+			/* Read the frame header and payload separately, as a network stack would */
+			if ((ErrorCode = RNDIS_Device_BeginReadPacket(&Test_RNDIS_Interface, &PacketLength)) == ENDPOINT_RWSTREAM_NoError &&
+			    PacketLength)
+			{
+				uint16_t HeaderLength = MIN(PacketLength, 14);
+
+				if (((ErrorCode = Endpoint_Read_Stream_LE(FrameBuffer, HeaderLength, NULL)) == ENDPOINT_RWSTREAM_NoError) &&
+				    ((ErrorCode = Endpoint_Read_Stream_LE(&FrameBuffer[HeaderLength], PacketLength - HeaderLength, NULL)) == ENDPOINT_RWSTREAM_NoError))
+				{
+					ErrorCode = RNDIS_Device_EndReadPacket(&Test_RNDIS_Interface);
+				}
+			}
+		}
+		else
+		{
+			ErrorCode = RNDIS_Device_ReadPacket(&Test_RNDIS_Interface, FrameBuffer, &PacketLength);
+		}
+
+		if (ErrorCode != ENDPOINT_RWSTREAM_NoError)
+		{
+			printf("Reading frame %u failed with error %u.\n", Frame, ErrorCode);
+			return false;
+		}
+
+		Endpoint_SelectEndpoint(CDC_RX_EPADDR);
+
+		if (!(PacketLength))
+		  continue;
+
+		if (Frame >= (FirstFrame + TotalFrames))
+		{
+			printf("Unexpected frame received after frame %u.\n", Frame);
+			return false;
+		}
+
+		if (PacketLength != FrameLengths[Frame - FirstFrame])
+		{
+			printf("Frame %u has length %u, expected %u.\n", Frame, PacketLength, FrameLengths[Frame - FirstFrame]);
+			return false;
+		}
+
+		for (uint16_t Offset = 0; Offset < PacketLength; Offset++)
+		{
+			if (FrameBuffer[Offset] != TestPattern(Frame, Offset))
+			{
+				printf("Frame %u data mismatch at offset %u.\n", Frame, Offset);
+				return false;
+			}
+		}
+
+		Frame++;
+		IdlePolls = 0;
+	}
+
+	if (Test_RNDIS_Interface.State.RxTransferLength)
+	{
+		printf("Device did not detect the end of the last transfer.\n");
+		return false;
+	}
+
+	memset(&HostOUT, 0x00, sizeof(HostOUT));
+	return true;
+}
+
+/** Issues an encapsulated RNDIS control message to the device, and retrieves its response. */
+static bool RNDIS_Command(const void* const Message,
+                          const uint16_t MessageLength,
+                          void* const Response)
+{
+	USB_Request_Header_t SendCommand =
+		{
+			.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE),
+			.bRequest      = RNDIS_REQ_SendEncapsulatedCommand,
+			.wValue        = 0,
+			.wIndex        = 0,
+			.wLength       = MessageLength,
+		};
+
+	USB_Request_Header_t GetResponse =
+		{
+			.bmRequestType = (REQDIR_DEVICETOHOST | REQTYPE_CLASS | REQREC_INTERFACE),
+			.bRequest      = RNDIS_REQ_GetEncapsulatedResponse,
+			.wValue        = 0,
+			.wIndex        = 0,
+			.wLength       = RNDIS_MESSAGE_BUFFER_SIZE,
+		};
+
+	if (USB_VirtualHost_ControlRequest(&SendCommand, (void*)Message) != VHOST_CONTROL_NoError)
+	  return false;
+
+	RNDIS_Device_USBTask(&Test_RNDIS_Interface);
+	HostTask();
+
+	return (USB_VirtualHost_ControlRequest(&GetResponse, Response) == VHOST_CONTROL_NoError);
+}
+
+/** Initializes the RNDIS adapter and enables its data path, checking the negotiated transfer limits. */
+static bool Test_Initialization(void)
+{
+	uint8_t Response[RNDIS_MESSAGE_BUFFER_SIZE];
+
+	RNDIS_Initialize_Message_t InitMessage =
+		{
+			.MessageType     = CPU_TO_LE32(REMOTE_NDIS_INITIALIZE_MSG),
+			.MessageLength   = CPU_TO_LE32(sizeof(RNDIS_Initialize_Message_t)),
+			.RequestId       = CPU_TO_LE32(1),
+			.MajorVersion    = CPU_TO_LE32(REMOTE_NDIS_VERSION_MAJOR),
+			.MinorVersion    = CPU_TO_LE32(REMOTE_NDIS_VERSION_MINOR),
+			.MaxTransferSize = CPU_TO_LE32(TEST_HOST_MAX_TRANSFER_SIZE),
+		};
+
+	RNDIS_Initialize_Complete_t* InitResponse = (RNDIS_Initialize_Complete_t*)Response;
+
+	if (!(RNDIS_Command(&InitMessage, sizeof(InitMessage), Response)) ||
+	    (InitResponse->MessageType != CPU_TO_LE32(REMOTE_NDIS_INITIALIZE_CMPLT)) ||
+	    (InitResponse->Status      != CPU_TO_LE32(REMOTE_NDIS_STATUS_SUCCESS)))
+	{
+		printf("RNDIS initialization failed.\n");
+		return false;
+	}
+
+	if ((le32_to_cpu(InitResponse->MaxPacketsPerTransfer) != TEST_MAX_PACKETS_PER_TRANSFER) ||
+	    (le32_to_cpu(InitResponse->MaxTransferSize) !=
+	     (TEST_MAX_PACKETS_PER_TRANSFER * (sizeof(RNDIS_Packet_Message_t) + ETHERNET_FRAME_SIZE_MAX))))
+	{
+		printf("Device reported incorrect transfer limits.\n");
+		return false;
+	}
+
+	struct
+	{
+		RNDIS_Set_Message_t Message;
+		uint32_t            PacketFilter;
+	} ATTR_PACKED SetFilter =
+		{
+			.Message =
+				{
+					.MessageType             = CPU_TO_LE32(REMOTE_NDIS_SET_MSG),
+					.MessageLength           = CPU_TO_LE32(sizeof(SetFilter)),
+					.RequestId               = CPU_TO_LE32(2),
+					.Oid                     = CPU_TO_LE32(OID_GEN_CURRENT_PACKET_FILTER),
+					.InformationBufferLength = CPU_TO_LE32(sizeof(uint32_t)),
+					.InformationBufferOffset = CPU_TO_LE32(sizeof(RNDIS_Set_Message_t) - sizeof(RNDIS_Message_Header_t)),
+				},
+			.PacketFilter = CPU_TO_LE32(REMOTE_NDIS_PACKET_DIRECTED | REMOTE_NDIS_PACKET_BROADCAST),
+		};
+
+	RNDIS_Set_Complete_t* SetResponse = (RNDIS_Set_Complete_t*)Response;
+
+	if (!(RNDIS_Command(&SetFilter, sizeof(SetFilter), Response)) ||
+	    (SetResponse->MessageType != CPU_TO_LE32(REMOTE_NDIS_SET_CMPLT)) ||
+	    (SetResponse->Status      != CPU_TO_LE32(REMOTE_NDIS_STATUS_SUCCESS)))
+	{
+		printf("Setting the RNDIS packet filter failed.\n");
+		return false;
+	}
+
+	return true;
+}
+
+/** Sends frames to the device one per bulk transfer, including transfers ending on a packet boundary. */
+static bool Test_SinglePacketTransfers(void)
+{
+	static const uint16_t FrameLengths[] = {60, 84, 84, 1500, 1, 724};
+	static uint8_t Transfer[sizeof(RNDIS_Packet_Message_t) + ETHERNET_FRAME_SIZE_MAX];
+
+	for (uint8_t Frame = 0; Frame < ARRAY_LENGTH(FrameLengths); Frame++)
+	{
+		uint16_t Length = Host_BuildPacketMessage(Transfer, Frame, FrameLengths[Frame], 0, 0);
+		Host_QueueTransfer(Transfer, Length, (Frame == 2));
+	}
+
+	return Device_ReceiveFrames(0, ARRAY_LENGTH(FrameLengths), FrameLengths, false);
+}
+
+/** Sends frames to the device combined into multiple packet bulk transfers. */
+static bool Test_MultiplePacketTransfers(void)
+{
+	static const uint16_t FrameLengths[] = {60, 1500, 42, 84, 84, 84, 84, 600, 1, 1200, 333, 64};
+	static uint8_t Transfer[TEST_MAX_PACKETS_PER_TRANSFER * (sizeof(RNDIS_Packet_Message_t) + ETHERNET_FRAME_SIZE_MAX + 16)];
+
+	uint8_t Frame = 0;
+
+	for (uint8_t SplitReads = 0; SplitReads < 2; SplitReads++)
+	{
+		uint8_t FirstFrame = Frame;
+
+		while (Frame < ((SplitReads + 1) * (ARRAY_LENGTH(FrameLengths) / 2)))
+		{
+			uint16_t Length        = 0;
+			uint8_t  TotalMessages = ((Frame % 3) + 2);
+
+			for (uint8_t Message = 0; (Message < TotalMessages) && (Frame < ARRAY_LENGTH(FrameLengths)); Message++)
+			{
+				/* Some messages carry the frame at a larger data offset, or with trailing padding */
+				uint16_t ExtraOffset   = ((Frame % 4) == 1) ? 12 : 0;
+				uint16_t TrailerLength = ((Frame % 5) == 2) ? 3  : 0;
+
+				Length += Host_BuildPacketMessage(&Transfer[Length], Frame, FrameLengths[Frame], ExtraOffset, TrailerLength);
+				Frame++;
+			}
+
+			Host_QueueTransfer(Transfer, Length, false);
+		}
+
+		if (!(Device_ReceiveFrames(FirstFrame, (Frame - FirstFrame), &FrameLengths[FirstFrame], SplitReads)))
+		  return false;
+	}
+
+	return true;
+}
+
+/** Sends frames from the device through the combining transmit path, and checks the resulting bulk transfers. */
+static bool Test_CombinedSends(void)
+{
+	static const uint16_t FrameLengths[] = {84, 84, 84, 84, 60, 1500, 1500, 42, 1, 300, 84};
+
+	memset(&HostIN, 0x00, sizeof(HostIN));
+
+	for (uint8_t Frame = 0; Frame < ARRAY_LENGTH(FrameLengths); Frame++)
+	{
+		for (uint16_t Offset = 0; Offset < FrameLengths[Frame]; Offset++)
+		  FrameBuffer[Offset] = TestPattern(Frame, Offset);
+
+		uint8_t ErrorCode;
+
+		if (Frame & 1)
+		{
+			/* Gather the frame from two separate buffers, as a network stack would */
+			uint16_t HeaderLength = MIN(FrameLengths[Frame], 14);
+
+			if (((ErrorCode = RNDIS_Device_BeginSendPacket(&Test_RNDIS_Interface, FrameLengths[Frame])) == ENDPOINT_RWSTREAM_NoError) &&
+			    ((ErrorCode = Endpoint_Write_Stream_LE(FrameBuffer, HeaderLength, NULL)) == ENDPOINT_RWSTREAM_NoError) &&
+			    ((ErrorCode = Endpoint_Write_Stream_LE(&FrameBuffer[HeaderLength], FrameLengths[Frame] - HeaderLength, NULL)) == ENDPOINT_RWSTREAM_NoError))
+			{
+				ErrorCode = RNDIS_Device_EndSendPacket(&Test_RNDIS_Interface);
+			}
+		}
+		else
+		{
+			ErrorCode = RNDIS_Device_SendPacket(&Test_RNDIS_Interface, FrameBuffer, FrameLengths[Frame]);
+		}
+
+		if (ErrorCode != ENDPOINT_RWSTREAM_NoError)
+		{
+			printf("Sending frame %u failed with error %u.\n", Frame, ErrorCode);
+			return false;
+		}
+	}
+
+	RNDIS_Device_USBTask(&Test_RNDIS_Interface);
+	HostTask();
+
+	uint8_t  Frame         = 0;
+	uint16_t TransferStart = 0;
+	bool     SawFullEnd    = false;
+
+	for (uint16_t Transfer = 0; Transfer < HostIN.TotalTransfers; Transfer++)
+	{
+		uint16_t TransferEnd = HostIN.TransferEnds[Transfer];
+		uint16_t Position    = TransferStart;
+		uint8_t  Messages    = 0;
+
+		if ((TransferEnd - TransferStart) > TEST_HOST_MAX_TRANSFER_SIZE)
+		{
+			printf("Transfer %u exceeds the host's maximum transfer size.\n", Transfer);
+			return false;
+		}
+
+		if (!((TransferEnd - TransferStart) % CDC_TXRX_EPSIZE))
+		  SawFullEnd = true;
+
+		while (Position < TransferEnd)
+		{
+			RNDIS_Packet_Message_t* Message = (RNDIS_Packet_Message_t*)&HostIN.Data[Position];
+			uint8_t* FrameData = &HostIN.Data[Position + sizeof(RNDIS_Message_Header_t) + le32_to_cpu(Message->DataOffset)];
+
+			if ((Message->MessageType != CPU_TO_LE32(REMOTE_NDIS_PACKET_MSG)) || (Frame >= ARRAY_LENGTH(FrameLengths)) ||
+			    (le32_to_cpu(Message->DataLength) != FrameLengths[Frame]))
+			{
+				printf("Invalid packet message for frame %u.\n", Frame);
+				return false;
+			}
+
+			for (uint16_t Offset = 0; Offset < FrameLengths[Frame]; Offset++)
+			{
+				if (FrameData[Offset] != TestPattern(Frame, Offset))
+				{
+					printf("Frame %u data mismatch at offset %u.\n", Frame, Offset);
+					return false;
+				}
+			}
+
+			Position += le32_to_cpu(Message->MessageLength);
+			Messages++;
+			Frame++;
+		}
+
+		if ((Position != TransferEnd) || (Messages > TEST_MAX_PACKETS_PER_TRANSFER))
+		{
+			printf("Transfer %u contains an invalid set of packet messages.\n", Transfer);
+			return false;
+		}
+
+		TransferStart = TransferEnd;
+	}
+
+	if ((Frame != ARRAY_LENGTH(FrameLengths)) || (TransferStart != HostIN.Length))
+	{
+		printf("Only %u of %u frames were received by the host.\n", Frame, (unsigned)ARRAY_LENGTH(FrameLengths));
+		return false;
+	}
+
+	if (!(SawFullEnd) || (HostIN.TotalTransfers >= ARRAY_LENGTH(FrameLengths)))
+	{
+		printf("Frames were not combined into multiple packet transfers as expected.\n");
+		return false;
+	}
+
+	printf("Received %u frames in %u transfers.\n", Frame, HostIN.TotalTransfers);
+	return true;
+}
+
+/** Sends a malformed packet message to the device, which must be rejected. */
+static bool Test_MalformedPacket(void)
+{
+	static uint8_t Transfer[sizeof(RNDIS_Packet_Message_t) + 100];
+
+	uint16_t Length = Host_BuildPacketMessage(Transfer, 0, 100, 0, 0);
+	((RNDIS_Packet_Message_t*)Transfer)->DataLength = CPU_TO_LE32(200);
+
+	Host_QueueTransfer(Transfer, Length, false);
+	HostTask();
+
+	uint16_t PacketLength;
+
+	if (RNDIS_Device_ReadPacket(&Test_RNDIS_Interface, FrameBuffer, &PacketLength) != RNDIS_ERROR_LOGICAL_CMD_FAILED)
+	{
+		printf("Malformed packet message was not rejected.\n");
+		return false;
+	}
+
+	return true;
+}
+
+int main(void)
+{
+	USB_Init(USB_DEVICE_OPT_FULLSPEED);
+	GlobalInterruptEnable();
+
+	if (USB_VirtualHost_Enumerate(1) != VHOST_CONTROL_NoError)
+	{
+		printf("Enumeration failed.\n");
+		return EXIT_FAILURE;
+	}
+
+	USB_VirtualHost_SetIdleHandler(HostTask);
+
+	if (!(Test_Initialization()) || !(Test_SinglePacketTransfers()) || !(Test_MultiplePacketTransfers()) ||
+	    !(Test_CombinedSends()) || !(Test_MalformedPacket()))
+	{
+		return EXIT_FAILURE;
+	}
+
+	printf("All RNDIS data path tests passed.\n");
+	return EXIT_SUCCESS;
+}
+
+void EVENT_USB_Device_ConfigurationChanged(void)
+{
+	RNDIS_Device_ConfigureEndpoints(&Test_RNDIS_Interface);
+}
+
+void EVENT_USB_Device_ControlRequest(void)
+{
+	RNDIS_Device_ProcessControlRequest(&Test_RNDIS_Interface);
+}
+
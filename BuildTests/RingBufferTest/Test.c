@@ -0,0 +1,414 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Host side stress test of the lock-free SPSC ring buffer driver. The lock-free buffer is first run in
+ *  lock step with the original ring buffer driver through a long pseudo-random sequence of byte, block and
+ *  in-place span operations, checking that both return the same data and counts. A producer and consumer
+ *  thread then hammer a lock-free buffer concurrently to check that no data is lost or reordered without
+ *  locking, and finally the throughput of both drivers is compared.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <LUFA/Drivers/Misc/RingBuffer.h>
+#include <LUFA/Drivers/Misc/SPSCRingBuffer.h>
+
+/** Size of the ring buffers under test, in bytes. */
+#define TEST_BUFFER_SIZE        128
+
+/** Number of random operations performed on each side of the buffers in the lock step comparison test. */
+#define TEST_LOCKSTEP_OPS       2000000UL
+
+/** Number of bytes passed between the producer and consumer threads in the concurrent test. */
+#define TEST_THREADED_BYTES     (16UL * 1024 * 1024)
+
+/** Number of bytes passed through each buffer in the throughput comparison. */
+#define TEST_THROUGHPUT_BYTES   (64UL * 1024 * 1024)
+
+/** Largest block size used when transferring data in blocks. */
+#define TEST_MAX_BLOCK          64
+
+static RingBuffer_t     Locked_Buffer;
+static uint8_t          Locked_BufferData[TEST_BUFFER_SIZE];
+
+static SPSCRingBuffer_t LockFree_Buffer;
+static uint8_t          LockFree_BufferData[TEST_BUFFER_SIZE];
+
+static uint32_t RandomState = 0x12345678;
+
+/** Simple xorshift pseudo-random generator, so that test runs are repeatable across hosts. */
+static uint32_t Random(void)
+{
+	RandomState ^= (RandomState << 13);
+	RandomState ^= (RandomState >> 17);
+	RandomState ^= (RandomState << 5);
+
+	return RandomState;
+}
+
+/** Data pattern byte for the given stream offset, independent of the buffer sizes and block lengths used. */
+static uint8_t TestPattern(const uint32_t Offset)
+{
+	return (uint8_t)((Offset * 7) ^ (Offset >> 8));
+}
+
+/** Runs the lock-free ring buffer in lock step with the original locked ring buffer, inserting and removing random
+ *  amounts of data through each of the lock-free buffer's interfaces, and checking the results of both against each
+ *  other and the expected data pattern.
+ *
+ *  \return Boolean \c true if the buffers behaved identically, \c false otherwise.
+ */
+static bool RunLockstepTest(void)
+{
+	uint32_t InOffset  = 0;
+	uint32_t OutOffset = 0;
+
+	RingBuffer_InitBuffer(&Locked_Buffer, Locked_BufferData, sizeof(Locked_BufferData));
+	SPSCRingBuffer_InitBuffer(&LockFree_Buffer, LockFree_BufferData, sizeof(LockFree_BufferData));
+
+	for (uint32_t Op = 0; Op < TEST_LOCKSTEP_OPS; Op++)
+	{
+		uint8_t  Block[TEST_MAX_BLOCK];
+		uint16_t Length = (Random() % TEST_MAX_BLOCK) + 1;
+		uint8_t  Method = (Random() % 3);
+
+		if (RingBuffer_GetCount(&Locked_Buffer) != SPSCRingBuffer_GetCount(&LockFree_Buffer))
+		{
+			printf("Count mismatch at operation %lu.\n", (unsigned long)Op);
+			return false;
+		}
+
+		if (Random() & 1)
+		{
+			Length = MIN(Length, RingBuffer_GetFreeCount(&Locked_Buffer));
+
+			for (uint16_t i = 0; i < Length; i++)
+			{
+				Block[i] = TestPattern(InOffset + i);
+				RingBuffer_Insert(&Locked_Buffer, Block[i]);
+			}
+
+			if (Method == 0)
+			{
+				for (uint16_t i = 0; i < Length; i++)
+				  SPSCRingBuffer_Insert(&LockFree_Buffer, Block[i]);
+			}
+			else if (Method == 1)
+			{
+				if (SPSCRingBuffer_InsertBlock(&LockFree_Buffer, Block, Length) != Length)
+				{
+					printf("Short block insert at operation %lu.\n", (unsigned long)Op);
+					return false;
+				}
+			}
+			else
+			{
+				uint16_t Written = 0;
+
+				while (Written < Length)
+				{
+					uint16_t SpanLength;
+					uint8_t* Span = SPSCRingBuffer_GetWriteSpan(&LockFree_Buffer, &SpanLength);
+
+					SpanLength = MIN(SpanLength, (Length - Written));
+					memcpy(Span, &Block[Written], SpanLength);
+					SPSCRingBuffer_CommitWrite(&LockFree_Buffer, SpanLength);
+
+					Written += SpanLength;
+				}
+			}
+
+			InOffset += Length;
+		}
+		else
+		{
+			Length = MIN(Length, RingBuffer_GetCount(&Locked_Buffer));
+
+			if (Method == 0)
+			{
+				for (uint16_t i = 0; i < Length; i++)
+				{
+					if (SPSCRingBuffer_Peek(&LockFree_Buffer) != TestPattern(OutOffset + i))
+					{
+						printf("Peek mismatch at operation %lu.\n", (unsigned long)Op);
+						return false;
+					}
+
+					Block[i] = SPSCRingBuffer_Remove(&LockFree_Buffer);
+				}
+			}
+			else if (Method == 1)
+			{
+				if (SPSCRingBuffer_RemoveBlock(&LockFree_Buffer, Block, Length) != Length)
+				{
+					printf("Short block remove at operation %lu.\n", (unsigned long)Op);
+					return false;
+				}
+			}
+			else
+			{
+				uint16_t Read = 0;
+
+				while (Read < Length)
+				{
+					uint16_t SpanLength;
+					uint8_t* Span = SPSCRingBuffer_GetReadSpan(&LockFree_Buffer, &SpanLength);
+
+					SpanLength = MIN(SpanLength, (Length - Read));
+					memcpy(&Block[Read], Span, SpanLength);
+					SPSCRingBuffer_CommitRead(&LockFree_Buffer, SpanLength);
+
+					Read += SpanLength;
+				}
+			}
+
+			if (Length && (RingBuffer_Peek(&Locked_Buffer) != TestPattern(OutOffset)))
+			{
+				printf("Peek mismatch at operation %lu.\n", (unsigned long)Op);
+				return false;
+			}
+
+			for (uint16_t i = 0; i < Length; i++)
+			{
+				uint8_t Expected = TestPattern(OutOffset + i);
+
+				if ((RingBuffer_Remove(&Locked_Buffer) != Expected) || (Block[i] != Expected))
+				{
+					printf("Data mismatch at stream offset %lu.\n", (unsigned long)(OutOffset + i));
+					return false;
+				}
+			}
+
+			OutOffset += Length;
+		}
+
+		if (SPSCRingBuffer_IsFull(&LockFree_Buffer) != RingBuffer_IsFull(&Locked_Buffer) ||
+		    SPSCRingBuffer_IsEmpty(&LockFree_Buffer) != RingBuffer_IsEmpty(&Locked_Buffer))
+		{
+			printf("Buffer state mismatch at operation %lu.\n", (unsigned long)Op);
+			return false;
+		}
+	}
+
+	printf("Lock step test passed %lu bytes through both buffers.\n", (unsigned long)OutOffset);
+	return true;
+}
+
+/** Producer thread for the concurrent test, inserting the data pattern into the lock-free buffer in random sized blocks. */
+static void* ProducerThread(void* Param)
+{
+	uint32_t Offset     = 0;
+	uint32_t LocalState = 0x9E3779B9;
+
+	(void)Param;
+
+	while (Offset < TEST_THREADED_BYTES)
+	{
+		uint8_t  Block[TEST_MAX_BLOCK];
+		uint16_t Length;
+
+		LocalState ^= (LocalState << 13);
+		LocalState ^= (LocalState >> 17);
+		LocalState ^= (LocalState << 5);
+
+		Length = MIN((LocalState % TEST_MAX_BLOCK) + 1, TEST_THREADED_BYTES - Offset);
+
+		for (uint16_t i = 0; i < Length; i++)
+		  Block[i] = TestPattern(Offset + i);
+
+		/* Single byte inserts exercise the per-byte index publishing, blocks the span based copies */
+		if (LocalState & 0x80000000)
+		{
+			for (uint16_t i = 0; i < Length; i++)
+			{
+				while (SPSCRingBuffer_IsFull(&LockFree_Buffer))
+				  sched_yield();
+
+				SPSCRingBuffer_Insert(&LockFree_Buffer, Block[i]);
+			}
+		}
+		else
+		{
+			uint16_t Inserted = 0;
+
+			while ((Inserted += SPSCRingBuffer_InsertBlock(&LockFree_Buffer, &Block[Inserted], (Length - Inserted))) < Length)
+			  sched_yield();
+		}
+
+		Offset += Length;
+	}
+
+	return NULL;
+}
+
+/** Runs a producer thread against a consumer on the calling thread through the lock-free buffer, with neither side
+ *  taking any locks, and checks that all data arrives intact and in order.
+ *
+ *  \return Boolean \c true if all data was received correctly, \c false otherwise.
+ */
+static bool RunThreadedTest(void)
+{
+	pthread_t Producer;
+	uint32_t  Offset = 0;
+	bool      Passed = true;
+
+	SPSCRingBuffer_InitBuffer(&LockFree_Buffer, LockFree_BufferData, sizeof(LockFree_BufferData));
+
+	if (pthread_create(&Producer, NULL, ProducerThread, NULL))
+	{
+		printf("Could not create producer thread.\n");
+		return false;
+	}
+
+	while (Offset < TEST_THREADED_BYTES)
+	{
+		uint16_t SpanLength;
+		uint8_t* Span = SPSCRingBuffer_GetReadSpan(&LockFree_Buffer, &SpanLength);
+
+		/* Give up the processor while the buffer is empty, as the test host may have only a single core */
+		if (!(Span))
+		{
+			sched_yield();
+			continue;
+		}
+
+		for (uint16_t i = 0; (i < SpanLength) && Passed; i++)
+		{
+			if (Span[i] != TestPattern(Offset + i))
+			{
+				printf("Concurrent data mismatch at stream offset %lu.\n", (unsigned long)(Offset + i));
+				Passed = false;
+			}
+		}
+
+		if (!(Passed))
+		  break;
+
+		SPSCRingBuffer_CommitRead(&LockFree_Buffer, SpanLength);
+		Offset += SpanLength;
+	}
+
+	if (!(Passed))
+	  pthread_cancel(Producer);
+
+	pthread_join(Producer, NULL);
+
+	if (Passed)
+	  printf("Concurrent test passed %lu bytes between threads.\n", (unsigned long)Offset);
+
+	return Passed;
+}
+
+/** Prints the throughput achieved by a throughput test pass that began at the given time. */
+static void ReportThroughput(const char* Name,
+                             const clock_t StartTime,
+                             const uint8_t Checksum)
+{
+	double ElapsedTime = ((double)(clock() - StartTime) / CLOCKS_PER_SEC);
+
+	printf("%s transferred %lu bytes in %.3f seconds (%.1f KB/s, checksum %02X).\n", Name,
+	       (unsigned long)TEST_THROUGHPUT_BYTES, ElapsedTime,
+	       (TEST_THROUGHPUT_BYTES / 1024.0) / ElapsedTime, Checksum);
+}
+
+/** Compares the throughput of the original and lock-free ring buffers, passing data through each a byte at a time
+ *  and the lock-free buffer additionally in blocks.
+ */
+static void RunThroughputTest(void)
+{
+	uint8_t Block[TEST_MAX_BLOCK];
+	uint8_t Checksum;
+	clock_t StartTime;
+
+	RingBuffer_InitBuffer(&Locked_Buffer, Locked_BufferData, sizeof(Locked_BufferData));
+	Checksum  = 0;
+	StartTime = clock();
+
+	for (uint32_t Offset = 0; Offset < TEST_THROUGHPUT_BYTES; Offset += TEST_MAX_BLOCK)
+	{
+		for (uint8_t i = 0; i < TEST_MAX_BLOCK; i++)
+		  RingBuffer_Insert(&Locked_Buffer, i);
+
+		while (!(RingBuffer_IsEmpty(&Locked_Buffer)))
+		  Checksum += RingBuffer_Remove(&Locked_Buffer);
+	}
+
+	ReportThroughput("Locked byte", StartTime, Checksum);
+
+	SPSCRingBuffer_InitBuffer(&LockFree_Buffer, LockFree_BufferData, sizeof(LockFree_BufferData));
+	Checksum  = 0;
+	StartTime = clock();
+
+	for (uint32_t Offset = 0; Offset < TEST_THROUGHPUT_BYTES; Offset += TEST_MAX_BLOCK)
+	{
+		for (uint8_t i = 0; i < TEST_MAX_BLOCK; i++)
+		  SPSCRingBuffer_Insert(&LockFree_Buffer, i);
+
+		while (!(SPSCRingBuffer_IsEmpty(&LockFree_Buffer)))
+		  Checksum += SPSCRingBuffer_Remove(&LockFree_Buffer);
+	}
+
+	ReportThroughput("Lock-free byte", StartTime, Checksum);
+
+	for (uint8_t i = 0; i < TEST_MAX_BLOCK; i++)
+	  Block[i] = i;
+
+	Checksum  = 0;
+	StartTime = clock();
+
+	for (uint32_t Offset = 0; Offset < TEST_THROUGHPUT_BYTES; Offset += TEST_MAX_BLOCK)
+	{
+		uint8_t OutBlock[TEST_MAX_BLOCK];
+
+		SPSCRingBuffer_InsertBlock(&LockFree_Buffer, Block, TEST_MAX_BLOCK);
+		SPSCRingBuffer_RemoveBlock(&LockFree_Buffer, OutBlock, TEST_MAX_BLOCK);
+
+		Checksum += OutBlock[Offset % TEST_MAX_BLOCK];
+	}
+
+	ReportThroughput("Lock-free block", StartTime, Checksum);
+}
+
+int main(void)
+{
+	if (!(RunLockstepTest()) || !(RunThreadedTest()))
+	  return EXIT_FAILURE;
+
+	RunThroughputTest();
+
+	return EXIT_SUCCESS;
+}
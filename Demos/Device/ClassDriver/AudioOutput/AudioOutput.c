@@ -52,12 +52,30 @@ USB_ClassInfo_Audio_Device_t Speaker_Audio_Interface =
 						.Size             = AUDIO_STREAM_EPSIZE,
 						.Banks            = 2,
 					},
+				.FeedbackEndpoint         =
+					{
+						.Address          = AUDIO_FEEDBACK_EPADDR,
+						.Size             = AUDIO_FEEDBACK_EPSIZE,
+						.Banks            = 1,
+					},
+				.FeedbackRefresh          = AUDIO_FEEDBACK_REFRESH,
 			},
 	};
 
 /** Current audio sampling frequency of the streaming audio endpoint. */
 static uint32_t CurrentAudioSampleFrequency = 48000;
 
+/** Intermediate buffer of signed 8-bit left and right sample pairs, filled from each received audio packet in the main
+ *  program loop and drained one sample pair at a time by the sample reload timer ISR.
+ */
+static int8_t SampleFrames[AUDIO_SAMPLE_FRAMES][2];
+
+/** Free running index of the next sample pair to store into \ref SampleFrames, updated only by the main program loop. */
+static volatile uint8_t SampleFramesIn;
+
+/** Free running index of the next sample pair to play from \ref SampleFrames, updated only by the sample reload timer ISR. */
+static volatile uint8_t SampleFramesOut;
+
 
 /** Main program entry point. This routine contains the overall program flow, including initial
  *  setup of all components and the main program loop.
@@ -71,6 +89,8 @@ int main(void)
 
 	for (;;)
 	{
+		ReceiveAudioPacket();
+
 		Audio_Device_USBTask(&Speaker_Audio_Interface);
 		USB_USBTask();
 	}
@@ -91,17 +111,53 @@ void SetupHardware(void)
 	USB_Init();
 }
 
+/** Reads the next received audio packet from the host in a single pass, converting each signed 16-bit stereo
+ *  sample pair to 8-bit and storing it into \ref SampleFrames for playback by the sample reload timer ISR. A
+ *  packet is only read once the buffer has room for a full endpoint's worth of samples, as any samples that do
+ *  not fit are discarded along with the rest of the packet.
+ */
+void ReceiveAudioPacket(void)
+{
+	static int16_t PacketSamples[AUDIO_STREAM_EPSIZE / sizeof(int16_t)];
+
+	uint8_t FramesIn = SampleFramesIn;
+
+	/* Leave the packet in the endpoint bank until there is room to buffer all of its samples */
+	if ((uint8_t)(FramesIn - SampleFramesOut) > (AUDIO_SAMPLE_FRAMES - (AUDIO_STREAM_EPSIZE / (2 * sizeof(int16_t)))))
+	  return;
+
+	uint16_t TotalSamples = Audio_Device_ReadPacket16(&Speaker_Audio_Interface, PacketSamples,
+	                                                  (AUDIO_STREAM_EPSIZE / sizeof(int16_t)));
+
+	/* Convert each signed 16-bit left and right sample pair to 8-bit */
+	for (uint16_t i = 0; (i + 1) < TotalSamples; i += 2)
+	{
+		SampleFrames[FramesIn % AUDIO_SAMPLE_FRAMES][0] = (PacketSamples[i]     >> 8);
+		SampleFrames[FramesIn % AUDIO_SAMPLE_FRAMES][1] = (PacketSamples[i + 1] >> 8);
+		FramesIn++;
+	}
+
+	/* Ensure the new sample pairs are stored before they are made visible to the ISR */
+	GCC_MEMORY_BARRIER();
+	SampleFramesIn = FramesIn;
+}
+
 /** ISR to handle the reloading of the PWM timer with the next sample. */
 ISR(TIMER0_COMPA_vect, ISR_BLOCK)
 {
-	uint8_t PrevEndpoint = Endpoint_GetCurrentEndpoint();
+	uint8_t FramesOut = SampleFramesOut;
+
+	/* Count each sample period so that the host can be told the true rate of the sample reload timer */
+	Audio_Device_CountSamples(&Speaker_Audio_Interface, 1);
 
-	/* Check that the USB bus is ready for the next sample to read */
-	if (Audio_Device_IsSampleReceived(&Speaker_Audio_Interface))
+	/* Check that a buffered sample pair is ready to be played */
+	if (FramesOut != SampleFramesIn)
 	{
-		/* Retrieve the signed 16-bit left and right audio samples, convert to 8-bit */
-		int8_t LeftSample_8Bit  = (Audio_Device_ReadSample16(&Speaker_Audio_Interface) >> 8);
-		int8_t RightSample_8Bit = (Audio_Device_ReadSample16(&Speaker_Audio_Interface) >> 8);
+		/* Retrieve the next signed 8-bit left and right audio samples */
+		int8_t LeftSample_8Bit  = SampleFrames[FramesOut % AUDIO_SAMPLE_FRAMES][0];
+		int8_t RightSample_8Bit = SampleFrames[FramesOut % AUDIO_SAMPLE_FRAMES][1];
+
+		SampleFramesOut = (FramesOut + 1);
 
 		/* Mix the two channels together to produce a mono, 8-bit sample */
 		int8_t MixedSample_8Bit = (((int16_t)LeftSample_8Bit + (int16_t)RightSample_8Bit) >> 1);
@@ -132,8 +188,6 @@ ISR(TIMER0_COMPA_vect, ISR_BLOCK)
 
 		LEDs_SetAllLEDs(LEDMask);
 	}
-
-	Endpoint_SelectEndpoint(PrevEndpoint);
 }
 
 /** Event handler for the library USB Connection event. */
@@ -198,6 +252,10 @@ void EVENT_USB_Device_ConfigurationChanged(void)
 
 	ConfigSuccess &= Audio_Device_ConfigureEndpoints(&Speaker_Audio_Interface);
 
+	/* Report the nominal sampling frequency until the first rate measurement completes */
+	Audio_Device_SetNominalSampleRate(&Speaker_Audio_Interface, CurrentAudioSampleFrequency);
+	USB_Device_EnableSOFEvents();
+
 	LEDs_SetAllLEDs(ConfigSuccess ? LEDMASK_USB_READY : LEDMASK_USB_ERROR);
 }
 
@@ -207,6 +265,12 @@ void EVENT_USB_Device_ControlRequest(void)
 	Audio_Device_ProcessControlRequest(&Speaker_Audio_Interface);
 }
 
+/** Event handler for the library USB Start Of Frame event, used to time the stream rate measurement. */
+void EVENT_USB_Device_StartOfFrame(void)
+{
+	Audio_Device_ProcessStartOfFrame(&Speaker_Audio_Interface);
+}
+
 /** Audio class driver callback for the setting and retrieval of streaming endpoint properties. This callback must be implemented
  *  in the user application to handle property manipulations on streaming audio endpoints.
  *
@@ -253,6 +317,9 @@ bool CALLBACK_Audio_Device_GetSetEndpointProperty(USB_ClassInfo_Audio_Device_t*
 
 						/* Adjust sample reload timer to the new frequency */
 						OCR0A = ((F_CPU / 8 / CurrentAudioSampleFrequency) - 1);
+
+						/* Restart the stream rate measurement from the new nominal frequency */
+						Audio_Device_SetNominalSampleRate(&Speaker_Audio_Interface, CurrentAudioSampleFrequency);
 					}
 
 					return true;
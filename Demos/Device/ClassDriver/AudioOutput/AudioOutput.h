@@ -62,13 +62,20 @@
 		/** LED mask for the library LED driver, to indicate that an error has occurred in the USB interface. */
 		#define LEDMASK_USB_ERROR        (LEDS_LED1 | LEDS_LED3)
 
+		/** Number of stereo sample pairs buffered between the main program loop and the sample reload timer ISR,
+		 *  which must be a power of two no larger than 128.
+		 */
+		#define AUDIO_SAMPLE_FRAMES       128
+
 	/* Function Prototypes: */
 		void SetupHardware(void);
+		void ReceiveAudioPacket(void);
 
 		void EVENT_USB_Device_Connect(void);
 		void EVENT_USB_Device_Disconnect(void);
 		void EVENT_USB_Device_ConfigurationChanged(void);
 		void EVENT_USB_Device_ControlRequest(void);
+		void EVENT_USB_Device_StartOfFrame(void);
 
 		bool CALLBACK_Audio_Device_GetSetEndpointProperty(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
 		                                                  const uint8_t EndpointProperty,
@@ -169,7 +169,7 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor =
 			.InterfaceNumber          = 1,
 			.AlternateSetting         = 1,
 
-			.TotalEndpoints           = 1,
+			.TotalEndpoints           = 2,
 
 			.Class                    = AUDIO_CSCP_AudioClass,
 			.SubClass                 = AUDIO_CSCP_AudioStreamingSubclass,
@@ -221,13 +221,13 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor =
 					.Header              = {.Size = sizeof(USB_Audio_Descriptor_StreamEndpoint_Std_t), .Type = DTYPE_Endpoint},
 
 					.EndpointAddress     = AUDIO_STREAM_EPADDR,
-					.Attributes          = (EP_TYPE_ISOCHRONOUS | ENDPOINT_ATTR_SYNC | ENDPOINT_USAGE_DATA),
+					.Attributes          = (EP_TYPE_ISOCHRONOUS | ENDPOINT_ATTR_ASYNC | ENDPOINT_USAGE_DATA),
 					.EndpointSize        = AUDIO_STREAM_EPSIZE,
 					.PollingIntervalMS   = 0x01
 				},
 
 			.Refresh                  = 0,
-			.SyncEndpointNumber       = 0
+			.SyncEndpointNumber       = AUDIO_FEEDBACK_EPADDR
 		},
 
 	.Audio_StreamEndpoint_SPC =
@@ -239,6 +239,22 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor =
 
 			.LockDelayUnits           = 0x00,
 			.LockDelay                = 0x0000
+		},
+
+	.Audio_FeedbackEndpoint =
+		{
+			.Endpoint =
+				{
+					.Header              = {.Size = sizeof(USB_Audio_Descriptor_StreamEndpoint_Std_t), .Type = DTYPE_Endpoint},
+
+					.EndpointAddress     = AUDIO_FEEDBACK_EPADDR,
+					.Attributes          = (EP_TYPE_ISOCHRONOUS | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_FEEDBACK),
+					.EndpointSize        = AUDIO_FEEDBACK_EPSIZE,
+					.PollingIntervalMS   = 0x01
+				},
+
+			.Refresh                  = AUDIO_FEEDBACK_REFRESH,
+			.SyncEndpointNumber       = 0
 		}
 };
 
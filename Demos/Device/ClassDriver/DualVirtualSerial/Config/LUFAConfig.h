@@ -64,6 +64,10 @@
 //		#define USB_STREAM_TIMEOUT_MS            {Insert Value Here}
 //		#define NO_LIMITED_CONTROLLER_CONNECT
 //		#define NO_SOF_EVENTS
+//		#define USB_ENABLE_TRACE
+//		#define USB_TRACE_BUFFER_SIZE            {Insert Value Here}
+//		#define USB_TRACE_TOTAL_COUNTERS         {Insert Value Here}
+//		#define USB_TRACE_SUBFRAME_TIMER         {Insert Value Here}
 
 		/* USB Device Mode Driver Related Tokens: */
 //		#define USE_RAM_DESCRIPTORS
@@ -117,10 +117,18 @@ int main(void)
 		/* Discard all received data on the first CDC interface */
 		CDC_Device_ReceiveByte(&VirtualSerial1_CDC_Interface);
 
+		#if defined(USB_ENABLE_TRACE)
+		/* Send the USB event trace on the second CDC interface, with any received data requesting the endpoint statistics */
+		if (!(CDC_Device_ReceiveByte(&VirtualSerial2_CDC_Interface) < 0))
+		  USB_Trace_QueueCounters();
+
+		SendTraceData();
+		#else
 		/* Echo all received data on the second CDC interface */
 		int16_t ReceivedByte = CDC_Device_ReceiveByte(&VirtualSerial2_CDC_Interface);
 		if (!(ReceivedByte < 0))
 		  CDC_Device_SendByte(&VirtualSerial2_CDC_Interface, (uint8_t)ReceivedByte);
+		#endif
 
 		CDC_Device_USBTask(&VirtualSerial1_CDC_Interface);
 		CDC_Device_USBTask(&VirtualSerial2_CDC_Interface);
@@ -174,6 +182,29 @@ void CheckJoystickMovement(void)
 	}
 }
 
+#if defined(USB_ENABLE_TRACE)
+/** Sends the next chunk of the binary USB event trace to the host through the second of the CDC interfaces, once
+ *  the host has opened the port. The trace may be decoded on the host with the TraceDecoder script supplied with
+ *  this demo.
+ */
+void SendTraceData(void)
+{
+	uint8_t TraceData[CDC_TXRX_EPSIZE];
+
+	/* Leave the trace in the ring buffer until a terminal is ready to receive it */
+	if ((USB_DeviceState != DEVICE_STATE_Configured) ||
+	    !(VirtualSerial2_CDC_Interface.State.ControlLineStates.HostToDevice & CDC_CONTROL_LINE_OUT_DTR))
+	{
+		return;
+	}
+
+	uint16_t TraceLength = USB_Trace_ReadStream(TraceData, sizeof(TraceData));
+
+	if (TraceLength)
+	  CDC_Device_SendData(&VirtualSerial2_CDC_Interface, (const char*)TraceData, TraceLength);
+}
+#endif
+
 /** Event handler for the library USB Connection event. */
 void EVENT_USB_Device_Connect(void)
 {
@@ -66,6 +66,10 @@
 		void SetupHardware(void);
 		void CheckJoystickMovement(void);
 
+		#if defined(USB_ENABLE_TRACE)
+		void SendTraceData(void);
+		#endif
+
 		void EVENT_USB_Device_Connect(void);
 		void EVENT_USB_Device_Disconnect(void);
 		void EVENT_USB_Device_ConfigurationChanged(void);
@@ -0,0 +1,169 @@
+#! /usr/bin/python
+
+#             LUFA Library
+#     Copyright (C) Dean Camera, 2012.
+#
+#  dean [at] fourwalledcubicle [dot] com
+#           www.lufa-lib.org
+
+# Decoder for the binary USB event trace sent by the DualVirtualSerial demo
+# when built with USB_ENABLE_TRACE defined. The trace is read either live
+# from the demo's second virtual serial port, or from a previously captured
+# file, and each trace record, endpoint statistics snapshot and dropped
+# record count is printed as it is decoded. When reading from a serial port,
+# the endpoint statistics are requested once per second. Requires the
+# pySerial module for live decoding.
+#
+# Usage: USBTraceDecoder.py <serial port | capture file> [output capture file]
+
+import os
+import struct
+import sys
+import time
+
+STREAM_SYNC     = 0xA5
+
+FRAME_RECORD    = 0x01
+FRAME_COUNTERS  = 0x02
+FRAME_DROPPED   = 0x03
+
+FRAME_LENGTHS   = {FRAME_RECORD: 8, FRAME_COUNTERS: 15, FRAME_DROPPED: 2}
+
+EVENT_NAMES     = {0x01: "Device Connect",
+                   0x02: "Device Disconnect",
+                   0x03: "Device Suspend",
+                   0x04: "Device Wake Up",
+                   0x05: "Device Reset",
+                   0x06: "Device Control Request",
+                   0x10: "Host Device Attached",
+                   0x11: "Host Device Unattached",
+                   0x12: "Host VBUS Error",
+                   0x13: "Host Enumeration Error",
+                   0x14: "Host Control Request",
+                   0x15: "Host Control Error",
+                   0x20: "Stall",
+                   0x21: "Timeout",
+                   0x30: "UID Change"}
+
+
+def format_record(payload):
+	(frame, sub_frame, event, address, param, value) = struct.unpack("<HBBBBH", payload)
+
+	if event >= 0x80:
+		name = "User Event %d" % (event - 0x80)
+	else:
+		name = EVENT_NAMES.get(event, "Unknown Event 0x%02X" % event)
+
+	details = ""
+	if event in (0x06, 0x14):
+		details = "bmRequestType 0x%02X, bRequest 0x%02X, wValue 0x%04X" % (address, param, value)
+	elif event == 0x15:
+		details = "bmRequestType 0x%02X, bRequest 0x%02X, error %d" % (address, value, param)
+	elif event == 0x13:
+		details = "error %d, sub error %d" % (param, value)
+	elif event in (0x20, 0x21):
+		details = "address 0x%02X" % address
+	elif event >= 0x80:
+		details = "address 0x%02X, param 0x%02X, value 0x%04X" % (address, param, value)
+
+	return "[%4d.%03d] %-24s %s" % (frame, sub_frame, name, details)
+
+
+def format_counters(payload):
+	(number, bytes_sent, sent, received, naks, stalls, timeouts) = struct.unpack("<BIHHHHH", payload)
+
+	return ("Endpoint %d: %d bytes in %d packets sent, %d packets received, "
+	        "%d NAKed, %d stalls, %d timeouts" % (number, bytes_sent, sent, received, naks, stalls, timeouts))
+
+
+class TraceDecoder(object):
+	def __init__(self):
+		self.buffer = bytearray()
+
+	def decode(self, data):
+		self.buffer.extend(data)
+		lines = []
+
+		while len(self.buffer) >= 2:
+			# Skip forward to the next sync byte if the stream was joined part way through a frame
+			if (self.buffer[0] != STREAM_SYNC) or (self.buffer[1] not in FRAME_LENGTHS):
+				del self.buffer[0]
+				continue
+
+			frame_type   = self.buffer[1]
+			frame_length = 2 + FRAME_LENGTHS[frame_type]
+
+			if len(self.buffer) < frame_length:
+				break
+
+			payload = bytes(self.buffer[2 : frame_length])
+			del self.buffer[: frame_length]
+
+			if frame_type == FRAME_RECORD:
+				lines.append(format_record(payload))
+			elif frame_type == FRAME_COUNTERS:
+				lines.append(format_counters(payload))
+			else:
+				lines.append("*** %d records dropped ***" % struct.unpack("<H", payload)[0])
+
+		return lines
+
+
+def decode_file(file_name):
+	decoder = TraceDecoder()
+
+	with open(file_name, "rb") as capture:
+		for line in decoder.decode(capture.read()):
+			print(line)
+
+
+def decode_port(port_name, capture_name):
+	import serial
+
+	port    = serial.Serial(port_name, 115200, timeout=0.1)
+	capture = open(capture_name, "wb") if capture_name else None
+	decoder = TraceDecoder()
+
+	# The demo only sends the trace once the port has been opened with DTR asserted
+	port.dtr = True
+
+	next_request = time.time()
+	try:
+		while True:
+			if time.time() >= next_request:
+				port.write(b"?")
+				next_request += 1
+
+			data = port.read(256)
+			if not data:
+				continue
+
+			if capture:
+				capture.write(data)
+
+			for line in decoder.decode(data):
+				print(line)
+	except KeyboardInterrupt:
+		pass
+	finally:
+		port.close()
+
+		if capture:
+			capture.close()
+
+
+def main():
+	if len(sys.argv) < 2:
+		print("Usage: %s <serial port | capture file> [output capture file]" % sys.argv[0])
+		return 1
+
+	if os.path.isfile(sys.argv[1]):
+		decode_file(sys.argv[1])
+	else:
+		decode_port(sys.argv[1], sys.argv[2] if len(sys.argv) > 2 else None)
+
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())
@@ -36,6 +36,18 @@
 
 #include "MIDI.h"
 
+/** Circular buffer to hold bytes received from the DIN-MIDI port until they can be sent to the host. */
+static SPSCRingBuffer_t DINtoUSB_Buffer;
+
+/** Underlying data buffer for \ref DINtoUSB_Buffer, where the stored bytes are located. */
+static uint8_t          DINtoUSB_Buffer_Data[128];
+
+/** MIDI byte stream parser, converting the bytes received from the DIN-MIDI port into event packets for the host. */
+static MIDI_StreamParser_t DINtoUSB_Parser;
+
+/** MIDI byte stream writer, converting event packets from the host into bytes for the DIN-MIDI port. */
+static MIDI_StreamWriter_t USBtoDIN_Writer;
+
 /** LUFA MIDI Class driver interface configuration and state information. This structure is
  *  passed to all MIDI Class driver functions, so that multiple instances of the same class
  *  within a device can be differentiated from one another.
@@ -68,21 +80,16 @@ int main(void)
 {
 	SetupHardware();
 
+	SPSCRingBuffer_InitBuffer(&DINtoUSB_Buffer, DINtoUSB_Buffer_Data, sizeof(DINtoUSB_Buffer_Data));
+
 	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
 	GlobalInterruptEnable();
 
 	for (;;)
 	{
 		CheckJoystickMovement();
-
-		MIDI_EventPacket_t ReceivedMIDIEvent;
-		while (MIDI_Device_ReceiveEventPacket(&Keyboard_MIDI_Interface, &ReceivedMIDIEvent))
-		{
-			if ((ReceivedMIDIEvent.Event == MIDI_EVENT(0, MIDI_COMMAND_NOTE_ON)) && (ReceivedMIDIEvent.Data3 > 0))
-			  LEDs_SetAllLEDs(ReceivedMIDIEvent.Data2 > 64 ? LEDS_LED1 : LEDS_LED2);
-			else
-			  LEDs_SetAllLEDs(LEDS_NO_LEDS);
-		}
+		DINtoUSB_SendStream();
+		USBtoDIN_ReceiveEvents();
 
 		MIDI_Device_USBTask(&Keyboard_MIDI_Interface);
 		USB_USBTask();
@@ -104,6 +111,48 @@ void SetupHardware(void)
 	LEDs_Init();
 	Buttons_Init();
 	USB_Init();
+
+	/* Start the DIN-MIDI port USART at the standard MIDI baud rate, with reception interrupt driven */
+	Serial_Init(31250, false);
+	UCSR1B |= (1 << RXCIE1);
+}
+
+/** Sends the bytes waiting in the DIN-MIDI to USB buffer to the host, converting them into MIDI event packets. Whole
+ *  spans of the buffer are converted and sent at once, so that long System Exclusive dumps fill complete endpoint banks.
+ */
+void DINtoUSB_SendStream(void)
+{
+	uint16_t SpanLength;
+	uint8_t* Span = SPSCRingBuffer_GetReadSpan(&DINtoUSB_Buffer, &SpanLength);
+
+	if (!(SpanLength))
+	  return;
+
+	MIDI_Device_SendStream(&Keyboard_MIDI_Interface, &DINtoUSB_Parser, Span, SpanLength);
+	SPSCRingBuffer_CommitRead(&DINtoUSB_Buffer, SpanLength);
+}
+
+/** Receives MIDI event packets from the host, showing note events on the board LEDs and forwarding every event out of
+ *  the DIN-MIDI port as a running status compressed byte stream.
+ */
+void USBtoDIN_ReceiveEvents(void)
+{
+	MIDI_EventPacket_t ReceivedMIDIEvents[MIDI_STREAM_EPSIZE / sizeof(MIDI_EventPacket_t)];
+	uint16_t           TotalEvents = MIDI_Device_ReceiveEventPackets(&Keyboard_MIDI_Interface, ReceivedMIDIEvents,
+	                                                                 (sizeof(ReceivedMIDIEvents) / sizeof(ReceivedMIDIEvents[0])));
+
+	for (uint16_t i = 0; i < TotalEvents; i++)
+	{
+		MIDI_EventPacket_t* ReceivedMIDIEvent = &ReceivedMIDIEvents[i];
+		uint8_t             StreamBytes[3];
+
+		if ((ReceivedMIDIEvent->Event == MIDI_EVENT(0, MIDI_COMMAND_NOTE_ON)) && (ReceivedMIDIEvent->Data3 > 0))
+		  LEDs_SetAllLEDs(ReceivedMIDIEvent->Data2 > 64 ? LEDS_LED1 : LEDS_LED2);
+		else
+		  LEDs_SetAllLEDs(LEDS_NO_LEDS);
+
+		Serial_SendData(StreamBytes, MIDI_ConvertEventToStream(&USBtoDIN_Writer, ReceivedMIDIEvent, StreamBytes));
+	}
 }
 
 /** Checks for changes in the position of the board joystick, sending MIDI events to the host upon each change. */
@@ -188,6 +237,9 @@ void EVENT_USB_Device_ConfigurationChanged(void)
 
 	ConfigSuccess &= MIDI_Device_ConfigureEndpoints(&Keyboard_MIDI_Interface);
 
+	MIDI_InitStreamParser(&DINtoUSB_Parser, 0);
+	MIDI_InitStreamWriter(&USBtoDIN_Writer);
+
 	LEDs_SetAllLEDs(ConfigSuccess ? LEDMASK_USB_READY : LEDMASK_USB_ERROR);
 }
 
@@ -197,3 +249,14 @@ void EVENT_USB_Device_ControlRequest(void)
 	MIDI_Device_ProcessControlRequest(&Keyboard_MIDI_Interface);
 }
 
+/** ISR to manage the reception of data from the DIN-MIDI port, placing received bytes into a circular buffer
+ *  for later conversion and transmission to the host.
+ */
+ISR(USART1_RX_vect, ISR_BLOCK)
+{
+	uint8_t ReceivedByte = UDR1;
+
+	if ((USB_DeviceState == DEVICE_STATE_Configured) && !(SPSCRingBuffer_IsFull(&DINtoUSB_Buffer)))
+	  SPSCRingBuffer_Insert(&DINtoUSB_Buffer, ReceivedByte);
+}
+
@@ -49,6 +49,8 @@
 		#include <LUFA/Drivers/Board/LEDs.h>
 		#include <LUFA/Drivers/Board/Joystick.h>
 		#include <LUFA/Drivers/Board/Buttons.h>
+		#include <LUFA/Drivers/Peripheral/Serial.h>
+		#include <LUFA/Drivers/Misc/SPSCRingBuffer.h>
 		#include <LUFA/Drivers/USB/USB.h>
 
 	/* Macros: */
@@ -67,6 +69,8 @@
 	/* Function Prototypes: */
 		void SetupHardware(void);
 		void CheckJoystickMovement(void);
+		void DINtoUSB_SendStream(void);
+		void USBtoDIN_ReceiveEvents(void);
 
 		void EVENT_USB_Device_Connect(void);
 		void EVENT_USB_Device_Disconnect(void);
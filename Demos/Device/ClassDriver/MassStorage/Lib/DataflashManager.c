@@ -31,48 +31,174 @@
 /** \file
  *
  *  Functions to manage the physical Dataflash media, including reading and writing of
- *  blocks of data. These functions are called by the SCSI layer when data must be stored
- *  or retrieved to/from the physical storage media. If a different media is used (such
- *  as a SD card or EEPROM), functions similar to these will need to be generated.
+ *  blocks of data. These functions are called by the library SCSI command layer through the
+ *  \ref DataflashManager_BlockDevice block device driver when data must be stored or retrieved
+ *  to/from the physical storage media. If a different media is used (such as a SD card or
+ *  EEPROM), a block device driver similar to this one will need to be written.
  */
 
 #define  INCLUDE_FROM_DATAFLASHMANAGER_C
 #include "DataflashManager.h"
 
+/** Mask of the Dataflash ICs whose next page write should be made through their second SRAM buffer rather than the first.
+ *  Each IC alternates between its two buffers on every page written, so that the next page can be loaded into one buffer
+ *  while the IC is still programming the previous page from the other.
+ */
+static uint8_t  SecondBufferChipsMask;
+
+/** Indicates if a page read was left open on the selected Dataflash IC at the end of the last \ref DataflashManager_ReadBlocks()
+ *  call, ready to continue from \ref NextReadBlock.
+ */
+static bool     ReadStreamOpen;
+
+/** Block address immediately following the last block read by \ref DataflashManager_ReadBlocks(). */
+static uint32_t NextReadBlock;
+
+/** Block device driver for the board Dataflash, through which the library SCSI command layer accesses the
+ *  Dataflash on behalf of the logical units of the Mass Storage interface.
+ */
+const MS_Device_BlockDevice_t DataflashManager_BlockDevice =
+	{
+		.ReadBlocks  = DataflashManager_ReadLUNBlocks,
+		.WriteBlocks = DataflashManager_WriteLUNBlocks,
+		.SelfTest    = DataflashManager_SelfTestLUN,
+	};
+
+/** Structure to hold the SCSI response data to a SCSI INQUIRY command. This gives information about the device's
+ *  features and capabilities.
+ */
+const SCSI_Inquiry_Response_t DataflashManager_InquiryData =
+	{
+		.DeviceType          = DEVICE_TYPE_BLOCK,
+		.PeripheralQualifier = 0,
+
+		.Removable           = true,
+
+		.Version             = 0,
+
+		.ResponseDataFormat  = 2,
+		.NormACA             = false,
+		.TrmTsk              = false,
+		.AERC                = false,
+
+		.AdditionalLength    = 0x1F,
+
+		.SoftReset           = false,
+		.CmdQue              = false,
+		.Linked              = false,
+		.Sync                = false,
+		.WideBus16Bit        = false,
+		.WideBus32Bit        = false,
+		.RelAddr             = false,
+
+		.VendorID            = "LUFA",
+		.ProductID           = "Dataflash Disk",
+		.RevisionID          = {'0','.','0','0'},
+	};
+
+/** Selects the Dataflash IC holding the given page and opens a write into the SRAM buffer to be used for the page's next
+ *  program cycle, copying in the page's existing contents first if they are to be partially preserved.
+ *
+ *  \param[in] PageAddress   Dataflash page address that is to be written
+ *  \param[in] PageByte      Byte offset within the page at which the new data starts
+ *  \param[in] PreservePage  If \c true, the existing page contents are loaded into the buffer before it is written to
+ */
+static void DataflashManager_BeginPageWrite(const uint16_t PageAddress,
+                                            const uint16_t PageByte,
+                                            const bool PreservePage)
+{
+	bool UseSecondBuffer = (SecondBufferChipsMask & DATAFLASHMANAGER_CHIP_BIT(PageAddress));
+
+	/* Select the correct Dataflash IC for the page requested */
+	Dataflash_SelectChipFromPage(PageAddress);
+
+	if (PreservePage)
+	{
+		/* Copy selected dataflash's current page contents to the Dataflash buffer once any pending program cycle is complete */
+		Dataflash_WaitWhileBusy();
+		Dataflash_SendByte(UseSecondBuffer ? DF_CMD_MAINMEMTOBUFF2 : DF_CMD_MAINMEMTOBUFF1);
+		Dataflash_SendAddressBytes(PageAddress, 0);
+		Dataflash_WaitWhileBusy();
+	}
+
+	/* Send the Dataflash buffer write command */
+	Dataflash_SendByte(UseSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
+	Dataflash_SendAddressBytes(0, PageByte);
+}
+
+/** Starts the program cycle writing the buffer opened by \ref DataflashManager_BeginPageWrite() back to the given page, on
+ *  the currently selected Dataflash IC. This does not wait for the program cycle to complete; the IC's next page write is
+ *  made through its other buffer, and any operation needing the IC's main memory waits for it to become ready first.
+ *
+ *  \param[in] PageAddress  Dataflash page address that is being written
+ */
+static void DataflashManager_EndPageWrite(const uint16_t PageAddress)
+{
+	uint8_t ChipBit = DATAFLASHMANAGER_CHIP_BIT(PageAddress);
+
+	/* Wait for the IC to finish programming its previous page from the other buffer, then program this page */
+	Dataflash_WaitWhileBusy();
+	Dataflash_SendByte((SecondBufferChipsMask & ChipBit) ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
+	Dataflash_SendAddressBytes(PageAddress, 0);
+
+	/* Start the program cycle, and switch buffers for the next page written to this IC */
+	Dataflash_DeselectChip();
+	SecondBufferChipsMask ^= ChipBit;
+}
+
+/** Selects the Dataflash IC holding the given page and opens a read of the page's main memory at the given byte offset,
+ *  once the IC has finished any program cycle left running by an earlier write.
+ *
+ *  \param[in] PageAddress  Dataflash page address that is to be read
+ *  \param[in] PageByte     Byte offset within the page at which to start reading
+ */
+static void DataflashManager_BeginPageRead(const uint16_t PageAddress,
+                                           const uint16_t PageByte)
+{
+	/* Select the correct Dataflash IC for the page requested */
+	Dataflash_SelectChipFromPage(PageAddress);
+	Dataflash_WaitWhileBusy();
+
+	/* Send the Dataflash main memory page read command */
+	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
+	Dataflash_SendAddressBytes(PageAddress, PageByte);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+}
+
 /** Writes blocks (OS blocks, not Dataflash pages) to the storage medium, the board Dataflash IC(s), from
  *  the pre-selected data OUT endpoint. This routine reads in OS sized blocks from the endpoint and writes
  *  them to the Dataflash in Dataflash page sized blocks.
  *
+ *  Consecutive pages are spread across the Dataflash ICs and alternate between each IC's two SRAM buffers,
+ *  so that the data for the next page is received from the host while earlier pages are still programming.
+ *  The final program cycle is left running when the routine returns.
+ *
  *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
  *  \param[in] BlockAddress  Data block starting address for the write sequence
  *  \param[in] TotalBlocks   Number of blocks of data to write
+ *
+ *  \return Boolean \c true if all the blocks were written, \c false if the transfer was aborted
  */
-void DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+bool DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
                                   const uint32_t BlockAddress,
                                   uint16_t TotalBlocks)
 {
 	uint16_t CurrDFPage          = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
 	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
 	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
-	bool     UsingSecondBuffer   = false;
 
-	/* Select the correct starting Dataflash IC for the block requested */
-	Dataflash_SelectChipFromPage(CurrDFPage);
+	ReadStreamOpen = false;
 
-#if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
-	/* Copy selected dataflash's current page contents to the Dataflash buffer */
-	Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
-	Dataflash_SendAddressBytes(CurrDFPage, 0);
-	Dataflash_WaitWhileBusy();
-#endif
-
-	/* Send the Dataflash buffer write command */
-	Dataflash_SendByte(DF_CMD_BUFF1WRITE);
-	Dataflash_SendAddressBytes(0, CurrDFPageByte);
+	/* Open the first page, preserving its existing contents if the new data does not cover all of it */
+	DataflashManager_BeginPageWrite(CurrDFPage, CurrDFPageByte,
+	                                (CurrDFPageByte || (((uint32_t)TotalBlocks * VIRTUAL_MEMORY_BLOCK_SIZE) < DATAFLASH_PAGE_SIZE)));
 
 	/* Wait until endpoint is ready before continuing */
 	if (Endpoint_WaitUntilReady())
-	  return;
+	  return false;
 
 	while (TotalBlocks)
 	{
@@ -89,43 +215,22 @@ void DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceIn
 
 				/* Wait until the host has sent another packet */
 				if (Endpoint_WaitUntilReady())
-				  return;
+				  return false;
 			}
 
 			/* Check if end of Dataflash page reached */
 			if (CurrDFPageByteDiv16 == (DATAFLASH_PAGE_SIZE >> 4))
 			{
-				/* Write the Dataflash buffer contents back to the Dataflash page */
-				Dataflash_WaitWhileBusy();
-				Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-				Dataflash_SendAddressBytes(CurrDFPage, 0);
+				/* Start writing the Dataflash buffer contents back to the Dataflash page */
+				DataflashManager_EndPageWrite(CurrDFPage);
 
 				/* Reset the Dataflash buffer counter, increment the page counter */
 				CurrDFPageByteDiv16 = 0;
 				CurrDFPage++;
 
-				/* Once all the Dataflash ICs have had their first buffers filled, switch buffers to maintain throughput */
-				if (Dataflash_GetSelectedChip() == DATAFLASH_CHIP_MASK(DATAFLASH_TOTALCHIPS))
-				  UsingSecondBuffer = !(UsingSecondBuffer);
-
-				/* Select the next Dataflash chip based on the new Dataflash page index */
-				Dataflash_SelectChipFromPage(CurrDFPage);
-
-#if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
-				/* If less than one Dataflash page remaining, copy over the existing page to preserve trailing data */
-				if ((TotalBlocks * (VIRTUAL_MEMORY_BLOCK_SIZE >> 4)) < (DATAFLASH_PAGE_SIZE >> 4))
-				{
-					/* Copy selected dataflash's current page contents to the Dataflash buffer */
-					Dataflash_WaitWhileBusy();
-					Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_MAINMEMTOBUFF2 : DF_CMD_MAINMEMTOBUFF1);
-					Dataflash_SendAddressBytes(CurrDFPage, 0);
-					Dataflash_WaitWhileBusy();
-				}
-#endif
-
-				/* Send the Dataflash buffer write command */
-				Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
-				Dataflash_SendAddressBytes(0, 0);
+				/* Open the next page, preserving its trailing data if less than one Dataflash page remains to be written */
+				uint32_t ChunksRemaining = (((uint32_t)TotalBlocks * (VIRTUAL_MEMORY_BLOCK_SIZE >> 4)) - BytesInBlockDiv16);
+				DataflashManager_BeginPageWrite(CurrDFPage, 0, (ChunksRemaining < (DATAFLASH_PAGE_SIZE >> 4)));
 			}
 
 			/* Write one 16-byte chunk of data to the Dataflash */
@@ -154,36 +259,37 @@ void DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceIn
 
 			/* Check if the current command is being aborted by the host */
 			if (MSInterfaceInfo->State.IsMassStoreReset)
-			  return;
+			  return false;
 		}
 
 		/* Decrement the blocks remaining counter */
 		TotalBlocks--;
 	}
 
-	/* Write the Dataflash buffer contents back to the Dataflash page */
-	Dataflash_WaitWhileBusy();
-	Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-	Dataflash_SendAddressBytes(CurrDFPage, 0x00);
-	Dataflash_WaitWhileBusy();
+	/* Start writing the last Dataflash buffer back to its page, leaving the program cycle to complete in the background */
+	DataflashManager_EndPageWrite(CurrDFPage);
 
 	/* If the endpoint is empty, clear it ready for the next packet from the host */
 	if (!(Endpoint_IsReadWriteAllowed()))
 	  Endpoint_ClearOUT();
 
-	/* Deselect all Dataflash chips */
-	Dataflash_DeselectChip();
+	return true;
 }
 
 /** Reads blocks (OS blocks, not Dataflash pages) from the storage medium, the board Dataflash IC(s), into
  *  the pre-selected data IN endpoint. This routine reads in Dataflash page sized blocks from the Dataflash
  *  and writes them in OS sized blocks to the endpoint.
  *
+ *  The Dataflash page read is left open once all the requested blocks have been sent, so that a following
+ *  sequential read starting part way through the same page can carry on without reissuing the read command.
+ *
  *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
  *  \param[in] BlockAddress  Data block starting address for the read sequence
  *  \param[in] TotalBlocks   Number of blocks of data to read
+ *
+ *  \return Boolean \c true if all the blocks were read, \c false if the transfer was aborted
  */
-void DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+bool DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
                                  const uint32_t BlockAddress,
                                  uint16_t TotalBlocks)
 {
@@ -191,20 +297,16 @@ void DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInf
 	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
 	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
 
-	/* Select the correct starting Dataflash IC for the block requested */
-	Dataflash_SelectChipFromPage(CurrDFPage);
+	/* Reuse the page read left open by the previous command if this one continues on from it part way through the page */
+	if (!(ReadStreamOpen && CurrDFPageByte && (BlockAddress == NextReadBlock)))
+	  DataflashManager_BeginPageRead(CurrDFPage, CurrDFPageByte);
 
-	/* Send the Dataflash main memory page read command */
-	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
-	Dataflash_SendAddressBytes(CurrDFPage, CurrDFPageByte);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
+	ReadStreamOpen = false;
+	NextReadBlock  = (BlockAddress + TotalBlocks);
 
 	/* Wait until endpoint is ready before continuing */
 	if (Endpoint_WaitUntilReady())
-	  return;
+	  return false;
 
 	while (TotalBlocks)
 	{
@@ -221,7 +323,7 @@ void DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInf
 
 				/* Wait until the endpoint is ready for more data */
 				if (Endpoint_WaitUntilReady())
-				  return;
+				  return false;
 			}
 
 			/* Check if end of Dataflash page reached */
@@ -231,16 +333,8 @@ void DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInf
 				CurrDFPageByteDiv16 = 0;
 				CurrDFPage++;
 
-				/* Select the next Dataflash chip based on the new Dataflash page index */
-				Dataflash_SelectChipFromPage(CurrDFPage);
-
-				/* Send the Dataflash main memory page read command */
-				Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
-				Dataflash_SendAddressBytes(CurrDFPage, 0);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
+				/* Open a read of the next page, on the Dataflash IC holding it */
+				DataflashManager_BeginPageRead(CurrDFPage, 0);
 			}
 
 			/* Read one 16-byte chunk of data from the Dataflash */
@@ -269,7 +363,7 @@ void DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInf
 
 			/* Check if the current command is being aborted by the host */
 			if (MSInterfaceInfo->State.IsMassStoreReset)
-			  return;
+			  return false;
 		}
 
 		/* Decrement the blocks remaining counter */
@@ -280,8 +374,10 @@ void DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInf
 	if (!(Endpoint_IsReadWriteAllowed()))
 	  Endpoint_ClearIN();
 
-	/* Deselect all Dataflash chips */
-	Dataflash_DeselectChip();
+	/* Leave the Dataflash IC selected with the page read open, ready for a following sequential read */
+	ReadStreamOpen = true;
+
+	return true;
 }
 
 /** Writes blocks (OS blocks, not Dataflash pages) to the storage medium, the board Dataflash IC(s), from
@@ -300,21 +396,12 @@ void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 	uint16_t CurrDFPage          = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
 	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
 	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
-	bool     UsingSecondBuffer   = false;
 
-	/* Select the correct starting Dataflash IC for the block requested */
-	Dataflash_SelectChipFromPage(CurrDFPage);
+	ReadStreamOpen = false;
 
-#if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
-	/* Copy selected dataflash's current page contents to the Dataflash buffer */
-	Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
-	Dataflash_SendAddressBytes(CurrDFPage, 0);
-	Dataflash_WaitWhileBusy();
-#endif
-
-	/* Send the Dataflash buffer write command */
-	Dataflash_SendByte(DF_CMD_BUFF1WRITE);
-	Dataflash_SendAddressBytes(0, CurrDFPageByte);
+	/* Open the first page, preserving its existing contents if the new data does not cover all of it */
+	DataflashManager_BeginPageWrite(CurrDFPage, CurrDFPageByte,
+	                                (CurrDFPageByte || (((uint32_t)TotalBlocks * VIRTUAL_MEMORY_BLOCK_SIZE) < DATAFLASH_PAGE_SIZE)));
 
 	while (TotalBlocks)
 	{
@@ -326,38 +413,16 @@ void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 			/* Check if end of Dataflash page reached */
 			if (CurrDFPageByteDiv16 == (DATAFLASH_PAGE_SIZE >> 4))
 			{
-				/* Write the Dataflash buffer contents back to the Dataflash page */
-				Dataflash_WaitWhileBusy();
-				Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-				Dataflash_SendAddressBytes(CurrDFPage, 0);
+				/* Start writing the Dataflash buffer contents back to the Dataflash page */
+				DataflashManager_EndPageWrite(CurrDFPage);
 
 				/* Reset the Dataflash buffer counter, increment the page counter */
 				CurrDFPageByteDiv16 = 0;
 				CurrDFPage++;
 
-				/* Once all the Dataflash ICs have had their first buffers filled, switch buffers to maintain throughput */
-				if (Dataflash_GetSelectedChip() == DATAFLASH_CHIP_MASK(DATAFLASH_TOTALCHIPS))
-				  UsingSecondBuffer = !(UsingSecondBuffer);
-
-				/* Select the next Dataflash chip based on the new Dataflash page index */
-				Dataflash_SelectChipFromPage(CurrDFPage);
-
-#if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
-				/* If less than one Dataflash page remaining, copy over the existing page to preserve trailing data */
-				if ((TotalBlocks * (VIRTUAL_MEMORY_BLOCK_SIZE >> 4)) < (DATAFLASH_PAGE_SIZE >> 4))
-				{
-					/* Copy selected dataflash's current page contents to the Dataflash buffer */
-					Dataflash_WaitWhileBusy();
-					Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_MAINMEMTOBUFF2 : DF_CMD_MAINMEMTOBUFF1);
-					Dataflash_SendAddressBytes(CurrDFPage, 0);
-					Dataflash_WaitWhileBusy();
-				}
-#endif
-
-				/* Send the Dataflash buffer write command */
-				Dataflash_ToggleSelectedChipCS();
-				Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
-				Dataflash_SendAddressBytes(0, 0);
+				/* Open the next page, preserving its trailing data if less than one Dataflash page remains to be written */
+				uint32_t ChunksRemaining = (((uint32_t)TotalBlocks * (VIRTUAL_MEMORY_BLOCK_SIZE >> 4)) - BytesInBlockDiv16);
+				DataflashManager_BeginPageWrite(CurrDFPage, 0, (ChunksRemaining < (DATAFLASH_PAGE_SIZE >> 4)));
 			}
 
 			/* Write one 16-byte chunk of data to the Dataflash */
@@ -375,14 +440,8 @@ void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 		TotalBlocks--;
 	}
 
-	/* Write the Dataflash buffer contents back to the Dataflash page */
-	Dataflash_WaitWhileBusy();
-	Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-	Dataflash_SendAddressBytes(CurrDFPage, 0x00);
-	Dataflash_WaitWhileBusy();
-
-	/* Deselect all Dataflash chips */
-	Dataflash_DeselectChip();
+	/* Start writing the last Dataflash buffer back to its page, leaving the program cycle to complete in the background */
+	DataflashManager_EndPageWrite(CurrDFPage);
 }
 
 /** Reads blocks (OS blocks, not Dataflash pages) from the storage medium, the board Dataflash IC(s), into
@@ -402,16 +461,10 @@ void DataflashManager_ReadBlocks_RAM(const uint32_t BlockAddress,
 	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
 	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
 
-	/* Select the correct starting Dataflash IC for the block requested */
-	Dataflash_SelectChipFromPage(CurrDFPage);
+	ReadStreamOpen = false;
 
-	/* Send the Dataflash main memory page read command */
-	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
-	Dataflash_SendAddressBytes(CurrDFPage, CurrDFPageByte);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
+	/* Open a read of the first page, on the Dataflash IC holding it */
+	DataflashManager_BeginPageRead(CurrDFPage, CurrDFPageByte);
 
 	while (TotalBlocks)
 	{
@@ -427,16 +480,8 @@ void DataflashManager_ReadBlocks_RAM(const uint32_t BlockAddress,
 				CurrDFPageByteDiv16 = 0;
 				CurrDFPage++;
 
-				/* Select the next Dataflash chip based on the new Dataflash page index */
-				Dataflash_SelectChipFromPage(CurrDFPage);
-
-				/* Send the Dataflash main memory page read command */
-				Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
-				Dataflash_SendAddressBytes(CurrDFPage, 0);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
+				/* Open a read of the next page, on the Dataflash IC holding it */
+				DataflashManager_BeginPageRead(CurrDFPage, 0);
 			}
 
 			/* Read one 16-byte chunk of data from the Dataflash */
@@ -458,6 +503,52 @@ void DataflashManager_ReadBlocks_RAM(const uint32_t BlockAddress,
 	Dataflash_DeselectChip();
 }
 
+/** Block device driver routine for \ref DataflashManager_BlockDevice, reading blocks of a logical unit to the host.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
+ *  \param[in] LUN              Pointer to the definition of the logical unit being read
+ *  \param[in] BlockAddress     Dataflash block starting address for the read sequence
+ *  \param[in] TotalBlocks      Number of blocks of data to read
+ *
+ *  \return Boolean \c true if all the blocks were read, \c false if the transfer was aborted
+ */
+static bool DataflashManager_ReadLUNBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                           const MS_Device_LUN_t* const LUN,
+                                           const uint32_t BlockAddress,
+                                           const uint16_t TotalBlocks)
+{
+	return DataflashManager_ReadBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+}
+
+/** Block device driver routine for \ref DataflashManager_BlockDevice, writing blocks of a logical unit from the host.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
+ *  \param[in] LUN              Pointer to the definition of the logical unit being written
+ *  \param[in] BlockAddress     Dataflash block starting address for the write sequence
+ *  \param[in] TotalBlocks      Number of blocks of data to write
+ *
+ *  \return Boolean \c true if all the blocks were written, \c false if the transfer was aborted
+ */
+static bool DataflashManager_WriteLUNBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                            const MS_Device_LUN_t* const LUN,
+                                            const uint32_t BlockAddress,
+                                            const uint16_t TotalBlocks)
+{
+	return DataflashManager_WriteBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+}
+
+/** Block device driver routine for \ref DataflashManager_BlockDevice, run when the host requests a self-test of a
+ *  logical unit.
+ *
+ *  \param[in] LUN  Pointer to the definition of the logical unit being tested
+ *
+ *  \return Boolean \c true if all media chips are working, \c false otherwise
+ */
+static bool DataflashManager_SelfTestLUN(const MS_Device_LUN_t* const LUN)
+{
+	return DataflashManager_CheckDataflashOperation();
+}
+
 /** Disables the Dataflash memory write protection bits on the board Dataflash ICs, if enabled. */
 void DataflashManager_ResetDataflashProtections(void)
 {
@@ -507,8 +598,12 @@ bool DataflashManager_CheckDataflashOperation(void)
 {
 	uint8_t ReturnByte;
 
+	/* Any page read left open by an earlier command is ended by reselecting the Dataflash ICs */
+	ReadStreamOpen = false;
+
 	/* Test first Dataflash IC is present and responding to commands */
 	Dataflash_SelectChip(DATAFLASH_CHIP1);
+	Dataflash_WaitWhileBusy();
 	Dataflash_SendByte(DF_CMD_READMANUFACTURERDEVICEINFO);
 	ReturnByte = Dataflash_ReceiveByte();
 	Dataflash_DeselectChip();
@@ -520,6 +615,7 @@ bool DataflashManager_CheckDataflashOperation(void)
 	#if (DATAFLASH_TOTALCHIPS == 2)
 	/* Test second Dataflash IC is present and responding to commands */
 	Dataflash_SelectChip(DATAFLASH_CHIP2);
+	Dataflash_WaitWhileBusy();
 	Dataflash_SendByte(DF_CMD_READMANUFACTURERDEVICEINFO);
 	ReturnByte = Dataflash_ReceiveByte();
 	Dataflash_DeselectChip();
@@ -45,7 +45,6 @@
 
 		#include "Descriptors.h"
 
-		#include "Lib/SCSI.h"
 		#include "Lib/DataflashManager.h"
 		#include "Config/AppConfig.h"
 
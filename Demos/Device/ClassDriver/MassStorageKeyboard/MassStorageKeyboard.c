@@ -37,6 +37,9 @@
 
 #include "MassStorageKeyboard.h"
 
+/** Logical units of the Mass Storage interface, each mapped onto an equal sized region of the board Dataflash. */
+static MS_Device_LUN_t Disk_LUNs[TOTAL_LUNS];
+
 /** LUFA Mass Storage Class driver interface configuration and state information. This structure is
  *  passed to all Mass Storage Class driver functions, so that multiple instances of the same class
  *  within a device can be differentiated from one another.
@@ -59,6 +62,7 @@ USB_ClassInfo_MS_Device_t Disk_MS_Interface =
 						.Banks             = 1,
 					},
 				.TotalLUNs                 = TOTAL_LUNS,
+				.LUNs                      = Disk_LUNs,
 			},
 	};
 
@@ -130,6 +134,20 @@ void SetupHardware(void)
 
 	/* Clear Dataflash sector protections, if enabled */
 	DataflashManager_ResetDataflashProtections();
+
+	/* Split the Dataflash evenly between the disk's logical units */
+	for (uint8_t LUNIndex = 0; LUNIndex < TOTAL_LUNS; LUNIndex++)
+	{
+		Disk_LUNs[LUNIndex] = (MS_Device_LUN_t)
+			{
+				.BlockDevice = &DataflashManager_BlockDevice,
+				.BlockOffset = ((uint32_t)LUNIndex * LUN_MEDIA_BLOCKS),
+				.TotalBlocks = LUN_MEDIA_BLOCKS,
+				.BlockSize   = VIRTUAL_MEMORY_BLOCK_SIZE,
+				.ReadOnly    = DISK_READ_ONLY,
+				.InquiryData = &DataflashManager_InquiryData,
+			};
+	}
 }
 
 /** Event handler for the library USB Connection event. */
@@ -173,7 +191,7 @@ bool CALLBACK_MS_Device_SCSICommandReceived(USB_ClassInfo_MS_Device_t* const MSI
 	bool CommandSuccess;
 
 	LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
-	CommandSuccess = SCSI_DecodeSCSICommand(MSInterfaceInfo);
+	CommandSuccess = MS_Device_ProcessSCSICommand(MSInterfaceInfo);
 	LEDs_SetAllLEDs(LEDMASK_USB_READY);
 
 	return CommandSuccess;
@@ -68,6 +68,23 @@
 		/** Blocks in each LUN, calculated from the total capacity divided by the total number of Logical Units in the device. */
 		#define LUN_MEDIA_BLOCKS                    (VIRTUAL_MEMORY_BLOCKS / TOTAL_LUNS)
 
+	/* Private Interface - For use in library only: */
+		#if defined(INCLUDE_FROM_DATAFLASHMANAGER_C)
+			/* Macros: */
+				/** Bit in the Dataflash IC masks for the IC holding the given page, matching the interleaving of pages
+				 *  across ICs by \c Dataflash_SelectChipFromPage().
+				 */
+				#define DATAFLASHMANAGER_CHIP_BIT(PageAddress)  (1 << ((PageAddress) % DATAFLASH_TOTALCHIPS))
+
+			/* Function Prototypes: */
+				static void DataflashManager_BeginPageWrite(const uint16_t PageAddress,
+				                                            const uint16_t PageByte,
+				                                            const bool PreservePage);
+				static void DataflashManager_EndPageWrite(const uint16_t PageAddress);
+				static void DataflashManager_BeginPageRead(const uint16_t PageAddress,
+				                                           const uint16_t PageByte);
+		#endif
+
 	/* Function Prototypes: */
 		void DataflashManager_WriteBlocks(const uint32_t BlockAddress,
 		                                  uint16_t TotalBlocks);
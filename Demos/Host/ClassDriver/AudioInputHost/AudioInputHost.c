@@ -36,6 +36,12 @@
 
 #include "AudioInputHost.h"
 
+/** Ring buffer of sample frames received from the attached device by the Audio Class driver's streaming engine. */
+static uint8_t AudioStreamBuffer[AUDIO_STREAM_FRAMES * AUDIO_STREAM_FRAME_SIZE];
+
+/** Flag set each USB frame by the Start Of Frame event, to run the Audio Class driver's streaming engine from the main loop. */
+static volatile bool StartOfFrameReceived;
+
 /** LUFA Audio Class driver interface configuration and state information. This structure is
  *  passed to all Audio Class driver functions, so that multiple instances of the same class
  *  within a device can be differentiated from one another.
@@ -48,6 +54,10 @@ USB_ClassInfo_Audio_Host_t Microphone_Audio_Interface =
 					{
 						.Address        = (PIPE_DIR_IN  | 1),
 					},
+
+				.SampleFrameSize        = AUDIO_STREAM_FRAME_SIZE,
+				.INStreamBuffer         = AudioStreamBuffer,
+				.INStreamFrames         = AUDIO_STREAM_FRAMES,
 			},
 	};
 
@@ -66,6 +76,13 @@ int main(void)
 
 	for (;;)
 	{
+		/* Process the audio stream outside the USB interrupt, so that the sample timer interrupt is never held off */
+		if (StartOfFrameReceived)
+		{
+			StartOfFrameReceived = false;
+			Audio_Host_ProcessStartOfFrame(&Microphone_Audio_Interface);
+		}
+
 		Audio_Host_USBTask(&Microphone_Audio_Interface);
 		USB_USBTask();
 	}
@@ -74,13 +91,13 @@ int main(void)
 /** ISR to handle the reloading of the PWM timer with the next sample. */
 ISR(TIMER0_COMPA_vect, ISR_BLOCK)
 {
-	uint8_t PrevPipe = Pipe_GetCurrentPipe();
+	int16_t Sample;
 
-	/* Check that the USB bus is ready for the next sample to read */
-	if (Audio_Host_IsSampleReceived(&Microphone_Audio_Interface))
+	/* Check that the next sample has been received from the device by the streaming engine */
+	if (Audio_Host_ReadStreamFrames(&Microphone_Audio_Interface, &Sample, 1))
 	{
-		/* Retrieve the signed 16-bit audio sample, convert to 8-bit */
-		int8_t Sample_8Bit = (Audio_Host_ReadSample16(&Microphone_Audio_Interface) >> 8);
+		/* Convert the signed 16-bit audio sample to 8-bit */
+		int8_t Sample_8Bit = (Sample >> 8);
 
 		/* Load the sample into the PWM timer channel */
 		OCR3A = (Sample_8Bit ^ (1 << 7));
@@ -99,8 +116,6 @@ ISR(TIMER0_COMPA_vect, ISR_BLOCK)
 
 		LEDs_SetAllLEDs(LEDMask);
 	}
-
-	Pipe_SelectPipe(PrevPipe);
 }
 
 /** Configures the board hardware and chip peripherals for the demo's functionality. */
@@ -192,6 +207,9 @@ void EVENT_USB_Host_DeviceEnumerationComplete(void)
 		return;
 	}
 
+	/* Start the driver's streaming engine, which stores each received packet into the ring buffer */
+	USB_Host_EnableSOFEvents();
+
 	/* Sample reload timer initialization */
 	TIMSK0  = (1 << OCIE0A);
 	OCR0A   = ((F_CPU / 8 / 48000) - 1);
@@ -209,6 +227,12 @@ void EVENT_USB_Host_DeviceEnumerationComplete(void)
 	LEDs_SetAllLEDs(LEDMASK_USB_READY);
 }
 
+/** Event handler for the USB_StartOfFrame event, used to receive the next packet of the buffered audio stream. */
+void EVENT_USB_Host_StartOfFrame(void)
+{
+	StartOfFrameReceived = true;
+}
+
 /** Event handler for the USB_HostError event. This indicates that a hardware error occurred while in host mode. */
 void EVENT_USB_Host_HostError(const uint8_t ErrorCode)
 {
@@ -50,6 +50,12 @@
 		#include <LUFA/Drivers/USB/USB.h>
 
 	/* Macros: */
+		/** Size in sample frames of the buffered audio stream's ring buffer, a little over two USB frames at 48KHz. */
+		#define AUDIO_STREAM_FRAMES       112
+
+		/** Size in bytes of each sample frame of the audio stream, as 16-bit mono samples. */
+		#define AUDIO_STREAM_FRAME_SIZE   sizeof(int16_t)
+
 		/** LED mask for the library LED driver, to indicate that the USB interface is not ready. */
 		#define LEDMASK_USB_NOTREADY      LEDS_LED1
 
@@ -71,6 +77,7 @@
 		void EVENT_USB_Host_DeviceEnumerationFailed(const uint8_t ErrorCode,
 		                                            const uint8_t SubErrorCode);
 		void EVENT_USB_Host_DeviceEnumerationComplete(void);
+		void EVENT_USB_Host_StartOfFrame(void);
 
 #endif
 
@@ -36,6 +36,12 @@
 
 #include "AudioOutputHost.h"
 
+/** Ring buffer of sample frames waiting to be sent to the attached device by the Audio Class driver's streaming engine. */
+static uint8_t AudioStreamBuffer[AUDIO_STREAM_FRAMES * AUDIO_STREAM_FRAME_SIZE];
+
+/** Flag set each USB frame by the Start Of Frame event, to run the Audio Class driver's streaming engine from the main loop. */
+static volatile bool StartOfFrameReceived;
+
 /** LUFA Audio Class driver interface configuration and state information. This structure is
  *  passed to all Audio Class driver functions, so that multiple instances of the same class
  *  within a device can be differentiated from one another.
@@ -48,6 +54,14 @@ USB_ClassInfo_Audio_Host_t Speaker_Audio_Interface =
 					{
 						.Address        = (PIPE_DIR_OUT | 2),
 					},
+				.FeedbackPipe           =
+					{
+						.Address        = (PIPE_DIR_IN  | 3),
+					},
+
+				.SampleFrameSize        = AUDIO_STREAM_FRAME_SIZE,
+				.OUTStreamBuffer        = AudioStreamBuffer,
+				.OUTStreamFrames        = AUDIO_STREAM_FRAMES,
 			},
 	};
 
@@ -66,6 +80,13 @@ int main(void)
 
 	for (;;)
 	{
+		/* Process the audio stream outside the USB interrupt, so that the sample timer interrupt is never held off */
+		if (StartOfFrameReceived)
+		{
+			StartOfFrameReceived = false;
+			Audio_Host_ProcessStartOfFrame(&Speaker_Audio_Interface);
+		}
+
 		Audio_Host_USBTask(&Speaker_Audio_Interface);
 		USB_USBTask();
 	}
@@ -74,38 +95,31 @@ int main(void)
 /** ISR to handle the reloading of the PWM timer with the next sample. */
 ISR(TIMER0_COMPA_vect, ISR_BLOCK)
 {
-	uint8_t PrevPipe = Pipe_GetCurrentPipe();
+	int16_t AudioSample;
 
-	/* Check that the USB bus is ready for the next sample to write */
-	if (Audio_Host_IsReadyForNextSample(&Speaker_Audio_Interface))
-	{
-		int16_t AudioSample;
-
-		#if defined(USE_TEST_TONE)
-			static uint8_t SquareWaveSampleCount;
-			static int16_t CurrentWaveValue;
-
-			/* In test tone mode, generate a square wave at 1/256 of the sample rate */
-			if (SquareWaveSampleCount++ == 0xFF)
-			  CurrentWaveValue ^= 0x8000;
-
-			/* Only generate audio if the board button is being pressed */
-			AudioSample = (Buttons_GetStatus() & BUTTONS_BUTTON1) ? CurrentWaveValue : 0;
-		#else
-			/* Audio sample is ADC value scaled to fit the entire range */
-			AudioSample = ((SAMPLE_MAX_RANGE / ADC_MAX_RANGE) * ADC_GetResult());
-
-			#if defined(MICROPHONE_BIASED_TO_HALF_RAIL)
-			/* Microphone is biased to half rail voltage, subtract the bias from the sample value */
-			AudioSample -= (SAMPLE_MAX_RANGE / 2);
-			#endif
-		#endif
+	#if defined(USE_TEST_TONE)
+		static uint8_t SquareWaveSampleCount;
+		static int16_t CurrentWaveValue;
 
-		Audio_Host_WriteSample16(&Speaker_Audio_Interface, AudioSample);
-		Audio_Host_WriteSample16(&Speaker_Audio_Interface, AudioSample);
-	}
+		/* In test tone mode, generate a square wave at 1/256 of the sample rate */
+		if (SquareWaveSampleCount++ == 0xFF)
+		  CurrentWaveValue ^= 0x8000;
+
+		/* Only generate audio if the board button is being pressed */
+		AudioSample = (Buttons_GetStatus() & BUTTONS_BUTTON1) ? CurrentWaveValue : 0;
+	#else
+		/* Audio sample is ADC value scaled to fit the entire range */
+		AudioSample = ((SAMPLE_MAX_RANGE / ADC_MAX_RANGE) * ADC_GetResult());
+
+		#if defined(MICROPHONE_BIASED_TO_HALF_RAIL)
+		/* Microphone is biased to half rail voltage, subtract the bias from the sample value */
+		AudioSample -= (SAMPLE_MAX_RANGE / 2);
+		#endif
+	#endif
 
-	Pipe_SelectPipe(PrevPipe);
+	/* Queue the sample on both channels, to be sent to the device in the next USB frame */
+	int16_t SampleFrame[2] = {AudioSample, AudioSample};
+	Audio_Host_WriteStreamFrames(&Speaker_Audio_Interface, SampleFrame, 1);
 }
 
 /** Configures the board hardware and chip peripherals for the demo's functionality. */
@@ -203,6 +217,10 @@ void EVENT_USB_Host_DeviceEnumerationComplete(void)
 		return;
 	}
 
+	/* Start the driver's streaming engine, which sends one packet from the ring buffer in each USB frame */
+	Audio_Host_SetStreamSampleRate(&Speaker_Audio_Interface, 48000);
+	USB_Host_EnableSOFEvents();
+
 	/* Sample reload timer initialization */
 	TIMSK0  = (1 << OCIE0A);
 	OCR0A   = ((F_CPU / 8 / 48000) - 1);
@@ -213,6 +231,12 @@ void EVENT_USB_Host_DeviceEnumerationComplete(void)
 	LEDs_SetAllLEDs(LEDMASK_USB_READY);
 }
 
+/** Event handler for the USB_StartOfFrame event, used to send the next packet of the buffered audio stream. */
+void EVENT_USB_Host_StartOfFrame(void)
+{
+	StartOfFrameReceived = true;
+}
+
 /** Event handler for the USB_HostError event. This indicates that a hardware error occurred while in host mode. */
 void EVENT_USB_Host_HostError(const uint8_t ErrorCode)
 {
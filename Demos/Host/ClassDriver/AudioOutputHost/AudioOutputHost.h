@@ -54,6 +54,12 @@
 		#include "Config/AppConfig.h"
 
 	/* Macros: */
+		/** Size in sample frames of the buffered audio stream's ring buffer, a little over two USB frames at 48KHz. */
+		#define AUDIO_STREAM_FRAMES       112
+
+		/** Size in bytes of each sample frame of the audio stream, as 16-bit stereo samples. */
+		#define AUDIO_STREAM_FRAME_SIZE   (2 * sizeof(int16_t))
+
 		/** Maximum audio sample value for the microphone input. */
 		#define SAMPLE_MAX_RANGE          0xFFFF
 
@@ -81,6 +87,7 @@
 		void EVENT_USB_Host_DeviceEnumerationFailed(const uint8_t ErrorCode,
 		                                            const uint8_t SubErrorCode);
 		void EVENT_USB_Host_DeviceEnumerationComplete(void);
+		void EVENT_USB_Host_StartOfFrame(void);
 
 #endif
 
@@ -113,16 +113,18 @@ void KeyboardHost_Task(void)
 
 	if (HID_Host_IsReportReceived(&Keyboard_HID_Interface))
 	{
-		uint8_t KeyboardReport[Keyboard_HID_Interface.State.LargestReportSize];
+		/* Reports are preceded by their report ID byte when the device uses report IDs */
+		uint8_t KeyboardReport[Keyboard_HID_Interface.State.LargestReportSize + (HIDReportInfo.UsingReportIDs ? 1 : 0)];
 		HID_Host_ReceiveReport(&Keyboard_HID_Interface, &KeyboardReport);
 
-		for (uint8_t ReportNumber = 0; ReportNumber < HIDReportInfo.TotalReportItems; ReportNumber++)
-		{
-			HID_ReportItem_t* ReportItem = &HIDReportInfo.ReportItems[ReportNumber];
+		/* Update the values of all the report items contained within the current report in a single pass */
+		const HID_ReportPlanEntry_t* PlanEntries;
+		uint8_t TotalReportItems = USB_GetHIDReportItemValues(&HIDReportInfo, HID_REPORT_ITEM_In, KeyboardReport,
+		                                                      sizeof(KeyboardReport), &PlanEntries);
 
-			/* Update the report item value if it is contained within the current report */
-			if (!(USB_GetHIDReportItemInfo(KeyboardReport, ReportItem)))
-			  continue;
+		for (uint8_t ReportNumber = 0; ReportNumber < TotalReportItems; ReportNumber++)
+		{
+			HID_ReportItem_t* ReportItem = PlanEntries[ReportNumber].ReportItem;
 
 			/* Determine what report item is being tested, process updated value as needed */
 			if ((ReportItem->Attributes.Usage.Page      == USAGE_PAGE_KEYBOARD) &&
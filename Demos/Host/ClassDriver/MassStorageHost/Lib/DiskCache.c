@@ -0,0 +1,397 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Least recently used sector cache, sitting between the FatFs disk I/O layer and the attached USB Mass Storage
+ *  device. Single sector accesses (the FAT, directory and partial file sectors FatFs repeatedly revisits) are held
+ *  in the cache, while multiple sector transfers of file data are issued to the disk as a single SCSI command
+ *  directly to or from the FatFs buffer, so that they run at the bulk pipe rate and do not evict the file system
+ *  metadata.
+ *
+ *  When the DISK_CACHE_WRITE_BACK token is defined, single sector writes are only made to the cache and reach the
+ *  disk when evicted or when \ref DiskCache_Flush() is called, otherwise all writes go through to the disk immediately.
+ */
+
+#define  INCLUDE_FROM_DISKCACHE_C
+#include "DiskCache.h"
+
+/** Mass Storage class driver interface of the attached disk, or \c NULL if no disk is attached. */
+static USB_ClassInfo_MS_Host_t* DiskInterface;
+
+/** Logical unit of the attached disk within its Mass Storage interface. */
+static uint8_t  DiskLUNIndex;
+
+/** Sector data held in each cache entry. */
+static uint8_t  CacheData[DISK_CACHE_SECTORS][DISK_CACHE_SECTOR_SIZE];
+
+/** Disk sector address of each cache entry. */
+static uint32_t CacheSector[DISK_CACHE_SECTORS];
+
+/** Mask of DISK_CACHE_FLAG_* flags for each cache entry. */
+static uint8_t  CacheFlags[DISK_CACHE_SECTORS];
+
+/** Number of cache accesses since each entry was last used, saturating at 0xFF. */
+static uint8_t  CacheAge[DISK_CACHE_SECTORS];
+
+/** Running hit and miss statistics of the cache. */
+static DiskCache_Statistics_t CacheStatistics;
+
+
+/** Attaches the cache to a logical unit of an enumerated Mass Storage device, discarding any previously cached sectors.
+ *  The logical unit must be ready and have a block size of \ref DISK_CACHE_SECTOR_SIZE bytes.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class driver interface of the disk
+ *  \param[in] LUNIndex         Index of the logical unit within the device to use as the disk
+ */
+void DiskCache_AttachDisk(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                          const uint8_t LUNIndex)
+{
+	DiskCache_Invalidate();
+
+	DiskInterface = MSInterfaceInfo;
+	DiskLUNIndex  = LUNIndex;
+}
+
+/** Detaches the cache from the current disk, discarding any cached sectors. \ref DiskCache_Flush() should be called
+ *  first if the disk is still present and dirty sectors are to be kept.
+ */
+void DiskCache_DetachDisk(void)
+{
+	DiskCache_Invalidate();
+
+	DiskInterface = NULL;
+}
+
+/** Determines if a disk is currently attached to the cache and its Mass Storage device is still configured.
+ *
+ *  \return Boolean \c true if the attached disk is available, \c false otherwise
+ */
+bool DiskCache_IsDiskAttached(void)
+{
+	return ((DiskInterface != NULL) && (USB_HostState == HOST_STATE_Configured) && DiskInterface->State.IsActive);
+}
+
+/** Reads one or more sectors through the cache. A single sector read is served from the cache if present, or fetched
+ *  into a newly allocated cache entry if not. Multiple sector reads are fetched from the disk with a single command
+ *  without allocating new entries, with any dirty cached sectors then copied over the data read from the disk.
+ *
+ *  \param[in]  Sector        Address of the first sector to read
+ *  \param[in]  TotalSectors  Number of sectors to read
+ *  \param[out] BufferPtr     Pointer to the destination buffer for the sector data
+ *
+ *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum or \ref MS_ERROR_LOGICAL_CMD_FAILED on failure
+ */
+uint8_t DiskCache_ReadSectors(const uint32_t Sector,
+                              const uint8_t TotalSectors,
+                              uint8_t* BufferPtr)
+{
+	uint8_t ErrorCode;
+
+	if (TotalSectors == 1)
+	{
+		uint8_t Entry = DiskCache_FindSector(Sector);
+
+		if (Entry != DISK_CACHE_NO_ENTRY)
+		{
+			CacheStatistics.ReadHits++;
+		}
+		else
+		{
+			CacheStatistics.ReadMisses++;
+
+			Entry = DiskCache_AllocateEntry(Sector, &ErrorCode);
+
+			if (ErrorCode)
+			  return ErrorCode;
+
+			if ((ErrorCode = DiskCache_ReadDisk(Sector, 1, CacheData[Entry])) != PIPE_RWSTREAM_NoError)
+			{
+				CacheFlags[Entry] = 0;
+				return ErrorCode;
+			}
+		}
+
+		memcpy(BufferPtr, CacheData[Entry], DISK_CACHE_SECTOR_SIZE);
+		DiskCache_Touch(Entry);
+		return PIPE_RWSTREAM_NoError;
+	}
+
+	CacheStatistics.ReadMisses += TotalSectors;
+
+	if ((ErrorCode = DiskCache_ReadDisk(Sector, TotalSectors, BufferPtr)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	/* Sectors modified in the cache but not yet written back are newer than the copies just read from the disk */
+	for (uint8_t Entry = 0; Entry < DISK_CACHE_SECTORS; Entry++)
+	{
+		if (!(CacheFlags[Entry] & DISK_CACHE_FLAG_DIRTY))
+		  continue;
+
+		uint32_t SectorIndex = (CacheSector[Entry] - Sector);
+
+		if (SectorIndex < TotalSectors)
+		  memcpy(&BufferPtr[(uint16_t)SectorIndex * DISK_CACHE_SECTOR_SIZE], CacheData[Entry], DISK_CACHE_SECTOR_SIZE);
+	}
+
+	return PIPE_RWSTREAM_NoError;
+}
+
+/** Writes one or more sectors through the cache. When DISK_CACHE_WRITE_BACK is defined a single sector write is held in
+ *  the cache and marked as dirty, otherwise the sectors are written to the disk with a single command and any cached
+ *  copies are updated.
+ *
+ *  \param[in] Sector        Address of the first sector to write
+ *  \param[in] TotalSectors  Number of sectors to write
+ *  \param[in] BufferPtr     Pointer to the source buffer of sector data
+ *
+ *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum or \ref MS_ERROR_LOGICAL_CMD_FAILED on failure
+ */
+uint8_t DiskCache_WriteSectors(const uint32_t Sector,
+                               const uint8_t TotalSectors,
+                               const uint8_t* BufferPtr)
+{
+	uint8_t ErrorCode;
+
+	#if defined(DISK_CACHE_WRITE_BACK)
+	if (TotalSectors == 1)
+	{
+		uint8_t Entry = DiskCache_FindSector(Sector);
+
+		if (Entry != DISK_CACHE_NO_ENTRY)
+		{
+			CacheStatistics.WriteHits++;
+		}
+		else
+		{
+			CacheStatistics.WriteMisses++;
+
+			Entry = DiskCache_AllocateEntry(Sector, &ErrorCode);
+
+			if (ErrorCode)
+			  return ErrorCode;
+		}
+
+		memcpy(CacheData[Entry], BufferPtr, DISK_CACHE_SECTOR_SIZE);
+		CacheFlags[Entry] |= DISK_CACHE_FLAG_DIRTY;
+		DiskCache_Touch(Entry);
+		return PIPE_RWSTREAM_NoError;
+	}
+	#endif
+
+	if ((ErrorCode = DiskCache_WriteDisk(Sector, TotalSectors, BufferPtr)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	/* Bring any cached copies of the written sectors up to date, they now match the disk contents */
+	for (uint8_t SectorIndex = 0; SectorIndex < TotalSectors; SectorIndex++)
+	{
+		uint8_t Entry = DiskCache_FindSector(Sector + SectorIndex);
+
+		if (Entry == DISK_CACHE_NO_ENTRY)
+		{
+			CacheStatistics.WriteMisses++;
+			continue;
+		}
+
+		CacheStatistics.WriteHits++;
+
+		memcpy(CacheData[Entry], &BufferPtr[(uint16_t)SectorIndex * DISK_CACHE_SECTOR_SIZE], DISK_CACHE_SECTOR_SIZE);
+		CacheFlags[Entry] &= ~DISK_CACHE_FLAG_DIRTY;
+	}
+
+	return PIPE_RWSTREAM_NoError;
+}
+
+/** Writes all dirty cache entries back to the disk. This must be called before the disk is removed or its Mass Storage
+ *  device is released, so that the disk holds the latest file system state.
+ *
+ *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum or \ref MS_ERROR_LOGICAL_CMD_FAILED on failure
+ */
+uint8_t DiskCache_Flush(void)
+{
+	for (uint8_t Entry = 0; Entry < DISK_CACHE_SECTORS; Entry++)
+	{
+		if (!(CacheFlags[Entry] & DISK_CACHE_FLAG_DIRTY))
+		  continue;
+
+		uint8_t ErrorCode = DiskCache_WriteDisk(CacheSector[Entry], 1, CacheData[Entry]);
+
+		if (ErrorCode)
+		  return ErrorCode;
+
+		CacheFlags[Entry] &= ~DISK_CACHE_FLAG_DIRTY;
+
+		CacheStatistics.WriteBacks++;
+	}
+
+	return PIPE_RWSTREAM_NoError;
+}
+
+/** Discards all cache entries, so that subsequent reads are fetched from the disk. Any dirty entries are discarded
+ *  without being written back, thus \ref DiskCache_Flush() should be called first if they are to be kept.
+ */
+void DiskCache_Invalidate(void)
+{
+	for (uint8_t Entry = 0; Entry < DISK_CACHE_SECTORS; Entry++)
+	{
+		CacheFlags[Entry] = 0;
+		CacheAge[Entry]   = 0;
+	}
+}
+
+/** Retrieves the current cache statistics.
+ *
+ *  \param[out] Statistics  Pointer to a location where the current cache statistics are to be stored
+ */
+void DiskCache_GetStatistics(DiskCache_Statistics_t* const Statistics)
+{
+	*Statistics = CacheStatistics;
+}
+
+/** Resets the cache statistics counters to zero. */
+void DiskCache_ResetStatistics(void)
+{
+	memset(&CacheStatistics, 0x00, sizeof(CacheStatistics));
+}
+
+/** Searches the cache for the given sector.
+ *
+ *  \param[in] Sector  Address of the sector to look for
+ *
+ *  \return Index of the cache entry holding the sector, or \c DISK_CACHE_NO_ENTRY if the sector is not cached
+ */
+static uint8_t DiskCache_FindSector(const uint32_t Sector)
+{
+	for (uint8_t Entry = 0; Entry < DISK_CACHE_SECTORS; Entry++)
+	{
+		if ((CacheFlags[Entry] & DISK_CACHE_FLAG_VALID) && (CacheSector[Entry] == Sector))
+		  return Entry;
+	}
+
+	return DISK_CACHE_NO_ENTRY;
+}
+
+/** Marks the given cache entry as the most recently used, ageing all other entries.
+ *
+ *  \param[in] Entry  Index of the cache entry that has been accessed
+ */
+static void DiskCache_Touch(const uint8_t Entry)
+{
+	for (uint8_t CurrEntry = 0; CurrEntry < DISK_CACHE_SECTORS; CurrEntry++)
+	{
+		if (CacheAge[CurrEntry] != 0xFF)
+		  CacheAge[CurrEntry]++;
+	}
+
+	CacheAge[Entry] = 0;
+}
+
+/** Allocates a cache entry for the given sector, reusing a free entry if one exists or evicting the least recently used
+ *  entry otherwise. A dirty entry is written back to the disk before being reused. The contents of the returned entry
+ *  must be filled in by the caller.
+ *
+ *  \param[in]  Sector     Address of the sector the entry is to hold
+ *  \param[out] ErrorCode  Location where the result of writing back the evicted entry is to be stored
+ *
+ *  \return Index of the allocated cache entry
+ */
+static uint8_t DiskCache_AllocateEntry(const uint32_t Sector,
+                                       uint8_t* const ErrorCode)
+{
+	uint8_t Victim = 0;
+
+	for (uint8_t Entry = 0; Entry < DISK_CACHE_SECTORS; Entry++)
+	{
+		if (!(CacheFlags[Entry] & DISK_CACHE_FLAG_VALID))
+		{
+			Victim = Entry;
+			break;
+		}
+
+		if (CacheAge[Entry] > CacheAge[Victim])
+		  Victim = Entry;
+	}
+
+	*ErrorCode = PIPE_RWSTREAM_NoError;
+
+	if (CacheFlags[Victim] & DISK_CACHE_FLAG_DIRTY)
+	{
+		/* Keep the dirty entry if it could not be written back, so that its data is not lost */
+		if ((*ErrorCode = DiskCache_WriteDisk(CacheSector[Victim], 1, CacheData[Victim])) != PIPE_RWSTREAM_NoError)
+		  return Victim;
+
+		CacheStatistics.WriteBacks++;
+	}
+
+	CacheSector[Victim] = Sector;
+	CacheFlags[Victim]  = DISK_CACHE_FLAG_VALID;
+
+	return Victim;
+}
+
+/** Reads sectors from the attached disk with a single SCSI READ (10) command.
+ *
+ *  \param[in]  Sector        Address of the first sector to read
+ *  \param[in]  TotalSectors  Number of sectors to read
+ *  \param[out] BufferPtr     Pointer to the destination buffer for the sector data
+ *
+ *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum or \ref MS_ERROR_LOGICAL_CMD_FAILED on failure
+ */
+static uint8_t DiskCache_ReadDisk(const uint32_t Sector,
+                                  const uint8_t TotalSectors,
+                                  void* const BufferPtr)
+{
+	if (!(DiskCache_IsDiskAttached()))
+	  return PIPE_RWSTREAM_DeviceDisconnected;
+
+	CacheStatistics.Commands++;
+
+	return MS_Host_ReadDeviceBlocks(DiskInterface, DiskLUNIndex, Sector, TotalSectors, DISK_CACHE_SECTOR_SIZE, BufferPtr);
+}
+
+/** Writes sectors to the attached disk with a single SCSI WRITE (10) command.
+ *
+ *  \param[in] Sector        Address of the first sector to write
+ *  \param[in] TotalSectors  Number of sectors to write
+ *  \param[in] BufferPtr     Pointer to the source buffer of sector data
+ *
+ *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum or \ref MS_ERROR_LOGICAL_CMD_FAILED on failure
+ */
+static uint8_t DiskCache_WriteDisk(const uint32_t Sector,
+                                   const uint8_t TotalSectors,
+                                   const void* const BufferPtr)
+{
+	if (!(DiskCache_IsDiskAttached()))
+	  return PIPE_RWSTREAM_DeviceDisconnected;
+
+	CacheStatistics.Commands++;
+
+	return MS_Host_WriteDeviceBlocks(DiskInterface, DiskLUNIndex, Sector, TotalSectors, DISK_CACHE_SECTOR_SIZE, BufferPtr);
+}
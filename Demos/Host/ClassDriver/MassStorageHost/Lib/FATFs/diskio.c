@@ -0,0 +1,98 @@
+/*-----------------------------------------------------------------------*/
+/* Low level disk I/O module skeleton for FatFs     (C)ChaN, 2007        */
+/*-----------------------------------------------------------------------*/
+/* This is a stub disk I/O module that acts as front end of the existing */
+/* disk I/O modules and attach it to FatFs module with common interface. */
+/*-----------------------------------------------------------------------*/
+
+#include "diskio.h"
+
+/*-----------------------------------------------------------------------*/
+/* Initialize a Drive                                                    */
+
+DSTATUS disk_initialize (
+	BYTE drv				/* Physical drive number (0..) */
+)
+{
+	if (!(DiskCache_IsDiskAttached()))
+	  return STA_NOINIT;
+
+	/* Drop any sectors cached from before the (re)mount, the disk may have been changed since */
+	DiskCache_Invalidate();
+	return 0;
+}
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Return Disk Status                                                    */
+
+DSTATUS disk_status (
+	BYTE drv		/* Physical drive number (0..) */
+)
+{
+	return DiskCache_IsDiskAttached() ? 0 : STA_NOINIT;
+}
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Read Sector(s)                                                        */
+
+DRESULT disk_read (
+	BYTE drv,		/* Physical drive number (0..) */
+	BYTE *buff,		/* Data buffer to store read data */
+	DWORD sector,	/* Sector address (LBA) */
+	BYTE count		/* Number of sectors to read (1..128) */
+)
+{
+	if (!(DiskCache_IsDiskAttached()))
+	  return RES_NOTRDY;
+
+	return DiskCache_ReadSectors(sector, count, buff) ? RES_ERROR : RES_OK;
+}
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Write Sector(s)                                                       */
+
+#if _READONLY == 0
+DRESULT disk_write (
+	BYTE drv,			/* Physical drive number (0..) */
+	const BYTE *buff,	/* Data to be written */
+	DWORD sector,		/* Sector address (LBA) */
+	BYTE count			/* Number of sectors to write (1..128) */
+)
+{
+	if (!(DiskCache_IsDiskAttached()))
+	  return RES_NOTRDY;
+
+	return DiskCache_WriteSectors(sector, count, buff) ? RES_ERROR : RES_OK;
+}
+#endif /* _READONLY */
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Miscellaneous Functions                                               */
+
+DRESULT disk_ioctl (
+	BYTE drv,		/* Physical drive number (0..) */
+	BYTE ctrl,		/* Control code */
+	void *buff		/* Buffer to send/receive control data */
+)
+{
+	if (ctrl == CTRL_SYNC)
+	  return DiskCache_Flush() ? RES_ERROR : RES_OK;
+	else
+	  return RES_PARERR;
+}
+
+
+DWORD get_fattime (void)
+{
+	/* No real time clock is available, so stamp files with a fixed date of 2012-01-01 00:00:00 */
+	return ((DWORD)(2012 - 1980) << 25) | ((DWORD)1 << 21) | ((DWORD)1 << 16);
+}
+
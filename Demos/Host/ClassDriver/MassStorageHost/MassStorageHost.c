@@ -57,6 +57,9 @@ USB_ClassInfo_MS_Host_t FlashDisk_MS_Interface =
 			},
 	};
 
+/** FAT Fs structure to hold the internal state of the FAT driver for the attached disk's file system. */
+static FATFS DiskFATState;
+
 
 /** Main program entry point. This routine configures the hardware required by the application, then
  *  enters a loop to run the application tasks in sequence.
@@ -140,45 +143,60 @@ void MassStorageHost_Task(void)
 
 	printf_P(PSTR("%lu blocks of %lu bytes.\r\n"), DiskCapacity.Blocks, DiskCapacity.BlockSize);
 
-	uint8_t BlockBuffer[DiskCapacity.BlockSize];
-
-	if (MS_Host_ReadDeviceBlocks(&FlashDisk_MS_Interface, 0, 0x00000000, 1, DiskCapacity.BlockSize, BlockBuffer))
+	if (DiskCapacity.BlockSize != DISK_CACHE_SECTOR_SIZE)
 	{
-		puts_P(PSTR("Error reading device block.\r\n"));
+		puts_P(PSTR("Unsupported device block size.\r\n"));
 		LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
 		USB_Host_SetDeviceConfiguration(0);
 		return;
 	}
 
-	puts_P(PSTR("\r\nContents of first block:\r\n"));
+	/* Mount the file system on the disk through the sector cache */
+	DiskCache_AttachDisk(&FlashDisk_MS_Interface, 0);
+	DiskCache_ResetStatistics();
+	f_mount(0, &DiskFATState);
 
-	for (uint16_t Chunk = 0; Chunk < (DiskCapacity.BlockSize >> 4); Chunk++)
-	{
-		uint8_t* ChunkPtr = &BlockBuffer[Chunk << 4];
+	MassStorageHost_ListRootDirectory();
 
-		/* Print out the 16 bytes of the chunk in HEX format */
-		for (uint8_t ByteOffset = 0; ByteOffset < (1 << 4); ByteOffset++)
-		{
-			char CurrByte = *(ChunkPtr + ByteOffset);
-			printf_P(PSTR("%.2X "), CurrByte);
-		}
+	/* Write back any cached sectors and release the disk */
+	f_mount(0, NULL);
+	DiskCache_Flush();
 
-		printf_P(PSTR("    "));
+	DiskCache_Statistics_t CacheStatistics;
+	DiskCache_GetStatistics(&CacheStatistics);
 
-		/* Print out the 16 bytes of the chunk in ASCII format */
-		for (uint8_t ByteOffset = 0; ByteOffset < (1 << 4); ByteOffset++)
-		{
-			char CurrByte = *(ChunkPtr + ByteOffset);
-			putchar(isprint(CurrByte) ? CurrByte : '.');
-		}
+	printf_P(PSTR("\r\nSector cache: %lu read hits, %lu read misses, %lu SCSI commands.\r\n"),
+	         CacheStatistics.ReadHits, CacheStatistics.ReadMisses, CacheStatistics.Commands);
 
-		printf_P(PSTR("\r\n"));
-	}
+	DiskCache_DetachDisk();
 
 	LEDs_SetAllLEDs(LEDMASK_USB_READY);
 	USB_Host_SetDeviceConfiguration(0);
 }
 
+/** Lists the names and sizes of the entries in the root directory of the mounted disk's file system. */
+void MassStorageHost_ListRootDirectory(void)
+{
+	DIR     RootDirectory;
+	FILINFO FileInfo;
+
+	if (f_opendir(&RootDirectory, "/") != FR_OK)
+	{
+		puts_P(PSTR("Error opening the disk's root directory - no valid FAT file system?\r\n"));
+		return;
+	}
+
+	puts_P(PSTR("\r\nContents of root directory:\r\n"));
+
+	while ((f_readdir(&RootDirectory, &FileInfo) == FR_OK) && FileInfo.fname[0])
+	{
+		if (FileInfo.fattrib & AM_DIR)
+		  printf_P(PSTR("  %-12s      <DIR>\r\n"), FileInfo.fname);
+		else
+		  printf_P(PSTR("  %-12s %10lu\r\n"), FileInfo.fname, FileInfo.fsize);
+	}
+}
+
 /** Event handler for the USB_DeviceAttached event. This indicates that a device has been attached to the host, and
  *  starts the library USB task to begin the enumeration and USB management process.
  */
@@ -194,6 +212,7 @@ void EVENT_USB_Host_DeviceAttached(void)
 void EVENT_USB_Host_DeviceUnattached(void)
 {
 	puts_P(PSTR("\r\nDevice Unattached.\r\n"));
+	DiskCache_DetachDisk();
 	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
 }
 
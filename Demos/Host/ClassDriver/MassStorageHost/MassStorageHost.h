@@ -50,6 +50,9 @@
 		#include <LUFA/Drivers/Board/LEDs.h>
 		#include <LUFA/Drivers/USB/USB.h>
 
+		#include "Lib/DiskCache.h"
+		#include "Lib/FATFs/ff.h"
+
 	/* Macros: */
 		/** LED mask for the library LED driver, to indicate that the USB interface is not ready. */
 		#define LEDMASK_USB_NOTREADY      LEDS_LED1
@@ -69,6 +72,7 @@
 	/* Function Prototypes: */
 		void SetupHardware(void);
 		void MassStorageHost_Task(void);
+		void MassStorageHost_ListRootDirectory(void);
 
 		void EVENT_USB_Host_HostError(const uint8_t ErrorCode);
 		void EVENT_USB_Host_DeviceAttached(void);
@@ -76,12 +76,17 @@ LUFA_SRC_USB         := $(LUFA_ROOT_PATH)/Drivers/USB/Core/$(ARCH)/Device_$(ARCH
                         $(LUFA_ROOT_PATH)/Drivers/USB/Core/$(ARCH)/EndpointStream_$(ARCH).c  \
                         $(LUFA_ROOT_PATH)/Drivers/USB/Core/$(ARCH)/PipeStream_$(ARCH).c      \
                         $(LUFA_ROOT_PATH)/Drivers/USB/Core/ConfigDescriptors.c               \
+                        $(LUFA_ROOT_PATH)/Drivers/USB/Core/DeviceControlTransfer.c           \
                         $(LUFA_ROOT_PATH)/Drivers/USB/Core/DeviceStandardReq.c               \
                         $(LUFA_ROOT_PATH)/Drivers/USB/Core/Events.c                          \
+                        $(LUFA_ROOT_PATH)/Drivers/USB/Core/HostControlTransfer.c             \
                         $(LUFA_ROOT_PATH)/Drivers/USB/Core/HostStandardReq.c                 \
+                        $(LUFA_ROOT_PATH)/Drivers/USB/Core/TransferRequest.c                 \
                         $(LUFA_ROOT_PATH)/Drivers/USB/Core/USBTask.c                         \
+                        $(LUFA_ROOT_PATH)/Drivers/USB/Core/USBTrace.c                        \
                         $(LUFA_ROOT_PATH)/Drivers/USB/Class/Common/HIDParser.c
-LUFA_SRC_USBCLASS    := $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/AudioClassDevice.c        \
+LUFA_SRC_USBCLASS    := $(LUFA_ROOT_PATH)/Drivers/USB/Class/Common/MIDIConverter.c           \
+                        $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/AudioClassDevice.c        \
                         $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/CDCClassDevice.c          \
                         $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/HIDClassDevice.c          \
                         $(LUFA_ROOT_PATH)/Drivers/USB/Class/Device/MassStorageClassDevice.c  \
@@ -103,10 +108,16 @@ LUFA_SRC_TWI         := $(LUFA_ROOT_PATH)/Drivers/Peripheral/$(ARCH)/TWI_$(ARCH)
 ifeq ($(ARCH), UC3)
    LUFA_SRC_PLATFORM := $(LUFA_ROOT_PATH)/Platform/UC3/Exception.S   \
                         $(LUFA_ROOT_PATH)/Platform/UC3/InterruptManagement.c
+else ifeq ($(ARCH), HOSTSIM)
+   LUFA_SRC_PLATFORM := $(LUFA_ROOT_PATH)/Platform/HOSTSIM/InterruptManagement.c
 else
    LUFA_SRC_PLATFORM :=
 endif
 
+ifeq ($(ARCH), HOSTSIM)
+   LUFA_SRC_USB      += $(LUFA_ROOT_PATH)/Drivers/USB/Core/HOSTSIM/VirtualHost_HOSTSIM.c
+endif
+
 # Build a list of all available module sources
 LUFA_SRC_ALL_FILES   := $(LUFA_SRC_USB)            \
                         $(LUFA_SRC_USBCLASS)       \
@@ -70,6 +70,12 @@
 			/** Selects the Atmel XMEGA AVR (ATXMEGA*U chips) architecture. */
 			#define ARCH_XMEGA          2
 
+			/** Selects the simulated host-native USB controller (HOSTSIM) architecture. This architecture compiles the
+			 *  library with the host system's native compiler against an in-memory model of the USB controller, so that
+			 *  the core stack and the device class drivers can be run, profiled and benchmarked without target hardware.
+			 */
+			#define ARCH_HOSTSIM        3
+
 			#if !defined(__DOXYGEN__)
 				#define ARCH_           ARCH_AVR8
 
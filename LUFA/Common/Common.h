@@ -139,6 +139,33 @@
 			#define ARCH_LITTLE_ENDIAN
 
 			#include "Endianness.h"
+		#elif (ARCH == ARCH_HOSTSIM)
+			#include <math.h>
+
+			#define PROGMEM
+			#define PSTR(s)                  (s)
+			#define pgm_read_byte(x)         (*(const uint8_t*)(x))
+			#define pgm_read_word(x)         (*(const uint16_t*)(x))
+			#define pgm_read_dword(x)        (*(const uint32_t*)(x))
+			#define pgm_read_ptr(x)          (*(void* const*)(x))
+			#define memcmp_P(...)            memcmp(__VA_ARGS__)
+			#define memcpy_P(...)            memcpy(__VA_ARGS__)
+			#define strlen_P(...)            strlen(__VA_ARGS__)
+
+			typedef uint8_t uint_reg_t;
+
+			#if (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+				#define ARCH_BIG_ENDIAN
+			#else
+				#define ARCH_LITTLE_ENDIAN
+			#endif
+
+			#include "Endianness.h"
+
+			/* Simulated global interrupt enable flag, defined in the HOSTSIM platform driver */
+			extern volatile uint_reg_t HOSTSIM_GlobalInterruptState;
+
+			#define ISR(Name, ...)           void Name (void) __VA_ARGS__; void Name (void)
 		#else
 			#error Unknown device architecture specified.
 		#endif
@@ -278,6 +305,8 @@
 					while (Milliseconds--)
 					  _delay_ms(1);
 				}
+				#elif (ARCH == ARCH_HOSTSIM)
+				(void)Milliseconds;
 				#endif
 			}
 
@@ -300,6 +329,8 @@
 				return __builtin_mfsr(AVR32_SR);
 				#elif (ARCH == ARCH_XMEGA)
 				return SREG;
+				#elif (ARCH == ARCH_HOSTSIM)
+				return HOSTSIM_GlobalInterruptState;
 				#endif
 			}
 
@@ -325,6 +356,8 @@
 				  __builtin_csrf(AVR32_SR_GM_OFFSET);
 				#elif (ARCH == ARCH_XMEGA)
 				SREG = GlobalIntState;
+				#elif (ARCH == ARCH_HOSTSIM)
+				HOSTSIM_GlobalInterruptState = GlobalIntState;
 				#endif
 
 				GCC_MEMORY_BARRIER();
@@ -345,6 +378,8 @@
 				__builtin_csrf(AVR32_SR_GM_OFFSET);
 				#elif (ARCH == ARCH_XMEGA)
 				sei();
+				#elif (ARCH == ARCH_HOSTSIM)
+				HOSTSIM_GlobalInterruptState = 1;
 				#endif
 
 				GCC_MEMORY_BARRIER();
@@ -365,6 +400,8 @@
 				__builtin_ssrf(AVR32_SR_GM_OFFSET);
 				#elif (ARCH == ARCH_XMEGA)
 				cli();
+				#elif (ARCH == ARCH_HOSTSIM)
+				HOSTSIM_GlobalInterruptState = 0;
 				#endif
 
 				GCC_MEMORY_BARRIER();
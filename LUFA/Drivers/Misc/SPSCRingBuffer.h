@@ -0,0 +1,431 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Lock-free single producer, single consumer ring (circular) buffer of bytes.
+ *
+ *  Lock-free ring buffer for a single inserting and a single removing execution thread, with block and
+ *  in-place transfers.
+ */
+
+/** \ingroup Group_MiscDrivers
+ *  \defgroup Group_SPSCRingBuff Lock-Free Byte Ring Buffer - LUFA/Drivers/Misc/SPSCRingBuffer.h
+ *  \brief Lock-free single producer, single consumer ring buffer, with block and in-place transfers.
+ *
+ *  \section Sec_Dependencies Module Source Dependencies
+ *  The following files must be built with any user project that uses this module:
+ *    - None
+ *
+ *  \section Sec_ModDescription Module Description
+ *  Lock-free variant of the \ref Group_RingBuff driver, for buffers shared between exactly one inserting
+ *  and one removing execution thread, such as a USART ISR and the main program loop. Rather than a shared
+ *  byte count guarded by atomic blocks, each side of the buffer owns its own free running index which only
+ *  it writes to, so that no buffer operation ever has to disable interrupts.
+ *
+ *  Buffer sizes must be a power of two, so that the indexes can be wrapped by masking. Each index is the
+ *  width of a machine register so that it can be read by the other thread in a single access, thus the
+ *  largest buffer size is half the range of the \c uint_reg_t type - 128 bytes on 8-bit architectures.
+ *
+ *  As well as single byte operations, whole blocks may be inserted or removed at a time, and the buffer's
+ *  storage may be read or written in place through the contiguous spans returned by
+ *  \ref SPSCRingBuffer_GetReadSpan() and \ref SPSCRingBuffer_GetWriteSpan(), so that data can be moved
+ *  directly between the buffer and an endpoint bank or peripheral.
+ *
+ *  \section Sec_ExampleUsage Example Usage
+ *  The following snippet is an example of how this module may be used within a typical
+ *  application.
+ *
+ *  \code
+ *      // Create the buffer structure and its underlying storage array
+ *      SPSCRingBuffer_t Buffer;
+ *      uint8_t          BufferData[64];
+ *      
+ *      // Initialize the buffer with the created storage array
+ *      SPSCRingBuffer_InitBuffer(&Buffer, BufferData, sizeof(BufferData));
+ *      
+ *      // Insert some data into the buffer
+ *      SPSCRingBuffer_Insert(&Buffer, 'H');
+ *      SPSCRingBuffer_InsertBlock(&Buffer, "ELLO", 4);
+ *      
+ *      // Write the buffered data out in place, one contiguous span at a time
+ *      uint16_t SpanLength;
+ *      uint8_t* SpanData;
+ *      
+ *      while ((SpanData = SPSCRingBuffer_GetReadSpan(&Buffer, &SpanLength)) != NULL)
+ *      {
+ *          fwrite(SpanData, 1, SpanLength, stdout);
+ *          SPSCRingBuffer_CommitRead(&Buffer, SpanLength);
+ *      }
+ *  \endcode
+ *
+ *  @{
+ */
+
+#ifndef __SPSC_RING_BUFFER_H__
+#define __SPSC_RING_BUFFER_H__
+
+	/* Includes: */
+		#include "../../Common/Common.h"
+
+		#include <string.h>
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#if (ARCH == ARCH_HOSTSIM)
+				#define SPSC_RING_BUFFER_FENCE()     __atomic_thread_fence(__ATOMIC_ACQ_REL)
+			#else
+				#define SPSC_RING_BUFFER_FENCE()     GCC_MEMORY_BARRIER()
+			#endif
+	#endif
+
+	/* Type Defines: */
+		/** \brief Lock-Free Ring Buffer Management Structure.
+		 *
+		 *  Type define for a new lock-free ring buffer object. Buffers should be initialized via a call to
+		 *  \ref SPSCRingBuffer_InitBuffer() before use.
+		 */
+		typedef struct
+		{
+			uint8_t*            Data; /**< Pointer to the start of the buffer's underlying storage array. */
+			uint_reg_t          Mask; /**< Size of the buffer's underlying storage array, less one. */
+			volatile uint_reg_t In; /**< Total number of bytes inserted into the buffer, modulo the index range. */
+			volatile uint_reg_t Out; /**< Total number of bytes removed from the buffer, modulo the index range. */
+		} SPSCRingBuffer_t;
+
+	/* Inline Functions: */
+		/** Initializes a lock-free ring buffer ready for use. Buffers must be initialized via this function
+		 *  before any operations are called upon them, and must not be in use by either thread while they
+		 *  are re-initialized.
+		 *
+		 *  \param[out] Buffer   Pointer to a ring buffer structure to initialize.
+		 *  \param[out] DataPtr  Pointer to a global array that will hold the data stored into the ring buffer.
+		 *  \param[in]  Size     Size of the underlying data array, which must be a power of two no larger than half
+		 *                       the range of \c uint_reg_t.
+		 */
+		static inline void SPSCRingBuffer_InitBuffer(SPSCRingBuffer_t* const Buffer,
+		                                             uint8_t* const DataPtr,
+		                                             const uint16_t Size) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline void SPSCRingBuffer_InitBuffer(SPSCRingBuffer_t* const Buffer,
+		                                             uint8_t* const DataPtr,
+		                                             const uint16_t Size)
+		{
+			Buffer->Data = DataPtr;
+			Buffer->Mask = (Size - 1);
+			Buffer->In   = 0;
+			Buffer->Out  = 0;
+		}
+
+		/** Retrieves the current number of bytes stored in a particular buffer. When called from the removing
+		 *  thread the value is the minimum number of bytes which may be removed, as the inserting thread may
+		 *  add more at any time.
+		 *
+		 *  \param[in] Buffer  Pointer to a ring buffer structure whose count is to be computed.
+		 *
+		 *  \return Number of bytes currently stored in the buffer.
+		 */
+		static inline uint16_t SPSCRingBuffer_GetCount(const SPSCRingBuffer_t* const Buffer) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+		static inline uint16_t SPSCRingBuffer_GetCount(const SPSCRingBuffer_t* const Buffer)
+		{
+			return (uint_reg_t)(Buffer->In - Buffer->Out);
+		}
+
+		/** Retrieves the free space in a particular buffer. When called from the inserting thread the value is
+		 *  the minimum number of bytes which may be inserted, as the removing thread may free more at any time.
+		 *
+		 *  \param[in] Buffer  Pointer to a ring buffer structure whose free count is to be computed.
+		 *
+		 *  \return Number of free bytes in the buffer.
+		 */
+		static inline uint16_t SPSCRingBuffer_GetFreeCount(const SPSCRingBuffer_t* const Buffer) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+		static inline uint16_t SPSCRingBuffer_GetFreeCount(const SPSCRingBuffer_t* const Buffer)
+		{
+			return ((uint16_t)Buffer->Mask + 1) - SPSCRingBuffer_GetCount(Buffer);
+		}
+
+		/** Determines if the specified ring buffer contains any data. This should be tested before removing
+		 *  data from the buffer, to ensure that the buffer does not underflow.
+		 *
+		 *  \param[in] Buffer  Pointer to a ring buffer structure to test.
+		 *
+		 *  \return Boolean \c true if the buffer contains no data, \c false otherwise.
+		 */
+		static inline bool SPSCRingBuffer_IsEmpty(const SPSCRingBuffer_t* const Buffer) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+		static inline bool SPSCRingBuffer_IsEmpty(const SPSCRingBuffer_t* const Buffer)
+		{
+			return (Buffer->In == Buffer->Out);
+		}
+
+		/** Determines if the specified ring buffer contains any free space. This should be tested before
+		 *  storing data to the buffer, to ensure that no data is lost due to a buffer overrun.
+		 *
+		 *  \param[in] Buffer  Pointer to a ring buffer structure to test.
+		 *
+		 *  \return Boolean \c true if the buffer contains no free space, \c false otherwise.
+		 */
+		static inline bool SPSCRingBuffer_IsFull(const SPSCRingBuffer_t* const Buffer) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+		static inline bool SPSCRingBuffer_IsFull(const SPSCRingBuffer_t* const Buffer)
+		{
+			return (SPSCRingBuffer_GetCount(Buffer) > Buffer->Mask);
+		}
+
+		/** Inserts an element into the ring buffer, which must not be full.
+		 *
+		 *  \warning Only the inserting execution thread may call this function.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to insert into.
+		 *  \param[in]     Data    Data element to insert into the buffer.
+		 */
+		static inline void SPSCRingBuffer_Insert(SPSCRingBuffer_t* const Buffer, const uint8_t Data) ATTR_NON_NULL_PTR_ARG(1);
+		static inline void SPSCRingBuffer_Insert(SPSCRingBuffer_t* const Buffer, const uint8_t Data)
+		{
+			uint_reg_t In = Buffer->In;
+
+			SPSC_RING_BUFFER_FENCE();
+			Buffer->Data[In & Buffer->Mask] = Data;
+
+			SPSC_RING_BUFFER_FENCE();
+			Buffer->In = (In + 1);
+		}
+
+		/** Removes an element from the ring buffer, which must not be empty.
+		 *
+		 *  \warning Only the removing execution thread may call this function.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to retrieve from.
+		 *
+		 *  \return Next data element stored in the buffer.
+		 */
+		static inline uint8_t SPSCRingBuffer_Remove(SPSCRingBuffer_t* const Buffer) ATTR_NON_NULL_PTR_ARG(1);
+		static inline uint8_t SPSCRingBuffer_Remove(SPSCRingBuffer_t* const Buffer)
+		{
+			uint_reg_t Out = Buffer->Out;
+
+			SPSC_RING_BUFFER_FENCE();
+			uint8_t Data = Buffer->Data[Out & Buffer->Mask];
+
+			SPSC_RING_BUFFER_FENCE();
+			Buffer->Out = (Out + 1);
+
+			return Data;
+		}
+
+		/** Returns the next element stored in the ring buffer, which must not be empty, without removing it.
+		 *
+		 *  \param[in] Buffer  Pointer to a ring buffer structure to retrieve from.
+		 *
+		 *  \return Next data element stored in the buffer.
+		 */
+		static inline uint8_t SPSCRingBuffer_Peek(const SPSCRingBuffer_t* const Buffer) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+		static inline uint8_t SPSCRingBuffer_Peek(const SPSCRingBuffer_t* const Buffer)
+		{
+			SPSC_RING_BUFFER_FENCE();
+			return Buffer->Data[Buffer->Out & Buffer->Mask];
+		}
+
+		/** Retrieves the largest contiguous run of free space in the buffer's storage array, starting at the
+		 *  next insertion location. Data may be written directly into the returned span, and then made visible
+		 *  to the removing thread via a call to \ref SPSCRingBuffer_CommitWrite().
+		 *
+		 *  \warning Only the inserting execution thread may call this function.
+		 *
+		 *  \param[in]  Buffer  Pointer to a ring buffer structure to insert into.
+		 *  \param[out] Length  Number of bytes which may be written into the returned span.
+		 *
+		 *  \return Pointer to the start of the free span, or \c NULL if the buffer is full.
+		 */
+		static inline uint8_t* SPSCRingBuffer_GetWriteSpan(SPSCRingBuffer_t* const Buffer,
+		                                                   uint16_t* const Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline uint8_t* SPSCRingBuffer_GetWriteSpan(SPSCRingBuffer_t* const Buffer,
+		                                                   uint16_t* const Length)
+		{
+			uint16_t Offset  = (Buffer->In & Buffer->Mask);
+			uint16_t ToWrap  = (((uint16_t)Buffer->Mask + 1) - Offset);
+			uint16_t Free    = SPSCRingBuffer_GetFreeCount(Buffer);
+
+			SPSC_RING_BUFFER_FENCE();
+
+			*Length = MIN(Free, ToWrap);
+			return (*Length ? &Buffer->Data[Offset] : NULL);
+		}
+
+		/** Marks bytes written into the span returned by \ref SPSCRingBuffer_GetWriteSpan() as inserted into the
+		 *  buffer.
+		 *
+		 *  \warning Only the inserting execution thread may call this function.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to insert into.
+		 *  \param[in]     Bytes   Number of bytes written, no larger than the length of the last retrieved span.
+		 */
+		static inline void SPSCRingBuffer_CommitWrite(SPSCRingBuffer_t* const Buffer,
+		                                              const uint16_t Bytes) ATTR_NON_NULL_PTR_ARG(1);
+		static inline void SPSCRingBuffer_CommitWrite(SPSCRingBuffer_t* const Buffer,
+		                                              const uint16_t Bytes)
+		{
+			SPSC_RING_BUFFER_FENCE();
+			Buffer->In = (Buffer->In + Bytes);
+		}
+
+		/** Retrieves the largest contiguous run of stored data in the buffer's storage array, starting at the
+		 *  next removal location. Data may be read directly from the returned span, and then released back to
+		 *  the inserting thread via a call to \ref SPSCRingBuffer_CommitRead().
+		 *
+		 *  \warning Only the removing execution thread may call this function.
+		 *
+		 *  \param[in]  Buffer  Pointer to a ring buffer structure to retrieve from.
+		 *  \param[out] Length  Number of bytes which may be read from the returned span.
+		 *
+		 *  \return Pointer to the start of the stored data span, or \c NULL if the buffer is empty.
+		 */
+		static inline uint8_t* SPSCRingBuffer_GetReadSpan(SPSCRingBuffer_t* const Buffer,
+		                                                  uint16_t* const Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline uint8_t* SPSCRingBuffer_GetReadSpan(SPSCRingBuffer_t* const Buffer,
+		                                                  uint16_t* const Length)
+		{
+			uint16_t Offset  = (Buffer->Out & Buffer->Mask);
+			uint16_t ToWrap  = (((uint16_t)Buffer->Mask + 1) - Offset);
+			uint16_t Count   = SPSCRingBuffer_GetCount(Buffer);
+
+			SPSC_RING_BUFFER_FENCE();
+
+			*Length = MIN(Count, ToWrap);
+			return (*Length ? &Buffer->Data[Offset] : NULL);
+		}
+
+		/** Removes bytes read from the span returned by \ref SPSCRingBuffer_GetReadSpan() from the buffer.
+		 *
+		 *  \warning Only the removing execution thread may call this function.
+		 *
+		 *  \param[in,out] Buffer  Pointer to a ring buffer structure to retrieve from.
+		 *  \param[in]     Bytes   Number of bytes read, no larger than the length of the last retrieved span.
+		 */
+		static inline void SPSCRingBuffer_CommitRead(SPSCRingBuffer_t* const Buffer,
+		                                             const uint16_t Bytes) ATTR_NON_NULL_PTR_ARG(1);
+		static inline void SPSCRingBuffer_CommitRead(SPSCRingBuffer_t* const Buffer,
+		                                             const uint16_t Bytes)
+		{
+			SPSC_RING_BUFFER_FENCE();
+			Buffer->Out = (Buffer->Out + Bytes);
+		}
+
+		/** Inserts as much of a block of data into the ring buffer as will fit, copying it in at most two
+		 *  contiguous runs.
+		 *
+		 *  \warning Only the inserting execution thread may call this function.
+		 *
+		 *  \param[in,out] Buffer   Pointer to a ring buffer structure to insert into.
+		 *  \param[in]     DataPtr  Pointer to the block of data to insert.
+		 *  \param[in]     Length   Number of bytes in the block of data.
+		 *
+		 *  \return Number of bytes inserted into the buffer.
+		 */
+		static inline uint16_t SPSCRingBuffer_InsertBlock(SPSCRingBuffer_t* const Buffer,
+		                                                  const void* DataPtr,
+		                                                  uint16_t Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline uint16_t SPSCRingBuffer_InsertBlock(SPSCRingBuffer_t* const Buffer,
+		                                                  const void* DataPtr,
+		                                                  uint16_t Length)
+		{
+			const uint8_t* DataIn   = (const uint8_t*)DataPtr;
+			uint16_t       Inserted = 0;
+
+			while (Length)
+			{
+				uint16_t SpanLength;
+				uint8_t* Span = SPSCRingBuffer_GetWriteSpan(Buffer, &SpanLength);
+
+				if (!(Span))
+				  break;
+
+				SpanLength = MIN(SpanLength, Length);
+				memcpy(Span, &DataIn[Inserted], SpanLength);
+				SPSCRingBuffer_CommitWrite(Buffer, SpanLength);
+
+				Inserted += SpanLength;
+				Length   -= SpanLength;
+			}
+
+			return Inserted;
+		}
+
+		/** Removes up to the given number of bytes from the ring buffer into a block of memory, copying them out
+		 *  in at most two contiguous runs.
+		 *
+		 *  \warning Only the removing execution thread may call this function.
+		 *
+		 *  \param[in,out] Buffer   Pointer to a ring buffer structure to retrieve from.
+		 *  \param[out]    DataPtr  Pointer to the destination block of memory.
+		 *  \param[in]     Length   Maximum number of bytes to remove.
+		 *
+		 *  \return Number of bytes removed from the buffer.
+		 */
+		static inline uint16_t SPSCRingBuffer_RemoveBlock(SPSCRingBuffer_t* const Buffer,
+		                                                  void* DataPtr,
+		                                                  uint16_t Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+		static inline uint16_t SPSCRingBuffer_RemoveBlock(SPSCRingBuffer_t* const Buffer,
+		                                                  void* DataPtr,
+		                                                  uint16_t Length)
+		{
+			uint8_t* DataOut = (uint8_t*)DataPtr;
+			uint16_t Removed = 0;
+
+			while (Length)
+			{
+				uint16_t SpanLength;
+				uint8_t* Span = SPSCRingBuffer_GetReadSpan(Buffer, &SpanLength);
+
+				if (!(Span))
+				  break;
+
+				SpanLength = MIN(SpanLength, Length);
+				memcpy(&DataOut[Removed], Span, SpanLength);
+				SPSCRingBuffer_CommitRead(Buffer, SpanLength);
+
+				Removed += SpanLength;
+				Length  -= SpanLength;
+			}
+
+			return Removed;
+		}
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
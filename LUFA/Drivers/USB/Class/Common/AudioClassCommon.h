@@ -199,6 +199,13 @@
 		 */
 		#define AUDIO_SAMPLE_FREQ(freq)           {.Byte1 = ((uint32_t)freq & 0xFF), .Byte2 = (((uint32_t)freq >> 8) & 0xFF), .Byte3 = (((uint32_t)freq >> 16) & 0xFF)}
 
+		/** Converts a sampling frequency in Hz to the 10.14 fixed point samples per frame format used by full speed
+		 *  isochronous feedback endpoints.
+		 *
+		 *  \param[in] Freq  Sampling frequency in Hz to convert.
+		 */
+		#define AUDIO_FEEDBACK_VALUE(Freq)        ((((uint32_t)(Freq)) << 14) / 1000)
+
 		/** Mask for the attributes parameter of an Audio class-specific Endpoint descriptor, indicating that the endpoint
 		 *  accepts only filled endpoint packets of audio samples.
 		 */
@@ -675,7 +682,7 @@
 		{
 			USB_Descriptor_Endpoint_t Endpoint; /**< Standard endpoint descriptor describing the audio endpoint. */
 
-			uint8_t                   Refresh; /**< Always set to zero for Audio class devices. */
+			uint8_t                   Refresh; /**< Exponent of the feedback period in frames for synchronization endpoints, zero otherwise. */
 			uint8_t                   SyncEndpointNumber; /**< Endpoint address to send synchronization information to, if needed (zero otherwise). */
 		} ATTR_PACKED USB_Audio_Descriptor_StreamEndpoint_Std_t;
 
@@ -708,7 +715,7 @@
 			                     *   ISOCHRONOUS type.
 			                     */
 
-			uint8_t  bRefresh; /**< Always set to zero for Audio class devices. */
+			uint8_t  bRefresh; /**< Exponent of the feedback period in frames for synchronization endpoints, zero otherwise. */
 			uint8_t  bSynchAddress; /**< Endpoint address to send synchronization information to, if needed (zero otherwise). */
 		} ATTR_PACKED USB_Audio_StdDescriptor_StreamEndpoint_Std_t;
 
@@ -30,25 +30,93 @@
 
 #define  __INCLUDE_FROM_USB_DRIVER
 #define  __INCLUDE_FROM_HID_DRIVER
+#define  __INCLUDE_FROM_HIDPARSER_C
 #include "HIDParser.h"
 
 uint8_t USB_ProcessHIDReport(const uint8_t* ReportData,
                              uint16_t ReportSize,
                              HID_ReportInfo_t* const ParserData)
 {
-	HID_StateTable_t      StateTable[HID_STATETABLE_STACK_DEPTH];
-	HID_StateTable_t*     CurrStateTable          = &StateTable[0];
-	HID_CollectionPath_t* CurrCollectionPath      = NULL;
-	HID_ReportSizeInfo_t* CurrReportIDInfo        = &ParserData->ReportIDSizes[0];
-	uint16_t              UsageList[HID_USAGE_STACK_DEPTH];
-	uint8_t               UsageListSize           = 0;
-	HID_MinMax_t          UsageMinMax             = {0, 0};
-
-	memset(ParserData,       0x00, sizeof(HID_ReportInfo_t));
+	HID_ReportParser_t Parser;
+
+	memset(ParserData, 0x00, sizeof(HID_ReportInfo_t));
+	memset(&Parser,    0x00, sizeof(HID_ReportParser_t));
+
+	Parser.ParserData      = ParserData;
+	Parser.CollectionPaths = ParserData->CollectionPaths;
+	Parser.ReportIDSizes   = ParserData->ReportIDSizes;
+
+	uint8_t ErrorCode = USB_ParseHIDReport(ReportData, ReportSize, &Parser);
+
+	ParserData->TotalDeviceReports    = Parser.TotalDeviceReports;
+	ParserData->LargestReportSizeBits = Parser.Statistics.LargestReportSizeBits;
+	ParserData->UsingReportIDs        = Parser.UsingReportIDs;
+
+	if (ErrorCode != HID_PARSE_Successful)
+	  return ErrorCode;
+
+	if (!(ParserData->TotalReportItems))
+	  return HID_PARSE_NoUnfilteredReportItems;
+
+	#if defined(HID_ENABLE_REPORT_PLAN)
+	USB_BuildHIDReportPlan(ParserData);
+	#endif
+
+	return HID_PARSE_Successful;
+}
+
+uint8_t USB_ProcessHIDReportStream(const uint8_t* ReportData,
+                                   uint16_t ReportSize,
+                                   const HID_ReportItemCallback_t Callback,
+                                   void* const Context,
+                                   HID_ParserStatistics_t* const Statistics)
+{
+	HID_ReportParser_t   Parser;
+	HID_CollectionPath_t CollectionPaths[HID_MAX_COLLECTIONS];
+	HID_ReportSizeInfo_t ReportIDSizes[HID_MAX_REPORT_IDS];
+
+	memset(&Parser,         0x00, sizeof(HID_ReportParser_t));
+	memset(CollectionPaths, 0x00, sizeof(CollectionPaths));
+
+	Parser.Callback        = Callback;
+	Parser.Context         = Context;
+	Parser.CollectionPaths = CollectionPaths;
+	Parser.ReportIDSizes   = ReportIDSizes;
+
+	uint8_t ErrorCode = USB_ParseHIDReport(ReportData, ReportSize, &Parser);
+
+	if (Statistics != NULL)
+	  memcpy(Statistics, &Parser.Statistics, sizeof(HID_ParserStatistics_t));
+
+	if (ErrorCode != HID_PARSE_Successful)
+	  return ErrorCode;
+
+	if (!(Parser.Statistics.TotalReportItems))
+	  return HID_PARSE_NoUnfilteredReportItems;
+
+	return HID_PARSE_Successful;
+}
+
+static uint8_t USB_ParseHIDReport(const uint8_t* ReportData,
+                                  uint16_t ReportSize,
+                                  HID_ReportParser_t* const Parser)
+{
+	HID_StateTable_t        StateTable[HID_STATETABLE_STACK_DEPTH];
+	HID_StateTable_t*       CurrStateTable          = &StateTable[0];
+	HID_CollectionPath_t*   CurrCollectionPath      = NULL;
+	HID_ReportSizeInfo_t*   CurrReportIDInfo        = &Parser->ReportIDSizes[0];
+	HID_ParserStatistics_t* Statistics              = &Parser->Statistics;
+	uint16_t                UsageList[HID_USAGE_STACK_DEPTH];
+	uint8_t                 UsageListSize           = 0;
+	uint8_t                 CollectionDepth         = 0;
+	HID_MinMax_t            UsageMinMax             = {0, 0};
+
 	memset(CurrStateTable,   0x00, sizeof(HID_StateTable_t));
 	memset(CurrReportIDInfo, 0x00, sizeof(HID_ReportSizeInfo_t));
 
-	ParserData->TotalDeviceReports = 1;
+	Parser->TotalDeviceReports     = 1;
+	Statistics->TotalReportIDs     = 1;
+	Statistics->MaxStateTableDepth = 1;
 
 	while (ReportSize)
 	{
@@ -61,6 +129,9 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData,
 		switch (HIDReportItem & HID_RI_DATA_SIZE_MASK)
 		{
 			case HID_RI_DATA_BITS_32:
+				if (ReportSize < 4)
+				  return HID_PARSE_TruncatedReportItem;
+
 				ReportItemData  = (((uint32_t)ReportData[3] << 24) | ((uint32_t)ReportData[2] << 16) |
 			                       ((uint16_t)ReportData[1] << 8)  | ReportData[0]);
 				ReportSize     -= 4;
@@ -68,12 +139,18 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData,
 				break;
 
 			case HID_RI_DATA_BITS_16:
+				if (ReportSize < 2)
+				  return HID_PARSE_TruncatedReportItem;
+
 				ReportItemData  = (((uint16_t)ReportData[1] << 8) | (ReportData[0]));
 				ReportSize     -= 2;
 				ReportData     += 2;
 				break;
 
 			case HID_RI_DATA_BITS_8:
+				if (ReportSize < 1)
+				  return HID_PARSE_TruncatedReportItem;
+
 				ReportItemData  = ReportData[0];
 				ReportSize     -= 1;
 				ReportData     += 1;
@@ -92,9 +169,11 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData,
 
 				memcpy((CurrStateTable + 1),
 				       CurrStateTable,
-				       sizeof(HID_ReportItem_t));
+				       sizeof(HID_StateTable_t));
 
 				CurrStateTable++;
+
+				Statistics->MaxStateTableDepth = MAX(Statistics->MaxStateTableDepth, (CurrStateTable - StateTable) + 1);
 				break;
 			case HID_RI_POP(0):
 				if (CurrStateTable == &StateTable[0])
@@ -114,6 +193,7 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData,
 			case HID_RI_LOGICAL_MAXIMUM(0):
 				CurrStateTable->Attributes.Logical.Maximum  = ReportItemData;
 				break;
+			#if !defined(HID_NO_PHYSICAL_UNIT_DATA)
 			case HID_RI_PHYSICAL_MINIMUM(0):
 				CurrStateTable->Attributes.Physical.Minimum = ReportItemData;
 				break;
@@ -126,6 +206,7 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData,
 			case HID_RI_UNIT(0):
 				CurrStateTable->Attributes.Unit.Type        = ReportItemData;
 				break;
+			#endif
 			case HID_RI_REPORT_SIZE(0):
 				CurrStateTable->Attributes.BitSize          = ReportItemData;
 				break;
@@ -135,30 +216,32 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData,
 			case HID_RI_REPORT_ID(0):
 				CurrStateTable->ReportID                    = ReportItemData;
 
-				if (ParserData->UsingReportIDs)
+				if (Parser->UsingReportIDs)
 				{
 					CurrReportIDInfo = NULL;
 
-					for (uint8_t i = 0; i < ParserData->TotalDeviceReports; i++)
+					for (uint8_t i = 0; i < Parser->TotalDeviceReports; i++)
 					{
-						if (ParserData->ReportIDSizes[i].ReportID == CurrStateTable->ReportID)
+						if (Parser->ReportIDSizes[i].ReportID == CurrStateTable->ReportID)
 						{
-							CurrReportIDInfo = &ParserData->ReportIDSizes[i];
+							CurrReportIDInfo = &Parser->ReportIDSizes[i];
 							break;
 						}
 					}
 
 					if (CurrReportIDInfo == NULL)
 					{
-						if (ParserData->TotalDeviceReports == HID_MAX_REPORT_IDS)
+						if (Parser->TotalDeviceReports == HID_MAX_REPORT_IDS)
 						  return HID_PARSE_InsufficientReportIDItems;
 
-						CurrReportIDInfo = &ParserData->ReportIDSizes[ParserData->TotalDeviceReports++];
+						CurrReportIDInfo = &Parser->ReportIDSizes[Parser->TotalDeviceReports++];
 						memset(CurrReportIDInfo, 0x00, sizeof(HID_ReportSizeInfo_t));
+
+						Statistics->TotalReportIDs = Parser->TotalDeviceReports;
 					}
 				}
 
-				ParserData->UsingReportIDs = true;
+				Parser->UsingReportIDs = true;
 
 				CurrReportIDInfo->ReportID = CurrStateTable->ReportID;
 				break;
@@ -167,6 +250,8 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData,
 				  return HID_PARSE_UsageListOverflow;
 
 				UsageList[UsageListSize++] = ReportItemData;
+
+				Statistics->MaxUsageListSize = MAX(Statistics->MaxUsageListSize, UsageListSize);
 				break;
 			case HID_RI_USAGE_MINIMUM(0):
 				UsageMinMax.Minimum = ReportItemData;
@@ -177,17 +262,17 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData,
 			case HID_RI_COLLECTION(0):
 				if (CurrCollectionPath == NULL)
 				{
-					CurrCollectionPath = &ParserData->CollectionPaths[0];
+					CurrCollectionPath = &Parser->CollectionPaths[0];
 				}
 				else
 				{
 					HID_CollectionPath_t* ParentCollectionPath = CurrCollectionPath;
 
-					CurrCollectionPath = &ParserData->CollectionPaths[1];
+					CurrCollectionPath = &Parser->CollectionPaths[1];
 
 					while (CurrCollectionPath->Parent != NULL)
 					{
-						if (CurrCollectionPath == &ParserData->CollectionPaths[HID_MAX_COLLECTIONS - 1])
+						if (CurrCollectionPath == &Parser->CollectionPaths[HID_MAX_COLLECTIONS - 1])
 						  return HID_PARSE_InsufficientCollectionPaths;
 
 						CurrCollectionPath++;
@@ -203,8 +288,8 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData,
 				{
 					CurrCollectionPath->Usage.Usage = UsageList[0];
 
-					for (uint8_t i = 0; i < UsageListSize; i++)
-					  UsageList[i] = UsageList[i + 1];
+					for (uint8_t i = 1; i < UsageListSize; i++)
+					  UsageList[i - 1] = UsageList[i];
 
 					UsageListSize--;
 				}
@@ -213,12 +298,26 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData,
 					CurrCollectionPath->Usage.Usage = UsageMinMax.Minimum++;
 				}
 
+				CollectionDepth++;
+
+				Statistics->TotalCollections++;
+				Statistics->MaxCollectionDepth = MAX(Statistics->MaxCollectionDepth, CollectionDepth);
 				break;
 			case HID_RI_END_COLLECTION(0):
 				if (CurrCollectionPath == NULL)
 				  return HID_PARSE_UnexpectedEndCollection;
 
-				CurrCollectionPath = CurrCollectionPath->Parent;
+				{
+					HID_CollectionPath_t* ParentCollectionPath = CurrCollectionPath->Parent;
+
+					/* Streamed items are finished with once the callback returns, so closed collections can be reused */
+					if ((Parser->ParserData == NULL) && (CurrCollectionPath != &Parser->CollectionPaths[0]))
+					  CurrCollectionPath->Parent = NULL;
+
+					CurrCollectionPath = ParentCollectionPath;
+				}
+
+				CollectionDepth--;
 				break;
 			case HID_RI_INPUT(0):
 			case HID_RI_OUTPUT(0):
@@ -234,13 +333,15 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData,
 					NewReportItem.ItemFlags      = ReportItemData;
 					NewReportItem.CollectionPath = CurrCollectionPath;
 					NewReportItem.ReportID       = CurrStateTable->ReportID;
+					NewReportItem.Value          = 0;
+					NewReportItem.PreviousValue  = 0;
 
 					if (UsageListSize)
 					{
 						NewReportItem.Attributes.Usage.Usage = UsageList[0];
 
-						for (uint8_t i = 0; i < UsageListSize; i++)
-						  UsageList[i] = UsageList[i + 1];
+						for (uint8_t i = 1; i < UsageListSize; i++)
+						  UsageList[i - 1] = UsageList[i];
 
 						UsageListSize--;
 					}
@@ -262,7 +363,21 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData,
 
 					CurrReportIDInfo->ReportSizeBits[NewReportItem.ItemType] += CurrStateTable->Attributes.BitSize;
 
-					ParserData->LargestReportSizeBits = MAX(ParserData->LargestReportSizeBits, CurrReportIDInfo->ReportSizeBits[NewReportItem.ItemType]);
+					Statistics->LargestReportSizeBits = MAX(Statistics->LargestReportSizeBits, CurrReportIDInfo->ReportSizeBits[NewReportItem.ItemType]);
+
+					/* Constant items are padding, which is accounted for in the report sizes but never stored */
+					if (ReportItemData & HID_IOF_CONSTANT)
+					  continue;
+
+					Statistics->TotalReportItems++;
+
+					if (Parser->ParserData == NULL)
+					{
+						Parser->Callback(Parser->Context, &NewReportItem);
+						continue;
+					}
+
+					HID_ReportInfo_t* ParserData = Parser->ParserData;
 
 					if (ParserData->TotalReportItems == HID_MAX_REPORTITEMS)
 					  return HID_PARSE_InsufficientReportItems;
@@ -270,12 +385,12 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData,
 					memcpy(&ParserData->ReportItems[ParserData->TotalReportItems],
 					       &NewReportItem, sizeof(HID_ReportItem_t));
 
-					if (!(ReportItemData & HID_IOF_CONSTANT) && CALLBACK_HIDParser_FilterHIDReportItem(&NewReportItem))
+					if (CALLBACK_HIDParser_FilterHIDReportItem(&NewReportItem))
 					  ParserData->TotalReportItems++;
 				}
 
 				break;
-			
+
 			default:
 				break;
 		}
@@ -288,12 +403,132 @@ uint8_t USB_ProcessHIDReport(const uint8_t* ReportData,
 		}
 	}
 
-	if (!(ParserData->TotalReportItems))
-	  return HID_PARSE_NoUnfilteredReportItems;
+	Statistics->RequiredTableSize = ((Statistics->TotalReportItems * sizeof(HID_ReportItem_t))     +
+	                                 (Statistics->TotalCollections * sizeof(HID_CollectionPath_t)) +
+	                                 (Statistics->TotalReportIDs   * sizeof(HID_ReportSizeInfo_t)));
 
 	return HID_PARSE_Successful;
 }
 
+#if defined(HID_ENABLE_REPORT_PLAN)
+static void USB_BuildHIDReportPlan(HID_ReportInfo_t* const ParserData)
+{
+	HID_ReportPlan_t* ReportPlan = &ParserData->ReportPlan;
+
+	ReportPlan->TotalEntries = 0;
+
+	for (uint8_t ReportIndex = 0; ReportIndex < ParserData->TotalDeviceReports; ReportIndex++)
+	{
+		HID_ReportPlanGroup_t* PlanGroup = &ReportPlan->Groups[ReportIndex];
+		uint8_t                ReportID  = ParserData->ReportIDSizes[ReportIndex].ReportID;
+
+		for (uint8_t ReportType = HID_REPORT_ITEM_In; ReportType <= HID_REPORT_ITEM_Feature; ReportType++)
+		{
+			PlanGroup->FirstEntry[ReportType]   = ReportPlan->TotalEntries;
+			PlanGroup->TotalEntries[ReportType] = 0;
+
+			for (uint8_t ItemIndex = 0; ItemIndex < ParserData->TotalReportItems; ItemIndex++)
+			{
+				HID_ReportItem_t* ReportItem = &ParserData->ReportItems[ItemIndex];
+				uint8_t           BitSize    = ReportItem->Attributes.BitSize;
+
+				if ((ReportItem->ReportID != ReportID) || (ReportItem->ItemType != ReportType))
+				  continue;
+
+				/* Items wider than the item value cannot be extracted, as with USB_GetHIDReportItemInfo() */
+				if (!(BitSize) || (BitSize > 32))
+				  continue;
+
+				HID_ReportPlanEntry_t* PlanEntry = &ReportPlan->Entries[ReportPlan->TotalEntries++];
+				uint16_t               BitOffset = ReportItem->BitOffset + (ReportID ? 8 : 0);
+
+				PlanEntry->ReportItem = ReportItem;
+				PlanEntry->Mask       = (BitSize == 32) ? 0xFFFFFFFF : (((uint32_t)1 << BitSize) - 1);
+				PlanEntry->ByteOffset = (BitOffset / 8);
+				PlanEntry->Shift      = (BitOffset % 8);
+				PlanEntry->TotalBytes = ((PlanEntry->Shift + BitSize + 7) / 8);
+
+				if (!(PlanEntry->Shift) && (BitSize == 8))
+				  PlanEntry->Extract = HID_PLAN_EXTRACT_Byte;
+				else if (!(PlanEntry->Shift) && (BitSize == 16))
+				  PlanEntry->Extract = HID_PLAN_EXTRACT_Word;
+				else
+				  PlanEntry->Extract = HID_PLAN_EXTRACT_Bits;
+
+				PlanGroup->TotalEntries[ReportType]++;
+			}
+		}
+	}
+}
+
+uint8_t USB_GetHIDReportItemValues(HID_ReportInfo_t* const ParserData,
+                                   const uint8_t ReportType,
+                                   const uint8_t* ReportData,
+                                   const uint16_t ReportSize,
+                                   const HID_ReportPlanEntry_t** const PlanEntries)
+{
+	if (!(ReportSize))
+	  return 0;
+
+	uint8_t ReportID = (ParserData->UsingReportIDs ? ReportData[0] : 0);
+
+	for (uint8_t ReportIndex = 0; ReportIndex < ParserData->TotalDeviceReports; ReportIndex++)
+	{
+		if (ParserData->ReportIDSizes[ReportIndex].ReportID != ReportID)
+		  continue;
+
+		/* The report's size is checked once up front so that the individual items need no bounds checks */
+		if (ReportSize < (USB_GetHIDReportSize(ParserData, ReportID, ReportType) + (ReportID ? 1 : 0)))
+		  return 0;
+
+		const HID_ReportPlanGroup_t* PlanGroup    = &ParserData->ReportPlan.Groups[ReportIndex];
+		const HID_ReportPlanEntry_t* PlanEntry    = &ParserData->ReportPlan.Entries[PlanGroup->FirstEntry[ReportType]];
+		uint8_t                      TotalEntries = PlanGroup->TotalEntries[ReportType];
+
+		if (PlanEntries != NULL)
+		  *PlanEntries = PlanEntry;
+
+		for (uint8_t EntriesRem = TotalEntries; EntriesRem; EntriesRem--, PlanEntry++)
+		{
+			const uint8_t*    ItemData   = &ReportData[PlanEntry->ByteOffset];
+			HID_ReportItem_t* ReportItem = PlanEntry->ReportItem;
+			uint32_t          ItemValue;
+
+			switch (PlanEntry->Extract)
+			{
+				case HID_PLAN_EXTRACT_Byte:
+					ItemValue = ItemData[0];
+					break;
+				case HID_PLAN_EXTRACT_Word:
+					ItemValue = (((uint16_t)ItemData[1] << 8) | ItemData[0]);
+					break;
+				default:
+					ItemValue = 0;
+
+					for (uint8_t ByteIndex = MIN(PlanEntry->TotalBytes, 4); ByteIndex--;)
+					  ItemValue = ((ItemValue << 8) | ItemData[ByteIndex]);
+
+					ItemValue >>= PlanEntry->Shift;
+
+					/* An unaligned 32-bit item spills into a fifth byte */
+					if (PlanEntry->TotalBytes > 4)
+					  ItemValue |= ((uint32_t)ItemData[4] << (32 - PlanEntry->Shift));
+
+					ItemValue &= PlanEntry->Mask;
+					break;
+			}
+
+			ReportItem->PreviousValue = ReportItem->Value;
+			ReportItem->Value         = ItemValue;
+		}
+
+		return TotalEntries;
+	}
+
+	return 0;
+}
+#endif
+
 bool USB_GetHIDReportItemInfo(const uint8_t* ReportData,
                               HID_ReportItem_t* const ReportItem)
 {
@@ -130,6 +130,30 @@
 			#define HID_MAX_REPORT_IDS            10
 		#endif
 
+		#if defined(__DOXYGEN__)
+			/** When defined, the Physical minimum and maximum and the Unit attributes of each report item are not stored by
+			 *  the parser, removing the \c Physical and \c Unit members from the \ref HID_ReportItem_Attributes_t structure.
+			 *  This greatly reduces the size of each parsed report item for applications which do not use these attributes.
+			 *  This token should be defined in the user project makefile, passing the define to the compiler using the -D
+			 *  compiler switch.
+			 */
+			#define HID_NO_PHYSICAL_UNIT_DATA
+
+			/** When defined, the Logical and Physical minimum and maximum attributes of each report item are stored as 16-bit
+			 *  values rather than 32-bit values, truncating any larger attribute values in the report descriptor. This token
+			 *  should be defined in the user project makefile, passing the define to the compiler using the -D compiler switch.
+			 */
+			#define HID_16BIT_ATTRIBUTE_RANGES
+
+			/** When defined, the parser additionally compiles each parsed report item's location into an extraction plan
+			 *  stored in the \c ReportPlan member of the \ref HID_ReportInfo_t structure, so that all the item values of a
+			 *  received report can be fetched at once via \ref USB_GetHIDReportItemValues(). This increases the size of
+			 *  the \ref HID_ReportInfo_t structure, and so is disabled by default. This token should be defined in the user
+			 *  project makefile, passing the define to the compiler using the -D compiler switch.
+			 */
+			#define HID_ENABLE_REPORT_PLAN
+		#endif
+
 		/** Returns the value a given HID report item (once its value has been fetched via \ref USB_GetHIDReportItemInfo())
 		 *  left-aligned to the given data type. This allows for signed data to be interpreted correctly, by shifting the data
 		 *  leftwards until the data's sign bit is in the correct position.
@@ -155,6 +179,17 @@
 				HID_PARSE_UsageListOverflow           = 6, /**< More than \ref HID_USAGE_STACK_DEPTH usages listed in a row. */
 				HID_PARSE_InsufficientReportIDItems   = 7, /**< More than \ref HID_MAX_REPORT_IDS report IDs in the device. */
 				HID_PARSE_NoUnfilteredReportItems     = 8, /**< All report items from the device were filtered by the filtering callback routine. */
+				HID_PARSE_TruncatedReportItem         = 9, /**< An item's data extended past the end of the report descriptor. */
+			};
+
+			/** Enum for the possible methods used to extract a report item's value from a report, as stored in the
+			 *  \c Extract member of a \ref HID_ReportPlanEntry_t.
+			 */
+			enum HID_ReportPlan_Extract_t
+			{
+				HID_PLAN_EXTRACT_Byte                 = 0, /**< Byte aligned 8-bit item, read directly from the report. */
+				HID_PLAN_EXTRACT_Word                 = 1, /**< Byte aligned 16-bit item, read directly from the report in little endian. */
+				HID_PLAN_EXTRACT_Bits                 = 2, /**< Any other item, shifted and masked out of the bytes it spans. */
 			};
 
 		/* Type Defines: */
@@ -164,8 +199,13 @@
 			 */
 			typedef struct
 			{
+				#if defined(HID_16BIT_ATTRIBUTE_RANGES) && !defined(__DOXYGEN__)
+				uint16_t Minimum;
+				uint16_t Maximum;
+				#else
 				uint32_t Minimum; /**< Minimum value for the attribute. */
 				uint32_t Maximum; /**< Maximum value for the attribute. */
+				#endif
 			} HID_MinMax_t;
 
 			/** \brief HID Parser Report Item Unit Structure.
@@ -209,9 +249,19 @@
 				uint8_t      BitSize;  /**< Size in bits of the report item's data. */
 
 				HID_Usage_t  Usage;    /**< Usage of the report item. */
-				HID_Unit_t   Unit;     /**< Unit type and exponent of the report item. */
+				#if !defined(HID_NO_PHYSICAL_UNIT_DATA) || defined(__DOXYGEN__)
+				HID_Unit_t   Unit;     /**< Unit type and exponent of the report item.
+				                        *
+				                        *   \note Not available when the \c HID_NO_PHYSICAL_UNIT_DATA token is defined.
+				                        */
+				#endif
 				HID_MinMax_t Logical;  /**< Logical minimum and maximum of the report item. */
-				HID_MinMax_t Physical; /**< Physical minimum and maximum of the report item. */
+				#if !defined(HID_NO_PHYSICAL_UNIT_DATA) || defined(__DOXYGEN__)
+				HID_MinMax_t Physical; /**< Physical minimum and maximum of the report item.
+				                        *
+				                        *   \note Not available when the \c HID_NO_PHYSICAL_UNIT_DATA token is defined.
+				                        */
+				#endif
 			} HID_ReportItem_Attributes_t;
 
 			/** \brief HID Parser Report Item Details Structure.
@@ -246,6 +296,74 @@
 				                             */
 			} HID_ReportSizeInfo_t;
 
+			/** \brief HID Parser Statistics Structure.
+			 *
+			 *  Type define for the statistics gathered by \ref USB_ProcessHIDReportStream() while parsing a HID report
+			 *  descriptor, giving the resources the descriptor requires of the parser.
+			 */
+			typedef struct
+			{
+				uint16_t TotalReportItems;      /**< Total number of non-constant IN, OUT and FEATURE report items in the descriptor. */
+				uint8_t  TotalCollections;      /**< Total number of COLLECTION items in the descriptor. */
+				uint8_t  TotalReportIDs;        /**< Total number of unique reports in the descriptor. */
+				uint8_t  MaxStateTableDepth;    /**< Deepest level of the state table stack reached through PUSH items. */
+				uint8_t  MaxUsageListSize;      /**< Largest number of USAGE items listed before a single main item. */
+				uint8_t  MaxCollectionDepth;    /**< Deepest level of COLLECTION item nesting. */
+				uint16_t LargestReportSizeBits; /**< Largest report that the device will generate, in bits. */
+				uint32_t RequiredTableSize;     /**< Size in bytes of the report item, collection and report size tables needed to
+				                                 *   store the complete descriptor in a \ref HID_ReportInfo_t structure.
+				                                 */
+			} HID_ParserStatistics_t;
+
+			/** Type define for a report item callback function for \ref USB_ProcessHIDReportStream(), called for each
+			 *  non-constant report item in the report descriptor as it is parsed.
+			 *
+			 *  \param[in] Context     Context pointer given to \ref USB_ProcessHIDReportStream().
+			 *  \param[in] ReportItem  Pointer to the parsed report item, which is only valid for the duration of the callback.
+			 */
+			typedef void (*HID_ReportItemCallback_t)(void* const Context,
+			                                         const HID_ReportItem_t* const ReportItem);
+
+			/** \brief HID Parser Report Extraction Plan Entry Structure.
+			 *
+			 *  Type define for the precomputed location of a single report item's value within its report, so that the value
+			 *  can be read out of a received report without walking the item's bits one at a time.
+			 */
+			typedef struct
+			{
+				HID_ReportItem_t* ReportItem; /**< Report item whose \c Value is updated from this entry. */
+				uint32_t          Mask;       /**< Mask of the item's value bits, once shifted down to bit zero. */
+				uint16_t          ByteOffset; /**< Offset of the first report byte holding the item, including any report ID byte. */
+				uint8_t           Shift;      /**< Bit position of the item's least significant bit within its first byte. */
+				uint8_t           TotalBytes; /**< Number of report bytes spanned by the item. */
+				uint8_t           Extract;    /**< Extraction method for the item, a value from the \ref HID_ReportPlan_Extract_t enum. */
+			} HID_ReportPlanEntry_t;
+
+			/** \brief HID Parser Report Extraction Plan Group Structure.
+			 *
+			 *  Type define for the range of extraction plan entries belonging to each report type of a single report ID. Each
+			 *  group corresponds to the report size information entry at the same index of the \c ReportIDSizes array.
+			 */
+			typedef struct
+			{
+				uint8_t FirstEntry[3];   /**< Index of the report ID's first plan entry of each report type, indexed by the
+				                          *   \ref HID_ReportItemTypes_t enum.
+				                          */
+				uint8_t TotalEntries[3]; /**< Number of plan entries of each report type, indexed by the \ref HID_ReportItemTypes_t enum. */
+			} HID_ReportPlanGroup_t;
+
+			/** \brief HID Parser Report Extraction Plan Structure.
+			 *
+			 *  Type define for the complete extraction plan of a parsed HID report descriptor, holding the precomputed
+			 *  location of every stored report item grouped by report ID and report type.
+			 */
+			typedef struct
+			{
+				uint8_t               TotalEntries; /**< Total number of entries stored in the \c Entries array. */
+				HID_ReportPlanEntry_t Entries[HID_MAX_REPORTITEMS]; /**< Plan entries, ordered by report ID and type. */
+				HID_ReportPlanGroup_t Groups[HID_MAX_REPORT_IDS]; /**< Plan entry ranges for each report ID in the interface. */
+			} HID_ReportPlan_t;
+
 			/** \brief HID Parser State Structure.
 			 *
 			 *  Type define for a complete processed HID report, including all report item data and collections.
@@ -265,6 +383,12 @@
 				bool                 UsingReportIDs; /**< Indicates if the device has at least one REPORT ID
 				                                      *   element in its HID report descriptor.
 				                                      */
+				#if defined(HID_ENABLE_REPORT_PLAN) || defined(__DOXYGEN__)
+				HID_ReportPlan_t     ReportPlan; /**< Extraction plan for the stored report items.
+				                                  *
+				                                  *  \note Only available when the \c HID_ENABLE_REPORT_PLAN token is defined.
+				                                  */
+				#endif
 			} HID_ReportInfo_t;
 
 		/* Function Prototypes: */
@@ -281,6 +405,29 @@
 			                             uint16_t ReportSize,
 			                             HID_ReportInfo_t* const ParserData) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(3);
 
+			/** Function to process a given HID report returned from an attached device without storing its report items,
+			 *  instead passing each report item to the given callback function as it is parsed. The RAM used by the parser
+			 *  in this mode does not depend on the number of report items in the report, and collections are only held
+			 *  while open, so that devices with very large reports can be processed on devices with limited RAM.
+			 *
+			 *  \note The report item filter callback \ref CALLBACK_HIDParser_FilterHIDReportItem() is not called in this mode.
+			 *
+			 *  \param[in]  ReportData  Buffer containing the device's HID report table.
+			 *  \param[in]  ReportSize  Size in bytes of the HID report table.
+			 *  \param[in]  Callback    Callback function to pass each parsed report item to.
+			 *  \param[in]  Context     Context pointer passed to the callback function.
+			 *  \param[out] Statistics  If not \c NULL, pointer to a \ref HID_ParserStatistics_t instance where the resources
+			 *                          required by the report are stored, even if the report could not be parsed.
+			 *
+			 *  \return A value in the \ref HID_Parse_ErrorCodes_t enum.
+			 */
+			uint8_t USB_ProcessHIDReportStream(const uint8_t* ReportData,
+			                                   uint16_t ReportSize,
+			                                   const HID_ReportItemCallback_t Callback,
+			                                   void* const Context,
+			                                   HID_ParserStatistics_t* const Statistics) ATTR_NON_NULL_PTR_ARG(1)
+			                                   ATTR_NON_NULL_PTR_ARG(3);
+
 			/** Extracts the given report item's value out of the given HID report and places it into the Value
 			 *  member of the report item's \ref HID_ReportItem_t structure.
 			 *
@@ -297,6 +444,30 @@
 			bool USB_GetHIDReportItemInfo(const uint8_t* ReportData,
 			                              HID_ReportItem_t* const ReportItem) ATTR_NON_NULL_PTR_ARG(1);
 
+			#if defined(HID_ENABLE_REPORT_PLAN) || defined(__DOXYGEN__)
+			/** Extracts the values of all the stored report items of the given type contained in the given HID report in a
+			 *  single pass, using the extraction plan built by \ref USB_ProcessHIDReport(). Each updated item's previous
+			 *  \c Value is copied to its \c PreviousValue element, as with \ref USB_GetHIDReportItemInfo().
+			 *
+			 *  \note Only available when the \c HID_ENABLE_REPORT_PLAN token is defined.
+			 *
+			 *  \param[in,out] ParserData   Pointer to a \ref HID_ReportInfo_t instance containing the parser output.
+			 *  \param[in]     ReportType   Type of the given report, a value from the \ref HID_ReportItemTypes_t enum.
+			 *  \param[in]     ReportData   Buffer containing an IN or FEATURE report from an attached device.
+			 *  \param[in]     ReportSize   Size in bytes of the given report.
+			 *  \param[out]    PlanEntries  If not \c NULL, set to the first plan entry of the updated report items, so that the
+			 *                              application can process just the items contained in the report.
+			 *
+			 *  \return Number of report items updated, or zero if the report ID is unknown or the report is too short.
+			 */
+			uint8_t USB_GetHIDReportItemValues(HID_ReportInfo_t* const ParserData,
+			                                   const uint8_t ReportType,
+			                                   const uint8_t* ReportData,
+			                                   const uint16_t ReportSize,
+			                                   const HID_ReportPlanEntry_t** const PlanEntries) ATTR_NON_NULL_PTR_ARG(1)
+			                                   ATTR_NON_NULL_PTR_ARG(3);
+			#endif
+
 			/** Retrieves the given report item's value out of the \c Value member of the report item's
 			 *  \ref HID_ReportItem_t structure and places it into the correct position in the HID report
 			 *  buffer. The report buffer is assumed to have the appropriate bits cleared before calling
@@ -351,6 +522,30 @@
 				 uint8_t                     ReportCount;
 				 uint8_t                     ReportID;
 			} HID_StateTable_t;
+
+			typedef struct
+			{
+				HID_ReportInfo_t*        ParserData;
+				HID_ReportItemCallback_t Callback;
+				void*                    Context;
+				HID_CollectionPath_t*    CollectionPaths;
+				HID_ReportSizeInfo_t*    ReportIDSizes;
+				uint8_t                  TotalDeviceReports;
+				bool                     UsingReportIDs;
+				HID_ParserStatistics_t   Statistics;
+			} HID_ReportParser_t;
+
+		/* Function Prototypes: */
+			#if defined(__INCLUDE_FROM_HIDPARSER_C)
+				static uint8_t USB_ParseHIDReport(const uint8_t* ReportData,
+				                                  uint16_t ReportSize,
+				                                  HID_ReportParser_t* const Parser) ATTR_NON_NULL_PTR_ARG(1)
+				                                  ATTR_NON_NULL_PTR_ARG(3);
+
+				#if defined(HID_ENABLE_REPORT_PLAN)
+				static void USB_BuildHIDReportPlan(HID_ReportInfo_t* const ParserData) ATTR_NON_NULL_PTR_ARG(1);
+				#endif
+			#endif
 	#endif
 
 	/* Disable C linkage for C++ Compilers: */
@@ -75,6 +75,41 @@
 
 		/** MIDI command for a note off (deactivation) event. */
 		#define MIDI_COMMAND_NOTE_OFF       0x80
+
+		/** MIDI command for the start of a System Exclusive (SysEx) message. */
+		#define MIDI_COMMAND_SYSEX_START    0xF0
+
+		/** MIDI command for the end of a System Exclusive (SysEx) message. */
+		#define MIDI_COMMAND_SYSEX_END      0xF7
+
+		/** Lowest MIDI command value of the single byte System Real-Time messages, which may be interleaved anywhere
+		 *  in a MIDI byte stream, including between the bytes of other messages.
+		 */
+		#define MIDI_COMMAND_REALTIME       0xF8
+		//@}
+
+		/** \name MIDI Event Packet Code Index Numbers */
+		//@{
+		/** Code Index Number for a two byte System Common message. */
+		#define MIDI_CIN_SYSCOMMON_2BYTE    0x02
+
+		/** Code Index Number for a three byte System Common message. */
+		#define MIDI_CIN_SYSCOMMON_3BYTE    0x03
+
+		/** Code Index Number for three bytes of a System Exclusive message which starts or continues in the packet. */
+		#define MIDI_CIN_SYSEX_START        0x04
+
+		/** Code Index Number for a single byte System Common message, or the final byte of a System Exclusive message. */
+		#define MIDI_CIN_SYSEX_END_1BYTE    0x05
+
+		/** Code Index Number for the final two bytes of a System Exclusive message. */
+		#define MIDI_CIN_SYSEX_END_2BYTE    0x06
+
+		/** Code Index Number for the final three bytes of a System Exclusive message. */
+		#define MIDI_CIN_SYSEX_END_3BYTE    0x07
+
+		/** Code Index Number for a single unparsed byte, used for System Real-Time messages. */
+		#define MIDI_CIN_SINGLE_BYTE        0x0F
 		//@}
 
 		/** Standard key press velocity value used for all note events. */
@@ -99,6 +134,17 @@
 		 */
 		#define MIDI_EVENT(virtualcable, command) ((virtualcable << 4) | (command >> 4))
 
+		/** Constructs a MIDI event ID from a given USB-MIDI Code Index Number and a virtual MIDI cable index, for
+		 *  event packets such as System Exclusive and System Common messages whose Code Index Number is not the
+		 *  upper nibble of the MIDI command.
+		 *
+		 *  \param[in] virtualcable  Index of the virtual MIDI cable the event relates to
+		 *  \param[in] cin           Code Index Number of the event, a \c MIDI_CIN_* value
+		 *
+		 *  \return Constructed MIDI event ID.
+		 */
+		#define MIDI_EVENT_CIN(virtualcable, cin) (((virtualcable) << 4) | (cin))
+
 	/* Enums: */
 		/** Enum for the possible MIDI jack types in a MIDI device jack descriptor. */
 		enum MIDI_JackTypes_t
@@ -0,0 +1,248 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#define  __INCLUDE_FROM_MIDI_DRIVER
+#define  __INCLUDE_FROM_MIDICONVERTER_C
+#include "MIDIConverter.h"
+
+/** Number of MIDI bytes carried in an event packet, indexed by the packet's Code Index Number. */
+static const uint8_t MIDI_EventLengths[16] = {0, 0, 2, 3, 3, 1, 2, 3, 3, 3, 3, 3, 2, 2, 3, 1};
+
+static void MIDI_CompleteStreamEvent(MIDI_StreamParser_t* const Parser,
+                                     const uint8_t CIN,
+                                     MIDI_EventPacket_t* const Event)
+{
+	Event->Event = MIDI_EVENT_CIN(Parser->Cable, CIN);
+	Event->Data1 = Parser->Message[0];
+	Event->Data2 = (Parser->MessageIndex > 1) ? Parser->Message[1] : 0;
+	Event->Data3 = (Parser->MessageIndex > 2) ? Parser->Message[2] : 0;
+
+	Parser->MessageIndex  = 0;
+	Parser->MessageLength = 0;
+}
+
+bool MIDI_ProcessStreamByte(MIDI_StreamParser_t* const Parser,
+                            const uint8_t Byte,
+                            MIDI_EventPacket_t* const Event)
+{
+	/* Real-Time messages may appear anywhere in the stream, and are passed through without touching the parser state */
+	if (Byte >= MIDI_COMMAND_REALTIME)
+	{
+		Event->Event = MIDI_EVENT_CIN(Parser->Cable, MIDI_CIN_SINGLE_BYTE);
+		Event->Data1 = Byte;
+		Event->Data2 = 0;
+		Event->Data3 = 0;
+
+		return true;
+	}
+
+	if (!(Byte & 0x80))
+	{
+		if (Parser->InSysEx)
+		{
+			Parser->Message[Parser->MessageIndex++] = Byte;
+
+			if (Parser->MessageIndex < 3)
+			  return false;
+
+			MIDI_CompleteStreamEvent(Parser, MIDI_CIN_SYSEX_START, Event);
+			return true;
+		}
+
+		/* Data bytes following a completed channel message start a new message under running status */
+		if (!(Parser->MessageLength))
+		{
+			if (!(Parser->RunningStatus))
+			  return false;
+
+			Parser->Message[Parser->MessageIndex++] = Parser->RunningStatus;
+			Parser->MessageLength = (((Parser->RunningStatus & 0xE0) == 0xC0) ? 2 : 3);
+		}
+
+		Parser->Message[Parser->MessageIndex++] = Byte;
+
+		if (Parser->MessageIndex < Parser->MessageLength)
+		  return false;
+
+		/* Channel messages use their command as the CIN, System Common messages their length (two or three bytes) */
+		if (Parser->Message[0] < 0xF0)
+		  MIDI_CompleteStreamEvent(Parser, (Parser->Message[0] >> 4), Event);
+		else
+		  MIDI_CompleteStreamEvent(Parser, Parser->MessageLength, Event);
+
+		return true;
+	}
+
+	/* The end byte of a SysEx message shares its packet with any data bytes left over from the last full packet */
+	if (Byte == MIDI_COMMAND_SYSEX_END)
+	{
+		bool WasInSysEx = Parser->InSysEx;
+
+		Parser->InSysEx = false;
+
+		if (!(WasInSysEx))
+		{
+			Parser->MessageIndex  = 0;
+			Parser->MessageLength = 0;
+			return false;
+		}
+
+		Parser->Message[Parser->MessageIndex++] = Byte;
+		MIDI_CompleteStreamEvent(Parser, (MIDI_CIN_SYSEX_END_1BYTE - 1 + Parser->MessageIndex), Event);
+		return true;
+	}
+
+	/* Any other status byte abandons an unfinished message, including an unterminated SysEx message */
+	Parser->InSysEx       = false;
+	Parser->MessageIndex  = 0;
+	Parser->MessageLength = 0;
+
+	if (Byte < 0xF0)
+	{
+		Parser->RunningStatus = Byte;
+		Parser->Message[Parser->MessageIndex++] = Byte;
+		Parser->MessageLength = (((Byte & 0xE0) == 0xC0) ? 2 : 3);
+
+		return false;
+	}
+
+	/* System Exclusive and System Common messages cancel any running status */
+	Parser->RunningStatus = 0;
+
+	switch (Byte)
+	{
+		case MIDI_COMMAND_SYSEX_START:
+			Parser->InSysEx = true;
+			Parser->Message[Parser->MessageIndex++] = Byte;
+			return false;
+		case 0xF1:
+		case 0xF3:
+			Parser->Message[Parser->MessageIndex++] = Byte;
+			Parser->MessageLength = 2;
+			return false;
+		case 0xF2:
+			Parser->Message[Parser->MessageIndex++] = Byte;
+			Parser->MessageLength = 3;
+			return false;
+		case 0xF6:
+			Parser->Message[Parser->MessageIndex++] = Byte;
+			MIDI_CompleteStreamEvent(Parser, MIDI_CIN_SYSEX_END_1BYTE, Event);
+			return true;
+		default:
+			return false;
+	}
+}
+
+uint16_t MIDI_ConvertStreamToEvents(MIDI_StreamParser_t* const Parser,
+                                    const uint8_t* Buffer,
+                                    const uint16_t Length,
+                                    uint16_t* const BytesProcessed,
+                                    MIDI_EventPacket_t* Events,
+                                    const uint16_t MaxEvents)
+{
+	uint16_t BytesRemaining = Length;
+	uint16_t TotalEvents    = 0;
+
+	while (BytesRemaining && (TotalEvents < MaxEvents))
+	{
+		/* Pack runs of SysEx data straight into event packets while the parser is on a packet boundary */
+		if (Parser->InSysEx && !(Parser->MessageIndex))
+		{
+			while ((BytesRemaining >= 3) && (TotalEvents < MaxEvents) && !((Buffer[0] | Buffer[1] | Buffer[2]) & 0x80))
+			{
+				Events->Event = MIDI_EVENT_CIN(Parser->Cable, MIDI_CIN_SYSEX_START);
+				Events->Data1 = Buffer[0];
+				Events->Data2 = Buffer[1];
+				Events->Data3 = Buffer[2];
+
+				Events++;
+				TotalEvents++;
+				Buffer         += 3;
+				BytesRemaining -= 3;
+			}
+
+			if (!(BytesRemaining) || (TotalEvents == MaxEvents))
+			  break;
+		}
+
+		if (MIDI_ProcessStreamByte(Parser, *(Buffer++), Events))
+		{
+			Events++;
+			TotalEvents++;
+		}
+
+		BytesRemaining--;
+	}
+
+	*BytesProcessed = (Length - BytesRemaining);
+	return TotalEvents;
+}
+
+uint8_t MIDI_ConvertEventToStream(MIDI_StreamWriter_t* const Writer,
+                                  const MIDI_EventPacket_t* const Event,
+                                  uint8_t* const Buffer)
+{
+	uint8_t CIN    = (Event->Event & 0x0F);
+	uint8_t Length = MIDI_EventLengths[CIN];
+	uint8_t Status = Event->Data1;
+
+	if (!(Length))
+	  return 0;
+
+	if ((CIN >= 0x08) && (CIN <= 0x0E))
+	{
+		/* Channel messages repeating the last status byte may omit it under running status */
+		if (Status == Writer->RunningStatus)
+		{
+			Buffer[0] = Event->Data2;
+			Buffer[1] = Event->Data3;
+
+			return (Length - 1);
+		}
+
+		Writer->RunningStatus = Status;
+	}
+	else if ((CIN != MIDI_CIN_SINGLE_BYTE) || ((Status & 0x80) && (Status < MIDI_COMMAND_REALTIME)))
+	{
+		Writer->RunningStatus = 0;
+	}
+
+	Buffer[0] = Status;
+	Buffer[1] = Event->Data2;
+	Buffer[2] = Event->Data3;
+
+	return Length;
+}
+
+uint8_t MIDI_GetEventLength(const MIDI_EventPacket_t* const Event)
+{
+	return MIDI_EventLengths[Event->Event & 0x0F];
+}
@@ -0,0 +1,234 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Conversion between MIDI byte streams and USB-MIDI event packets.
+ *
+ *  This file provides routines to convert a raw MIDI byte stream, such as the one carried on a DIN-MIDI
+ *  serial link, into USB-MIDI event packets and back again.
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB module driver
+ *        dispatch header located in LUFA/Drivers/USB.h.
+ */
+
+/** \ingroup Group_USBClassMIDI
+ *  \defgroup Group_MIDIConverter MIDI Stream Converter
+ *  \brief Conversion between MIDI byte streams and USB-MIDI event packets.
+ *
+ *  \section Sec_Dependencies Module Source Dependencies
+ *  The following files must be built with any user project that uses this module:
+ *    - LUFA/Drivers/USB/Class/Common/MIDIConverter.c <i>(Makefile source module name: LUFA_SRC_USBCLASS)</i>
+ *
+ *  \section Sec_ModDescription Module Description
+ *  MIDI byte stream converter. A MIDI byte stream may omit the status byte of consecutive channel messages
+ *  sharing the same status (running status), may interleave single byte System Real-Time messages between
+ *  the bytes of any other message, and carries System Exclusive messages of arbitrary length between a start
+ *  and end byte. The USB-MIDI class instead sends every message as one or more self contained four byte event
+ *  packets, each tagged with a Code Index Number describing the packet contents.
+ *
+ *  A \ref MIDI_StreamParser_t instance assembles event packets from a byte stream, emitting System Real-Time
+ *  messages immediately, restoring elided running status bytes and splitting System Exclusive messages into
+ *  three byte packets; whole buffers of bytes can be converted at once with \ref MIDI_ConvertStreamToEvents(),
+ *  which packs the bulk of a System Exclusive dump without running each byte through the parser state machine.
+ *  A \ref MIDI_StreamWriter_t instance converts event packets back into a byte stream, eliding repeated channel
+ *  message status bytes to reduce the stream length on slow links.
+ *
+ *  Each parser handles a single virtual MIDI cable; applications bridging several physical MIDI ports should
+ *  use one parser and one writer per port.
+ *
+ *  @{
+ */
+
+#ifndef _MIDI_CONVERTER_H_
+#define _MIDI_CONVERTER_H_
+
+	/* Includes: */
+		#include "../../../../Common/Common.h"
+
+		#include "MIDIClassCommon.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_MIDI_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB.h instead.
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Type Defines: */
+			/** \brief MIDI Byte Stream Parser State.
+			 *
+			 *  State of a MIDI byte stream to event packet converter. An instance of this structure should be made
+			 *  for each byte stream being converted, and initialized with \ref MIDI_InitStreamParser() before use.
+			 *  The contents of this structure should not be altered by the user application.
+			 */
+			typedef struct
+			{
+				uint8_t Cable; /**< Virtual MIDI cable index the produced event packets are tagged with. */
+				uint8_t RunningStatus; /**< Channel message status byte applied to data bytes without a preceding status
+				                        *   byte, or zero if no running status is currently in effect.
+				                        */
+				uint8_t Message[3]; /**< Bytes of the message or System Exclusive packet currently being assembled. */
+				uint8_t MessageIndex; /**< Number of bytes currently stored in \c Message. */
+				uint8_t MessageLength; /**< Total length of the message currently being assembled, or zero if idle. */
+				bool    InSysEx; /**< Indicates if the stream is currently within a System Exclusive message. */
+			} MIDI_StreamParser_t;
+
+			/** \brief MIDI Byte Stream Writer State.
+			 *
+			 *  State of a MIDI event packet to byte stream converter. An instance of this structure should be made
+			 *  for each byte stream being produced, and initialized with \ref MIDI_InitStreamWriter() before use.
+			 *  The contents of this structure should not be altered by the user application.
+			 */
+			typedef struct
+			{
+				uint8_t RunningStatus; /**< Channel message status byte last written to the stream, or zero if the
+				                        *   next channel message must include its status byte.
+				                        */
+			} MIDI_StreamWriter_t;
+
+		/* Function Prototypes: */
+			/** Processes a single byte of a MIDI byte stream, assembling it into a USB-MIDI event packet. System
+			 *  Real-Time bytes complete an event immediately without disturbing any partially assembled message,
+			 *  and data bytes following a completed channel message reuse its status byte under running status.
+			 *  Unrecognized status bytes, unterminated System Exclusive messages interrupted by another status byte
+			 *  and data bytes without a valid status are discarded.
+			 *
+			 *  \param[in,out] Parser  Pointer to the parser state of the byte stream.
+			 *  \param[in]     Byte    Next byte of the MIDI byte stream.
+			 *  \param[out]    Event   Pointer to an event packet where a completed event is to be stored.
+			 *
+			 *  \return Boolean \c true if the byte completed an event packet, \c false otherwise.
+			 */
+			bool MIDI_ProcessStreamByte(MIDI_StreamParser_t* const Parser,
+			                            const uint8_t Byte,
+			                            MIDI_EventPacket_t* const Event) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(3);
+
+			/** Converts a block of a MIDI byte stream into USB-MIDI event packets. This is equivalent to passing each
+			 *  byte in turn to \ref MIDI_ProcessStreamByte(), however runs of System Exclusive data are packed three
+			 *  bytes at a time without passing through the parser state machine, so that large System Exclusive dumps
+			 *  are converted quickly. Conversion stops once the end of the block is reached, or once the event buffer
+			 *  is full, in which case the remaining bytes should be passed to a later call.
+			 *
+			 *  \param[in,out] Parser          Pointer to the parser state of the byte stream.
+			 *  \param[in]     Buffer          Pointer to the block of bytes to convert.
+			 *  \param[in]     Length          Number of bytes in the block.
+			 *  \param[out]    BytesProcessed  Pointer to a location where the number of bytes consumed from the block is stored.
+			 *  \param[out]    Events          Pointer to a buffer where the produced event packets are stored.
+			 *  \param[in]     MaxEvents       Maximum number of event packets that may be stored into the buffer.
+			 *
+			 *  \return Number of event packets stored into the event buffer.
+			 */
+			uint16_t MIDI_ConvertStreamToEvents(MIDI_StreamParser_t* const Parser,
+			                                    const uint8_t* Buffer,
+			                                    const uint16_t Length,
+			                                    uint16_t* const BytesProcessed,
+			                                    MIDI_EventPacket_t* Events,
+			                                    const uint16_t MaxEvents) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(4)
+			                                    ATTR_NON_NULL_PTR_ARG(5);
+
+			/** Converts a USB-MIDI event packet into the bytes of a MIDI byte stream. The status byte of a channel
+			 *  message is omitted when it matches that of the previous channel message written to the stream, while
+			 *  System Exclusive and System Common messages cancel running status so that the next channel message
+			 *  always carries its status byte. System Real-Time messages do not affect running status.
+			 *
+			 *  \param[in,out] Writer  Pointer to the writer state of the byte stream.
+			 *  \param[in]     Event   Pointer to the event packet to convert.
+			 *  \param[out]    Buffer  Pointer to a buffer of at least three bytes where the stream bytes are to be stored.
+			 *
+			 *  \return Number of bytes stored into the buffer, zero if the event packet carries no MIDI data.
+			 */
+			uint8_t MIDI_ConvertEventToStream(MIDI_StreamWriter_t* const Writer,
+			                                  const MIDI_EventPacket_t* const Event,
+			                                  uint8_t* const Buffer) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2)
+			                                  ATTR_NON_NULL_PTR_ARG(3);
+
+			/** Retrieves the number of MIDI bytes carried in a USB-MIDI event packet, determined by the packet's
+			 *  Code Index Number.
+			 *
+			 *  \param[in] Event  Pointer to the event packet to examine.
+			 *
+			 *  \return Number of MIDI bytes in the event packet, from zero to three.
+			 */
+			uint8_t MIDI_GetEventLength(const MIDI_EventPacket_t* const Event) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+
+		/* Inline Functions: */
+			/** Initializes a MIDI byte stream parser, ready for the conversion of a new byte stream. Any partially
+			 *  assembled message and running status from a previous stream is discarded.
+			 *
+			 *  \param[out] Parser  Pointer to the parser state to initialize.
+			 *  \param[in]  Cable   Virtual MIDI cable index the produced event packets are to be tagged with.
+			 */
+			static inline void MIDI_InitStreamParser(MIDI_StreamParser_t* const Parser,
+			                                         const uint8_t Cable) ATTR_NON_NULL_PTR_ARG(1);
+			static inline void MIDI_InitStreamParser(MIDI_StreamParser_t* const Parser,
+			                                         const uint8_t Cable)
+			{
+				memset(Parser, 0x00, sizeof(MIDI_StreamParser_t));
+				Parser->Cable = (Cable & 0x0F);
+			}
+
+			/** Initializes a MIDI byte stream writer, ready for the production of a new byte stream. The first
+			 *  channel message written afterwards always includes its status byte.
+			 *
+			 *  \param[out] Writer  Pointer to the writer state to initialize.
+			 */
+			static inline void MIDI_InitStreamWriter(MIDI_StreamWriter_t* const Writer) ATTR_NON_NULL_PTR_ARG(1);
+			static inline void MIDI_InitStreamWriter(MIDI_StreamWriter_t* const Writer)
+			{
+				Writer->RunningStatus = 0;
+			}
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define MIDI_STREAM_CHUNK_EVENTS    16
+
+		/* Function Prototypes: */
+			#if defined(__INCLUDE_FROM_MIDICONVERTER_C)
+				static void MIDI_CompleteStreamEvent(MIDI_StreamParser_t* const Parser,
+				                                     const uint8_t CIN,
+				                                     MIDI_EventPacket_t* const Event) ATTR_NON_NULL_PTR_ARG(1)
+				                                     ATTR_NON_NULL_PTR_ARG(3);
+			#endif
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
@@ -116,6 +116,35 @@
 
 		/** SCSI Command Code for a MODE SENSE (10) command. */
 		#define SCSI_CMD_MODE_SENSE_10                         0x5A
+
+		/** SCSI Command Code for a SYNCHRONIZE CACHE (10) command. */
+		#define SCSI_CMD_SYNCHRONIZE_CACHE_10                  0x35
+
+		/** SCSI Command Code for an UNMAP command. */
+		#define SCSI_CMD_UNMAP                                 0x42
+
+		/** SCSI Command Code for a SERVICE ACTION IN (16) command, whose service action is given in the lower five
+		 *  bits of the second command byte.
+		 */
+		#define SCSI_CMD_SERVICE_ACTION_IN_16                  0x9E
+		//@}
+
+		/** \name SCSI Service Actions */
+		//@{
+		/** SCSI Service Action of a SERVICE ACTION IN (16) command for a READ CAPACITY (16) command. */
+		#define SCSI_SERVICE_ACTION_READ_CAPACITY_16           0x10
+		//@}
+
+		/** \name SCSI Vital Product Data Page Codes */
+		//@{
+		/** SCSI Vital Product Data page code for the Supported VPD Pages page. */
+		#define SCSI_VPD_PAGE_SUPPORTED_PAGES                  0x00
+
+		/** SCSI Vital Product Data page code for the Block Limits page. */
+		#define SCSI_VPD_PAGE_BLOCK_LIMITS                     0xB0
+
+		/** SCSI Vital Product Data page code for the Logical Block Provisioning page. */
+		#define SCSI_VPD_PAGE_LOGICAL_BLOCK_PROVISIONING       0xB2
 		//@}
 
 		/** \name SCSI Sense Key Values */
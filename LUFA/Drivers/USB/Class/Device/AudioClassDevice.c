@@ -176,8 +176,15 @@ bool Audio_Device_ConfigureEndpoints(USB_ClassInfo_Audio_Device_t* const AudioIn
 {
 	memset(&AudioInterfaceInfo->State, 0x00, sizeof(AudioInterfaceInfo->State));
 	
-	AudioInterfaceInfo->Config.DataINEndpoint.Type  = EP_TYPE_ISOCHRONOUS;
-	AudioInterfaceInfo->Config.DataOUTEndpoint.Type = EP_TYPE_ISOCHRONOUS;
+	AudioInterfaceInfo->Config.DataINEndpoint.Type   = EP_TYPE_ISOCHRONOUS;
+	AudioInterfaceInfo->Config.DataOUTEndpoint.Type  = EP_TYPE_ISOCHRONOUS;
+	AudioInterfaceInfo->Config.FeedbackEndpoint.Type = EP_TYPE_ISOCHRONOUS;
+
+	/* Longer refresh periods would overflow the 11-bit frame number used to time each feedback measurement */
+	if (AudioInterfaceInfo->Config.FeedbackRefresh < AUDIO_FEEDBACK_REFRESH_MIN)
+	  AudioInterfaceInfo->Config.FeedbackRefresh = AUDIO_FEEDBACK_REFRESH_MIN;
+	else if (AudioInterfaceInfo->Config.FeedbackRefresh > AUDIO_FEEDBACK_REFRESH_MAX)
+	  AudioInterfaceInfo->Config.FeedbackRefresh = AUDIO_FEEDBACK_REFRESH_MAX;
 
 	if (!(Endpoint_ConfigureEndpointTable(&AudioInterfaceInfo->Config.DataINEndpoint, 1)))
 	  return false;
@@ -185,9 +192,208 @@ bool Audio_Device_ConfigureEndpoints(USB_ClassInfo_Audio_Device_t* const AudioIn
 	if (!(Endpoint_ConfigureEndpointTable(&AudioInterfaceInfo->Config.DataOUTEndpoint, 1)))
 	  return false;
 
+	if (!(Endpoint_ConfigureEndpointTable(&AudioInterfaceInfo->Config.FeedbackEndpoint, 1)))
+	  return false;
+
 	return true;
 }
 
+void Audio_Device_USBTask(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo)
+{
+	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(AudioInterfaceInfo->State.InterfaceEnabled))
+	  return;
+
+	if (!(AudioInterfaceInfo->Config.FeedbackEndpoint.Address))
+	  return;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	uint32_t FeedbackValue = AudioInterfaceInfo->State.FeedbackValue;
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	if (!(FeedbackValue))
+	  return;
+
+	Endpoint_SelectEndpoint(AudioInterfaceInfo->Config.FeedbackEndpoint.Address);
+
+	if (!(Endpoint_IsINReady()))
+	  return;
+
+	/* Full speed feedback values are sent as three byte 10.14 fixed point samples per frame */
+	Endpoint_Write_16_LE(FeedbackValue);
+	Endpoint_Write_8(FeedbackValue >> 16);
+	Endpoint_ClearIN();
+}
+
+void Audio_Device_ProcessStartOfFrame(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo)
+{
+	if (!(AudioInterfaceInfo->Config.FeedbackEndpoint.Address) || !(AudioInterfaceInfo->State.InterfaceEnabled))
+	{
+		AudioInterfaceInfo->State.PeriodStarted = false;
+		return;
+	}
+
+	uint16_t CurrentFrame = USB_Device_GetFrameNumber();
+
+	if (!(AudioInterfaceInfo->State.PeriodStarted))
+	{
+		AudioInterfaceInfo->State.PeriodStartFrame = CurrentFrame;
+		AudioInterfaceInfo->State.SampleCount      = 0;
+		AudioInterfaceInfo->State.PeriodStarted    = true;
+		return;
+	}
+
+	uint16_t RefreshFrames = (1 << AudioInterfaceInfo->Config.FeedbackRefresh);
+	uint16_t ElapsedFrames = ((CurrentFrame - AudioInterfaceInfo->State.PeriodStartFrame) & AUDIO_FRAMENUMBER_MASK);
+
+	if (ElapsedFrames < RefreshFrames)
+	  return;
+
+	/* Discard the measurement if the period overran badly, e.g. across a suspend, rather than report a bogus rate */
+	if (ElapsedFrames < (RefreshFrames << 1))
+	  AudioInterfaceInfo->State.FeedbackValue = ((AudioInterfaceInfo->State.SampleCount << 14) / ElapsedFrames);
+
+	AudioInterfaceInfo->State.PeriodStartFrame = CurrentFrame;
+	AudioInterfaceInfo->State.SampleCount      = 0;
+}
+
+uint16_t Audio_Device_ReadPacket8(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+                                  int8_t* Samples,
+                                  const uint16_t MaxSamples)
+{
+	if (!(Audio_Device_IsSampleReceived(AudioInterfaceInfo)))
+	  return 0;
+
+	uint16_t SamplesInPacket = Endpoint_BytesInEndpoint();
+
+	if (SamplesInPacket > MaxSamples)
+	  SamplesInPacket = MaxSamples;
+
+	for (uint16_t i = 0; i < SamplesInPacket; i++)
+	  *(Samples++) = Endpoint_Read_8();
+
+	Endpoint_ClearOUT();
+
+	return SamplesInPacket;
+}
+
+uint16_t Audio_Device_ReadPacket16(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+                                   int16_t* Samples,
+                                   const uint16_t MaxSamples)
+{
+	if (!(Audio_Device_IsSampleReceived(AudioInterfaceInfo)))
+	  return 0;
+
+	uint16_t SamplesInPacket = (Endpoint_BytesInEndpoint() / sizeof(int16_t));
+
+	if (SamplesInPacket > MaxSamples)
+	  SamplesInPacket = MaxSamples;
+
+	for (uint16_t i = 0; i < SamplesInPacket; i++)
+	  *(Samples++) = (int16_t)Endpoint_Read_16_LE();
+
+	Endpoint_ClearOUT();
+
+	return SamplesInPacket;
+}
+
+uint16_t Audio_Device_ReadPacket24(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+                                   int32_t* Samples,
+                                   const uint16_t MaxSamples)
+{
+	if (!(Audio_Device_IsSampleReceived(AudioInterfaceInfo)))
+	  return 0;
+
+	uint16_t SamplesInPacket = (Endpoint_BytesInEndpoint() / 3);
+
+	if (SamplesInPacket > MaxSamples)
+	  SamplesInPacket = MaxSamples;
+
+	for (uint16_t i = 0; i < SamplesInPacket; i++)
+	{
+		uint32_t Sample = Endpoint_Read_16_LE();
+		uint8_t  Upper  = Endpoint_Read_8();
+
+		/* Sign extend the packed sample from its most significant byte */
+		Sample |= ((uint32_t)Upper << 16);
+		if (Upper & 0x80)
+		  Sample |= 0xFF000000UL;
+
+		*(Samples++) = (int32_t)Sample;
+	}
+
+	Endpoint_ClearOUT();
+
+	return SamplesInPacket;
+}
+
+uint16_t Audio_Device_WritePacket8(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+                                   const int8_t* Samples,
+                                   const uint16_t TotalSamples)
+{
+	if (!(Audio_Device_IsReadyForNextSample(AudioInterfaceInfo)))
+	  return 0;
+
+	uint16_t SamplesInPacket = (AudioInterfaceInfo->Config.DataINEndpoint.Size - Endpoint_BytesInEndpoint());
+
+	if (SamplesInPacket > TotalSamples)
+	  SamplesInPacket = TotalSamples;
+
+	for (uint16_t i = 0; i < SamplesInPacket; i++)
+	  Endpoint_Write_8(*(Samples++));
+
+	Endpoint_ClearIN();
+
+	return SamplesInPacket;
+}
+
+uint16_t Audio_Device_WritePacket16(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+                                    const int16_t* Samples,
+                                    const uint16_t TotalSamples)
+{
+	if (!(Audio_Device_IsReadyForNextSample(AudioInterfaceInfo)))
+	  return 0;
+
+	uint16_t SamplesInPacket = ((AudioInterfaceInfo->Config.DataINEndpoint.Size - Endpoint_BytesInEndpoint()) / sizeof(int16_t));
+
+	if (SamplesInPacket > TotalSamples)
+	  SamplesInPacket = TotalSamples;
+
+	for (uint16_t i = 0; i < SamplesInPacket; i++)
+	  Endpoint_Write_16_LE(*(Samples++));
+
+	Endpoint_ClearIN();
+
+	return SamplesInPacket;
+}
+
+uint16_t Audio_Device_WritePacket24(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+                                    const int32_t* Samples,
+                                    const uint16_t TotalSamples)
+{
+	if (!(Audio_Device_IsReadyForNextSample(AudioInterfaceInfo)))
+	  return 0;
+
+	uint16_t SamplesInPacket = ((AudioInterfaceInfo->Config.DataINEndpoint.Size - Endpoint_BytesInEndpoint()) / 3);
+
+	if (SamplesInPacket > TotalSamples)
+	  SamplesInPacket = TotalSamples;
+
+	for (uint16_t i = 0; i < SamplesInPacket; i++)
+	{
+		int32_t Sample = *(Samples++);
+
+		Endpoint_Write_16_LE(Sample);
+		Endpoint_Write_8(Sample >> 16);
+	}
+
+	Endpoint_ClearIN();
+
+	return SamplesInPacket;
+}
+
 // cppcheck-suppress unusedFunction
 void Audio_Device_Event_Stub(void)
 {
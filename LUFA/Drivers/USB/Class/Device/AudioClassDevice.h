@@ -47,6 +47,17 @@
  *  \section Sec_ModDescription Module Description
  *  Device Mode USB Class driver framework interface, for the Audio 1.0 USB Class driver.
  *
+ *  Audio samples may be moved either one at a time from a sample clock ISR via the \c Audio_Device_ReadSample*()
+ *  and \c Audio_Device_WriteSample*() functions, or a whole isochronous packet (one USB frame's worth of interleaved
+ *  samples) at a time into or out of an application buffer via the \c Audio_Device_ReadPacket*() and
+ *  \c Audio_Device_WritePacket*() functions, which unpack and pack the little endian samples in a single tight loop.
+ *
+ *  Devices which play an OUT stream from their own sample clock should declare their streaming endpoint as
+ *  asynchronous and supply an isochronous feedback IN endpoint in the driver's configuration. The driver then
+ *  measures the number of samples consumed by the application (reported via \ref Audio_Device_CountSamples())
+ *  against the bus Start Of Frame packets, and reports the measured rate to the host so that it can adjust the
+ *  size of the packets it sends to match the device's clock.
+ *
  *  @{
  */
 
@@ -88,6 +99,15 @@
 
 					USB_Endpoint_Table_t DataINEndpoint; /**< Data IN endpoint configuration table. */
 					USB_Endpoint_Table_t DataOUTEndpoint; /**< Data OUT endpoint configuration table. */
+
+					USB_Endpoint_Table_t FeedbackEndpoint; /**< Optional isochronous feedback IN endpoint configuration table, for
+					                                        *   asynchronous OUT streams. Leave the address as zero if unused.
+					                                        */
+					uint8_t              FeedbackRefresh; /**< Exponent of the feedback endpoint's refresh period, in frames, as given
+					                                       *   in the endpoint descriptor's \c Refresh field (e.g. 5 for 32ms). Full speed
+					                                       *   feedback endpoints must use a value between 1 (2ms) and 9 (512ms); values
+					                                       *   outside this range are clamped to it when the endpoints are configured.
+					                                       */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */
@@ -96,6 +116,13 @@
 					bool InterfaceEnabled; /**< Set and cleared by the class driver to indicate if the host has enabled the streaming endpoints
 					                        *   of the Audio Streaming interface.
 					                        */
+
+					uint32_t FeedbackValue; /**< Current stream rate reported to the host through the feedback endpoint, in samples
+					                         *   per frame in 10.14 fixed point format, or zero if no rate is yet known.
+					                         */
+					uint32_t SampleCount; /**< Number of samples consumed in the current feedback measurement period. */
+					uint16_t PeriodStartFrame; /**< Bus frame number at the start of the current feedback measurement period. */
+					bool     PeriodStarted; /**< Indicates if a feedback measurement period is currently in progress. */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 				          *   are reset to their defaults when the interface is enumerated.
 				          */
@@ -119,6 +146,110 @@
 			 */
 			void Audio_Device_ProcessControlRequest(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 
+			/** General management task for a given Audio class interface, required for the correct operation of the interface. This should
+			 *  be called frequently in the main program loop, before the master USB management task \ref USB_USBTask(). When the interface
+			 *  has a feedback endpoint, this queues the current measured stream rate for the host each time the endpoint bank is free.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class configuration and state.
+			 */
+			void Audio_Device_USBTask(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Updates the stream rate measurement of a given Audio interface's feedback endpoint. This should be linked to the
+			 *  library \ref EVENT_USB_Device_StartOfFrame() event, which must be enabled via \ref USB_Device_EnableSOFEvents(),
+			 *  on devices with a feedback endpoint.
+			 *
+			 *  Once every refresh period the number of samples counted via \ref Audio_Device_CountSamples() is divided by the
+			 *  number of bus frames elapsed according to the frame counter, so that missed Start Of Frame events do not skew
+			 *  the result, and the quotient becomes the new value reported to the host.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class configuration and state.
+			 */
+			void Audio_Device_ProcessStartOfFrame(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Reads a complete isochronous packet of interleaved 8-bit samples from the streaming OUT endpoint of the given
+			 *  Audio interface, if one has been received. Any samples in the packet beyond \c MaxSamples are discarded, and
+			 *  the endpoint bank is released for the next packet.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class configuration and state.
+			 *  \param[out]    Samples             Pointer to a buffer where the received samples are to be stored.
+			 *  \param[in]     MaxSamples          Maximum number of samples to store into the buffer.
+			 *
+			 *  \return Number of samples stored into the buffer, or zero if no packet was available.
+			 */
+			uint16_t Audio_Device_ReadPacket8(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+			                                  int8_t* Samples,
+			                                  const uint16_t MaxSamples) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Reads a complete isochronous packet of interleaved 16-bit samples from the streaming OUT endpoint of the given
+			 *  Audio interface, if one has been received. Any samples in the packet beyond \c MaxSamples are discarded, and
+			 *  the endpoint bank is released for the next packet.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class configuration and state.
+			 *  \param[out]    Samples             Pointer to a buffer where the received samples are to be stored.
+			 *  \param[in]     MaxSamples          Maximum number of samples to store into the buffer.
+			 *
+			 *  \return Number of samples stored into the buffer, or zero if no packet was available.
+			 */
+			uint16_t Audio_Device_ReadPacket16(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+			                                   int16_t* Samples,
+			                                   const uint16_t MaxSamples) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Reads a complete isochronous packet of interleaved, packed 3-byte 24-bit samples from the streaming OUT endpoint
+			 *  of the given Audio interface, if one has been received. Each sample is sign extended to 32 bits. Any samples in
+			 *  the packet beyond \c MaxSamples are discarded, and the endpoint bank is released for the next packet.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class configuration and state.
+			 *  \param[out]    Samples             Pointer to a buffer where the received samples are to be stored.
+			 *  \param[in]     MaxSamples          Maximum number of samples to store into the buffer.
+			 *
+			 *  \return Number of samples stored into the buffer, or zero if no packet was available.
+			 */
+			uint16_t Audio_Device_ReadPacket24(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+			                                   int32_t* Samples,
+			                                   const uint16_t MaxSamples) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Writes an isochronous packet of interleaved 8-bit samples to the streaming IN endpoint of the given Audio interface,
+			 *  if the endpoint is ready for the next packet. As many samples as fit into the endpoint bank are sent; the caller
+			 *  should supply one frame's worth of samples per call.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class configuration and state.
+			 *  \param[in]     Samples             Pointer to a buffer containing the samples to send.
+			 *  \param[in]     TotalSamples        Number of samples in the buffer.
+			 *
+			 *  \return Number of samples sent from the buffer, or zero if the endpoint was not ready.
+			 */
+			uint16_t Audio_Device_WritePacket8(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+			                                   const int8_t* Samples,
+			                                   const uint16_t TotalSamples) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Writes an isochronous packet of interleaved 16-bit samples to the streaming IN endpoint of the given Audio interface,
+			 *  if the endpoint is ready for the next packet. As many samples as fit into the endpoint bank are sent; the caller
+			 *  should supply one frame's worth of samples per call.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class configuration and state.
+			 *  \param[in]     Samples             Pointer to a buffer containing the samples to send.
+			 *  \param[in]     TotalSamples        Number of samples in the buffer.
+			 *
+			 *  \return Number of samples sent from the buffer, or zero if the endpoint was not ready.
+			 */
+			uint16_t Audio_Device_WritePacket16(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+			                                    const int16_t* Samples,
+			                                    const uint16_t TotalSamples) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Writes an isochronous packet of interleaved 24-bit samples to the streaming IN endpoint of the given Audio interface,
+			 *  if the endpoint is ready for the next packet. Each sample is packed into three bytes. As many samples as fit into the
+			 *  endpoint bank are sent; the caller should supply one frame's worth of samples per call.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class configuration and state.
+			 *  \param[in]     Samples             Pointer to a buffer containing the samples to send.
+			 *  \param[in]     TotalSamples        Number of samples in the buffer.
+			 *
+			 *  \return Number of samples sent from the buffer, or zero if the endpoint was not ready.
+			 */
+			uint16_t Audio_Device_WritePacket24(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+			                                    const int32_t* Samples,
+			                                    const uint16_t TotalSamples) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
 			/** Audio class driver callback for the setting and retrieval of streaming endpoint properties. This callback must be implemented
 			 *  in the user application to handle property manipulations on streaming audio endpoints.
 			 *
@@ -186,16 +317,43 @@
 			void EVENT_Audio_Device_StreamStartStop(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo);
 
 		/* Inline Functions: */
-			/** General management task for a given Audio class interface, required for the correct operation of the interface. This should
-			 *  be called frequently in the main program loop, before the master USB management task \ref USB_USBTask().
+			/** Adds to the number of samples consumed (for an OUT stream) by the given Audio interface's sample clock, for the
+			 *  measurement of the rate reported through the interface's feedback endpoint. This should be called from the
+			 *  application's sample clock ISR each time a sample (one per channel set) is played.
+			 *
+			 *  \note As the count is updated from the Start Of Frame event, this must be called either from an ISR or with
+			 *        global interrupts disabled.
 			 *
 			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class configuration and state.
+			 *  \param[in]     Samples             Number of samples consumed since the last call.
 			 */
-			static inline void Audio_Device_USBTask(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo)
-			                                        ATTR_NON_NULL_PTR_ARG(1) ATTR_ALWAYS_INLINE;
-			static inline void Audio_Device_USBTask(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo)
+			static inline void Audio_Device_CountSamples(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+			                                             const uint8_t Samples) ATTR_NON_NULL_PTR_ARG(1) ATTR_ALWAYS_INLINE;
+			static inline void Audio_Device_CountSamples(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+			                                             const uint8_t Samples)
 			{
-				(void)AudioInterfaceInfo;
+				AudioInterfaceInfo->State.SampleCount += Samples;
+			}
+
+			/** Sets the nominal sampling frequency of the given Audio interface's stream, reported through the feedback endpoint
+			 *  until the first measurement period completes. This should be called each time the host changes the sampling
+			 *  frequency of the stream, as it also restarts the rate measurement.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class configuration and state.
+			 *  \param[in]     SampleRate          New nominal sampling frequency of the stream, in Hz.
+			 */
+			static inline void Audio_Device_SetNominalSampleRate(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+			                                                     const uint32_t SampleRate) ATTR_NON_NULL_PTR_ARG(1);
+			static inline void Audio_Device_SetNominalSampleRate(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo,
+			                                                     const uint32_t SampleRate)
+			{
+				uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+				GlobalInterruptDisable();
+
+				AudioInterfaceInfo->State.FeedbackValue = AUDIO_FEEDBACK_VALUE(SampleRate);
+				AudioInterfaceInfo->State.PeriodStarted = false;
+
+				SetGlobalInterruptMask(CurrentGlobalInt);
 			}
 
 			/** Determines if the given audio interface is ready for a sample to be read from it, and selects the streaming
@@ -307,7 +465,8 @@
 
 				(void)AudioInterfaceInfo;
 
-				Sample = (((uint32_t)Endpoint_Read_8() << 16) | Endpoint_Read_16_LE());
+				Sample  = Endpoint_Read_16_LE();
+				Sample |= ((int32_t)(int8_t)Endpoint_Read_8() << 16);
 
 				if (!(Endpoint_BytesInEndpoint()))
 				  Endpoint_ClearOUT();
@@ -375,12 +534,27 @@
 
 	/* Private Interface - For use in library only: */
 	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define AUDIO_FRAMENUMBER_MASK      0x07FF
+
+			#define AUDIO_FEEDBACK_REFRESH_MIN  1
+			#define AUDIO_FEEDBACK_REFRESH_MAX  9
+
 		/* Function Prototypes: */
 			#if defined(__INCLUDE_FROM_AUDIO_DEVICE_C)
-				void Audio_Device_Event_Stub(void) ATTR_CONST;
+				void Audio_Device_Event_Stub(void);
+
+				#if (__GNUC__ >= 8)
+					#pragma GCC diagnostic push
+					#pragma GCC diagnostic ignored "-Wattribute-alias"
+				#endif
 
 				void EVENT_Audio_Device_StreamStartStop(USB_ClassInfo_Audio_Device_t* const AudioInterfaceInfo)
 				                                        ATTR_WEAK ATTR_NON_NULL_PTR_ARG(1) ATTR_ALIAS(Audio_Device_Event_Stub);
+
+				#if (__GNUC__ >= 8)
+					#pragma GCC diagnostic pop
+				#endif
 			#endif
 
 	#endif
@@ -50,17 +50,17 @@ void CDC_Device_ProcessControlRequest(USB_ClassInfo_CDC_Device_t* const CDCInter
 		case CDC_REQ_GetLineEncoding:
 			if (USB_ControlRequest.bmRequestType == (REQDIR_DEVICETOHOST | REQTYPE_CLASS | REQREC_INTERFACE))
 			{
-				Endpoint_ClearSETUP();
-
-				while (!(Endpoint_IsINReady()));
+				CDC_LineEncoding_t LineEncoding =
+					{
+						.BaudRateBPS = cpu_to_le32(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS),
+						.CharFormat  = CDCInterfaceInfo->State.LineEncoding.CharFormat,
+						.ParityType  = CDCInterfaceInfo->State.LineEncoding.ParityType,
+						.DataBits    = CDCInterfaceInfo->State.LineEncoding.DataBits,
+					};
 
-				Endpoint_Write_32_LE(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS);
-				Endpoint_Write_8(CDCInterfaceInfo->State.LineEncoding.CharFormat);
-				Endpoint_Write_8(CDCInterfaceInfo->State.LineEncoding.ParityType);
-				Endpoint_Write_8(CDCInterfaceInfo->State.LineEncoding.DataBits);
+				Endpoint_ClearSETUP();
 
-				Endpoint_ClearIN();
-				Endpoint_ClearStatusStage();
+				USB_Device_SendControlData(&LineEncoding, sizeof(CDC_LineEncoding_t), NULL, NULL);
 			}
 
 			break;
@@ -69,21 +69,7 @@ void CDC_Device_ProcessControlRequest(USB_ClassInfo_CDC_Device_t* const CDCInter
 			{
 				Endpoint_ClearSETUP();
 
-				while (!(Endpoint_IsOUTReceived()))
-				{
-					if (USB_DeviceState == DEVICE_STATE_Unattached)
-					  return;
-				}
-				
-				CDCInterfaceInfo->State.LineEncoding.BaudRateBPS = Endpoint_Read_32_LE();
-				CDCInterfaceInfo->State.LineEncoding.CharFormat  = Endpoint_Read_8();
-				CDCInterfaceInfo->State.LineEncoding.ParityType  = Endpoint_Read_8();
-				CDCInterfaceInfo->State.LineEncoding.DataBits    = Endpoint_Read_8();
-
-				Endpoint_ClearOUT();
-				Endpoint_ClearStatusStage();
-
-				EVENT_CDC_Device_LineEncodingChanged(CDCInterfaceInfo);
+				USB_Device_ReceiveControlData(NULL, sizeof(CDC_LineEncoding_t), CDC_Device_LineEncodingReceived, CDCInterfaceInfo);
 			}
 
 			break;
@@ -91,7 +77,7 @@ void CDC_Device_ProcessControlRequest(USB_ClassInfo_CDC_Device_t* const CDCInter
 			if (USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE))
 			{
 				Endpoint_ClearSETUP();
-				Endpoint_ClearStatusStage();
+				USB_Device_AcknowledgeControlRequest(NULL, NULL);
 
 				CDCInterfaceInfo->State.ControlLineStates.HostToDevice = USB_ControlRequest.wValue;
 
@@ -103,7 +89,7 @@ void CDC_Device_ProcessControlRequest(USB_ClassInfo_CDC_Device_t* const CDCInter
 			if (USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE))
 			{
 				Endpoint_ClearSETUP();
-				Endpoint_ClearStatusStage();
+				USB_Device_AcknowledgeControlRequest(NULL, NULL);
 
 				EVENT_CDC_Device_BreakSent(CDCInterfaceInfo, (uint8_t)USB_ControlRequest.wValue);
 			}
@@ -112,6 +98,23 @@ void CDC_Device_ProcessControlRequest(USB_ClassInfo_CDC_Device_t* const CDCInter
 	}
 }
 
+static void CDC_Device_LineEncodingReceived(void* const Context,
+                                            const uint8_t ErrorCode)
+{
+	USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo = (USB_ClassInfo_CDC_Device_t*)Context;
+	CDC_LineEncoding_t*               LineEncoding     = (CDC_LineEncoding_t*)USB_Device_GetControlData();
+
+	if (ErrorCode != ENDPOINT_RWCSTREAM_NoError)
+	  return;
+
+	CDCInterfaceInfo->State.LineEncoding.BaudRateBPS = le32_to_cpu(LineEncoding->BaudRateBPS);
+	CDCInterfaceInfo->State.LineEncoding.CharFormat  = LineEncoding->CharFormat;
+	CDCInterfaceInfo->State.LineEncoding.ParityType  = LineEncoding->ParityType;
+	CDCInterfaceInfo->State.LineEncoding.DataBits    = LineEncoding->DataBits;
+
+	EVENT_CDC_Device_LineEncodingChanged(CDCInterfaceInfo);
+}
+
 bool CDC_Device_ConfigureEndpoints(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
 {
 	memset(&CDCInterfaceInfo->State, 0x00, sizeof(CDCInterfaceInfo->State));
@@ -137,20 +140,128 @@ void CDC_Device_USBTask(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
 	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
 	  return;
 
+	if (CDCInterfaceInfo->Config.TXBuffer || CDCInterfaceInfo->Config.RXBuffer)
+	  CDC_Device_ProcessBuffers(CDCInterfaceInfo);
+
 	#if !defined(NO_CLASS_DRIVER_AUTOFLUSH)
-	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
-	
-	if (Endpoint_IsINReady())
-	  CDC_Device_Flush(CDCInterfaceInfo);
+	if (!(CDCInterfaceInfo->Config.TXBuffer))
+	{
+		Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
+
+		if (Endpoint_IsINReady())
+		  CDC_Device_Flush(CDCInterfaceInfo);
+	}
 	#endif
 }
 
+static void CDC_Device_ProcessBuffers(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+{
+	RingBuffer_t* TXBuffer = CDCInterfaceInfo->Config.TXBuffer;
+	RingBuffer_t* RXBuffer = CDCInterfaceInfo->Config.RXBuffer;
+
+	/* Preserve the selected endpoint, as this may be called from the SOF interrupt while another endpoint is in use */
+	uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
+
+	if (TXBuffer != NULL)
+	{
+		uint16_t BytesToSend = RingBuffer_GetCount(TXBuffer);
+
+		if (BytesToSend > CDCInterfaceInfo->Config.TXLowWatermark)
+		  CDCInterfaceInfo->State.TXBufferAboveLow = true;
+
+		Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
+
+		while (BytesToSend && Endpoint_IsINReady())
+		{
+			while (BytesToSend && Endpoint_IsReadWriteAllowed())
+			{
+				Endpoint_Write_8(RingBuffer_Remove(TXBuffer));
+				BytesToSend--;
+			}
+
+			if (!(Endpoint_IsReadWriteAllowed()))
+			{
+				Endpoint_ClearIN();
+				CDCInterfaceInfo->State.TXLastBankFull = true;
+			}
+		}
+
+		/* Send any partially filled bank once the buffer is empty, or a zero length packet to terminate the transfer
+		 * if the last bank sent was full - this may be deferred to a later call if the endpoint is not yet ready */
+		if (!(BytesToSend) && Endpoint_IsINReady() && (Endpoint_BytesInEndpoint() || CDCInterfaceInfo->State.TXLastBankFull))
+		{
+			Endpoint_ClearIN();
+			CDCInterfaceInfo->State.TXLastBankFull = false;
+		}
+
+		if (CDCInterfaceInfo->State.TXBufferAboveLow &&
+		    (RingBuffer_GetCount(TXBuffer) <= CDCInterfaceInfo->Config.TXLowWatermark))
+		{
+			CDCInterfaceInfo->State.TXBufferAboveLow = false;
+			EVENT_CDC_Device_TXBufferLow(CDCInterfaceInfo);
+		}
+	}
+
+	if (RXBuffer != NULL)
+	{
+		Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+		while (Endpoint_IsOUTReceived())
+		{
+			uint16_t BytesToReceive = MIN(Endpoint_BytesInEndpoint(), RingBuffer_GetFreeCount(RXBuffer));
+
+			while (BytesToReceive--)
+			  RingBuffer_Insert(RXBuffer, Endpoint_Read_8());
+
+			/* Leave any data that does not fit in the buffer in the bank, so that the host is held off until it is read */
+			if (Endpoint_BytesInEndpoint())
+			  break;
+
+			Endpoint_ClearOUT();
+		}
+
+		if (CDCInterfaceInfo->Config.RXHighWatermark &&
+		    (RingBuffer_GetCount(RXBuffer) >= CDCInterfaceInfo->Config.RXHighWatermark))
+		{
+			if (!(CDCInterfaceInfo->State.RXBufferAboveHigh))
+			{
+				CDCInterfaceInfo->State.RXBufferAboveHigh = true;
+				EVENT_CDC_Device_RXBufferHigh(CDCInterfaceInfo);
+			}
+		}
+		else
+		{
+			CDCInterfaceInfo->State.RXBufferAboveHigh = false;
+		}
+	}
+
+	Endpoint_SelectEndpoint(PrevSelectedEndpoint);
+}
+
+static uint8_t CDC_Device_QueueData(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
+                                    const char* Buffer,
+                                    uint16_t Length)
+{
+	RingBuffer_t* TXBuffer = CDCInterfaceInfo->Config.TXBuffer;
+
+	if (RingBuffer_GetFreeCount(TXBuffer) < Length)
+	  return ENDPOINT_RWSTREAM_IncompleteTransfer;
+
+	while (Length--)
+	  RingBuffer_Insert(TXBuffer, *(Buffer++));
+
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
 uint8_t CDC_Device_SendString(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
                               const char* const String)
 {
 	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
 	  return ENDPOINT_RWSTREAM_DeviceDisconnected;
 
+	if (CDCInterfaceInfo->Config.TXBuffer)
+	  return CDC_Device_QueueData(CDCInterfaceInfo, String, strlen(String));
+
 	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
 	return Endpoint_Write_Stream_LE(String, strlen(String), NULL);
 }
@@ -162,6 +273,9 @@ uint8_t CDC_Device_SendData(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
 	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
 	  return ENDPOINT_RWSTREAM_DeviceDisconnected;
 
+	if (CDCInterfaceInfo->Config.TXBuffer)
+	  return CDC_Device_QueueData(CDCInterfaceInfo, Buffer, Length);
+
 	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
 	return Endpoint_Write_Stream_LE(Buffer, Length, NULL);
 }
@@ -172,6 +286,15 @@ uint8_t CDC_Device_SendByte(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
 	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
 	  return ENDPOINT_RWSTREAM_DeviceDisconnected;
 
+	if (CDCInterfaceInfo->Config.TXBuffer)
+	{
+		if (RingBuffer_IsFull(CDCInterfaceInfo->Config.TXBuffer))
+		  return ENDPOINT_READYWAIT_Timeout;
+
+		RingBuffer_Insert(CDCInterfaceInfo->Config.TXBuffer, Data);
+		return ENDPOINT_READYWAIT_NoError;
+	}
+
 	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
 
 	if (!(Endpoint_IsReadWriteAllowed()))
@@ -193,6 +316,9 @@ uint8_t CDC_Device_Flush(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
 	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
 	  return ENDPOINT_RWSTREAM_DeviceDisconnected;
 
+	if (CDCInterfaceInfo->Config.TXBuffer)
+	  return ENDPOINT_READYWAIT_NoError;
+
 	uint8_t ErrorCode;
 
 	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
@@ -220,6 +346,9 @@ uint16_t CDC_Device_BytesReceived(USB_ClassInfo_CDC_Device_t* const CDCInterface
 	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
 	  return 0;
 
+	if (CDCInterfaceInfo->Config.RXBuffer)
+	  return RingBuffer_GetCount(CDCInterfaceInfo->Config.RXBuffer);
+
 	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataOUTEndpoint.Address);
 
 	if (Endpoint_IsOUTReceived())
@@ -245,6 +374,14 @@ int16_t CDC_Device_ReceiveByte(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInf
 	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
 	  return -1;
 
+	if (CDCInterfaceInfo->Config.RXBuffer)
+	{
+		if (RingBuffer_IsEmpty(CDCInterfaceInfo->Config.RXBuffer))
+		  return -1;
+
+		return RingBuffer_Remove(CDCInterfaceInfo->Config.RXBuffer);
+	}
+
 	int16_t ReceivedByte = -1;
 
 	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataOUTEndpoint.Address);
@@ -65,6 +65,40 @@
  *        that the virtual serial line DTR (Data Terminal Ready) signal be used where possible
  *        to determine if a host application is ready for data.
  *
+ *  \section Sec_CDCDeviceBuffered Buffered Operation
+ *  By default the data transmission and reception functions of this driver operate directly on the CDC interface's
+ *  endpoint banks, and may block for up to \ref USB_STREAM_TIMEOUT_MS while waiting for the host. Alternatively, ring
+ *  buffers may be assigned to the interface's \c Config.TXBuffer and \c Config.RXBuffer elements, in which case the
+ *  interface operates in a buffered mode; data to send is queued into the transmit buffer and received data is read
+ *  from the receive buffer, with the buffers drained into and filled from the endpoints by \ref CDC_Device_USBTask().
+ *  In this mode none of the driver's data functions will ever wait on the host.
+ *
+ *  As \ref CDC_Device_USBTask() never blocks in buffered mode, it may be called from the \ref EVENT_USB_Device_StartOfFrame()
+ *  event (once Start Of Frame events have been enabled via \ref USB_Device_EnableSOFEvents()) so that the buffers are
+ *  serviced from the USB interrupt once per millisecond instead of the main program loop. In this case it must not also be
+ *  called from the main program loop, as each buffer must only be drained and filled from a single execution context.
+ *
+ *  \code
+ *      static RingBuffer_t CDC_TXBuffer, CDC_RXBuffer;
+ *      static uint8_t      CDC_TXBufferData[128], CDC_RXBufferData[128];
+ *
+ *      USB_ClassInfo_CDC_Device_t VirtualSerial_CDC_Interface =
+ *          {
+ *              .Config =
+ *                  {
+ *                      // Endpoint configuration as usual, plus:
+ *                      .TXBuffer        = &CDC_TXBuffer,
+ *                      .RXBuffer        = &CDC_RXBuffer,
+ *                      .TXLowWatermark  = 16,
+ *                      .RXHighWatermark = 96,
+ *                  },
+ *          };
+ *
+ *      // During startup, before the interface is configured
+ *      RingBuffer_InitBuffer(&CDC_TXBuffer, CDC_TXBufferData, sizeof(CDC_TXBufferData));
+ *      RingBuffer_InitBuffer(&CDC_RXBuffer, CDC_RXBufferData, sizeof(CDC_RXBufferData));
+ *  \endcode
+ *
  *  @{
  */
 
@@ -74,6 +108,7 @@
 	/* Includes: */
 		#include "../../USB.h"
 		#include "../Common/CDCClassCommon.h"
+		#include "../../../Misc/RingBuffer.h"
 
 		#include <stdio.h>
 
@@ -104,8 +139,22 @@
 					USB_Endpoint_Table_t DataINEndpoint; /**< Data IN endpoint configuration table. */
 					USB_Endpoint_Table_t DataOUTEndpoint; /**< Data OUT endpoint configuration table. */
 					USB_Endpoint_Table_t NotificationEndpoint; /**< Notification IN Endpoint configuration table. */
+
+					RingBuffer_t* TXBuffer; /**< Optional initialized ring buffer used to queue data for transmission to the host. If
+					                         *   set, the data transmission functions operate in buffered mode, see \ref Sec_CDCDeviceBuffered.
+					                         */
+					RingBuffer_t* RXBuffer; /**< Optional initialized ring buffer used to hold data received from the host. If set,
+					                         *   the data reception functions operate in buffered mode, see \ref Sec_CDCDeviceBuffered.
+					                         */
+					uint16_t TXLowWatermark; /**< Number of bytes in the transmit buffer at or below which, once the buffer has been
+					                          *   drained from a higher level, the \ref EVENT_CDC_Device_TXBufferLow() event is fired.
+					                          */
+					uint16_t RXHighWatermark; /**< Number of bytes in the receive buffer at or above which the
+					                           *   \ref EVENT_CDC_Device_RXBufferHigh() event is fired, or zero to disable the event.
+					                           */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
-				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
+				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly, except
+				           *   for the buffered mode elements which may be left zeroed if buffered mode is not used.
 				           */
 				struct
 				{
@@ -124,6 +173,16 @@
 					                                  *  This is generally only used if the virtual serial port data is to be
 					                                  *  reconstructed on a physical UART.
 					                                  */
+
+					bool TXBufferAboveLow; /**< Indicates if the transmit buffer has been filled above its low watermark since the
+					                        *   last \ref EVENT_CDC_Device_TXBufferLow() event, for internal use by the driver.
+					                        */
+					bool RXBufferAboveHigh; /**< Indicates if the \ref EVENT_CDC_Device_RXBufferHigh() event has been fired since the
+					                         *   receive buffer last fell below its high watermark, for internal use by the driver.
+					                         */
+					bool TXLastBankFull; /**< Indicates if the last IN bank sent from the transmit buffer was full, so that a zero
+					                      *   length packet is still owed to terminate the transfer, for internal use by the driver.
+					                      */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 				          *   are reset to their defaults when the interface is enumerated.
 				          */
@@ -150,6 +209,10 @@
 			/** General management task for a given CDC class interface, required for the correct operation of the interface. This should
 			 *  be called frequently in the main program loop, before the master USB management task \ref USB_USBTask().
 			 *
+			 *  If the interface is operating in buffered mode, this task drains the transmit buffer into the data IN endpoint and fills
+			 *  the receive buffer from the data OUT endpoint without blocking, and may instead be called from the USB Start Of Frame
+			 *  event, see \ref Sec_CDCDeviceBuffered.
+			 *
 			 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class configuration and state.
 			 */
 			void CDC_Device_USBTask(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
@@ -182,11 +245,36 @@
 			void EVENT_CDC_Device_BreakSent(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
 			                                const uint8_t Duration) ATTR_NON_NULL_PTR_ARG(1);
 
+			/** CDC class driver event for the transmit buffer of a CDC interface operating in buffered mode draining to its low
+			 *  watermark. This event fires each time the number of bytes queued for transmission falls to or below the interface's
+			 *  \c Config.TXLowWatermark value after having been above it, and may be used to refill the buffer from the application.
+			 *
+			 *  \note This event is fired from the context \ref CDC_Device_USBTask() is called from, which may be an interrupt.
+			 *
+			 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class configuration and state.
+			 */
+			void EVENT_CDC_Device_TXBufferLow(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** CDC class driver event for the receive buffer of a CDC interface operating in buffered mode filling to its high
+			 *  watermark. This event fires each time the number of received bytes waiting to be read rises to or above the interface's
+			 *  \c Config.RXHighWatermark value after having been below it. While the receive buffer is full the host is prevented
+			 *  from sending further data, so the application should read out the buffered data promptly.
+			 *
+			 *  \note This event is fired from the context \ref CDC_Device_USBTask() is called from, which may be an interrupt.
+			 *
+			 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class configuration and state.
+			 */
+			void EVENT_CDC_Device_RXBufferHigh(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
 			/** Sends a given data buffer to the attached USB host, if connected. If a host is not connected when the function is
 			 *  called, the string is discarded. Bytes will be queued for transmission to the host until either the endpoint bank
 			 *  becomes full, or the \ref CDC_Device_Flush() function is called to flush the pending data to the host. This allows
 			 *  for multiple bytes to be packed into a single endpoint packet, increasing data throughput.
 			 *
+			 *  \note In buffered mode the data is instead queued into the transmit buffer without blocking. If there is insufficient
+			 *        free space in the buffer for the entire data, no data is queued and \ref ENDPOINT_RWSTREAM_IncompleteTransfer is
+			 *        returned.
+			 *
 			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
 			 *       the call will fail.
 			 *
@@ -205,6 +293,10 @@
 			 *  the endpoint bank becomes full, or the \ref CDC_Device_Flush() function is called to flush the pending data to
 			 *  the host. This allows for multiple bytes to be packed into a single endpoint packet, increasing data throughput.
 			 *
+			 *  \note In buffered mode the string is instead queued into the transmit buffer without blocking. If there is insufficient
+			 *        free space in the buffer for the entire string, no data is queued and \ref ENDPOINT_RWSTREAM_IncompleteTransfer
+			 *        is returned.
+			 *
 			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
 			 *       the call will fail.
 			 *
@@ -221,6 +313,9 @@
 			 *  \ref CDC_Device_Flush() function is called to flush the pending data to the host. This allows for multiple bytes to be
 			 *  packed into a single endpoint packet, increasing data throughput.
 			 *
+			 *  \note In buffered mode the byte is instead queued into the transmit buffer without blocking, and
+			 *        \ref ENDPOINT_READYWAIT_Timeout is returned if the buffer is full.
+			 *
 			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
 			 *       the call will fail.
 			 *
@@ -237,6 +332,8 @@
 			 *  succeed immediately. If multiple bytes are to be received, they should be buffered by the user application, as the endpoint
 			 *  bank will not be released back to the USB controller until all bytes are read.
 			 *
+			 *  \note In buffered mode, this instead returns the number of bytes waiting in the receive buffer.
+			 *
 			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
 			 *       the call will fail.
 			 *
@@ -251,6 +348,8 @@
 			 *  bytes are currently buffered in the CDC interface's data receive endpoint bank, and thus how many repeated calls to this
 			 *  function which are guaranteed to succeed.
 			 *
+			 *  \note In buffered mode, bytes are instead read from the receive buffer.
+			 *
 			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
 			 *       the call will fail.
 			 *
@@ -261,6 +360,9 @@
 			int16_t CDC_Device_ReceiveByte(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 
 			/** Flushes any data waiting to be sent, ensuring that the send buffer is cleared.
+			 *
+			 *  \note In buffered mode, queued data is flushed to the host automatically as the transmit buffer is drained by
+			 *        \ref CDC_Device_USBTask(), and this function has no effect.
 			 *
 			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or
 			 *       the call will fail.
@@ -328,7 +430,20 @@
 				static int CDC_Device_getchar_Blocking(FILE* Stream) ATTR_NON_NULL_PTR_ARG(1);
 				#endif
 
-				void CDC_Device_Event_Stub(void) ATTR_CONST;
+				static void CDC_Device_ProcessBuffers(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+				static void CDC_Device_LineEncodingReceived(void* const Context,
+				                                            const uint8_t ErrorCode) ATTR_NON_NULL_PTR_ARG(1);
+				static uint8_t CDC_Device_QueueData(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
+				                                    const char* Buffer,
+				                                    uint16_t Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+				void CDC_Device_Event_Stub(void);
+
+				/* The event stub is shared between events of different prototypes, which newer compilers warn about */
+				#if (__GNUC__ >= 8)
+					#pragma GCC diagnostic push
+					#pragma GCC diagnostic ignored "-Wattribute-alias"
+				#endif
 
 				void EVENT_CDC_Device_LineEncodingChanged(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
 				                                          ATTR_WEAK ATTR_NON_NULL_PTR_ARG(1) ATTR_ALIAS(CDC_Device_Event_Stub);
@@ -337,6 +452,14 @@
 				void EVENT_CDC_Device_BreakSent(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo,
 				                                const uint8_t Duration) ATTR_WEAK ATTR_NON_NULL_PTR_ARG(1)
 				                                ATTR_ALIAS(CDC_Device_Event_Stub);
+				void EVENT_CDC_Device_TXBufferLow(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+				                                  ATTR_WEAK ATTR_NON_NULL_PTR_ARG(1) ATTR_ALIAS(CDC_Device_Event_Stub);
+				void EVENT_CDC_Device_RXBufferHigh(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+				                                   ATTR_WEAK ATTR_NON_NULL_PTR_ARG(1) ATTR_ALIAS(CDC_Device_Event_Stub);
+
+				#if (__GNUC__ >= 8)
+					#pragma GCC diagnostic pop
+				#endif
 			#endif
 
 	#endif
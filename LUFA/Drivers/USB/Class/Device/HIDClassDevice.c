@@ -68,8 +68,17 @@ void HID_Device_ProcessControlRequest(USB_ClassInfo_HID_Device_t* const HIDInter
 				Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
 
 				Endpoint_ClearSETUP();
-				Endpoint_Write_Control_Stream_LE(ReportData, ReportSize);
-				Endpoint_ClearOUT();
+
+				/* Short reports are copied by the non-blocking control transfer, larger ones must be sent from the stack */
+				if (ReportSize <= USB_DEVICE_CONTROL_BUFFER_SIZE)
+				{
+					USB_Device_SendControlData(ReportData, ReportSize, NULL, NULL);
+				}
+				else
+				{
+					Endpoint_Write_Control_Stream_LE(ReportData, ReportSize);
+					Endpoint_ClearOUT();
+				}
 			}
 
 			break;
@@ -77,27 +86,33 @@ void HID_Device_ProcessControlRequest(USB_ClassInfo_HID_Device_t* const HIDInter
 			if (USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE))
 			{
 				uint16_t ReportSize = USB_ControlRequest.wLength;
-				uint8_t  ReportID   = (USB_ControlRequest.wValue & 0xFF);
-				uint8_t  ReportType = (USB_ControlRequest.wValue >> 8) - 1;
-				uint8_t  ReportData[ReportSize];
 
-				Endpoint_ClearSETUP();
-				Endpoint_Read_Control_Stream_LE(ReportData, ReportSize);
-				Endpoint_ClearIN();
+				/* Short reports are received into the non-blocking control transfer buffer, larger ones onto the stack */
+				if (ReportSize <= USB_DEVICE_CONTROL_BUFFER_SIZE)
+				{
+					Endpoint_ClearSETUP();
+					USB_Device_ReceiveControlData(NULL, ReportSize, HID_Device_ReportReceived, HIDInterfaceInfo);
+				}
+				else
+				{
+					uint8_t ReportData[ReportSize];
+
+					Endpoint_ClearSETUP();
+					Endpoint_Read_Control_Stream_LE(ReportData, ReportSize);
+					Endpoint_ClearIN();
 
-				CALLBACK_HID_Device_ProcessHIDReport(HIDInterfaceInfo, ReportID, ReportType,
-				                                     &ReportData[ReportID ? 1 : 0], ReportSize - (ReportID ? 1 : 0));
+					HID_Device_ProcessReceivedReport(HIDInterfaceInfo, ReportData, ReportSize);
+				}
 			}
 
 			break;
 		case HID_REQ_GetProtocol:
 			if (USB_ControlRequest.bmRequestType == (REQDIR_DEVICETOHOST | REQTYPE_CLASS | REQREC_INTERFACE))
 			{
+				uint8_t UsingReportProtocol = HIDInterfaceInfo->State.UsingReportProtocol;
+
 				Endpoint_ClearSETUP();
-				while (!(Endpoint_IsINReady()));
-				Endpoint_Write_8(HIDInterfaceInfo->State.UsingReportProtocol);
-				Endpoint_ClearIN();
-				Endpoint_ClearStatusStage();
+				USB_Device_SendControlData(&UsingReportProtocol, sizeof(uint8_t), NULL, NULL);
 			}
 
 			break;
@@ -105,7 +120,7 @@ void HID_Device_ProcessControlRequest(USB_ClassInfo_HID_Device_t* const HIDInter
 			if (USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE))
 			{
 				Endpoint_ClearSETUP();
-				Endpoint_ClearStatusStage();
+				USB_Device_AcknowledgeControlRequest(NULL, NULL);
 
 				HIDInterfaceInfo->State.UsingReportProtocol = ((USB_ControlRequest.wValue & 0xFF) != 0x00);
 			}
@@ -115,7 +130,7 @@ void HID_Device_ProcessControlRequest(USB_ClassInfo_HID_Device_t* const HIDInter
 			if (USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE))
 			{
 				Endpoint_ClearSETUP();
-				Endpoint_ClearStatusStage();
+				USB_Device_AcknowledgeControlRequest(NULL, NULL);
 
 				HIDInterfaceInfo->State.IdleCount = ((USB_ControlRequest.wValue & 0xFF00) >> 6);
 			}
@@ -124,17 +139,37 @@ void HID_Device_ProcessControlRequest(USB_ClassInfo_HID_Device_t* const HIDInter
 		case HID_REQ_GetIdle:
 			if (USB_ControlRequest.bmRequestType == (REQDIR_DEVICETOHOST | REQTYPE_CLASS | REQREC_INTERFACE))
 			{
+				uint8_t IdleCount = (HIDInterfaceInfo->State.IdleCount >> 2);
+
 				Endpoint_ClearSETUP();
-				while (!(Endpoint_IsINReady()));
-				Endpoint_Write_8(HIDInterfaceInfo->State.IdleCount >> 2);
-				Endpoint_ClearIN();
-				Endpoint_ClearStatusStage();
+				USB_Device_SendControlData(&IdleCount, sizeof(uint8_t), NULL, NULL);
 			}
 
 			break;
 	}
 }
 
+static void HID_Device_ReportReceived(void* const Context,
+                                      const uint8_t ErrorCode)
+{
+	if (ErrorCode != ENDPOINT_RWCSTREAM_NoError)
+	  return;
+
+	HID_Device_ProcessReceivedReport((USB_ClassInfo_HID_Device_t*)Context, USB_Device_GetControlData(),
+	                                 USB_ControlRequest.wLength);
+}
+
+static void HID_Device_ProcessReceivedReport(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo,
+                                             uint8_t* const ReportData,
+                                             const uint16_t ReportSize)
+{
+	uint8_t ReportID   = (USB_ControlRequest.wValue & 0xFF);
+	uint8_t ReportType = (USB_ControlRequest.wValue >> 8) - 1;
+
+	CALLBACK_HID_Device_ProcessHIDReport(HIDInterfaceInfo, ReportID, ReportType,
+	                                     &ReportData[ReportID ? 1 : 0], ReportSize - (ReportID ? 1 : 0));
+}
+
 bool HID_Device_ConfigureEndpoints(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo)
 {
 	memset(&HIDInterfaceInfo->State, 0x00, sizeof(HIDInterfaceInfo->State));
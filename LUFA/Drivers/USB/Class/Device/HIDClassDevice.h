@@ -199,6 +199,19 @@
 				  HIDInterfaceInfo->State.IdleMSRemaining--;
 			}
 
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Function Prototypes: */
+			#if defined(__INCLUDE_FROM_HID_DEVICE_C)
+				static void HID_Device_ReportReceived(void* const Context,
+				                                      const uint8_t ErrorCode) ATTR_NON_NULL_PTR_ARG(1);
+				static void HID_Device_ProcessReceivedReport(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo,
+				                                             uint8_t* const ReportData,
+				                                             const uint16_t ReportSize) ATTR_NON_NULL_PTR_ARG(1)
+				                                             ATTR_NON_NULL_PTR_ARG(2);
+			#endif
+	#endif
+
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			}
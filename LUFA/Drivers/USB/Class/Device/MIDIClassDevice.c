@@ -124,5 +124,113 @@ bool MIDI_Device_ReceiveEventPacket(USB_ClassInfo_MIDI_Device_t* const MIDIInter
 	return true;
 }
 
+uint8_t MIDI_Device_SendEventPackets(USB_ClassInfo_MIDI_Device_t* const MIDIInterfaceInfo,
+                                     const MIDI_EventPacket_t* const Events,
+                                     const uint16_t TotalEvents)
+{
+	if (USB_DeviceState != DEVICE_STATE_Configured)
+	  return ENDPOINT_RWSTREAM_DeviceDisconnected;
+
+	uint8_t ErrorCode;
+
+	Endpoint_SelectEndpoint(MIDIInterfaceInfo->Config.DataINEndpoint.Address);
+
+	if ((ErrorCode = Endpoint_Write_Stream_LE(Events, (TotalEvents * sizeof(MIDI_EventPacket_t)), NULL)) != ENDPOINT_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearIN();
+
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+uint16_t MIDI_Device_ReceiveEventPackets(USB_ClassInfo_MIDI_Device_t* const MIDIInterfaceInfo,
+                                         MIDI_EventPacket_t* const Events,
+                                         const uint16_t MaxEvents)
+{
+	if (USB_DeviceState != DEVICE_STATE_Configured)
+	  return 0;
+
+	uint16_t TotalEvents = 0;
+
+	Endpoint_SelectEndpoint(MIDIInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+	while ((TotalEvents < MaxEvents) && Endpoint_IsReadWriteAllowed())
+	{
+		uint16_t BankEvents = (Endpoint_BytesInEndpoint() / sizeof(MIDI_EventPacket_t));
+
+		if (BankEvents > (MaxEvents - TotalEvents))
+		  BankEvents = (MaxEvents - TotalEvents);
+
+		Endpoint_Read_Stream_LE(&Events[TotalEvents], (BankEvents * sizeof(MIDI_EventPacket_t)), NULL);
+		TotalEvents += BankEvents;
+
+		/* Release the bank once emptied, discarding any trailing partial event packet */
+		if (Endpoint_BytesInEndpoint() < sizeof(MIDI_EventPacket_t))
+		  Endpoint_ClearOUT();
+	}
+
+	return TotalEvents;
+}
+
+uint8_t MIDI_Device_SendStream(USB_ClassInfo_MIDI_Device_t* const MIDIInterfaceInfo,
+                               MIDI_StreamParser_t* const Parser,
+                               const uint8_t* Buffer,
+                               uint16_t Length)
+{
+	if (USB_DeviceState != DEVICE_STATE_Configured)
+	  return ENDPOINT_RWSTREAM_DeviceDisconnected;
+
+	MIDI_EventPacket_t Events[MIDI_STREAM_CHUNK_EVENTS];
+	uint8_t            ErrorCode;
+
+	while (Length)
+	{
+		uint16_t BytesProcessed;
+		uint16_t TotalEvents = MIDI_ConvertStreamToEvents(Parser, Buffer, Length, &BytesProcessed,
+		                                                  Events, MIDI_STREAM_CHUNK_EVENTS);
+
+		Buffer += BytesProcessed;
+		Length -= BytesProcessed;
+
+		if (!(TotalEvents))
+		  continue;
+
+		if ((ErrorCode = MIDI_Device_SendEventPackets(MIDIInterfaceInfo, Events, TotalEvents)) != ENDPOINT_RWSTREAM_NoError)
+		  return ErrorCode;
+	}
+
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+uint16_t MIDI_Device_ReceiveStream(USB_ClassInfo_MIDI_Device_t* const MIDIInterfaceInfo,
+                                   MIDI_StreamWriter_t* const Writer,
+                                   uint8_t* const Buffer,
+                                   const uint16_t Length)
+{
+	if (USB_DeviceState != DEVICE_STATE_Configured)
+	  return 0;
+
+	uint16_t BytesReceived = 0;
+
+	Endpoint_SelectEndpoint(MIDIInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+	while (((Length - BytesReceived) >= 3) && Endpoint_IsReadWriteAllowed())
+	{
+		if (Endpoint_BytesInEndpoint() >= sizeof(MIDI_EventPacket_t))
+		{
+			MIDI_EventPacket_t Event;
+
+			Endpoint_Read_Stream_LE(&Event, sizeof(MIDI_EventPacket_t), NULL);
+			BytesReceived += MIDI_ConvertEventToStream(Writer, &Event, &Buffer[BytesReceived]);
+		}
+
+		if (Endpoint_BytesInEndpoint() < sizeof(MIDI_EventPacket_t))
+		  Endpoint_ClearOUT();
+	}
+
+	return BytesReceived;
+}
+
 #endif
 
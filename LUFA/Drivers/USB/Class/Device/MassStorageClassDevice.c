@@ -37,6 +37,42 @@
 #define  __INCLUDE_FROM_MASSSTORAGE_DEVICE_C
 #include "MassStorageClassDevice.h"
 
+const MS_Device_BlockDevice_t MS_Device_RAMDiskBlockDevice =
+	{
+		.ReadBlocks  = MS_Device_RAMDisk_ReadBlocks,
+		.WriteBlocks = MS_Device_RAMDisk_WriteBlocks,
+	};
+
+/** Default response to SCSI INQUIRY commands, for logical units without their own INQUIRY data. */
+static const SCSI_Inquiry_Response_t MS_Device_DefaultInquiryData =
+	{
+		.DeviceType          = 0x00,
+		.PeripheralQualifier = 0,
+
+		.Removable           = true,
+
+		.Version             = 0,
+
+		.ResponseDataFormat  = 2,
+		.NormACA             = false,
+		.TrmTsk              = false,
+		.AERC                = false,
+
+		.AdditionalLength    = 0x1F,
+
+		.SoftReset           = false,
+		.CmdQue              = false,
+		.Linked              = false,
+		.Sync                = false,
+		.WideBus16Bit        = false,
+		.WideBus32Bit        = false,
+		.RelAddr             = false,
+
+		.VendorID            = "LUFA",
+		.ProductID           = "Block Device",
+		.RevisionID          = {'0','.','0','0'},
+	};
+
 void MS_Device_ProcessControlRequest(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
 {
 	if (!(Endpoint_IsSETUPReceived()))
@@ -51,7 +87,7 @@ void MS_Device_ProcessControlRequest(USB_ClassInfo_MS_Device_t* const MSInterfac
 			if (USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE))
 			{
 				Endpoint_ClearSETUP();
-				Endpoint_ClearStatusStage();
+				USB_Device_AcknowledgeControlRequest(NULL, NULL);
 
 				MSInterfaceInfo->State.IsMassStoreReset = true;
 			}
@@ -60,11 +96,10 @@ void MS_Device_ProcessControlRequest(USB_ClassInfo_MS_Device_t* const MSInterfac
 		case MS_REQ_GetMaxLUN:
 			if (USB_ControlRequest.bmRequestType == (REQDIR_DEVICETOHOST | REQTYPE_CLASS | REQREC_INTERFACE))
 			{
+				uint8_t MaxLUN = (MSInterfaceInfo->Config.TotalLUNs - 1);
+
 				Endpoint_ClearSETUP();
-				while (!(Endpoint_IsINReady()));
-				Endpoint_Write_8(MSInterfaceInfo->Config.TotalLUNs - 1);
-				Endpoint_ClearIN();
-				Endpoint_ClearStatusStage();
+				USB_Device_SendControlData(&MaxLUN, sizeof(uint8_t), NULL, NULL);
 			}
 
 			break;
@@ -211,5 +246,531 @@ static void MS_Device_ReturnCommandStatus(USB_ClassInfo_MS_Device_t* const MSInt
 	Endpoint_ClearIN();
 }
 
+bool MS_Device_ProcessSCSICommand(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
+{
+	const MS_Device_LUN_t* LUN = &MSInterfaceInfo->Config.LUNs[MSInterfaceInfo->State.CommandBlock.LUN];
+	bool CommandSuccess        = false;
+
+	switch (MSInterfaceInfo->State.CommandBlock.SCSICommandData[0])
+	{
+		case SCSI_CMD_INQUIRY:
+			CommandSuccess = MS_Device_SCSI_Inquiry(MSInterfaceInfo, LUN);
+			break;
+		case SCSI_CMD_REQUEST_SENSE:
+			CommandSuccess = MS_Device_SCSI_RequestSense(MSInterfaceInfo);
+			break;
+		case SCSI_CMD_READ_CAPACITY_10:
+			CommandSuccess = MS_Device_SCSI_ReadCapacity10(MSInterfaceInfo, LUN);
+			break;
+		case SCSI_CMD_SERVICE_ACTION_IN_16:
+			if ((MSInterfaceInfo->State.CommandBlock.SCSICommandData[1] & 0x1F) != SCSI_SERVICE_ACTION_READ_CAPACITY_16)
+			{
+				MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+				                   SCSI_ASENSE_INVALID_FIELD_IN_CDB, SCSI_ASENSEQ_NO_QUALIFIER);
+				break;
+			}
+
+			CommandSuccess = MS_Device_SCSI_ReadCapacity16(MSInterfaceInfo, LUN);
+			break;
+		case SCSI_CMD_SEND_DIAGNOSTIC:
+			CommandSuccess = MS_Device_SCSI_SendDiagnostic(MSInterfaceInfo, LUN);
+			break;
+		case SCSI_CMD_WRITE_10:
+			CommandSuccess = MS_Device_SCSI_ReadWrite10(MSInterfaceInfo, LUN, false);
+			break;
+		case SCSI_CMD_READ_10:
+			CommandSuccess = MS_Device_SCSI_ReadWrite10(MSInterfaceInfo, LUN, true);
+			break;
+		case SCSI_CMD_MODE_SENSE_6:
+			CommandSuccess = MS_Device_SCSI_ModeSense6(MSInterfaceInfo, LUN);
+			break;
+		case SCSI_CMD_SYNCHRONIZE_CACHE_10:
+			CommandSuccess = MS_Device_SCSI_SynchronizeCache10(MSInterfaceInfo, LUN);
+			break;
+		case SCSI_CMD_UNMAP:
+			CommandSuccess = MS_Device_SCSI_Unmap(MSInterfaceInfo, LUN);
+			break;
+		case SCSI_CMD_TEST_UNIT_READY:
+			if (!(MS_Device_GetLUNTotalBlocks(LUN)))
+			{
+				MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_NOT_READY,
+				                   SCSI_ASENSE_MEDIUM_NOT_PRESENT, SCSI_ASENSEQ_NO_QUALIFIER);
+				break;
+			}
+
+			CommandSuccess = true;
+			MSInterfaceInfo->State.CommandBlock.DataTransferLength = 0;
+			break;
+		case SCSI_CMD_PREVENT_ALLOW_MEDIUM_REMOVAL:
+		case SCSI_CMD_VERIFY_10:
+			CommandSuccess = true;
+			MSInterfaceInfo->State.CommandBlock.DataTransferLength = 0;
+			break;
+		default:
+			MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+			                   SCSI_ASENSE_INVALID_COMMAND, SCSI_ASENSEQ_NO_QUALIFIER);
+			break;
+	}
+
+	if (CommandSuccess)
+	{
+		MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_GOOD,
+		                   SCSI_ASENSE_NO_ADDITIONAL_INFORMATION, SCSI_ASENSEQ_NO_QUALIFIER);
+	}
+
+	return CommandSuccess;
+}
+
+static void MS_Device_SetSense(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                               const uint8_t Key,
+                               const uint8_t Acode,
+                               const uint8_t Aqual)
+{
+	MSInterfaceInfo->State.SenseKey                 = Key;
+	MSInterfaceInfo->State.AdditionalSenseCode      = Acode;
+	MSInterfaceInfo->State.AdditionalSenseQualifier = Aqual;
+}
+
+static uint32_t MS_Device_GetLUNTotalBlocks(const MS_Device_LUN_t* const LUN)
+{
+	if (LUN->TotalBlocks)
+	  return LUN->TotalBlocks;
+
+	if (LUN->BlockDevice->GetTotalBlocks)
+	{
+		uint32_t MediumBlocks = LUN->BlockDevice->GetTotalBlocks(LUN);
+
+		if (MediumBlocks > LUN->BlockOffset)
+		  return (MediumBlocks - LUN->BlockOffset);
+	}
+
+	return 0;
+}
+
+static bool MS_Device_UnitSupportsUnmap(const MS_Device_LUN_t* const LUN)
+{
+	return (LUN->BlockDevice->Trim && !(LUN->ReadOnly));
+}
+
+static uint8_t MS_Device_GetVPDPage(const MS_Device_LUN_t* const LUN,
+                                    const SCSI_Inquiry_Response_t* const InquiryData,
+                                    const uint8_t PageCode,
+                                    uint8_t* const Page)
+{
+	uint8_t PageLength;
+
+	memset(Page, 0x00, MS_DEVICE_VPD_PAGE_MAX_SIZE);
+
+	switch (PageCode)
+	{
+		case SCSI_VPD_PAGE_SUPPORTED_PAGES:
+			PageLength = 3;
+
+			Page[4] = SCSI_VPD_PAGE_SUPPORTED_PAGES;
+			Page[5] = SCSI_VPD_PAGE_BLOCK_LIMITS;
+			Page[6] = SCSI_VPD_PAGE_LOGICAL_BLOCK_PROVISIONING;
+			break;
+		case SCSI_VPD_PAGE_BLOCK_LIMITS:
+			PageLength = (MS_DEVICE_VPD_PAGE_MAX_SIZE - 4);
+
+			if (MS_Device_UnitSupportsUnmap(LUN))
+			{
+				/* Any number of blocks may be unmapped, but only as many descriptors as fit in a 16-bit parameter list */
+				*(uint32_t*)&Page[20] = CPU_TO_BE32(0xFFFFFFFF);
+				*(uint32_t*)&Page[24] = CPU_TO_BE32((0xFFFF - 8) / 16);
+				*(uint32_t*)&Page[28] = CPU_TO_BE32(1);
+			}
+
+			break;
+		case SCSI_VPD_PAGE_LOGICAL_BLOCK_PROVISIONING:
+			PageLength = 4;
+
+			/* Advertise UNMAP support, and thin provisioning so that the host knows unmapped blocks may be released */
+			if (MS_Device_UnitSupportsUnmap(LUN))
+			{
+				Page[5] = (1 << 7);
+				Page[6] = 0x02;
+			}
+
+			break;
+		default:
+			return 0;
+	}
+
+	Page[0] = ((InquiryData->PeripheralQualifier << 5) | InquiryData->DeviceType);
+	Page[1] = PageCode;
+	Page[3] = PageLength;
+
+	return (PageLength + 4);
+}
+
+static bool MS_Device_SCSI_Inquiry(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                   const MS_Device_LUN_t* const LUN)
+{
+	const SCSI_Inquiry_Response_t* InquiryData = (LUN->InquiryData) ? LUN->InquiryData : &MS_Device_DefaultInquiryData;
+
+	uint8_t     VPDPage[MS_DEVICE_VPD_PAGE_MAX_SIZE];
+	const void* ResponseData   = InquiryData;
+	uint16_t    ResponseLength = sizeof(SCSI_Inquiry_Response_t);
+
+	uint8_t  InquiryFlags     = MSInterfaceInfo->State.CommandBlock.SCSICommandData[1];
+	uint8_t  PageCode         = MSInterfaceInfo->State.CommandBlock.SCSICommandData[2];
+	uint16_t AllocationLength = SwapEndian_16(*(uint16_t*)&MSInterfaceInfo->State.CommandBlock.SCSICommandData[3]);
+
+	/* Vital Product Data pages are requested with the EVPD bit, command support data (CmdDt) is not supported */
+	if (InquiryFlags & (1 << 1))
+	{
+		ResponseLength = 0;
+	}
+	else if (InquiryFlags & (1 << 0))
+	{
+		ResponseData   = VPDPage;
+		ResponseLength = MS_Device_GetVPDPage(LUN, InquiryData, PageCode, VPDPage);
+	}
+	else if (PageCode)
+	{
+		ResponseLength = 0;
+	}
+
+	if (!(ResponseLength))
+	{
+		MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+		                   SCSI_ASENSE_INVALID_FIELD_IN_CDB, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	uint16_t BytesTransferred = MIN(AllocationLength, ResponseLength);
+
+	Endpoint_Write_Stream_LE(ResponseData, BytesTransferred, NULL);
+	Endpoint_Null_Stream((AllocationLength - BytesTransferred), NULL);
+	Endpoint_ClearIN();
+
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= BytesTransferred;
+	return true;
+}
+
+static bool MS_Device_SCSI_RequestSense(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
+{
+	SCSI_Request_Sense_Response_t SenseData =
+		{
+			.ResponseCode             = 0x70,
+			.SenseKey                 = MSInterfaceInfo->State.SenseKey,
+			.AdditionalLength         = 0x0A,
+			.AdditionalSenseCode      = MSInterfaceInfo->State.AdditionalSenseCode,
+			.AdditionalSenseQualifier = MSInterfaceInfo->State.AdditionalSenseQualifier,
+		};
+
+	uint8_t AllocationLength = MSInterfaceInfo->State.CommandBlock.SCSICommandData[4];
+	uint8_t BytesTransferred = MIN(AllocationLength, sizeof(SenseData));
+
+	Endpoint_Write_Stream_LE(&SenseData, BytesTransferred, NULL);
+	Endpoint_Null_Stream((AllocationLength - BytesTransferred), NULL);
+	Endpoint_ClearIN();
+
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= BytesTransferred;
+	return true;
+}
+
+static bool MS_Device_SCSI_ReadCapacity10(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                          const MS_Device_LUN_t* const LUN)
+{
+	uint32_t TotalLUNBlocks = MS_Device_GetLUNTotalBlocks(LUN);
+
+	if (!(TotalLUNBlocks))
+	{
+		MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_NOT_READY,
+		                   SCSI_ASENSE_MEDIUM_NOT_PRESENT, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	uint32_t LastBlockAddressInLUN = (TotalLUNBlocks - 1);
+	uint32_t MediaBlockSize        = LUN->BlockSize;
+
+	Endpoint_Write_Stream_BE(&LastBlockAddressInLUN, sizeof(LastBlockAddressInLUN), NULL);
+	Endpoint_Write_Stream_BE(&MediaBlockSize, sizeof(MediaBlockSize), NULL);
+	Endpoint_ClearIN();
+
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= 8;
+	return true;
+}
+
+static bool MS_Device_SCSI_ReadCapacity16(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                          const MS_Device_LUN_t* const LUN)
+{
+	uint32_t AllocationLength = SwapEndian_32(*(uint32_t*)&MSInterfaceInfo->State.CommandBlock.SCSICommandData[10]);
+	uint32_t TotalLUNBlocks   = MS_Device_GetLUNTotalBlocks(LUN);
+
+	if (!(TotalLUNBlocks))
+	{
+		MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_NOT_READY,
+		                   SCSI_ASENSE_MEDIUM_NOT_PRESENT, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	uint8_t CapacityData[32];
+
+	memset(CapacityData, 0x00, sizeof(CapacityData));
+
+	/* The upper half of the 64-bit last block address is always zero, as units are limited to 32-bit block addresses */
+	*(uint32_t*)&CapacityData[4] = cpu_to_be32(TotalLUNBlocks - 1);
+	*(uint32_t*)&CapacityData[8] = cpu_to_be32((uint32_t)LUN->BlockSize);
+
+	/* Set the LBPME bit for units which can unmap blocks, so that the host looks for the provisioning VPD pages */
+	if (MS_Device_UnitSupportsUnmap(LUN))
+	  CapacityData[14] = (1 << 7);
+
+	uint8_t BytesTransferred = MIN(AllocationLength, sizeof(CapacityData));
+
+	Endpoint_Write_Stream_LE(CapacityData, BytesTransferred, NULL);
+	Endpoint_ClearIN();
+
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= BytesTransferred;
+	return true;
+}
+
+static bool MS_Device_SCSI_SendDiagnostic(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                          const MS_Device_LUN_t* const LUN)
+{
+	/* Only the Self-Test portion of the diagnostic command is supported */
+	if (!(MSInterfaceInfo->State.CommandBlock.SCSICommandData[1] & (1 << 2)))
+	{
+		MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+		                   SCSI_ASENSE_INVALID_FIELD_IN_CDB, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	if (LUN->BlockDevice->SelfTest && !(LUN->BlockDevice->SelfTest(LUN)))
+	{
+		MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_HARDWARE_ERROR,
+		                   SCSI_ASENSE_NO_ADDITIONAL_INFORMATION, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength = 0;
+	return true;
+}
+
+static bool MS_Device_SCSI_ReadWrite10(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                       const MS_Device_LUN_t* const LUN,
+                                       const bool IsDataRead)
+{
+	uint32_t BlockAddress   = SwapEndian_32(*(uint32_t*)&MSInterfaceInfo->State.CommandBlock.SCSICommandData[2]);
+	uint16_t TotalBlocks    = SwapEndian_16(*(uint16_t*)&MSInterfaceInfo->State.CommandBlock.SCSICommandData[7]);
+	uint32_t TotalLUNBlocks = MS_Device_GetLUNTotalBlocks(LUN);
+	uint32_t TotalBytes     = ((uint32_t)TotalBlocks * LUN->BlockSize);
+
+	if (!(TotalLUNBlocks))
+	{
+		MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_NOT_READY,
+		                   SCSI_ASENSE_MEDIUM_NOT_PRESENT, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	if (!(IsDataRead) && LUN->ReadOnly)
+	{
+		MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_DATA_PROTECT,
+		                   SCSI_ASENSE_WRITE_PROTECTED, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	if ((BlockAddress >= TotalLUNBlocks) || (TotalBlocks > (TotalLUNBlocks - BlockAddress)))
+	{
+		MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+		                   SCSI_ASENSE_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	/* Refuse transfers larger than the host has allowed for in the command block, rather than overrunning it */
+	if (TotalBytes > le32_to_cpu(MSInterfaceInfo->State.CommandBlock.DataTransferLength))
+	{
+		MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+		                   SCSI_ASENSE_INVALID_FIELD_IN_CDB, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	if (TotalBlocks)
+	{
+		bool TransferSuccess;
+
+		/* Hand the entire range to the block device in one call, so that it can stream across block boundaries */
+		if (IsDataRead)
+		  TransferSuccess = LUN->BlockDevice->ReadBlocks(MSInterfaceInfo, LUN, (LUN->BlockOffset + BlockAddress), TotalBlocks);
+		else
+		  TransferSuccess = LUN->BlockDevice->WriteBlocks(MSInterfaceInfo, LUN, (LUN->BlockOffset + BlockAddress), TotalBlocks);
+
+		/* With the Force Unit Access bit set, written data must reach the medium before the command completes */
+		if (!(IsDataRead) && TransferSuccess && LUN->BlockDevice->Flush &&
+		    (MSInterfaceInfo->State.CommandBlock.SCSICommandData[1] & (1 << 3)))
+		{
+			TransferSuccess = LUN->BlockDevice->Flush(LUN);
+		}
+
+		if (!(TransferSuccess) || MSInterfaceInfo->State.IsMassStoreReset)
+		{
+			MS_Device_SetSense(MSInterfaceInfo, (IsDataRead ? SCSI_SENSE_KEY_MEDIUM_ERROR : SCSI_SENSE_KEY_HARDWARE_ERROR),
+			                   SCSI_ASENSE_NO_ADDITIONAL_INFORMATION, SCSI_ASENSEQ_NO_QUALIFIER);
+			return false;
+		}
+	}
+
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= TotalBytes;
+	return true;
+}
+
+static bool MS_Device_SCSI_ModeSense6(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                      const MS_Device_LUN_t* const LUN)
+{
+	/* Send an empty header response with the Write Protect flag status */
+	Endpoint_Write_8(0x00);
+	Endpoint_Write_8(0x00);
+	Endpoint_Write_8(LUN->ReadOnly ? 0x80 : 0x00);
+	Endpoint_Write_8(0x00);
+	Endpoint_ClearIN();
+
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= 4;
+	return true;
+}
+
+static bool MS_Device_SCSI_SynchronizeCache10(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                              const MS_Device_LUN_t* const LUN)
+{
+	if (LUN->BlockDevice->Flush && !(LUN->BlockDevice->Flush(LUN)))
+	{
+		MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_HARDWARE_ERROR,
+		                   SCSI_ASENSE_NO_ADDITIONAL_INFORMATION, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength = 0;
+	return true;
+}
+
+static bool MS_Device_SCSI_Unmap(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                 const MS_Device_LUN_t* const LUN)
+{
+	uint16_t ParameterListLength = SwapEndian_16(*(uint16_t*)&MSInterfaceInfo->State.CommandBlock.SCSICommandData[7]);
+	uint32_t TotalLUNBlocks      = MS_Device_GetLUNTotalBlocks(LUN);
+
+	if (!(LUN->BlockDevice->Trim))
+	{
+		MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+		                   SCSI_ASENSE_INVALID_COMMAND, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	if (LUN->ReadOnly)
+	{
+		MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_DATA_PROTECT,
+		                   SCSI_ASENSE_WRITE_PROTECTED, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	if (ParameterListLength > le32_to_cpu(MSInterfaceInfo->State.CommandBlock.DataTransferLength))
+	{
+		MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+		                   SCSI_ASENSE_INVALID_FIELD_IN_CDB, SCSI_ASENSEQ_NO_QUALIFIER);
+		return false;
+	}
+
+	uint16_t BytesRemaining = ParameterListLength;
+	bool     TrimSuccess    = true;
+
+	if (BytesRemaining >= 8)
+	{
+		uint8_t ParameterListHeader[8];
+
+		Endpoint_Read_Stream_LE(ParameterListHeader, sizeof(ParameterListHeader), NULL);
+		BytesRemaining -= sizeof(ParameterListHeader);
+
+		/* Each block descriptor holds a 64-bit big-endian block address, then a 32-bit big-endian block count */
+		while (BytesRemaining >= 16)
+		{
+			uint8_t BlockDescriptor[16];
+
+			Endpoint_Read_Stream_LE(BlockDescriptor, sizeof(BlockDescriptor), NULL);
+			BytesRemaining -= sizeof(BlockDescriptor);
+
+			if (!(TrimSuccess))
+			  continue;
+
+			uint32_t BlockAddressHigh = SwapEndian_32(*(uint32_t*)&BlockDescriptor[0]);
+			uint32_t BlockAddress     = SwapEndian_32(*(uint32_t*)&BlockDescriptor[4]);
+			uint32_t TotalBlocks      = SwapEndian_32(*(uint32_t*)&BlockDescriptor[8]);
+
+			if (BlockAddressHigh || (BlockAddress >= TotalLUNBlocks) || (TotalBlocks > (TotalLUNBlocks - BlockAddress)))
+			{
+				MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+				                   SCSI_ASENSE_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE, SCSI_ASENSEQ_NO_QUALIFIER);
+				TrimSuccess = false;
+			}
+			else if (TotalBlocks && !(LUN->BlockDevice->Trim(LUN, (LUN->BlockOffset + BlockAddress), TotalBlocks)))
+			{
+				MS_Device_SetSense(MSInterfaceInfo, SCSI_SENSE_KEY_HARDWARE_ERROR,
+				                   SCSI_ASENSE_NO_ADDITIONAL_INFORMATION, SCSI_ASENSEQ_NO_QUALIFIER);
+				TrimSuccess = false;
+			}
+		}
+	}
+
+	Endpoint_Discard_Stream(BytesRemaining, NULL);
+
+	/* If the endpoint is empty, clear it ready for the next packet from the host */
+	if (ParameterListLength && !(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearOUT();
+
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= ParameterListLength;
+	return TrimSuccess;
+}
+
+static bool MS_Device_RAMDisk_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                         const MS_Device_LUN_t* const LUN,
+                                         const uint32_t BlockAddress,
+                                         const uint16_t TotalBlocks)
+{
+	const uint8_t* BlockData = ((const uint8_t*)LUN->Context + (BlockAddress * LUN->BlockSize));
+
+	for (uint16_t BlockIndex = 0; BlockIndex < TotalBlocks; BlockIndex++)
+	{
+		if (Endpoint_Write_Stream_LE(BlockData, LUN->BlockSize, NULL) != ENDPOINT_RWSTREAM_NoError)
+		  return false;
+
+		if (MSInterfaceInfo->State.IsMassStoreReset)
+		  return false;
+
+		BlockData += LUN->BlockSize;
+	}
+
+	/* Send any partially filled packet now, so that it is not merged with the command status */
+	if (Endpoint_BytesInEndpoint())
+	  Endpoint_ClearIN();
+
+	return true;
+}
+
+static bool MS_Device_RAMDisk_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                          const MS_Device_LUN_t* const LUN,
+                                          const uint32_t BlockAddress,
+                                          const uint16_t TotalBlocks)
+{
+	uint8_t* BlockData = ((uint8_t*)LUN->Context + (BlockAddress * LUN->BlockSize));
+
+	for (uint16_t BlockIndex = 0; BlockIndex < TotalBlocks; BlockIndex++)
+	{
+		if (Endpoint_Read_Stream_LE(BlockData, LUN->BlockSize, NULL) != ENDPOINT_RWSTREAM_NoError)
+		  return false;
+
+		if (MSInterfaceInfo->State.IsMassStoreReset)
+		  return false;
+
+		BlockData += LUN->BlockSize;
+	}
+
+	/* If the endpoint is empty, clear it ready for the next packet from the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearOUT();
+
+	return true;
+}
+
 #endif
 
@@ -47,6 +47,13 @@
  *  \section Sec_ModDescription Module Description
  *  Device Mode USB Class driver framework interface, for the Mass Storage USB Class driver.
  *
+ *  SCSI commands received from the host may either be decoded entirely by the user application inside the
+ *  \ref CALLBACK_MS_Device_SCSICommandReceived() callback, or passed on to the library's SCSI command layer via
+ *  \ref MS_Device_ProcessSCSICommand(). The latter routes each command to the logical unit it addresses, as
+ *  described by the interface's \ref MS_Device_LUN_t table, and performs the data transfers through the block
+ *  device driver (\ref MS_Device_BlockDevice_t) backing that unit. A block device driver for a buffer in RAM is
+ *  provided by the library as \ref MS_Device_RAMDiskBlockDevice.
+ *
  *  @{
  */
 
@@ -69,13 +76,102 @@
 
 	/* Public Interface - May be used in end-application: */
 		/* Type Defines: */
+			struct USB_ClassInfo_MS_Device;
+			struct MS_Device_LUN;
+
+			/** \brief Mass Storage Class Device Mode Block Device Driver.
+			 *
+			 *  Table of routines implementing a block addressed storage medium, used by \ref MS_Device_ProcessSCSICommand()
+			 *  to access the medium backing a logical unit. Each routine is passed the \ref MS_Device_LUN_t entry of the
+			 *  unit being accessed, whose \c Context element can hold any driver specific data such as a buffer address.
+			 *
+			 *  Block addresses passed to the driver are absolute addresses on the medium, i.e. they already include the
+			 *  logical unit's \c BlockOffset.
+			 */
+			typedef struct
+			{
+				/** Reads the given range of blocks from the medium and writes them to the currently selected IN endpoint,
+				 *  as a single transfer. The routine should abort the transfer early and return \c false if the
+				 *  interface's \c IsMassStoreReset state flag becomes set.
+				 *
+				 *  \return Boolean \c true if all blocks were read and sent to the host, \c false otherwise.
+				 */
+				bool (*ReadBlocks)(struct USB_ClassInfo_MS_Device* const MSInterfaceInfo,
+				                   const struct MS_Device_LUN* const LUN,
+				                   const uint32_t BlockAddress,
+				                   const uint16_t TotalBlocks);
+
+				/** Reads the given range of blocks from the currently selected OUT endpoint and writes them to the medium,
+				 *  as a single transfer. The routine should abort the transfer early and return \c false if the
+				 *  interface's \c IsMassStoreReset state flag becomes set.
+				 *
+				 *  \return Boolean \c true if all blocks were received and written to the medium, \c false otherwise.
+				 */
+				bool (*WriteBlocks)(struct USB_ClassInfo_MS_Device* const MSInterfaceInfo,
+				                    const struct MS_Device_LUN* const LUN,
+				                    const uint32_t BlockAddress,
+				                    const uint16_t TotalBlocks);
+
+				/** Optional routine to commit any writes held in a volatile cache to the medium, or \c NULL if the driver
+				 *  does not cache writes.
+				 *
+				 *  \return Boolean \c true if the cache was flushed, \c false on error.
+				 */
+				bool (*Flush)(const struct MS_Device_LUN* const LUN);
+
+				/** Optional routine to discard the contents of the given range of blocks, which the host is no longer
+				 *  using, or \c NULL if the medium cannot make use of this information.
+				 *
+				 *  \return Boolean \c true if the blocks were discarded, \c false on error.
+				 */
+				bool (*Trim)(const struct MS_Device_LUN* const LUN,
+				             const uint32_t BlockAddress,
+				             const uint32_t TotalBlocks);
+
+				/** Optional routine to retrieve the number of blocks on the medium, for media whose size is not fixed (such
+				 *  as removable cards). Only used for logical units with a \c TotalBlocks value of zero.
+				 *
+				 *  \return Number of blocks on the medium, or zero if no medium is present.
+				 */
+				uint32_t (*GetTotalBlocks)(const struct MS_Device_LUN* const LUN);
+
+				/** Optional routine to check that the medium is functioning correctly, run in response to a SCSI SEND
+				 *  DIAGNOSTIC command, or \c NULL if the medium cannot be tested.
+				 *
+				 *  \return Boolean \c true if the medium passed the test, \c false otherwise.
+				 */
+				bool (*SelfTest)(const struct MS_Device_LUN* const LUN);
+			} MS_Device_BlockDevice_t;
+
+			/** \brief Mass Storage Class Device Mode Logical Unit Definition.
+			 *
+			 *  Definition of a single logical unit (drive) of a Mass Storage interface, for use by the library SCSI
+			 *  command layer. A table of these, one per logical unit, is referenced by the \c LUNs element of the
+			 *  interface configuration. Several logical units may share one block device by mapping each onto a
+			 *  different region of the medium through their \c BlockOffset values.
+			 */
+			typedef struct MS_Device_LUN
+			{
+				const MS_Device_BlockDevice_t* BlockDevice; /**< Block device driver for the unit's storage medium. */
+				void*    Context; /**< Driver specific data for the block device driver, e.g. a buffer address. */
+
+				uint32_t BlockOffset; /**< Address of the unit's first block on the medium. */
+				uint32_t TotalBlocks; /**< Number of blocks in the unit, or zero to query the driver for the medium size. */
+				uint16_t BlockSize; /**< Size of each block in the unit, in bytes. */
+				bool     ReadOnly; /**< Indicates if the unit should be reported as write protected to the host. */
+
+				const SCSI_Inquiry_Response_t* InquiryData; /**< Optional response to SCSI INQUIRY commands for the unit,
+				                                             *   or \c NULL to report a generic removable block device.
+				                                             */
+			} MS_Device_LUN_t;
+
 			/** \brief Mass Storage Class Device Mode Configuration and State Structure.
 			 *
 			 *  Class state structure. An instance of this structure should be made for each Mass Storage interface
 			 *  within the user application, and passed to each of the Mass Storage class driver functions as the
 			 *  \c MSInterfaceInfo parameter. This stores each Mass Storage interface's configuration and state information.
 			 */
-			typedef struct
+			typedef struct USB_ClassInfo_MS_Device
 			{
 				struct
 				{
@@ -85,6 +181,11 @@
 					USB_Endpoint_Table_t DataOUTEndpoint; /**< Data OUT endpoint configuration table. */
 
 					uint8_t  TotalLUNs; /**< Total number of logical drives in the Mass Storage interface. */
+
+					const MS_Device_LUN_t* LUNs; /**< Table of \c TotalLUNs logical unit definitions, used by
+					                              *   \ref MS_Device_ProcessSCSICommand(). May be \c NULL if all
+					                              *   SCSI commands are decoded by the user application.
+					                              */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */
@@ -99,6 +200,9 @@
 					volatile bool IsMassStoreReset; /**< Flag indicating that the host has requested that the Mass Storage interface be reset
 											         *   and that all current Mass Storage operations should immediately abort.
 											         */
+					uint8_t SenseKey; /**< SCSI sense key of the last command processed by \ref MS_Device_ProcessSCSICommand(). */
+					uint8_t AdditionalSenseCode; /**< SCSI additional sense code of the last processed command. */
+					uint8_t AdditionalSenseQualifier; /**< SCSI additional sense qualifier of the last processed command. */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 				          *   are reset to their defaults when the interface is enumerated.
 				          */
@@ -140,12 +244,82 @@
 			 */
 			bool CALLBACK_MS_Device_SCSICommandReceived(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 
+			/** Processes the SCSI command held in the given Mass Storage interface's command block, through the library SCSI
+			 *  command layer. The command is routed to the logical unit it addresses in the interface's \c LUNs table, and
+			 *  any data transfer is performed through that unit's block device driver; READ (10) and WRITE (10) commands
+			 *  are passed to the driver as a single multiple block transfer. The sense data reported to the host in
+			 *  response to a later REQUEST SENSE command is updated to reflect the outcome of the command.
+			 *
+			 *  This is intended to be called from the user application's \ref CALLBACK_MS_Device_SCSICommandReceived()
+			 *  callback, either directly or after the application has handled any commands of its own.
+			 *
+			 *  The following SCSI commands are supported: TEST UNIT READY, REQUEST SENSE, INQUIRY, MODE SENSE (6),
+			 *  PREVENT ALLOW MEDIUM REMOVAL, SEND DIAGNOSTIC, READ CAPACITY (10), READ CAPACITY (16), READ (10),
+			 *  WRITE (10), VERIFY (10), SYNCHRONIZE CACHE (10) and UNMAP. All others are failed with an ILLEGAL
+			 *  REQUEST sense key. INQUIRY also returns the Supported VPD Pages, Block Limits and Logical Block
+			 *  Provisioning Vital Product Data pages, through which (along with the LBPME bit of READ CAPACITY (16))
+			 *  the host discovers UNMAP support on writable units whose block device has a \c Trim routine.
+			 *
+			 *  \param[in,out] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state.
+			 *
+			 *  \return Boolean \c true if the SCSI command was successfully processed, \c false otherwise.
+			 */
+			bool MS_Device_ProcessSCSICommand(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+		/* External Variables: */
+			/** Block device driver for a medium held in RAM, such as a RAM disk. The \c Context element of each logical
+			 *  unit using the driver must point to the start of the memory buffer holding the medium's blocks, which
+			 *  must be at least (\c BlockOffset + \c TotalBlocks) * \c BlockSize bytes in size.
+			 */
+			extern const MS_Device_BlockDevice_t MS_Device_RAMDiskBlockDevice;
+
 	/* Private Interface - For use in library only: */
 	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define MS_DEVICE_VPD_PAGE_MAX_SIZE    64
+
 		/* Function Prototypes: */
 			#if defined(__INCLUDE_FROM_MASSSTORAGE_DEVICE_C)
 				static void MS_Device_ReturnCommandStatus(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 				static bool MS_Device_ReadInCommandBlock(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+				static void MS_Device_SetSense(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                               const uint8_t Key,
+				                               const uint8_t Acode,
+				                               const uint8_t Aqual) ATTR_NON_NULL_PTR_ARG(1);
+				static uint32_t MS_Device_GetLUNTotalBlocks(const MS_Device_LUN_t* const LUN) ATTR_NON_NULL_PTR_ARG(1);
+				static bool MS_Device_UnitSupportsUnmap(const MS_Device_LUN_t* const LUN) ATTR_NON_NULL_PTR_ARG(1);
+				static uint8_t MS_Device_GetVPDPage(const MS_Device_LUN_t* const LUN,
+				                                    const SCSI_Inquiry_Response_t* const InquiryData,
+				                                    const uint8_t PageCode,
+				                                    uint8_t* const Page) ATTR_NON_NULL_PTR_ARG(1, 2, 4);
+				static bool MS_Device_SCSI_Inquiry(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                   const MS_Device_LUN_t* const LUN) ATTR_NON_NULL_PTR_ARG(1, 2);
+				static bool MS_Device_SCSI_RequestSense(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+				static bool MS_Device_SCSI_ReadCapacity10(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                          const MS_Device_LUN_t* const LUN) ATTR_NON_NULL_PTR_ARG(1, 2);
+				static bool MS_Device_SCSI_ReadCapacity16(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                          const MS_Device_LUN_t* const LUN) ATTR_NON_NULL_PTR_ARG(1, 2);
+				static bool MS_Device_SCSI_SendDiagnostic(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                          const MS_Device_LUN_t* const LUN) ATTR_NON_NULL_PTR_ARG(1, 2);
+				static bool MS_Device_SCSI_ReadWrite10(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                       const MS_Device_LUN_t* const LUN,
+				                                       const bool IsDataRead) ATTR_NON_NULL_PTR_ARG(1, 2);
+				static bool MS_Device_SCSI_ModeSense6(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                      const MS_Device_LUN_t* const LUN) ATTR_NON_NULL_PTR_ARG(1, 2);
+				static bool MS_Device_SCSI_SynchronizeCache10(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                              const MS_Device_LUN_t* const LUN) ATTR_NON_NULL_PTR_ARG(1, 2);
+				static bool MS_Device_SCSI_Unmap(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                 const MS_Device_LUN_t* const LUN) ATTR_NON_NULL_PTR_ARG(1, 2);
+
+				static bool MS_Device_RAMDisk_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                         const MS_Device_LUN_t* const LUN,
+				                                         const uint32_t BlockAddress,
+				                                         const uint16_t TotalBlocks) ATTR_NON_NULL_PTR_ARG(1, 2);
+				static bool MS_Device_RAMDisk_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                          const MS_Device_LUN_t* const LUN,
+				                                          const uint32_t BlockAddress,
+				                                          const uint16_t TotalBlocks) ATTR_NON_NULL_PTR_ARG(1, 2);
 			#endif
 
 	#endif
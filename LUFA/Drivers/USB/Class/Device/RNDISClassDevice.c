@@ -155,6 +155,8 @@ void RNDIS_Device_USBTask(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo
 
 		RNDISInterfaceInfo->State.ResponseReady = false;
 	}
+
+	RNDIS_Device_Flush(RNDISInterfaceInfo);
 }
 
 void RNDIS_Device_ProcessRNDISControlMessage(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
@@ -174,6 +176,14 @@ void RNDIS_Device_ProcessRNDISControlMessage(USB_ClassInfo_RNDIS_Device_t* const
 			RNDIS_Initialize_Complete_t* INITIALIZE_Response =
 			               (RNDIS_Initialize_Complete_t*)&RNDISInterfaceInfo->State.RNDISMessageBuffer;
 
+			/* Save the host's transfer size limit before it is overwritten by the response */
+			RNDISInterfaceInfo->State.HostMaxTransferSize = le32_to_cpu(INITIALIZE_Message->MaxTransferSize);
+
+			uint8_t MaxPacketsPerTransfer = RNDISInterfaceInfo->Config.MaxPacketsPerTransfer;
+
+			if (!(MaxPacketsPerTransfer))
+			  MaxPacketsPerTransfer = 1;
+
 			INITIALIZE_Response->MessageType            = CPU_TO_LE32(REMOTE_NDIS_INITIALIZE_CMPLT);
 			INITIALIZE_Response->MessageLength          = CPU_TO_LE32(sizeof(RNDIS_Initialize_Complete_t));
 			INITIALIZE_Response->RequestId              = INITIALIZE_Message->RequestId;
@@ -183,8 +193,9 @@ void RNDIS_Device_ProcessRNDISControlMessage(USB_ClassInfo_RNDIS_Device_t* const
 			INITIALIZE_Response->MinorVersion           = CPU_TO_LE32(REMOTE_NDIS_VERSION_MINOR);
 			INITIALIZE_Response->DeviceFlags            = CPU_TO_LE32(REMOTE_NDIS_DF_CONNECTIONLESS);
 			INITIALIZE_Response->Medium                 = CPU_TO_LE32(REMOTE_NDIS_MEDIUM_802_3);
-			INITIALIZE_Response->MaxPacketsPerTransfer  = CPU_TO_LE32(1);
-			INITIALIZE_Response->MaxTransferSize        = CPU_TO_LE32(sizeof(RNDIS_Packet_Message_t) + ETHERNET_FRAME_SIZE_MAX);
+			INITIALIZE_Response->MaxPacketsPerTransfer  = cpu_to_le32(MaxPacketsPerTransfer);
+			INITIALIZE_Response->MaxTransferSize        = cpu_to_le32((uint32_t)MaxPacketsPerTransfer *
+			                                                          (sizeof(RNDIS_Packet_Message_t) + ETHERNET_FRAME_SIZE_MAX));
 			INITIALIZE_Response->PacketAlignmentFactor  = CPU_TO_LE32(0);
 			INITIALIZE_Response->AFListOffset           = CPU_TO_LE32(0);
 			INITIALIZE_Response->AFListSize             = CPU_TO_LE32(0);
@@ -434,6 +445,42 @@ uint8_t RNDIS_Device_ReadPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfa
                                 void* Buffer,
                                 uint16_t* const PacketLength)
 {
+	uint8_t ErrorCode;
+
+	if ((ErrorCode = RNDIS_Device_BeginReadPacket(RNDISInterfaceInfo, PacketLength)) != ENDPOINT_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	if (!(*PacketLength))
+	  return ENDPOINT_RWSTREAM_NoError;
+
+	if ((ErrorCode = Endpoint_Read_Stream_LE(Buffer, *PacketLength, NULL)) != ENDPOINT_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	return RNDIS_Device_EndReadPacket(RNDISInterfaceInfo);
+}
+
+uint8_t RNDIS_Device_SendPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo,
+                                void* Buffer,
+                                const uint16_t PacketLength)
+{
+	uint8_t ErrorCode;
+
+	if ((ErrorCode = RNDIS_Device_BeginSendPacket(RNDISInterfaceInfo, PacketLength)) != ENDPOINT_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	if ((ErrorCode = Endpoint_Write_Stream_LE(Buffer, PacketLength, NULL)) != ENDPOINT_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	return RNDIS_Device_EndSendPacket(RNDISInterfaceInfo);
+}
+
+uint8_t RNDIS_Device_BeginReadPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo,
+                                     uint16_t* const PacketLength)
+{
+	uint8_t ErrorCode;
+
+	*PacketLength = 0;
+
 	if ((USB_DeviceState != DEVICE_STATE_Configured) ||
 	    (RNDISInterfaceInfo->State.CurrRNDISState != RNDIS_Data_Initialized))
 	{
@@ -442,32 +489,88 @@ uint8_t RNDIS_Device_ReadPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfa
 
 	Endpoint_SelectEndpoint(RNDISInterfaceInfo->Config.DataOUTEndpoint.Address);
 
-	*PacketLength = 0;
-
 	if (!(Endpoint_IsOUTReceived()))
+	  return ENDPOINT_RWSTREAM_NoError;
+
+	uint16_t EndpointSize = RNDISInterfaceInfo->Config.DataOUTEndpoint.Size;
+	uint16_t BankPosition = (RNDISInterfaceInfo->State.RxTransferLength % EndpointSize);
+	uint16_t BytesInBank  = Endpoint_BytesInEndpoint();
+
+	/* A short packet with too few bytes left for a message header can only be the zero length packet or padding that
+	   terminates a transfer ending on a packet boundary, rather than the start of another packet message */
+	if (((BankPosition + BytesInBank) < EndpointSize) && (BytesInBank < sizeof(RNDIS_Message_Header_t)))
+	{
+		Endpoint_ClearOUT();
+		RNDISInterfaceInfo->State.RxTransferLength = 0;
+
 		return ENDPOINT_RWSTREAM_NoError;
+	}
 
-	RNDIS_Packet_Message_t RNDISPacketHeader;
-	Endpoint_Read_Stream_LE(&RNDISPacketHeader, sizeof(RNDIS_Packet_Message_t), NULL);
+	struct
+	{
+		uint32_t MessageType;
+		uint32_t MessageLength;
+		uint32_t DataOffset;
+		uint32_t DataLength;
+	} PacketHeader;
+
+	if ((ErrorCode = Endpoint_Read_Stream_LE(&PacketHeader, sizeof(PacketHeader), NULL)) != ENDPOINT_RWSTREAM_NoError)
+	  return ErrorCode;
 
-	if (le32_to_cpu(RNDISPacketHeader.DataLength) > ETHERNET_FRAME_SIZE_MAX)
+	uint32_t MessageLength = le32_to_cpu(PacketHeader.MessageLength);
+	uint32_t DataStart     = (sizeof(RNDIS_Message_Header_t) + le32_to_cpu(PacketHeader.DataOffset));
+	uint32_t DataLength    = le32_to_cpu(PacketHeader.DataLength);
+
+	if ((le32_to_cpu(PacketHeader.MessageType) != REMOTE_NDIS_PACKET_MSG) || (MessageLength > UINT16_MAX) ||
+	    (DataStart < sizeof(PacketHeader)) || (DataLength > ETHERNET_FRAME_SIZE_MAX) ||
+	    ((DataStart + DataLength) > MessageLength))
 	{
 		Endpoint_StallTransaction();
+		RNDISInterfaceInfo->State.RxTransferLength = 0;
 
 		return RNDIS_ERROR_LOGICAL_CMD_FAILED;
 	}
 
-	*PacketLength = (uint16_t)le32_to_cpu(RNDISPacketHeader.DataLength);
+	if ((ErrorCode = Endpoint_Discard_Stream(DataStart - sizeof(PacketHeader), NULL)) != ENDPOINT_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	RNDISInterfaceInfo->State.RxMessageLength = MessageLength;
+	RNDISInterfaceInfo->State.RxTrailerLength = (MessageLength - DataStart - DataLength);
 
-	Endpoint_Read_Stream_LE(Buffer, *PacketLength, NULL);
-	Endpoint_ClearOUT();
+	/* Empty frames are dropped here, as a zero length indicates to the caller that there is no packet to complete */
+	if (!(DataLength))
+	  return RNDIS_Device_EndReadPacket(RNDISInterfaceInfo);
 
+	*PacketLength = DataLength;
 	return ENDPOINT_RWSTREAM_NoError;
 }
 
-uint8_t RNDIS_Device_SendPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo,
-                                void* Buffer,
-                                const uint16_t PacketLength)
+uint8_t RNDIS_Device_EndReadPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+{
+	uint8_t ErrorCode;
+
+	Endpoint_SelectEndpoint(RNDISInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+	if ((ErrorCode = Endpoint_Discard_Stream(RNDISInterfaceInfo->State.RxTrailerLength, NULL)) != ENDPOINT_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	RNDISInterfaceInfo->State.RxTransferLength += RNDISInterfaceInfo->State.RxMessageLength;
+
+	/* Further packet messages of the same transfer may follow in the current bank, so only release it once emptied */
+	if (!(Endpoint_BytesInEndpoint()))
+	{
+		Endpoint_ClearOUT();
+
+		/* A bank which was not completely filled by the host was the short packet which ended the transfer */
+		if (RNDISInterfaceInfo->State.RxTransferLength % RNDISInterfaceInfo->Config.DataOUTEndpoint.Size)
+		  RNDISInterfaceInfo->State.RxTransferLength = 0;
+	}
+
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+uint8_t RNDIS_Device_BeginSendPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo,
+                                     const uint16_t PacketLength)
 {
 	uint8_t ErrorCode;
 
@@ -477,25 +580,83 @@ uint8_t RNDIS_Device_SendPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfa
 		return ENDPOINT_RWSTREAM_DeviceDisconnected;
 	}
 
+	uint16_t MessageLength = (sizeof(RNDIS_Packet_Message_t) + PacketLength);
+
+	/* End the current transfer first if adding this packet message would exceed what the host will accept */
+	if (RNDISInterfaceInfo->State.TxPacketCount &&
+	    ((RNDISInterfaceInfo->State.TxTransferLength + MessageLength) > RNDISInterfaceInfo->State.HostMaxTransferSize))
+	{
+		if ((ErrorCode = RNDIS_Device_Flush(RNDISInterfaceInfo)) != ENDPOINT_READYWAIT_NoError)
+		  return ErrorCode;
+	}
+
 	Endpoint_SelectEndpoint(RNDISInterfaceInfo->Config.DataINEndpoint.Address);
 
 	if ((ErrorCode = Endpoint_WaitUntilReady()) != ENDPOINT_READYWAIT_NoError)
 	  return ErrorCode;
 
-	RNDIS_Packet_Message_t RNDISPacketHeader;
+	struct
+	{
+		uint32_t MessageType;
+		uint32_t MessageLength;
+		uint32_t DataOffset;
+		uint32_t DataLength;
+	} PacketHeader =
+		{
+			.MessageType   = CPU_TO_LE32(REMOTE_NDIS_PACKET_MSG),
+			.MessageLength = cpu_to_le32(MessageLength),
+			.DataOffset    = CPU_TO_LE32(sizeof(RNDIS_Packet_Message_t) - sizeof(RNDIS_Message_Header_t)),
+			.DataLength    = cpu_to_le32(PacketLength),
+		};
+
+	/* Only the leading header fields are used, the remaining out-of-band and per-packet information fields are zero */
+	if ((ErrorCode = Endpoint_Write_Stream_LE(&PacketHeader, sizeof(PacketHeader), NULL)) != ENDPOINT_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	if ((ErrorCode = Endpoint_Null_Stream(sizeof(RNDIS_Packet_Message_t) - sizeof(PacketHeader), NULL)) != ENDPOINT_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	RNDISInterfaceInfo->State.TxTransferLength += MessageLength;
+
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+uint8_t RNDIS_Device_EndSendPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+{
+	if (++RNDISInterfaceInfo->State.TxPacketCount < RNDISInterfaceInfo->Config.MaxPacketsPerTransfer)
+	  return ENDPOINT_RWSTREAM_NoError;
+
+	return RNDIS_Device_Flush(RNDISInterfaceInfo);
+}
+
+uint8_t RNDIS_Device_Flush(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+{
+	if (!(RNDISInterfaceInfo->State.TxPacketCount))
+	  return ENDPOINT_READYWAIT_NoError;
+
+	if (USB_DeviceState != DEVICE_STATE_Configured)
+	  return ENDPOINT_READYWAIT_DeviceDisconnected;
 
-	memset(&RNDISPacketHeader, 0, sizeof(RNDIS_Packet_Message_t));
+	bool EndsOnFullPacket = !(RNDISInterfaceInfo->State.TxTransferLength % RNDISInterfaceInfo->Config.DataINEndpoint.Size);
 
-	RNDISPacketHeader.MessageType   = CPU_TO_LE32(REMOTE_NDIS_PACKET_MSG);
-	RNDISPacketHeader.MessageLength = cpu_to_le32(sizeof(RNDIS_Packet_Message_t) + PacketLength);
-	RNDISPacketHeader.DataOffset    = CPU_TO_LE32(sizeof(RNDIS_Packet_Message_t) - sizeof(RNDIS_Message_Header_t));
-	RNDISPacketHeader.DataLength    = cpu_to_le32(PacketLength);
+	RNDISInterfaceInfo->State.TxTransferLength = 0;
+	RNDISInterfaceInfo->State.TxPacketCount    = 0;
 
-	Endpoint_Write_Stream_LE(&RNDISPacketHeader, sizeof(RNDIS_Packet_Message_t), NULL);
-	Endpoint_Write_Stream_LE(Buffer, PacketLength, NULL);
+	Endpoint_SelectEndpoint(RNDISInterfaceInfo->Config.DataINEndpoint.Address);
 	Endpoint_ClearIN();
 
-	return ENDPOINT_RWSTREAM_NoError;
+	/* A transfer ending on a full packet must be terminated with a zero length packet for the host to see its end */
+	if (EndsOnFullPacket)
+	{
+		uint8_t ErrorCode;
+
+		if ((ErrorCode = Endpoint_WaitUntilReady()) != ENDPOINT_READYWAIT_NoError)
+		  return ErrorCode;
+
+		Endpoint_ClearIN();
+	}
+
+	return ENDPOINT_READYWAIT_NoError;
 }
 
 #endif
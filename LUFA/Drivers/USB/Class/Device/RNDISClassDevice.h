@@ -47,6 +47,12 @@
  *  \section Sec_ModDescription Module Description
  *  Device Mode USB Class driver framework interface, for the RNDIS USB Class driver.
  *
+ *  Ethernet frames may be exchanged with the host either whole via \ref RNDIS_Device_ReadPacket() and
+ *  \ref RNDIS_Device_SendPacket(), or piecewise via the \c Begin and \c End packet functions, which handle the
+ *  RNDIS packet message header and leave the application to stream the frame data directly to or from the data
+ *  endpoints with the regular endpoint stream functions. Setting the \c MaxPacketsPerTransfer configuration
+ *  value allows several frames to be combined into a single bulk transfer in each direction.
+ *
  *  @{
  */
 
@@ -87,6 +93,12 @@
 
 					char*         AdapterVendorDescription; /**< String description of the adapter vendor. */
 					MAC_Address_t AdapterMACAddress; /**< MAC address of the adapter. */
+
+					uint8_t       MaxPacketsPerTransfer; /**< Maximum number of Ethernet frames which may be combined into a single
+					                                      *   bulk transfer in each direction, or zero to exchange only a single
+					                                      *   frame per transfer. When greater than one, sent frames are held until
+					                                      *   the transfer is full or \ref RNDIS_Device_Flush() is called.
+					                                      */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */
@@ -98,6 +110,16 @@
 					bool     ResponseReady; /**< Internal flag indicating if a RNDIS message is waiting to be returned to the host. */
 					uint8_t  CurrRNDISState; /**< Current RNDIS state of the adapter, a value from the \ref RNDIS_States_t enum. */
 					uint32_t CurrPacketFilter; /**< Current packet filter mode, used internally by the class driver. */
+					uint32_t HostMaxTransferSize; /**< Maximum size of a single bulk transfer the host will accept from the device. */
+					uint16_t RxTransferLength; /**< Number of bytes of the current OUT transfer consumed, used internally by the
+					                            *   class driver to locate the end of the transfer.
+					                            */
+					uint16_t RxMessageLength; /**< Length of the RNDIS packet message currently being read. */
+					uint16_t RxTrailerLength; /**< Number of bytes following the frame data in the RNDIS packet message currently
+					                           *   being read.
+					                           */
+					uint32_t TxTransferLength; /**< Number of bytes written into the current IN transfer. */
+					uint8_t  TxPacketCount; /**< Number of RNDIS packet messages written into the current IN transfer. */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 				          *   are reset to their defaults when the interface is enumerated.
 				          */
@@ -170,6 +192,71 @@
 											void* Buffer,
 											const uint16_t PacketLength);
 
+			/** Begins reading the next pending packet from the host, parsing and discarding its RNDIS packet message header so
+			 *  that the endpoint is left positioned at the start of the Ethernet frame. The application must then read exactly
+			 *  the returned number of frame bytes from the data OUT endpoint using the regular endpoint stream functions (for
+			 *  example, reading the frame header and payload into separate buffers), before calling
+			 *  \ref RNDIS_Device_EndReadPacket().
+			 *
+			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or the
+			 *       call will fail.
+			 *
+			 *  \note If no packet is waiting, or the host sent padding rather than a packet, the returned length is zero and
+			 *        \ref RNDIS_Device_EndReadPacket() must not be called.
+			 *
+			 *  \param[in,out] RNDISInterfaceInfo  Pointer to a structure containing an RNDIS Class configuration and state.
+			 *  \param[out]    PacketLength        Pointer to where the length in bytes of the waiting Ethernet frame is to be stored.
+			 *
+			 *  \return A value from the \ref Endpoint_Stream_RW_ErrorCodes_t enum, or \ref RNDIS_ERROR_LOGICAL_CMD_FAILED if the
+			 *          host sent a malformed packet message.
+			 */
+			uint8_t RNDIS_Device_BeginReadPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo,
+			                                     uint16_t* const PacketLength) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Completes the reading of a packet started with \ref RNDIS_Device_BeginReadPacket(), discarding any padding
+			 *  following the frame. The data OUT endpoint bank is released once all the RNDIS packet messages it contains have
+			 *  been read.
+			 *
+			 *  \param[in,out] RNDISInterfaceInfo  Pointer to a structure containing an RNDIS Class configuration and state.
+			 *
+			 *  \return A value from the \ref Endpoint_Stream_RW_ErrorCodes_t enum.
+			 */
+			uint8_t RNDIS_Device_EndReadPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Begins sending a packet to the host, writing its RNDIS packet message header to the data IN endpoint. The
+			 *  application must then write exactly \c PacketLength bytes of Ethernet frame data using the regular endpoint
+			 *  stream functions, which may be gathered from several buffers, before calling \ref RNDIS_Device_EndSendPacket().
+			 *
+			 *  \pre This function must only be called when the Device state machine is in the \ref DEVICE_STATE_Configured state or the
+			 *       call will fail.
+			 *
+			 *  \param[in,out] RNDISInterfaceInfo  Pointer to a structure containing an RNDIS Class configuration and state.
+			 *  \param[in]     PacketLength        Length in bytes of the Ethernet frame to send.
+			 *
+			 *  \return A value from the \ref Endpoint_Stream_RW_ErrorCodes_t enum.
+			 */
+			uint8_t RNDIS_Device_BeginSendPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo,
+			                                     const uint16_t PacketLength) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Completes the sending of a packet started with \ref RNDIS_Device_BeginSendPacket(). The bulk transfer is ended and
+			 *  sent to the host immediately unless the interface's \c MaxPacketsPerTransfer configuration value allows further
+			 *  packets to be added to it.
+			 *
+			 *  \param[in,out] RNDISInterfaceInfo  Pointer to a structure containing an RNDIS Class configuration and state.
+			 *
+			 *  \return A value from the \ref Endpoint_Stream_RW_ErrorCodes_t enum.
+			 */
+			uint8_t RNDIS_Device_EndSendPacket(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Ends the current bulk transfer of packets to the host, if any packets are waiting in it. This is called
+			 *  automatically from \ref RNDIS_Device_USBTask(), so that combined packets are not held back for long.
+			 *
+			 *  \param[in,out] RNDISInterfaceInfo  Pointer to a structure containing an RNDIS Class configuration and state.
+			 *
+			 *  \return A value from the \ref Endpoint_WaitUntilReady_ErrorCodes_t enum.
+			 */
+			uint8_t RNDIS_Device_Flush(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
 	/* Private Interface - For use in library only: */
 	#if !defined(__DOXYGEN__)
 		/* Function Prototypes: */
@@ -56,37 +56,27 @@ uint8_t AOA_Host_ConfigurePipes(USB_ClassInfo_AOA_Host_t* const AOAInterfaceInfo
                                 uint16_t ConfigDescriptorSize,
                                 void* ConfigDescriptorData)
 {
-	USB_Descriptor_Endpoint_t*  DataINEndpoint  = NULL;
-	USB_Descriptor_Endpoint_t*  DataOUTEndpoint = NULL;
-	USB_Descriptor_Interface_t* AOAInterface    = NULL;
+	const USB_ConfigIndex_t*           ConfigIndex;
+	USB_ConfigIndex_Interface_t        AOAInterface;
+	USB_Descriptor_Endpoint_t*         DataINEndpoint  = NULL;
+	USB_Descriptor_Endpoint_t*         DataOUTEndpoint = NULL;
+	uint8_t                            InterfaceIndex  = 0;
 
 	memset(&AOAInterfaceInfo->State, 0x00, sizeof(AOAInterfaceInfo->State));
 
-	if (DESCRIPTOR_TYPE(ConfigDescriptorData) != DTYPE_Configuration)
+	if (!(ConfigIndex = USB_Host_GetConfigIndex(ConfigDescriptorSize, ConfigDescriptorData)))
 	  return AOA_ENUMERROR_InvalidConfigDescriptor;
-	
-	if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-	                              DCOMP_AOA_Host_NextAndroidAccessoryInterface) != DESCRIPTOR_SEARCH_COMP_Found)
-	{
-		return AOA_ENUMERROR_NoCompatibleInterfaceFound;
-	}
-	
-	AOAInterface = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Interface_t);
 
 	while (!(DataINEndpoint) || !(DataOUTEndpoint))
 	{
-		if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-		                              DCOMP_AOA_Host_NextInterfaceBulkEndpoint) != DESCRIPTOR_SEARCH_COMP_Found)
+		if (!(USB_Host_FindIndexedInterface(ConfigIndex, &InterfaceIndex, AOA_CSCP_AOADataClass,
+		                                    AOA_CSCP_AOADataSubclass, AOA_CSCP_AOADataProtocol, &AOAInterface)))
 		{
 			return AOA_ENUMERROR_NoCompatibleInterfaceFound;
 		}
 
-		USB_Descriptor_Endpoint_t* EndpointData = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Endpoint_t);
-
-		if ((EndpointData->EndpointAddress & ENDPOINT_DIR_MASK) == ENDPOINT_DIR_IN)
-		  DataINEndpoint  = EndpointData;
-		else
-		  DataOUTEndpoint = EndpointData;
+		DataINEndpoint  = USB_Host_GetIndexedEndpoint(&AOAInterface, ENDPOINT_DIR_IN,  EP_TYPE_BULK);
+		DataOUTEndpoint = USB_Host_GetIndexedEndpoint(&AOAInterface, ENDPOINT_DIR_OUT, EP_TYPE_BULK);
 	}
 
 	AOAInterfaceInfo->Config.DataINPipe.Size  = le16_to_cpu(DataINEndpoint->EndpointSize);
@@ -104,51 +94,11 @@ uint8_t AOA_Host_ConfigurePipes(USB_ClassInfo_AOA_Host_t* const AOAInterfaceInfo
 	  return false;
 
 	AOAInterfaceInfo->State.IsActive        = true;
-	AOAInterfaceInfo->State.InterfaceNumber = AOAInterface->InterfaceNumber;
+	AOAInterfaceInfo->State.InterfaceNumber = AOAInterface.Descriptor->InterfaceNumber;
 
 	return AOA_ENUMERROR_NoError;
 }
 
-static uint8_t DCOMP_AOA_Host_NextAndroidAccessoryInterface(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Interface)
-	{
-		USB_Descriptor_Interface_t* Interface = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Interface_t);
-
-		if ((Interface->Class    == AOA_CSCP_AOADataClass)    &&
-		    (Interface->SubClass == AOA_CSCP_AOADataSubclass) &&
-		    (Interface->Protocol == AOA_CSCP_AOADataProtocol))
-		{
-			return DESCRIPTOR_SEARCH_Found;
-		}
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
-static uint8_t DCOMP_AOA_Host_NextInterfaceBulkEndpoint(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Endpoint)
-	{
-		USB_Descriptor_Endpoint_t* Endpoint = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Endpoint_t);
-
-		uint8_t EndpointType = (Endpoint->Attributes & EP_TYPE_MASK);
-
-		if ((EndpointType == EP_TYPE_BULK) && (!(Pipe_IsEndpointBound(Endpoint->EndpointAddress))))
-		  return DESCRIPTOR_SEARCH_Found;
-	}
-	else if (Header->Type == DTYPE_Interface)
-	{
-		return DESCRIPTOR_SEARCH_Fail;
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
 void AOA_Host_USBTask(USB_ClassInfo_AOA_Host_t* const AOAInterfaceInfo)
 {
 	if ((USB_HostState != HOST_STATE_Configured) || !(AOAInterfaceInfo->State.IsActive))
@@ -41,147 +41,164 @@ uint8_t Audio_Host_ConfigurePipes(USB_ClassInfo_Audio_Host_t* const AudioInterfa
                                   uint16_t ConfigDescriptorSize,
                                   void* ConfigDescriptorData)
 {
-	USB_Descriptor_Endpoint_t*  DataINEndpoint          = NULL;
-	USB_Descriptor_Endpoint_t*  DataOUTEndpoint         = NULL;
-	USB_Descriptor_Interface_t* AudioControlInterface   = NULL;
-	USB_Descriptor_Interface_t* AudioStreamingInterface = NULL;
+	const USB_ConfigIndex_t*           ConfigIndex;
+	USB_ConfigIndex_Interface_t        AudioControlInterface   = { .Descriptor = NULL };
+	USB_ConfigIndex_Interface_t        AudioStreamingInterface = { .Descriptor = NULL };
+	USB_Descriptor_Endpoint_t*         DataINEndpoint          = NULL;
+	USB_Descriptor_Endpoint_t*         DataOUTEndpoint         = NULL;
+	USB_Descriptor_Endpoint_t*         FeedbackEndpoint        = NULL;
+	uint8_t                            InterfaceIndex          = 0;
 
 	memset(&AudioInterfaceInfo->State, 0x00, sizeof(AudioInterfaceInfo->State));
 
-	if (DESCRIPTOR_TYPE(ConfigDescriptorData) != DTYPE_Configuration)
+	if (!(ConfigIndex = USB_Host_GetConfigIndex(ConfigDescriptorSize, ConfigDescriptorData)))
 	  return AUDIO_ENUMERROR_InvalidConfigDescriptor;
 
-	while ((AudioInterfaceInfo->Config.DataINPipe.Address  && !(DataINEndpoint)) ||
+	while (!(AudioStreamingInterface.Descriptor) ||
+	       (AudioInterfaceInfo->Config.DataINPipe.Address  && !(DataINEndpoint)) ||
 	       (AudioInterfaceInfo->Config.DataOUTPipe.Address && !(DataOUTEndpoint)))
 	{
-		if (!(AudioControlInterface) ||
-		    USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-		                              DCOMP_Audio_Host_NextAudioInterfaceDataEndpoint) != DESCRIPTOR_SEARCH_COMP_Found)
+		if (!(AudioControlInterface.Descriptor) ||
+		    !(USB_Host_FindIndexedInterface(ConfigIndex, &InterfaceIndex, AUDIO_CSCP_AudioClass, AUDIO_CSCP_AudioStreamingSubclass,
+		                                    AUDIO_CSCP_StreamingProtocol, &AudioStreamingInterface)))
 		{
-			if (!(AudioControlInterface) ||
-			    USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-			                              DCOMP_Audio_Host_NextAudioStreamInterface) != DESCRIPTOR_SEARCH_COMP_Found)
+			if (!(USB_Host_FindIndexedInterface(ConfigIndex, &InterfaceIndex, AUDIO_CSCP_AudioClass, AUDIO_CSCP_ControlSubclass,
+			                                    AUDIO_CSCP_ControlProtocol, &AudioControlInterface)))
 			{
-				if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-				                              DCOMP_Audio_Host_NextAudioControlInterface) != DESCRIPTOR_SEARCH_COMP_Found)
-				{
-					return AUDIO_ENUMERROR_NoCompatibleInterfaceFound;
-				}
-
-				AudioControlInterface = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Interface_t);
-
-				if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-				                              DCOMP_Audio_Host_NextAudioStreamInterface) != DESCRIPTOR_SEARCH_COMP_Found)
-				{
-					return AUDIO_ENUMERROR_NoCompatibleInterfaceFound;
-				}
+				return AUDIO_ENUMERROR_NoCompatibleInterfaceFound;
 			}
 
-			AudioStreamingInterface = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Interface_t);
-
-			DataINEndpoint  = NULL;
-			DataOUTEndpoint = NULL;
-
 			continue;
 		}
 
-		USB_Descriptor_Endpoint_t* EndpointData = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Endpoint_t);
-
-		if ((EndpointData->EndpointAddress & ENDPOINT_DIR_MASK) == ENDPOINT_DIR_IN)
-		  DataINEndpoint  = EndpointData;
-		else
-		  DataOUTEndpoint = EndpointData;
-	}
-
-	AudioInterfaceInfo->Config.DataINPipe.Size   = le16_to_cpu(DataINEndpoint->EndpointSize);
-	AudioInterfaceInfo->Config.DataINPipe.EndpointAddress = DataINEndpoint->EndpointAddress;
-	AudioInterfaceInfo->Config.DataINPipe.Type   = EP_TYPE_ISOCHRONOUS;
-	AudioInterfaceInfo->Config.DataINPipe.Banks  = 2;
-	
-	AudioInterfaceInfo->Config.DataOUTPipe.Size  = le16_to_cpu(DataOUTEndpoint->EndpointSize);
-	AudioInterfaceInfo->Config.DataOUTPipe.EndpointAddress = DataOUTEndpoint->EndpointAddress;
-	AudioInterfaceInfo->Config.DataOUTPipe.Type  = EP_TYPE_ISOCHRONOUS;
-	AudioInterfaceInfo->Config.DataOUTPipe.Banks = 2;
-	
-	if (!(Pipe_ConfigurePipeTable(&AudioInterfaceInfo->Config.DataINPipe, 1)))
-	  return false;
-	
-	if (!(Pipe_ConfigurePipeTable(&AudioInterfaceInfo->Config.DataOUTPipe, 1)))
-	  return false;
-
-	AudioInterfaceInfo->State.ControlInterfaceNumber    = AudioControlInterface->InterfaceNumber;
-	AudioInterfaceInfo->State.StreamingInterfaceNumber  = AudioStreamingInterface->InterfaceNumber;
-	AudioInterfaceInfo->State.EnabledStreamingAltIndex  = AudioStreamingInterface->AlternateSetting;
+		DataINEndpoint   = Audio_Host_GetStreamingEndpoint(&AudioStreamingInterface, ENDPOINT_DIR_IN,  false);
+		DataOUTEndpoint  = Audio_Host_GetStreamingEndpoint(&AudioStreamingInterface, ENDPOINT_DIR_OUT, false);
+		FeedbackEndpoint = Audio_Host_GetStreamingEndpoint(&AudioStreamingInterface, ENDPOINT_DIR_IN,  true);
+	}
+
+	if (DataINEndpoint)
+	{
+		AudioInterfaceInfo->Config.DataINPipe.Size   = le16_to_cpu(DataINEndpoint->EndpointSize);
+		AudioInterfaceInfo->Config.DataINPipe.EndpointAddress = DataINEndpoint->EndpointAddress;
+		AudioInterfaceInfo->Config.DataINPipe.Type   = EP_TYPE_ISOCHRONOUS;
+		AudioInterfaceInfo->Config.DataINPipe.Banks  = 2;
+
+		if (!(Pipe_ConfigurePipeTable(&AudioInterfaceInfo->Config.DataINPipe, 1)))
+		  return AUDIO_ENUMERROR_PipeConfigurationFailed;
+	}
+
+	if (DataOUTEndpoint)
+	{
+		AudioInterfaceInfo->Config.DataOUTPipe.Size  = le16_to_cpu(DataOUTEndpoint->EndpointSize);
+		AudioInterfaceInfo->Config.DataOUTPipe.EndpointAddress = DataOUTEndpoint->EndpointAddress;
+		AudioInterfaceInfo->Config.DataOUTPipe.Type  = EP_TYPE_ISOCHRONOUS;
+		AudioInterfaceInfo->Config.DataOUTPipe.Banks = 2;
+
+		if (!(Pipe_ConfigurePipeTable(&AudioInterfaceInfo->Config.DataOUTPipe, 1)))
+		  return AUDIO_ENUMERROR_PipeConfigurationFailed;
+	}
+
+	if (FeedbackEndpoint && AudioInterfaceInfo->Config.FeedbackPipe.Address)
+	{
+		AudioInterfaceInfo->Config.FeedbackPipe.Size  = le16_to_cpu(FeedbackEndpoint->EndpointSize);
+		AudioInterfaceInfo->Config.FeedbackPipe.EndpointAddress = FeedbackEndpoint->EndpointAddress;
+		AudioInterfaceInfo->Config.FeedbackPipe.Type  = EP_TYPE_ISOCHRONOUS;
+		AudioInterfaceInfo->Config.FeedbackPipe.Banks = 1;
+
+		if (!(Pipe_ConfigurePipeTable(&AudioInterfaceInfo->Config.FeedbackPipe, 1)))
+		  return AUDIO_ENUMERROR_PipeConfigurationFailed;
+
+		AudioInterfaceInfo->State.HasFeedbackPipe = true;
+	}
+
+	AudioInterfaceInfo->State.ControlInterfaceNumber    = AudioControlInterface.Descriptor->InterfaceNumber;
+	AudioInterfaceInfo->State.StreamingInterfaceNumber  = AudioStreamingInterface.Descriptor->InterfaceNumber;
+	AudioInterfaceInfo->State.EnabledStreamingAltIndex  = AudioStreamingInterface.Descriptor->AlternateSetting;
 	AudioInterfaceInfo->State.IsActive = true;
 
 	return AUDIO_ENUMERROR_NoError;
 }
 
-static uint8_t DCOMP_Audio_Host_NextAudioControlInterface(void* CurrentDescriptor)
+static USB_Descriptor_Endpoint_t* Audio_Host_GetStreamingEndpoint(const USB_ConfigIndex_Interface_t* const Interface,
+                                                                  const uint8_t Direction,
+                                                                  const bool IsFeedback)
 {
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
+	USB_Descriptor_Endpoint_t* Endpoint = NULL;
 
-	if (Header->Type == DTYPE_Interface)
+	while ((Endpoint = USB_Host_GetNextIndexedEndpoint(Interface, Endpoint)) != NULL)
 	{
-		USB_Descriptor_Interface_t* Interface = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Interface_t);
-
-		if ((Interface->Class    == AUDIO_CSCP_AudioClass) &&
-		    (Interface->SubClass == AUDIO_CSCP_ControlSubclass) &&
-		    (Interface->Protocol == AUDIO_CSCP_ControlProtocol))
+		if (((Endpoint->EndpointAddress & ENDPOINT_DIR_MASK) != Direction) ||
+		    ((Endpoint->Attributes & EP_TYPE_MASK) != EP_TYPE_ISOCHRONOUS) ||
+		    Pipe_IsEndpointBound(Endpoint->EndpointAddress))
 		{
-			return DESCRIPTOR_SEARCH_Found;
+			continue;
 		}
+
+		/* Implicit feedback endpoints carry audio data, so only explicit feedback endpoints are excluded from the data search */
+		if (((Endpoint->Attributes & AUDIO_ENDPOINT_USAGE_MASK) == ENDPOINT_USAGE_FEEDBACK) == IsFeedback)
+		  return Endpoint;
 	}
 
-	return DESCRIPTOR_SEARCH_NotFound;
+	return NULL;
 }
 
-static uint8_t DCOMP_Audio_Host_NextAudioStreamInterface(void* CurrentDescriptor)
+uint8_t Audio_Host_StartStopStreaming(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo,
+			                          const bool EnableStreaming)
 {
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
+	if (!(AudioInterfaceInfo->State.IsActive))
+	  return HOST_SENDCONTROL_DeviceDisconnected;
+
+	uint8_t ErrorCode;
 
-	if (Header->Type == DTYPE_Interface)
+	if (!(EnableStreaming))
 	{
-		USB_Descriptor_Interface_t* Interface = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Interface_t);
+		AudioInterfaceInfo->State.StreamingEnabled = false;
 
-		if ((Interface->Class    == AUDIO_CSCP_AudioClass) &&
-		    (Interface->SubClass == AUDIO_CSCP_AudioStreamingSubclass) &&
-		    (Interface->Protocol == AUDIO_CSCP_StreamingProtocol))
+		/* Stop the streaming engine's pipes from polling the device once the stream has been disabled */
+		if (AudioInterfaceInfo->Config.DataINPipe.Address)
 		{
-			return DESCRIPTOR_SEARCH_Found;
+			Pipe_SelectPipe(AudioInterfaceInfo->Config.DataINPipe.Address);
+			Pipe_Freeze();
 		}
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
 
-static uint8_t DCOMP_Audio_Host_NextAudioInterfaceDataEndpoint(void* CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
+		if (AudioInterfaceInfo->Config.DataOUTPipe.Address)
+		{
+			Pipe_SelectPipe(AudioInterfaceInfo->Config.DataOUTPipe.Address);
+			Pipe_Freeze();
+		}
 
-	if (Header->Type == DTYPE_Endpoint)
-	{
-		USB_Descriptor_Endpoint_t* Endpoint = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Endpoint_t);
+		if (AudioInterfaceInfo->State.HasFeedbackPipe)
+		{
+			Pipe_SelectPipe(AudioInterfaceInfo->Config.FeedbackPipe.Address);
+			Pipe_Freeze();
+		}
 
-		if ((Endpoint->Attributes & EP_TYPE_MASK) == EP_TYPE_ISOCHRONOUS)
-		  return DESCRIPTOR_SEARCH_Found;
+		Pipe_SelectPipe(PIPE_CONTROLPIPE);
 	}
-	else if (Header->Type == DTYPE_Interface)
+
+	if ((ErrorCode = USB_Host_SetInterfaceAltSetting(AudioInterfaceInfo->State.StreamingInterfaceNumber,
+	                                                 EnableStreaming ? AudioInterfaceInfo->State.EnabledStreamingAltIndex : 0)) != HOST_SENDCONTROL_Successful)
 	{
-		return DESCRIPTOR_SEARCH_Fail;
+		return ErrorCode;
 	}
 
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
-uint8_t Audio_Host_StartStopStreaming(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo,
-			                          const bool EnableStreaming)
-{
-	if (!(AudioInterfaceInfo->State.IsActive))
-	  return HOST_SENDCONTROL_DeviceDisconnected;
+	if (EnableStreaming)
+	{
+		uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+		GlobalInterruptDisable();
+
+		memset(&AudioInterfaceInfo->State.INStream,  0x00, sizeof(Audio_Host_StreamRing_t));
+		memset(&AudioInterfaceInfo->State.OUTStream, 0x00, sizeof(Audio_Host_StreamRing_t));
+		AudioInterfaceInfo->State.FrameRemainder   = 0;
+		AudioInterfaceInfo->State.OUTStreamPrimed  = false;
+		AudioInterfaceInfo->State.Underruns        = 0;
+		AudioInterfaceInfo->State.Overruns         = 0;
+		AudioInterfaceInfo->State.StreamingEnabled = true;
+
+		SetGlobalInterruptMask(CurrentGlobalInt);
+	}
 
-	return USB_Host_SetInterfaceAltSetting(AudioInterfaceInfo->State.StreamingInterfaceNumber,
-	                                       EnableStreaming ? AudioInterfaceInfo->State.EnabledStreamingAltIndex : 0);
+	return HOST_SENDCONTROL_Successful;
 }
 
 uint8_t Audio_Host_GetSetEndpointProperty(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo,
@@ -219,5 +236,281 @@ uint8_t Audio_Host_GetSetEndpointProperty(USB_ClassInfo_Audio_Host_t* const Audi
 	return USB_Host_SendControlRequest(Data);
 }
 
+void Audio_Host_SetStreamSampleRate(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo,
+                                    const uint32_t SampleRate)
+{
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	AudioInterfaceInfo->State.NominalStreamRate = AUDIO_FEEDBACK_VALUE(SampleRate);
+	AudioInterfaceInfo->State.StreamRate        = AudioInterfaceInfo->State.NominalStreamRate;
+	AudioInterfaceInfo->State.FrameRemainder    = 0;
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+}
+
+void Audio_Host_ProcessStartOfFrame(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(AudioInterfaceInfo->State.IsActive) ||
+	    !(AudioInterfaceInfo->State.StreamingEnabled))
+	{
+		return;
+	}
+
+	uint8_t PrevPipe = Pipe_GetCurrentPipe();
+
+	if (AudioInterfaceInfo->State.HasFeedbackPipe)
+	  Audio_Host_ReceiveFeedback(AudioInterfaceInfo);
+
+	if (AudioInterfaceInfo->Config.OUTStreamBuffer && AudioInterfaceInfo->Config.DataOUTPipe.Address)
+	  Audio_Host_SendStreamPacket(AudioInterfaceInfo);
+
+	if (AudioInterfaceInfo->Config.INStreamBuffer && AudioInterfaceInfo->Config.DataINPipe.Address)
+	  Audio_Host_ReceiveStreamPacket(AudioInterfaceInfo);
+
+	Pipe_SelectPipe(PrevPipe);
+}
+
+uint16_t Audio_Host_WriteStreamFrames(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo,
+                                      const void* Frames,
+                                      const uint16_t TotalFrames)
+{
+	Audio_Host_StreamRing_t* Ring       = &AudioInterfaceInfo->State.OUTStream;
+	uint8_t*                 RingBuffer = AudioInterfaceInfo->Config.OUTStreamBuffer;
+	uint16_t                 RingFrames = AudioInterfaceInfo->Config.OUTStreamFrames;
+	uint8_t                  FrameSize  = AudioInterfaceInfo->Config.SampleFrameSize;
+	const uint8_t*           FrameData  = Frames;
+
+	if (!(RingBuffer))
+	  return 0;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+	uint16_t FramesFree = (RingFrames - Ring->Count);
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	uint16_t FramesToQueue = MIN(TotalFrames, FramesFree);
+	uint16_t FramesRem     = FramesToQueue;
+
+	/* Copy the frames into the free space of the ring, in at most two runs either side of the wrap point */
+	while (FramesRem)
+	{
+		uint16_t RunFrames = MIN(FramesRem, (uint16_t)(RingFrames - Ring->In));
+
+		memcpy(&RingBuffer[Ring->In * FrameSize], FrameData, (RunFrames * FrameSize));
+
+		FrameData += (RunFrames * FrameSize);
+		FramesRem -= RunFrames;
+		Ring->In  += RunFrames;
+
+		if (Ring->In == RingFrames)
+		  Ring->In = 0;
+	}
+
+	CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	Ring->Count += FramesToQueue;
+
+	if (FramesToQueue < TotalFrames)
+	  AudioInterfaceInfo->State.Overruns++;
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	return FramesToQueue;
+}
+
+uint16_t Audio_Host_ReadStreamFrames(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo,
+                                     void* Frames,
+                                     const uint16_t MaxFrames)
+{
+	Audio_Host_StreamRing_t* Ring       = &AudioInterfaceInfo->State.INStream;
+	uint8_t*                 RingBuffer = AudioInterfaceInfo->Config.INStreamBuffer;
+	uint16_t                 RingFrames = AudioInterfaceInfo->Config.INStreamFrames;
+	uint8_t                  FrameSize  = AudioInterfaceInfo->Config.SampleFrameSize;
+	uint8_t*                 FrameData  = Frames;
+
+	if (!(RingBuffer))
+	  return 0;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+	uint16_t FramesStored = Ring->Count;
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	uint16_t FramesToRead = MIN(MaxFrames, FramesStored);
+	uint16_t FramesRem    = FramesToRead;
+
+	/* Copy the frames out of the ring, in at most two runs either side of the wrap point */
+	while (FramesRem)
+	{
+		uint16_t RunFrames = MIN(FramesRem, (uint16_t)(RingFrames - Ring->Out));
+
+		memcpy(FrameData, &RingBuffer[Ring->Out * FrameSize], (RunFrames * FrameSize));
+
+		FrameData += (RunFrames * FrameSize);
+		FramesRem -= RunFrames;
+		Ring->Out += RunFrames;
+
+		if (Ring->Out == RingFrames)
+		  Ring->Out = 0;
+	}
+
+	CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+	Ring->Count -= FramesToRead;
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	return FramesToRead;
+}
+
+static void Audio_Host_SendStreamPacket(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo)
+{
+	Audio_Host_StreamRing_t* Ring       = &AudioInterfaceInfo->State.OUTStream;
+	uint8_t*                 RingBuffer = AudioInterfaceInfo->Config.OUTStreamBuffer;
+	uint16_t                 RingFrames = AudioInterfaceInfo->Config.OUTStreamFrames;
+	uint8_t                  FrameSize  = AudioInterfaceInfo->Config.SampleFrameSize;
+
+	Pipe_SelectPipe(AudioInterfaceInfo->Config.DataOUTPipe.Address);
+	Pipe_Unfreeze();
+
+	if (!(Pipe_IsOUTReady()))
+	  return;
+
+	/* Add this frame's share of the stream rate to the fractional frame accumulator, and send its whole frames */
+	uint32_t FrameAccumulator = (AudioInterfaceInfo->State.FrameRemainder + AudioInterfaceInfo->State.StreamRate);
+	uint16_t FramesInPacket   = (FrameAccumulator >> AUDIO_FEEDBACK_FRACTION_BITS);
+	uint16_t MaxFrames        = (AudioInterfaceInfo->Config.DataOUTPipe.Size / FrameSize);
+
+	AudioInterfaceInfo->State.FrameRemainder = (FrameAccumulator & ((1UL << AUDIO_FEEDBACK_FRACTION_BITS) - 1));
+
+	if (FramesInPacket > MaxFrames)
+	  FramesInPacket = MaxFrames;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+	uint16_t FramesStored = Ring->Count;
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	/* Hold off sending queued frames until the ring is half full, so that the producer's jitter can be absorbed */
+	if (!(AudioInterfaceInfo->State.OUTStreamPrimed) && (FramesStored >= (RingFrames >> 1)))
+	  AudioInterfaceInfo->State.OUTStreamPrimed = true;
+
+	uint16_t FramesToSend = (AudioInterfaceInfo->State.OUTStreamPrimed ? MIN(FramesInPacket, FramesStored) : 0);
+	uint16_t FramesRem    = FramesToSend;
+
+	while (FramesRem)
+	{
+		uint16_t RunFrames = MIN(FramesRem, (uint16_t)(RingFrames - Ring->Out));
+		uint8_t* RunData   = &RingBuffer[Ring->Out * FrameSize];
+
+		for (uint16_t BytesRem = (RunFrames * FrameSize); BytesRem; BytesRem--)
+		  Pipe_Write_8(*(RunData++));
+
+		FramesRem -= RunFrames;
+		Ring->Out += RunFrames;
+
+		if (Ring->Out == RingFrames)
+		  Ring->Out = 0;
+	}
+
+	CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+	Ring->Count -= FramesToSend;
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	/* Pad the packet out to its full length with silence if the ring ran dry, so that the device's timing is kept */
+	if (FramesToSend < FramesInPacket)
+	{
+		for (uint16_t BytesRem = ((FramesInPacket - FramesToSend) * FrameSize); BytesRem; BytesRem--)
+		  Pipe_Write_8(0);
+
+		/* An underrun restarts the priming of the ring, rather than playing each new frame as soon as it arrives */
+		if (AudioInterfaceInfo->State.OUTStreamPrimed)
+		{
+			AudioInterfaceInfo->State.OUTStreamPrimed = false;
+			AudioInterfaceInfo->State.Underruns++;
+		}
+	}
+
+	Pipe_ClearOUT();
+}
+
+static void Audio_Host_ReceiveStreamPacket(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo)
+{
+	Audio_Host_StreamRing_t* Ring       = &AudioInterfaceInfo->State.INStream;
+	uint8_t*                 RingBuffer = AudioInterfaceInfo->Config.INStreamBuffer;
+	uint16_t                 RingFrames = AudioInterfaceInfo->Config.INStreamFrames;
+	uint8_t                  FrameSize  = AudioInterfaceInfo->Config.SampleFrameSize;
+
+	Pipe_SelectPipe(AudioInterfaceInfo->Config.DataINPipe.Address);
+	Pipe_Unfreeze();
+
+	if (!(Pipe_IsINReceived()))
+	  return;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+	uint16_t FramesFree = (RingFrames - Ring->Count);
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	uint16_t FramesInPacket = (Pipe_BytesInPipe() / FrameSize);
+
+	if (FramesInPacket > FramesFree)
+	{
+		FramesInPacket = FramesFree;
+		AudioInterfaceInfo->State.Overruns++;
+	}
+
+	uint16_t FramesRem = FramesInPacket;
+
+	while (FramesRem)
+	{
+		uint16_t RunFrames = MIN(FramesRem, (uint16_t)(RingFrames - Ring->In));
+		uint8_t* RunData   = &RingBuffer[Ring->In * FrameSize];
+
+		for (uint16_t BytesRem = (RunFrames * FrameSize); BytesRem; BytesRem--)
+		  *(RunData++) = Pipe_Read_8();
+
+		FramesRem -= RunFrames;
+		Ring->In  += RunFrames;
+
+		if (Ring->In == RingFrames)
+		  Ring->In = 0;
+	}
+
+	CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+	Ring->Count += FramesInPacket;
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	Pipe_ClearIN();
+}
+
+static void Audio_Host_ReceiveFeedback(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo)
+{
+	Pipe_SelectPipe(AudioInterfaceInfo->Config.FeedbackPipe.Address);
+	Pipe_Unfreeze();
+
+	if (!(Pipe_IsINReceived()))
+	  return;
+
+	/* Full speed devices report their rate as a three byte 10.14 fixed point number of samples per frame */
+	if (Pipe_BytesInPipe() >= 3)
+	{
+		uint32_t FeedbackValue = Pipe_Read_16_LE();
+		FeedbackValue |= ((uint32_t)Pipe_Read_8() << 16);
+
+		uint32_t NominalRate = AudioInterfaceInfo->State.NominalStreamRate;
+		uint32_t Tolerance   = (NominalRate >> 3);
+
+		/* Ignore rates more than an eighth away from the nominal rate, as they can only come from a misbehaving device */
+		if ((FeedbackValue > (NominalRate - Tolerance)) && (FeedbackValue < (NominalRate + Tolerance)))
+		  AudioInterfaceInfo->State.StreamRate = FeedbackValue;
+	}
+
+	Pipe_ClearIN();
+}
+
 #endif
 
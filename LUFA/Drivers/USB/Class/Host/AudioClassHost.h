@@ -47,6 +47,28 @@
  *  \section Sec_ModDescription Module Description
  *  Host Mode USB Class driver framework interface, for the Audio 1.0 USB Class driver.
  *
+ *  Audio samples may be moved either one at a time through the \c Audio_Host_ReadSample*() and \c Audio_Host_WriteSample*()
+ *  functions, or through the driver's buffered streaming engine. To use the streaming engine, give the driver a ring
+ *  buffer of sample frames for each stream direction in its configuration and call \ref Audio_Host_ProcessStartOfFrame()
+ *  once for each host Start Of Frame event. The driver then moves exactly one isochronous packet per stream in each bus
+ *  frame between the pipes and the ring buffers, while the application fills or drains the ring buffers at its own pace
+ *  via \ref Audio_Host_WriteStreamFrames() and \ref Audio_Host_ReadStreamFrames(), which may be called from a sample
+ *  timer interrupt.
+ *
+ *  \note Each call to \ref Audio_Host_ProcessStartOfFrame() copies a whole packet of sample data, which on the AVR8
+ *        architecture takes longer than the period of a typical sample timer. As the \ref EVENT_USB_Host_StartOfFrame()
+ *        event is fired from within the blocking USB interrupt, the event handler should only set a flag which the
+ *        application's main loop then tests to call \ref Audio_Host_ProcessStartOfFrame(), so that the sample timer
+ *        interrupt is not held off by the copy.
+ *
+ *  Queued OUT sample frames are held back until the OUT ring buffer is half full, both when the stream starts and after
+ *  it has run dry, so that jitter between the application's sample clock and the bus frames can be absorbed.
+ *
+ *  The number of sample frames sent in each OUT packet is taken from a fractional frame accumulator, so that sample
+ *  rates which are not a whole number of samples per millisecond (such as 44.1KHz) are sent at the correct average
+ *  rate. When the attached device has an isochronous feedback endpoint for an asynchronous stream, the accumulator
+ *  follows the rate reported by the device rather than the nominal rate, so that the host matches the device's clock.
+ *
  *  @{
  */
 
@@ -69,6 +91,18 @@
 
 	/* Public Interface - May be used in end-application: */
 		/* Type Defines: */
+			/** \brief Audio Class Host Mode Stream Ring Buffer State Structure.
+			 *
+			 *  Type define for the state of one of the sample frame ring buffers of the Audio Class host streaming engine. The
+			 *  buffer storage itself is supplied by the application in the interface's configuration.
+			 */
+			typedef struct
+			{
+				uint16_t          In; /**< Index of the next sample frame to be inserted into the ring buffer. */
+				uint16_t          Out; /**< Index of the next sample frame to be removed from the ring buffer. */
+				volatile uint16_t Count; /**< Number of sample frames currently stored in the ring buffer. */
+			} Audio_Host_StreamRing_t;
+
 			/** \brief Audio Class Host Mode Configuration and State Structure.
 			 *
 			 *  Class state structure. An instance of this structure should be made within the user application,
@@ -81,6 +115,21 @@
 				{
 					USB_Pipe_Table_t DataINPipe; /**< Data IN Pipe configuration table. */
 					USB_Pipe_Table_t DataOUTPipe; /**< Data OUT Pipe configuration table. */
+					USB_Pipe_Table_t FeedbackPipe; /**< Optional rate feedback IN Pipe configuration table, used when the attached
+					                                *   device has an asynchronous OUT stream. Leave the address as zero if unused.
+					                                */
+
+					uint8_t  SampleFrameSize; /**< Size in bytes of a single sample frame of the buffered streams, i.e. the
+					                           *   sample subframe size multiplied by the number of channels.
+					                           */
+					void*    INStreamBuffer; /**< Storage for the buffered IN stream's ring buffer, or \c NULL if the IN stream
+					                          *   is not buffered.
+					                          */
+					uint16_t INStreamFrames; /**< Size of the buffered IN stream's ring buffer, in sample frames. */
+					void*    OUTStreamBuffer; /**< Storage for the buffered OUT stream's ring buffer, or \c NULL if the OUT stream
+					                           *   is not buffered.
+					                           */
+					uint16_t OUTStreamFrames; /**< Size of the buffered OUT stream's ring buffer, in sample frames. */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */
@@ -94,6 +143,21 @@
 					uint8_t StreamingInterfaceNumber; /**< Interface index of the Audio Streaming interface within the attached device. */
 
 					uint8_t EnabledStreamingAltIndex; /**< Alternative setting index of the Audio Streaming interface when the stream is enabled. */
+
+					bool     HasFeedbackPipe; /**< Indicates if the feedback pipe has been bound to a feedback endpoint of the attached device. */
+					bool     StreamingEnabled; /**< Indicates if the audio stream has been enabled via \ref Audio_Host_StartStopStreaming(). */
+					uint32_t NominalStreamRate; /**< Nominal OUT stream rate, in samples per frame in 10.14 fixed point format. */
+					uint32_t StreamRate; /**< Current OUT stream rate, in samples per frame in 10.14 fixed point format, following
+					                      *   the device's feedback endpoint where present.
+					                      */
+					uint16_t FrameRemainder; /**< Fractional sample frame accumulator of the OUT stream, in 2^-14 frame units. */
+					Audio_Host_StreamRing_t INStream; /**< Ring buffer state of the buffered IN stream. */
+					Audio_Host_StreamRing_t OUTStream; /**< Ring buffer state of the buffered OUT stream. */
+					bool     OUTStreamPrimed; /**< Indicates if the OUT stream ring buffer has been filled to half its size since the
+					                           *   stream was started or last ran dry, so that its frames are being sent.
+					                           */
+					uint16_t Underruns; /**< Number of times the OUT stream ring buffer ran dry, so that silence was sent. */
+					uint16_t Overruns; /**< Number of times sample frames were dropped as a stream ring buffer was full. */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 						  *   <b>may</b> be set to initial values, but may also be ignored to default to sane values when
 						  *   the interface is enumerated.
@@ -159,6 +223,55 @@
 			                                          const uint16_t DataLength,
 			                                          void* const Data) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(6);
 
+			/** Sets the nominal sampling frequency of the given Audio interface's buffered OUT stream, from which the number of
+			 *  sample frames sent in each packet is derived until the attached device reports its actual rate through its
+			 *  feedback endpoint. This should be called after the sampling frequency has been set in the device via
+			 *  \ref Audio_Host_GetSetEndpointProperty().
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class host configuration and state.
+			 *  \param[in]     SampleRate          Sampling frequency of the stream, in Hz.
+			 */
+			void Audio_Host_SetStreamSampleRate(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo,
+			                                    const uint32_t SampleRate) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Runs the buffered streaming engine of the given Audio interface for the current bus frame, sending the next OUT
+			 *  packet from the OUT stream ring buffer, storing any received IN packet into the IN stream ring buffer and reading
+			 *  any new rate from the feedback pipe. This should be called once for each library \ref EVENT_USB_Host_StartOfFrame()
+			 *  event, which must be enabled via \ref USB_Host_EnableSOFEvents().
+			 *
+			 *  \note This function should be called from the application's main loop after the event has fired rather than from
+			 *        the event handler itself, as the event runs inside the USB interrupt and the packet copy would otherwise
+			 *        block any sample timer interrupt for its duration.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class host configuration and state.
+			 */
+			void Audio_Host_ProcessStartOfFrame(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Queues sample frames into the buffered OUT stream of the given Audio interface, to be sent in the following
+			 *  bus frames. Sample frames which do not fit into the ring buffer are dropped and counted as an overrun.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class host configuration and state.
+			 *  \param[in]     Frames              Pointer to the interleaved sample frames to queue.
+			 *  \param[in]     TotalFrames         Number of sample frames to queue.
+			 *
+			 *  \return Number of sample frames queued.
+			 */
+			uint16_t Audio_Host_WriteStreamFrames(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo,
+			                                      const void* Frames,
+			                                      const uint16_t TotalFrames) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Retrieves received sample frames from the buffered IN stream of the given Audio interface.
+			 *
+			 *  \param[in,out] AudioInterfaceInfo  Pointer to a structure containing an Audio Class host configuration and state.
+			 *  \param[out]    Frames              Pointer to a buffer where the interleaved sample frames are to be stored.
+			 *  \param[in]     MaxFrames           Maximum number of sample frames to retrieve.
+			 *
+			 *  \return Number of sample frames retrieved.
+			 */
+			uint16_t Audio_Host_ReadStreamFrames(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo,
+			                                     void* Frames,
+			                                     const uint16_t MaxFrames) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
 		/* Inline Functions: */
 			/** General management task for a given Audio host class interface, required for the correct operation of
 			 *  the interface. This should be called frequently in the main program loop, before the master USB management task
@@ -389,14 +502,18 @@
 
 	/* Private Interface - For use in library only: */
 	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define AUDIO_ENDPOINT_USAGE_MASK         (3 << 4)
+			#define AUDIO_FEEDBACK_FRACTION_BITS      14
+
 		/* Function Prototypes: */
 			#if defined(__INCLUDE_FROM_AUDIO_HOST_C)
-				static uint8_t DCOMP_Audio_Host_NextAudioControlInterface(void* CurrentDescriptor)
-				                                                          ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-				static uint8_t DCOMP_Audio_Host_NextAudioStreamInterface(void* CurrentDescriptor)
-				                                                         ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-				static uint8_t DCOMP_Audio_Host_NextAudioInterfaceDataEndpoint(void* CurrentDescriptor)
-				                                                               ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
+				static USB_Descriptor_Endpoint_t* Audio_Host_GetStreamingEndpoint(const USB_ConfigIndex_Interface_t* const Interface,
+				                                                                  const uint8_t Direction,
+				                                                                  const bool IsFeedback) ATTR_NON_NULL_PTR_ARG(1);
+				static void Audio_Host_SendStreamPacket(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+				static void Audio_Host_ReceiveStreamPacket(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+				static void Audio_Host_ReceiveFeedback(USB_ClassInfo_Audio_Host_t* const AudioInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 			#endif
 	#endif
 
@@ -41,62 +41,40 @@ uint8_t CDC_Host_ConfigurePipes(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo
                                 uint16_t ConfigDescriptorSize,
                                 void* ConfigDescriptorData)
 {
-	USB_Descriptor_Endpoint_t*  DataINEndpoint       = NULL;
-	USB_Descriptor_Endpoint_t*  DataOUTEndpoint      = NULL;
-	USB_Descriptor_Endpoint_t*  NotificationEndpoint = NULL;
-	USB_Descriptor_Interface_t* CDCControlInterface  = NULL;
+	const USB_ConfigIndex_t*           ConfigIndex;
+	USB_ConfigIndex_Interface_t        CDCControlInterface;
+	USB_ConfigIndex_Interface_t        CDCDataInterface;
+	USB_Descriptor_Endpoint_t*         DataINEndpoint       = NULL;
+	USB_Descriptor_Endpoint_t*         DataOUTEndpoint      = NULL;
+	USB_Descriptor_Endpoint_t*         NotificationEndpoint = NULL;
+	uint8_t                            InterfaceIndex       = 0;
 
 	memset(&CDCInterfaceInfo->State, 0x00, sizeof(CDCInterfaceInfo->State));
 
-	if (DESCRIPTOR_TYPE(ConfigDescriptorData) != DTYPE_Configuration)
+	if (!(ConfigIndex = USB_Host_GetConfigIndex(ConfigDescriptorSize, ConfigDescriptorData)))
 	  return CDC_ENUMERROR_InvalidConfigDescriptor;
 
-	while (!(DataINEndpoint) || !(DataOUTEndpoint) || !(NotificationEndpoint))
+	while (!(NotificationEndpoint))
 	{
-		if (!(CDCControlInterface) ||
-		    USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-		                              DCOMP_CDC_Host_NextCDCInterfaceEndpoint) != DESCRIPTOR_SEARCH_COMP_Found)
+		if (!(USB_Host_FindIndexedInterface(ConfigIndex, &InterfaceIndex, CDC_CSCP_CDCClass,
+		                                    CDC_CSCP_ACMSubclass, CDC_CSCP_ATCommandProtocol, &CDCControlInterface)))
 		{
-			if (NotificationEndpoint)
-			{
-				if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-				                              DCOMP_CDC_Host_NextCDCDataInterface) != DESCRIPTOR_SEARCH_COMP_Found)
-				{
-					return CDC_ENUMERROR_NoCompatibleInterfaceFound;
-				}
-
-				DataINEndpoint  = NULL;
-				DataOUTEndpoint = NULL;
-			}
-			else
-			{
-				if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-				                              DCOMP_CDC_Host_NextCDCControlInterface) != DESCRIPTOR_SEARCH_COMP_Found)
-				{
-					return CDC_ENUMERROR_NoCompatibleInterfaceFound;
-				}
-
-				CDCControlInterface = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Interface_t);
-
-				NotificationEndpoint = NULL;
-			}
-
-			continue;
+			return CDC_ENUMERROR_NoCompatibleInterfaceFound;
 		}
 
-		USB_Descriptor_Endpoint_t* EndpointData = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Endpoint_t);
+		NotificationEndpoint = USB_Host_GetIndexedEndpoint(&CDCControlInterface, ENDPOINT_DIR_IN, EP_TYPE_INTERRUPT);
+	}
 
-		if ((EndpointData->EndpointAddress & ENDPOINT_DIR_MASK) == ENDPOINT_DIR_IN)
-		{
-			if ((EndpointData->Attributes & EP_TYPE_MASK) == EP_TYPE_INTERRUPT)
-			  NotificationEndpoint = EndpointData;
-			else
-			  DataINEndpoint = EndpointData;
-		}
-		else
+	while (!(DataINEndpoint) || !(DataOUTEndpoint))
+	{
+		if (!(USB_Host_FindIndexedInterface(ConfigIndex, &InterfaceIndex, CDC_CSCP_CDCDataClass,
+		                                    CDC_CSCP_NoDataSubclass, CDC_CSCP_NoDataProtocol, &CDCDataInterface)))
 		{
-			DataOUTEndpoint = EndpointData;
+			return CDC_ENUMERROR_NoCompatibleInterfaceFound;
 		}
+
+		DataINEndpoint  = USB_Host_GetIndexedEndpoint(&CDCDataInterface, ENDPOINT_DIR_IN,  EP_TYPE_BULK);
+		DataOUTEndpoint = USB_Host_GetIndexedEndpoint(&CDCDataInterface, ENDPOINT_DIR_OUT, EP_TYPE_BULK);
 	}
 
 	CDCInterfaceInfo->Config.DataINPipe.Size  = le16_to_cpu(DataINEndpoint->EndpointSize);
@@ -120,7 +98,7 @@ uint8_t CDC_Host_ConfigurePipes(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo
 	if (!(Pipe_ConfigurePipeTable(&CDCInterfaceInfo->Config.NotificationPipe, 1)))
 	  return false;
 
-	CDCInterfaceInfo->State.ControlInterfaceNumber = CDCControlInterface->InterfaceNumber;
+	CDCInterfaceInfo->State.ControlInterfaceNumber = CDCControlInterface.Descriptor->InterfaceNumber;
 	CDCInterfaceInfo->State.ControlLineStates.HostToDevice = (CDC_CONTROL_LINE_OUT_RTS | CDC_CONTROL_LINE_OUT_DTR);
 	CDCInterfaceInfo->State.ControlLineStates.DeviceToHost = (CDC_CONTROL_LINE_IN_DCD  | CDC_CONTROL_LINE_IN_DSR);
 	CDCInterfaceInfo->State.IsActive = true;
@@ -128,68 +106,6 @@ uint8_t CDC_Host_ConfigurePipes(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo
 	return CDC_ENUMERROR_NoError;
 }
 
-static uint8_t DCOMP_CDC_Host_NextCDCControlInterface(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Interface)
-	{
-		USB_Descriptor_Interface_t* Interface = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Interface_t);
-
-		if ((Interface->Class    == CDC_CSCP_CDCClass)    &&
-		    (Interface->SubClass == CDC_CSCP_ACMSubclass) &&
-		    (Interface->Protocol == CDC_CSCP_ATCommandProtocol))
-		{
-			return DESCRIPTOR_SEARCH_Found;
-		}
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
-static uint8_t DCOMP_CDC_Host_NextCDCDataInterface(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Interface)
-	{
-		USB_Descriptor_Interface_t* Interface = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Interface_t);
-
-		if ((Interface->Class    == CDC_CSCP_CDCDataClass)   &&
-		    (Interface->SubClass == CDC_CSCP_NoDataSubclass) &&
-		    (Interface->Protocol == CDC_CSCP_NoDataProtocol))
-		{
-			return DESCRIPTOR_SEARCH_Found;
-		}
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
-static uint8_t DCOMP_CDC_Host_NextCDCInterfaceEndpoint(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Endpoint)
-	{
-		USB_Descriptor_Endpoint_t* Endpoint = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Endpoint_t);
-
-		uint8_t EndpointType = (Endpoint->Attributes & EP_TYPE_MASK);
-
-		if (((EndpointType == EP_TYPE_BULK) || (EndpointType == EP_TYPE_INTERRUPT)) &&
-		    !(Pipe_IsEndpointBound(Endpoint->EndpointAddress)))
-		{
-			return DESCRIPTOR_SEARCH_Found;
-		}
-	}
-	else if (Header->Type == DTYPE_Interface)
-	{
-		return DESCRIPTOR_SEARCH_Fail;
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
 void CDC_Host_USBTask(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo)
 {
 	if ((USB_HostState != HOST_STATE_Configured) || !(CDCInterfaceInfo->State.IsActive))
@@ -41,126 +41,63 @@ uint8_t HID_Host_ConfigurePipes(USB_ClassInfo_HID_Host_t* const HIDInterfaceInfo
                                 uint16_t ConfigDescriptorSize,
                                 void* ConfigDescriptorData)
 {
-	USB_Descriptor_Endpoint_t*  DataINEndpoint  = NULL;
-	USB_Descriptor_Endpoint_t*  DataOUTEndpoint = NULL;
-	USB_Descriptor_Interface_t* HIDInterface    = NULL;
-	USB_HID_Descriptor_HID_t*   HIDDescriptor   = NULL;
+	const USB_ConfigIndex_t*           ConfigIndex;
+	USB_ConfigIndex_Interface_t        HIDInterface;
+	USB_Descriptor_Endpoint_t*         DataINEndpoint  = NULL;
+	USB_Descriptor_Endpoint_t*         DataOUTEndpoint = NULL;
+	USB_HID_Descriptor_HID_t*          HIDDescriptor   = NULL;
+	uint8_t                            InterfaceIndex  = 0;
 
 	memset(&HIDInterfaceInfo->State, 0x00, sizeof(HIDInterfaceInfo->State));
 
-	if (DESCRIPTOR_TYPE(ConfigDescriptorData) != DTYPE_Configuration)
+	if (!(ConfigIndex = USB_Host_GetConfigIndex(ConfigDescriptorSize, ConfigDescriptorData)))
 	  return HID_ENUMERROR_InvalidConfigDescriptor;
 
-	while (!(DataINEndpoint) || !(DataOUTEndpoint))
+	while (!(DataINEndpoint))
 	{
-		if (!(HIDInterface) ||
-		    USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-		                              DCOMP_HID_Host_NextHIDInterfaceEndpoint) != DESCRIPTOR_SEARCH_COMP_Found)
-		{
-			if (DataINEndpoint || DataOUTEndpoint)
-			  break;
-
-			do
-			{
-				if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-				                              DCOMP_HID_Host_NextHIDInterface) != DESCRIPTOR_SEARCH_COMP_Found)
-				{
-					return HID_ENUMERROR_NoCompatibleInterfaceFound;
-				}
-
-				HIDInterface = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Interface_t);
-			} while (HIDInterfaceInfo->Config.HIDInterfaceProtocol &&
-					 (HIDInterface->Protocol != HIDInterfaceInfo->Config.HIDInterfaceProtocol));
-
-			if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-			                              DCOMP_HID_Host_NextHIDDescriptor) != DESCRIPTOR_SEARCH_COMP_Found)
-			{
-				return HID_ENUMERROR_NoCompatibleInterfaceFound;
-			}
-
-			HIDDescriptor = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_HID_Descriptor_HID_t);
-
-			DataINEndpoint  = NULL;
-			DataOUTEndpoint = NULL;
+		if (!(USB_Host_GetIndexedInterface(ConfigIndex, &InterfaceIndex, &HIDInterface)))
+		  return HID_ENUMERROR_NoCompatibleInterfaceFound;
 
+		if ((HIDInterface.Descriptor->Class != HID_CSCP_HIDClass) ||
+		    (HIDInterfaceInfo->Config.HIDInterfaceProtocol &&
+		     (HIDInterface.Descriptor->Protocol != HIDInterfaceInfo->Config.HIDInterfaceProtocol)))
+		{
 			continue;
 		}
 
-		USB_Descriptor_Endpoint_t* EndpointData = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Endpoint_t);
+		if (!(HIDDescriptor = USB_Host_GetIndexedClassDescriptor(&HIDInterface, HID_DTYPE_HID)))
+		  continue;
 
-		if ((EndpointData->EndpointAddress & ENDPOINT_DIR_MASK) == ENDPOINT_DIR_IN)
-		  DataINEndpoint  = EndpointData;
-		else
-		  DataOUTEndpoint = EndpointData;
+		DataINEndpoint  = USB_Host_GetIndexedEndpoint(&HIDInterface, ENDPOINT_DIR_IN,  EP_TYPE_INTERRUPT);
+		DataOUTEndpoint = USB_Host_GetIndexedEndpoint(&HIDInterface, ENDPOINT_DIR_OUT, EP_TYPE_INTERRUPT);
 	}
 
 	HIDInterfaceInfo->Config.DataINPipe.Size  = le16_to_cpu(DataINEndpoint->EndpointSize);
 	HIDInterfaceInfo->Config.DataINPipe.EndpointAddress = DataINEndpoint->EndpointAddress;
 	HIDInterfaceInfo->Config.DataINPipe.Type  = EP_TYPE_INTERRUPT;
-	
-	HIDInterfaceInfo->Config.DataOUTPipe.Size = le16_to_cpu(DataOUTEndpoint->EndpointSize);
-	HIDInterfaceInfo->Config.DataOUTPipe.EndpointAddress = DataOUTEndpoint->EndpointAddress;
-	HIDInterfaceInfo->Config.DataOUTPipe.Type = EP_TYPE_INTERRUPT;
-	
+
 	if (!(Pipe_ConfigurePipeTable(&HIDInterfaceInfo->Config.DataINPipe, 1)))
 	  return false;
-	
-	if (!(Pipe_ConfigurePipeTable(&HIDInterfaceInfo->Config.DataOUTPipe, 1)))
-	  return false;
 
-	HIDInterfaceInfo->State.InterfaceNumber      = HIDInterface->InterfaceNumber;
-	HIDInterfaceInfo->State.HIDReportSize        = LE16_TO_CPU(HIDDescriptor->HIDReportLength);
-	HIDInterfaceInfo->State.SupportsBootProtocol = (HIDInterface->SubClass != HID_CSCP_NonBootProtocol);
-	HIDInterfaceInfo->State.LargestReportSize    = 8;
-	HIDInterfaceInfo->State.IsActive             = true;
-
-	return HID_ENUMERROR_NoError;
-}
-
-static uint8_t DCOMP_HID_Host_NextHIDInterface(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Interface)
+	if (DataOUTEndpoint)
 	{
-		USB_Descriptor_Interface_t* Interface = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Interface_t);
+		HIDInterfaceInfo->Config.DataOUTPipe.Size = le16_to_cpu(DataOUTEndpoint->EndpointSize);
+		HIDInterfaceInfo->Config.DataOUTPipe.EndpointAddress = DataOUTEndpoint->EndpointAddress;
+		HIDInterfaceInfo->Config.DataOUTPipe.Type = EP_TYPE_INTERRUPT;
 
-		if (Interface->Class == HID_CSCP_HIDClass)
-		  return DESCRIPTOR_SEARCH_Found;
-	}
+		if (!(Pipe_ConfigurePipeTable(&HIDInterfaceInfo->Config.DataOUTPipe, 1)))
+		  return false;
 
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
-static uint8_t DCOMP_HID_Host_NextHIDDescriptor(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == HID_DTYPE_HID)
-	  return DESCRIPTOR_SEARCH_Found;
-	else if (Header->Type == DTYPE_Interface)
-	  return DESCRIPTOR_SEARCH_Fail;
-	else
-	  return DESCRIPTOR_SEARCH_NotFound;
-}
-
-static uint8_t DCOMP_HID_Host_NextHIDInterfaceEndpoint(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Endpoint)
-	{
-		USB_Descriptor_Endpoint_t* Endpoint = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Endpoint_t);
-
-		if (!(Pipe_IsEndpointBound(Endpoint->EndpointAddress)))
-		  return DESCRIPTOR_SEARCH_Found;
-	}
-	else if (Header->Type == DTYPE_Interface)
-	{
-		return DESCRIPTOR_SEARCH_Fail;
+		HIDInterfaceInfo->State.DeviceUsesOUTPipe = (HIDInterfaceInfo->Config.DataOUTPipe.Address != 0);
 	}
 
-	return DESCRIPTOR_SEARCH_NotFound;
+	HIDInterfaceInfo->State.InterfaceNumber      = HIDInterface.Descriptor->InterfaceNumber;
+	HIDInterfaceInfo->State.HIDReportSize        = LE16_TO_CPU(HIDDescriptor->HIDReportLength);
+	HIDInterfaceInfo->State.SupportsBootProtocol = (HIDInterface.Descriptor->SubClass != HID_CSCP_NonBootProtocol);
+	HIDInterfaceInfo->State.LargestReportSize    = 8;
+	HIDInterfaceInfo->State.IsActive             = true;
+
+	return HID_ENUMERROR_NoError;
 }
 
 #if !defined(HID_HOST_BOOT_PROTOCOL_ONLY)
@@ -289,19 +289,6 @@
 				(void)HIDInterfaceInfo;
 			}
 
-	/* Private Interface - For use in library only: */
-	#if !defined(__DOXYGEN__)
-		/* Function Prototypes: */
-			#if defined(__INCLUDE_FROM_HID_HOST_C)
-				static uint8_t DCOMP_HID_Host_NextHIDInterface(void* const CurrentDescriptor)
-				                                               ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-				static uint8_t DCOMP_HID_Host_NextHIDDescriptor(void* const CurrentDescriptor)
-				                                                ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-				static uint8_t DCOMP_HID_Host_NextHIDInterfaceEndpoint(void* const CurrentDescriptor)
-				                                                       ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-			#endif
-	#endif
-
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			}
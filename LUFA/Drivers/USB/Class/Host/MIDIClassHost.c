@@ -41,41 +41,27 @@ uint8_t MIDI_Host_ConfigurePipes(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceI
                                  uint16_t ConfigDescriptorSize,
                                  void* ConfigDescriptorData)
 {
-	USB_Descriptor_Endpoint_t*  DataINEndpoint  = NULL;
-	USB_Descriptor_Endpoint_t*  DataOUTEndpoint = NULL;
-	USB_Descriptor_Interface_t* MIDIInterface   = NULL;
+	const USB_ConfigIndex_t*           ConfigIndex;
+	USB_ConfigIndex_Interface_t        MIDIInterface;
+	USB_Descriptor_Endpoint_t*         DataINEndpoint  = NULL;
+	USB_Descriptor_Endpoint_t*         DataOUTEndpoint = NULL;
+	uint8_t                            InterfaceIndex  = 0;
 
 	memset(&MIDIInterfaceInfo->State, 0x00, sizeof(MIDIInterfaceInfo->State));
 
-	if (DESCRIPTOR_TYPE(ConfigDescriptorData) != DTYPE_Configuration)
+	if (!(ConfigIndex = USB_Host_GetConfigIndex(ConfigDescriptorSize, ConfigDescriptorData)))
 	  return MIDI_ENUMERROR_InvalidConfigDescriptor;
 
 	while (!(DataINEndpoint) || !(DataOUTEndpoint))
 	{
-		if (!(MIDIInterface) ||
-		    USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-		                              DCOMP_MIDI_Host_NextMIDIStreamingDataEndpoint) != DESCRIPTOR_SEARCH_COMP_Found)
+		if (!(USB_Host_FindIndexedInterface(ConfigIndex, &InterfaceIndex, AUDIO_CSCP_AudioClass,
+		                                    AUDIO_CSCP_MIDIStreamingSubclass, AUDIO_CSCP_StreamingProtocol, &MIDIInterface)))
 		{
-			if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-			                              DCOMP_MIDI_Host_NextMIDIStreamingInterface) != DESCRIPTOR_SEARCH_COMP_Found)
-			{
-				return MIDI_ENUMERROR_NoCompatibleInterfaceFound;
-			}
-
-			MIDIInterface = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Interface_t);
-
-			DataINEndpoint  = NULL;
-			DataOUTEndpoint = NULL;
-
-			continue;
+			return MIDI_ENUMERROR_NoCompatibleInterfaceFound;
 		}
 
-		USB_Descriptor_Endpoint_t* EndpointData = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Endpoint_t);
-
-		if ((EndpointData->EndpointAddress & ENDPOINT_DIR_MASK) == ENDPOINT_DIR_IN)
-		  DataINEndpoint  = EndpointData;
-		else
-		  DataOUTEndpoint = EndpointData;
+		DataINEndpoint  = USB_Host_GetIndexedEndpoint(&MIDIInterface, ENDPOINT_DIR_IN,  EP_TYPE_BULK);
+		DataOUTEndpoint = USB_Host_GetIndexedEndpoint(&MIDIInterface, ENDPOINT_DIR_OUT, EP_TYPE_BULK);
 	}
 
 	MIDIInterfaceInfo->Config.DataINPipe.Size  = le16_to_cpu(DataINEndpoint->EndpointSize);
@@ -87,57 +73,17 @@ uint8_t MIDI_Host_ConfigurePipes(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceI
 	MIDIInterfaceInfo->Config.DataOUTPipe.Type = EP_TYPE_BULK;
 	
 	if (!(Pipe_ConfigurePipeTable(&MIDIInterfaceInfo->Config.DataINPipe, 1)))
-	  return false;
+	  return MIDI_ENUMERROR_PipeConfigurationFailed;
 	
 	if (!(Pipe_ConfigurePipeTable(&MIDIInterfaceInfo->Config.DataOUTPipe, 1)))
-	  return false;	
+	  return MIDI_ENUMERROR_PipeConfigurationFailed;
 
-	MIDIInterfaceInfo->State.InterfaceNumber = MIDIInterface->InterfaceNumber;
+	MIDIInterfaceInfo->State.InterfaceNumber = MIDIInterface.Descriptor->InterfaceNumber;
 	MIDIInterfaceInfo->State.IsActive = true;
 
 	return MIDI_ENUMERROR_NoError;
 }
 
-static uint8_t DCOMP_MIDI_Host_NextMIDIStreamingInterface(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Interface)
-	{
-		USB_Descriptor_Interface_t* Interface = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Interface_t);
-
-		if ((Interface->Class    == AUDIO_CSCP_AudioClass)            &&
-		    (Interface->SubClass == AUDIO_CSCP_MIDIStreamingSubclass) &&
-		    (Interface->Protocol == AUDIO_CSCP_StreamingProtocol))
-		{
-			return DESCRIPTOR_SEARCH_Found;
-		}
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
-static uint8_t DCOMP_MIDI_Host_NextMIDIStreamingDataEndpoint(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Endpoint)
-	{
-		USB_Descriptor_Endpoint_t* Endpoint = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Endpoint_t);
-
-		uint8_t EndpointType = (Endpoint->Attributes & EP_TYPE_MASK);
-
-		if ((EndpointType == EP_TYPE_BULK) && !(Pipe_IsEndpointBound(Endpoint->EndpointAddress)))
-		  return DESCRIPTOR_SEARCH_Found;
-	}
-	else if (Header->Type == DTYPE_Interface)
-	{
-		return DESCRIPTOR_SEARCH_Fail;
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
 void MIDI_Host_USBTask(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo)
 {
 	if ((USB_HostState != HOST_STATE_Configured) || !(MIDIInterfaceInfo->State.IsActive))
@@ -227,5 +173,125 @@ bool MIDI_Host_ReceiveEventPacket(USB_ClassInfo_MIDI_Host_t* const MIDIInterface
 	return DataReady;
 }
 
+uint8_t MIDI_Host_SendEventPackets(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo,
+                                   const MIDI_EventPacket_t* const Events,
+                                   const uint16_t TotalEvents)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(MIDIInterfaceInfo->State.IsActive))
+	  return PIPE_RWSTREAM_DeviceDisconnected;
+
+	uint8_t ErrorCode;
+
+	Pipe_SelectPipe(MIDIInterfaceInfo->Config.DataOUTPipe.Address);
+	Pipe_Unfreeze();
+
+	if ((ErrorCode = Pipe_Write_Stream_LE(Events, (TotalEvents * sizeof(MIDI_EventPacket_t)), NULL)) != PIPE_RWSTREAM_NoError)
+	{
+		Pipe_Freeze();
+		return ErrorCode;
+	}
+
+	if (!(Pipe_IsReadWriteAllowed()))
+	  Pipe_ClearOUT();
+
+	Pipe_Freeze();
+
+	return PIPE_RWSTREAM_NoError;
+}
+
+uint16_t MIDI_Host_ReceiveEventPackets(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo,
+                                       MIDI_EventPacket_t* const Events,
+                                       const uint16_t MaxEvents)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(MIDIInterfaceInfo->State.IsActive))
+	  return 0;
+
+	uint16_t TotalEvents = 0;
+
+	Pipe_SelectPipe(MIDIInterfaceInfo->Config.DataINPipe.Address);
+	Pipe_Unfreeze();
+
+	while ((TotalEvents < MaxEvents) && Pipe_IsINReceived())
+	{
+		uint16_t BankEvents = (Pipe_BytesInPipe() / sizeof(MIDI_EventPacket_t));
+
+		if (BankEvents > (MaxEvents - TotalEvents))
+		  BankEvents = (MaxEvents - TotalEvents);
+
+		Pipe_Read_Stream_LE(&Events[TotalEvents], (BankEvents * sizeof(MIDI_EventPacket_t)), NULL);
+		TotalEvents += BankEvents;
+
+		/* Release the bank once emptied, discarding any trailing partial event packet */
+		if (Pipe_BytesInPipe() < sizeof(MIDI_EventPacket_t))
+		  Pipe_ClearIN();
+	}
+
+	Pipe_Freeze();
+
+	return TotalEvents;
+}
+
+uint8_t MIDI_Host_SendStream(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo,
+                             MIDI_StreamParser_t* const Parser,
+                             const uint8_t* Buffer,
+                             uint16_t Length)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(MIDIInterfaceInfo->State.IsActive))
+	  return PIPE_RWSTREAM_DeviceDisconnected;
+
+	MIDI_EventPacket_t Events[MIDI_STREAM_CHUNK_EVENTS];
+	uint8_t            ErrorCode;
+
+	while (Length)
+	{
+		uint16_t BytesProcessed;
+		uint16_t TotalEvents = MIDI_ConvertStreamToEvents(Parser, Buffer, Length, &BytesProcessed,
+		                                                  Events, MIDI_STREAM_CHUNK_EVENTS);
+
+		Buffer += BytesProcessed;
+		Length -= BytesProcessed;
+
+		if (!(TotalEvents))
+		  continue;
+
+		if ((ErrorCode = MIDI_Host_SendEventPackets(MIDIInterfaceInfo, Events, TotalEvents)) != PIPE_RWSTREAM_NoError)
+		  return ErrorCode;
+	}
+
+	return PIPE_RWSTREAM_NoError;
+}
+
+uint16_t MIDI_Host_ReceiveStream(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo,
+                                 MIDI_StreamWriter_t* const Writer,
+                                 uint8_t* const Buffer,
+                                 const uint16_t Length)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(MIDIInterfaceInfo->State.IsActive))
+	  return 0;
+
+	uint16_t BytesReceived = 0;
+
+	Pipe_SelectPipe(MIDIInterfaceInfo->Config.DataINPipe.Address);
+	Pipe_Unfreeze();
+
+	while (((Length - BytesReceived) >= 3) && Pipe_IsINReceived())
+	{
+		if (Pipe_BytesInPipe() >= sizeof(MIDI_EventPacket_t))
+		{
+			MIDI_EventPacket_t Event;
+
+			Pipe_Read_Stream_LE(&Event, sizeof(MIDI_EventPacket_t), NULL);
+			BytesReceived += MIDI_ConvertEventToStream(Writer, &Event, &Buffer[BytesReceived]);
+		}
+
+		if (Pipe_BytesInPipe() < sizeof(MIDI_EventPacket_t))
+		  Pipe_ClearIN();
+	}
+
+	Pipe_Freeze();
+
+	return BytesReceived;
+}
+
 #endif
 
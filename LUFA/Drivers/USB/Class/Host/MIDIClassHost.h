@@ -43,6 +43,7 @@
  *  \section Sec_Dependencies Module Source Dependencies
  *  The following files must be built with any user project that uses this module:
  *    - LUFA/Drivers/USB/Class/Host/MIDIClassHost.c <i>(Makefile source module name: LUFA_SRC_USBCLASS)</i>
+ *    - LUFA/Drivers/USB/Class/Common/MIDIConverter.c <i>(Makefile source module name: LUFA_SRC_USBCLASS)</i>
  *
  *  \section Sec_ModDescription Module Description
  *  Host Mode USB Class driver framework interface, for the MIDI USB Class driver.
@@ -56,6 +57,7 @@
 	/* Includes: */
 		#include "../../USB.h"
 		#include "../Common/MIDIClassCommon.h"
+		#include "../Common/MIDIConverter.h"
 
 	/* Enable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
@@ -168,16 +170,80 @@
 			bool MIDI_Host_ReceiveEventPacket(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo,
 			                                  MIDI_EventPacket_t* const Event) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
 
-	/* Private Interface - For use in library only: */
-	#if !defined(__DOXYGEN__)
-		/* Function Prototypes: */
-			#if defined(__INCLUDE_FROM_MIDI_HOST_C)
-				static uint8_t DCOMP_MIDI_Host_NextMIDIStreamingInterface(void* const CurrentDescriptor)
-				                                                          ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-				static uint8_t DCOMP_MIDI_Host_NextMIDIStreamingDataEndpoint(void* const CurrentDescriptor)
-				                                                             ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-			#endif
-	#endif
+			/** Sends a block of MIDI event packets to the device. The events are written into the pipe with a single stream
+			 *  transfer, so that full pipe banks are sent as they fill without waiting for a flush; any events left over in a
+			 *  partially filled bank are queued as per \ref MIDI_Host_SendEventPacket().
+			 *
+			 *  \pre This function must only be called when the Host state machine is in the \ref HOST_STATE_Configured state or the
+			 *       call will fail.
+			 *
+			 *  \param[in,out] MIDIInterfaceInfo  Pointer to a structure containing a MIDI Class configuration and state.
+			 *  \param[in]     Events             Pointer to a buffer of populated \ref MIDI_EventPacket_t structures to send.
+			 *  \param[in]     TotalEvents        Number of event packets in the buffer.
+			 *
+			 *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum.
+			 */
+			uint8_t MIDI_Host_SendEventPackets(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo,
+			                                   const MIDI_EventPacket_t* const Events,
+			                                   const uint16_t TotalEvents) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Receives all MIDI event packets waiting from the device, up to the given maximum. Each pipe bank is read
+			 *  in a single stream transfer and released once emptied, continuing into the next bank if it has already
+			 *  been received.
+			 *
+			 *  \pre This function must only be called when the Host state machine is in the \ref HOST_STATE_Configured state or the
+			 *       call will fail.
+			 *
+			 *  \param[in,out] MIDIInterfaceInfo  Pointer to a structure containing a MIDI Class configuration and state.
+			 *  \param[out]    Events             Pointer to a buffer where the received event packets are to be placed.
+			 *  \param[in]     MaxEvents          Maximum number of event packets that may be placed into the buffer.
+			 *
+			 *  \return Number of MIDI event packets received.
+			 */
+			uint16_t MIDI_Host_ReceiveEventPackets(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo,
+			                                       MIDI_EventPacket_t* const Events,
+			                                       const uint16_t MaxEvents) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Sends a block of a raw MIDI byte stream to the device, such as one received from a DIN-MIDI serial port. The
+			 *  bytes are converted into event packets through the given stream parser a chunk at a time, each chunk being
+			 *  sent with \ref MIDI_Host_SendEventPackets() so that long System Exclusive dumps are sent at the full bus
+			 *  rate. Messages split across calls are completed by the next call with the same parser.
+			 *
+			 *  \pre This function must only be called when the Host state machine is in the \ref HOST_STATE_Configured state or the
+			 *       call will fail.
+			 *
+			 *  \param[in,out] MIDIInterfaceInfo  Pointer to a structure containing a MIDI Class configuration and state.
+			 *  \param[in,out] Parser             Pointer to the parser state of the byte stream, see \ref Group_MIDIConverter.
+			 *  \param[in]     Buffer             Pointer to the block of MIDI stream bytes to send.
+			 *  \param[in]     Length             Number of bytes in the block.
+			 *
+			 *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum.
+			 */
+			uint8_t MIDI_Host_SendStream(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo,
+			                             MIDI_StreamParser_t* const Parser,
+			                             const uint8_t* Buffer,
+			                             uint16_t Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Receives MIDI event packets from the device as a raw MIDI byte stream, such as one to be sent out of a DIN-MIDI
+			 *  serial port, with the status bytes of consecutive channel messages compressed under running status. Event
+			 *  packets are only read while the buffer has room for the largest possible message, so that no packet is split
+			 *  between calls.
+			 *
+			 *  \pre This function must only be called when the Host state machine is in the \ref HOST_STATE_Configured state or the
+			 *       call will fail.
+			 *
+			 *  \param[in,out] MIDIInterfaceInfo  Pointer to a structure containing a MIDI Class configuration and state.
+			 *  \param[in,out] Writer             Pointer to the writer state of the byte stream, see \ref Group_MIDIConverter.
+			 *  \param[out]    Buffer             Pointer to a buffer where the stream bytes are to be placed.
+			 *  \param[in]     Length             Size of the buffer, in bytes.
+			 *
+			 *  \return Number of stream bytes placed into the buffer.
+			 */
+			uint16_t MIDI_Host_ReceiveStream(USB_ClassInfo_MIDI_Host_t* const MIDIInterfaceInfo,
+			                                 MIDI_StreamWriter_t* const Writer,
+			                                 uint8_t* const Buffer,
+			                                 const uint16_t Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2)
+			                                 ATTR_NON_NULL_PTR_ARG(3);
 
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
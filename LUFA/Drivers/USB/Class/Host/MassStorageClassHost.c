@@ -41,41 +41,27 @@ uint8_t MS_Host_ConfigurePipes(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
                                uint16_t ConfigDescriptorSize,
 							   void* ConfigDescriptorData)
 {
-	USB_Descriptor_Endpoint_t*  DataINEndpoint       = NULL;
-	USB_Descriptor_Endpoint_t*  DataOUTEndpoint      = NULL;
-	USB_Descriptor_Interface_t* MassStorageInterface = NULL;
+	const USB_ConfigIndex_t*           ConfigIndex;
+	USB_ConfigIndex_Interface_t        MassStorageInterface;
+	USB_Descriptor_Endpoint_t*         DataINEndpoint  = NULL;
+	USB_Descriptor_Endpoint_t*         DataOUTEndpoint = NULL;
+	uint8_t                            InterfaceIndex  = 0;
 
 	memset(&MSInterfaceInfo->State, 0x00, sizeof(MSInterfaceInfo->State));
 
-	if (DESCRIPTOR_TYPE(ConfigDescriptorData) != DTYPE_Configuration)
+	if (!(ConfigIndex = USB_Host_GetConfigIndex(ConfigDescriptorSize, ConfigDescriptorData)))
 	  return MS_ENUMERROR_InvalidConfigDescriptor;
 
 	while (!(DataINEndpoint) || !(DataOUTEndpoint))
 	{
-		if (!(MassStorageInterface) ||
-		    USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-		                              DCOMP_MS_Host_NextMSInterfaceEndpoint) != DESCRIPTOR_SEARCH_COMP_Found)
+		if (!(USB_Host_FindIndexedInterface(ConfigIndex, &InterfaceIndex, MS_CSCP_MassStorageClass,
+		                                    MS_CSCP_SCSITransparentSubclass, MS_CSCP_BulkOnlyTransportProtocol, &MassStorageInterface)))
 		{
-			if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-			                              DCOMP_MS_Host_NextMSInterface) != DESCRIPTOR_SEARCH_COMP_Found)
-			{
-				return MS_ENUMERROR_NoCompatibleInterfaceFound;
-			}
-
-			MassStorageInterface = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Interface_t);
-
-			DataINEndpoint  = NULL;
-			DataOUTEndpoint = NULL;
-
-			continue;
+			return MS_ENUMERROR_NoCompatibleInterfaceFound;
 		}
 
-		USB_Descriptor_Endpoint_t* EndpointData = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Endpoint_t);
-
-		if ((EndpointData->EndpointAddress & ENDPOINT_DIR_MASK) == ENDPOINT_DIR_IN)
-		  DataINEndpoint  = EndpointData;
-		else
-		  DataOUTEndpoint = EndpointData;
+		DataINEndpoint  = USB_Host_GetIndexedEndpoint(&MassStorageInterface, ENDPOINT_DIR_IN,  EP_TYPE_BULK);
+		DataOUTEndpoint = USB_Host_GetIndexedEndpoint(&MassStorageInterface, ENDPOINT_DIR_OUT, EP_TYPE_BULK);
 	}
 
 	MSInterfaceInfo->Config.DataINPipe.Size  = le16_to_cpu(DataINEndpoint->EndpointSize);
@@ -92,57 +78,25 @@ uint8_t MS_Host_ConfigurePipes(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
 	if (!(Pipe_ConfigurePipeTable(&MSInterfaceInfo->Config.DataOUTPipe, 1)))
 	  return false;
 
-	MSInterfaceInfo->State.InterfaceNumber = MassStorageInterface->InterfaceNumber;
+	MSInterfaceInfo->State.InterfaceNumber = MassStorageInterface.Descriptor->InterfaceNumber;
 	MSInterfaceInfo->State.IsActive = true;
 
 	return MS_ENUMERROR_NoError;
 }
 
-static uint8_t DCOMP_MS_Host_NextMSInterface(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Interface)
-	{
-		USB_Descriptor_Interface_t* Interface = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Interface_t);
-
-		if ((Interface->Class    == MS_CSCP_MassStorageClass)        &&
-		    (Interface->SubClass == MS_CSCP_SCSITransparentSubclass) &&
-		    (Interface->Protocol == MS_CSCP_BulkOnlyTransportProtocol))
-		{
-			return DESCRIPTOR_SEARCH_Found;
-		}
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
-static uint8_t DCOMP_MS_Host_NextMSInterfaceEndpoint(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Endpoint)
-	{
-		USB_Descriptor_Endpoint_t* Endpoint = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Endpoint_t);
-
-		uint8_t EndpointType = (Endpoint->Attributes & EP_TYPE_MASK);
-
-		if ((EndpointType == EP_TYPE_BULK) && (!(Pipe_IsEndpointBound(Endpoint->EndpointAddress))))
-		{
-			return DESCRIPTOR_SEARCH_Found;
-		}
-	}
-	else if (Header->Type == DTYPE_Interface)
-	{
-		return DESCRIPTOR_SEARCH_Fail;
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
 static uint8_t MS_Host_SendCommand(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
                                    MS_CommandBlockWrapper_t* const SCSICommandBlock,
                                    const void* const BufferPtr)
+{
+	return MS_Host_SendStreamedCommand(MSInterfaceInfo, SCSICommandBlock, (void*)BufferPtr, UINT16_MAX, NULL, NULL);
+}
+
+static uint8_t MS_Host_SendStreamedCommand(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                                           MS_CommandBlockWrapper_t* const SCSICommandBlock,
+                                           void* const BufferPtr,
+                                           const uint16_t ChunkSize,
+                                           MS_Host_StreamCallback_t const Callback,
+                                           void* const Context)
 {
 	uint8_t ErrorCode = PIPE_RWSTREAM_NoError;
 
@@ -168,7 +122,7 @@ static uint8_t MS_Host_SendCommand(USB_ClassInfo_MS_Host_t* const MSInterfaceInf
 
 	if (BufferPtr != NULL)
 	{
-		ErrorCode = MS_Host_SendReceiveData(MSInterfaceInfo, SCSICommandBlock, (void*)BufferPtr);
+		ErrorCode = MS_Host_SendReceiveData(MSInterfaceInfo, SCSICommandBlock, BufferPtr, ChunkSize, Callback, Context);
 
 		if ((ErrorCode != PIPE_RWSTREAM_NoError) && (ErrorCode != PIPE_RWSTREAM_PipeStalled))
 		{
@@ -236,37 +190,72 @@ static uint8_t MS_Host_WaitForDataReceived(USB_ClassInfo_MS_Host_t* const MSInte
 
 static uint8_t MS_Host_SendReceiveData(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
                                        MS_CommandBlockWrapper_t* const SCSICommandBlock,
-                                       void* BufferPtr)
+                                       void* BufferPtr,
+                                       const uint16_t ChunkSize,
+                                       MS_Host_StreamCallback_t const Callback,
+                                       void* const Context)
 {
 	uint8_t  ErrorCode = PIPE_RWSTREAM_NoError;
-	uint16_t BytesRem  = le32_to_cpu(SCSICommandBlock->DataTransferLength);
+	uint32_t BytesRem  = le32_to_cpu(SCSICommandBlock->DataTransferLength);
+	uint8_t* ChunkPtr  = BufferPtr;
+	bool     DataIN    = (SCSICommandBlock->Flags & MS_COMMAND_DIR_DATA_IN);
+	uint8_t  DataPipe  = DataIN ? MSInterfaceInfo->Config.DataINPipe.Address : MSInterfaceInfo->Config.DataOUTPipe.Address;
 
-	if (SCSICommandBlock->Flags & MS_COMMAND_DIR_DATA_IN)
+	if (DataIN)
 	{
 		if ((ErrorCode = MS_Host_WaitForDataReceived(MSInterfaceInfo)) != PIPE_RWSTREAM_NoError)
 		{
 			Pipe_Freeze();
 			return ErrorCode;
 		}
+	}
 
-		Pipe_SelectPipe(MSInterfaceInfo->Config.DataINPipe.Address);
+	while (BytesRem)
+	{
+		uint16_t ChunkLength = (BytesRem < ChunkSize) ? BytesRem : ChunkSize;
+
+		if (Callback && !(DataIN))
+		  Callback(Context, ChunkPtr, ChunkLength);
+
+		Pipe_SelectPipe(DataPipe);
 		Pipe_Unfreeze();
 
-		if ((ErrorCode = Pipe_Read_Stream_LE(BufferPtr, BytesRem, NULL)) != PIPE_RWSTREAM_NoError)
+		if (DataIN)
+		  ErrorCode = Pipe_Read_Stream_LE(ChunkPtr, ChunkLength, NULL);
+		else
+		  ErrorCode = Pipe_Write_Stream_LE(ChunkPtr, ChunkLength, NULL);
+
+		if (ErrorCode != PIPE_RWSTREAM_NoError)
 		  return ErrorCode;
 
+		BytesRem -= ChunkLength;
+
+		/* Streamed transfers reuse the chunk buffer, which the callback may process with the pipe frozen */
+		if (Callback)
+		{
+			Pipe_Freeze();
+
+			if (DataIN)
+			  Callback(Context, ChunkPtr, ChunkLength);
+		}
+		else
+		{
+			ChunkPtr += ChunkLength;
+		}
+	}
+
+	Pipe_SelectPipe(DataPipe);
+
+	if (DataIN)
+	{
 		Pipe_ClearIN();
 	}
 	else
 	{
-		Pipe_SelectPipe(MSInterfaceInfo->Config.DataOUTPipe.Address);
-		Pipe_Unfreeze();
-
-		if ((ErrorCode = Pipe_Write_Stream_LE(BufferPtr, BytesRem, NULL)) != PIPE_RWSTREAM_NoError)
-		  return ErrorCode;
-
 		Pipe_ClearOUT();
 
+		Pipe_Unfreeze();
+
 		while (!(Pipe_IsOUTReady()))
 		{
 			if (USB_HostState == HOST_STATE_Unattached)
@@ -575,5 +564,87 @@ uint8_t MS_Host_WriteDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo
 	return MS_Host_SendCommand(MSInterfaceInfo, &SCSICommandBlock, BlockBuffer);
 }
 
+uint8_t MS_Host_ReadDeviceBlocksStream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                                       const uint8_t LUNIndex,
+                                       const uint32_t BlockAddress,
+                                       const uint16_t Blocks,
+                                       const uint16_t BlockSize,
+                                       void* const ChunkBuffer,
+                                       const uint16_t ChunkSize,
+                                       MS_Host_StreamCallback_t const Callback,
+                                       void* const Context)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(MSInterfaceInfo->State.IsActive))
+	  return HOST_SENDCONTROL_DeviceDisconnected;
+
+	/* A zero length chunk buffer could never make progress through the data stage */
+	if (!(ChunkSize))
+	  return MS_ERROR_LOGICAL_CMD_FAILED;
+
+	MS_CommandBlockWrapper_t SCSICommandBlock = (MS_CommandBlockWrapper_t)
+		{
+			.DataTransferLength = cpu_to_le32((uint32_t)Blocks * BlockSize),
+			.Flags              = MS_COMMAND_DIR_DATA_IN,
+			.LUN                = LUNIndex,
+			.SCSICommandLength  = 10,
+			.SCSICommandData    =
+				{
+					SCSI_CMD_READ_10,
+					0x00,                   // Unused (control bits, all off)
+					(BlockAddress >> 24),   // MSB of Block Address
+					(BlockAddress >> 16),
+					(BlockAddress >> 8),
+					(BlockAddress & 0xFF),  // LSB of Block Address
+					0x00,                   // Reserved
+					(Blocks >> 8),          // MSB of Total Blocks to Read
+					(Blocks & 0xFF),        // LSB of Total Blocks to Read
+					0x00                    // Unused (control)
+				}
+		};
+
+	return MS_Host_SendStreamedCommand(MSInterfaceInfo, &SCSICommandBlock, ChunkBuffer, ChunkSize, Callback, Context);
+}
+
+uint8_t MS_Host_WriteDeviceBlocksStream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                                        const uint8_t LUNIndex,
+                                        const uint32_t BlockAddress,
+                                        const uint16_t Blocks,
+                                        const uint16_t BlockSize,
+                                        void* const ChunkBuffer,
+                                        const uint16_t ChunkSize,
+                                        MS_Host_StreamCallback_t const Callback,
+                                        void* const Context)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(MSInterfaceInfo->State.IsActive))
+	  return HOST_SENDCONTROL_DeviceDisconnected;
+
+	/* A zero length chunk buffer could never make progress through the data stage */
+	if (!(ChunkSize))
+	  return MS_ERROR_LOGICAL_CMD_FAILED;
+
+	MS_CommandBlockWrapper_t SCSICommandBlock = (MS_CommandBlockWrapper_t)
+		{
+			.DataTransferLength = cpu_to_le32((uint32_t)Blocks * BlockSize),
+			.Flags              = MS_COMMAND_DIR_DATA_OUT,
+			.LUN                = LUNIndex,
+			.SCSICommandLength  = 10,
+			.SCSICommandData    =
+				{
+					SCSI_CMD_WRITE_10,
+					0x00,                   // Unused (control bits, all off)
+					(BlockAddress >> 24),   // MSB of Block Address
+					(BlockAddress >> 16),
+					(BlockAddress >> 8),
+					(BlockAddress & 0xFF),  // LSB of Block Address
+					0x00,                   // Reserved
+					(Blocks >> 8),          // MSB of Total Blocks to Write
+					(Blocks & 0xFF),        // LSB of Total Blocks to Write
+					0x00                    // Unused (control)
+				}
+		};
+
+	return MS_Host_SendStreamedCommand(MSInterfaceInfo, &SCSICommandBlock, ChunkBuffer, ChunkSize, Callback, Context);
+}
+
 #endif
 
@@ -115,6 +115,19 @@
 				uint32_t BlockSize; /**< Number of bytes in each block in the addressed LUN. */
 			} SCSI_Capacity_t;
 
+			/** Type define for a Mass Storage host streamed block transfer callback, used by \ref MS_Host_ReadDeviceBlocksStream()
+			 *  and \ref MS_Host_WriteDeviceBlocksStream(). For reads, the callback is called after each chunk of data has been
+			 *  received from the device into the chunk buffer; for writes, it is called before each chunk is sent to the device,
+			 *  and must fill the chunk buffer with the data to send.
+			 *
+			 *  \param[in]     Context  User context pointer passed to the streamed transfer function.
+			 *  \param[in,out] Chunk    Pointer to the chunk buffer holding, or to be filled with, the chunk's data.
+			 *  \param[in]     Length   Length in bytes of the current chunk.
+			 */
+			typedef void (*MS_Host_StreamCallback_t)(void* const Context,
+			                                         void* const Chunk,
+			                                         const uint16_t Length);
+
 		/* Enums: */
 			/** Enum for the possible error codes returned by the \ref MS_Host_ConfigurePipes() function. */
 			enum MS_Host_EnumerationFailure_ErrorCodes_t
@@ -286,6 +299,75 @@
 			                                  const uint16_t BlockSize,
 			                                  const void* BlockBuffer) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(6);
 
+			/** Reads blocks of data from the attached Mass Storage device's medium with a single SCSI command, passing the data
+			 *  to the given callback one chunk at a time rather than storing it all in RAM. This allows many blocks to be read
+			 *  per command through a small buffer, avoiding the command and status overhead of reading one block at a time.
+			 *
+			 *  \pre This function must only be called when the Host state machine is in the \ref HOST_STATE_Configured state or the
+			 *       call will fail. The chunk buffer must be at least one byte long, or the call will fail without a command
+			 *       being sent.
+			 *
+			 *  \note The chunk size does not need to be related to the block or pipe size; chunks which are a multiple of the pipe
+			 *        size will give the best throughput.
+			 *
+			 *  \param[in,out] MSInterfaceInfo  Pointer to a structure containing a MS Class host configuration and state.
+			 *  \param[in]     LUNIndex         LUN index within the device the command is being issued to.
+			 *  \param[in]     BlockAddress     Starting block address within the device to read from.
+			 *  \param[in]     Blocks           Total number of blocks to read.
+			 *  \param[in]     BlockSize        Size in bytes of each block within the device.
+			 *  \param[out]    ChunkBuffer      Pointer to a buffer where each chunk of read data is stored before being passed to
+			 *                                  the callback.
+			 *  \param[in]     ChunkSize        Size in bytes of the chunk buffer, which must be non-zero.
+			 *  \param[in]     Callback         Callback function to process each chunk of read data.
+			 *  \param[in]     Context          User context pointer passed to the callback function.
+			 *
+			 *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum or \ref MS_ERROR_LOGICAL_CMD_FAILED if not ready or
+			 *          if \c ChunkSize is zero.
+			 */
+			uint8_t MS_Host_ReadDeviceBlocksStream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+			                                       const uint8_t LUNIndex,
+			                                       const uint32_t BlockAddress,
+			                                       const uint16_t Blocks,
+			                                       const uint16_t BlockSize,
+			                                       void* const ChunkBuffer,
+			                                       const uint16_t ChunkSize,
+			                                       MS_Host_StreamCallback_t const Callback,
+			                                       void* const Context) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(6)
+			                                       ATTR_NON_NULL_PTR_ARG(8);
+
+			/** Writes blocks of data to the attached Mass Storage device's medium with a single SCSI command, fetching the data
+			 *  from the given callback one chunk at a time rather than from a buffer holding all of it. This allows many blocks
+			 *  to be written per command through a small buffer, avoiding the command and status overhead of writing one block
+			 *  at a time.
+			 *
+			 *  \pre This function must only be called when the Host state machine is in the \ref HOST_STATE_Configured state or the
+			 *       call will fail. The chunk buffer must be at least one byte long, or the call will fail without a command
+			 *       being sent.
+			 *
+			 *  \param[in,out] MSInterfaceInfo  Pointer to a structure containing a MS Class host configuration and state.
+			 *  \param[in]     LUNIndex         LUN index within the device the command is being issued to.
+			 *  \param[in]     BlockAddress     Starting block address within the device to write to.
+			 *  \param[in]     Blocks           Total number of blocks to write.
+			 *  \param[in]     BlockSize        Size in bytes of each block within the device.
+			 *  \param[in]     ChunkBuffer      Pointer to a buffer which the callback fills with each chunk of data to write.
+			 *  \param[in]     ChunkSize        Size in bytes of the chunk buffer, which must be non-zero.
+			 *  \param[in]     Callback         Callback function to fill each chunk of data to write.
+			 *  \param[in]     Context          User context pointer passed to the callback function.
+			 *
+			 *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum or \ref MS_ERROR_LOGICAL_CMD_FAILED if not ready or
+			 *          if \c ChunkSize is zero.
+			 */
+			uint8_t MS_Host_WriteDeviceBlocksStream(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+			                                        const uint8_t LUNIndex,
+			                                        const uint32_t BlockAddress,
+			                                        const uint16_t Blocks,
+			                                        const uint16_t BlockSize,
+			                                        void* const ChunkBuffer,
+			                                        const uint16_t ChunkSize,
+			                                        MS_Host_StreamCallback_t const Callback,
+			                                        void* const Context) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(6)
+			                                        ATTR_NON_NULL_PTR_ARG(8);
+
 		/* Inline Functions: */
 			/** General management task for a given Mass Storage host class interface, required for the correct operation of
 			 *  the interface. This should be called frequently in the main program loop, before the master USB management task
@@ -309,18 +391,22 @@
 				static uint8_t MS_Host_SendCommand(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
 				                                   MS_CommandBlockWrapper_t* const SCSICommandBlock,
 				                                   const void* const BufferPtr) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+				static uint8_t MS_Host_SendStreamedCommand(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+				                                           MS_CommandBlockWrapper_t* const SCSICommandBlock,
+				                                           void* const BufferPtr,
+				                                           const uint16_t ChunkSize,
+				                                           MS_Host_StreamCallback_t const Callback,
+				                                           void* const Context) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
 				static uint8_t MS_Host_WaitForDataReceived(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 				static uint8_t MS_Host_SendReceiveData(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
 				                                       MS_CommandBlockWrapper_t* const SCSICommandBlock,
-				                                       void* BufferPtr) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+				                                       void* BufferPtr,
+				                                       const uint16_t ChunkSize,
+				                                       MS_Host_StreamCallback_t const Callback,
+				                                       void* const Context) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
 				static uint8_t MS_Host_GetReturnedStatus(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
 				                                         MS_CommandStatusWrapper_t* const SCSICommandStatus)
 				                                         ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
-
-				static uint8_t DCOMP_MS_Host_NextMSInterface(void* const CurrentDescriptor)
-				                                             ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-				static uint8_t DCOMP_MS_Host_NextMSInterfaceEndpoint(void* const CurrentDescriptor)
-				                                                     ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
 			#endif
 	#endif
 
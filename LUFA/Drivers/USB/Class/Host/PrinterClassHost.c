@@ -41,41 +41,27 @@ uint8_t PRNT_Host_ConfigurePipes(USB_ClassInfo_PRNT_Host_t* const PRNTInterfaceI
                                  uint16_t ConfigDescriptorSize,
 							     void* ConfigDescriptorData)
 {
-	USB_Descriptor_Endpoint_t*  DataINEndpoint   = NULL;
-	USB_Descriptor_Endpoint_t*  DataOUTEndpoint  = NULL;
-	USB_Descriptor_Interface_t* PrinterInterface = NULL;
+	const USB_ConfigIndex_t*           ConfigIndex;
+	USB_ConfigIndex_Interface_t        PrinterInterface;
+	USB_Descriptor_Endpoint_t*         DataINEndpoint  = NULL;
+	USB_Descriptor_Endpoint_t*         DataOUTEndpoint = NULL;
+	uint8_t                            InterfaceIndex  = 0;
 
 	memset(&PRNTInterfaceInfo->State, 0x00, sizeof(PRNTInterfaceInfo->State));
 
-	if (DESCRIPTOR_TYPE(ConfigDescriptorData) != DTYPE_Configuration)
+	if (!(ConfigIndex = USB_Host_GetConfigIndex(ConfigDescriptorSize, ConfigDescriptorData)))
 	  return PRNT_ENUMERROR_InvalidConfigDescriptor;
 
 	while (!(DataINEndpoint) || !(DataOUTEndpoint))
 	{
-		if (!(PrinterInterface) ||
-		    USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-		                              DCOMP_PRNT_Host_NextPRNTInterfaceEndpoint) != DESCRIPTOR_SEARCH_COMP_Found)
+		if (!(USB_Host_FindIndexedInterface(ConfigIndex, &InterfaceIndex, PRNT_CSCP_PrinterClass,
+		                                    PRNT_CSCP_PrinterSubclass, PRNT_CSCP_BidirectionalProtocol, &PrinterInterface)))
 		{
-			if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-			                              DCOMP_PRNT_Host_NextPRNTInterface) != DESCRIPTOR_SEARCH_COMP_Found)
-			{
-				return PRNT_ENUMERROR_NoCompatibleInterfaceFound;
-			}
-
-			PrinterInterface = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Interface_t);
-
-			DataINEndpoint  = NULL;
-			DataOUTEndpoint = NULL;
-
-			continue;
+			return PRNT_ENUMERROR_NoCompatibleInterfaceFound;
 		}
 
-		USB_Descriptor_Endpoint_t* EndpointData = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Endpoint_t);
-
-		if ((EndpointData->EndpointAddress & ENDPOINT_DIR_MASK) == ENDPOINT_DIR_IN)
-		  DataINEndpoint  = EndpointData;
-		else
-		  DataOUTEndpoint = EndpointData;
+		DataINEndpoint  = USB_Host_GetIndexedEndpoint(&PrinterInterface, ENDPOINT_DIR_IN,  EP_TYPE_BULK);
+		DataOUTEndpoint = USB_Host_GetIndexedEndpoint(&PrinterInterface, ENDPOINT_DIR_OUT, EP_TYPE_BULK);
 	}
 
 	PRNTInterfaceInfo->Config.DataINPipe.Size  = le16_to_cpu(DataINEndpoint->EndpointSize);
@@ -92,53 +78,13 @@ uint8_t PRNT_Host_ConfigurePipes(USB_ClassInfo_PRNT_Host_t* const PRNTInterfaceI
 	if (!(Pipe_ConfigurePipeTable(&PRNTInterfaceInfo->Config.DataOUTPipe, 1)))
 	  return false;	
 
-	PRNTInterfaceInfo->State.InterfaceNumber  = PrinterInterface->InterfaceNumber;
-	PRNTInterfaceInfo->State.AlternateSetting = PrinterInterface->AlternateSetting;
+	PRNTInterfaceInfo->State.InterfaceNumber  = PrinterInterface.Descriptor->InterfaceNumber;
+	PRNTInterfaceInfo->State.AlternateSetting = PrinterInterface.Descriptor->AlternateSetting;
 	PRNTInterfaceInfo->State.IsActive = true;
 
 	return PRNT_ENUMERROR_NoError;
 }
 
-static uint8_t DCOMP_PRNT_Host_NextPRNTInterface(void* CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Interface)
-	{
-		USB_Descriptor_Interface_t* Interface = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Interface_t);
-
-		if ((Interface->Class    == PRNT_CSCP_PrinterClass)    &&
-		    (Interface->SubClass == PRNT_CSCP_PrinterSubclass) &&
-		    (Interface->Protocol == PRNT_CSCP_BidirectionalProtocol))
-		{
-			return DESCRIPTOR_SEARCH_Found;
-		}
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
-static uint8_t DCOMP_PRNT_Host_NextPRNTInterfaceEndpoint(void* CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Endpoint)
-	{
-		USB_Descriptor_Endpoint_t* Endpoint = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Endpoint_t);
-
-		uint8_t EndpointType = (Endpoint->Attributes & EP_TYPE_MASK);
-
-		if (EndpointType == EP_TYPE_BULK)
-		  return DESCRIPTOR_SEARCH_Found;
-	}
-	else if (Header->Type == DTYPE_Interface)
-	{
-		return DESCRIPTOR_SEARCH_Fail;
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
 void PRNT_Host_USBTask(USB_ClassInfo_PRNT_Host_t* const PRNTInterfaceInfo)
 {
 	if ((USB_HostState != HOST_STATE_Configured) || !(PRNTInterfaceInfo->State.IsActive))
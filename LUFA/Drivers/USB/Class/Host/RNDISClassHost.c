@@ -41,64 +41,40 @@ uint8_t RNDIS_Host_ConfigurePipes(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfa
                                   uint16_t ConfigDescriptorSize,
                                   void* ConfigDescriptorData)
 {
-	USB_Descriptor_Endpoint_t*  DataINEndpoint        = NULL;
-	USB_Descriptor_Endpoint_t*  DataOUTEndpoint       = NULL;
-	USB_Descriptor_Endpoint_t*  NotificationEndpoint  = NULL;
-	USB_Descriptor_Interface_t* RNDISControlInterface = NULL;
+	const USB_ConfigIndex_t*           ConfigIndex;
+	USB_ConfigIndex_Interface_t        RNDISControlInterface;
+	USB_ConfigIndex_Interface_t        RNDISDataInterface;
+	USB_Descriptor_Endpoint_t*         DataINEndpoint       = NULL;
+	USB_Descriptor_Endpoint_t*         DataOUTEndpoint      = NULL;
+	USB_Descriptor_Endpoint_t*         NotificationEndpoint = NULL;
+	uint8_t                            InterfaceIndex       = 0;
 
 	memset(&RNDISInterfaceInfo->State, 0x00, sizeof(RNDISInterfaceInfo->State));
 
-	if (DESCRIPTOR_TYPE(ConfigDescriptorData) != DTYPE_Configuration)
+	if (!(ConfigIndex = USB_Host_GetConfigIndex(ConfigDescriptorSize, ConfigDescriptorData)))
 	  return RNDIS_ENUMERROR_InvalidConfigDescriptor;
 
-	RNDISControlInterface = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Interface_t);
-
-	while (!(DataINEndpoint) || !(DataOUTEndpoint) || !(NotificationEndpoint))
+	while (!(NotificationEndpoint))
 	{
-		if (!(RNDISControlInterface) ||
-		    USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-		                              DCOMP_RNDIS_Host_NextRNDISInterfaceEndpoint) != DESCRIPTOR_SEARCH_COMP_Found)
+		if (!(USB_Host_FindIndexedInterface(ConfigIndex, &InterfaceIndex, CDC_CSCP_CDCClass,
+		                                    CDC_CSCP_ACMSubclass, CDC_CSCP_VendorSpecificProtocol, &RNDISControlInterface)))
 		{
-			if (NotificationEndpoint)
-			{
-				if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-											  DCOMP_RNDIS_Host_NextRNDISDataInterface) != DESCRIPTOR_SEARCH_COMP_Found)
-				{
-					return RNDIS_ENUMERROR_NoCompatibleInterfaceFound;
-				}
-
-				DataINEndpoint  = NULL;
-				DataOUTEndpoint = NULL;
-			}
-			else
-			{
-				if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-											  DCOMP_RNDIS_Host_NextRNDISControlInterface) != DESCRIPTOR_SEARCH_COMP_Found)
-				{
-					return RNDIS_ENUMERROR_NoCompatibleInterfaceFound;
-				}
-
-				RNDISControlInterface = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Interface_t);
-
-				NotificationEndpoint = NULL;
-			}
-
-			continue;
+			return RNDIS_ENUMERROR_NoCompatibleInterfaceFound;
 		}
 
-		USB_Descriptor_Endpoint_t* EndpointData = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Endpoint_t);
+		NotificationEndpoint = USB_Host_GetIndexedEndpoint(&RNDISControlInterface, ENDPOINT_DIR_IN, EP_TYPE_INTERRUPT);
+	}
 
-		if ((EndpointData->EndpointAddress & ENDPOINT_DIR_MASK) == ENDPOINT_DIR_IN)
-		{
-			if ((EndpointData->Attributes & EP_TYPE_MASK) == EP_TYPE_INTERRUPT)
-			  NotificationEndpoint = EndpointData;
-			else
-			  DataINEndpoint = EndpointData;
-		}
-		else
+	while (!(DataINEndpoint) || !(DataOUTEndpoint))
+	{
+		if (!(USB_Host_FindIndexedInterface(ConfigIndex, &InterfaceIndex, CDC_CSCP_CDCDataClass,
+		                                    CDC_CSCP_NoDataSubclass, CDC_CSCP_NoDataProtocol, &RNDISDataInterface)))
 		{
-			DataOUTEndpoint = EndpointData;
+			return RNDIS_ENUMERROR_NoCompatibleInterfaceFound;
 		}
+
+		DataINEndpoint  = USB_Host_GetIndexedEndpoint(&RNDISDataInterface, ENDPOINT_DIR_IN,  EP_TYPE_BULK);
+		DataOUTEndpoint = USB_Host_GetIndexedEndpoint(&RNDISDataInterface, ENDPOINT_DIR_OUT, EP_TYPE_BULK);
 	}
 
 	RNDISInterfaceInfo->Config.DataINPipe.Size  = le16_to_cpu(DataINEndpoint->EndpointSize);
@@ -122,75 +98,12 @@ uint8_t RNDIS_Host_ConfigurePipes(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfa
 	if (!(Pipe_ConfigurePipeTable(&RNDISInterfaceInfo->Config.NotificationPipe, 1)))
 	  return false;
 
-	RNDISInterfaceInfo->State.ControlInterfaceNumber = RNDISControlInterface->InterfaceNumber;
+	RNDISInterfaceInfo->State.ControlInterfaceNumber = RNDISControlInterface.Descriptor->InterfaceNumber;
 	RNDISInterfaceInfo->State.IsActive = true;
 
 	return RNDIS_ENUMERROR_NoError;
 }
 
-static uint8_t DCOMP_RNDIS_Host_NextRNDISControlInterface(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Interface)
-	{
-		USB_Descriptor_Interface_t* Interface = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Interface_t);
-
-		if ((Interface->Class    == CDC_CSCP_CDCClass)    &&
-		    (Interface->SubClass == CDC_CSCP_ACMSubclass) &&
-		    (Interface->Protocol == CDC_CSCP_VendorSpecificProtocol))
-		{
-			return DESCRIPTOR_SEARCH_Found;
-		}
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
-static uint8_t DCOMP_RNDIS_Host_NextRNDISDataInterface(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Interface)
-	{
-		USB_Descriptor_Interface_t* Interface = DESCRIPTOR_PCAST(CurrentDescriptor,
-		                                                         USB_Descriptor_Interface_t);
-
-		if ((Interface->Class    == CDC_CSCP_CDCDataClass)   &&
-		    (Interface->SubClass == CDC_CSCP_NoDataSubclass) &&
-		    (Interface->Protocol == CDC_CSCP_NoDataProtocol))
-		{
-			return DESCRIPTOR_SEARCH_Found;
-		}
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
-static uint8_t DCOMP_RNDIS_Host_NextRNDISInterfaceEndpoint(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Endpoint)
-	{
-		USB_Descriptor_Endpoint_t* Endpoint = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Endpoint_t);
-
-		uint8_t EndpointType = (Endpoint->Attributes & EP_TYPE_MASK);
-
-		if (((EndpointType == EP_TYPE_BULK) || (EndpointType == EP_TYPE_INTERRUPT)) &&
-		    !(Pipe_IsEndpointBound(Endpoint->EndpointAddress)))
-		{
-			return DESCRIPTOR_SEARCH_Found;
-		}
-	}
-	else if (Header->Type == DTYPE_Interface)
-	{
-		return DESCRIPTOR_SEARCH_Fail;
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
 static uint8_t RNDIS_SendEncapsulatedCommand(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo,
                                              void* Buffer,
                                              const uint16_t Length)
@@ -284,6 +197,7 @@ uint8_t RNDIS_Host_InitializeDevice(USB_ClassInfo_RNDIS_Host_t* const RNDISInter
 	  return RNDIS_ERROR_LOGICAL_CMD_FAILED;
 
 	RNDISInterfaceInfo->State.DeviceMaxPacketSize = le32_to_cpu(InitMessageResponse.MaxTransferSize);
+	RNDISInterfaceInfo->State.DeviceMaxPacketsPerTransfer = le32_to_cpu(InitMessageResponse.MaxPacketsPerTransfer);
 
 	return HOST_SENDCONTROL_Successful;
 }
@@ -398,78 +312,230 @@ uint8_t RNDIS_Host_ReadPacket(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceIn
 {
 	uint8_t ErrorCode;
 
+	if ((ErrorCode = RNDIS_Host_BeginReadPacket(RNDISInterfaceInfo, PacketLength)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	if (!(*PacketLength))
+	  return PIPE_RWSTREAM_NoError;
+
+	if ((ErrorCode = Pipe_Read_Stream_LE(Buffer, *PacketLength, NULL)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	return RNDIS_Host_EndReadPacket(RNDISInterfaceInfo);
+}
+
+uint8_t RNDIS_Host_SendPacket(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo,
+                              void* Buffer,
+                              const uint16_t PacketLength)
+{
+	uint8_t ErrorCode;
+
+	if ((ErrorCode = RNDIS_Host_BeginSendPacket(RNDISInterfaceInfo, PacketLength)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	if ((ErrorCode = Pipe_Write_Stream_LE(Buffer, PacketLength, NULL)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	return RNDIS_Host_EndSendPacket(RNDISInterfaceInfo);
+}
+
+uint8_t RNDIS_Host_BeginReadPacket(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo,
+                                   uint16_t* const PacketLength)
+{
+	uint8_t ErrorCode;
+
+	*PacketLength = 0;
+
 	if ((USB_HostState != HOST_STATE_Configured) || !(RNDISInterfaceInfo->State.IsActive))
 	  return PIPE_READYWAIT_DeviceDisconnected;
 
 	Pipe_SelectPipe(RNDISInterfaceInfo->Config.DataINPipe.Address);
 	Pipe_Unfreeze();
 
-	if (!(Pipe_IsReadWriteAllowed()))
+	if (!(Pipe_IsINReceived()))
 	{
-		if (Pipe_IsINReceived())
-		  Pipe_ClearIN();
-
-		*PacketLength = 0;
 		Pipe_Freeze();
 		return PIPE_RWSTREAM_NoError;
 	}
 
-	RNDIS_Packet_Message_t DeviceMessage;
+	uint16_t PipeSize     = RNDISInterfaceInfo->Config.DataINPipe.Size;
+	uint16_t BankPosition = (RNDISInterfaceInfo->State.RxTransferLength % PipeSize);
+	uint16_t BytesInBank  = Pipe_BytesInPipe();
 
-	if ((ErrorCode = Pipe_Read_Stream_LE(&DeviceMessage, sizeof(RNDIS_Packet_Message_t),
-	                                     NULL)) != PIPE_RWSTREAM_NoError)
+	/* A short packet with too few bytes left for a message header can only be the zero length packet or padding that
+	   terminates a transfer ending on a packet boundary, rather than the start of another packet message */
+	if (((BankPosition + BytesInBank) < PipeSize) && (BytesInBank < sizeof(RNDIS_Message_Header_t)))
 	{
-		return ErrorCode;
+		Pipe_ClearIN();
+		Pipe_Freeze();
+
+		RNDISInterfaceInfo->State.RxTransferLength = 0;
+		return PIPE_RWSTREAM_NoError;
+	}
+
+	struct
+	{
+		uint32_t MessageType;
+		uint32_t MessageLength;
+		uint32_t DataOffset;
+		uint32_t DataLength;
+	} PacketHeader;
+
+	if ((ErrorCode = Pipe_Read_Stream_LE(&PacketHeader, sizeof(PacketHeader), NULL)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	uint32_t MessageLength = le32_to_cpu(PacketHeader.MessageLength);
+	uint32_t DataStart     = (sizeof(RNDIS_Message_Header_t) + le32_to_cpu(PacketHeader.DataOffset));
+	uint32_t DataLength    = le32_to_cpu(PacketHeader.DataLength);
+
+	if ((le32_to_cpu(PacketHeader.MessageType) != REMOTE_NDIS_PACKET_MSG) || (MessageLength > UINT16_MAX) ||
+	    (DataStart < sizeof(PacketHeader)) || (DataLength > ETHERNET_FRAME_SIZE_MAX) ||
+	    ((DataStart + DataLength) > MessageLength))
+	{
+		Pipe_ClearIN();
+		Pipe_Freeze();
+
+		RNDISInterfaceInfo->State.RxTransferLength = 0;
+		return RNDIS_ERROR_LOGICAL_CMD_FAILED;
 	}
 
-	*PacketLength = (uint16_t)le32_to_cpu(DeviceMessage.DataLength);
+	if ((ErrorCode = Pipe_Discard_Stream(DataStart - sizeof(PacketHeader), NULL)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
 
-	Pipe_Discard_Stream(le32_to_cpu(DeviceMessage.DataOffset) -
-	                    (sizeof(RNDIS_Packet_Message_t) - sizeof(RNDIS_Message_Header_t)),
-	                    NULL);
+	RNDISInterfaceInfo->State.RxMessageLength = MessageLength;
+	RNDISInterfaceInfo->State.RxTrailerLength = (MessageLength - DataStart - DataLength);
 
-	Pipe_Read_Stream_LE(Buffer, *PacketLength, NULL);
+	/* Empty frames are dropped here, as a zero length indicates to the caller that there is no packet to complete */
+	if (!(DataLength))
+	  return RNDIS_Host_EndReadPacket(RNDISInterfaceInfo);
+
+	*PacketLength = DataLength;
+	return PIPE_RWSTREAM_NoError;
+}
+
+uint8_t RNDIS_Host_EndReadPacket(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo)
+{
+	uint8_t ErrorCode;
+
+	Pipe_SelectPipe(RNDISInterfaceInfo->Config.DataINPipe.Address);
 
+	if ((ErrorCode = Pipe_Discard_Stream(RNDISInterfaceInfo->State.RxTrailerLength, NULL)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	RNDISInterfaceInfo->State.RxTransferLength += RNDISInterfaceInfo->State.RxMessageLength;
+
+	/* Further packet messages of the same transfer may follow in the current bank, so only release it once emptied */
 	if (!(Pipe_BytesInPipe()))
-	  Pipe_ClearIN();
+	{
+		Pipe_ClearIN();
+
+		/* A bank which was not completely filled by the device was the short packet which ended the transfer */
+		if (RNDISInterfaceInfo->State.RxTransferLength % RNDISInterfaceInfo->Config.DataINPipe.Size)
+		  RNDISInterfaceInfo->State.RxTransferLength = 0;
+	}
 
 	Pipe_Freeze();
 
 	return PIPE_RWSTREAM_NoError;
 }
 
-uint8_t RNDIS_Host_SendPacket(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo,
-                              void* Buffer,
-                              const uint16_t PacketLength)
+uint8_t RNDIS_Host_BeginSendPacket(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo,
+                                   const uint16_t PacketLength)
 {
 	uint8_t ErrorCode;
 
 	if ((USB_HostState != HOST_STATE_Configured) || !(RNDISInterfaceInfo->State.IsActive))
 	  return PIPE_READYWAIT_DeviceDisconnected;
 
-	RNDIS_Packet_Message_t DeviceMessage;
+	uint16_t MessageLength = (sizeof(RNDIS_Packet_Message_t) + PacketLength);
 
-	memset(&DeviceMessage, 0, sizeof(RNDIS_Packet_Message_t));
-	DeviceMessage.MessageType   = CPU_TO_LE32(REMOTE_NDIS_PACKET_MSG);
-	DeviceMessage.MessageLength = CPU_TO_LE32(sizeof(RNDIS_Packet_Message_t) + PacketLength);
-	DeviceMessage.DataOffset    = CPU_TO_LE32(sizeof(RNDIS_Packet_Message_t) - sizeof(RNDIS_Message_Header_t));
-	DeviceMessage.DataLength    = cpu_to_le32(PacketLength);
+	/* End the current transfer first if adding this packet message would exceed what the device will accept */
+	if (RNDISInterfaceInfo->State.TxPacketCount &&
+	    ((RNDISInterfaceInfo->State.TxTransferLength + MessageLength) > RNDISInterfaceInfo->State.DeviceMaxPacketSize))
+	{
+		if ((ErrorCode = RNDIS_Host_Flush(RNDISInterfaceInfo)) != PIPE_READYWAIT_NoError)
+		  return ErrorCode;
+	}
+
+	struct
+	{
+		uint32_t MessageType;
+		uint32_t MessageLength;
+		uint32_t DataOffset;
+		uint32_t DataLength;
+	} PacketHeader =
+		{
+			.MessageType   = CPU_TO_LE32(REMOTE_NDIS_PACKET_MSG),
+			.MessageLength = cpu_to_le32(MessageLength),
+			.DataOffset    = CPU_TO_LE32(sizeof(RNDIS_Packet_Message_t) - sizeof(RNDIS_Message_Header_t)),
+			.DataLength    = cpu_to_le32(PacketLength),
+		};
 
 	Pipe_SelectPipe(RNDISInterfaceInfo->Config.DataOUTPipe.Address);
 	Pipe_Unfreeze();
 
-	if ((ErrorCode = Pipe_Write_Stream_LE(&DeviceMessage, sizeof(RNDIS_Packet_Message_t),
-	                                      NULL)) != PIPE_RWSTREAM_NoError)
+	/* Only the leading header fields are used, the remaining out-of-band and per-packet information fields are zero */
+	if ((ErrorCode = Pipe_Write_Stream_LE(&PacketHeader, sizeof(PacketHeader), NULL)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	if ((ErrorCode = Pipe_Null_Stream(sizeof(RNDIS_Packet_Message_t) - sizeof(PacketHeader), NULL)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	RNDISInterfaceInfo->State.TxTransferLength += MessageLength;
+
+	return PIPE_RWSTREAM_NoError;
+}
+
+uint8_t RNDIS_Host_EndSendPacket(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo)
+{
+	uint8_t MaxPacketsPerTransfer = RNDISInterfaceInfo->Config.MaxPacketsPerTransfer;
+
+	if (RNDISInterfaceInfo->State.DeviceMaxPacketsPerTransfer < MaxPacketsPerTransfer)
+	  MaxPacketsPerTransfer = RNDISInterfaceInfo->State.DeviceMaxPacketsPerTransfer;
+
+	if (++RNDISInterfaceInfo->State.TxPacketCount < MaxPacketsPerTransfer)
 	{
-		return ErrorCode;
+		Pipe_SelectPipe(RNDISInterfaceInfo->Config.DataOUTPipe.Address);
+		Pipe_Freeze();
+
+		return PIPE_RWSTREAM_NoError;
 	}
 
-	Pipe_Write_Stream_LE(Buffer, PacketLength, NULL);
+	return RNDIS_Host_Flush(RNDISInterfaceInfo);
+}
+
+uint8_t RNDIS_Host_Flush(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo)
+{
+	if (!(RNDISInterfaceInfo->State.TxPacketCount))
+	  return PIPE_READYWAIT_NoError;
+
+	if ((USB_HostState != HOST_STATE_Configured) || !(RNDISInterfaceInfo->State.IsActive))
+	  return PIPE_READYWAIT_DeviceDisconnected;
+
+	bool EndsOnFullPacket = !(RNDISInterfaceInfo->State.TxTransferLength % RNDISInterfaceInfo->Config.DataOUTPipe.Size);
+
+	RNDISInterfaceInfo->State.TxTransferLength = 0;
+	RNDISInterfaceInfo->State.TxPacketCount    = 0;
+
+	Pipe_SelectPipe(RNDISInterfaceInfo->Config.DataOUTPipe.Address);
+	Pipe_Unfreeze();
+
 	Pipe_ClearOUT();
 
+	/* A transfer ending on a full packet must be terminated with a zero length packet for the device to see its end */
+	if (EndsOnFullPacket)
+	{
+		uint8_t ErrorCode;
+
+		if ((ErrorCode = Pipe_WaitUntilReady()) != PIPE_READYWAIT_NoError)
+		  return ErrorCode;
+
+		Pipe_ClearOUT();
+	}
+
 	Pipe_Freeze();
 
-	return PIPE_RWSTREAM_NoError;
+	return PIPE_READYWAIT_NoError;
 }
 
 #endif
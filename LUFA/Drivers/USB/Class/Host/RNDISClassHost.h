@@ -48,6 +48,11 @@
  *  Host Mode USB Class driver framework interface, for the Microsoft RNDIS Ethernet
  *  USB Class driver.
  *
+ *  As with the device mode driver, Ethernet frames may be exchanged either whole or piecewise via the \c Begin
+ *  and \c End packet functions, with the frame data streamed directly to or from the data pipes by the application.
+ *  Several frames may be combined into a single bulk transfer to the device when both the host's
+ *  \c MaxPacketsPerTransfer configuration value and the attached device allow it.
+ *
  *  @{
  */
 
@@ -85,6 +90,12 @@
 					USB_Pipe_Table_t NotificationPipe; /**< Notification IN Pipe configuration table. */
 
 					uint32_t HostMaxPacketSize; /**< Maximum size of a packet which can be buffered by the host. */
+
+					uint8_t  MaxPacketsPerTransfer; /**< Maximum number of Ethernet frames which may be combined into a single
+					                                 *   bulk transfer to the device, or zero to send only a single frame per
+					                                 *   transfer. When greater than one, sent frames are held until the transfer
+					                                 *   is full or \ref RNDIS_Host_Flush() is called.
+					                                 */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */
@@ -97,8 +108,21 @@
 					uint8_t ControlInterfaceNumber; /**< Interface index of the RNDIS control interface within the attached device. */
 
 					uint32_t DeviceMaxPacketSize; /**< Maximum size of a packet which can be buffered by the attached RNDIS device. */
+					uint32_t DeviceMaxPacketsPerTransfer; /**< Maximum number of packet messages the attached RNDIS device accepts
+					                                       *   in a single bulk transfer.
+					                                       */
 
 					uint32_t RequestID; /**< Request ID counter to give a unique ID for each command/response pair. */
+
+					uint16_t RxTransferLength; /**< Number of bytes of the current IN transfer consumed, used internally by the
+					                            *   class driver to locate the end of the transfer.
+					                            */
+					uint16_t RxMessageLength; /**< Length of the RNDIS packet message currently being read. */
+					uint16_t RxTrailerLength; /**< Number of bytes following the frame data in the RNDIS packet message currently
+					                           *   being read.
+					                           */
+					uint32_t TxTransferLength; /**< Number of bytes written into the current OUT transfer. */
+					uint8_t  TxPacketCount; /**< Number of RNDIS packet messages written into the current OUT transfer. */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 						  *   <b>may</b> be set to initial values, but may also be ignored to default to sane values when
 						  *   the interface is enumerated.
@@ -225,6 +249,69 @@
 			                              void* Buffer,
 			                              const uint16_t PacketLength) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
 
+			/** Begins reading the next pending packet from the device, parsing and discarding its RNDIS packet message header so
+			 *  that the pipe is left positioned at the start of the Ethernet frame. The application must then read exactly the
+			 *  returned number of frame bytes from the data IN pipe using the regular pipe stream functions, before calling
+			 *  \ref RNDIS_Host_EndReadPacket().
+			 *
+			 *  \pre This function must only be called when the Host state machine is in the \ref HOST_STATE_Configured state or the
+			 *       call will fail.
+			 *
+			 *  \note If no packet is waiting, or the device sent padding rather than a packet, the returned length is zero and
+			 *        \ref RNDIS_Host_EndReadPacket() must not be called.
+			 *
+			 *  \param[in,out] RNDISInterfaceInfo  Pointer to a structure containing an RNDIS Class host configuration and state.
+			 *  \param[out]    PacketLength        Pointer to where the length in bytes of the waiting Ethernet frame is to be stored.
+			 *
+			 *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum, or \ref RNDIS_ERROR_LOGICAL_CMD_FAILED if the
+			 *          device sent a malformed packet message.
+			 */
+			uint8_t RNDIS_Host_BeginReadPacket(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo,
+			                                   uint16_t* const PacketLength) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Completes the reading of a packet started with \ref RNDIS_Host_BeginReadPacket(), discarding any padding
+			 *  following the frame. The data IN pipe bank is released once all the RNDIS packet messages it contains have
+			 *  been read.
+			 *
+			 *  \param[in,out] RNDISInterfaceInfo  Pointer to a structure containing an RNDIS Class host configuration and state.
+			 *
+			 *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum.
+			 */
+			uint8_t RNDIS_Host_EndReadPacket(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Begins sending a packet to the attached device, writing its RNDIS packet message header to the data OUT pipe. The
+			 *  application must then write exactly \c PacketLength bytes of Ethernet frame data using the regular pipe stream
+			 *  functions before calling \ref RNDIS_Host_EndSendPacket().
+			 *
+			 *  \pre This function must only be called when the Host state machine is in the \ref HOST_STATE_Configured state or the
+			 *       call will fail.
+			 *
+			 *  \param[in,out] RNDISInterfaceInfo  Pointer to a structure containing an RNDIS Class host configuration and state.
+			 *  \param[in]     PacketLength        Length in bytes of the Ethernet frame to send.
+			 *
+			 *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum.
+			 */
+			uint8_t RNDIS_Host_BeginSendPacket(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo,
+			                                   const uint16_t PacketLength) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Completes the sending of a packet started with \ref RNDIS_Host_BeginSendPacket(). The bulk transfer is ended and
+			 *  sent to the device immediately unless further packets may be added to it.
+			 *
+			 *  \param[in,out] RNDISInterfaceInfo  Pointer to a structure containing an RNDIS Class host configuration and state.
+			 *
+			 *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum.
+			 */
+			uint8_t RNDIS_Host_EndSendPacket(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Ends the current bulk transfer of packets to the device, if any packets are waiting in it. This is called
+			 *  automatically from \ref RNDIS_Host_USBTask().
+			 *
+			 *  \param[in,out] RNDISInterfaceInfo  Pointer to a structure containing an RNDIS Class host configuration and state.
+			 *
+			 *  \return A value from the \ref Pipe_WaitUntilReady_ErrorCodes_t enum.
+			 */
+			uint8_t RNDIS_Host_Flush(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
 		/* Inline Functions: */
 			/** General management task for a given RNDIS host class interface, required for the correct operation of the interface. This should
 			 *  be called frequently in the main program loop, before the master USB management task \ref USB_USBTask().
@@ -234,7 +321,7 @@
 			static inline void RNDIS_Host_USBTask(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1) ATTR_ALWAYS_INLINE;
 			static inline void RNDIS_Host_USBTask(USB_ClassInfo_RNDIS_Host_t* const RNDISInterfaceInfo)
 			{
-				(void)RNDISInterfaceInfo;
+				RNDIS_Host_Flush(RNDISInterfaceInfo);
 			}
 
 	/* Private Interface - For use in library only: */
@@ -250,12 +337,6 @@
 				                                             const uint16_t Length) ATTR_NON_NULL_PTR_ARG(1)
 				                                             ATTR_NON_NULL_PTR_ARG(2);
 
-				static uint8_t DCOMP_RNDIS_Host_NextRNDISControlInterface(void* const CurrentDescriptor)
-				                                                          ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-				static uint8_t DCOMP_RNDIS_Host_NextRNDISDataInterface(void* const CurrentDescriptor)
-				                                                       ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-				static uint8_t DCOMP_RNDIS_Host_NextRNDISInterfaceEndpoint(void* const CurrentDescriptor)
-				                                                           ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
 			#endif
 	#endif
 
@@ -41,50 +41,29 @@ uint8_t SI_Host_ConfigurePipes(USB_ClassInfo_SI_Host_t* const SIInterfaceInfo,
                                uint16_t ConfigDescriptorSize,
                                void* ConfigDescriptorData)
 {
-	USB_Descriptor_Endpoint_t*  DataINEndpoint      = NULL;
-	USB_Descriptor_Endpoint_t*  DataOUTEndpoint     = NULL;
-	USB_Descriptor_Endpoint_t*  EventsEndpoint      = NULL;
-	USB_Descriptor_Interface_t* StillImageInterface = NULL;
+	const USB_ConfigIndex_t*           ConfigIndex;
+	USB_ConfigIndex_Interface_t        StillImageInterface;
+	USB_Descriptor_Endpoint_t*         DataINEndpoint  = NULL;
+	USB_Descriptor_Endpoint_t*         DataOUTEndpoint = NULL;
+	USB_Descriptor_Endpoint_t*         EventsEndpoint  = NULL;
+	uint8_t                            InterfaceIndex  = 0;
 
 	memset(&SIInterfaceInfo->State, 0x00, sizeof(SIInterfaceInfo->State));
 
-	if (DESCRIPTOR_TYPE(ConfigDescriptorData) != DTYPE_Configuration)
+	if (!(ConfigIndex = USB_Host_GetConfigIndex(ConfigDescriptorSize, ConfigDescriptorData)))
 	  return SI_ENUMERROR_InvalidConfigDescriptor;
 
 	while (!(DataINEndpoint) || !(DataOUTEndpoint) || !(EventsEndpoint))
 	{
-		if (!(StillImageInterface) ||
-		    USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-		                              DCOMP_SI_Host_NextSIInterfaceEndpoint) != DESCRIPTOR_SEARCH_COMP_Found)
+		if (!(USB_Host_FindIndexedInterface(ConfigIndex, &InterfaceIndex, SI_CSCP_StillImageClass,
+		                                    SI_CSCP_StillImageSubclass, SI_CSCP_BulkOnlyProtocol, &StillImageInterface)))
 		{
-			if (USB_GetNextDescriptorComp(&ConfigDescriptorSize, &ConfigDescriptorData,
-			                              DCOMP_SI_Host_NextSIInterface) != DESCRIPTOR_SEARCH_COMP_Found)
-			{
-				return SI_ENUMERROR_NoCompatibleInterfaceFound;
-			}
-
-			StillImageInterface = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Interface_t);
-
-			DataINEndpoint  = NULL;
-			DataOUTEndpoint = NULL;
-			EventsEndpoint  = NULL;
-
-			continue;
+			return SI_ENUMERROR_NoCompatibleInterfaceFound;
 		}
 
-		USB_Descriptor_Endpoint_t* EndpointData = DESCRIPTOR_PCAST(ConfigDescriptorData, USB_Descriptor_Endpoint_t);
-
-		if ((EndpointData->EndpointAddress & ENDPOINT_DIR_MASK) == ENDPOINT_DIR_IN)
-		{
-			if ((EndpointData->Attributes & EP_TYPE_MASK) == EP_TYPE_INTERRUPT)
-			  EventsEndpoint = EndpointData;
-			else
-			  DataINEndpoint = EndpointData;
-		}
-		else
-		{
-			DataOUTEndpoint = EndpointData;
-		}
+		DataINEndpoint  = USB_Host_GetIndexedEndpoint(&StillImageInterface, ENDPOINT_DIR_IN,  EP_TYPE_BULK);
+		DataOUTEndpoint = USB_Host_GetIndexedEndpoint(&StillImageInterface, ENDPOINT_DIR_OUT, EP_TYPE_BULK);
+		EventsEndpoint  = USB_Host_GetIndexedEndpoint(&StillImageInterface, ENDPOINT_DIR_IN,  EP_TYPE_INTERRUPT);
 	}
 
 	SIInterfaceInfo->Config.DataINPipe.Size  = le16_to_cpu(DataINEndpoint->EndpointSize);
@@ -108,55 +87,12 @@ uint8_t SI_Host_ConfigurePipes(USB_ClassInfo_SI_Host_t* const SIInterfaceInfo,
 	if (!(Pipe_ConfigurePipeTable(&SIInterfaceInfo->Config.EventsPipe, 1)))
 	  return false;
 	
-	SIInterfaceInfo->State.InterfaceNumber = StillImageInterface->InterfaceNumber;
+	SIInterfaceInfo->State.InterfaceNumber = StillImageInterface.Descriptor->InterfaceNumber;
 	SIInterfaceInfo->State.IsActive = true;
 
 	return SI_ENUMERROR_NoError;
 }
 
-uint8_t DCOMP_SI_Host_NextSIInterface(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Interface)
-	{
-		USB_Descriptor_Interface_t* Interface = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Interface_t);
-
-		if ((Interface->Class    == SI_CSCP_StillImageClass)    &&
-		    (Interface->SubClass == SI_CSCP_StillImageSubclass) &&
-		    (Interface->Protocol == SI_CSCP_BulkOnlyProtocol))
-		{
-			return DESCRIPTOR_SEARCH_Found;
-		}
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
-uint8_t DCOMP_SI_Host_NextSIInterfaceEndpoint(void* const CurrentDescriptor)
-{
-	USB_Descriptor_Header_t* Header = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Header_t);
-
-	if (Header->Type == DTYPE_Endpoint)
-	{
-		USB_Descriptor_Endpoint_t* Endpoint = DESCRIPTOR_PCAST(CurrentDescriptor, USB_Descriptor_Endpoint_t);
-
-		uint8_t EndpointType = (Endpoint->Attributes & EP_TYPE_MASK);
-
-		if (((EndpointType == EP_TYPE_BULK) || (EndpointType == EP_TYPE_INTERRUPT)) &&
-		    (!(Pipe_IsEndpointBound(Endpoint->EndpointAddress))))
-		{
-			return DESCRIPTOR_SEARCH_Found;
-		}
-	}
-	else if (Header->Type == DTYPE_Interface)
-	{
-		return DESCRIPTOR_SEARCH_Fail;
-	}
-
-	return DESCRIPTOR_SEARCH_NotFound;
-}
-
 uint8_t SI_Host_SendBlockHeader(USB_ClassInfo_SI_Host_t* const SIInterfaceInfo,
                                 PIMA_Container_t* const PIMAHeader)
 {
@@ -296,14 +296,6 @@
 	#if !defined(__DOXYGEN__)
 		/* Macros: */
 			#define SI_COMMAND_DATA_TIMEOUT_MS        10000
-
-		/* Function Prototypes: */
-			#if defined(__INCLUDE_FROM_STILLIMAGE_HOST_C)
-				static uint8_t DCOMP_SI_Host_NextSIInterface(void* const CurrentDescriptor)
-				                                             ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-				static uint8_t DCOMP_SI_Host_NextSIInterfaceEndpoint(void* const CurrentDescriptor)
-				                                                     ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1);
-			#endif
 	#endif
 
 	/* Disable C linkage for C++ Compilers: */
@@ -39,6 +39,18 @@
 #include "EndpointStream_AVR8.h"
 
 #if !defined(CONTROL_ONLY_DEVICE)
+static inline uint16_t Endpoint_BytesFreeInBank(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+static inline uint16_t Endpoint_BytesFreeInBank(void)
+{
+	return ((8 << ((UECFG1X & (0x07 << EPSIZE0)) >> EPSIZE0)) - Endpoint_BytesInEndpoint());
+}
+
+static inline uint16_t Endpoint_BytesLeftInBank(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+static inline uint16_t Endpoint_BytesLeftInBank(void)
+{
+	return Endpoint_BytesInEndpoint();
+}
+
 uint8_t Endpoint_Discard_Stream(uint16_t Length,
                                 uint16_t* const BytesProcessed)
 {
@@ -123,6 +135,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Write_Stream_LE
 #define  TEMPLATE_BUFFER_TYPE                      const void*
 #define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 #define  TEMPLATE_BUFFER_OFFSET(Length)            0
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(*BufferPtr)
@@ -131,6 +144,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Write_Stream_BE
 #define  TEMPLATE_BUFFER_TYPE                      const void*
 #define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 #define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(*BufferPtr)
@@ -139,6 +153,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Read_Stream_LE
 #define  TEMPLATE_BUFFER_TYPE                      void*
 #define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearOUT()
+#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesLeftInBank()
 #define  TEMPLATE_BUFFER_OFFSET(Length)            0
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         *BufferPtr = Endpoint_Read_8()
@@ -147,6 +162,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Read_Stream_BE
 #define  TEMPLATE_BUFFER_TYPE                      void*
 #define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearOUT()
+#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesLeftInBank()
 #define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         *BufferPtr = Endpoint_Read_8()
@@ -156,6 +172,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_PStream_LE
 	#define  TEMPLATE_BUFFER_TYPE                      const void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            0
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(pgm_read_byte(BufferPtr))
@@ -164,6 +181,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_PStream_BE
 	#define  TEMPLATE_BUFFER_TYPE                      const void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(pgm_read_byte(BufferPtr))
@@ -174,6 +192,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_EStream_LE
 	#define  TEMPLATE_BUFFER_TYPE                      const void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            0
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(eeprom_read_byte(BufferPtr))
@@ -182,6 +201,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_EStream_BE
 	#define  TEMPLATE_BUFFER_TYPE                      const void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(eeprom_read_byte(BufferPtr))
@@ -190,6 +210,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Read_EStream_LE
 	#define  TEMPLATE_BUFFER_TYPE                      void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearOUT()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesLeftInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            0
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         eeprom_update_byte(BufferPtr, Endpoint_Read_8())
@@ -198,6 +219,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Read_EStream_BE
 	#define  TEMPLATE_BUFFER_TYPE                      void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearOUT()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesLeftInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         eeprom_update_byte(BufferPtr, Endpoint_Read_8())
@@ -190,7 +190,10 @@ uint8_t Endpoint_WaitUntilReady(void)
 			PreviousFrameNumber = CurrentFrameNumber;
 
 			if (!(TimeoutMSRem--))
-			  return ENDPOINT_READYWAIT_Timeout;
+			{
+				USB_TRACE_TIMEOUT(Endpoint_GetCurrentEndpoint());
+				return ENDPOINT_READYWAIT_Timeout;
+			}
 		}
 	}
 }
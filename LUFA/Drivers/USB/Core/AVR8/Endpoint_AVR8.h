@@ -75,6 +75,7 @@
 	/* Includes: */
 		#include "../../../../Common/Common.h"
 		#include "../USBTask.h"
+		#include "../USBTrace.h"
 		#include "../USBInterrupt.h"
 
 	/* Enable C linkage for C++ Compilers: */
@@ -230,6 +231,20 @@
 				#endif
 			}
 
+			/** Retrieves the bank size in bytes of the currently selected endpoint, as set when the endpoint was
+			 *  configured. This is the maximum packet size of the endpoint; a packet smaller than this indicates the
+			 *  end of a transfer.
+			 *
+			 *  \ingroup Group_EndpointRW_AVR8
+			 *
+			 *  \return Size in bytes of each bank of the currently selected endpoint.
+			 */
+			static inline uint16_t Endpoint_GetEndpointSize(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint16_t Endpoint_GetEndpointSize(void)
+			{
+				return (8 << ((UECFG1X & (0x07 << EPSIZE0)) >> EPSIZE0));
+			}
+
 			/** Determines the currently selected endpoint's direction.
 			 *
 			 *  \return The currently selected endpoint's direction, as a \c ENDPOINT_DIR_* mask.
@@ -452,7 +467,15 @@
 			static inline void Endpoint_ClearIN(void) ATTR_ALWAYS_INLINE;
 			static inline void Endpoint_ClearIN(void)
 			{
-				#if !defined(CONTROL_ONLY_DEVICE)
+				#if defined(USB_ENABLE_TRACE)
+					USB_TRACE_PACKET_SENT(Endpoint_GetCurrentEndpoint(), Endpoint_BytesInEndpoint(), (UEINTX & (1 << NAKINI)));
+
+					#if !defined(CONTROL_ONLY_DEVICE)
+						UEINTX &= ~((1 << TXINI) | (1 << FIFOCON) | (1 << NAKINI));
+					#else
+						UEINTX &= ~((1 << TXINI) | (1 << NAKINI));
+					#endif
+				#elif !defined(CONTROL_ONLY_DEVICE)
 					UEINTX &= ~((1 << TXINI) | (1 << FIFOCON));
 				#else
 					UEINTX &= ~(1 << TXINI);
@@ -467,7 +490,15 @@
 			static inline void Endpoint_ClearOUT(void) ATTR_ALWAYS_INLINE;
 			static inline void Endpoint_ClearOUT(void)
 			{
-				#if !defined(CONTROL_ONLY_DEVICE)
+				#if defined(USB_ENABLE_TRACE)
+					USB_TRACE_PACKET_RECEIVED(Endpoint_GetCurrentEndpoint(), (UEINTX & (1 << NAKOUTI)));
+
+					#if !defined(CONTROL_ONLY_DEVICE)
+						UEINTX &= ~((1 << RXOUTI) | (1 << FIFOCON) | (1 << NAKOUTI));
+					#else
+						UEINTX &= ~((1 << RXOUTI) | (1 << NAKOUTI));
+					#endif
+				#elif !defined(CONTROL_ONLY_DEVICE)
 					UEINTX &= ~((1 << RXOUTI) | (1 << FIFOCON));
 				#else
 					UEINTX &= ~(1 << RXOUTI);
@@ -488,6 +519,8 @@
 			static inline void Endpoint_StallTransaction(void) ATTR_ALWAYS_INLINE;
 			static inline void Endpoint_StallTransaction(void)
 			{
+				USB_TRACE_STALL(Endpoint_GetCurrentEndpoint());
+
 				UECONX |= (1 << STALLRQ);
 			}
 
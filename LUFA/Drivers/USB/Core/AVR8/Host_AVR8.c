@@ -39,58 +39,57 @@
 #define  __INCLUDE_FROM_HOST_C
 #include "../Host.h"
 
+#if defined(HOST_MEASURE_ENUMERATION_TIME)
+USB_Host_EnumerationTime_t USB_Host_EnumerationTime;
+#endif
+
+static uint16_t USB_Host_BusTimeMS;
+static uint16_t USB_Host_PreviousFrameNumber;
+static bool     USB_Host_DeviceResetPending;
+
 void USB_Host_ProcessNextHostState(void)
 {
 	uint8_t ErrorCode    = HOST_ENUMERROR_NoError;
 	uint8_t SubErrorCode = HOST_ENUMERROR_NoError;
 
-	static uint16_t WaitMSRemaining;
+	static uint16_t WaitDurationMS;
+	static uint16_t WaitStartTime;
 	static uint8_t  PostWaitState;
 
+	uint16_t BusTime = USB_Host_UpdateBusTime();
+
 	switch (USB_HostState)
 	{
 		case HOST_STATE_WaitForDevice:
-			if (WaitMSRemaining)
+			if (USB_Host_DeviceResetPending)
 			{
-				if ((SubErrorCode = USB_Host_WaitMS(1)) != HOST_WAITERROR_Successful)
-				{
-					USB_HostState = PostWaitState;
-					ErrorCode     = HOST_ENUMERROR_WaitStage;
-					break;
-				}
+				if (!(USB_Host_IsBusResetComplete()))
+				  break;
 
-				if (!(--WaitMSRemaining))
-				  USB_HostState = PostWaitState;
+				USB_Host_CompleteDeviceReset();
+
+				/* Reset recovery intervals are timed from the end of the reset signalling */
+				WaitStartTime = USB_Host_UpdateBusTime();
+				break;
 			}
 
+			if ((uint16_t)(BusTime - WaitStartTime) >= WaitDurationMS)
+			  USB_HostState = PostWaitState;
+
 			break;
 		case HOST_STATE_Powered:
-			WaitMSRemaining = HOST_DEVICE_SETTLE_DELAY_MS;
+			USB_Host_VBUS_Manual_Off();
 
-			USB_HostState = HOST_STATE_Powered_WaitForDeviceSettle;
-			break;
-		case HOST_STATE_Powered_WaitForDeviceSettle:
-			if (WaitMSRemaining--)
-			{
-				Delay_MS(1);
-				break;
-			}
-			else
-			{
-				USB_Host_VBUS_Manual_Off();
-
-				USB_OTGPAD_On();
-				USB_Host_VBUS_Auto_Enable();
-				USB_Host_VBUS_Auto_On();
-				
-				#if defined(NO_AUTO_VBUS_MANAGEMENT)
-				USB_Host_VBUS_Manual_Enable();
-				USB_Host_VBUS_Manual_On();
-				#endif
+			USB_OTGPAD_On();
+			USB_Host_VBUS_Auto_Enable();
+			USB_Host_VBUS_Auto_On();
 
-				USB_HostState = HOST_STATE_Powered_WaitForConnect;
-			}
+			#if defined(NO_AUTO_VBUS_MANAGEMENT)
+			USB_Host_VBUS_Manual_Enable();
+			USB_Host_VBUS_Manual_On();
+			#endif
 
+			USB_HostState = HOST_STATE_Powered_WaitForConnect;
 			break;
 		case HOST_STATE_Powered_WaitForConnect:
 			if (USB_INT_HasOccurred(USB_INT_DCONNI))
@@ -104,14 +103,26 @@ void USB_Host_ProcessNextHostState(void)
 				USB_Host_ResumeBus();
 				Pipe_ClearPipes();
 
-				HOST_TASK_NONBLOCK_WAIT(100, HOST_STATE_Powered_DoReset);
+				/* All enumeration delays are timed in bus frames from the moment the device connection is detected */
+				USB_Host_PreviousFrameNumber = USB_Host_GetFrameNumber();
+				USB_Host_BusTimeMS           = 0;
+
+				#if defined(HOST_MEASURE_ENUMERATION_TIME)
+				memset(&USB_Host_EnumerationTime, 0x00, sizeof(USB_Host_EnumerationTime_t));
+				#endif
+
+				HOST_TASK_NONBLOCK_WAIT((HOST_DEVICE_SETTLE_DELAY_MS + HOST_CONNECT_DEBOUNCE_MS), HOST_STATE_Powered_DoReset);
 			}
 
 			break;
 		case HOST_STATE_Powered_DoReset:
+			#if defined(HOST_MEASURE_ENUMERATION_TIME)
+			USB_Host_EnumerationTime.ResetMS = BusTime;
+			#endif
+
 			USB_Host_ResetDevice();
 
-			HOST_TASK_NONBLOCK_WAIT(200, HOST_STATE_Powered_ConfigPipe);
+			HOST_TASK_NONBLOCK_WAIT(HOST_RESET_RECOVERY_MS, HOST_STATE_Powered_ConfigPipe);
 			break;
 		case HOST_STATE_Powered_ConfigPipe:
 			if (!(Pipe_ConfigurePipe(PIPE_CONTROLPIPE, EP_TYPE_CONTROL, ENDPOINT_CONTROLEP, PIPE_CONTROLPIPE_DEFAULT_SIZE, 1)))
@@ -146,7 +157,7 @@ void USB_Host_ProcessNextHostState(void)
 
 			USB_Host_ResetDevice();
 
-			HOST_TASK_NONBLOCK_WAIT(200, HOST_STATE_Default_PostReset);
+			HOST_TASK_NONBLOCK_WAIT(HOST_RESET_RECOVERY_MS, HOST_STATE_Default_PostReset);
 			break;
 		case HOST_STATE_Default_PostReset:
 			if (!(Pipe_ConfigurePipe(PIPE_CONTROLPIPE, EP_TYPE_CONTROL, ENDPOINT_CONTROLEP, USB_Host_ControlPipeSize, 1)))
@@ -171,15 +182,26 @@ void USB_Host_ProcessNextHostState(void)
 				break;
 			}
 
-			HOST_TASK_NONBLOCK_WAIT(100, HOST_STATE_Default_PostAddressSet);
+			HOST_TASK_NONBLOCK_WAIT(HOST_SET_ADDRESS_RECOVERY_MS, HOST_STATE_Default_PostAddressSet);
 			break;
 		case HOST_STATE_Default_PostAddressSet:
 			USB_Host_SetDeviceAddress(USB_HOST_DEVICEADDRESS);
 
 			USB_HostState = HOST_STATE_Addressed;
 
+			#if defined(HOST_MEASURE_ENUMERATION_TIME)
+			USB_Host_EnumerationTime.AddressedMS = BusTime;
+			#endif
+
 			EVENT_USB_Host_DeviceEnumerationComplete();
 			break;
+		#if defined(HOST_MEASURE_ENUMERATION_TIME)
+		case HOST_STATE_Configured:
+			if (!(USB_Host_EnumerationTime.ConfiguredMS))
+			  USB_Host_EnumerationTime.ConfiguredMS = BusTime;
+
+			break;
+		#endif
 
 		default:
 			break;
@@ -187,10 +209,12 @@ void USB_Host_ProcessNextHostState(void)
 
 	if ((ErrorCode != HOST_ENUMERROR_NoError) && (USB_HostState != HOST_STATE_Unattached))
 	{
+		USB_TRACE_EVENT(TRACE_EVENT_HostEnumerationError, 0, ErrorCode, SubErrorCode);
 		EVENT_USB_Host_DeviceEnumerationFailed(ErrorCode, SubErrorCode);
 
 		USB_Host_VBUS_Auto_Off();
 
+		USB_TRACE_EVENT(TRACE_EVENT_HostDeviceUnattached, 0, 0, 0);
 		EVENT_USB_Host_DeviceUnattached();
 
 		USB_ResetInterface();
@@ -249,17 +273,32 @@ uint8_t USB_Host_WaitMS(uint8_t MS)
 	return ErrorCode;
 }
 
-static void USB_Host_ResetDevice(void)
+static uint16_t USB_Host_UpdateBusTime(void)
 {
-	bool BusSuspended = USB_Host_IsBusSuspended();
+	uint16_t FrameNumber = USB_Host_GetFrameNumber();
 
+	/* The frame number wraps every 2048 frames, so this must be called at least once in that period to keep time */
+	USB_Host_BusTimeMS          += ((FrameNumber - USB_Host_PreviousFrameNumber) & USB_HOST_FRAMENUMBER_MASK);
+	USB_Host_PreviousFrameNumber = FrameNumber;
+
+	return USB_Host_BusTimeMS;
+}
+
+static void USB_Host_ResetDevice(void)
+{
 	USB_INT_Disable(USB_INT_DDISCI);
 
 	USB_Host_ResetBus();
-	while (!(USB_Host_IsBusResetComplete()));
-	USB_Host_ResumeBus();
 
 	USB_Host_ConfigurationNumber = 0;
+	USB_Host_DeviceResetPending  = true;
+}
+
+static void USB_Host_CompleteDeviceReset(void)
+{
+	USB_Host_DeviceResetPending = false;
+
+	USB_Host_ResumeBus();
 
 	bool HSOFIEnabled = USB_INT_IsEnabled(USB_INT_HSOFI);
 
@@ -286,8 +325,8 @@ static void USB_Host_ResetDevice(void)
 	if (HSOFIEnabled)
 	  USB_INT_Enable(USB_INT_HSOFI);
 
-	if (BusSuspended)
-	  USB_Host_SuspendBus();
+	/* The frame number may restart after a bus reset, so the bus time resumes from the current frame */
+	USB_Host_PreviousFrameNumber = USB_Host_GetFrameNumber();
 
 	USB_INT_Enable(USB_INT_DDISCI);
 }
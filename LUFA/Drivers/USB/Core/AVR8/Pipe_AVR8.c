@@ -189,7 +189,10 @@ uint8_t Pipe_WaitUntilReady(void)
 		}
 
 		if (Pipe_IsStalled())
-		  return PIPE_READYWAIT_PipeStalled;
+		{
+			USB_TRACE_STALL(Pipe_GetCurrentPipe());
+			return PIPE_READYWAIT_PipeStalled;
+		}
 		else if (USB_HostState == HOST_STATE_Unattached)
 		  return PIPE_READYWAIT_DeviceDisconnected;
 
@@ -200,7 +203,10 @@ uint8_t Pipe_WaitUntilReady(void)
 			PreviousFrameNumber = CurrentFrameNumber;
 
 			if (!(TimeoutMSRem--))
-			  return PIPE_READYWAIT_Timeout;
+			{
+				USB_TRACE_TIMEOUT(Pipe_GetCurrentPipe());
+				return PIPE_READYWAIT_Timeout;
+			}
 		}
 	}
 }
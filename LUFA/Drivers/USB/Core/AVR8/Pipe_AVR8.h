@@ -85,6 +85,7 @@
 	/* Includes: */
 		#include "../../../../Common/Common.h"
 		#include "../USBTask.h"
+		#include "../USBTrace.h"
 
 	/* Enable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
@@ -187,6 +188,19 @@
 				return UPBCX;
 			}
 
+			/** Retrieves the bank size in bytes of the currently selected pipe, as set when the pipe was configured.
+			 *  This is the maximum packet size of the pipe; a packet smaller than this indicates the end of a transfer.
+			 *
+			 *  \ingroup Group_PipeRW_AVR8
+			 *
+			 *  \return Size in bytes of each bank of the currently selected pipe.
+			 */
+			static inline uint16_t Pipe_GetPipeSize(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint16_t Pipe_GetPipeSize(void)
+			{
+				return (8 << ((UPCFG1X & (0x07 << EPSIZE0)) >> EPSIZE0));
+			}
+
 			/** Determines the currently selected pipe's direction.
 			 *
 			 *  \return The currently selected pipe's direction, as a \c PIPE_DIR_* mask.
@@ -506,7 +520,13 @@
 			static inline void Pipe_ClearIN(void) ATTR_ALWAYS_INLINE;
 			static inline void Pipe_ClearIN(void)
 			{
-				UPINTX &= ~((1 << RXINI) | (1 << FIFOCON));
+				#if defined(USB_ENABLE_TRACE)
+					USB_TRACE_PACKET_RECEIVED(Pipe_GetCurrentPipe(), (UPINTX & (1 << NAKEDI)));
+
+					UPINTX &= ~((1 << RXINI) | (1 << FIFOCON) | (1 << NAKEDI));
+				#else
+					UPINTX &= ~((1 << RXINI) | (1 << FIFOCON));
+				#endif
 			}
 
 			/** Sends the currently selected pipe's contents to the device as an OUT packet on the selected pipe, freeing
@@ -517,7 +537,13 @@
 			static inline void Pipe_ClearOUT(void) ATTR_ALWAYS_INLINE;
 			static inline void Pipe_ClearOUT(void)
 			{
-				UPINTX &= ~((1 << TXOUTI) | (1 << FIFOCON));
+				#if defined(USB_ENABLE_TRACE)
+					USB_TRACE_PACKET_SENT(Pipe_GetCurrentPipe(), Pipe_BytesInPipe(), (UPINTX & (1 << NAKEDI)));
+
+					UPINTX &= ~((1 << TXOUTI) | (1 << FIFOCON) | (1 << NAKEDI));
+				#else
+					UPINTX &= ~((1 << TXOUTI) | (1 << FIFOCON));
+				#endif
 			}
 
 			/** Determines if the device sent a NAK (Negative Acknowledge) in response to the last sent packet on
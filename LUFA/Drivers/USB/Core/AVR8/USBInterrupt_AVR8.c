@@ -100,6 +100,7 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 			}
 
 			USB_DeviceState = DEVICE_STATE_Powered;
+			USB_TRACE_EVENT(TRACE_EVENT_DeviceConnect, 0, 0, 0);
 			EVENT_USB_Device_Connect();
 		}
 		else
@@ -108,6 +109,7 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 			  USB_PLL_Off();
 
 			USB_DeviceState = DEVICE_STATE_Unattached;
+			USB_TRACE_EVENT(TRACE_EVENT_DeviceDisconnect, 0, 0, 0);
 			EVENT_USB_Device_Disconnect();
 		}
 	}
@@ -125,9 +127,11 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 
 		#if defined(USB_SERIES_2_AVR) && !defined(NO_LIMITED_CONTROLLER_CONNECT)
 		USB_DeviceState = DEVICE_STATE_Unattached;
+		USB_TRACE_EVENT(TRACE_EVENT_DeviceDisconnect, 0, 0, 0);
 		EVENT_USB_Device_Disconnect();
 		#else
 		USB_DeviceState = DEVICE_STATE_Suspended;
+		USB_TRACE_EVENT(TRACE_EVENT_DeviceSuspend, 0, 0, 0);
 		EVENT_USB_Device_Suspend();
 		#endif
 	}
@@ -153,8 +157,10 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 		  USB_DeviceState = (USB_Device_IsAddressSet()) ? DEVICE_STATE_Configured : DEVICE_STATE_Powered;
 
 		#if defined(USB_SERIES_2_AVR) && !defined(NO_LIMITED_CONTROLLER_CONNECT)
+		USB_TRACE_EVENT(TRACE_EVENT_DeviceConnect, 0, 0, 0);
 		EVENT_USB_Device_Connect();
 		#else
+		USB_TRACE_EVENT(TRACE_EVENT_DeviceWakeUp, 0, 0, 0);
 		EVENT_USB_Device_WakeUp();
 		#endif
 	}
@@ -177,6 +183,7 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 		USB_INT_Enable(USB_INT_RXSTPI);
 		#endif
 
+		USB_TRACE_EVENT(TRACE_EVENT_DeviceReset, 0, 0, 0);
 		EVENT_USB_Device_Reset();
 	}
 	#endif
@@ -197,6 +204,7 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 		USB_INT_Clear(USB_INT_DCONNI);
 		USB_INT_Disable(USB_INT_DDISCI);
 
+		USB_TRACE_EVENT(TRACE_EVENT_HostDeviceUnattached, 0, 0, 0);
 		EVENT_USB_Host_DeviceUnattached();
 
 		USB_ResetInterface();
@@ -209,7 +217,9 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 		USB_Host_VBUS_Manual_Off();
 		USB_Host_VBUS_Auto_Off();
 
+		USB_TRACE_EVENT(TRACE_EVENT_HostVBUSError, 0, 0, 0);
 		EVENT_USB_Host_HostError(HOST_ERROR_VBusVoltageDip);
+		USB_TRACE_EVENT(TRACE_EVENT_HostDeviceUnattached, 0, 0, 0);
 		EVENT_USB_Host_DeviceUnattached();
 
 		USB_HostState = HOST_STATE_Unattached;
@@ -220,6 +230,7 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 		USB_INT_Clear(USB_INT_SRPI);
 		USB_INT_Disable(USB_INT_SRPI);
 
+		USB_TRACE_EVENT(TRACE_EVENT_HostDeviceAttached, 0, 0, 0);
 		EVENT_USB_Host_DeviceAttached();
 
 		USB_INT_Enable(USB_INT_DDISCI);
@@ -231,7 +242,9 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 	{
 		USB_INT_Clear(USB_INT_BCERRI);
 
+		USB_TRACE_EVENT(TRACE_EVENT_HostEnumerationError, 0, HOST_ENUMERROR_NoDeviceDetected, 0);
 		EVENT_USB_Host_DeviceEnumerationFailed(HOST_ENUMERROR_NoDeviceDetected, 0);
+		USB_TRACE_EVENT(TRACE_EVENT_HostDeviceUnattached, 0, 0, 0);
 		EVENT_USB_Host_DeviceUnattached();
 
 		USB_ResetInterface();
@@ -252,6 +265,7 @@ ISR(USB_GEN_vect, ISR_BLOCK)
 		USB_CurrentMode = USB_GetUSBModeFromUID();
 		USB_ResetInterface();
 
+		USB_TRACE_EVENT(TRACE_EVENT_UIDChange, 0, 0, 0);
 		EVENT_USB_UIDChange();
 	}
 	#endif
@@ -262,15 +276,34 @@ ISR(USB_COM_vect, ISR_BLOCK)
 {
 	uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
 
+	#if !defined(CONTROL_ONLY_DEVICE)
+	Endpoint_DisableRequestInterrupts();
+	#endif
+
 	Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
 	USB_INT_Disable(USB_INT_RXSTPI);
+	USB_INT_Disable(USB_INT_TXINI);
+	USB_INT_Disable(USB_INT_RXOUTI);
 
 	GlobalInterruptEnable();
 
-	USB_Device_ProcessControlRequest();
+	USB_Device_ProcessControlTransfer();
+
+	if (Endpoint_IsSETUPReceived())
+	  USB_Device_ProcessControlRequest();
+
+	#if !defined(CONTROL_ONLY_DEVICE)
+	Endpoint_ProcessRequests();
+	#endif
 
 	Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
 	USB_INT_Enable(USB_INT_RXSTPI);
+	USB_Device_UpdateControlTransferInterrupts();
+
+	#if !defined(CONTROL_ONLY_DEVICE)
+	Endpoint_UpdateRequestInterrupts();
+	#endif
+
 	Endpoint_SelectEndpoint(PrevSelectedEndpoint);
 }
 #endif
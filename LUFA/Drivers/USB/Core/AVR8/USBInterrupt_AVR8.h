@@ -81,6 +81,10 @@
 				USB_INT_VBERRI  = 12,
 				USB_INT_SRPI    = 13,
 				#endif
+				#if (defined(USB_CAN_BE_DEVICE) || defined(__DOXYGEN__))
+				USB_INT_TXINI   = 14,
+				USB_INT_RXOUTI  = 15,
+				#endif
 			};
 
 		/* Inline Functions: */
@@ -115,6 +119,12 @@
 					case USB_INT_RXSTPI:
 						UEIENX |= (1 << RXSTPE);
 						break;
+					case USB_INT_TXINI:
+						UEIENX |= (1 << TXINE);
+						break;
+					case USB_INT_RXOUTI:
+						UEIENX |= (1 << RXOUTE);
+						break;
 					#endif
 					#if defined(USB_CAN_BE_HOST)
 					case USB_INT_HSOFI:
@@ -175,6 +185,12 @@
 					case USB_INT_RXSTPI:
 						UEIENX &= ~(1 << RXSTPE);
 						break;
+					case USB_INT_TXINI:
+						UEIENX &= ~(1 << TXINE);
+						break;
+					case USB_INT_RXOUTI:
+						UEIENX &= ~(1 << RXOUTE);
+						break;
 					#endif
 					#if defined(USB_CAN_BE_HOST)
 					case USB_INT_HSOFI:
@@ -288,6 +304,10 @@
 						return (UDIEN  & (1 << SOFE));
 					case USB_INT_RXSTPI:
 						return (UEIENX & (1 << RXSTPE));
+					case USB_INT_TXINI:
+						return (UEIENX & (1 << TXINE));
+					case USB_INT_RXOUTI:
+						return (UEIENX & (1 << RXOUTE));
 					#endif
 					#if defined(USB_CAN_BE_HOST)
 					case USB_INT_HSOFI:
@@ -334,6 +354,10 @@
 						return (UDINT  & (1 << SOFI));
 					case USB_INT_RXSTPI:
 						return (UEINTX & (1 << RXSTPI));
+					case USB_INT_TXINI:
+						return (UEINTX & (1 << TXINI));
+					case USB_INT_RXOUTI:
+						return (UEINTX & (1 << RXOUTI));
 					#endif
 					#if defined(USB_CAN_BE_HOST)
 					case USB_INT_HSOFI:
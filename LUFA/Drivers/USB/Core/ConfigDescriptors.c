@@ -29,9 +29,13 @@
 */
 
 #define  __INCLUDE_FROM_USB_DRIVER
+#define  __INCLUDE_FROM_CONFIGDESCRIPTORS_C
 #include "ConfigDescriptors.h"
 
 #if defined(USB_CAN_BE_HOST)
+static USB_ConfigIndex_t USB_Host_ConfigIndex;
+static bool              USB_Host_ConfigIndexValid;
+
 uint8_t USB_Host_GetDeviceConfigDescriptor(const uint8_t ConfigNumber,
                                            uint16_t* const ConfigSizePtr,
                                            void* const BufferPtr,
@@ -40,6 +44,8 @@ uint8_t USB_Host_GetDeviceConfigDescriptor(const uint8_t ConfigNumber,
 	uint8_t ErrorCode;
 	uint8_t ConfigHeader[sizeof(USB_Descriptor_Configuration_Header_t)];
 
+	USB_Host_InvalidateConfigIndex();
+
 	USB_ControlRequest = (USB_Request_Header_t)
 		{
 			.bmRequestType = (REQDIR_DEVICETOHOST | REQTYPE_STANDARD | REQREC_DEVICE),
@@ -69,8 +75,251 @@ uint8_t USB_Host_GetDeviceConfigDescriptor(const uint8_t ConfigNumber,
 
 	return HOST_GETCONFIG_Successful;
 }
+
+const USB_ConfigIndex_t* USB_Host_GetConfigIndex(const uint16_t ConfigDescriptorSize,
+                                                 void* const ConfigDescriptorData)
+{
+	if (!(USB_Host_ConfigIndexValid) ||
+	    (USB_Host_ConfigIndex.ConfigDescriptorData != ConfigDescriptorData) ||
+	    (USB_Host_ConfigIndex.ConfigDescriptorSize != ConfigDescriptorSize))
+	{
+		USB_Host_ConfigIndexValid = USB_Host_IndexConfigDescriptor(&USB_Host_ConfigIndex, ConfigDescriptorSize, ConfigDescriptorData);
+	}
+
+	return USB_Host_ConfigIndexValid ? &USB_Host_ConfigIndex : NULL;
+}
+
+void USB_Host_InvalidateConfigIndex(void)
+{
+	USB_Host_ConfigIndexValid = false;
+}
+
+USB_Descriptor_Endpoint_t* USB_Host_GetIndexedEndpoint(const USB_ConfigIndex_Interface_t* const Interface,
+                                                       const uint8_t Direction,
+                                                       const uint8_t Type)
+{
+	USB_Descriptor_Endpoint_t* Endpoint = NULL;
+
+	while ((Endpoint = USB_Host_GetNextIndexedEndpoint(Interface, Endpoint)) != NULL)
+	{
+		if (((Endpoint->EndpointAddress & ENDPOINT_DIR_MASK) == Direction) &&
+		    ((Endpoint->Attributes & EP_TYPE_MASK) == Type) &&
+		    !(Pipe_IsEndpointBound(Endpoint->EndpointAddress)))
+		{
+			return Endpoint;
+		}
+	}
+
+	return NULL;
+}
 #endif
 
+bool USB_Host_IndexConfigDescriptor(USB_ConfigIndex_t* const ConfigIndex,
+                                    const uint16_t ConfigDescriptorSize,
+                                    void* const ConfigDescriptorData)
+{
+	USB_ConfigIndex_Interface_t* CurrInterface  = NULL;
+	bool                         InInterface    = false;
+	bool                         EndpointFound  = false;
+	uint8_t*                     CurrDescriptor = ConfigDescriptorData;
+	uint16_t                     BytesRem       = ConfigDescriptorSize;
+
+	ConfigIndex->ConfigDescriptorData = ConfigDescriptorData;
+	ConfigIndex->ConfigDescriptorSize = ConfigDescriptorSize;
+	ConfigIndex->TotalInterfaces      = 0;
+	ConfigIndex->OverflowOffset       = 0;
+
+	if ((BytesRem < sizeof(USB_Descriptor_Configuration_Header_t)) || (DESCRIPTOR_TYPE(CurrDescriptor) != DTYPE_Configuration))
+	  return false;
+
+	while (BytesRem)
+	{
+		uint8_t DescriptorSize;
+
+		if ((BytesRem < sizeof(USB_Descriptor_Header_t)) ||
+		    ((DescriptorSize = DESCRIPTOR_SIZE(CurrDescriptor)) < sizeof(USB_Descriptor_Header_t)) ||
+		    (DescriptorSize > BytesRem))
+		{
+			return false;
+		}
+
+		switch (DESCRIPTOR_TYPE(CurrDescriptor))
+		{
+			case DTYPE_Interface:
+				if (DescriptorSize < sizeof(USB_Descriptor_Interface_t))
+				  return false;
+
+				InInterface   = true;
+				EndpointFound = false;
+				CurrInterface = NULL;
+
+				/* Interfaces beyond the end of the table are left to be found by a linear search from the first of them */
+				if (ConfigIndex->TotalInterfaces < USB_HOST_CONFIG_INDEX_MAX_INTERFACES)
+				{
+					CurrInterface = &ConfigIndex->Interfaces[ConfigIndex->TotalInterfaces++];
+
+					CurrInterface->Descriptor           = DESCRIPTOR_PCAST(CurrDescriptor, USB_Descriptor_Interface_t);
+					CurrInterface->ClassDescriptorsSize = 0;
+					CurrInterface->DescriptorsSize      = 0;
+				}
+				else if (!(ConfigIndex->OverflowOffset))
+				{
+					ConfigIndex->OverflowOffset = (ConfigDescriptorSize - BytesRem);
+				}
+
+				break;
+			case DTYPE_Endpoint:
+				if (InInterface && (DescriptorSize < sizeof(USB_Descriptor_Endpoint_t)))
+				  return false;
+
+				EndpointFound = true;
+				break;
+			case DTYPE_InterfaceAssociation:
+				/* Association descriptors introduce the next interface rather than describing the current one */
+				InInterface   = false;
+				CurrInterface = NULL;
+				break;
+			default:
+				if (CurrInterface && !(EndpointFound))
+				  CurrInterface->ClassDescriptorsSize += DescriptorSize;
+
+				break;
+		}
+
+		if (CurrInterface)
+		  CurrInterface->DescriptorsSize += DescriptorSize;
+
+		CurrDescriptor += DescriptorSize;
+		BytesRem       -= DescriptorSize;
+	}
+
+	return true;
+}
+
+bool USB_Host_GetIndexedInterface(const USB_ConfigIndex_t* const ConfigIndex,
+                                  uint8_t* const InterfaceIndex,
+                                  USB_ConfigIndex_Interface_t* const Interface)
+{
+	if (*InterfaceIndex < ConfigIndex->TotalInterfaces)
+	{
+		*Interface = ConfigIndex->Interfaces[(*InterfaceIndex)++];
+		return true;
+	}
+
+	if (!(ConfigIndex->OverflowOffset))
+	  return false;
+
+	uint8_t* CurrDescriptor   = ((uint8_t*)ConfigIndex->ConfigDescriptorData + ConfigIndex->OverflowOffset);
+	uint16_t BytesRem         = (ConfigIndex->ConfigDescriptorSize - ConfigIndex->OverflowOffset);
+	uint8_t  InterfacesToSkip = (*InterfaceIndex - ConfigIndex->TotalInterfaces);
+
+	/* Interfaces which did not fit into the table are found by walking the descriptor from the first of them */
+	while (BytesRem)
+	{
+		if (DESCRIPTOR_TYPE(CurrDescriptor) == DTYPE_Interface)
+		{
+			if (!(InterfacesToSkip))
+			{
+				USB_Host_IndexInterface(Interface, CurrDescriptor, BytesRem);
+				(*InterfaceIndex)++;
+				return true;
+			}
+
+			InterfacesToSkip--;
+		}
+
+		BytesRem       -= DESCRIPTOR_SIZE(CurrDescriptor);
+		CurrDescriptor += DESCRIPTOR_SIZE(CurrDescriptor);
+	}
+
+	return false;
+}
+
+bool USB_Host_FindIndexedInterface(const USB_ConfigIndex_t* const ConfigIndex,
+                                   uint8_t* const InterfaceIndex,
+                                   const uint8_t Class,
+                                   const uint8_t SubClass,
+                                   const uint8_t Protocol,
+                                   USB_ConfigIndex_Interface_t* const Interface)
+{
+	while (USB_Host_GetIndexedInterface(ConfigIndex, InterfaceIndex, Interface))
+	{
+		if ((Interface->Descriptor->Class    == Class)    &&
+		    (Interface->Descriptor->SubClass == SubClass) &&
+		    (Interface->Descriptor->Protocol == Protocol))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+USB_Descriptor_Endpoint_t* USB_Host_GetNextIndexedEndpoint(const USB_ConfigIndex_Interface_t* const Interface,
+                                                           USB_Descriptor_Endpoint_t* const PrevEndpoint)
+{
+	uint8_t* CurrDescriptor = (uint8_t*)Interface->Descriptor;
+	uint16_t BytesRem       = Interface->DescriptorsSize;
+
+	/* Resume the search from the descriptor following the previously returned endpoint, if any */
+	if (PrevEndpoint)
+	{
+		BytesRem      -= ((uint8_t*)PrevEndpoint - CurrDescriptor);
+		CurrDescriptor = (uint8_t*)PrevEndpoint;
+	}
+
+	USB_GetNextDescriptorOfType(&BytesRem, (void**)&CurrDescriptor, DTYPE_Endpoint);
+
+	return BytesRem ? DESCRIPTOR_PCAST(CurrDescriptor, USB_Descriptor_Endpoint_t) : NULL;
+}
+
+void* USB_Host_GetIndexedClassDescriptor(const USB_ConfigIndex_Interface_t* const Interface,
+                                         const uint8_t Type)
+{
+	uint8_t* CurrDescriptor = (uint8_t*)Interface->Descriptor + DESCRIPTOR_SIZE(Interface->Descriptor);
+	uint16_t BytesRem       = Interface->ClassDescriptorsSize;
+
+	while (BytesRem)
+	{
+		if (DESCRIPTOR_TYPE(CurrDescriptor) == Type)
+		  return CurrDescriptor;
+
+		BytesRem       -= DESCRIPTOR_SIZE(CurrDescriptor);
+		CurrDescriptor += DESCRIPTOR_SIZE(CurrDescriptor);
+	}
+
+	return NULL;
+}
+
+static void USB_Host_IndexInterface(USB_ConfigIndex_Interface_t* const Interface,
+                                    uint8_t* CurrDescriptor,
+                                    uint16_t BytesRem)
+{
+	bool EndpointFound = false;
+
+	Interface->Descriptor           = DESCRIPTOR_PCAST(CurrDescriptor, USB_Descriptor_Interface_t);
+	Interface->ClassDescriptorsSize = 0;
+	Interface->DescriptorsSize      = 0;
+
+	/* The interface's descriptors run up to the next interface or association descriptor, with only the class-specific
+	 * descriptors ahead of its first endpoint counted as belonging to the interface itself */
+	do
+	{
+		uint8_t DescriptorSize = DESCRIPTOR_SIZE(CurrDescriptor);
+
+		if (DESCRIPTOR_TYPE(CurrDescriptor) == DTYPE_Endpoint)
+		  EndpointFound = true;
+		else if (Interface->DescriptorsSize && !(EndpointFound))
+		  Interface->ClassDescriptorsSize += DescriptorSize;
+
+		Interface->DescriptorsSize += DescriptorSize;
+		CurrDescriptor             += DescriptorSize;
+		BytesRem                   -= DescriptorSize;
+	}
+	while (BytesRem && (DESCRIPTOR_TYPE(CurrDescriptor) != DTYPE_Interface) &&
+	       (DESCRIPTOR_TYPE(CurrDescriptor) != DTYPE_InterfaceAssociation));
+}
+
 void USB_GetNextDescriptorOfType(uint16_t* const BytesRem,
                                  void** const CurrConfigLoc,
                                  const uint8_t Type)
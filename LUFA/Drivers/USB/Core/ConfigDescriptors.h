@@ -105,6 +105,19 @@
 			/** Returns the descriptor's size, expressed as the 8-bit value indicating the number of bytes. */
 			#define DESCRIPTOR_SIZE(DescriptorPtr)    DESCRIPTOR_PCAST(DescriptorPtr, USB_Descriptor_Header_t)->Size
 
+			#if !defined(USB_HOST_CONFIG_INDEX_MAX_INTERFACES) || defined(__DOXYGEN__)
+				/** Maximum number of interface descriptors (counting each alternate setting separately) which can be stored
+				 *  in a \ref USB_ConfigIndex_t configuration descriptor index. Configuration descriptors with more interface
+				 *  descriptors than this are still indexed, but the interfaces past the end of the table are located by a
+				 *  linear search of the configuration descriptor each time they are retrieved.
+				 *
+				 *  The default value may be overridden in the user project makefile by defining the
+				 *  \c USB_HOST_CONFIG_INDEX_MAX_INTERFACES token to the required value, and passed to the compiler using
+				 *  the -D switch.
+				 */
+				#define USB_HOST_CONFIG_INDEX_MAX_INTERFACES  10
+			#endif
+
 		/* Type Defines: */
 			/** Type define for a Configuration Descriptor comparator function (function taking a pointer to an array
 			 *  of type void, returning a uint8_t value).
@@ -113,6 +126,43 @@
 			 */
 			typedef uint8_t (* ConfigComparatorPtr_t)(void*);
 
+			/** \brief Configuration Descriptor Index Interface Entry.
+			 *
+			 *  Type define for a single interface descriptor entry of a \ref USB_ConfigIndex_t configuration descriptor
+			 *  index. Each alternate setting of an interface is given its own entry.
+			 */
+			typedef struct
+			{
+				USB_Descriptor_Interface_t* Descriptor; /**< Pointer to the interface descriptor inside the configuration descriptor. */
+				uint16_t ClassDescriptorsSize; /**< Total size in bytes of the class-specific descriptors which immediately follow
+				                                *   the interface descriptor, before its first endpoint descriptor.
+				                                */
+				uint16_t DescriptorsSize; /**< Total size in bytes of the interface descriptor and all of the descriptors which
+				                           *   follow it, up to the next interface or interface association descriptor.
+				                           */
+			} USB_ConfigIndex_Interface_t;
+
+			/** \brief Configuration Descriptor Index.
+			 *
+			 *  Type define for an index of a device's configuration descriptor, built in a single pass over the descriptor
+			 *  by \ref USB_Host_IndexConfigDescriptor(). The index records each interface descriptor together with the extent of
+			 *  its class-specific and endpoint descriptors, so that they can be looked up without rescanning the configuration
+			 *  descriptor. The index points into the original configuration descriptor buffer, which must remain valid while
+			 *  the index is in use.
+			 */
+			typedef struct
+			{
+				void*    ConfigDescriptorData; /**< Pointer to the start of the indexed configuration descriptor. */
+				uint16_t ConfigDescriptorSize; /**< Size in bytes of the indexed configuration descriptor. */
+				uint8_t  TotalInterfaces; /**< Number of interface descriptors stored in the index. */
+				uint16_t OverflowOffset; /**< Offset in bytes of the first interface descriptor which did not fit into the index,
+				                          *   or zero if all interface descriptors were stored.
+				                          */
+				USB_ConfigIndex_Interface_t Interfaces[USB_HOST_CONFIG_INDEX_MAX_INTERFACES]; /**< Indexed interface descriptors,
+				                                                                               *   in descriptor order.
+				                                                                               */
+			} USB_ConfigIndex_t;
+
 		/* Enums: */
 			/** Enum for the possible return codes of the \ref USB_Host_GetDeviceConfigDescriptor() function. */
 			enum USB_Host_GetConfigDescriptor_ErrorCodes_t
@@ -254,6 +304,121 @@
 			                                  void** const CurrConfigLoc,
 			                                  ConfigComparatorPtr_t const ComparatorRoutine);
 
+			/** Indexes the given configuration descriptor in a single pass, recording each interface descriptor together with
+			 *  its class-specific and endpoint descriptors into the given index. The descriptors can then be looked up with
+			 *  \ref USB_Host_GetIndexedInterface(), \ref USB_Host_FindIndexedInterface(), \ref USB_Host_GetIndexedEndpoint()
+			 *  and \ref USB_Host_GetIndexedClassDescriptor() without rescanning the configuration descriptor.
+			 *
+			 *  Interface descriptors beyond the first \ref USB_HOST_CONFIG_INDEX_MAX_INTERFACES are not stored; the index
+			 *  instead records where the first of them starts, so that they can still be retrieved by a linear search.
+			 *
+			 *  \param[out] ConfigIndex           Pointer to the index to fill.
+			 *  \param[in]  ConfigDescriptorSize  Size in bytes of the configuration descriptor.
+			 *  \param[in]  ConfigDescriptorData  Pointer to the configuration descriptor to index.
+			 *
+			 *  \return Boolean \c true if the descriptor was indexed, \c false if it is malformed.
+			 */
+			bool USB_Host_IndexConfigDescriptor(USB_ConfigIndex_t* const ConfigIndex,
+			                                    const uint16_t ConfigDescriptorSize,
+			                                    void* const ConfigDescriptorData) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(3);
+
+			/** Retrieves the library's shared index of the given configuration descriptor, indexing it first if it is not the
+			 *  descriptor most recently indexed. This allows each class driver of a composite device to look up its interfaces
+			 *  from a single pass over the configuration descriptor. The shared index is invalidated each time a configuration
+			 *  descriptor is fetched via \ref USB_Host_GetDeviceConfigDescriptor() and when the attached device is removed;
+			 *  applications which obtain or alter a configuration descriptor by other means must call
+			 *  \ref USB_Host_InvalidateConfigIndex() afterwards.
+			 *
+			 *  \note This function is available in USB Host mode only.
+			 *
+			 *  \param[in] ConfigDescriptorSize  Size in bytes of the configuration descriptor.
+			 *  \param[in] ConfigDescriptorData  Pointer to the configuration descriptor.
+			 *
+			 *  \return Pointer to the configuration descriptor's index, or \c NULL if the descriptor could not be indexed.
+			 */
+			const USB_ConfigIndex_t* USB_Host_GetConfigIndex(const uint16_t ConfigDescriptorSize,
+			                                                 void* const ConfigDescriptorData) ATTR_NON_NULL_PTR_ARG(2);
+
+			/** Invalidates the library's shared configuration descriptor index, so that it is rebuilt on the next call to
+			 *  \ref USB_Host_GetConfigIndex().
+			 *
+			 *  \note This function is available in USB Host mode only.
+			 */
+			void USB_Host_InvalidateConfigIndex(void);
+
+			/** Retrieves the given interface entry of a configuration descriptor index. Entries which did not fit into the
+			 *  index are located by a linear search of the configuration descriptor, so that up to 255 interface descriptors
+			 *  (counting each alternate setting separately) can be retrieved regardless of the index size.
+			 *
+			 *  \param[in]     ConfigIndex     Pointer to the configuration descriptor index to read.
+			 *  \param[in,out] InterfaceIndex  Pointer to the index of the interface entry to retrieve, incremented on success
+			 *                                 so that the entries can be iterated.
+			 *  \param[out]    Interface       Pointer to the location where the interface entry is to be stored.
+			 *
+			 *  \return Boolean \c true if the interface entry was retrieved, \c false if there are no further interfaces.
+			 */
+			bool USB_Host_GetIndexedInterface(const USB_ConfigIndex_t* const ConfigIndex,
+			                                  uint8_t* const InterfaceIndex,
+			                                  USB_ConfigIndex_Interface_t* const Interface)
+			                                  ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2) ATTR_NON_NULL_PTR_ARG(3);
+
+			/** Searches a configuration descriptor index for the next interface descriptor with the given class, subclass
+			 *  and protocol values, starting from the given interface entry.
+			 *
+			 *  \param[in]     ConfigIndex     Pointer to the configuration descriptor index to search.
+			 *  \param[in,out] InterfaceIndex  Pointer to the index of the first interface entry to check, set to the entry
+			 *                                 following the matching interface on return so that the search can be continued.
+			 *  \param[in]     Class           Interface class value to search for.
+			 *  \param[in]     SubClass        Interface subclass value to search for.
+			 *  \param[in]     Protocol        Interface protocol value to search for.
+			 *  \param[out]    Interface       Pointer to the location where the matching interface entry is to be stored.
+			 *
+			 *  \return Boolean \c true if a matching interface was found, \c false if no further interface matches.
+			 */
+			bool USB_Host_FindIndexedInterface(const USB_ConfigIndex_t* const ConfigIndex,
+			                                   uint8_t* const InterfaceIndex,
+			                                   const uint8_t Class,
+			                                   const uint8_t SubClass,
+			                                   const uint8_t Protocol,
+			                                   USB_ConfigIndex_Interface_t* const Interface)
+			                                   ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2) ATTR_NON_NULL_PTR_ARG(6);
+
+			/** Retrieves the next endpoint descriptor of an indexed interface, in descriptor order.
+			 *
+			 *  \param[in] Interface     Pointer to the interface entry whose endpoints are to be iterated.
+			 *  \param[in] PrevEndpoint  Pointer to the previously retrieved endpoint descriptor, or \c NULL to retrieve the first.
+			 *
+			 *  \return Pointer to the next endpoint descriptor, or \c NULL if the interface has no further endpoints.
+			 */
+			USB_Descriptor_Endpoint_t* USB_Host_GetNextIndexedEndpoint(const USB_ConfigIndex_Interface_t* const Interface,
+			                                                           USB_Descriptor_Endpoint_t* const PrevEndpoint)
+			                                                           ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Retrieves the first endpoint descriptor of an indexed interface with the given direction and type, which is
+			 *  not already bound to a configured pipe.
+			 *
+			 *  \note This function is available in USB Host mode only.
+			 *
+			 *  \param[in] Interface  Pointer to the interface entry whose endpoints are to be searched.
+			 *  \param[in] Direction  Endpoint direction to search for, either \ref ENDPOINT_DIR_IN or \ref ENDPOINT_DIR_OUT.
+			 *  \param[in] Type       Endpoint type to search for, an \c EP_TYPE_* value.
+			 *
+			 *  \return Pointer to the matching endpoint descriptor, or \c NULL if the interface has no such endpoint.
+			 */
+			USB_Descriptor_Endpoint_t* USB_Host_GetIndexedEndpoint(const USB_ConfigIndex_Interface_t* const Interface,
+			                                                       const uint8_t Direction,
+			                                                       const uint8_t Type) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Retrieves the first class-specific descriptor of an indexed interface with the given descriptor type.
+			 *
+			 *  \param[in] Interface  Pointer to the interface entry whose class-specific descriptors are to be searched.
+			 *  \param[in] Type       Descriptor type value to search for.
+			 *
+			 *  \return Pointer to the matching descriptor, or \c NULL if the interface has no such descriptor.
+			 */
+			void* USB_Host_GetIndexedClassDescriptor(const USB_ConfigIndex_Interface_t* const Interface,
+			                                         const uint8_t Type) ATTR_NON_NULL_PTR_ARG(1);
+
 		/* Inline Functions: */
 			/** Skips over the current sub-descriptor inside the configuration descriptor, so that the pointer then
 			    points to the next sub-descriptor. The bytes remaining value is automatically decremented.
@@ -275,6 +440,16 @@
 				*BytesRem      -= CurrDescriptorSize;
 			}
 
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Function Prototypes: */
+			#if defined(__INCLUDE_FROM_CONFIGDESCRIPTORS_C)
+				static void USB_Host_IndexInterface(USB_ConfigIndex_Interface_t* const Interface,
+				                                    uint8_t* CurrDescriptor,
+				                                    uint16_t BytesRem) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+			#endif
+	#endif
+
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			}
@@ -0,0 +1,326 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "USBMode.h"
+
+#if defined(USB_CAN_BE_DEVICE)
+
+#define  __INCLUDE_FROM_DEVICECONTROLTRANSFER_C
+#include "DeviceControlTransfer.h"
+#include "USBController.h"
+#include "USBInterrupt.h"
+#include "Endpoint.h"
+
+static struct
+{
+	uint8_t                      Stage;
+	bool                         SendZLP;
+	uint16_t                     Length;
+	uint8_t*                     Buffer;
+	#if defined(ARCH_HAS_MULTI_ADDRESS_SPACE)
+	uint8_t                      MemorySpace;
+	#endif
+	USB_Device_ControlCallback_t Callback;
+	void*                        Context;
+	uint8_t                      Data[USB_DEVICE_CONTROL_BUFFER_SIZE];
+} USB_Device_ControlTransfer;
+
+bool USB_Device_SendControlData(const void* const Buffer,
+                                const uint16_t Length,
+                                const USB_Device_ControlCallback_t Callback,
+                                void* const Context)
+{
+	if (USB_Device_ControlTransfer.Stage != CONTROL_STAGE_Idle)
+	  return false;
+
+	const void* DataStream     = Buffer;
+	uint16_t    TransferLength = MIN(Length, USB_ControlRequest.wLength);
+
+	/* Take a copy of short responses, so that they may be built in a temporary variable by the caller */
+	if (TransferLength <= USB_DEVICE_CONTROL_BUFFER_SIZE)
+	{
+		memcpy(USB_Device_ControlTransfer.Data, Buffer, TransferLength);
+		DataStream = USB_Device_ControlTransfer.Data;
+	}
+
+	#if defined(ARCH_HAS_MULTI_ADDRESS_SPACE)
+	USB_Device_ControlTransfer.MemorySpace = MEMSPACE_RAM;
+	#endif
+
+	return USB_Device_StartControlTransfer(DataStream, TransferLength, CONTROL_STAGE_DataIN, Callback, Context);
+}
+
+#if defined(ARCH_HAS_FLASH_ADDRESS_SPACE)
+bool USB_Device_SendControlData_P(const void* const Buffer,
+                                  const uint16_t Length,
+                                  const USB_Device_ControlCallback_t Callback,
+                                  void* const Context)
+{
+	if (USB_Device_ControlTransfer.Stage != CONTROL_STAGE_Idle)
+	  return false;
+
+	USB_Device_ControlTransfer.MemorySpace = MEMSPACE_FLASH;
+
+	return USB_Device_StartControlTransfer(Buffer, Length, CONTROL_STAGE_DataIN, Callback, Context);
+}
+#endif
+
+#if defined(ARCH_HAS_EEPROM_ADDRESS_SPACE)
+bool USB_Device_SendControlData_E(const void* const Buffer,
+                                  const uint16_t Length,
+                                  const USB_Device_ControlCallback_t Callback,
+                                  void* const Context)
+{
+	if (USB_Device_ControlTransfer.Stage != CONTROL_STAGE_Idle)
+	  return false;
+
+	USB_Device_ControlTransfer.MemorySpace = MEMSPACE_EEPROM;
+
+	return USB_Device_StartControlTransfer(Buffer, Length, CONTROL_STAGE_DataIN, Callback, Context);
+}
+#endif
+
+bool USB_Device_ReceiveControlData(void* const Buffer,
+                                   const uint16_t Length,
+                                   const USB_Device_ControlCallback_t Callback,
+                                   void* const Context)
+{
+	if (USB_Device_ControlTransfer.Stage != CONTROL_STAGE_Idle)
+	  return false;
+
+	void* DataStream = Buffer;
+
+	if (DataStream == NULL)
+	{
+		if (Length > USB_DEVICE_CONTROL_BUFFER_SIZE)
+		  return false;
+
+		DataStream = USB_Device_ControlTransfer.Data;
+	}
+
+	#if defined(ARCH_HAS_MULTI_ADDRESS_SPACE)
+	USB_Device_ControlTransfer.MemorySpace = MEMSPACE_RAM;
+	#endif
+
+	return USB_Device_StartControlTransfer(DataStream, Length, CONTROL_STAGE_DataOUT, Callback, Context);
+}
+
+bool USB_Device_AcknowledgeControlRequest(const USB_Device_ControlCallback_t Callback,
+                                          void* const Context)
+{
+	if (USB_Device_ControlTransfer.Stage != CONTROL_STAGE_Idle)
+	  return false;
+
+	return USB_Device_StartControlTransfer(NULL, 0, CONTROL_STAGE_StatusIN, Callback, Context);
+}
+
+uint8_t* USB_Device_GetControlData(void)
+{
+	return USB_Device_ControlTransfer.Data;
+}
+
+bool USB_Device_IsControlTransferActive(void)
+{
+	return (USB_Device_ControlTransfer.Stage != CONTROL_STAGE_Idle);
+}
+
+void USB_Device_ProcessControlTransfer(void)
+{
+	if (USB_Device_ControlTransfer.Stage == CONTROL_STAGE_Idle)
+	  return;
+
+	uint8_t USB_DeviceState_LCL = USB_DeviceState;
+
+	if (USB_DeviceState_LCL == DEVICE_STATE_Unattached)
+	{
+		USB_Device_CompleteControlTransfer(ENDPOINT_RWCSTREAM_DeviceDisconnected);
+		return;
+	}
+	else if (USB_DeviceState_LCL == DEVICE_STATE_Suspended)
+	{
+		USB_Device_CompleteControlTransfer(ENDPOINT_RWCSTREAM_BusSuspended);
+		return;
+	}
+
+	/* A new SETUP packet from the host abandons any transfer still in progress */
+	if (Endpoint_IsSETUPReceived())
+	{
+		USB_Device_CompleteControlTransfer(ENDPOINT_RWCSTREAM_HostAborted);
+		return;
+	}
+
+	if (USB_Device_ControlTransfer.Stage == CONTROL_STAGE_DataIN)
+	  USB_Device_ProcessControlDataIN();
+	else if (USB_Device_ControlTransfer.Stage == CONTROL_STAGE_DataOUT)
+	  USB_Device_ProcessControlDataOUT();
+
+	if (USB_Device_ControlTransfer.Stage == CONTROL_STAGE_StatusOUT)
+	{
+		if (Endpoint_IsOUTReceived())
+		{
+			Endpoint_ClearOUT();
+			USB_Device_CompleteControlTransfer(ENDPOINT_RWCSTREAM_NoError);
+		}
+	}
+	else if (USB_Device_ControlTransfer.Stage == CONTROL_STAGE_StatusIN)
+	{
+		if (Endpoint_IsINReady())
+		{
+			Endpoint_ClearIN();
+			USB_Device_CompleteControlTransfer(ENDPOINT_RWCSTREAM_NoError);
+		}
+	}
+}
+
+#if defined(INTERRUPT_CONTROL_ENDPOINT) && (ARCH != ARCH_XMEGA)
+void USB_Device_UpdateControlTransferInterrupts(void)
+{
+	switch (USB_Device_ControlTransfer.Stage)
+	{
+		case CONTROL_STAGE_DataIN:
+			USB_INT_Enable(USB_INT_TXINI);
+			USB_INT_Enable(USB_INT_RXOUTI);
+			break;
+		case CONTROL_STAGE_StatusOUT:
+		case CONTROL_STAGE_DataOUT:
+			USB_INT_Enable(USB_INT_RXOUTI);
+			break;
+		case CONTROL_STAGE_StatusIN:
+			USB_INT_Enable(USB_INT_TXINI);
+			break;
+		default:
+			break;
+	}
+}
+#endif
+
+static bool USB_Device_StartControlTransfer(const void* const Buffer,
+                                            const uint16_t Length,
+                                            const uint8_t Stage,
+                                            const USB_Device_ControlCallback_t Callback,
+                                            void* const Context)
+{
+	uint16_t TransferLength = MIN(Length, USB_ControlRequest.wLength);
+
+	USB_Device_ControlTransfer.Buffer   = (uint8_t*)Buffer;
+	USB_Device_ControlTransfer.Length   = TransferLength;
+	USB_Device_ControlTransfer.SendZLP  = (TransferLength < USB_ControlRequest.wLength);
+	USB_Device_ControlTransfer.Callback = Callback;
+	USB_Device_ControlTransfer.Context  = Context;
+	USB_Device_ControlTransfer.Stage    = Stage;
+
+	USB_Device_ProcessControlTransfer();
+
+	return true;
+}
+
+static void USB_Device_CompleteControlTransfer(const uint8_t ErrorCode)
+{
+	USB_Device_ControlCallback_t Callback = USB_Device_ControlTransfer.Callback;
+
+	USB_Device_ControlTransfer.Stage = CONTROL_STAGE_Idle;
+
+	if (Callback != NULL)
+	{
+		Callback(USB_Device_ControlTransfer.Context, ErrorCode);
+		Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
+	}
+}
+
+static void USB_Device_ProcessControlDataIN(void)
+{
+	/* The host may move on to the status stage before all the data has been sent if it requires no more */
+	if (Endpoint_IsOUTReceived())
+	{
+		Endpoint_ClearOUT();
+		USB_Device_CompleteControlTransfer(ENDPOINT_RWCSTREAM_NoError);
+		return;
+	}
+
+	while (Endpoint_IsINReady())
+	{
+		uint16_t BytesInPacket = 0;
+
+		while (USB_Device_ControlTransfer.Length && (BytesInPacket < USB_Device_ControlEndpointSize))
+		{
+			#if defined(ARCH_HAS_FLASH_ADDRESS_SPACE)
+			if (USB_Device_ControlTransfer.MemorySpace == MEMSPACE_FLASH)
+			  Endpoint_Write_8(pgm_read_byte(USB_Device_ControlTransfer.Buffer));
+			else
+			#endif
+			#if defined(ARCH_HAS_EEPROM_ADDRESS_SPACE)
+			if (USB_Device_ControlTransfer.MemorySpace == MEMSPACE_EEPROM)
+			  Endpoint_Write_8(eeprom_read_byte(USB_Device_ControlTransfer.Buffer));
+			else
+			#endif
+			  Endpoint_Write_8(*USB_Device_ControlTransfer.Buffer);
+
+			USB_Device_ControlTransfer.Buffer++;
+			USB_Device_ControlTransfer.Length--;
+			BytesInPacket++;
+		}
+
+		Endpoint_ClearIN();
+
+		/* A full final packet must be followed by a zero length packet if the host asked for more than was sent */
+		if (!(USB_Device_ControlTransfer.Length) &&
+		    (!(USB_Device_ControlTransfer.SendZLP) || (BytesInPacket < USB_Device_ControlEndpointSize)))
+		{
+			USB_Device_ControlTransfer.Stage = CONTROL_STAGE_StatusOUT;
+			break;
+		}
+	}
+}
+
+static void USB_Device_ProcessControlDataOUT(void)
+{
+	while (USB_Device_ControlTransfer.Length && Endpoint_IsOUTReceived())
+	{
+		bool ShortPacket = (Endpoint_BytesInEndpoint() < USB_Device_ControlEndpointSize);
+
+		while (USB_Device_ControlTransfer.Length && Endpoint_BytesInEndpoint())
+		{
+			*(USB_Device_ControlTransfer.Buffer++) = Endpoint_Read_8();
+			USB_Device_ControlTransfer.Length--;
+		}
+
+		Endpoint_ClearOUT();
+
+		if (ShortPacket)
+		  USB_Device_ControlTransfer.Length = 0;
+	}
+
+	if (!(USB_Device_ControlTransfer.Length))
+	  USB_Device_ControlTransfer.Stage = CONTROL_STAGE_StatusIN;
+}
+
+#endif
+
@@ -0,0 +1,257 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Non-blocking device mode control transfer management.
+ *  \copydetails Group_DeviceControlTransfer
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB driver
+ *        dispatch header located in LUFA/Drivers/USB/USB.h.
+ */
+
+/** \ingroup Group_Device
+ *  \defgroup Group_DeviceControlTransfer Non-Blocking Control Transfers
+ *  \brief Non-blocking device mode control transfer management.
+ *
+ *  Functions and types for the non-blocking completion of control requests in device mode. Rather than spinning on
+ *  the control endpoint until the data and status stages of a request have completed, as the
+ *  \c Endpoint_*_Control_Stream_* functions and \ref Endpoint_ClearStatusStage() do, a control request handler may
+ *  instead start a transfer with one of the functions in this module and return immediately. The library then moves
+ *  the transfer through its data and status stages from \ref USB_USBTask() (or from the control endpoint interrupt
+ *  when the \c INTERRUPT_CONTROL_ENDPOINT compile time token is defined), leaving the application free to service
+ *  its other endpoints while the host completes the request.
+ *
+ *  A transfer is started from within \ref EVENT_USB_Device_ControlRequest() once the request has been accepted with
+ *  \ref Endpoint_ClearSETUP(), in place of the blocking stream and status stage functions:
+ *
+ *  \code
+ *      void EVENT_USB_Device_ControlRequest(void)
+ *      {
+ *          if ((USB_ControlRequest.bRequest == REQ_GetVendorStatus) &&
+ *              (USB_ControlRequest.bmRequestType == (REQDIR_DEVICETOHOST | REQTYPE_VENDOR | REQREC_DEVICE)))
+ *          {
+ *              Endpoint_ClearSETUP();
+ *              USB_Device_SendControlData(&VendorStatus, sizeof(VendorStatus), NULL, NULL);
+ *          }
+ *      }
+ *  \endcode
+ *
+ *  Only one control transfer can be in progress at any one time. The optional completion callback is run once the
+ *  transfer has finished, with an error code from the \ref Endpoint_ControlStream_RW_ErrorCodes_t enum indicating if
+ *  the transfer completed successfully or was abandoned. A transfer is abandoned if the host sends a new SETUP
+ *  request before it completes, or if the bus is suspended or the device disconnected.
+ *
+ *  @{
+ */
+
+#ifndef __DEVICECONTROLTRANSFER_H__
+#define __DEVICECONTROLTRANSFER_H__
+
+	/* Includes: */
+		#include "../../../Common/Common.h"
+		#include "USBMode.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_USB_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** Size in bytes of the internal control transfer buffer. Data passed to \ref USB_Device_SendControlData()
+			 *  that fits within this buffer is copied by the library, so that it may be built in a temporary variable
+			 *  by the caller; data received via \ref USB_Device_ReceiveControlData() with a \c NULL buffer is stored
+			 *  here, and may be retrieved with \ref USB_Device_GetControlData().
+			 */
+			#define USB_DEVICE_CONTROL_BUFFER_SIZE      8
+
+		/* Type Defines: */
+			/** Type define for a control transfer completion callback, run by the library once a control transfer
+			 *  started with one of the non-blocking control transfer functions has finished.
+			 *
+			 *  \param[in] Context    Context pointer given when the transfer was started.
+			 *  \param[in] ErrorCode  Result of the transfer, a value from the \ref Endpoint_ControlStream_RW_ErrorCodes_t enum.
+			 */
+			typedef void (*USB_Device_ControlCallback_t)(void* const Context,
+			                                             const uint8_t ErrorCode);
+
+		/* Function Prototypes: */
+			/** Starts the data stage of a device to host control transfer, sending the given data to the host. The
+			 *  length is automatically clipped to the number of bytes requested by the host, and the transfer is
+			 *  terminated with a short or zero length packet where required. Data no larger than
+			 *  \ref USB_DEVICE_CONTROL_BUFFER_SIZE bytes is copied internally, otherwise the buffer must remain valid
+			 *  until the completion callback is run.
+			 *
+			 *  \pre The SETUP packet must have been acknowledged with \ref Endpoint_ClearSETUP() before this function is
+			 *       called.
+			 *
+			 *  \param[in] Buffer    Pointer to the source data buffer to send.
+			 *  \param[in] Length    Length of the data to send to the host.
+			 *  \param[in] Callback  Completion callback to run once the status stage has completed, or \c NULL if not required.
+			 *  \param[in] Context   Context pointer passed to the completion callback.
+			 *
+			 *  \return Boolean \c true if the transfer was started, \c false if another control transfer is in progress.
+			 */
+			bool USB_Device_SendControlData(const void* const Buffer,
+			                                const uint16_t Length,
+			                                const USB_Device_ControlCallback_t Callback,
+			                                void* const Context);
+
+			#if defined(ARCH_HAS_FLASH_ADDRESS_SPACE) || defined(__DOXYGEN__)
+				/** FLASH buffer source version of \ref USB_Device_SendControlData(). The buffer must remain valid until
+				 *  the transfer has completed.
+				 *
+				 *  \note This function is not available on all architectures.
+				 *
+				 *  \param[in] Buffer    Pointer to the source data buffer to send, located in FLASH memory.
+				 *  \param[in] Length    Length of the data to send to the host.
+				 *  \param[in] Callback  Completion callback to run once the status stage has completed, or \c NULL if not required.
+				 *  \param[in] Context   Context pointer passed to the completion callback.
+				 *
+				 *  \return Boolean \c true if the transfer was started, \c false if another control transfer is in progress.
+				 */
+				bool USB_Device_SendControlData_P(const void* const Buffer,
+				                                  const uint16_t Length,
+				                                  const USB_Device_ControlCallback_t Callback,
+				                                  void* const Context);
+			#endif
+
+			#if defined(ARCH_HAS_EEPROM_ADDRESS_SPACE) || defined(__DOXYGEN__)
+				/** EEPROM buffer source version of \ref USB_Device_SendControlData(). The buffer must remain valid until
+				 *  the transfer has completed.
+				 *
+				 *  \note This function is not available on all architectures.
+				 *
+				 *  \param[in] Buffer    Pointer to the source data buffer to send, located in EEPROM memory.
+				 *  \param[in] Length    Length of the data to send to the host.
+				 *  \param[in] Callback  Completion callback to run once the status stage has completed, or \c NULL if not required.
+				 *  \param[in] Context   Context pointer passed to the completion callback.
+				 *
+				 *  \return Boolean \c true if the transfer was started, \c false if another control transfer is in progress.
+				 */
+				bool USB_Device_SendControlData_E(const void* const Buffer,
+				                                  const uint16_t Length,
+				                                  const USB_Device_ControlCallback_t Callback,
+				                                  void* const Context);
+			#endif
+
+			/** Starts the data stage of a host to device control transfer, receiving data from the host into the given
+			 *  buffer. The transfer ends once the given number of bytes has been received or the host sends a short
+			 *  packet, after which the status stage is completed automatically. If \c NULL is given as the buffer, up to
+			 *  \ref USB_DEVICE_CONTROL_BUFFER_SIZE bytes are received into the internal control transfer buffer instead,
+			 *  which can be read with \ref USB_Device_GetControlData() from within the completion callback.
+			 *
+			 *  \pre The SETUP packet must have been acknowledged with \ref Endpoint_ClearSETUP() before this function is
+			 *       called.
+			 *
+			 *  \param[out] Buffer    Pointer to the destination data buffer, or \c NULL to use the internal buffer.
+			 *  \param[in]  Length    Length of the data to receive from the host.
+			 *  \param[in]  Callback  Completion callback to run once the data has been received, or \c NULL if not required.
+			 *  \param[in]  Context   Context pointer passed to the completion callback.
+			 *
+			 *  \return Boolean \c true if the transfer was started, \c false if another control transfer is in progress
+			 *          or the requested length is too large for the internal buffer.
+			 */
+			bool USB_Device_ReceiveControlData(void* const Buffer,
+			                                   const uint16_t Length,
+			                                   const USB_Device_ControlCallback_t Callback,
+			                                   void* const Context);
+
+			/** Completes a control request that has no data stage, by acknowledging it in the status stage.
+			 *
+			 *  \pre The SETUP packet must have been acknowledged with \ref Endpoint_ClearSETUP() before this function is
+			 *       called.
+			 *
+			 *  \param[in] Callback  Completion callback to run once the status stage has been queued, or \c NULL if not required.
+			 *  \param[in] Context   Context pointer passed to the completion callback.
+			 *
+			 *  \return Boolean \c true if the transfer was started, \c false if another control transfer is in progress.
+			 */
+			bool USB_Device_AcknowledgeControlRequest(const USB_Device_ControlCallback_t Callback,
+			                                          void* const Context);
+
+			/** Retrieves a pointer to the internal control transfer buffer, holding the data received by the last call to
+			 *  \ref USB_Device_ReceiveControlData() that was made with a \c NULL buffer.
+			 *
+			 *  \return Pointer to the \ref USB_DEVICE_CONTROL_BUFFER_SIZE byte internal control transfer buffer.
+			 */
+			uint8_t* USB_Device_GetControlData(void) ATTR_WARN_UNUSED_RESULT;
+
+			/** Determines if a non-blocking control transfer is currently in progress.
+			 *
+			 *  \return Boolean \c true if a control transfer is in progress, \c false otherwise.
+			 */
+			bool USB_Device_IsControlTransferActive(void) ATTR_WARN_UNUSED_RESULT;
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Enums: */
+			enum USB_Device_ControlStages_t
+			{
+				CONTROL_STAGE_Idle      = 0,
+				CONTROL_STAGE_DataIN    = 1,
+				CONTROL_STAGE_StatusOUT = 2,
+				CONTROL_STAGE_DataOUT   = 3,
+				CONTROL_STAGE_StatusIN  = 4,
+			};
+
+		/* Function Prototypes: */
+			void USB_Device_ProcessControlTransfer(void);
+
+			#if defined(INTERRUPT_CONTROL_ENDPOINT) && (ARCH != ARCH_XMEGA)
+				void USB_Device_UpdateControlTransferInterrupts(void);
+			#endif
+
+			#if defined(__INCLUDE_FROM_DEVICECONTROLTRANSFER_C)
+				static bool USB_Device_StartControlTransfer(const void* const Buffer,
+				                                            const uint16_t Length,
+				                                            const uint8_t Stage,
+				                                            const USB_Device_ControlCallback_t Callback,
+				                                            void* const Context);
+				static void USB_Device_CompleteControlTransfer(const uint8_t ErrorCode);
+				static void USB_Device_ProcessControlDataIN(void);
+				static void USB_Device_ProcessControlDataOUT(void);
+			#endif
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
@@ -61,6 +61,9 @@ void USB_Device_ProcessControlRequest(void)
 	  *(RequestHeader++) = Endpoint_Read_8();
 	#endif
 
+	USB_TRACE_EVENT(TRACE_EVENT_DeviceControlRequest, USB_ControlRequest.bmRequestType,
+	                USB_ControlRequest.bRequest, USB_ControlRequest.wValue);
+
 	EVENT_USB_Device_ControlRequest();
 
 	if (Endpoint_IsSETUPReceived())
@@ -196,7 +199,7 @@ static void USB_Device_SetConfiguration(void)
 
 	USB_Device_ConfigurationNumber = (uint8_t)USB_ControlRequest.wValue;
 
-	Endpoint_ClearStatusStage();
+	USB_Device_AcknowledgeControlRequest(NULL, NULL);
 
 	if (USB_Device_ConfigurationNumber)
 	  USB_DeviceState = DEVICE_STATE_Configured;
@@ -210,10 +213,7 @@ static void USB_Device_GetConfiguration(void)
 {
 	Endpoint_ClearSETUP();
 
-	Endpoint_Write_8(USB_Device_ConfigurationNumber);
-	Endpoint_ClearIN();
-
-	Endpoint_ClearStatusStage();
+	USB_Device_SendControlData(&USB_Device_ConfigurationNumber, sizeof(uint8_t), NULL, NULL);
 }
 
 #if !defined(NO_INTERNAL_SERIAL) && (USE_INTERNAL_SERIAL != NO_DESCRIPTOR)
@@ -269,21 +269,19 @@ static void USB_Device_GetDescriptor(void)
 	Endpoint_ClearSETUP();
 
 	#if defined(USE_RAM_DESCRIPTORS) || !defined(ARCH_HAS_MULTI_ADDRESS_SPACE)
-	Endpoint_Write_Control_Stream_LE(DescriptorPointer, DescriptorSize);
+	USB_Device_SendControlData(DescriptorPointer, DescriptorSize, NULL, NULL);
 	#elif defined(USE_EEPROM_DESCRIPTORS)
-	Endpoint_Write_Control_EStream_LE(DescriptorPointer, DescriptorSize);
+	USB_Device_SendControlData_E(DescriptorPointer, DescriptorSize, NULL, NULL);
 	#elif defined(USE_FLASH_DESCRIPTORS)
-	Endpoint_Write_Control_PStream_LE(DescriptorPointer, DescriptorSize);
+	USB_Device_SendControlData_P(DescriptorPointer, DescriptorSize, NULL, NULL);
 	#else
 	if (DescriptorAddressSpace == MEMSPACE_FLASH)
-	  Endpoint_Write_Control_PStream_LE(DescriptorPointer, DescriptorSize);
+	  USB_Device_SendControlData_P(DescriptorPointer, DescriptorSize, NULL, NULL);
 	else if (DescriptorAddressSpace == MEMSPACE_EEPROM)
-	  Endpoint_Write_Control_EStream_LE(DescriptorPointer, DescriptorSize);
+	  USB_Device_SendControlData_E(DescriptorPointer, DescriptorSize, NULL, NULL);
 	else
-	  Endpoint_Write_Control_Stream_LE(DescriptorPointer, DescriptorSize);
+	  USB_Device_SendControlData(DescriptorPointer, DescriptorSize, NULL, NULL);
 	#endif
-
-	Endpoint_ClearOUT();
 }
 
 static void USB_Device_GetStatus(void)
@@ -317,12 +315,11 @@ static void USB_Device_GetStatus(void)
 			return;
 	}
 
-	Endpoint_ClearSETUP();
+	uint16_t StatusResponse = cpu_to_le16(CurrentStatus);
 
-	Endpoint_Write_16_LE(CurrentStatus);
-	Endpoint_ClearIN();
+	Endpoint_ClearSETUP();
 
-	Endpoint_ClearStatusStage();
+	USB_Device_SendControlData(&StatusResponse, sizeof(StatusResponse), NULL, NULL);
 }
 
 static void USB_Device_ClearSetFeature(void)
@@ -374,7 +371,7 @@ static void USB_Device_ClearSetFeature(void)
 
 	Endpoint_ClearSETUP();
 
-	Endpoint_ClearStatusStage();
+	USB_Device_AcknowledgeControlRequest(NULL, NULL);
 }
 
 #endif
@@ -117,6 +117,8 @@
 			#include "UC3/Endpoint_UC3.h"
 		#elif (ARCH == ARCH_XMEGA)
 			#include "XMEGA/Endpoint_XMEGA.h"
+		#elif (ARCH == ARCH_HOSTSIM)
+			#include "HOSTSIM/Endpoint_HOSTSIM.h"
 		#endif
 
 	/* Disable C linkage for C++ Compilers: */
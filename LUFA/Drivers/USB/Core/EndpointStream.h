@@ -111,6 +111,8 @@
 			#include "UC3/EndpointStream_UC3.h"
 		#elif (ARCH == ARCH_XMEGA)
 			#include "XMEGA/EndpointStream_XMEGA.h"
+		#elif (ARCH == ARCH_HOSTSIM)
+			#include "HOSTSIM/EndpointStream_HOSTSIM.h"
 		#endif
 
 	/* Disable C linkage for C++ Compilers: */
@@ -0,0 +1,170 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#include "../../../../Common/Common.h"
+#if (ARCH == ARCH_HOSTSIM)
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "../USBInterrupt.h"
+
+void USB_INT_DisableAllInterrupts(void)
+{
+	USB_HOSTSIM_Controller.INTEN      = 0;
+	USB_HOSTSIM_Controller.TXINTEN    = 0;
+	USB_HOSTSIM_Controller.RXOUTINTEN = 0;
+}
+
+void USB_INT_ClearAllInterrupts(void)
+{
+	USB_HOSTSIM_Controller.INTFLAGS = 0;
+}
+
+ISR(USB_GEN_vect)
+{
+	#if !defined(NO_SOF_EVENTS)
+	if (USB_INT_HasOccurred(USB_INT_SOFI) && USB_INT_IsEnabled(USB_INT_SOFI))
+	{
+		USB_INT_Clear(USB_INT_SOFI);
+
+		EVENT_USB_Device_StartOfFrame();
+	}
+	#endif
+
+	if (USB_INT_HasOccurred(USB_INT_VBUSTI) && USB_INT_IsEnabled(USB_INT_VBUSTI))
+	{
+		USB_INT_Clear(USB_INT_VBUSTI);
+
+		if (USB_HOSTSIM_Controller.VBUS)
+		{
+			USB_DeviceState = DEVICE_STATE_Powered;
+			USB_TRACE_EVENT(TRACE_EVENT_DeviceConnect, 0, 0, 0);
+			EVENT_USB_Device_Connect();
+		}
+		else
+		{
+			USB_DeviceState = DEVICE_STATE_Unattached;
+			USB_TRACE_EVENT(TRACE_EVENT_DeviceDisconnect, 0, 0, 0);
+			EVENT_USB_Device_Disconnect();
+		}
+	}
+
+	if (USB_INT_HasOccurred(USB_INT_SUSPI) && USB_INT_IsEnabled(USB_INT_SUSPI))
+	{
+		USB_INT_Clear(USB_INT_SUSPI);
+
+		USB_INT_Disable(USB_INT_SUSPI);
+		USB_INT_Enable(USB_INT_WAKEUPI);
+
+		USB_DeviceState = DEVICE_STATE_Suspended;
+		USB_TRACE_EVENT(TRACE_EVENT_DeviceSuspend, 0, 0, 0);
+		EVENT_USB_Device_Suspend();
+	}
+
+	if (USB_INT_HasOccurred(USB_INT_WAKEUPI) && USB_INT_IsEnabled(USB_INT_WAKEUPI))
+	{
+		USB_INT_Clear(USB_INT_WAKEUPI);
+
+		USB_INT_Disable(USB_INT_WAKEUPI);
+		USB_INT_Enable(USB_INT_SUSPI);
+
+		if (USB_Device_ConfigurationNumber)
+		  USB_DeviceState = DEVICE_STATE_Configured;
+		else
+		  USB_DeviceState = (USB_Device_IsAddressSet()) ? DEVICE_STATE_Addressed : DEVICE_STATE_Powered;
+
+		USB_TRACE_EVENT(TRACE_EVENT_DeviceWakeUp, 0, 0, 0);
+		EVENT_USB_Device_WakeUp();
+	}
+
+	if (USB_INT_HasOccurred(USB_INT_EORSTI) && USB_INT_IsEnabled(USB_INT_EORSTI))
+	{
+		USB_INT_Clear(USB_INT_EORSTI);
+
+		USB_DeviceState                = DEVICE_STATE_Default;
+		USB_Device_ConfigurationNumber = 0;
+
+		USB_Device_SetDeviceAddress(0);
+
+		USB_INT_Clear(USB_INT_SUSPI);
+		USB_INT_Enable(USB_INT_SUSPI);
+		USB_INT_Disable(USB_INT_WAKEUPI);
+
+		Endpoint_ClearEndpoints();
+		Endpoint_ConfigureEndpoint(ENDPOINT_CONTROLEP, EP_TYPE_CONTROL,
+		                           USB_Device_ControlEndpointSize, 1);
+
+		#if defined(INTERRUPT_CONTROL_ENDPOINT)
+		USB_INT_Enable(USB_INT_RXSTPI);
+		#endif
+
+		USB_TRACE_EVENT(TRACE_EVENT_DeviceReset, 0, 0, 0);
+		EVENT_USB_Device_Reset();
+	}
+}
+
+#if defined(INTERRUPT_CONTROL_ENDPOINT)
+ISR(USB_COM_vect)
+{
+	uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
+
+	#if !defined(CONTROL_ONLY_DEVICE)
+	Endpoint_DisableRequestInterrupts();
+	#endif
+
+	Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
+	USB_INT_Disable(USB_INT_RXSTPI);
+	USB_INT_Disable(USB_INT_TXINI);
+	USB_INT_Disable(USB_INT_RXOUTI);
+
+	GlobalInterruptEnable();
+
+	USB_Device_ProcessControlTransfer();
+
+	if (Endpoint_IsSETUPReceived())
+	  USB_Device_ProcessControlRequest();
+
+	#if !defined(CONTROL_ONLY_DEVICE)
+	Endpoint_ProcessRequests();
+	#endif
+
+	Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
+	USB_INT_Enable(USB_INT_RXSTPI);
+	USB_Device_UpdateControlTransferInterrupts();
+
+	#if !defined(CONTROL_ONLY_DEVICE)
+	Endpoint_UpdateRequestInterrupts();
+	#endif
+
+	Endpoint_SelectEndpoint(PrevSelectedEndpoint);
+}
+#endif
+
+#endif
+
@@ -0,0 +1,182 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief USB Controller Interrupt definitions for the simulated HOSTSIM architecture.
+ *
+ *  This file contains definitions required for the correct handling of low level USB service routine interrupts
+ *  from the simulated USB controller.
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB driver
+ *        dispatch header located in LUFA/Drivers/USB/USB.h.
+ */
+
+#ifndef __USBINTERRUPT_HOSTSIM_H__
+#define __USBINTERRUPT_HOSTSIM_H__
+
+	/* Includes: */
+		#include "../../../../Common/Common.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_USB_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
+		#endif
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Type Defines: */
+			/* Register block of the simulated USB controller, shared between the device stack and the virtual host.
+			 * The endpoint interrupts are enabled per endpoint, as a mask of endpoint numbers, in the same way as the
+			 * AVR8 UEIENX register applies to the currently selected endpoint.
+			 */
+			typedef struct
+			{
+				uint8_t  INTEN;
+				uint8_t  INTFLAGS;
+				uint16_t TXINTEN;
+				uint16_t RXOUTINTEN;
+				uint8_t  ADDR;
+				uint16_t FRAMENUM;
+				bool     ENABLED;
+				bool     ATTACHED;
+				bool     VBUS;
+				bool     LOWSPEED;
+				bool     RMWAKEUP;
+			} USB_HOSTSIM_Controller_t;
+
+		/* External Variables: */
+			extern volatile USB_HOSTSIM_Controller_t USB_HOSTSIM_Controller;
+			extern uint8_t                           USB_Endpoint_SelectedEndpoint;
+
+		/* Enums: */
+			enum USB_Interrupts_t
+			{
+				USB_INT_VBUSTI  = 0,
+				USB_INT_WAKEUPI = 1,
+				USB_INT_SUSPI   = 2,
+				USB_INT_EORSTI  = 3,
+				USB_INT_SOFI    = 4,
+				USB_INT_RXSTPI  = 5,
+				USB_INT_TXINI   = 6,
+				USB_INT_RXOUTI  = 7,
+			};
+
+		/* Inline Functions: */
+			static inline uint16_t USB_INT_GetEndpointMask(void) ATTR_ALWAYS_INLINE ATTR_WARN_UNUSED_RESULT;
+			static inline uint16_t USB_INT_GetEndpointMask(void)
+			{
+				return (1 << (USB_Endpoint_SelectedEndpoint & 0x0F));
+			}
+
+			static inline void USB_INT_Enable(const uint8_t Interrupt) ATTR_ALWAYS_INLINE;
+			static inline void USB_INT_Enable(const uint8_t Interrupt)
+			{
+				switch (Interrupt)
+				{
+					case USB_INT_TXINI:
+						USB_HOSTSIM_Controller.TXINTEN    |=  USB_INT_GetEndpointMask();
+						break;
+					case USB_INT_RXOUTI:
+						USB_HOSTSIM_Controller.RXOUTINTEN |=  USB_INT_GetEndpointMask();
+						break;
+					default:
+						USB_HOSTSIM_Controller.INTEN      |=  (1 << Interrupt);
+						break;
+				}
+			}
+
+			static inline void USB_INT_Disable(const uint8_t Interrupt) ATTR_ALWAYS_INLINE;
+			static inline void USB_INT_Disable(const uint8_t Interrupt)
+			{
+				switch (Interrupt)
+				{
+					case USB_INT_TXINI:
+						USB_HOSTSIM_Controller.TXINTEN    &= ~USB_INT_GetEndpointMask();
+						break;
+					case USB_INT_RXOUTI:
+						USB_HOSTSIM_Controller.RXOUTINTEN &= ~USB_INT_GetEndpointMask();
+						break;
+					default:
+						USB_HOSTSIM_Controller.INTEN      &= ~(1 << Interrupt);
+						break;
+				}
+			}
+
+			static inline void USB_INT_Clear(const uint8_t Interrupt) ATTR_ALWAYS_INLINE;
+			static inline void USB_INT_Clear(const uint8_t Interrupt)
+			{
+				USB_HOSTSIM_Controller.INTFLAGS &= ~(1 << Interrupt);
+			}
+
+			static inline bool USB_INT_IsEnabled(const uint8_t Interrupt) ATTR_ALWAYS_INLINE ATTR_WARN_UNUSED_RESULT;
+			static inline bool USB_INT_IsEnabled(const uint8_t Interrupt)
+			{
+				switch (Interrupt)
+				{
+					case USB_INT_TXINI:
+						return ((USB_HOSTSIM_Controller.TXINTEN & USB_INT_GetEndpointMask()) ? true : false);
+					case USB_INT_RXOUTI:
+						return ((USB_HOSTSIM_Controller.RXOUTINTEN & USB_INT_GetEndpointMask()) ? true : false);
+					default:
+						return ((USB_HOSTSIM_Controller.INTEN & (1 << Interrupt)) ? true : false);
+				}
+			}
+
+			static inline bool USB_INT_HasOccurred(const uint8_t Interrupt) ATTR_ALWAYS_INLINE ATTR_WARN_UNUSED_RESULT;
+			static inline bool USB_INT_HasOccurred(const uint8_t Interrupt)
+			{
+				return ((USB_HOSTSIM_Controller.INTFLAGS & (1 << Interrupt)) ? true : false);
+			}
+
+		/* Includes: */
+			#include "../USBMode.h"
+			#include "../Events.h"
+			#include "../USBController.h"
+
+		/* Function Prototypes: */
+			void USB_INT_ClearAllInterrupts(void);
+			void USB_INT_DisableAllInterrupts(void);
+
+			void USB_GEN_vect(void);
+			void USB_COM_vect(void);
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
@@ -0,0 +1,503 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#include "../../../../Common/Common.h"
+#if (ARCH == ARCH_HOSTSIM)
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "../USBMode.h"
+
+#if defined(USB_CAN_BE_DEVICE)
+
+#include "../USBController.h"
+#include "VirtualHost_HOSTSIM.h"
+
+enum VirtualHost_ControlStages_t
+{
+	VHOST_STAGE_Idle,
+	VHOST_STAGE_DataIN,
+	VHOST_STAGE_DataOUT,
+	VHOST_STAGE_StatusIN,
+	VHOST_STAGE_StatusOUT,
+	VHOST_STAGE_Complete,
+	VHOST_STAGE_Stalled,
+};
+
+static struct
+{
+	uint8_t  Stage;
+	uint8_t* Data;
+	uint16_t Remaining;
+	uint16_t Transferred;
+} VirtualHost_Control;
+
+static USB_VirtualHost_IdleHandler_t VirtualHost_IdleHandler;
+static bool                          VirtualHost_InYield;
+static bool                          VirtualHost_InDevice;
+
+#if defined(INTERRUPT_CONTROL_ENDPOINT)
+static bool VirtualHost_IsEndpointInterruptPending(void)
+{
+	if (USB_INT_IsEnabled(USB_INT_RXSTPI) && USB_Endpoint_FIFOs[ENDPOINT_CONTROLEP].OUT.IsSETUP)
+	  return true;
+
+	for (uint8_t EPNum = 0; EPNum < ENDPOINT_TOTAL_ENDPOINTS; EPNum++)
+	{
+		Endpoint_FIFO_t* FIFOOUT = &USB_Endpoint_FIFOs[EPNum].OUT;
+		Endpoint_FIFO_t* FIFOIN  = &USB_Endpoint_FIFOs[EPNum].IN;
+
+		if ((USB_HOSTSIM_Controller.RXOUTINTEN & (1 << EPNum)) && FIFOOUT->BanksInUse && !(FIFOOUT->IsSETUP))
+		  return true;
+
+		if ((USB_HOSTSIM_Controller.TXINTEN & (1 << EPNum)) && FIFOIN->IsConfigured &&
+		    (FIFOIN->BanksInUse < FIFOIN->TotalBanks))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif
+
+static void VirtualHost_ServiceInterrupts(void)
+{
+	if (!(GetGlobalInterruptMask()))
+	  return;
+
+	if (USB_HOSTSIM_Controller.INTFLAGS & USB_HOSTSIM_Controller.INTEN)
+	{
+		GlobalInterruptDisable();
+		USB_GEN_vect();
+		GlobalInterruptEnable();
+	}
+
+	#if defined(INTERRUPT_CONTROL_ENDPOINT)
+	if (VirtualHost_IsEndpointInterruptPending())
+	{
+		GlobalInterruptDisable();
+		USB_COM_vect();
+		GlobalInterruptEnable();
+	}
+	#endif
+}
+
+static void VirtualHost_RaiseInterrupt(const uint8_t Interrupt)
+{
+	USB_HOSTSIM_Controller.INTFLAGS |= (1 << Interrupt);
+
+	VirtualHost_ServiceInterrupts();
+}
+
+static bool VirtualHost_QueuePacket(Endpoint_FIFO_t* const FIFO,
+                                    const void* const Data,
+                                    const uint16_t Length)
+{
+	if (!(FIFO->IsConfigured) || FIFO->IsStalled || (FIFO->BanksInUse >= FIFO->TotalBanks) || (Length > FIFO->Size))
+	  return false;
+
+	Endpoint_Bank_t* Bank = &FIFO->Banks[(FIFO->DeviceBank + FIFO->BanksInUse) % FIFO->TotalBanks];
+
+	if (Length)
+	  memcpy(Bank->Data, Data, Length);
+
+	Bank->Length = Length;
+	FIFO->BanksInUse++;
+
+	return true;
+}
+
+static bool VirtualHost_DequeuePacket(Endpoint_FIFO_t* const FIFO,
+                                      void* const Buffer,
+                                      uint16_t* const Length)
+{
+	if (!(FIFO->IsConfigured) || !(FIFO->BanksInUse))
+	  return false;
+
+	Endpoint_Bank_t* Bank = &FIFO->Banks[(FIFO->DeviceBank + FIFO->TotalBanks - FIFO->BanksInUse) % FIFO->TotalBanks];
+
+	uint16_t BytesToCopy = MIN(*Length, Bank->Length);
+
+	if (Buffer != NULL)
+	  memcpy(Buffer, Bank->Data, BytesToCopy);
+
+	*Length = Bank->Length;
+	FIFO->BanksInUse--;
+
+	return true;
+}
+
+static void VirtualHost_ServiceControl(void)
+{
+	Endpoint_FIFO_t* ControlOUT = &USB_Endpoint_FIFOs[ENDPOINT_CONTROLEP].OUT;
+	Endpoint_FIFO_t* ControlIN  = &USB_Endpoint_FIFOs[ENDPOINT_CONTROLEP].IN;
+
+	switch (VirtualHost_Control.Stage)
+	{
+		case VHOST_STAGE_Idle:
+		case VHOST_STAGE_Complete:
+		case VHOST_STAGE_Stalled:
+			return;
+		default:
+			break;
+	}
+
+	if (ControlOUT->IsStalled || ControlIN->IsStalled)
+	{
+		VirtualHost_Control.Stage = VHOST_STAGE_Stalled;
+		return;
+	}
+
+	switch (VirtualHost_Control.Stage)
+	{
+		case VHOST_STAGE_DataOUT:
+			if (ControlOUT->IsSETUP)
+			  break;
+
+			if (VirtualHost_Control.Remaining)
+			{
+				uint16_t PacketSize = MIN(VirtualHost_Control.Remaining, ControlOUT->Size);
+
+				if (VirtualHost_QueuePacket(ControlOUT, VirtualHost_Control.Data, PacketSize))
+				{
+					VirtualHost_Control.Data      += PacketSize;
+					VirtualHost_Control.Remaining -= PacketSize;
+				}
+			}
+			else if (!(ControlOUT->BanksInUse))
+			{
+				VirtualHost_Control.Stage = VHOST_STAGE_StatusIN;
+			}
+
+			break;
+		case VHOST_STAGE_DataIN:
+		{
+			uint16_t PacketSize = VirtualHost_Control.Remaining;
+
+			if (!(VirtualHost_DequeuePacket(ControlIN, VirtualHost_Control.Data, &PacketSize)))
+			  break;
+
+			PacketSize = MIN(PacketSize, VirtualHost_Control.Remaining);
+
+			if (VirtualHost_Control.Data != NULL)
+			  VirtualHost_Control.Data += PacketSize;
+
+			VirtualHost_Control.Remaining   -= PacketSize;
+			VirtualHost_Control.Transferred += PacketSize;
+
+			if ((PacketSize < ControlIN->Size) || !(VirtualHost_Control.Remaining))
+			{
+				VirtualHost_QueuePacket(ControlOUT, NULL, 0);
+				VirtualHost_Control.Stage = VHOST_STAGE_StatusOUT;
+			}
+
+			break;
+		}
+		case VHOST_STAGE_StatusIN:
+		{
+			uint16_t PacketSize = 0;
+
+			if (VirtualHost_DequeuePacket(ControlIN, NULL, &PacketSize))
+			  VirtualHost_Control.Stage = VHOST_STAGE_Complete;
+
+			break;
+		}
+		case VHOST_STAGE_StatusOUT:
+			if (!(ControlOUT->BanksInUse))
+			  VirtualHost_Control.Stage = VHOST_STAGE_Complete;
+
+			break;
+	}
+}
+
+static void VirtualHost_RunDevice(void)
+{
+	if (VirtualHost_InDevice)
+	  return;
+
+	VirtualHost_InDevice = true;
+
+	VirtualHost_ServiceInterrupts();
+	USB_USBTask();
+
+	VirtualHost_InDevice = false;
+}
+
+void USB_VirtualHost_Yield(void)
+{
+	if (VirtualHost_InYield)
+	  return;
+
+	VirtualHost_InYield = true;
+
+	VirtualHost_ServiceControl();
+
+	if (VirtualHost_IdleHandler != NULL)
+	  VirtualHost_IdleHandler();
+
+	if (USB_HOSTSIM_Controller.RMWAKEUP)
+	{
+		USB_HOSTSIM_Controller.RMWAKEUP = false;
+
+		if (USB_DeviceState == DEVICE_STATE_Suspended)
+		  USB_VirtualHost_Resume();
+	}
+
+	USB_VirtualHost_StartOfFrame();
+
+	VirtualHost_InYield = false;
+}
+
+void USB_VirtualHost_Connect(void)
+{
+	USB_HOSTSIM_Controller.VBUS = true;
+
+	VirtualHost_RaiseInterrupt(USB_INT_VBUSTI);
+}
+
+void USB_VirtualHost_Disconnect(void)
+{
+	USB_HOSTSIM_Controller.VBUS = false;
+
+	VirtualHost_Control.Stage = VHOST_STAGE_Idle;
+	VirtualHost_RaiseInterrupt(USB_INT_VBUSTI);
+}
+
+void USB_VirtualHost_BusReset(void)
+{
+	if (!(USB_HOSTSIM_Controller.VBUS) || !(USB_HOSTSIM_Controller.ATTACHED))
+	  return;
+
+	VirtualHost_Control.Stage = VHOST_STAGE_Idle;
+	VirtualHost_RaiseInterrupt(USB_INT_EORSTI);
+}
+
+void USB_VirtualHost_Suspend(void)
+{
+	VirtualHost_RaiseInterrupt(USB_INT_SUSPI);
+}
+
+void USB_VirtualHost_Resume(void)
+{
+	VirtualHost_RaiseInterrupt(USB_INT_WAKEUPI);
+}
+
+void USB_VirtualHost_StartOfFrame(void)
+{
+	if (!(USB_HOSTSIM_Controller.VBUS) || !(USB_HOSTSIM_Controller.ATTACHED))
+	  return;
+
+	USB_HOSTSIM_Controller.FRAMENUM = ((USB_HOSTSIM_Controller.FRAMENUM + 1) & 0x07FF);
+
+	VirtualHost_RaiseInterrupt(USB_INT_SOFI);
+}
+
+void USB_VirtualHost_SetIdleHandler(const USB_VirtualHost_IdleHandler_t Handler)
+{
+	VirtualHost_IdleHandler = Handler;
+}
+
+uint8_t USB_VirtualHost_ControlRequest(const USB_Request_Header_t* const Request,
+                                       void* const Data)
+{
+	Endpoint_FIFO_t* ControlOUT = &USB_Endpoint_FIFOs[ENDPOINT_CONTROLEP].OUT;
+	Endpoint_FIFO_t* ControlIN  = &USB_Endpoint_FIFOs[ENDPOINT_CONTROLEP].IN;
+
+	if (!(USB_HOSTSIM_Controller.VBUS) || !(USB_HOSTSIM_Controller.ATTACHED))
+	  return VHOST_CONTROL_DeviceDisconnected;
+
+	switch (VirtualHost_Control.Stage)
+	{
+		case VHOST_STAGE_Idle:
+		case VHOST_STAGE_Complete:
+		case VHOST_STAGE_Stalled:
+			break;
+		default:
+			return VHOST_CONTROL_Busy;
+	}
+
+	/* A SETUP packet is always accepted by the device, and clears any pending data and stall on the control endpoint */
+	Endpoint_ResetEndpoint(ENDPOINT_CONTROLEP);
+	Endpoint_ResetEndpoint(ENDPOINT_CONTROLEP | ENDPOINT_DIR_IN);
+	ControlOUT->IsStalled = false;
+	ControlIN->IsStalled  = false;
+
+	USB_Request_Header_t SetupPacket =
+		{
+			.bmRequestType = Request->bmRequestType,
+			.bRequest      = Request->bRequest,
+			.wValue        = cpu_to_le16(Request->wValue),
+			.wIndex        = cpu_to_le16(Request->wIndex),
+			.wLength       = cpu_to_le16(Request->wLength),
+		};
+
+	VirtualHost_QueuePacket(ControlOUT, &SetupPacket, sizeof(USB_Request_Header_t));
+	ControlOUT->IsSETUP = true;
+
+	VirtualHost_Control.Data        = (uint8_t*)Data;
+	VirtualHost_Control.Remaining   = Request->wLength;
+	VirtualHost_Control.Transferred = 0;
+
+	if (!(Request->wLength))
+	  VirtualHost_Control.Stage = VHOST_STAGE_StatusIN;
+	else if (Request->bmRequestType & REQDIR_DEVICETOHOST)
+	  VirtualHost_Control.Stage = VHOST_STAGE_DataIN;
+	else
+	  VirtualHost_Control.Stage = VHOST_STAGE_DataOUT;
+
+	uint16_t IdleFrames = 0;
+
+	for (;;)
+	{
+		uint8_t  PreviousStage       = VirtualHost_Control.Stage;
+		uint16_t PreviousRemaining   = VirtualHost_Control.Remaining;
+		uint8_t  PreviousOUTBanks    = ControlOUT->BanksInUse;
+		uint8_t  PreviousINBanks     = ControlIN->BanksInUse;
+
+		VirtualHost_ServiceControl();
+
+		if ((VirtualHost_Control.Stage == VHOST_STAGE_Complete) || (VirtualHost_Control.Stage == VHOST_STAGE_Stalled))
+		  break;
+
+		VirtualHost_RunDevice();
+		VirtualHost_ServiceControl();
+
+		if ((VirtualHost_Control.Stage == VHOST_STAGE_Complete) || (VirtualHost_Control.Stage == VHOST_STAGE_Stalled))
+		  break;
+
+		if (!(USB_HOSTSIM_Controller.VBUS) || (USB_DeviceState == DEVICE_STATE_Unattached))
+		{
+			VirtualHost_Control.Stage = VHOST_STAGE_Idle;
+			return VHOST_CONTROL_DeviceDisconnected;
+		}
+
+		if ((PreviousStage     == VirtualHost_Control.Stage)     &&
+		    (PreviousRemaining == VirtualHost_Control.Remaining) &&
+		    (PreviousOUTBanks  == ControlOUT->BanksInUse)        &&
+		    (PreviousINBanks   == ControlIN->BanksInUse))
+		{
+			if (VirtualHost_IdleHandler != NULL)
+			  VirtualHost_IdleHandler();
+
+			USB_VirtualHost_StartOfFrame();
+
+			if (++IdleFrames > VHOST_CONTROL_TIMEOUT_FRAMES)
+			{
+				VirtualHost_Control.Stage = VHOST_STAGE_Idle;
+				return VHOST_CONTROL_Timeout;
+			}
+		}
+		else
+		{
+			IdleFrames = 0;
+		}
+	}
+
+	return (VirtualHost_Control.Stage == VHOST_STAGE_Stalled) ? VHOST_CONTROL_Stalled : VHOST_CONTROL_NoError;
+}
+
+uint8_t USB_VirtualHost_Enumerate(const uint8_t ConfigNumber)
+{
+	uint8_t ErrorCode;
+
+	if (!(USB_HOSTSIM_Controller.VBUS))
+	  USB_VirtualHost_Connect();
+
+	USB_VirtualHost_BusReset();
+
+	USB_Descriptor_Device_t DeviceDescriptor;
+
+	USB_Request_Header_t Request =
+		{
+			.bmRequestType = (REQDIR_DEVICETOHOST | REQTYPE_STANDARD | REQREC_DEVICE),
+			.bRequest      = REQ_GetDescriptor,
+			.wValue        = (DTYPE_Device << 8),
+			.wIndex        = 0,
+			.wLength       = sizeof(USB_Descriptor_Device_t),
+		};
+
+	if ((ErrorCode = USB_VirtualHost_ControlRequest(&Request, &DeviceDescriptor)) != VHOST_CONTROL_NoError)
+	  return ErrorCode;
+
+	Request = (USB_Request_Header_t)
+		{
+			.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_STANDARD | REQREC_DEVICE),
+			.bRequest      = REQ_SetAddress,
+			.wValue        = VHOST_DEVICE_ADDRESS,
+			.wIndex        = 0,
+			.wLength       = 0,
+		};
+
+	if ((ErrorCode = USB_VirtualHost_ControlRequest(&Request, NULL)) != VHOST_CONTROL_NoError)
+	  return ErrorCode;
+
+	Request = (USB_Request_Header_t)
+		{
+			.bmRequestType = (REQDIR_HOSTTODEVICE | REQTYPE_STANDARD | REQREC_DEVICE),
+			.bRequest      = REQ_SetConfiguration,
+			.wValue        = ConfigNumber,
+			.wIndex        = 0,
+			.wLength       = 0,
+		};
+
+	return USB_VirtualHost_ControlRequest(&Request, NULL);
+}
+
+bool USB_VirtualHost_SendOUT(const uint8_t Address,
+                             const void* const Data,
+                             const uint16_t Length)
+{
+	if ((Address & ENDPOINT_EPNUM_MASK) >= ENDPOINT_TOTAL_ENDPOINTS)
+	  return false;
+
+	bool PacketQueued = VirtualHost_QueuePacket(&USB_Endpoint_FIFOs[Address & ENDPOINT_EPNUM_MASK].OUT, Data, Length);
+
+	/* Endpoint interrupts are level triggered, so any left pending while masked must be serviced even if the FIFO was full */
+	VirtualHost_ServiceInterrupts();
+	return PacketQueued;
+}
+
+bool USB_VirtualHost_ReceiveIN(const uint8_t Address,
+                               void* const Buffer,
+                               uint16_t* const Length)
+{
+	if ((Address & ENDPOINT_EPNUM_MASK) >= ENDPOINT_TOTAL_ENDPOINTS)
+	  return false;
+
+	bool PacketDequeued = VirtualHost_DequeuePacket(&USB_Endpoint_FIFOs[Address & ENDPOINT_EPNUM_MASK].IN, Buffer, Length);
+
+	VirtualHost_ServiceInterrupts();
+	return PacketDequeued;
+}
+
+#endif
+
+#endif
+
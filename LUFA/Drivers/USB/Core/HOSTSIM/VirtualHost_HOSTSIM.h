@@ -0,0 +1,206 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Virtual USB host for the simulated HOSTSIM architecture.
+ *  \copydetails Group_VirtualHost_HOSTSIM
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB driver
+ *        dispatch header located in LUFA/Drivers/USB/USB.h.
+ */
+
+/** \ingroup Group_USBManagement
+ *  \defgroup Group_VirtualHost_HOSTSIM Virtual USB Host (HOSTSIM)
+ *  \brief Virtual USB host for the simulated HOSTSIM architecture.
+ *
+ *  The virtual host drives the host side of the simulated USB bus when the library is compiled for the
+ *  \ref ARCH_HOSTSIM architecture. It can power and reset the bus, issue control requests to the device's
+ *  default control endpoint, enumerate the device, and exchange packets with the device's other endpoints.
+ *
+ *  Everything runs on a single thread of execution. The virtual host runs the device stack (via
+ *  \ref USB_USBTask() and the simulated USB interrupts) while it waits for a control transfer to complete,
+ *  and the device stack hands control back to the virtual host each time it has to wait for the bus, so
+ *  that blocking device code such as the endpoint stream functions makes progress. An optional idle handler
+ *  registered with \ref USB_VirtualHost_SetIdleHandler() is run at each of these points, and can be used by
+ *  a test harness to act as the sink or source of the device's non-control endpoint data.
+ *
+ *  One simulated USB frame elapses each time the device stack waits for the bus without any progress being
+ *  made, so that the device's stream timeouts and Start of Frame events behave as they would on hardware.
+ *
+ *  \note The virtual host does not model bus timing, data toggles or transmission errors; it is intended for
+ *        functional testing and for profiling the device stack, not for validating USB compliance.
+ *
+ *  @{
+ */
+
+#ifndef __VIRTUALHOST_HOSTSIM_H__
+#define __VIRTUALHOST_HOSTSIM_H__
+
+	/* Includes: */
+		#include "../../../../Common/Common.h"
+		#include "../StdRequestType.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_USB_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			#if !defined(VHOST_CONTROL_TIMEOUT_FRAMES) || defined(__DOXYGEN__)
+				/** Number of simulated USB frames the virtual host will wait for a control transfer to make
+				 *  progress before it is aborted with \ref VHOST_CONTROL_Timeout.
+				 *
+				 *  This value may be overridden in the user project makefile as the value of the
+				 *  \ref VHOST_CONTROL_TIMEOUT_FRAMES token, and passed to the compiler using the -D switch.
+				 */
+				#define VHOST_CONTROL_TIMEOUT_FRAMES   5000
+			#endif
+
+			/** Device address assigned by \ref USB_VirtualHost_Enumerate() to the simulated device. */
+			#define VHOST_DEVICE_ADDRESS               1
+
+		/* Type Defines: */
+			/** Type define for a virtual host idle handler, run each time the device stack or the virtual host
+			 *  waits on the simulated bus.
+			 */
+			typedef void (*USB_VirtualHost_IdleHandler_t)(void);
+
+		/* Enums: */
+			/** Enum for the possible error return codes of the virtual host control transfer functions. */
+			enum USB_VirtualHost_ControlErrorCodes_t
+			{
+				VHOST_CONTROL_NoError            = 0, /**< Control transfer completed successfully. */
+				VHOST_CONTROL_Stalled            = 1, /**< The device stalled the control transfer. */
+				VHOST_CONTROL_Timeout            = 2, /**< The device did not complete the control transfer within
+				                                       *   \ref VHOST_CONTROL_TIMEOUT_FRAMES simulated frames.
+				                                       */
+				VHOST_CONTROL_DeviceDisconnected = 3, /**< The device is not attached to a powered bus. */
+				VHOST_CONTROL_Busy               = 4, /**< A control transfer is already in progress. */
+			};
+
+		/* Function Prototypes: */
+			/** Powers the simulated bus, raising a VBUS transition on the device. The device must call
+			 *  \ref USB_Attach() (done automatically by \ref USB_Init()) before it will respond to the host.
+			 */
+			void USB_VirtualHost_Connect(void);
+
+			/** Removes power from the simulated bus, raising a VBUS transition on the device. */
+			void USB_VirtualHost_Disconnect(void);
+
+			/** Issues a USB bus reset to the attached device, returning it to the Default state. */
+			void USB_VirtualHost_BusReset(void);
+
+			/** Suspends the simulated bus, raising a suspend event on the device. */
+			void USB_VirtualHost_Suspend(void);
+
+			/** Resumes the simulated bus after a previous call to \ref USB_VirtualHost_Suspend(). */
+			void USB_VirtualHost_Resume(void);
+
+			/** Advances the simulated bus by one USB frame, updating the device's frame number and raising
+			 *  a Start of Frame event.
+			 */
+			void USB_VirtualHost_StartOfFrame(void);
+
+			/** Sets the idle handler run each time the device stack or the virtual host waits on the simulated
+			 *  bus. The handler should not itself issue control requests through the virtual host.
+			 *
+			 *  \param[in] Handler  Handler to run, or \c NULL to remove the current handler.
+			 */
+			void USB_VirtualHost_SetIdleHandler(const USB_VirtualHost_IdleHandler_t Handler);
+
+			/** Issues a control request to the device's default control endpoint, running the device stack
+			 *  until the request completes.
+			 *
+			 *  \param[in]     Request  Pointer to the request header to send.
+			 *  \param[in,out] Data     Pointer to the data stage buffer of at least \c wLength bytes, or \c NULL
+			 *                          if the request has no data stage (or the returned data is to be discarded).
+			 *
+			 *  \return A value from the \ref USB_VirtualHost_ControlErrorCodes_t enum.
+			 */
+			uint8_t USB_VirtualHost_ControlRequest(const USB_Request_Header_t* const Request,
+			                                       void* const Data) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Connects and resets the simulated bus, then enumerates the device at address \ref VHOST_DEVICE_ADDRESS
+			 *  and selects the given configuration.
+			 *
+			 *  \param[in] ConfigNumber  Configuration number to select once the device has been addressed.
+			 *
+			 *  \return A value from the \ref USB_VirtualHost_ControlErrorCodes_t enum.
+			 */
+			uint8_t USB_VirtualHost_Enumerate(const uint8_t ConfigNumber);
+
+			/** Sends a single packet from the virtual host to an OUT endpoint of the device.
+			 *
+			 *  \param[in] Address  Address of the device OUT endpoint to send to.
+			 *  \param[in] Data     Pointer to the packet data.
+			 *  \param[in] Length   Length of the packet, which must not exceed the endpoint's size.
+			 *
+			 *  \return Boolean \c true if the packet was accepted, \c false if the endpoint is not configured, is
+			 *          stalled or has no free banks (i.e. the device NAKed the packet).
+			 */
+			bool USB_VirtualHost_SendOUT(const uint8_t Address,
+			                             const void* const Data,
+			                             const uint16_t Length);
+
+			/** Receives a single packet sent by the device on one of its IN endpoints.
+			 *
+			 *  \param[in]     Address  Address of the device IN endpoint to receive from.
+			 *  \param[out]    Buffer   Buffer to store the received packet into, or \c NULL to discard it.
+			 *  \param[in,out] Length   Size of \c Buffer on entry, length of the received packet on exit. Packet data
+			 *                          which does not fit in the buffer is discarded.
+			 *
+			 *  \return Boolean \c true if a packet was received, \c false if the device has no packet waiting (i.e.
+			 *          the device NAKed the request).
+			 */
+			bool USB_VirtualHost_ReceiveIN(const uint8_t Address,
+			                               void* const Buffer,
+			                               uint16_t* const Length) ATTR_NON_NULL_PTR_ARG(3);
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Function Prototypes: */
+			void USB_VirtualHost_Yield(void);
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
@@ -86,8 +86,9 @@
 				                                               *   library's internals are being configured to begin the enumeration
 				                                               *   process.
 				                                               */
-				HOST_STATE_Powered_WaitForDeviceSettle  = 3,  /**< This state indicates that the stack is waiting for the initial
-				                                               *   settling period to elapse before beginning the enumeration process.
+				HOST_STATE_Powered_WaitForDeviceSettle  = 3,  /**< This state is no longer entered by the library; the initial settling
+				                                               *   period is now timed after the device connects, in the
+				                                               *   \ref HOST_STATE_WaitForDevice state.
 				                                               */
 				HOST_STATE_Powered_WaitForConnect       = 4,  /**< This state indicates that the stack is waiting for a connection event
 				                                               *   from the USB controller to indicate a valid USB device has been attached
@@ -121,6 +122,41 @@
 				                                               */
 			};
 
+		/* Type Defines: */
+			#if defined(HOST_MEASURE_ENUMERATION_TIME) || defined(__DOXYGEN__)
+				/** \brief Host Mode Enumeration Timing Structure.
+				 *
+				 *  Type define for the enumeration timings of the attached device, stored in \ref USB_Host_EnumerationTime.
+				 *  Each timing is the number of milliseconds of USB bus frames from the detection of the device's connection
+				 *  to the given point in the enumeration process, excluding the bus reset signalling itself.
+				 *
+				 *  \note This structure is only available when the \c HOST_MEASURE_ENUMERATION_TIME token is defined.
+				 */
+				typedef struct
+				{
+					uint16_t ResetMS; /**< Time at which the first bus reset of the device was issued, after the
+					                   *   settle and connection debounce intervals.
+					                   */
+					uint16_t AddressedMS; /**< Time at which the device was addressed and the
+					                       *   \ref EVENT_USB_Host_DeviceEnumerationComplete() event fired.
+					                       */
+					uint16_t ConfiguredMS; /**< Time at which the device was first seen in the configured state by
+					                        *   \ref USB_USBTask(), or zero if the device has not yet been configured.
+					                        */
+				} USB_Host_EnumerationTime_t;
+			#endif
+
+		/* Global Variables: */
+			#if defined(HOST_MEASURE_ENUMERATION_TIME) || defined(__DOXYGEN__)
+				/** Enumeration timings of the currently attached device, reset each time a new device connection is
+				 *  detected. This may be read by the application once the device is configured to report how long the
+				 *  attach process took.
+				 *
+				 *  \note This global is only available when the \c HOST_MEASURE_ENUMERATION_TIME token is defined.
+				 */
+				extern USB_Host_EnumerationTime_t USB_Host_EnumerationTime;
+			#endif
+
 	/* Architecture Includes: */
 		#if (ARCH == ARCH_AVR8)
 			#include "AVR8/Host_AVR8.h"
@@ -0,0 +1,338 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "USBMode.h"
+
+#if defined(USB_CAN_BE_HOST)
+
+#define  __INCLUDE_FROM_HOSTCONTROLTRANSFER_C
+#include "HostControlTransfer.h"
+#include "HostStandardReq.h"
+#include "USBController.h"
+#include "Host.h"
+#include "Pipe.h"
+
+static struct
+{
+	uint8_t                    Stage;
+	bool                       BusSuspended;
+	uint16_t                   Length;
+	uint8_t*                   Buffer;
+	uint16_t                   PreviousFrameNumber;
+	uint16_t                   StageTimeMS;
+	USB_Host_ControlCallback_t Callback;
+	void*                      Context;
+	USB_Request_Header_t       Request;
+} USB_Host_ControlTransfer;
+
+bool USB_Host_StartControlRequest(const USB_Request_Header_t* const Request,
+                                  void* const Buffer,
+                                  const USB_Host_ControlCallback_t Callback,
+                                  void* const Context)
+{
+	if (USB_Host_ControlTransfer.Stage != HOST_CONTROL_STAGE_Idle)
+	  return false;
+
+	USB_Host_ControlTransfer.Request      = *Request;
+	USB_Host_ControlTransfer.Buffer       = (uint8_t*)Buffer;
+	USB_Host_ControlTransfer.Length       = Request->wLength;
+	USB_Host_ControlTransfer.Callback     = Callback;
+	USB_Host_ControlTransfer.Context      = Context;
+	USB_Host_ControlTransfer.BusSuspended = USB_Host_IsBusSuspended();
+
+	USB_TRACE_EVENT(TRACE_EVENT_HostControlRequest, Request->bmRequestType, Request->bRequest, Request->wValue);
+
+	USB_Host_ResumeBus();
+
+	USB_Host_ControlTransfer.PreviousFrameNumber = USB_Host_GetFrameNumber();
+	USB_Host_SetControlStage(HOST_CONTROL_STAGE_SetupWait);
+
+	USB_Host_ProcessControlTransfer();
+
+	return true;
+}
+
+bool USB_Host_IsControlTransferActive(void)
+{
+	return (USB_Host_ControlTransfer.Stage != HOST_CONTROL_STAGE_Idle);
+}
+
+void USB_Host_ProcessControlTransfer(void)
+{
+	if (USB_Host_ControlTransfer.Stage == HOST_CONTROL_STAGE_Idle)
+	  return;
+
+	uint8_t PrevPipe = Pipe_GetCurrentPipe();
+
+	Pipe_SelectPipe(PIPE_CONTROLPIPE);
+
+	/* Stage timeouts are measured in bus frames, so that they run without blocking */
+	uint16_t FrameNumber = USB_Host_GetFrameNumber();
+
+	USB_Host_ControlTransfer.StageTimeMS        += ((FrameNumber - USB_Host_ControlTransfer.PreviousFrameNumber) & USB_HOST_FRAMENUMBER_MASK);
+	USB_Host_ControlTransfer.PreviousFrameNumber = FrameNumber;
+
+	if ((USB_HostState == HOST_STATE_Unattached) || (USB_CurrentMode != USB_MODE_Host))
+	{
+		USB_Host_CompleteControlTransfer(HOST_SENDCONTROL_DeviceDisconnected);
+	}
+	else if (Pipe_IsError())
+	{
+		Pipe_ClearError();
+		USB_Host_CompleteControlTransfer(HOST_SENDCONTROL_PipeError);
+	}
+	else if (Pipe_IsStalled())
+	{
+		Pipe_ClearStall();
+		USB_Host_CompleteControlTransfer(HOST_SENDCONTROL_SetupStalled);
+	}
+	else
+	{
+		switch (USB_Host_ControlTransfer.Stage)
+		{
+			case HOST_CONTROL_STAGE_SetupWait:
+				/* The SETUP packet is sent at least one frame after the transfer is started */
+				if (USB_Host_ControlTransfer.StageTimeMS)
+				  USB_Host_SendControlSETUP();
+
+				break;
+			case HOST_CONTROL_STAGE_SetupSent:
+				if (Pipe_IsSETUPSent())
+				{
+					Pipe_Freeze();
+					USB_Host_SetControlStage(HOST_CONTROL_STAGE_DataWait);
+				}
+
+				break;
+			case HOST_CONTROL_STAGE_DataWait:
+				/* Give the device at least one frame to process the request before the data or status stage */
+				if (USB_Host_ControlTransfer.StageTimeMS)
+				  USB_Host_StartControlDataStage();
+
+				break;
+			case HOST_CONTROL_STAGE_DataIN:
+				USB_Host_ProcessControlDataIN();
+				break;
+			case HOST_CONTROL_STAGE_DataOUT:
+				USB_Host_ProcessControlDataOUT();
+				break;
+			case HOST_CONTROL_STAGE_StatusOUT:
+				if (Pipe_IsOUTReady())
+				{
+					Pipe_ClearOUT();
+					USB_Host_SetControlStage(HOST_CONTROL_STAGE_StatusOUTSent);
+				}
+
+				break;
+			case HOST_CONTROL_STAGE_StatusOUTSent:
+				if (Pipe_IsOUTReady())
+				  USB_Host_CompleteControlTransfer(HOST_SENDCONTROL_Successful);
+
+				break;
+			case HOST_CONTROL_STAGE_StatusIN:
+				if (Pipe_IsINReceived())
+				{
+					Pipe_ClearIN();
+					USB_Host_CompleteControlTransfer(HOST_SENDCONTROL_Successful);
+				}
+
+				break;
+		}
+
+		if ((USB_Host_ControlTransfer.Stage != HOST_CONTROL_STAGE_Idle) &&
+		    (USB_Host_ControlTransfer.StageTimeMS > USB_HOST_TIMEOUT_MS))
+		{
+			USB_Host_CompleteControlTransfer(HOST_SENDCONTROL_SoftwareTimeOut);
+		}
+	}
+
+	Pipe_SelectPipe(PrevPipe);
+}
+
+static void USB_Host_SetControlStage(const uint8_t Stage)
+{
+	USB_Host_ControlTransfer.Stage       = Stage;
+	USB_Host_ControlTransfer.StageTimeMS = 0;
+}
+
+static void USB_Host_CompleteControlTransfer(const uint8_t ErrorCode)
+{
+	USB_Host_ControlCallback_t Callback = USB_Host_ControlTransfer.Callback;
+
+	Pipe_Freeze();
+
+	if (USB_Host_ControlTransfer.BusSuspended)
+	  USB_Host_SuspendBus();
+
+	Pipe_ResetPipe(PIPE_CONTROLPIPE);
+
+	if (ErrorCode != HOST_SENDCONTROL_Successful)
+	{
+		USB_TRACE_EVENT(TRACE_EVENT_HostControlError, USB_Host_ControlTransfer.Request.bmRequestType,
+		                ErrorCode, USB_Host_ControlTransfer.Request.bRequest);
+	}
+
+	USB_Host_ControlTransfer.Stage = HOST_CONTROL_STAGE_Idle;
+
+	if (Callback != NULL)
+	{
+		Callback(USB_Host_ControlTransfer.Context, ErrorCode);
+		Pipe_SelectPipe(PIPE_CONTROLPIPE);
+	}
+}
+
+static void USB_Host_SendControlSETUP(void)
+{
+	Pipe_SetPipeToken(PIPE_TOKEN_SETUP);
+	Pipe_ClearError();
+
+	Pipe_Unfreeze();
+
+	#if defined(ARCH_BIG_ENDIAN)
+	Pipe_Write_8(USB_Host_ControlTransfer.Request.bmRequestType);
+	Pipe_Write_8(USB_Host_ControlTransfer.Request.bRequest);
+	Pipe_Write_16_LE(USB_Host_ControlTransfer.Request.wValue);
+	Pipe_Write_16_LE(USB_Host_ControlTransfer.Request.wIndex);
+	Pipe_Write_16_LE(USB_Host_ControlTransfer.Request.wLength);
+	#else
+	uint8_t* HeaderStream = (uint8_t*)&USB_Host_ControlTransfer.Request;
+
+	for (uint8_t HeaderByte = 0; HeaderByte < sizeof(USB_Request_Header_t); HeaderByte++)
+	  Pipe_Write_8(*(HeaderStream++));
+	#endif
+
+	Pipe_ClearSETUP();
+
+	USB_Host_SetControlStage(HOST_CONTROL_STAGE_SetupSent);
+}
+
+static void USB_Host_StartControlDataStage(void)
+{
+	if ((USB_Host_ControlTransfer.Request.bmRequestType & CONTROL_REQTYPE_DIRECTION) == REQDIR_DEVICETOHOST)
+	{
+		if ((USB_Host_ControlTransfer.Buffer == NULL) || !(USB_Host_ControlTransfer.Length))
+		{
+			USB_Host_StartControlStatusStage();
+			return;
+		}
+
+		Pipe_SetPipeToken(PIPE_TOKEN_IN);
+		Pipe_Unfreeze();
+
+		USB_Host_SetControlStage(HOST_CONTROL_STAGE_DataIN);
+	}
+	else
+	{
+		if (USB_Host_ControlTransfer.Buffer == NULL)
+		{
+			USB_Host_StartControlStatusStage();
+			return;
+		}
+
+		Pipe_SetPipeToken(PIPE_TOKEN_OUT);
+		Pipe_Unfreeze();
+
+		USB_Host_SetControlStage(HOST_CONTROL_STAGE_DataOUT);
+	}
+}
+
+static void USB_Host_StartControlStatusStage(void)
+{
+	/* The status stage runs in the opposite direction to the request's data stage */
+	if ((USB_Host_ControlTransfer.Request.bmRequestType & CONTROL_REQTYPE_DIRECTION) == REQDIR_DEVICETOHOST)
+	{
+		Pipe_SetPipeToken(PIPE_TOKEN_OUT);
+		Pipe_Unfreeze();
+
+		USB_Host_SetControlStage(HOST_CONTROL_STAGE_StatusOUT);
+	}
+	else
+	{
+		Pipe_SetPipeToken(PIPE_TOKEN_IN);
+		Pipe_Unfreeze();
+
+		USB_Host_SetControlStage(HOST_CONTROL_STAGE_StatusIN);
+	}
+}
+
+static void USB_Host_ProcessControlDataIN(void)
+{
+	if (!(Pipe_IsINReceived()))
+	  return;
+
+	bool ShortPacket = (Pipe_BytesInPipe() < USB_Host_ControlPipeSize);
+
+	while (Pipe_BytesInPipe() && USB_Host_ControlTransfer.Length)
+	{
+		*(USB_Host_ControlTransfer.Buffer++) = Pipe_Read_8();
+		USB_Host_ControlTransfer.Length--;
+	}
+
+	/* Freeze the pipe before releasing the bank, so that no further IN tokens are sent once the data is complete */
+	Pipe_Freeze();
+	Pipe_ClearIN();
+
+	if (!(USB_Host_ControlTransfer.Length) || ShortPacket)
+	{
+		USB_Host_StartControlStatusStage();
+	}
+	else
+	{
+		Pipe_Unfreeze();
+		USB_Host_SetControlStage(HOST_CONTROL_STAGE_DataIN);
+	}
+}
+
+static void USB_Host_ProcessControlDataOUT(void)
+{
+	if (!(Pipe_IsOUTReady()))
+	  return;
+
+	if (!(USB_Host_ControlTransfer.Length))
+	{
+		Pipe_Freeze();
+		USB_Host_StartControlStatusStage();
+		return;
+	}
+
+	while (USB_Host_ControlTransfer.Length && (Pipe_BytesInPipe() < USB_Host_ControlPipeSize))
+	{
+		Pipe_Write_8(*(USB_Host_ControlTransfer.Buffer++));
+		USB_Host_ControlTransfer.Length--;
+	}
+
+	Pipe_ClearOUT();
+
+	USB_Host_SetControlStage(HOST_CONTROL_STAGE_DataOUT);
+}
+
+#endif
+
@@ -0,0 +1,179 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Non-blocking host mode control transfer management.
+ *  \copydetails Group_HostControlTransfer
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB driver
+ *        dispatch header located in LUFA/Drivers/USB/USB.h.
+ */
+
+/** \ingroup Group_Host
+ *  \defgroup Group_HostControlTransfer Non-Blocking Control Transfers
+ *  \brief Non-blocking host mode control transfer management.
+ *
+ *  Functions and types for the non-blocking issuing of control requests in host mode. Rather than spinning on the
+ *  control pipe until the SETUP, data and status stages of a request have completed, as
+ *  \ref USB_Host_SendControlRequest() does, a request may instead be started with
+ *  \ref USB_Host_StartControlRequest(), which returns immediately. The library then moves the transfer through its
+ *  stages from \ref USB_USBTask(), leaving the application free to service its other pipes while the attached
+ *  device completes the request.
+ *
+ *  \code
+ *      static uint8_t PortStatus;
+ *
+ *      static void PortStatusReceived(void* const Context, const uint8_t ErrorCode)
+ *      {
+ *          if (ErrorCode == HOST_SENDCONTROL_Successful)
+ *            ProcessPortStatus(PortStatus);
+ *      }
+ *
+ *      void RequestPortStatus(void)
+ *      {
+ *          USB_Request_Header_t Request =
+ *              {
+ *                  .bmRequestType = (REQDIR_DEVICETOHOST | REQTYPE_CLASS | REQREC_INTERFACE),
+ *                  .bRequest      = PRNT_REQ_GetPortStatus,
+ *                  .wValue        = 0,
+ *                  .wIndex        = 0,
+ *                  .wLength       = sizeof(PortStatus),
+ *              };
+ *
+ *          USB_Host_StartControlRequest(&Request, &PortStatus, PortStatusReceived, NULL);
+ *      }
+ *  \endcode
+ *
+ *  Only one control transfer can be in progress at any one time; \ref USB_Host_SendControlRequest() and the
+ *  functions built on it first wait for any transfer started with \ref USB_Host_StartControlRequest() to complete.
+ *  The optional completion callback is run once the transfer has finished, with an error code from the
+ *  \ref USB_Host_SendControlErrorCodes_t enum indicating if the transfer completed successfully or failed. A
+ *  transfer fails if the device stalls the request, fails to respond to a stage within \ref USB_HOST_TIMEOUT_MS
+ *  milliseconds, or is disconnected.
+ *
+ *  @{
+ */
+
+#ifndef __HOSTCONTROLTRANSFER_H__
+#define __HOSTCONTROLTRANSFER_H__
+
+	/* Includes: */
+		#include "../../../Common/Common.h"
+		#include "USBMode.h"
+		#include "StdRequestType.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_USB_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Type Defines: */
+			/** Type define for a control transfer completion callback, run by the library once a control transfer
+			 *  started with \ref USB_Host_StartControlRequest() has finished.
+			 *
+			 *  \param[in] Context    Context pointer given when the transfer was started.
+			 *  \param[in] ErrorCode  Result of the transfer, a value from the \ref USB_Host_SendControlErrorCodes_t enum.
+			 */
+			typedef void (*USB_Host_ControlCallback_t)(void* const Context,
+			                                           const uint8_t ErrorCode);
+
+		/* Function Prototypes: */
+			/** Starts sending the given control request to the attached device on the control pipe, and transfers the
+			 *  data stored in the buffer to the device, or from the device to the buffer, as requested. The request is
+			 *  copied internally so that it may be built in a temporary variable by the caller, however the buffer must
+			 *  remain valid until the completion callback is run.
+			 *
+			 *  Data stages from the device which end with a short packet before the requested length has been received
+			 *  complete the transfer early.
+			 *
+			 *  \param[in]     Request   Pointer to the control request to send.
+			 *  \param[in,out] Buffer    Pointer to the start of the data buffer if the request has a data stage, or
+			 *                           \c NULL if the request transfers no data to or from the device.
+			 *  \param[in]     Callback  Completion callback to run once the transfer has finished, or \c NULL if not required.
+			 *  \param[in]     Context   Context pointer passed to the completion callback.
+			 *
+			 *  \return Boolean \c true if the transfer was started, \c false if another control transfer is in progress.
+			 */
+			bool USB_Host_StartControlRequest(const USB_Request_Header_t* const Request,
+			                                  void* const Buffer,
+			                                  const USB_Host_ControlCallback_t Callback,
+			                                  void* const Context) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Determines if a non-blocking control transfer is currently in progress.
+			 *
+			 *  \return Boolean \c true if a control transfer is in progress, \c false otherwise.
+			 */
+			bool USB_Host_IsControlTransferActive(void) ATTR_WARN_UNUSED_RESULT;
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Enums: */
+			enum USB_Host_ControlStages_t
+			{
+				HOST_CONTROL_STAGE_Idle          = 0,
+				HOST_CONTROL_STAGE_SetupWait     = 1,
+				HOST_CONTROL_STAGE_SetupSent     = 2,
+				HOST_CONTROL_STAGE_DataWait      = 3,
+				HOST_CONTROL_STAGE_DataIN        = 4,
+				HOST_CONTROL_STAGE_DataOUT       = 5,
+				HOST_CONTROL_STAGE_StatusOUT     = 6,
+				HOST_CONTROL_STAGE_StatusOUTSent = 7,
+				HOST_CONTROL_STAGE_StatusIN      = 8,
+			};
+
+		/* Function Prototypes: */
+			void USB_Host_ProcessControlTransfer(void);
+
+			#if defined(__INCLUDE_FROM_HOSTCONTROLTRANSFER_C)
+				static void USB_Host_SetControlStage(const uint8_t Stage);
+				static void USB_Host_CompleteControlTransfer(const uint8_t ErrorCode);
+				static void USB_Host_SendControlSETUP(void);
+				static void USB_Host_StartControlDataStage(void);
+				static void USB_Host_StartControlStatusStage(void);
+				static void USB_Host_ProcessControlDataIN(void);
+				static void USB_Host_ProcessControlDataOUT(void);
+			#endif
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
@@ -35,162 +35,29 @@
 
 #define  __INCLUDE_FROM_HOSTSTDREQ_C
 #include "HostStandardReq.h"
+#include "HostControlTransfer.h"
 
 uint8_t USB_Host_ConfigurationNumber;
 
-static uint8_t USB_Host_SendControlRequest_PRV(void* const BufferPtr)
+uint8_t USB_Host_SendControlRequest(void* const BufferPtr)
 {
-	uint8_t* DataStream   = (uint8_t*)BufferPtr;
-	uint8_t  ReturnStatus = HOST_SENDCONTROL_Successful;
-	uint16_t DataLen      = USB_ControlRequest.wLength;
-
-	USB_Host_ResumeBus();
-
-	if ((ReturnStatus = USB_Host_WaitMS(1)) != HOST_WAITERROR_Successful)
-	  return ReturnStatus;
-
-	Pipe_SetPipeToken(PIPE_TOKEN_SETUP);
-	Pipe_ClearError();
-
-	Pipe_Unfreeze();
-
-	#if defined(ARCH_BIG_ENDIAN)
-	Pipe_Write_8(USB_ControlRequest.bmRequestType);
-	Pipe_Write_8(USB_ControlRequest.bRequest);
-	Pipe_Write_16_LE(USB_ControlRequest.wValue);
-	Pipe_Write_16_LE(USB_ControlRequest.wIndex);
-	Pipe_Write_16_LE(USB_ControlRequest.wLength);
-	#else
-	uint8_t* HeaderStream = (uint8_t*)&USB_ControlRequest;
-
-	for (uint8_t HeaderByte = 0; HeaderByte < sizeof(USB_Request_Header_t); HeaderByte++)
-	  Pipe_Write_8(*(HeaderStream++));
-	#endif
-
-	Pipe_ClearSETUP();
-
-	if ((ReturnStatus = USB_Host_WaitForIOS(USB_HOST_WAITFOR_SetupSent)) != HOST_SENDCONTROL_Successful)
-	  return ReturnStatus;
-
-	Pipe_Freeze();
-
-	if ((ReturnStatus = USB_Host_WaitMS(1)) != HOST_WAITERROR_Successful)
-	  return ReturnStatus;
-
-	if ((USB_ControlRequest.bmRequestType & CONTROL_REQTYPE_DIRECTION) == REQDIR_DEVICETOHOST)
-	{
-		Pipe_SetPipeToken(PIPE_TOKEN_IN);
-
-		if (DataStream != NULL)
-		{
-			while (DataLen)
-			{
-				Pipe_Unfreeze();
-
-				if ((ReturnStatus = USB_Host_WaitForIOS(USB_HOST_WAITFOR_InReceived)) != HOST_SENDCONTROL_Successful)
-				  return ReturnStatus;
-
-				if (!(Pipe_BytesInPipe()))
-				  DataLen = 0;
-
-				while (Pipe_BytesInPipe() && DataLen)
-				{
-					*(DataStream++) = Pipe_Read_8();
-					DataLen--;
-				}
-
-				Pipe_Freeze();
-				Pipe_ClearIN();
-			}
-		}
-
-		Pipe_SetPipeToken(PIPE_TOKEN_OUT);
-		Pipe_Unfreeze();
-
-		if ((ReturnStatus = USB_Host_WaitForIOS(USB_HOST_WAITFOR_OutReady)) != HOST_SENDCONTROL_Successful)
-		  return ReturnStatus;
-
-		Pipe_ClearOUT();
-
-		if ((ReturnStatus = USB_Host_WaitForIOS(USB_HOST_WAITFOR_OutReady)) != HOST_SENDCONTROL_Successful)
-		  return ReturnStatus;
-	}
-	else
-	{
-		if (DataStream != NULL)
-		{
-			Pipe_SetPipeToken(PIPE_TOKEN_OUT);
-			Pipe_Unfreeze();
-
-			while (DataLen)
-			{
-				if ((ReturnStatus = USB_Host_WaitForIOS(USB_HOST_WAITFOR_OutReady)) != HOST_SENDCONTROL_Successful)
-				  return ReturnStatus;
-
-				while (DataLen && (Pipe_BytesInPipe() < USB_Host_ControlPipeSize))
-				{
-					Pipe_Write_8(*(DataStream++));
-					DataLen--;
-				}
-
-				Pipe_ClearOUT();
-			}
+	uint8_t ReturnStatus = HOST_SENDCONTROL_Successful;
 
-			if ((ReturnStatus = USB_Host_WaitForIOS(USB_HOST_WAITFOR_OutReady)) != HOST_SENDCONTROL_Successful)
-			  return ReturnStatus;
+	/* Finish any non-blocking transfer already in progress, as the control pipe can only run one request at a time - a
+	 * completion callback may start another transfer, so keep retrying until this request has been started */
+	while (!(USB_Host_StartControlRequest(&USB_ControlRequest, BufferPtr, USB_Host_ControlRequestComplete, &ReturnStatus)))
+	  USB_Host_ProcessControlTransfer();
 
-			Pipe_Freeze();
-		}
+	while (USB_Host_IsControlTransferActive())
+	  USB_Host_ProcessControlTransfer();
 
-		Pipe_SetPipeToken(PIPE_TOKEN_IN);
-		Pipe_Unfreeze();
-
-		if ((ReturnStatus = USB_Host_WaitForIOS(USB_HOST_WAITFOR_InReceived)) != HOST_SENDCONTROL_Successful)
-		  return ReturnStatus;
-
-		Pipe_ClearIN();
-	}
-	
 	return ReturnStatus;
 }
 
-static uint8_t USB_Host_WaitForIOS(const uint8_t WaitType)
+static void USB_Host_ControlRequestComplete(void* const Context,
+                                            const uint8_t ErrorCode)
 {
-	#if (USB_HOST_TIMEOUT_MS < 0xFF)
-	uint8_t  TimeoutCounter = USB_HOST_TIMEOUT_MS;
-	#else
-	uint16_t TimeoutCounter = USB_HOST_TIMEOUT_MS;
-	#endif
-
-	while (!(((WaitType == USB_HOST_WAITFOR_SetupSent)  && Pipe_IsSETUPSent())  ||
-	         ((WaitType == USB_HOST_WAITFOR_InReceived) && Pipe_IsINReceived()) ||
-	         ((WaitType == USB_HOST_WAITFOR_OutReady)   && Pipe_IsOUTReady())))
-	{
-		uint8_t ErrorCode;
-
-		if ((ErrorCode = USB_Host_WaitMS(1)) != HOST_WAITERROR_Successful)
-		  return ErrorCode;
-
-		if (!(TimeoutCounter--))
-		  return HOST_SENDCONTROL_SoftwareTimeOut;
-	}
-
-	return HOST_SENDCONTROL_Successful;
-}
-
-uint8_t USB_Host_SendControlRequest(void* const BufferPtr)
-{
-	bool BusSuspended    = USB_Host_IsBusSuspended();
-	uint8_t ReturnStatus = USB_Host_SendControlRequest_PRV(BufferPtr);
-
-	Pipe_Freeze();
-
-	if (BusSuspended)
-	  USB_Host_SuspendBus();
-
-	Pipe_ResetPipe(PIPE_CONTROLPIPE);
-
-	return ReturnStatus;
+	*((uint8_t*)Context) = ErrorCode;
 }
 
 uint8_t USB_Host_SetDeviceConfiguration(const uint8_t ConfigNumber)
@@ -105,7 +105,8 @@
 		/* Function Prototypes: */
 			/** Sends the request stored in the \ref USB_ControlRequest global structure to the attached device,
 			 *  and transfers the data stored in the buffer to the device, or from the device to the buffer
-			 *  as requested. The transfer is made on the currently selected pipe.
+			 *  as requested. The transfer is made on the control pipe, and this function blocks until it has
+			 *  completed; see \ref Group_HostControlTransfer for a non-blocking alternative.
 			 *
 			 *  \ingroup Group_PipeControlReq
 			 *
@@ -268,18 +269,10 @@
 
 	/* Private Interface - For use in library only: */
 	#if !defined(__DOXYGEN__)
-		/* Enums: */
-			enum USB_WaitForTypes_t
-			{
-				USB_HOST_WAITFOR_SetupSent,
-				USB_HOST_WAITFOR_InReceived,
-				USB_HOST_WAITFOR_OutReady,
-			};
-
 		/* Function Prototypes: */
 			#if defined(__INCLUDE_FROM_HOSTSTDREQ_C)
-				static uint8_t USB_Host_SendControlRequest_PRV(void* const BufferPtr);
-				static uint8_t USB_Host_WaitForIOS(const uint8_t WaitType);
+				static void USB_Host_ControlRequestComplete(void* const Context,
+				                                            const uint8_t ErrorCode) ATTR_NON_NULL_PTR_ARG(1);
 			#endif
 	#endif
 
@@ -0,0 +1,516 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "USBMode.h"
+
+#if (defined(USB_CAN_BE_DEVICE) && !defined(CONTROL_ONLY_DEVICE)) || defined(USB_CAN_BE_HOST)
+
+#define  __INCLUDE_FROM_TRANSFERREQUEST_C
+#include "TransferRequest.h"
+#include "USBController.h"
+#include "USBInterrupt.h"
+
+#if defined(USB_CAN_BE_DEVICE)
+	#include "Endpoint.h"
+#endif
+
+#if defined(USB_CAN_BE_HOST)
+	#include "Pipe.h"
+#endif
+
+static bool USB_TransferRequest_Append(USB_TransferRequest_t** const Queue,
+                                       USB_TransferRequest_t* const Request)
+{
+	Request->BytesTransferred = 0;
+	Request->Next             = NULL;
+	Request->Status           = TRANSFER_STATUS_Pending;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	USB_TransferRequest_t** QueueTail = Queue;
+
+	while (*QueueTail != NULL)
+	  QueueTail = &(*QueueTail)->Next;
+
+	*QueueTail = Request;
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	return (Queue == QueueTail);
+}
+
+static bool USB_TransferRequest_Remove(USB_TransferRequest_t** const Queue,
+                                       USB_TransferRequest_t* const Request)
+{
+	bool RequestFound = false;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	for (USB_TransferRequest_t** QueueEntry = Queue; *QueueEntry != NULL; QueueEntry = &(*QueueEntry)->Next)
+	{
+		if (*QueueEntry == Request)
+		{
+			*QueueEntry  = Request->Next;
+			RequestFound = true;
+			break;
+		}
+	}
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	return RequestFound;
+}
+
+static USB_TransferRequest_t* USB_TransferRequest_Detach(USB_TransferRequest_t** const Queue)
+{
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	USB_TransferRequest_t* Request = *Queue;
+	*Queue = NULL;
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	return Request;
+}
+
+static void USB_TransferRequest_Complete(USB_TransferRequest_t* const Request,
+                                         const uint8_t Status)
+{
+	Request->Next   = NULL;
+	Request->Status = Status;
+
+	if (Request->Callback != NULL)
+	  Request->Callback(Request);
+}
+
+static void USB_TransferRequest_CompleteAll(USB_TransferRequest_t* Request,
+                                            const uint8_t Status)
+{
+	while (Request != NULL)
+	{
+		USB_TransferRequest_t* NextRequest = Request->Next;
+
+		USB_TransferRequest_Complete(Request, Status);
+		Request = NextRequest;
+	}
+}
+
+#if defined(USB_CAN_BE_DEVICE) && !defined(CONTROL_ONLY_DEVICE)
+static USB_TransferRequest_t* Endpoint_RequestQueues[ENDPOINT_TOTAL_ENDPOINTS];
+static uint8_t                Endpoint_RequestPacketState[ENDPOINT_TOTAL_ENDPOINTS];
+
+#if defined(INTERRUPT_CONTROL_ENDPOINT) && (ARCH != ARCH_XMEGA)
+static volatile bool Endpoint_RequestInterruptActive;
+#endif
+
+bool Endpoint_SubmitRequest(const uint8_t Address,
+                            USB_TransferRequest_t* const Request)
+{
+	uint8_t EPNum = (Address & ENDPOINT_EPNUM_MASK);
+
+	if ((EPNum == ENDPOINT_CONTROLEP) || (EPNum >= ENDPOINT_TOTAL_ENDPOINTS))
+	  return false;
+
+	if (Request->Status == TRANSFER_STATUS_Pending)
+	  return false;
+
+	Request->Address = Address;
+
+	/* A newly started queue needs its endpoint interrupt enabled, unless it is being submitted from within the
+	 * endpoint interrupt itself, which will re-enable it on exit */
+	#if defined(INTERRUPT_CONTROL_ENDPOINT) && (ARCH != ARCH_XMEGA)
+	if (USB_TransferRequest_Append(&Endpoint_RequestQueues[EPNum], Request) && !(Endpoint_RequestInterruptActive))
+	  Endpoint_UpdateRequestInterrupt(EPNum);
+	#else
+	USB_TransferRequest_Append(&Endpoint_RequestQueues[EPNum], Request);
+	#endif
+
+	return true;
+}
+
+bool Endpoint_CancelRequest(USB_TransferRequest_t* const Request)
+{
+	uint8_t EPNum = (Request->Address & ENDPOINT_EPNUM_MASK);
+
+	if ((Request->Status != TRANSFER_STATUS_Pending) || (EPNum >= ENDPOINT_TOTAL_ENDPOINTS))
+	  return false;
+
+	if (!(USB_TransferRequest_Remove(&Endpoint_RequestQueues[EPNum], Request)))
+	  return false;
+
+	#if defined(INTERRUPT_CONTROL_ENDPOINT) && (ARCH != ARCH_XMEGA)
+	if (!(Endpoint_RequestInterruptActive))
+	  Endpoint_UpdateRequestInterrupt(EPNum);
+	#endif
+
+	USB_TransferRequest_Complete(Request, TRANSFER_STATUS_Cancelled);
+	return true;
+}
+
+void Endpoint_AbortRequests(const uint8_t Address)
+{
+	uint8_t EPNum = (Address & ENDPOINT_EPNUM_MASK);
+
+	if (EPNum >= ENDPOINT_TOTAL_ENDPOINTS)
+	  return;
+
+	USB_TransferRequest_t* Request = USB_TransferRequest_Detach(&Endpoint_RequestQueues[EPNum]);
+
+	#if defined(INTERRUPT_CONTROL_ENDPOINT) && (ARCH != ARCH_XMEGA)
+	if (!(Endpoint_RequestInterruptActive))
+	  Endpoint_UpdateRequestInterrupt(EPNum);
+	#endif
+
+	USB_TransferRequest_CompleteAll(Request, TRANSFER_STATUS_Cancelled);
+}
+
+void Endpoint_ProcessRequests(void)
+{
+	uint8_t PrevEndpoint = Endpoint_GetCurrentEndpoint();
+	bool    DeviceReset  = (USB_DeviceState < DEVICE_STATE_Configured);
+
+	for (uint8_t EPNum = 1; EPNum < ENDPOINT_TOTAL_ENDPOINTS; EPNum++)
+	{
+		/* Requests cannot outlive the configuration they were submitted under */
+		if (DeviceReset)
+		{
+			USB_TransferRequest_CompleteAll(USB_TransferRequest_Detach(&Endpoint_RequestQueues[EPNum]),
+			                                TRANSFER_STATUS_DeviceDisconnected);
+			Endpoint_RequestPacketState[EPNum] = TRANSFER_PACKET_None;
+			continue;
+		}
+
+		USB_TransferRequest_t* Request;
+
+		while ((Request = Endpoint_RequestQueues[EPNum]) != NULL)
+		{
+			Endpoint_SelectEndpoint(Request->Address);
+
+			bool RequestFinished;
+
+			if (Request->Address & ENDPOINT_DIR_IN)
+			  RequestFinished = Endpoint_ProcessINRequest(Request);
+			else
+			  RequestFinished = Endpoint_ProcessOUTRequest(Request);
+
+			if (!(RequestFinished))
+			  break;
+
+			if (USB_TransferRequest_Remove(&Endpoint_RequestQueues[EPNum], Request))
+			  USB_TransferRequest_Complete(Request, TRANSFER_STATUS_Complete);
+		}
+	}
+
+	Endpoint_SelectEndpoint(PrevEndpoint);
+}
+
+#if defined(INTERRUPT_CONTROL_ENDPOINT) && (ARCH != ARCH_XMEGA)
+void Endpoint_DisableRequestInterrupts(void)
+{
+	Endpoint_RequestInterruptActive = true;
+
+	for (uint8_t EPNum = 1; EPNum < ENDPOINT_TOTAL_ENDPOINTS; EPNum++)
+	{
+		Endpoint_SelectEndpoint(EPNum);
+		USB_INT_Disable(USB_INT_TXINI);
+		USB_INT_Disable(USB_INT_RXOUTI);
+	}
+}
+
+void Endpoint_UpdateRequestInterrupts(void)
+{
+	for (uint8_t EPNum = 1; EPNum < ENDPOINT_TOTAL_ENDPOINTS; EPNum++)
+	  Endpoint_UpdateRequestInterrupt(EPNum);
+
+	Endpoint_RequestInterruptActive = false;
+}
+
+static void Endpoint_UpdateRequestInterrupt(const uint8_t EPNum)
+{
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	uint8_t                PrevEndpoint = Endpoint_GetCurrentEndpoint();
+	USB_TransferRequest_t* Request      = Endpoint_RequestQueues[EPNum];
+
+	Endpoint_SelectEndpoint(EPNum);
+	USB_INT_Disable(USB_INT_TXINI);
+	USB_INT_Disable(USB_INT_RXOUTI);
+
+	if (Request != NULL)
+	{
+		Endpoint_SelectEndpoint(Request->Address);
+
+		if (Request->Address & ENDPOINT_DIR_IN)
+		  USB_INT_Enable(USB_INT_TXINI);
+		else
+		  USB_INT_Enable(USB_INT_RXOUTI);
+	}
+
+	Endpoint_SelectEndpoint(PrevEndpoint);
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+}
+#endif
+
+static bool Endpoint_ProcessINRequest(USB_TransferRequest_t* const Request)
+{
+	while (Endpoint_IsINReady())
+	{
+		uint8_t* DataStream = ((uint8_t*)Request->Buffer + Request->BytesTransferred);
+
+		while ((Request->BytesTransferred < Request->Length) && Endpoint_IsReadWriteAllowed())
+		{
+			Endpoint_Write_8(*(DataStream++));
+			Request->BytesTransferred++;
+		}
+
+		bool PacketFull = !(Endpoint_IsReadWriteAllowed());
+
+		Endpoint_ClearIN();
+
+		/* A full final packet is followed by a zero length packet on the next pass if one was requested */
+		if ((Request->BytesTransferred == Request->Length) &&
+		    (!(PacketFull) || !(Request->Flags & TRANSFER_FLAG_SendZLP)))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool Endpoint_ProcessOUTRequest(USB_TransferRequest_t* const Request)
+{
+	uint8_t* PacketState = &Endpoint_RequestPacketState[Request->Address & ENDPOINT_EPNUM_MASK];
+
+	while (Endpoint_IsOUTReceived())
+	{
+		uint8_t* DataStream = ((uint8_t*)Request->Buffer + Request->BytesTransferred);
+
+		/* The packet size is recorded once when the bank arrives, as a bank partly read by an earlier request
+		 * would otherwise appear to hold a short packet */
+		if (*PacketState == TRANSFER_PACKET_None)
+		{
+			*PacketState = (Endpoint_BytesInEndpoint() < Endpoint_GetEndpointSize()) ? TRANSFER_PACKET_Short
+			                                                                           : TRANSFER_PACKET_Full;
+		}
+
+		while ((Request->BytesTransferred < Request->Length) && Endpoint_IsReadWriteAllowed())
+		{
+			*(DataStream++) = Endpoint_Read_8();
+			Request->BytesTransferred++;
+		}
+
+		/* Any data left in the packet once the buffer is full is kept for the next request */
+		if (Endpoint_IsReadWriteAllowed())
+		  return true;
+
+		Endpoint_ClearOUT();
+
+		bool ShortPacket = (*PacketState == TRANSFER_PACKET_Short);
+		*PacketState = TRANSFER_PACKET_None;
+
+		if (ShortPacket || (Request->BytesTransferred == Request->Length))
+		  return true;
+	}
+
+	return false;
+}
+#endif
+
+#if defined(USB_CAN_BE_HOST)
+static USB_TransferRequest_t* Pipe_RequestQueues[PIPE_TOTAL_PIPES];
+static uint8_t                Pipe_RequestPacketState[PIPE_TOTAL_PIPES];
+
+bool Pipe_SubmitRequest(const uint8_t Address,
+                        USB_TransferRequest_t* const Request)
+{
+	uint8_t PipeNum = (Address & PIPE_PIPENUM_MASK);
+
+	if ((PipeNum == PIPE_CONTROLPIPE) || (PipeNum >= PIPE_TOTAL_PIPES))
+	  return false;
+
+	if (Request->Status == TRANSFER_STATUS_Pending)
+	  return false;
+
+	Request->Address = Address;
+
+	if (USB_TransferRequest_Append(&Pipe_RequestQueues[PipeNum], Request))
+	{
+		uint8_t PrevPipe = Pipe_GetCurrentPipe();
+
+		Pipe_SelectPipe(Address);
+		Pipe_Unfreeze();
+		Pipe_SelectPipe(PrevPipe);
+	}
+
+	return true;
+}
+
+bool Pipe_CancelRequest(USB_TransferRequest_t* const Request)
+{
+	uint8_t PipeNum = (Request->Address & PIPE_PIPENUM_MASK);
+
+	if ((Request->Status != TRANSFER_STATUS_Pending) || (PipeNum >= PIPE_TOTAL_PIPES))
+	  return false;
+
+	if (!(USB_TransferRequest_Remove(&Pipe_RequestQueues[PipeNum], Request)))
+	  return false;
+
+	USB_TransferRequest_Complete(Request, TRANSFER_STATUS_Cancelled);
+	return true;
+}
+
+void Pipe_AbortRequests(const uint8_t Address)
+{
+	uint8_t PipeNum = (Address & PIPE_PIPENUM_MASK);
+
+	if (PipeNum >= PIPE_TOTAL_PIPES)
+	  return;
+
+	USB_TransferRequest_CompleteAll(USB_TransferRequest_Detach(&Pipe_RequestQueues[PipeNum]), TRANSFER_STATUS_Cancelled);
+}
+
+void Pipe_ProcessRequests(void)
+{
+	uint8_t PrevPipe = Pipe_GetCurrentPipe();
+
+	for (uint8_t PipeNum = 1; PipeNum < PIPE_TOTAL_PIPES; PipeNum++)
+	{
+		if (USB_HostState == HOST_STATE_Unattached)
+		{
+			USB_TransferRequest_CompleteAll(USB_TransferRequest_Detach(&Pipe_RequestQueues[PipeNum]),
+			                                TRANSFER_STATUS_DeviceDisconnected);
+			Pipe_RequestPacketState[PipeNum] = TRANSFER_PACKET_None;
+			continue;
+		}
+		else if (USB_HostState != HOST_STATE_Configured)
+		{
+			continue;
+		}
+
+		USB_TransferRequest_t* Request;
+
+		while ((Request = Pipe_RequestQueues[PipeNum]) != NULL)
+		{
+			Pipe_SelectPipe(Request->Address);
+
+			uint8_t RequestStatus = Pipe_ProcessRequest(Request);
+
+			if (RequestStatus == TRANSFER_STATUS_Pending)
+			  break;
+
+			if (USB_TransferRequest_Remove(&Pipe_RequestQueues[PipeNum], Request))
+			{
+				if (Pipe_RequestQueues[PipeNum] == NULL)
+				  Pipe_Freeze();
+
+				USB_TransferRequest_Complete(Request, RequestStatus);
+			}
+		}
+	}
+
+	Pipe_SelectPipe(PrevPipe);
+}
+
+static uint8_t Pipe_ProcessRequest(USB_TransferRequest_t* const Request)
+{
+	/* Stall and error conditions are left set, so that any requests queued behind this one also fail until the
+	 * application clears them */
+	if (Pipe_IsStalled())
+	  return TRANSFER_STATUS_Stalled;
+	else if (Pipe_IsError())
+	  return TRANSFER_STATUS_PipeError;
+
+	if (Pipe_GetPipeToken() == PIPE_TOKEN_IN)
+	{
+		uint8_t* PacketState = &Pipe_RequestPacketState[Request->Address & PIPE_PIPENUM_MASK];
+
+		while (Pipe_IsINReceived())
+		{
+			uint8_t* DataStream = ((uint8_t*)Request->Buffer + Request->BytesTransferred);
+
+			/* The packet size is recorded once when the bank arrives, as a bank partly read by an earlier request
+			 * would otherwise appear to hold a short packet */
+			if (*PacketState == TRANSFER_PACKET_None)
+			  *PacketState = (Pipe_BytesInPipe() < Pipe_GetPipeSize()) ? TRANSFER_PACKET_Short : TRANSFER_PACKET_Full;
+
+			while ((Request->BytesTransferred < Request->Length) && Pipe_IsReadWriteAllowed())
+			{
+				*(DataStream++) = Pipe_Read_8();
+				Request->BytesTransferred++;
+			}
+
+			if (Pipe_IsReadWriteAllowed())
+			  return TRANSFER_STATUS_Complete;
+
+			Pipe_ClearIN();
+
+			bool ShortPacket = (*PacketState == TRANSFER_PACKET_Short);
+			*PacketState = TRANSFER_PACKET_None;
+
+			if (ShortPacket || (Request->BytesTransferred == Request->Length))
+			  return TRANSFER_STATUS_Complete;
+		}
+	}
+	else
+	{
+		while (Pipe_IsOUTReady())
+		{
+			uint8_t* DataStream = ((uint8_t*)Request->Buffer + Request->BytesTransferred);
+
+			while ((Request->BytesTransferred < Request->Length) && Pipe_IsReadWriteAllowed())
+			{
+				Pipe_Write_8(*(DataStream++));
+				Request->BytesTransferred++;
+			}
+
+			bool PacketFull = !(Pipe_IsReadWriteAllowed());
+
+			Pipe_ClearOUT();
+
+			if ((Request->BytesTransferred == Request->Length) &&
+			    (!(PacketFull) || !(Request->Flags & TRANSFER_FLAG_SendZLP)))
+			{
+				return TRANSFER_STATUS_Complete;
+			}
+		}
+	}
+
+	return TRANSFER_STATUS_Pending;
+}
+#endif
+
+#endif
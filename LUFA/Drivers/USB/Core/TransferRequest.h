@@ -0,0 +1,279 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Asynchronous endpoint and pipe transfer requests.
+ *  \copydetails Group_TransferRequest
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB driver
+ *        dispatch header located in LUFA/Drivers/USB/USB.h.
+ */
+
+/** \ingroup Group_USB
+ *  \defgroup Group_TransferRequest Asynchronous Transfer Requests
+ *  \brief Asynchronous endpoint and pipe transfer requests.
+ *
+ *  Functions and types for the queuing of asynchronous data transfers on the data endpoints of a device or the data
+ *  pipes of a host. Rather than blocking until a transfer completes as the stream functions do, the application fills
+ *  out a \ref USB_TransferRequest_t structure with a buffer, length and optional completion callback, and submits it
+ *  to an endpoint or pipe; the library then moves the data in the background as the host or attached device becomes
+ *  ready, and runs the callback once the transfer has finished. Several requests may be queued on each endpoint or
+ *  pipe, and are processed in the order they were submitted.
+ *
+ *  Requests are processed from \ref USB_USBTask(). In device mode when the \c INTERRUPT_CONTROL_ENDPOINT compile time
+ *  token is defined, requests are instead processed from the endpoint interrupt on architectures that support it;
+ *  in this case the completion callbacks are run from interrupt context, in the same manner as the control request
+ *  events.
+ *
+ *  \code
+ *      static uint8_t              ReportBuffer[64];
+ *      static USB_TransferRequest_t ReportRequest;
+ *
+ *      static void ReportSent(USB_TransferRequest_t* const Request)
+ *      {
+ *          if (Request->Status == TRANSFER_STATUS_Complete)
+ *            PrepareNextReport(ReportBuffer);
+ *      }
+ *
+ *      void SendReport(void)
+ *      {
+ *          ReportRequest.Buffer   = ReportBuffer;
+ *          ReportRequest.Length   = sizeof(ReportBuffer);
+ *          ReportRequest.Flags    = TRANSFER_FLAG_SendZLP;
+ *          ReportRequest.Callback = ReportSent;
+ *
+ *          Endpoint_SubmitRequest(REPORT_IN_EPADDR, &ReportRequest);
+ *      }
+ *  \endcode
+ *
+ *  Each IN request is sent as a single transfer, terminated with a short packet (or a zero length packet when the
+ *  \ref TRANSFER_FLAG_SendZLP flag is set and the data is an exact multiple of the packet size). Each OUT request
+ *  completes when its buffer is full or a short packet is received; any data in a packet beyond the end of the
+ *  buffer is left in the endpoint or pipe for the next request.
+ *
+ *  \note The request structure and its buffer are owned by the library from submission until the completion
+ *        callback is run (or \ref USB_TransferRequest_t::Status is no longer \ref TRANSFER_STATUS_Pending), and must
+ *        not be modified or go out of scope during this time.
+ *
+ *  @{
+ */
+
+#ifndef __TRANSFERREQUEST_H__
+#define __TRANSFERREQUEST_H__
+
+	/* Includes: */
+		#include "../../../Common/Common.h"
+		#include "USBMode.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_USB_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			/** Transfer request flag mask, indicating that an IN transfer whose length is an exact multiple of the
+			 *  endpoint or pipe size should be terminated with a zero length packet.
+			 */
+			#define TRANSFER_FLAG_SendZLP               (1 << 0)
+
+		/* Enums: */
+			/** Enum for the possible status values of a \ref USB_TransferRequest_t request. */
+			enum USB_TransferRequest_Status_t
+			{
+				TRANSFER_STATUS_Idle               = 0, /**< Request has not been submitted. */
+				TRANSFER_STATUS_Pending            = 1, /**< Request is queued or in progress. */
+				TRANSFER_STATUS_Complete           = 2, /**< Request completed successfully. */
+				TRANSFER_STATUS_Cancelled          = 3, /**< Request was cancelled by the application before it completed. */
+				TRANSFER_STATUS_Stalled            = 4, /**< Attached device stalled the pipe during the transfer (host mode only). */
+				TRANSFER_STATUS_PipeError          = 5, /**< A hardware error occurred on the pipe during the transfer (host mode only). */
+				TRANSFER_STATUS_DeviceDisconnected = 6, /**< Device was disconnected or reset before the request completed. */
+			};
+
+		/* Type Defines: */
+			struct USB_TransferRequest;
+
+			/** Type define for a transfer request completion callback, run by the library once a submitted request
+			 *  has finished, successfully or otherwise.
+			 *
+			 *  \param[in] Request  Pointer to the request that has finished. Its \c Status and \c BytesTransferred
+			 *                      elements give the outcome of the transfer.
+			 */
+			typedef void (*USB_TransferCallback_t)(struct USB_TransferRequest* const Request);
+
+			/** \brief Asynchronous Transfer Request.
+			 *
+			 *  Type define for an asynchronous endpoint or pipe transfer request. The \c Buffer, \c Length, \c Flags,
+			 *  \c Callback and \c Context elements are set by the application before the request is submitted; the
+			 *  remaining elements are managed by the library.
+			 */
+			typedef struct USB_TransferRequest
+			{
+				void*                  Buffer; /**< Pointer to the data to send, or the buffer to receive into. */
+				uint16_t               Length; /**< Length of the data to send, or size of the receive buffer, in bytes. */
+				uint16_t               BytesTransferred; /**< Number of bytes transferred so far. */
+				uint8_t                Flags; /**< Mask of \c TRANSFER_FLAG_* flags for the request. */
+				volatile uint8_t       Status; /**< Current status of the request, a value from the \ref USB_TransferRequest_Status_t enum. */
+				USB_TransferCallback_t Callback; /**< Completion callback, or \c NULL if not required. */
+				void*                  Context; /**< Application defined value, for use by the completion callback. */
+
+				uint8_t                Address; /**< Endpoint or pipe address the request was submitted to (set by the library). */
+				struct USB_TransferRequest* Next; /**< Next request in the queue (private to the library). */
+			} USB_TransferRequest_t;
+
+		/* Function Prototypes: */
+			#if (defined(USB_CAN_BE_DEVICE) && !defined(CONTROL_ONLY_DEVICE)) || defined(__DOXYGEN__)
+				/** Queues a transfer request on the given device endpoint. The request will be started once all requests
+				 *  previously submitted to the same endpoint number have finished.
+				 *
+				 *  \note Requests may not be submitted to the control endpoint; see \ref Group_DeviceControlTransfer instead.
+				 *        Requests for both directions of the same endpoint number share a single queue.
+				 *
+				 *  \param[in]     Address  Address of the endpoint to queue the request on, including its direction.
+				 *  \param[in,out] Request  Pointer to the request to queue.
+				 *
+				 *  \return Boolean \c true if the request was queued, \c false if the request is already pending or the
+				 *          endpoint address is invalid.
+				 */
+				bool Endpoint_SubmitRequest(const uint8_t Address,
+				                            USB_TransferRequest_t* const Request) ATTR_NON_NULL_PTR_ARG(2);
+
+				/** Cancels a pending transfer request on a device endpoint, removing it from its endpoint's queue and
+				 *  running its completion callback with a status of \ref TRANSFER_STATUS_Cancelled. Any packets already
+				 *  sent or received by the request are not affected.
+				 *
+				 *  \param[in,out] Request  Pointer to the request to cancel.
+				 *
+				 *  \return Boolean \c true if the request was cancelled, \c false if it was not pending.
+				 */
+				bool Endpoint_CancelRequest(USB_TransferRequest_t* const Request) ATTR_NON_NULL_PTR_ARG(1);
+
+				/** Cancels all pending transfer requests on the given device endpoint number, as if
+				 *  \ref Endpoint_CancelRequest() was called for each in turn.
+				 *
+				 *  \param[in] Address  Address of the endpoint whose requests are to be cancelled.
+				 */
+				void Endpoint_AbortRequests(const uint8_t Address);
+			#endif
+
+			#if defined(USB_CAN_BE_HOST) || defined(__DOXYGEN__)
+				/** Queues a transfer request on the given host pipe. The request will be started once all requests
+				 *  previously submitted to the same pipe have finished. The pipe is unfrozen by the library while it
+				 *  has requests queued, and frozen again once its queue is empty.
+				 *
+				 *  \note Requests may not be submitted to the control pipe.
+				 *
+				 *  \param[in]     Address  Address of the pipe to queue the request on.
+				 *  \param[in,out] Request  Pointer to the request to queue.
+				 *
+				 *  \return Boolean \c true if the request was queued, \c false if the request is already pending or the
+				 *          pipe address is invalid.
+				 */
+				bool Pipe_SubmitRequest(const uint8_t Address,
+				                        USB_TransferRequest_t* const Request) ATTR_NON_NULL_PTR_ARG(2);
+
+				/** Cancels a pending transfer request on a host pipe, removing it from its pipe's queue and running its
+				 *  completion callback with a status of \ref TRANSFER_STATUS_Cancelled.
+				 *
+				 *  \param[in,out] Request  Pointer to the request to cancel.
+				 *
+				 *  \return Boolean \c true if the request was cancelled, \c false if it was not pending.
+				 */
+				bool Pipe_CancelRequest(USB_TransferRequest_t* const Request) ATTR_NON_NULL_PTR_ARG(1);
+
+				/** Cancels all pending transfer requests on the given host pipe, as if \ref Pipe_CancelRequest() was
+				 *  called for each in turn.
+				 *
+				 *  \param[in] Address  Address of the pipe whose requests are to be cancelled.
+				 */
+				void Pipe_AbortRequests(const uint8_t Address);
+			#endif
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define TRANSFER_PACKET_None         0
+			#define TRANSFER_PACKET_Full         1
+			#define TRANSFER_PACKET_Short        2
+
+		/* Function Prototypes: */
+			#if defined(USB_CAN_BE_DEVICE) && !defined(CONTROL_ONLY_DEVICE)
+				void Endpoint_ProcessRequests(void);
+
+				#if defined(INTERRUPT_CONTROL_ENDPOINT) && (ARCH != ARCH_XMEGA)
+					void Endpoint_DisableRequestInterrupts(void);
+					void Endpoint_UpdateRequestInterrupts(void);
+				#endif
+			#endif
+
+			#if defined(USB_CAN_BE_HOST)
+				void Pipe_ProcessRequests(void);
+			#endif
+
+			#if defined(__INCLUDE_FROM_TRANSFERREQUEST_C)
+				static bool USB_TransferRequest_Append(USB_TransferRequest_t** const Queue,
+				                                       USB_TransferRequest_t* const Request);
+				static bool USB_TransferRequest_Remove(USB_TransferRequest_t** const Queue,
+				                                       USB_TransferRequest_t* const Request);
+				static USB_TransferRequest_t* USB_TransferRequest_Detach(USB_TransferRequest_t** const Queue);
+				static void USB_TransferRequest_Complete(USB_TransferRequest_t* const Request,
+				                                         const uint8_t Status);
+				static void USB_TransferRequest_CompleteAll(USB_TransferRequest_t* Request,
+				                                            const uint8_t Status);
+
+				#if defined(USB_CAN_BE_DEVICE) && !defined(CONTROL_ONLY_DEVICE)
+					static bool Endpoint_ProcessINRequest(USB_TransferRequest_t* const Request);
+					static bool Endpoint_ProcessOUTRequest(USB_TransferRequest_t* const Request);
+
+					#if defined(INTERRUPT_CONTROL_ENDPOINT) && (ARCH != ARCH_XMEGA)
+						static void Endpoint_UpdateRequestInterrupt(const uint8_t EPNum);
+					#endif
+				#endif
+
+				#if defined(USB_CAN_BE_HOST)
+					static uint8_t Pipe_ProcessRequest(USB_TransferRequest_t* const Request);
+				#endif
+			#endif
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
@@ -39,6 +39,89 @@
 #include "EndpointStream_UC3.h"
 
 #if !defined(CONTROL_ONLY_DEVICE)
+static inline uint16_t Endpoint_BankPosition(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+static inline uint16_t Endpoint_BankPosition(void)
+{
+	return (USB_Endpoint_FIFOPos[USB_Endpoint_SelectedEndpoint] -
+	        &AVR32_USBB_SLAVE[USB_Endpoint_SelectedEndpoint * ENDPOINT_HSB_ADDRESS_SPACE_SIZE]);
+}
+
+static inline uint16_t Endpoint_BytesFreeInBank(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+static inline uint16_t Endpoint_BytesFreeInBank(void)
+{
+	return ((8 << (&AVR32_USBB.UECFG0)[USB_Endpoint_SelectedEndpoint].epsize) - Endpoint_BankPosition());
+}
+
+static inline uint16_t Endpoint_BytesLeftInBank(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+static inline uint16_t Endpoint_BytesLeftInBank(void)
+{
+	return (Endpoint_BytesInEndpoint() - Endpoint_BankPosition());
+}
+
+static inline void Endpoint_CopyToBank(const uint8_t* Buffer,
+                                       uint16_t Length) ATTR_ALWAYS_INLINE;
+static inline void Endpoint_CopyToBank(const uint8_t* Buffer,
+                                       uint16_t Length)
+{
+	volatile uint8_t* FIFOPos = USB_Endpoint_FIFOPos[USB_Endpoint_SelectedEndpoint];
+
+	while (Length && ((uintptr_t)FIFOPos & 0x03))
+	{
+		*(FIFOPos++) = *(Buffer++);
+		Length--;
+	}
+
+	/* Once the bank is word aligned, copy whole words if the source buffer is also word aligned */
+	if (!((uintptr_t)Buffer & 0x03))
+	{
+		while (Length >= 4)
+		{
+			*((volatile uint32_t*)FIFOPos) = *((const uint32_t*)Buffer);
+
+			FIFOPos += 4;
+			Buffer  += 4;
+			Length  -= 4;
+		}
+	}
+
+	while (Length--)
+	  *(FIFOPos++) = *(Buffer++);
+
+	USB_Endpoint_FIFOPos[USB_Endpoint_SelectedEndpoint] = FIFOPos;
+}
+
+static inline void Endpoint_CopyFromBank(uint8_t* Buffer,
+                                         uint16_t Length) ATTR_ALWAYS_INLINE;
+static inline void Endpoint_CopyFromBank(uint8_t* Buffer,
+                                         uint16_t Length)
+{
+	volatile uint8_t* FIFOPos = USB_Endpoint_FIFOPos[USB_Endpoint_SelectedEndpoint];
+
+	while (Length && ((uintptr_t)FIFOPos & 0x03))
+	{
+		*(Buffer++) = *(FIFOPos++);
+		Length--;
+	}
+
+	/* Once the bank is word aligned, copy whole words if the destination buffer is also word aligned */
+	if (!((uintptr_t)Buffer & 0x03))
+	{
+		while (Length >= 4)
+		{
+			*((uint32_t*)Buffer) = *((volatile uint32_t*)FIFOPos);
+
+			FIFOPos += 4;
+			Buffer  += 4;
+			Length  -= 4;
+		}
+	}
+
+	while (Length--)
+	  *(Buffer++) = *(FIFOPos++);
+
+	USB_Endpoint_FIFOPos[USB_Endpoint_SelectedEndpoint] = FIFOPos;
+}
+
 uint8_t Endpoint_Discard_Stream(uint16_t Length,
                                 uint16_t* const BytesProcessed)
 {
@@ -123,14 +206,17 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Write_Stream_LE
 #define  TEMPLATE_BUFFER_TYPE                      const void*
 #define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 #define  TEMPLATE_BUFFER_OFFSET(Length)            0
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(*BufferPtr)
+#define  TEMPLATE_TRANSFER_BLOCK(BufferPtr, Len)   Endpoint_CopyToBank(BufferPtr, Len)
 #include "Template/Template_Endpoint_RW.c"
 
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Write_Stream_BE
 #define  TEMPLATE_BUFFER_TYPE                      const void*
 #define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 #define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(*BufferPtr)
@@ -139,14 +225,17 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Read_Stream_LE
 #define  TEMPLATE_BUFFER_TYPE                      void*
 #define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearOUT()
+#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesLeftInBank()
 #define  TEMPLATE_BUFFER_OFFSET(Length)            0
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         *BufferPtr = Endpoint_Read_8()
+#define  TEMPLATE_TRANSFER_BLOCK(BufferPtr, Len)   Endpoint_CopyFromBank(BufferPtr, Len)
 #include "Template/Template_Endpoint_RW.c"
 
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Read_Stream_BE
 #define  TEMPLATE_BUFFER_TYPE                      void*
 #define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearOUT()
+#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesLeftInBank()
 #define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         *BufferPtr = Endpoint_Read_8()
@@ -156,6 +245,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_PStream_LE
 	#define  TEMPLATE_BUFFER_TYPE                      const void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            0
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(pgm_read_byte(BufferPtr))
@@ -164,6 +254,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_PStream_BE
 	#define  TEMPLATE_BUFFER_TYPE                      const void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(pgm_read_byte(BufferPtr))
@@ -174,6 +265,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_EStream_LE
 	#define  TEMPLATE_BUFFER_TYPE                      const void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            0
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(eeprom_read_byte(BufferPtr))
@@ -182,6 +274,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_EStream_BE
 	#define  TEMPLATE_BUFFER_TYPE                      const void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(eeprom_read_byte(BufferPtr))
@@ -190,6 +283,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Read_EStream_LE
 	#define  TEMPLATE_BUFFER_TYPE                      void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearOUT()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesLeftInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            0
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         eeprom_update_byte(BufferPtr, Endpoint_Read_8())
@@ -198,6 +292,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Read_EStream_BE
 	#define  TEMPLATE_BUFFER_TYPE                      void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearOUT()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesLeftInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         eeprom_update_byte(BufferPtr, Endpoint_Read_8())
@@ -233,6 +233,20 @@
 				return (&AVR32_USBB.UESTA0)[USB_Endpoint_SelectedEndpoint].byct;
 			}
 
+			/** Retrieves the bank size in bytes of the currently selected endpoint, as set when the endpoint was
+			 *  configured. This is the maximum packet size of the endpoint; a packet smaller than this indicates the
+			 *  end of a transfer.
+			 *
+			 *  \ingroup Group_EndpointRW_UC3
+			 *
+			 *  \return Size in bytes of each bank of the currently selected endpoint.
+			 */
+			static inline uint16_t Endpoint_GetEndpointSize(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint16_t Endpoint_GetEndpointSize(void)
+			{
+				return (8 << (&AVR32_USBB.UECFG0)[USB_Endpoint_SelectedEndpoint].epsize);
+			}
+
 			/** Determines the currently selected endpoint's direction.
 			 *
 			 *  \return The currently selected endpoint's direction, as a \c ENDPOINT_DIR_* mask.
@@ -75,9 +75,12 @@
 
 			#if !defined(HOST_DEVICE_SETTLE_DELAY_MS) || defined(__DOXYGEN__)
 				/** Constant for the delay in milliseconds after a device is connected before the library
-				 *  will start the enumeration process. Some devices require a delay of up to 5 seconds
-				 *  after connection before the enumeration process can start or incorrect operation will
-				 *  occur.
+				 *  will start the enumeration process, in addition to the \ref HOST_CONNECT_DEBOUNCE_MS
+				 *  connection debounce interval. Some devices require a delay of up to 5 seconds after
+				 *  connection before the enumeration process can start or incorrect operation will occur.
+				 *
+				 *  This delay is timed from the USB bus frames sent to the device, so that the application's
+				 *  main loop continues to run while it elapses.
 				 *
 				 *  The default delay value may be overridden in the user project makefile by defining the
 				 *  \c HOST_DEVICE_SETTLE_DELAY_MS token to the required delay in milliseconds, and passed to the
@@ -86,6 +89,42 @@
 				#define HOST_DEVICE_SETTLE_DELAY_MS        1000
 			#endif
 
+			#if !defined(HOST_CONNECT_DEBOUNCE_MS) || defined(__DOXYGEN__)
+				/** Constant for the debounce interval in milliseconds between a device connection being detected
+				 *  and the first bus reset of the device. The USB 2.0 specification requires this interval to be at
+				 *  least 100ms.
+				 *
+				 *  The default delay value may be overridden in the user project makefile by defining the
+				 *  \c HOST_CONNECT_DEBOUNCE_MS token to the required delay in milliseconds, and passed to the
+				 *  compiler using the -D switch.
+				 */
+				#define HOST_CONNECT_DEBOUNCE_MS           100
+			#endif
+
+			#if !defined(HOST_RESET_RECOVERY_MS) || defined(__DOXYGEN__)
+				/** Constant for the recovery interval in milliseconds allowed after each bus reset of the attached
+				 *  device before it is next communicated with. The USB 2.0 specification requires this interval to be
+				 *  at least 10ms; the longer default accommodates slow devices.
+				 *
+				 *  The default delay value may be overridden in the user project makefile by defining the
+				 *  \c HOST_RESET_RECOVERY_MS token to the required delay in milliseconds, and passed to the
+				 *  compiler using the -D switch.
+				 */
+				#define HOST_RESET_RECOVERY_MS             200
+			#endif
+
+			#if !defined(HOST_SET_ADDRESS_RECOVERY_MS) || defined(__DOXYGEN__)
+				/** Constant for the recovery interval in milliseconds allowed after the attached device is sent its
+				 *  new address before it is communicated with at that address. The USB 2.0 specification requires this
+				 *  interval to be at least 2ms; the longer default accommodates slow devices.
+				 *
+				 *  The default delay value may be overridden in the user project makefile by defining the
+				 *  \c HOST_SET_ADDRESS_RECOVERY_MS token to the required delay in milliseconds, and passed to the
+				 *  compiler using the -D switch.
+				 */
+				#define HOST_SET_ADDRESS_RECOVERY_MS       100
+			#endif
+
 		/* Enums: */
 			/** Enum for the error codes for the \ref EVENT_USB_Host_HostError() event.
 			 *
@@ -274,6 +313,8 @@
 	/* Private Interface - For use in library only: */
 	#if !defined(__DOXYGEN__)
 		/* Macros: */
+			#define USB_HOST_FRAMENUMBER_MASK          0x07FF
+
 			static inline void USB_Host_HostMode_On(void) ATTR_ALWAYS_INLINE;
 			static inline void USB_Host_HostMode_On(void)
 			{
@@ -348,7 +389,9 @@
 			uint8_t USB_Host_WaitMS(uint8_t MS);
 
 			#if defined(__INCLUDE_FROM_HOST_C)
-				static void USB_Host_ResetDevice(void);
+				static void     USB_Host_ResetDevice(void);
+				static void     USB_Host_CompleteDeviceReset(void);
+				static uint16_t USB_Host_UpdateBusTime(void);
 			#endif
 	#endif
 
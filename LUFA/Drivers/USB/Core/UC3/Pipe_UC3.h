@@ -197,6 +197,19 @@
 				return (&AVR32_USBB.UPSTA0)[USB_Pipe_SelectedPipe].pbyct;
 			}
 
+			/** Retrieves the bank size in bytes of the currently selected pipe, as set when the pipe was configured.
+			 *  This is the maximum packet size of the pipe; a packet smaller than this indicates the end of a transfer.
+			 *
+			 *  \ingroup Group_PipeRW_UC3
+			 *
+			 *  \return Size in bytes of each bank of the currently selected pipe.
+			 */
+			static inline uint16_t Pipe_GetPipeSize(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint16_t Pipe_GetPipeSize(void)
+			{
+				return (8 << (&AVR32_USBB.UPCFG0)[USB_Pipe_SelectedPipe].psize);
+			}
+
 			/** Determines the currently selected pipe's direction.
 			 *
 			 *  \return The currently selected pipe's direction, as a \c PIPE_DIR_* mask.
@@ -212,15 +212,34 @@ ISR(USB_COM_vect)
 {
 	uint8_t PrevSelectedEndpoint = Endpoint_GetCurrentEndpoint();
 
+	#if !defined(CONTROL_ONLY_DEVICE)
+	Endpoint_DisableRequestInterrupts();
+	#endif
+
 	Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
 	USB_INT_Disable(USB_INT_RXSTPI);
+	USB_INT_Disable(USB_INT_TXINI);
+	USB_INT_Disable(USB_INT_RXOUTI);
 
 	GlobalInterruptEnable();
 
-	USB_Device_ProcessControlRequest();
+	USB_Device_ProcessControlTransfer();
+
+	if (Endpoint_IsSETUPReceived())
+	  USB_Device_ProcessControlRequest();
+
+	#if !defined(CONTROL_ONLY_DEVICE)
+	Endpoint_ProcessRequests();
+	#endif
 
 	Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
 	USB_INT_Enable(USB_INT_RXSTPI);
+	USB_Device_UpdateControlTransferInterrupts();
+
+	#if !defined(CONTROL_ONLY_DEVICE)
+	Endpoint_UpdateRequestInterrupts();
+	#endif
+
 	Endpoint_SelectEndpoint(PrevSelectedEndpoint);
 }
 #endif
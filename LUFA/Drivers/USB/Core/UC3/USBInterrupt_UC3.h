@@ -81,6 +81,10 @@
 				USB_INT_BCERRI  = 11,
 				USB_INT_VBERRI  = 12,
 				#endif
+				#if (defined(USB_CAN_BE_DEVICE) || defined(__DOXYGEN__))
+				USB_INT_TXINI   = 13,
+				USB_INT_RXOUTI  = 14,
+				#endif
 			};
 
 		/* Inline Functions: */
@@ -113,6 +117,12 @@
 					case USB_INT_RXSTPI:
 						(&AVR32_USBB.UECON0SET)[USB_Endpoint_SelectedEndpoint].rxstpes = true;
 						break;
+					case USB_INT_TXINI:
+						(&AVR32_USBB.UECON0SET)[USB_Endpoint_SelectedEndpoint].txines  = true;
+						break;
+					case USB_INT_RXOUTI:
+						(&AVR32_USBB.UECON0SET)[USB_Endpoint_SelectedEndpoint].rxoutes = true;
+						break;
 					#endif
 					#if defined(USB_CAN_BE_HOST)
 					case USB_INT_HSOFI:
@@ -168,6 +178,12 @@
 					case USB_INT_RXSTPI:
 						(&AVR32_USBB.UECON0CLR)[USB_Endpoint_SelectedEndpoint].rxstpec = true;
 						break;
+					case USB_INT_TXINI:
+						(&AVR32_USBB.UECON0CLR)[USB_Endpoint_SelectedEndpoint].txinec  = true;
+						break;
+					case USB_INT_RXOUTI:
+						(&AVR32_USBB.UECON0CLR)[USB_Endpoint_SelectedEndpoint].rxoutec = true;
+						break;
 					#endif
 					#if defined(USB_CAN_BE_HOST)
 					case USB_INT_HSOFI:
@@ -283,6 +299,10 @@
 						return AVR32_USBB.UDINTE.sofe;
 					case USB_INT_RXSTPI:
 						return (&AVR32_USBB.UECON0)[USB_Endpoint_SelectedEndpoint].rxstpe;
+					case USB_INT_TXINI:
+						return (&AVR32_USBB.UECON0)[USB_Endpoint_SelectedEndpoint].txine;
+					case USB_INT_RXOUTI:
+						return (&AVR32_USBB.UECON0)[USB_Endpoint_SelectedEndpoint].rxoute;
 					#endif
 					#if defined(USB_CAN_BE_HOST)
 					case USB_INT_HSOFI:
@@ -325,6 +345,10 @@
 						return AVR32_USBB.UDINT.sof;
 					case USB_INT_RXSTPI:
 						return (&AVR32_USBB.UESTA0)[USB_Endpoint_SelectedEndpoint].rxstpi;
+					case USB_INT_TXINI:
+						return (&AVR32_USBB.UESTA0)[USB_Endpoint_SelectedEndpoint].txini;
+					case USB_INT_RXOUTI:
+						return (&AVR32_USBB.UESTA0)[USB_Endpoint_SelectedEndpoint].rxouti;
 					#endif
 					#if defined(USB_CAN_BE_HOST)
 					case USB_INT_HSOFI:
@@ -55,6 +55,9 @@
 #ifndef __USBMODE_H__
 #define __USBMODE_H__
 
+	/* Includes: */
+		#include "../../../Common/Common.h"
+
 	/* Enable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			extern "C" {
@@ -152,6 +155,11 @@
 		 */
 		#define USB_SERIES_C4_XMEGA
 
+		/** Indicates that the target is the simulated HOSTSIM USB controller, which models the USB controller
+		 *  in memory so that the library may be compiled and run natively on the build host.
+		 */
+		#define USB_SERIES_HOSTSIM
+
 		/** Indicates that the target microcontroller and compilation settings allow for the
 		 *  target to be configured in USB Device mode when defined.
 		 */
@@ -242,6 +250,9 @@
 			#elif (defined(__AVR_ATxmega16C4__) || defined(__AVR_ATxmega32C4__))
 				#define USB_SERIES_C4_XMEGA
 				#define USB_CAN_BE_DEVICE
+			#elif (ARCH == ARCH_HOSTSIM)
+				#define USB_SERIES_HOSTSIM
+				#define USB_CAN_BE_DEVICE
 			#endif
 
 			#if (defined(USB_HOST_ONLY) && defined(USB_DEVICE_ONLY))
@@ -61,15 +61,38 @@ void USB_USBTask(void)
 static void USB_DeviceTask(void)
 {
 	if (USB_DeviceState == DEVICE_STATE_Unattached)
-	  return;
+	{
+		/* Abandon any control transfer or endpoint requests still in progress when the device was disconnected */
+		USB_Device_ProcessControlTransfer();
+
+		#if !defined(CONTROL_ONLY_DEVICE)
+		Endpoint_ProcessRequests();
+		#endif
+
+		return;
+	}
 
 	uint8_t PrevEndpoint = Endpoint_GetCurrentEndpoint();
 
 	Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
 
+	#if !defined(INTERRUPT_CONTROL_ENDPOINT) || (ARCH == ARCH_XMEGA)
+	USB_Device_ProcessControlTransfer();
+	#endif
+
 	if (Endpoint_IsSETUPReceived())
 	  USB_Device_ProcessControlRequest();
 
+	/* Endpoint requests are serviced from the endpoint interrupt when enabled, which cannot abandon them after a bus reset */
+	#if !defined(CONTROL_ONLY_DEVICE)
+		#if !defined(INTERRUPT_CONTROL_ENDPOINT) || (ARCH == ARCH_XMEGA)
+		Endpoint_ProcessRequests();
+		#else
+		if (USB_DeviceState < DEVICE_STATE_Configured)
+		  Endpoint_ProcessRequests();
+		#endif
+	#endif
+
 	Endpoint_SelectEndpoint(PrevEndpoint);
 }
 #endif
@@ -81,7 +104,13 @@ static void USB_HostTask(void)
 
 	Pipe_SelectPipe(PIPE_CONTROLPIPE);
 
+	/* The shared configuration descriptor index describes the attached device, and must not outlive it */
+	if (USB_HostState == HOST_STATE_Unattached)
+	  USB_Host_InvalidateConfigIndex();
+
 	USB_Host_ProcessNextHostState();
+	USB_Host_ProcessControlTransfer();
+	Pipe_ProcessRequests();
 
 	Pipe_SelectPipe(PrevPipe);
 }
@@ -44,17 +44,21 @@
 	/* Includes: */
 		#include "../../../Common/Common.h"
 		#include "USBMode.h"
+		#include "USBTrace.h"
 		#include "USBController.h"
 		#include "Events.h"
 		#include "StdRequestType.h"
 		#include "StdDescriptors.h"
+		#include "TransferRequest.h"
 
 		#if defined(USB_CAN_BE_DEVICE)
 			#include "DeviceStandardReq.h"
+			#include "DeviceControlTransfer.h"
 		#endif
 
 		#if defined(USB_CAN_BE_HOST)
 			#include "HostStandardReq.h"
+			#include "HostControlTransfer.h"
 		#endif
 
 	/* Enable C linkage for C++ Compilers: */
@@ -190,9 +194,10 @@
 			#endif
 
 		/* Macros: */
-			#define HOST_TASK_NONBLOCK_WAIT(Duration, NextState) MACROS{ USB_HostState   = HOST_STATE_WaitForDevice; \
-			                                                             WaitMSRemaining = (Duration);               \
-			                                                             PostWaitState   = (NextState);              }MACROE
+			#define HOST_TASK_NONBLOCK_WAIT(Duration, NextState) MACROS{ USB_HostState  = HOST_STATE_WaitForDevice;  \
+			                                                             WaitDurationMS = (Duration);                \
+			                                                             WaitStartTime  = USB_Host_UpdateBusTime();  \
+			                                                             PostWaitState  = (NextState);               }MACROE
 	#endif
 
 	/* Disable C linkage for C++ Compilers: */
@@ -0,0 +1,336 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#include "USBMode.h"
+
+#if defined(USB_ENABLE_TRACE)
+
+#define  __INCLUDE_FROM_USBTRACE_C
+#include "USBTrace.h"
+#include "USBController.h"
+
+#if defined(USB_CAN_BE_DEVICE)
+	#include "Device.h"
+#endif
+
+#if defined(USB_CAN_BE_HOST)
+	#include "Host.h"
+#endif
+
+static struct
+{
+	USB_TraceRecord_t   Records[USB_TRACE_BUFFER_SIZE];
+	uint8_t             Head;
+	uint8_t             Count;
+	uint16_t            Dropped;
+
+	USB_TraceCounters_t Counters[USB_TRACE_TOTAL_COUNTERS];
+	uint8_t             NextCounterFrame;
+
+	uint8_t             Frame[2 + 1 + sizeof(USB_TraceCounters_t)];
+	uint8_t             FrameLength;
+	uint8_t             FramePosition;
+} USB_Trace =
+	{
+		.NextCounterFrame = USB_TRACE_TOTAL_COUNTERS,
+	};
+
+static uint16_t USB_Trace_GetFrameNumber(void)
+{
+	#if defined(USB_CAN_BE_BOTH)
+	if (USB_CurrentMode == USB_MODE_Host)
+	  return USB_Host_GetFrameNumber();
+	else
+	  return USB_Device_GetFrameNumber();
+	#elif defined(USB_CAN_BE_HOST)
+	return USB_Host_GetFrameNumber();
+	#else
+	return USB_Device_GetFrameNumber();
+	#endif
+}
+
+void USB_Trace_Record(const uint8_t Event,
+                      const uint8_t Address,
+                      const uint8_t Param,
+                      const uint16_t Value)
+{
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	uint16_t Tail = ((uint16_t)USB_Trace.Head + USB_Trace.Count);
+
+	if (Tail >= USB_TRACE_BUFFER_SIZE)
+	  Tail -= USB_TRACE_BUFFER_SIZE;
+
+	USB_TraceRecord_t* Record = &USB_Trace.Records[Tail];
+
+	Record->FrameNumber = USB_Trace_GetFrameNumber();
+	Record->SubFrame    = (uint8_t)(USB_TRACE_SUBFRAME_TIMER);
+	Record->Event       = Event;
+	Record->Address     = Address;
+	Record->Param       = Param;
+	Record->Value       = Value;
+
+	/* Overwrite the oldest record once the buffer is full, so that the trace always shows the most recent events */
+	if (USB_Trace.Count == USB_TRACE_BUFFER_SIZE)
+	{
+		if (++USB_Trace.Head == USB_TRACE_BUFFER_SIZE)
+		  USB_Trace.Head = 0;
+
+		if (USB_Trace.Dropped != 0xFFFF)
+		  USB_Trace.Dropped++;
+	}
+	else
+	{
+		USB_Trace.Count++;
+	}
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+}
+
+void USB_Trace_CountPacketSent(const uint8_t Address,
+                               const uint16_t Length,
+                               const bool NAKed)
+{
+	uint8_t Number = (Address & 0x0F);
+
+	if (Number >= USB_TRACE_TOTAL_COUNTERS)
+	  return;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	USB_TraceCounters_t* Counters = &USB_Trace.Counters[Number];
+
+	Counters->BytesSent += Length;
+	Counters->PacketsSent++;
+
+	if (NAKed)
+	  Counters->NAKs++;
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+}
+
+void USB_Trace_CountPacketReceived(const uint8_t Address,
+                                   const bool NAKed)
+{
+	uint8_t Number = (Address & 0x0F);
+
+	if (Number >= USB_TRACE_TOTAL_COUNTERS)
+	  return;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	USB_TraceCounters_t* Counters = &USB_Trace.Counters[Number];
+
+	Counters->PacketsReceived++;
+
+	if (NAKed)
+	  Counters->NAKs++;
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+}
+
+void USB_Trace_CountFailure(const uint8_t Event,
+                            const uint8_t Address)
+{
+	uint8_t Number = (Address & 0x0F);
+
+	if (Number < USB_TRACE_TOTAL_COUNTERS)
+	{
+		uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+		GlobalInterruptDisable();
+
+		if (Event == TRACE_EVENT_Stall)
+		  USB_Trace.Counters[Number].Stalls++;
+		else
+		  USB_Trace.Counters[Number].Timeouts++;
+
+		SetGlobalInterruptMask(CurrentGlobalInt);
+	}
+
+	USB_Trace_Record(Event, Address, 0, 0);
+}
+
+uint8_t USB_Trace_ReadRecords(USB_TraceRecord_t* Records,
+                              const uint8_t MaxRecords)
+{
+	uint8_t RecordsRead = 0;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	while (USB_Trace.Count && (RecordsRead < MaxRecords))
+	{
+		*(Records++) = USB_Trace.Records[USB_Trace.Head];
+
+		if (++USB_Trace.Head == USB_TRACE_BUFFER_SIZE)
+		  USB_Trace.Head = 0;
+
+		USB_Trace.Count--;
+		RecordsRead++;
+	}
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	return RecordsRead;
+}
+
+bool USB_Trace_GetCounters(const uint8_t Number,
+                           USB_TraceCounters_t* const Counters)
+{
+	if (Number >= USB_TRACE_TOTAL_COUNTERS)
+	  return false;
+
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	*Counters = USB_Trace.Counters[Number];
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+
+	return true;
+}
+
+void USB_Trace_Reset(void)
+{
+	uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+	GlobalInterruptDisable();
+
+	USB_Trace.Head             = 0;
+	USB_Trace.Count            = 0;
+	USB_Trace.Dropped          = 0;
+	USB_Trace.NextCounterFrame = USB_TRACE_TOTAL_COUNTERS;
+	USB_Trace.FrameLength      = 0;
+	USB_Trace.FramePosition    = 0;
+
+	memset(USB_Trace.Counters, 0x00, sizeof(USB_Trace.Counters));
+
+	SetGlobalInterruptMask(CurrentGlobalInt);
+}
+
+void USB_Trace_QueueCounters(void)
+{
+	USB_Trace.NextCounterFrame = 0;
+}
+
+uint16_t USB_Trace_ReadStream(void* Buffer,
+                              uint16_t Length)
+{
+	uint8_t* DataStream   = (uint8_t*)Buffer;
+	uint16_t BytesWritten = 0;
+
+	while (Length)
+	{
+		if (USB_Trace.FramePosition == USB_Trace.FrameLength)
+		{
+			USB_Trace.FramePosition = 0;
+			USB_Trace.FrameLength   = USB_Trace_LoadStreamFrame();
+
+			if (!(USB_Trace.FrameLength))
+			  break;
+		}
+
+		*(DataStream++) = USB_Trace.Frame[USB_Trace.FramePosition++];
+
+		BytesWritten++;
+		Length--;
+	}
+
+	return BytesWritten;
+}
+
+static uint8_t USB_Trace_LoadStreamFrame(void)
+{
+	uint8_t* Frame = USB_Trace.Frame;
+
+	*(Frame++) = USB_TRACE_STREAM_SYNC;
+
+	/* Report lost records first, so that the host knows there is a gap before the records that follow */
+	if (USB_Trace.Dropped)
+	{
+		uint_reg_t CurrentGlobalInt = GetGlobalInterruptMask();
+		GlobalInterruptDisable();
+
+		uint16_t Dropped = USB_Trace.Dropped;
+		USB_Trace.Dropped = 0;
+
+		SetGlobalInterruptMask(CurrentGlobalInt);
+
+		*(Frame++) = USB_TRACE_FRAME_Dropped;
+		*(Frame++) = (Dropped & 0xFF);
+		*(Frame++) = (Dropped >> 8);
+	}
+	else if (USB_Trace.NextCounterFrame < USB_TRACE_TOTAL_COUNTERS)
+	{
+		USB_TraceCounters_t Counters;
+		USB_Trace_GetCounters(USB_Trace.NextCounterFrame, &Counters);
+
+		*(Frame++) = USB_TRACE_FRAME_Counters;
+		*(Frame++) = USB_Trace.NextCounterFrame++;
+		*(Frame++) = (Counters.BytesSent & 0xFF);
+		*(Frame++) = (Counters.BytesSent >> 8);
+		*(Frame++) = (Counters.BytesSent >> 16);
+		*(Frame++) = (Counters.BytesSent >> 24);
+
+		const uint16_t Values[] = {Counters.PacketsSent, Counters.PacketsReceived, Counters.NAKs,
+		                           Counters.Stalls, Counters.Timeouts};
+
+		for (uint8_t i = 0; i < (sizeof(Values) / sizeof(Values[0])); i++)
+		{
+			*(Frame++) = (Values[i] & 0xFF);
+			*(Frame++) = (Values[i] >> 8);
+		}
+	}
+	else
+	{
+		USB_TraceRecord_t Record;
+
+		if (!(USB_Trace_ReadRecords(&Record, 1)))
+		  return 0;
+
+		*(Frame++) = USB_TRACE_FRAME_Record;
+		*(Frame++) = (Record.FrameNumber & 0xFF);
+		*(Frame++) = (Record.FrameNumber >> 8);
+		*(Frame++) = Record.SubFrame;
+		*(Frame++) = Record.Event;
+		*(Frame++) = Record.Address;
+		*(Frame++) = Record.Param;
+		*(Frame++) = (Record.Value & 0xFF);
+		*(Frame++) = (Record.Value >> 8);
+	}
+
+	return (Frame - USB_Trace.Frame);
+}
+
+#endif
+
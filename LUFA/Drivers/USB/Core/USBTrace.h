@@ -0,0 +1,309 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief USB bus event tracing and endpoint statistics.
+ *  \copydetails Group_USBTrace
+ *
+ *  \note This file should not be included directly. It is automatically included as needed by the USB driver
+ *        dispatch header located in LUFA/Drivers/USB/USB.h.
+ */
+
+/** \ingroup Group_USB
+ *  \defgroup Group_USBTrace USB Event Tracing
+ *  \brief USB bus event tracing and endpoint statistics.
+ *
+ *  Optional diagnostic module which records USB bus events, control requests, stalls and transfer timeouts into a
+ *  RAM ring buffer as they occur, and keeps a set of running packet statistics for each endpoint (or pipe) number.
+ *  Each record is stamped with the current USB frame number, and optionally a sub-frame timer value, so that bursts
+ *  of NAKs, stalls or timeouts can be placed in time relative to the surrounding bus traffic.
+ *
+ *  This module is compiled out entirely unless the \c USB_ENABLE_TRACE compile time token is defined, in which case
+ *  the hooks in the core USB driver add only a few instructions to each packet. The hooks are currently only present
+ *  in the AVR8 and HOSTSIM architecture drivers, and defining the token on any other architecture is an error. The trace may be read back by the
+ *  application as records via \ref USB_Trace_ReadRecords() and \ref USB_Trace_GetCounters(), or as a framed binary
+ *  byte stream via \ref USB_Trace_ReadStream() for transmission over a spare CDC or vendor interface to the host. A
+ *  Python decoder for the binary stream format is supplied with the DualVirtualSerial class driver demo.
+ *
+ *  The binary stream consists of frames beginning with the \ref USB_TRACE_STREAM_SYNC byte and a frame type, all
+ *  multi-byte values being little endian:
+ *    - \ref USB_TRACE_FRAME_Record: a single \ref USB_TraceRecord_t.
+ *    - \ref USB_TRACE_FRAME_Counters: the endpoint number, followed by its \ref USB_TraceCounters_t.
+ *    - \ref USB_TRACE_FRAME_Dropped: a 16-bit count of records lost since the last such frame.
+ *
+ *  The following compile time tokens configure the module:
+ *    - \c USB_TRACE_BUFFER_SIZE - number of records held in the trace ring buffer, up to 255 (default 32).
+ *    - \c USB_TRACE_TOTAL_COUNTERS - number of endpoint numbers to keep statistics for (default 8).
+ *    - \c USB_TRACE_SUBFRAME_TIMER - expression sampled for each record's sub-frame timestamp, such as a free
+ *      running timer register (default 0).
+ *
+ *  @{
+ */
+
+#ifndef __USBTRACE_H__
+#define __USBTRACE_H__
+
+	/* Includes: */
+		#include "../../../Common/Common.h"
+		#include "USBMode.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Preprocessor Checks: */
+		#if !defined(__INCLUDE_FROM_USB_DRIVER)
+			#error Do not include this file directly. Include LUFA/Drivers/USB/USB.h instead.
+		#endif
+
+		#if defined(USB_ENABLE_TRACE) && !((ARCH == ARCH_AVR8) || (ARCH == ARCH_HOSTSIM))
+			#error USB_ENABLE_TRACE is not supported on the selected architecture, as its USB driver has no trace hooks.
+		#endif
+
+		#if defined(USB_ENABLE_TRACE) && defined(USB_TRACE_BUFFER_SIZE) && ((USB_TRACE_BUFFER_SIZE < 1) || (USB_TRACE_BUFFER_SIZE > 255))
+			#error USB_TRACE_BUFFER_SIZE must be between 1 and 255 records.
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Macros: */
+			#if !defined(USB_TRACE_BUFFER_SIZE) || defined(__DOXYGEN__)
+				/** Number of records held in the trace ring buffer. Once full, the oldest record is overwritten by each
+				 *  new record and counted as dropped. This value may be overridden in the user project makefile as the
+				 *  value of the \c USB_TRACE_BUFFER_SIZE token.
+				 */
+				#define USB_TRACE_BUFFER_SIZE               32
+			#endif
+
+			#if !defined(USB_TRACE_TOTAL_COUNTERS) || defined(__DOXYGEN__)
+				/** Number of endpoint (or pipe) numbers for which packet statistics are kept, starting from zero. This
+				 *  value may be overridden in the user project makefile as the value of the \c USB_TRACE_TOTAL_COUNTERS
+				 *  token.
+				 */
+				#define USB_TRACE_TOTAL_COUNTERS            8
+			#endif
+
+			#if !defined(USB_TRACE_SUBFRAME_TIMER) || defined(__DOXYGEN__)
+				/** Expression sampled as the 8-bit sub-frame timestamp of each trace record, such as the count register
+				 *  of a free running timer. This value may be overridden in the user project makefile as the value of
+				 *  the \c USB_TRACE_SUBFRAME_TIMER token, e.g. \c -DUSB_TRACE_SUBFRAME_TIMER=TCNT0.
+				 */
+				#define USB_TRACE_SUBFRAME_TIMER            0
+			#endif
+
+			/** Synchronization byte starting each frame of the binary trace stream. */
+			#define USB_TRACE_STREAM_SYNC                   0xA5
+
+			/** Binary trace stream frame type for a single trace record. */
+			#define USB_TRACE_FRAME_Record                  0x01
+
+			/** Binary trace stream frame type for the statistics of a single endpoint number. */
+			#define USB_TRACE_FRAME_Counters                0x02
+
+			/** Binary trace stream frame type for a count of records lost to ring buffer overflow. */
+			#define USB_TRACE_FRAME_Dropped                 0x03
+
+		/* Enums: */
+			/** Enum for the event types which may be stored in a \ref USB_TraceRecord_t. The meaning of each record's
+			 *  \c Address, \c Param and \c Value elements depends on its event type, as listed.
+			 */
+			enum USB_Trace_Events_t
+			{
+				TRACE_EVENT_DeviceConnect        = 0x01, /**< VBUS applied to the device. */
+				TRACE_EVENT_DeviceDisconnect     = 0x02, /**< VBUS removed from the device. */
+				TRACE_EVENT_DeviceSuspend        = 0x03, /**< Bus suspended by the host. */
+				TRACE_EVENT_DeviceWakeUp         = 0x04, /**< Bus resumed by the host. */
+				TRACE_EVENT_DeviceReset          = 0x05, /**< Bus reset by the host. */
+				TRACE_EVENT_DeviceControlRequest = 0x06, /**< Control request received; \c Address is the request's
+				                                          *   \c bmRequestType, \c Param its \c bRequest and \c Value
+				                                          *   its \c wValue.
+				                                          */
+				TRACE_EVENT_HostDeviceAttached   = 0x10, /**< Device attached to the host. */
+				TRACE_EVENT_HostDeviceUnattached = 0x11, /**< Device removed from the host. */
+				TRACE_EVENT_HostVBUSError        = 0x12, /**< VBUS voltage dip detected by the host. */
+				TRACE_EVENT_HostEnumerationError = 0x13, /**< Enumeration failed; \c Param is the error code and
+				                                          *   \c Value the sub error code.
+				                                          */
+				TRACE_EVENT_HostControlRequest   = 0x14, /**< Control request started; elements as for
+				                                          *   \ref TRACE_EVENT_DeviceControlRequest.
+				                                          */
+				TRACE_EVENT_HostControlError     = 0x15, /**< Control request failed; \c Address is the request's
+				                                          *   \c bmRequestType, \c Param the
+				                                          *   \ref USB_Host_SendControlErrorCodes_t error code and
+				                                          *   \c Value the request's \c bRequest.
+				                                          */
+				TRACE_EVENT_Stall                = 0x20, /**< Endpoint stalled by the device, or pipe stalled by the
+				                                          *   attached device; \c Address is the endpoint or pipe address.
+				                                          */
+				TRACE_EVENT_Timeout              = 0x21, /**< Endpoint or pipe wait timed out; \c Address is the endpoint
+				                                          *   or pipe address.
+				                                          */
+				TRACE_EVENT_UIDChange            = 0x30, /**< USB mode changed via the UID pin. */
+				TRACE_EVENT_User                 = 0x80, /**< First event value available for application defined events,
+				                                          *   added via \ref USB_Trace_Record().
+				                                          */
+			};
+
+		/* Type Defines: */
+			/** \brief USB Trace Record.
+			 *
+			 *  Type define for a single record of the USB event trace. This is also the layout of each record within the
+			 *  binary trace stream.
+			 */
+			typedef struct
+			{
+				uint16_t FrameNumber; /**< USB frame number the event occurred in. */
+				uint8_t  SubFrame; /**< Value of \ref USB_TRACE_SUBFRAME_TIMER when the event occurred. */
+				uint8_t  Event; /**< Event type, a value from the \ref USB_Trace_Events_t enum. */
+				uint8_t  Address; /**< Endpoint or pipe address associated with the event, if any. */
+				uint8_t  Param; /**< Event specific parameter. */
+				uint16_t Value; /**< Event specific value. */
+			} ATTR_PACKED USB_TraceRecord_t;
+
+			/** \brief USB Trace Endpoint Statistics.
+			 *
+			 *  Type define for the running packet statistics of a single endpoint (or pipe) number, in both directions.
+			 *  Sent and received are from the point of view of the local USB controller.
+			 */
+			typedef struct
+			{
+				uint32_t BytesSent; /**< Total number of data bytes sent. */
+				uint16_t PacketsSent; /**< Total number of packets sent. */
+				uint16_t PacketsReceived; /**< Total number of packets received. */
+				uint16_t NAKs; /**< Number of packets which were NAKed at least once before being transferred. */
+				uint16_t Stalls; /**< Number of stalls. */
+				uint16_t Timeouts; /**< Number of endpoint or pipe wait timeouts. */
+			} ATTR_PACKED USB_TraceCounters_t;
+
+		/* Function Prototypes: */
+			#if defined(USB_ENABLE_TRACE) || defined(__DOXYGEN__)
+				/** Adds a record to the trace ring buffer, timestamped with the current frame number and sub-frame timer.
+				 *  If the buffer is full, the oldest record is discarded. This is used by the library to record bus events,
+				 *  but may also be used by the application to record its own events with event types starting from
+				 *  \ref TRACE_EVENT_User.
+				 *
+				 *  \note This function may be called from interrupt context.
+				 *
+				 *  \param[in] Event    Event type of the record, a value from the \ref USB_Trace_Events_t enum.
+				 *  \param[in] Address  Endpoint or pipe address associated with the event, if any.
+				 *  \param[in] Param    Event specific parameter.
+				 *  \param[in] Value    Event specific value.
+				 */
+				void USB_Trace_Record(const uint8_t Event,
+				                      const uint8_t Address,
+				                      const uint8_t Param,
+				                      const uint16_t Value);
+
+				/** Removes up to the given number of the oldest records from the trace ring buffer.
+				 *
+				 *  \param[out] Records     Pointer to the buffer to copy the records into.
+				 *  \param[in]  MaxRecords  Maximum number of records to copy.
+				 *
+				 *  \return Number of records copied into the buffer.
+				 */
+				uint8_t USB_Trace_ReadRecords(USB_TraceRecord_t* Records,
+				                              const uint8_t MaxRecords) ATTR_NON_NULL_PTR_ARG(1);
+
+				/** Retrieves a snapshot of the packet statistics for the given endpoint (or pipe) number.
+				 *
+				 *  \param[in]  Number    Endpoint or pipe number, less than \ref USB_TRACE_TOTAL_COUNTERS.
+				 *  \param[out] Counters  Pointer to the location to store the statistics.
+				 *
+				 *  \return Boolean \c true if the statistics were retrieved, \c false if the number is out of range.
+				 */
+				bool USB_Trace_GetCounters(const uint8_t Number,
+				                           USB_TraceCounters_t* const Counters) ATTR_NON_NULL_PTR_ARG(2);
+
+				/** Discards all records in the trace ring buffer and any partially read stream frame, and zeroes all
+				 *  endpoint statistics.
+				 */
+				void USB_Trace_Reset(void);
+
+				/** Queues a snapshot of the statistics of every endpoint number for transmission, as a
+				 *  \ref USB_TRACE_FRAME_Counters frame per endpoint number, in the binary stream returned by
+				 *  \ref USB_Trace_ReadStream().
+				 */
+				void USB_Trace_QueueCounters(void);
+
+				/** Fills the given buffer with as much of the binary trace stream as is available, consuming records from
+				 *  the trace ring buffer. Frames may be split across successive calls.
+				 *
+				 *  \param[out] Buffer  Pointer to the buffer to fill.
+				 *  \param[in]  Length  Size of the buffer, in bytes.
+				 *
+				 *  \return Number of bytes written to the buffer, zero if no trace data is pending.
+				 */
+				uint16_t USB_Trace_ReadStream(void* Buffer,
+				                              uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+			#endif
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#if defined(USB_ENABLE_TRACE)
+				#define USB_TRACE_EVENT(Event, Address, Param, Value)  USB_Trace_Record(Event, Address, Param, Value)
+				#define USB_TRACE_PACKET_SENT(Address, Length, NAKed)  USB_Trace_CountPacketSent(Address, Length, NAKed)
+				#define USB_TRACE_PACKET_RECEIVED(Address, NAKed)      USB_Trace_CountPacketReceived(Address, NAKed)
+				#define USB_TRACE_STALL(Address)                       USB_Trace_CountFailure(TRACE_EVENT_Stall, Address)
+				#define USB_TRACE_TIMEOUT(Address)                     USB_Trace_CountFailure(TRACE_EVENT_Timeout, Address)
+			#else
+				#define USB_TRACE_EVENT(Event, Address, Param, Value)
+				#define USB_TRACE_PACKET_SENT(Address, Length, NAKed)
+				#define USB_TRACE_PACKET_RECEIVED(Address, NAKed)
+				#define USB_TRACE_STALL(Address)
+				#define USB_TRACE_TIMEOUT(Address)
+			#endif
+
+		/* Function Prototypes: */
+			#if defined(USB_ENABLE_TRACE)
+				void USB_Trace_CountPacketSent(const uint8_t Address,
+				                               const uint16_t Length,
+				                               const bool NAKed);
+				void USB_Trace_CountPacketReceived(const uint8_t Address,
+				                                   const bool NAKed);
+				void USB_Trace_CountFailure(const uint8_t Event,
+				                            const uint8_t Address);
+
+				#if defined(__INCLUDE_FROM_USBTRACE_C)
+					static uint16_t USB_Trace_GetFrameNumber(void);
+					static uint8_t USB_Trace_LoadStreamFrame(void);
+				#endif
+			#endif
+	#endif
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
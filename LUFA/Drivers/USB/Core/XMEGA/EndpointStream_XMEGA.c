@@ -39,6 +39,36 @@
 #include "EndpointStream_XMEGA.h"
 
 #if !defined(CONTROL_ONLY_DEVICE)
+static inline uint16_t Endpoint_BytesFreeInBank(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+static inline uint16_t Endpoint_BytesFreeInBank(void)
+{
+	return (USB_Endpoint_SelectedFIFO->Length - USB_Endpoint_SelectedFIFO->Position);
+}
+
+static inline uint16_t Endpoint_BytesLeftInBank(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+static inline uint16_t Endpoint_BytesLeftInBank(void)
+{
+	return (USB_Endpoint_SelectedFIFO->Length - USB_Endpoint_SelectedFIFO->Position);
+}
+
+static inline void Endpoint_CopyToBank(const uint8_t* Buffer,
+                                       const uint16_t Length) ATTR_ALWAYS_INLINE;
+static inline void Endpoint_CopyToBank(const uint8_t* Buffer,
+                                       const uint16_t Length)
+{
+	memcpy((uint8_t*)&USB_Endpoint_SelectedFIFO->Data[USB_Endpoint_SelectedFIFO->Position], Buffer, Length);
+	USB_Endpoint_SelectedFIFO->Position += Length;
+}
+
+static inline void Endpoint_CopyFromBank(uint8_t* Buffer,
+                                         const uint16_t Length) ATTR_ALWAYS_INLINE;
+static inline void Endpoint_CopyFromBank(uint8_t* Buffer,
+                                         const uint16_t Length)
+{
+	memcpy(Buffer, (const uint8_t*)&USB_Endpoint_SelectedFIFO->Data[USB_Endpoint_SelectedFIFO->Position], Length);
+	USB_Endpoint_SelectedFIFO->Position += Length;
+}
+
 uint8_t Endpoint_Discard_Stream(uint16_t Length,
                                 uint16_t* const BytesProcessed)
 {
@@ -123,14 +153,17 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Write_Stream_LE
 #define  TEMPLATE_BUFFER_TYPE                      const void*
 #define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 #define  TEMPLATE_BUFFER_OFFSET(Length)            0
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(*BufferPtr)
+#define  TEMPLATE_TRANSFER_BLOCK(BufferPtr, Len)   Endpoint_CopyToBank(BufferPtr, Len)
 #include "Template/Template_Endpoint_RW.c"
 
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Write_Stream_BE
 #define  TEMPLATE_BUFFER_TYPE                      const void*
 #define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 #define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(*BufferPtr)
@@ -139,14 +172,17 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Read_Stream_LE
 #define  TEMPLATE_BUFFER_TYPE                      void*
 #define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearOUT()
+#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesLeftInBank()
 #define  TEMPLATE_BUFFER_OFFSET(Length)            0
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         *BufferPtr = Endpoint_Read_8()
+#define  TEMPLATE_TRANSFER_BLOCK(BufferPtr, Len)   Endpoint_CopyFromBank(BufferPtr, Len)
 #include "Template/Template_Endpoint_RW.c"
 
 #define  TEMPLATE_FUNC_NAME                        Endpoint_Read_Stream_BE
 #define  TEMPLATE_BUFFER_TYPE                      void*
 #define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearOUT()
+#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesLeftInBank()
 #define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 #define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 #define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         *BufferPtr = Endpoint_Read_8()
@@ -156,6 +192,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_PStream_LE
 	#define  TEMPLATE_BUFFER_TYPE                      const void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            0
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(pgm_read_byte(BufferPtr))
@@ -164,6 +201,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_PStream_BE
 	#define  TEMPLATE_BUFFER_TYPE                      const void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(pgm_read_byte(BufferPtr))
@@ -174,6 +212,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_EStream_LE
 	#define  TEMPLATE_BUFFER_TYPE                      const void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            0
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(eeprom_read_byte(BufferPtr))
@@ -182,6 +221,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Write_EStream_BE
 	#define  TEMPLATE_BUFFER_TYPE                      const void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearIN()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesFreeInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         Endpoint_Write_8(eeprom_read_byte(BufferPtr))
@@ -190,6 +230,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Read_EStream_LE
 	#define  TEMPLATE_BUFFER_TYPE                      void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearOUT()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesLeftInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            0
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr += Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         eeprom_update_byte(BufferPtr, Endpoint_Read_8())
@@ -198,6 +239,7 @@ uint8_t Endpoint_Null_Stream(uint16_t Length,
 	#define  TEMPLATE_FUNC_NAME                        Endpoint_Read_EStream_BE
 	#define  TEMPLATE_BUFFER_TYPE                      void*
 	#define  TEMPLATE_CLEAR_ENDPOINT()                 Endpoint_ClearOUT()
+	#define  TEMPLATE_BYTES_IN_BANK()                  Endpoint_BytesLeftInBank()
 	#define  TEMPLATE_BUFFER_OFFSET(Length)            (Length - 1)
 	#define  TEMPLATE_BUFFER_MOVE(BufferPtr, Amount)   BufferPtr -= Amount
 	#define  TEMPLATE_TRANSFER_BYTE(BufferPtr)         eeprom_update_byte(BufferPtr, Endpoint_Read_8())
@@ -51,6 +51,21 @@
  *  from and to endpoints.
  */
 
+/** \ingroup Group_EndpointRW_XMEGA
+ *  \defgroup Group_EndpointBankAccess_XMEGA Direct Endpoint Bank Access (XMEGA)
+ *  \brief Endpoint bank buffer access definitions for the Atmel AVR XMEGA architecture.
+ *
+ *  Functions related to reading and writing packet data directly inside the currently selected endpoint's
+ *  bank buffer. This allows packets to be built and parsed in place, rather than copying each byte into
+ *  or out of the bank through the primitive read and write functions.
+ *
+ *  To access a bank directly, the application should select the endpoint and wait until it is ready as usual,
+ *  obtain a pointer into the bank with \ref Endpoint_AcquireBank(), and then read or write up to the returned
+ *  number of bytes through it. The number of bytes actually consumed or produced is then recorded with
+ *  \ref Endpoint_CommitBank(), before the bank is released with \ref Endpoint_ClearOUT() or
+ *  \ref Endpoint_ClearIN(). Direct bank access may be freely mixed with the primitive and stream functions.
+ */
+
 /** \ingroup Group_EndpointPacketManagement
  *  \defgroup Group_EndpointPacketManagement_XMEGA Endpoint Packet Management (XMEGA)
  *  \brief Endpoint packet management definitions for the Atmel AVR XMEGA architecture.
@@ -288,6 +303,20 @@
 				  return (USB_Endpoint_SelectedFIFO->Length - USB_Endpoint_SelectedFIFO->Position);
 			}
 
+			/** Retrieves the bank size in bytes of the currently selected endpoint, as set when the endpoint was
+			 *  configured. This is the maximum packet size of the endpoint; a packet smaller than this indicates the
+			 *  end of a transfer.
+			 *
+			 *  \ingroup Group_EndpointRW_XMEGA
+			 *
+			 *  \return Size in bytes of each bank of the currently selected endpoint.
+			 */
+			static inline uint16_t Endpoint_GetEndpointSize(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint16_t Endpoint_GetEndpointSize(void)
+			{
+				return (8 << ((USB_Endpoint_SelectedHandle->CTRL & USB_EP_BUFSIZE_gm) >> USB_EP_BUFSIZE_gp));
+			}
+
 			/** Get the endpoint address of the currently selected endpoint. This is typically used to save
 			 *  the currently selected endpoint so that it can be restored after another endpoint has been
 			 *  manipulated.
@@ -558,6 +587,39 @@
 				USB_Endpoint_SelectedFIFO->Position++;
 			}
 
+			/** Retrieves a pointer to the current position within the currently selected endpoint's bank buffer, so
+			 *  that packet data may be written (IN endpoints) or read (OUT endpoints) in place.
+			 *
+			 *  \ingroup Group_EndpointBankAccess_XMEGA
+			 *
+			 *  \param[out] Length  Number of bytes which may be written to or read from the returned location before the
+			 *                      end of the bank is reached.
+			 *
+			 *  \return Pointer to the current read or write position within the selected endpoint's bank.
+			 */
+			static inline uint8_t* Endpoint_AcquireBank(uint16_t* const Length) ATTR_WARN_UNUSED_RESULT ATTR_NON_NULL_PTR_ARG(1)
+			                                                                  ATTR_ALWAYS_INLINE;
+			static inline uint8_t* Endpoint_AcquireBank(uint16_t* const Length)
+			{
+				*Length = (USB_Endpoint_SelectedFIFO->Length - USB_Endpoint_SelectedFIFO->Position);
+
+				return (uint8_t*)&USB_Endpoint_SelectedFIFO->Data[USB_Endpoint_SelectedFIFO->Position];
+			}
+
+			/** Advances the current position within the currently selected endpoint's bank buffer, after data has been
+			 *  written to or read from the buffer returned by \ref Endpoint_AcquireBank().
+			 *
+			 *  \ingroup Group_EndpointBankAccess_XMEGA
+			 *
+			 *  \param[in] Bytes  Number of bytes written to or read from the bank, which must not exceed the length
+			 *                    returned by the last call to \ref Endpoint_AcquireBank().
+			 */
+			static inline void Endpoint_CommitBank(const uint16_t Bytes) ATTR_ALWAYS_INLINE;
+			static inline void Endpoint_CommitBank(const uint16_t Bytes)
+			{
+				USB_Endpoint_SelectedFIFO->Position += Bytes;
+			}
+
 			/** Reads two bytes from the currently selected endpoint's bank in little endian format, for OUT
 			 *  direction endpoints.
 			 *
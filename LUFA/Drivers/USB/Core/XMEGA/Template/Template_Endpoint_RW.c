@@ -69,10 +69,42 @@ uint8_t TEMPLATE_FUNC_NAME (TEMPLATE_BUFFER_TYPE const Buffer,
 		}
 		else
 		{
-			TEMPLATE_TRANSFER_BYTE(DataStream);
-			TEMPLATE_BUFFER_MOVE(DataStream, 1);
-			Length--;
-			BytesInTransfer++;
+			/* Transfer the largest run of bytes the current bank can accept or supply in one go, so that the bank
+			 * status only needs to be checked once per bank rather than once per byte */
+			uint16_t BytesInBlock = TEMPLATE_BYTES_IN_BANK();
+
+			if (BytesInBlock > Length)
+			  BytesInBlock = Length;
+			else if (!(BytesInBlock))
+			  BytesInBlock = 1;
+
+			Length          -= BytesInBlock;
+			BytesInTransfer += BytesInBlock;
+
+			#if defined(TEMPLATE_TRANSFER_BLOCK)
+			TEMPLATE_TRANSFER_BLOCK(DataStream, BytesInBlock);
+			TEMPLATE_BUFFER_MOVE(DataStream, BytesInBlock);
+			#else
+			while (BytesInBlock >= 4)
+			{
+				TEMPLATE_TRANSFER_BYTE(DataStream);
+				TEMPLATE_BUFFER_MOVE(DataStream, 1);
+				TEMPLATE_TRANSFER_BYTE(DataStream);
+				TEMPLATE_BUFFER_MOVE(DataStream, 1);
+				TEMPLATE_TRANSFER_BYTE(DataStream);
+				TEMPLATE_BUFFER_MOVE(DataStream, 1);
+				TEMPLATE_TRANSFER_BYTE(DataStream);
+				TEMPLATE_BUFFER_MOVE(DataStream, 1);
+
+				BytesInBlock -= 4;
+			}
+
+			while (BytesInBlock--)
+			{
+				TEMPLATE_TRANSFER_BYTE(DataStream);
+				TEMPLATE_BUFFER_MOVE(DataStream, 1);
+			}
+			#endif
 		}
 	}
 
@@ -82,6 +114,8 @@ uint8_t TEMPLATE_FUNC_NAME (TEMPLATE_BUFFER_TYPE const Buffer,
 #undef TEMPLATE_FUNC_NAME
 #undef TEMPLATE_BUFFER_TYPE
 #undef TEMPLATE_TRANSFER_BYTE
+#undef TEMPLATE_TRANSFER_BLOCK
+#undef TEMPLATE_BYTES_IN_BANK
 #undef TEMPLATE_CLEAR_ENDPOINT
 #undef TEMPLATE_BUFFER_OFFSET
 #undef TEMPLATE_BUFFER_MOVE
@@ -0,0 +1,87 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *  \brief Interrupt Management Driver for the simulated HOSTSIM architecture.
+ *
+ *  Interrupt management driver for the simulated HOSTSIM architecture, providing the emulated global
+ *  interrupt enable flag used by the library's global interrupt control functions.
+ */
+
+/** \ingroup Group_PlatformDrivers_HOSTSIM
+ *  \defgroup Group_PlatformDrivers_HOSTSIMInterrupts Interrupt Management Driver - LUFA/Platform/HOSTSIM/InterruptManagement.h
+ *  \brief Interrupt Management Driver for the simulated HOSTSIM architecture.
+ *
+ *  \section Sec_Dependencies Module Source Dependencies
+ *  The following files must be built with any user project that uses this module:
+ *    - LUFA/Platform/HOSTSIM/InterruptManagement.c <i>(Makefile source module name: LUFA_SRC_PLATFORM)</i>
+ *
+ *  \section Sec_ModDescription Module Description
+ *  The HOSTSIM architecture has no interrupt controller; simulated peripherals instead call their interrupt
+ *  service routines directly from the thread of execution that raised the event, once the emulated global
+ *  interrupt flag is set. Critical sections created with \ref GetGlobalInterruptMask(), \ref GlobalInterruptDisable()
+ *  and \ref SetGlobalInterruptMask() therefore defer simulated interrupts in the same manner as on real hardware.
+ *
+ *  @{
+ */
+
+#ifndef _HOSTSIM_INTERRUPT_MANAGEMENT_H_
+#define _HOSTSIM_INTERRUPT_MANAGEMENT_H_
+
+	/* Includes: */
+		#include "../../Common/Common.h"
+
+	/* Enable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			extern "C" {
+		#endif
+
+	/* Public Interface - May be used in end-application: */
+		/* Inline Functions: */
+			/** Determines if the emulated global interrupt flag is currently set, so that a simulated peripheral
+			 *  may deliver a pending interrupt to its service routine.
+			 *
+			 *  \return Boolean \c true if simulated interrupts may currently be serviced, \c false otherwise.
+			 */
+			static inline bool INTC_AreInterruptsEnabled(void) ATTR_ALWAYS_INLINE ATTR_WARN_UNUSED_RESULT;
+			static inline bool INTC_AreInterruptsEnabled(void)
+			{
+				return (HOSTSIM_GlobalInterruptState ? true : false);
+			}
+
+	/* Disable C linkage for C++ Compilers: */
+		#if defined(__cplusplus)
+			}
+		#endif
+
+#endif
+
+/** @} */
+
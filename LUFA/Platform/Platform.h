@@ -48,6 +48,7 @@
  *  The following files must be built with any user project that uses this module:
  *    - <b>UC3 Architecture Only:</b> LUFA/Platform/UC3/InterruptManagement.c <i>(Makefile source module name: LUFA_SRC_PLATFORM)</i> 
  *    - <b>UC3 Architecture Only:</b> LUFA/Platform/UC3/Exception.S <i>(Makefile source module name: LUFA_SRC_PLATFORM)</i>
+ *    - <b>HOSTSIM Architecture Only:</b> LUFA/Platform/HOSTSIM/InterruptManagement.c <i>(Makefile source module name: LUFA_SRC_PLATFORM)</i>
  *
  *  \section Sec_ModDescription Module Description
  *  Device-specific hardware platform drivers, for low level hardware configuration and management. The platform
@@ -74,6 +75,8 @@
 			#include "UC3/InterruptManagement.h"
 		#elif (ARCH == ARCH_XMEGA)
 			#include "XMEGA/ClockManagement.h"
+		#elif (ARCH == ARCH_HOSTSIM)
+			#include "HOSTSIM/InterruptManagement.h"
 		#endif
 
 #endif
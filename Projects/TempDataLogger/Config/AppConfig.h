@@ -45,4 +45,7 @@
 
 //	#define DUMMY_RTC
 
+	#define DISK_CACHE_SECTORS      4
+	#define DISK_CACHE_WRITE_BACK
+
 #endif
\ No newline at end of file
@@ -53,6 +53,9 @@
 		#endif
 
 	/* Defines: */
+		/** Value for the DeviceType entry in the SCSI_Inquiry_Response_t enum, indicating a Block Media device. */
+		#define DEVICE_TYPE_BLOCK                   0x00
+
 		/** Total number of bytes of the storage medium, comprised of one or more Dataflash ICs. */
 		#define VIRTUAL_MEMORY_BYTES                ((uint32_t)DATAFLASH_PAGES * DATAFLASH_PAGE_SIZE * DATAFLASH_TOTALCHIPS)
 
@@ -66,11 +69,42 @@
 		 */
 		#define VIRTUAL_MEMORY_BLOCKS               (VIRTUAL_MEMORY_BYTES / VIRTUAL_MEMORY_BLOCK_SIZE)
 
+	/* Private Interface - For use in library only: */
+		#if defined(INCLUDE_FROM_DATAFLASHMANAGER_C)
+			/* Macros: */
+				/** Bit in the Dataflash IC masks for the IC holding the given page, matching the interleaving of pages
+				 *  across ICs by \c Dataflash_SelectChipFromPage().
+				 */
+				#define DATAFLASHMANAGER_CHIP_BIT(PageAddress)  (1 << ((PageAddress) % DATAFLASH_TOTALCHIPS))
+
+			/* Function Prototypes: */
+				static void DataflashManager_BeginPageWrite(const uint16_t PageAddress,
+				                                            const uint16_t PageByte,
+				                                            const bool PreservePage);
+				static void DataflashManager_EndPageWrite(const uint16_t PageAddress);
+				static void DataflashManager_BeginPageRead(const uint16_t PageAddress,
+				                                           const uint16_t PageByte);
+
+				static bool DataflashManager_ReadLUNBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                           const MS_Device_LUN_t* const LUN,
+				                                           const uint32_t BlockAddress,
+				                                           const uint16_t TotalBlocks);
+				static bool DataflashManager_WriteLUNBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+				                                            const MS_Device_LUN_t* const LUN,
+				                                            const uint32_t BlockAddress,
+				                                            const uint16_t TotalBlocks);
+				static bool DataflashManager_SelfTestLUN(const MS_Device_LUN_t* const LUN);
+		#endif
+
+	/* External Variables: */
+		extern const MS_Device_BlockDevice_t DataflashManager_BlockDevice;
+		extern const SCSI_Inquiry_Response_t DataflashManager_InquiryData;
+
 	/* Function Prototypes: */
-		void DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+		bool DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
 		                                  const uint32_t BlockAddress,
 		                                  uint16_t TotalBlocks);
-		void DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+		bool DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
 		                                 const uint32_t BlockAddress,
 		                                 uint16_t TotalBlocks);
 		void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
@@ -14,6 +14,8 @@ DSTATUS disk_initialize (
 	BYTE drv				/* Physical drive number (0..) */
 )
 {
+	/* Drop any sectors cached from before the (re)mount, the disk may have been changed by the USB host since */
+	DiskCache_Invalidate();
 	return FR_OK;
 }
 
@@ -41,7 +43,7 @@ DRESULT disk_read (
 	BYTE count		/* Number of sectors to read (1..128) */
 )
 {
-	DataflashManager_ReadBlocks_RAM(sector, count, buff);
+	DiskCache_ReadSectors(sector, count, buff);
 	return RES_OK;
 }
 
@@ -58,7 +60,7 @@ DRESULT disk_write (
 	BYTE count			/* Number of sectors to write (1..128) */
 )
 {
-	DataflashManager_WriteBlocks_RAM(sector, count, buff);
+	DiskCache_WriteSectors(sector, count, buff);
 	return RES_OK;
 }
 #endif /* _READONLY */
@@ -75,7 +77,10 @@ DRESULT disk_ioctl (
 )
 {
 	if (ctrl == CTRL_SYNC)
-	  return RES_OK;
+	{
+		DiskCache_Flush();
+		return RES_OK;
+	}
 	else
 	  return RES_PARERR;
 }
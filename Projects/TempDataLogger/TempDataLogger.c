@@ -36,6 +36,17 @@
 
 #include "TempDataLogger.h"
 
+/** Logical unit of the Mass Storage interface, backed by the board Dataflash. */
+static const MS_Device_LUN_t Disk_LUN =
+	{
+		.BlockDevice = &DataflashManager_BlockDevice,
+		.BlockOffset = 0,
+		.TotalBlocks = VIRTUAL_MEMORY_BLOCKS,
+		.BlockSize   = VIRTUAL_MEMORY_BLOCK_SIZE,
+		.ReadOnly    = DISK_READ_ONLY,
+		.InquiryData = &DataflashManager_InquiryData,
+	};
+
 /** LUFA Mass Storage Class driver interface configuration and state information. This structure is
  *  passed to all Mass Storage Class driver functions, so that multiple instances of the same class
  *  within a device can be differentiated from one another.
@@ -58,6 +69,7 @@ USB_ClassInfo_MS_Device_t Disk_MS_Interface =
 						.Banks             = 1,
 					},
 				.TotalLUNs                 = 1,
+				.LUNs                      = &Disk_LUN,
 			},
 	};
 
@@ -267,7 +279,7 @@ bool CALLBACK_MS_Device_SCSICommandReceived(USB_ClassInfo_MS_Device_t* const MSI
 	bool CommandSuccess;
 
 	LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
-	CommandSuccess = SCSI_DecodeSCSICommand(MSInterfaceInfo);
+	CommandSuccess = MS_Device_ProcessSCSICommand(MSInterfaceInfo);
 	LEDs_SetAllLEDs(LEDMASK_USB_READY);
 
 	return CommandSuccess;
@@ -45,7 +45,6 @@
 
 		#include "Descriptors.h"
 
-		#include "Lib/SCSI.h"
 		#include "Lib/DataflashManager.h"
 		#include "Lib/FATFs/ff.h"
 		#include "Lib/DS1307.h"
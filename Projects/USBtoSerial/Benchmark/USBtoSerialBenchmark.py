@@ -0,0 +1,79 @@
+#! /usr/bin/python
+
+#             LUFA Library
+#     Copyright (C) Dean Camera, 2012.
+#
+#  dean [at] fourwalledcubicle [dot] com
+#           www.lufa-lib.org
+
+# Throughput benchmark for the USBtoSerial project. With the bridge's USART
+# TX and RX pins wired together, a pseudo-random block of data is written to
+# the virtual serial port at each of the standard baud rates and read back
+# again, and the achieved throughput and any lost or corrupted bytes are
+# reported. Requires the pySerial module.
+#
+# Usage: USBtoSerialBenchmark.py <serial port> [bytes per baud rate]
+
+import random
+import sys
+import threading
+import time
+
+import serial
+
+STANDARD_BAUD_RATES = [9600, 19200, 38400, 57600, 115200, 230400, 250000,
+                       500000, 1000000, 2000000]
+
+
+def run_benchmark(port_name, baud_rate, total_bytes):
+	port = serial.Serial(port_name, baud_rate, timeout=0.5)
+	port.reset_input_buffer()
+
+	test_data = bytes(bytearray(random.getrandbits(8) for _ in range(total_bytes)))
+	received  = bytearray()
+
+	# Write from a separate thread so that the read side keeps draining the
+	# bridge while the host is still sending, as a real full duplex link would
+	writer = threading.Thread(target=port.write, args=(test_data,))
+
+	start_time = time.time()
+	writer.start()
+
+	# Allow twice the theoretical line time (10 bits per character) before
+	# giving up on the remaining bytes
+	deadline = start_time + 1 + ((total_bytes * 10 * 2.0) / baud_rate)
+	while (len(received) < total_bytes) and (time.time() < deadline):
+		received.extend(port.read(total_bytes - len(received)))
+
+	elapsed = time.time() - start_time
+	writer.join()
+	port.close()
+
+	errors = sum(1 for (a, b) in zip(bytearray(test_data), received) if a != b)
+	return (len(received), errors, elapsed)
+
+
+def main():
+	if len(sys.argv) < 2:
+		print("Usage: %s <serial port> [bytes per baud rate]" % sys.argv[0])
+		return 1
+
+	port_name = sys.argv[1]
+	fixed_length = int(sys.argv[2]) if len(sys.argv) > 2 else None
+
+	print("%10s %10s %10s %12s %10s" % ("Baud", "Bytes", "Lost", "Corrupted", "KB/s"))
+
+	for baud_rate in STANDARD_BAUD_RATES:
+		# Default to roughly two seconds of line time at each rate
+		total_bytes = fixed_length or max(1024, baud_rate // 5)
+
+		(received, errors, elapsed) = run_benchmark(port_name, baud_rate, total_bytes)
+
+		print("%10d %10d %10d %12d %10.1f" % (baud_rate, total_bytes, total_bytes - received,
+		                                      errors, (received / 1024.0) / elapsed))
+
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())
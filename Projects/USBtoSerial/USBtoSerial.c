@@ -37,16 +37,31 @@
 #include "USBtoSerial.h"
 
 /** Circular buffer to hold data from the host before it is sent to the device via the serial port. */
-static RingBuffer_t USBtoUSART_Buffer;
+static SPSCRingBuffer_t USBtoUSART_Buffer;
 
 /** Underlying data buffer for \ref USBtoUSART_Buffer, where the stored bytes are located. */
-static uint8_t      USBtoUSART_Buffer_Data[128];
+static uint8_t          USBtoUSART_Buffer_Data[128];
 
 /** Circular buffer to hold data from the serial port before it is sent to the host. */
-static RingBuffer_t USARTtoUSB_Buffer;
+static SPSCRingBuffer_t USARTtoUSB_Buffer;
 
 /** Underlying data buffer for \ref USARTtoUSB_Buffer, where the stored bytes are located. */
-static uint8_t      USARTtoUSB_Buffer_Data[128];
+static uint8_t          USARTtoUSB_Buffer_Data[128];
+
+/** Number of bytes which must be waiting in \ref USARTtoUSB_Buffer before a packet is sent to the host without waiting for
+ *  the flush timeout, set from the current serial line encoding.
+ */
+static volatile uint8_t USARTtoUSB_FlushThreshold = 1;
+
+/** Number of USB frames left before any bytes waiting in \ref USARTtoUSB_Buffer are sent to the host regardless of the
+ *  flush threshold, decremented on each Start Of Frame event.
+ */
+static volatile uint8_t USARTtoUSB_FlushTimer;
+
+/** Indicates that the last packet sent to the host was full, and must be followed by a short or Zero Length Packet (ZLP)
+ *  once the buffered data runs out so that the host knows the transfer has ended.
+ */
+static bool USARTtoUSB_ZLPPending;
 
 /** LUFA CDC Class driver interface configuration and state information. This structure is
  *  passed to all CDC Class driver functions, so that multiple instances of the same class
@@ -86,64 +101,104 @@ int main(void)
 {
 	SetupHardware();
 
-	RingBuffer_InitBuffer(&USBtoUSART_Buffer, USBtoUSART_Buffer_Data, sizeof(USBtoUSART_Buffer_Data));
-	RingBuffer_InitBuffer(&USARTtoUSB_Buffer, USARTtoUSB_Buffer_Data, sizeof(USARTtoUSB_Buffer_Data));
+	SPSCRingBuffer_InitBuffer(&USBtoUSART_Buffer, USBtoUSART_Buffer_Data, sizeof(USBtoUSART_Buffer_Data));
+	SPSCRingBuffer_InitBuffer(&USARTtoUSB_Buffer, USARTtoUSB_Buffer_Data, sizeof(USARTtoUSB_Buffer_Data));
 
 	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
 	GlobalInterruptEnable();
 
 	for (;;)
 	{
-		/* Only try to read in bytes from the CDC interface if the transmit buffer is not full */
-		if (!(RingBuffer_IsFull(&USBtoUSART_Buffer)))
+		if (USB_DeviceState == DEVICE_STATE_Configured)
 		{
-			int16_t ReceivedByte = CDC_Device_ReceiveByte(&VirtualSerial_CDC_Interface);
-
-			/* Read bytes from the USB OUT endpoint into the USART transmit buffer */
-			if (!(ReceivedByte < 0))
-			  RingBuffer_Insert(&USBtoUSART_Buffer, ReceivedByte);
+			USBtoUSART_ReceivePacket();
+			USARTtoUSB_SendPacket();
 		}
 
-		/* Check if the UART receive buffer flush timer has expired or the buffer is nearly full */
-		uint16_t BufferCount = RingBuffer_GetCount(&USARTtoUSB_Buffer);
-		if ((TIFR0 & (1 << TOV0)) || (BufferCount > (uint8_t)(sizeof(USARTtoUSB_Buffer_Data) * .75)))
-		{
-			Endpoint_SelectEndpoint(VirtualSerial_CDC_Interface.Config.DataINEndpoint.Address);
-			
-			/* Check if a packet is already enqueued to the host - if so, we shouldn't try to send more data
-			 * until it completes as there is a chance nothing is listening and a lengthy timeout could occur */
-			if (Endpoint_IsINReady())
-			{
-				/* Clear flush timer expiry flag */
-				TIFR0 |= (1 << TOV0);
-			
-				/* Never send more than one bank size less one byte to the host at a time, so that we don't block
-				 * while a Zero Length Packet (ZLP) to terminate the transfer is sent if the host isn't listening */
-				uint8_t BytesToSend = MIN(BufferCount, (CDC_TXRX_EPSIZE - 1));
-
-				/* Read bytes from the USART receive buffer into the USB IN endpoint */
-				while (BytesToSend--)
-				{
-					/* Try to send the next byte of data to the host, abort if there is an error without dequeuing */
-					if (CDC_Device_SendByte(&VirtualSerial_CDC_Interface,
-											RingBuffer_Peek(&USARTtoUSB_Buffer)) != ENDPOINT_READYWAIT_NoError)
-					{
-						break;
-					}
+		CDC_Device_USBTask(&VirtualSerial_CDC_Interface);
+		USB_USBTask();
+	}
+}
 
-					/* Dequeue the already sent byte from the buffer now we have confirmed that no transmission error occurred */
-					RingBuffer_Remove(&USARTtoUSB_Buffer);
-				}
-			}
-		}
+/** Reads the next packet of data from the host into the USB to USART buffer once there is room for all of it, and
+ *  starts the interrupt driven transmission of the buffered data through the USART.
+ */
+void USBtoUSART_ReceivePacket(void)
+{
+	Endpoint_SelectEndpoint(VirtualSerial_CDC_Interface.Config.DataOUTEndpoint.Address);
 
-		/* Load the next byte from the USART transmit buffer into the USART */
-		if (!(RingBuffer_IsEmpty(&USBtoUSART_Buffer)))
-		  Serial_SendByte(RingBuffer_Remove(&USBtoUSART_Buffer));
+	if (!(Endpoint_IsOUTReceived()))
+	  return;
 
-		CDC_Device_USBTask(&VirtualSerial_CDC_Interface);
-		USB_USBTask();
+	uint16_t BytesInPacket = Endpoint_BytesInEndpoint();
+
+	/* Leave the packet in the endpoint until it can be buffered whole, so that the host is NAKed while the USART catches up */
+	if (BytesInPacket > SPSCRingBuffer_GetFreeCount(&USBtoUSART_Buffer))
+	  return;
+
+	/* Copy the packet straight into the buffer's storage, which may take two runs if it wraps around the end */
+	while (BytesInPacket)
+	{
+		uint16_t SpanLength;
+		uint8_t* Span = SPSCRingBuffer_GetWriteSpan(&USBtoUSART_Buffer, &SpanLength);
+
+		SpanLength     = MIN(SpanLength, BytesInPacket);
+		BytesInPacket -= SpanLength;
+
+		for (uint16_t i = 0; i < SpanLength; i++)
+		  Span[i] = Endpoint_Read_8();
+
+		SPSCRingBuffer_CommitWrite(&USBtoUSART_Buffer, SpanLength);
 	}
+
+	Endpoint_ClearOUT();
+
+	/* Enable the USART data register empty interrupt so that the ISR starts feeding the buffered data to the USART */
+	UCSR1B |= (1 << UDRIE1);
+}
+
+/** Sends the data waiting in the USART to USB buffer to the host once at least the flush threshold's worth of bytes are
+ *  waiting, or once the flush timer has expired with any bytes waiting.
+ */
+void USARTtoUSB_SendPacket(void)
+{
+	uint16_t BufferCount = SPSCRingBuffer_GetCount(&USARTtoUSB_Buffer);
+
+	if (BufferCount < USARTtoUSB_FlushThreshold)
+	{
+		if (USARTtoUSB_FlushTimer || !(BufferCount || USARTtoUSB_ZLPPending))
+		  return;
+	}
+
+	Endpoint_SelectEndpoint(VirtualSerial_CDC_Interface.Config.DataINEndpoint.Address);
+
+	/* Check if a packet is already enqueued to the host - if so, we shouldn't try to send more data
+	 * until it completes as there is a chance nothing is listening and a lengthy timeout could occur */
+	if (!(Endpoint_IsINReady()))
+	  return;
+
+	uint8_t BytesToSend = MIN(BufferCount, CDC_TXRX_EPSIZE);
+
+	/* A full packet must later be terminated by a short packet, which will be a ZLP if no more data arrives in the meantime */
+	USARTtoUSB_ZLPPending = (BytesToSend == CDC_TXRX_EPSIZE);
+
+	while (BytesToSend)
+	{
+		uint16_t SpanLength;
+		uint8_t* Span = SPSCRingBuffer_GetReadSpan(&USARTtoUSB_Buffer, &SpanLength);
+
+		SpanLength   = MIN(SpanLength, BytesToSend);
+		BytesToSend -= SpanLength;
+
+		for (uint16_t i = 0; i < SpanLength; i++)
+		  Endpoint_Write_8(Span[i]);
+
+		SPSCRingBuffer_CommitRead(&USARTtoUSB_Buffer, SpanLength);
+	}
+
+	Endpoint_ClearIN();
+
+	USARTtoUSB_FlushTimer = 1;
 }
 
 /** Configures the board hardware and chip peripherals for the demo's functionality. */
@@ -159,9 +214,6 @@ void SetupHardware(void)
 	/* Hardware Initialization */
 	LEDs_Init();
 	USB_Init();
-
-	/* Start the flush timer so that overflows occur rapidly to push received bytes to the USB interface */
-	TCCR0B = (1 << CS02);
 }
 
 /** Event handler for the library USB Connection event. */
@@ -183,6 +235,8 @@ void EVENT_USB_Device_ConfigurationChanged(void)
 
 	ConfigSuccess &= CDC_Device_ConfigureEndpoints(&VirtualSerial_CDC_Interface);
 
+	USB_Device_EnableSOFEvents();
+
 	LEDs_SetAllLEDs(ConfigSuccess ? LEDMASK_USB_READY : LEDMASK_USB_ERROR);
 }
 
@@ -192,6 +246,13 @@ void EVENT_USB_Device_ControlRequest(void)
 	CDC_Device_ProcessControlRequest(&VirtualSerial_CDC_Interface);
 }
 
+/** Event handler for the library USB Start Of Frame event, used to time out the USART to USB buffer flushes. */
+void EVENT_USB_Device_StartOfFrame(void)
+{
+	if (USARTtoUSB_FlushTimer)
+	  USARTtoUSB_FlushTimer--;
+}
+
 /** ISR to manage the reception of data from the serial port, placing received bytes into a circular buffer
  *  for later transmission to the host.
  */
@@ -199,8 +260,20 @@ ISR(USART1_RX_vect, ISR_BLOCK)
 {
 	uint8_t ReceivedByte = UDR1;
 
-	if (USB_DeviceState == DEVICE_STATE_Configured)
-	  RingBuffer_Insert(&USARTtoUSB_Buffer, ReceivedByte);
+	if ((USB_DeviceState == DEVICE_STATE_Configured) && !(SPSCRingBuffer_IsFull(&USARTtoUSB_Buffer)))
+	  SPSCRingBuffer_Insert(&USARTtoUSB_Buffer, ReceivedByte);
+}
+
+/** ISR to manage the transmission of data through the serial port, loading the next byte waiting in the USB to USART
+ *  buffer into the USART each time its data register empties and disabling itself once the buffer has been drained.
+ */
+ISR(USART1_UDRE_vect, ISR_BLOCK)
+{
+	if (!(SPSCRingBuffer_IsEmpty(&USBtoUSART_Buffer)))
+	  UDR1 = SPSCRingBuffer_Remove(&USBtoUSART_Buffer);
+
+	if (SPSCRingBuffer_IsEmpty(&USBtoUSART_Buffer))
+	  UCSR1B &= ~(1 << UDRIE1);
 }
 
 /** Event handler for the CDC Class driver Line Encoding Changed event.
@@ -210,6 +283,7 @@ ISR(USART1_RX_vect, ISR_BLOCK)
 void EVENT_CDC_Device_LineEncodingChanged(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
 {
 	uint8_t ConfigMask = 0;
+	uint8_t BitsPerChar;
 
 	switch (CDCInterfaceInfo->State.LineEncoding.ParityType)
 	{
@@ -221,8 +295,14 @@ void EVENT_CDC_Device_LineEncodingChanged(USB_ClassInfo_CDC_Device_t* const CDCI
 			break;
 	}
 
+	/* Count the start, data, parity and stop bits making up each character on the serial line */
+	BitsPerChar = (2 + CDCInterfaceInfo->State.LineEncoding.DataBits + (ConfigMask ? 1 : 0));
+
 	if (CDCInterfaceInfo->State.LineEncoding.CharFormat == CDC_LINEENCODING_TwoStopBits)
-	  ConfigMask |= (1 << USBS1);
+	{
+		ConfigMask |= (1 << USBS1);
+		BitsPerChar++;
+	}
 
 	switch (CDCInterfaceInfo->State.LineEncoding.DataBits)
 	{
@@ -249,5 +329,13 @@ void EVENT_CDC_Device_LineEncodingChanged(USB_ClassInfo_CDC_Device_t* const CDCI
 	UCSR1C = ConfigMask;
 	UCSR1A = (1 << U2X1);
 	UCSR1B = ((1 << RXCIE1) | (1 << TXEN1) | (1 << RXEN1));
+
+	/* Resume transmission of any data still waiting to be sent through the USART */
+	if (!(SPSCRingBuffer_IsEmpty(&USBtoUSART_Buffer)))
+	  UCSR1B |= (1 << UDRIE1);
+
+	/* Flush packets to the host as soon as a USB frame's worth of characters at the new baud rate have been received */
+	uint32_t CharsPerFrame = (CDCInterfaceInfo->State.LineEncoding.BaudRateBPS / ((uint32_t)BitsPerChar * 1000));
+	USARTtoUSB_FlushThreshold = MIN(MAX(CharsPerFrame, 1), CDC_TXRX_EPSIZE);
 }
 
@@ -46,7 +46,7 @@
 
 		#include <LUFA/Drivers/Board/LEDs.h>
 		#include <LUFA/Drivers/Peripheral/Serial.h>
-		#include <LUFA/Drivers/Misc/RingBuffer.h>
+		#include <LUFA/Drivers/Misc/SPSCRingBuffer.h>
 		#include <LUFA/Drivers/USB/USB.h>
 
 	/* Macros: */
@@ -64,11 +64,14 @@
 
 	/* Function Prototypes: */
 		void SetupHardware(void);
+		void USBtoUSART_ReceivePacket(void);
+		void USARTtoUSB_SendPacket(void);
 
 		void EVENT_USB_Device_Connect(void);
 		void EVENT_USB_Device_Disconnect(void);
 		void EVENT_USB_Device_ConfigurationChanged(void);
 		void EVENT_USB_Device_ControlRequest(void);
+		void EVENT_USB_Device_StartOfFrame(void);
 
 		void EVENT_CDC_Device_LineEncodingChanged(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo);
 
@@ -47,6 +47,7 @@
 	#define ENABLE_DHCP_SERVER
 	#define ENABLE_TELNET_SERVER
 	#define MAX_URI_LENGTH                50
+	#define DISK_CACHE_SECTORS            2
 
 	#define DEVICE_IP_ADDRESS             (uint8_t[]){ 10,   0,   0,   2}
 	#define DEVICE_NETMASK                (uint8_t[]){255, 255, 255,   0}
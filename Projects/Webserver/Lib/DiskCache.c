@@ -0,0 +1,294 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Least recently used sector cache, sitting between the FatFs disk I/O layer and the Dataflash manager. Single
+ *  sector accesses (the FAT, directory and partial file sectors FatFs repeatedly revisits) are held in the cache,
+ *  while multiple sector transfers of file data are passed straight through to the Dataflash so that they do not
+ *  evict the file system metadata.
+ *
+ *  When the DISK_CACHE_WRITE_BACK token is defined, single sector writes are only made to the cache and reach the
+ *  Dataflash when evicted or when \ref DiskCache_Flush() is called, otherwise all writes go through to the Dataflash
+ *  immediately.
+ */
+
+#define  INCLUDE_FROM_DISKCACHE_C
+#include "DiskCache.h"
+
+/** Sector data held in each cache entry. */
+static uint8_t  CacheData[DISK_CACHE_SECTORS][VIRTUAL_MEMORY_BLOCK_SIZE];
+
+/** Disk sector address of each cache entry. */
+static uint32_t CacheSector[DISK_CACHE_SECTORS];
+
+/** Mask of DISK_CACHE_FLAG_* flags for each cache entry. */
+static uint8_t  CacheFlags[DISK_CACHE_SECTORS];
+
+/** Number of cache accesses since each entry was last used, saturating at 0xFF. */
+static uint8_t  CacheAge[DISK_CACHE_SECTORS];
+
+/** Running hit and miss statistics of the cache. */
+static DiskCache_Statistics_t CacheStatistics;
+
+
+/** Reads one or more sectors through the cache. A single sector read is served from the cache if present, or fetched
+ *  into a newly allocated cache entry if not. Multiple sector reads copy out any cached sectors and read the remainder
+ *  directly from the Dataflash without allocating new entries.
+ *
+ *  \param[in]  Sector        Address of the first sector to read
+ *  \param[in]  TotalSectors  Number of sectors to read
+ *  \param[out] BufferPtr     Pointer to the destination buffer for the sector data
+ */
+void DiskCache_ReadSectors(const uint32_t Sector,
+                           const uint8_t TotalSectors,
+                           uint8_t* BufferPtr)
+{
+	if (TotalSectors == 1)
+	{
+		uint8_t Entry = DiskCache_FindSector(Sector);
+
+		if (Entry != DISK_CACHE_NO_ENTRY)
+		{
+			CacheStatistics.ReadHits++;
+		}
+		else
+		{
+			CacheStatistics.ReadMisses++;
+
+			Entry = DiskCache_AllocateEntry(Sector);
+			DataflashManager_ReadBlocks_RAM(Sector, 1, CacheData[Entry]);
+		}
+
+		memcpy(BufferPtr, CacheData[Entry], VIRTUAL_MEMORY_BLOCK_SIZE);
+		DiskCache_Touch(Entry);
+		return;
+	}
+
+	uint32_t CurrSector       = Sector;
+	uint8_t  SectorsRemaining = TotalSectors;
+
+	while (SectorsRemaining)
+	{
+		uint8_t Entry = DiskCache_FindSector(CurrSector);
+
+		if (Entry != DISK_CACHE_NO_ENTRY)
+		{
+			CacheStatistics.ReadHits++;
+
+			memcpy(BufferPtr, CacheData[Entry], VIRTUAL_MEMORY_BLOCK_SIZE);
+			DiskCache_Touch(Entry);
+
+			CurrSector++;
+			SectorsRemaining--;
+			BufferPtr += VIRTUAL_MEMORY_BLOCK_SIZE;
+			continue;
+		}
+
+		/* Gather the run of uncached sectors from the current sector so they can be read in a single Dataflash access */
+		uint8_t RunLength = 1;
+		while ((RunLength < SectorsRemaining) && (DiskCache_FindSector(CurrSector + RunLength) == DISK_CACHE_NO_ENTRY))
+		  RunLength++;
+
+		CacheStatistics.ReadMisses += RunLength;
+		DataflashManager_ReadBlocks_RAM(CurrSector, RunLength, BufferPtr);
+
+		CurrSector       += RunLength;
+		SectorsRemaining -= RunLength;
+		BufferPtr        += ((uint16_t)RunLength * VIRTUAL_MEMORY_BLOCK_SIZE);
+	}
+}
+
+/** Writes one or more sectors through the cache. When DISK_CACHE_WRITE_BACK is defined a single sector write is held in
+ *  the cache and marked as dirty, otherwise the sectors are written to the Dataflash and any cached copies are updated.
+ *
+ *  \param[in] Sector        Address of the first sector to write
+ *  \param[in] TotalSectors  Number of sectors to write
+ *  \param[in] BufferPtr     Pointer to the source buffer of sector data
+ */
+void DiskCache_WriteSectors(const uint32_t Sector,
+                            const uint8_t TotalSectors,
+                            const uint8_t* BufferPtr)
+{
+	#if defined(DISK_CACHE_WRITE_BACK)
+	if (TotalSectors == 1)
+	{
+		uint8_t Entry = DiskCache_FindSector(Sector);
+
+		if (Entry != DISK_CACHE_NO_ENTRY)
+		{
+			CacheStatistics.WriteHits++;
+		}
+		else
+		{
+			CacheStatistics.WriteMisses++;
+			Entry = DiskCache_AllocateEntry(Sector);
+		}
+
+		memcpy(CacheData[Entry], BufferPtr, VIRTUAL_MEMORY_BLOCK_SIZE);
+		CacheFlags[Entry] |= DISK_CACHE_FLAG_DIRTY;
+		DiskCache_Touch(Entry);
+		return;
+	}
+	#endif
+
+	DataflashManager_WriteBlocks_RAM(Sector, TotalSectors, BufferPtr);
+
+	/* Bring any cached copies of the written sectors up to date, they now match the Dataflash contents */
+	for (uint8_t SectorIndex = 0; SectorIndex < TotalSectors; SectorIndex++)
+	{
+		uint8_t Entry = DiskCache_FindSector(Sector + SectorIndex);
+
+		if (Entry == DISK_CACHE_NO_ENTRY)
+		{
+			CacheStatistics.WriteMisses++;
+			continue;
+		}
+
+		CacheStatistics.WriteHits++;
+
+		memcpy(CacheData[Entry], &BufferPtr[(uint16_t)SectorIndex * VIRTUAL_MEMORY_BLOCK_SIZE], VIRTUAL_MEMORY_BLOCK_SIZE);
+		CacheFlags[Entry] &= ~DISK_CACHE_FLAG_DIRTY;
+	}
+}
+
+/** Writes all dirty cache entries back to the Dataflash. This must be called before another party (such as a USB host
+ *  through the Mass Storage interface) accesses the Dataflash directly, so that it sees the latest file system state.
+ */
+void DiskCache_Flush(void)
+{
+	for (uint8_t Entry = 0; Entry < DISK_CACHE_SECTORS; Entry++)
+	{
+		if (!(CacheFlags[Entry] & DISK_CACHE_FLAG_DIRTY))
+		  continue;
+
+		DataflashManager_WriteBlocks_RAM(CacheSector[Entry], 1, CacheData[Entry]);
+		CacheFlags[Entry] &= ~DISK_CACHE_FLAG_DIRTY;
+
+		CacheStatistics.WriteBacks++;
+	}
+}
+
+/** Discards all cache entries, so that subsequent reads are fetched from the Dataflash. This must be called after the
+ *  Dataflash contents have been changed without going through the cache. Any dirty entries are discarded without being
+ *  written back, thus \ref DiskCache_Flush() should be called first if they are to be kept.
+ */
+void DiskCache_Invalidate(void)
+{
+	for (uint8_t Entry = 0; Entry < DISK_CACHE_SECTORS; Entry++)
+	{
+		CacheFlags[Entry] = 0;
+		CacheAge[Entry]   = 0;
+	}
+}
+
+/** Retrieves the current cache statistics.
+ *
+ *  \param[out] Statistics  Pointer to a location where the current cache statistics are to be stored
+ */
+void DiskCache_GetStatistics(DiskCache_Statistics_t* const Statistics)
+{
+	*Statistics = CacheStatistics;
+}
+
+/** Resets the cache statistics counters to zero. */
+void DiskCache_ResetStatistics(void)
+{
+	memset(&CacheStatistics, 0x00, sizeof(CacheStatistics));
+}
+
+/** Searches the cache for the given sector.
+ *
+ *  \param[in] Sector  Address of the sector to look for
+ *
+ *  \return Index of the cache entry holding the sector, or \c DISK_CACHE_NO_ENTRY if the sector is not cached
+ */
+static uint8_t DiskCache_FindSector(const uint32_t Sector)
+{
+	for (uint8_t Entry = 0; Entry < DISK_CACHE_SECTORS; Entry++)
+	{
+		if ((CacheFlags[Entry] & DISK_CACHE_FLAG_VALID) && (CacheSector[Entry] == Sector))
+		  return Entry;
+	}
+
+	return DISK_CACHE_NO_ENTRY;
+}
+
+/** Marks the given cache entry as the most recently used, ageing all other entries.
+ *
+ *  \param[in] Entry  Index of the cache entry that has been accessed
+ */
+static void DiskCache_Touch(const uint8_t Entry)
+{
+	for (uint8_t CurrEntry = 0; CurrEntry < DISK_CACHE_SECTORS; CurrEntry++)
+	{
+		if (CacheAge[CurrEntry] != 0xFF)
+		  CacheAge[CurrEntry]++;
+	}
+
+	CacheAge[Entry] = 0;
+}
+
+/** Allocates a cache entry for the given sector, reusing a free entry if one exists or evicting the least recently used
+ *  entry otherwise. A dirty entry is written back to the Dataflash before being reused. The contents of the returned
+ *  entry must be filled in by the caller.
+ *
+ *  \param[in] Sector  Address of the sector the entry is to hold
+ *
+ *  \return Index of the allocated cache entry
+ */
+static uint8_t DiskCache_AllocateEntry(const uint32_t Sector)
+{
+	uint8_t Victim = 0;
+
+	for (uint8_t Entry = 0; Entry < DISK_CACHE_SECTORS; Entry++)
+	{
+		if (!(CacheFlags[Entry] & DISK_CACHE_FLAG_VALID))
+		{
+			Victim = Entry;
+			break;
+		}
+
+		if (CacheAge[Entry] > CacheAge[Victim])
+		  Victim = Entry;
+	}
+
+	if (CacheFlags[Victim] & DISK_CACHE_FLAG_DIRTY)
+	{
+		DataflashManager_WriteBlocks_RAM(CacheSector[Victim], 1, CacheData[Victim]);
+		CacheStatistics.WriteBacks++;
+	}
+
+	CacheSector[Victim] = Sector;
+	CacheFlags[Victim]  = DISK_CACHE_FLAG_VALID;
+
+	return Victim;
+}
+
@@ -0,0 +1,100 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2012.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2012  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for DiskCache.c.
+ */
+
+#ifndef _DISK_CACHE_H_
+#define _DISK_CACHE_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <stdbool.h>
+		#include <string.h>
+
+		#include "Config/AppConfig.h"
+		#include "DataflashManager.h"
+
+	/* Defines: */
+		#if !defined(DISK_CACHE_SECTORS) || defined(__DOXYGEN__)
+			/** Number of disk sectors held in the sector cache, each of which occupies \ref VIRTUAL_MEMORY_BLOCK_SIZE
+			 *  bytes of SRAM. This may be overridden in the project's AppConfig.h header or makefile.
+			 */
+			#define DISK_CACHE_SECTORS              2
+		#endif
+
+	/* Preprocessor Checks: */
+		#if ((DISK_CACHE_SECTORS < 1) || (DISK_CACHE_SECTORS > 16))
+			#error DISK_CACHE_SECTORS must be between 1 and 16.
+		#endif
+
+	/* Type Defines: */
+		/** Type define for the sector cache statistics, retrieved via \ref DiskCache_GetStatistics(). */
+		typedef struct
+		{
+			uint32_t ReadHits; /**< Number of sector reads served from the cache. */
+			uint32_t ReadMisses; /**< Number of sector reads which had to be fetched from the Dataflash. */
+			uint32_t WriteHits; /**< Number of sector writes to a sector already held in the cache. */
+			uint32_t WriteMisses; /**< Number of sector writes to a sector not held in the cache. */
+			uint32_t WriteBacks; /**< Number of dirty sectors written back to the Dataflash. */
+		} DiskCache_Statistics_t;
+
+	/* Function Prototypes: */
+		void DiskCache_ReadSectors(const uint32_t Sector,
+		                           const uint8_t TotalSectors,
+		                           uint8_t* BufferPtr) ATTR_NON_NULL_PTR_ARG(3);
+		void DiskCache_WriteSectors(const uint32_t Sector,
+		                            const uint8_t TotalSectors,
+		                            const uint8_t* BufferPtr) ATTR_NON_NULL_PTR_ARG(3);
+		void DiskCache_Flush(void);
+		void DiskCache_Invalidate(void);
+		void DiskCache_GetStatistics(DiskCache_Statistics_t* const Statistics) ATTR_NON_NULL_PTR_ARG(1);
+		void DiskCache_ResetStatistics(void);
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#define DISK_CACHE_FLAG_VALID           (1 << 0)
+			#define DISK_CACHE_FLAG_DIRTY           (1 << 1)
+
+			#define DISK_CACHE_NO_ENTRY             0xFF
+
+		/* Function Prototypes: */
+			#if defined(INCLUDE_FROM_DISKCACHE_C)
+				static uint8_t DiskCache_FindSector(const uint32_t Sector);
+				static void    DiskCache_Touch(const uint8_t Entry);
+				static uint8_t DiskCache_AllocateEntry(const uint32_t Sector);
+			#endif
+	#endif
+
+#endif
+
@@ -12,7 +12,7 @@ extern "C" {
 #include "integer.h"
 #include "ff.h"
 
-#include "../DataflashManager.h"
+#include "../DiskCache.h"
 
 
 /* Status of Disk Functions */
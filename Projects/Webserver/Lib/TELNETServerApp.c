@@ -48,12 +48,16 @@ const char PROGMEM WelcomeHeader[] = "******************************************
 const char PROGMEM TELNETMenu[] = "\r\n"
                                   "  == Available Commands: ==\r\n"
                                   "     c) List Active TCP Connections\r\n"
+                                  "     d) Show Disk Cache Statistics\r\n"
                                   "  =========================\r\n"
                                   "\r\n>";
 
 /** Header to print before the current connections are printed to the client */
 const char PROGMEM CurrentConnectionsHeader[] = "\r\n* Current TCP Connections: *\r\n";
 
+/** Header to print before the disk sector cache statistics are printed to the client */
+const char PROGMEM DiskCacheStatisticsHeader[] = "\r\n* Disk Cache Statistics: *\r\n";
+
 /** Initialization function for the simple TELNET webserver. */
 void TELNETServerApp_Init(void)
 {
@@ -115,6 +119,9 @@ void TELNETServerApp_Callback(void)
 					case 'c':
 						TELNETServerApp_DisplayTCPConnections();
 						break;
+					case 'd':
+						TELNETServerApp_DisplayDiskCacheStatistics();
+						break;
 					default:
 						strcpy_P(AppData, PSTR("Invalid Command.\r\n"));
 						uip_send(AppData, strlen(AppData));
@@ -159,5 +166,27 @@ static void TELNETServerApp_DisplayTCPConnections(void)
 	uip_send(AppData, ResponseLen);
 }
 
+/** Sends the hit and miss statistics of the disk sector cache to the TELNET client. */
+static void TELNETServerApp_DisplayDiskCacheStatistics(void)
+{
+	char* const AppData    = (char*)uip_appdata;
+
+	DiskCache_Statistics_t CacheStatistics;
+	DiskCache_GetStatistics(&CacheStatistics);
+
+	strcpy_P(AppData, DiskCacheStatisticsHeader);
+
+	uint16_t ResponseLen = strlen(AppData);
+
+	ResponseLen += sprintf_P(&AppData[ResponseLen], PSTR("Read Hits: %lu, Read Misses: %lu\r\n"
+	                                                     "Write Hits: %lu, Write Misses: %lu\r\n"
+	                                                     "Write Backs: %lu\r\n"),
+	                         CacheStatistics.ReadHits, CacheStatistics.ReadMisses,
+	                         CacheStatistics.WriteHits, CacheStatistics.WriteMisses,
+	                         CacheStatistics.WriteBacks);
+
+	uip_send(AppData, ResponseLen);
+}
+
 #endif
 
@@ -44,6 +44,7 @@
 		#include <uip.h>
 
 		#include "Config/AppConfig.h"
+		#include "DiskCache.h"
 
 	/* Macros: */
 		/** TCP listen port for incoming TELNET traffic. */
@@ -65,6 +66,7 @@
 
 		#if defined(INCLUDE_FROM_TELNETSERVERAPP_C)
 			static void TELNETServerApp_DisplayTCPConnections(void);
+			static void TELNETServerApp_DisplayDiskCacheStatistics(void);
 		#endif
 
 #endif
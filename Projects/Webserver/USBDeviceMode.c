@@ -65,9 +65,21 @@ USB_ClassInfo_RNDIS_Device_t Ethernet_RNDIS_Interface_Device =
 					},
 				.AdapterVendorDescription       = "LUFA RNDIS Adapter",
 				.AdapterMACAddress              = {{0x02, 0x00, 0x02, 0x00, 0x02, 0x00}},
+				.MaxPacketsPerTransfer          = 4,
 			},
 	};
 
+/** Logical unit of the Mass Storage interface, backed by the board Dataflash. */
+static const MS_Device_LUN_t Disk_LUN =
+	{
+		.BlockDevice = &DataflashManager_BlockDevice,
+		.BlockOffset = 0,
+		.TotalBlocks = VIRTUAL_MEMORY_BLOCKS,
+		.BlockSize   = VIRTUAL_MEMORY_BLOCK_SIZE,
+		.ReadOnly    = DISK_READ_ONLY,
+		.InquiryData = &DataflashManager_InquiryData,
+	};
+
 /** LUFA Mass Storage Class driver interface configuration and state information. This structure is
  *  passed to all Mass Storage Class driver functions, so that multiple instances of the same class
  *  within a device can be differentiated from one another.
@@ -90,6 +102,7 @@ USB_ClassInfo_MS_Device_t Disk_MS_Interface =
 						.Banks                  = 1,
 					},
 				.TotalLUNs                 = 1,
+				.LUNs                      = &Disk_LUN,
 			},
 	};
 
@@ -149,9 +162,13 @@ bool CALLBACK_MS_Device_SCSICommandReceived(USB_ClassInfo_MS_Device_t* const MSI
 	bool CommandSuccess;
 
 	LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
-	CommandSuccess = SCSI_DecodeSCSICommand(MSInterfaceInfo);
+	CommandSuccess = MS_Device_ProcessSCSICommand(MSInterfaceInfo);
 	LEDs_SetAllLEDs(LEDMASK_USB_READY);
 
+	/* Host writes bypass the webserver's disk sector cache, so any cached copies are now potentially stale */
+	if (MSInterfaceInfo->State.CommandBlock.SCSICommandData[0] == SCSI_CMD_WRITE_10)
+	  DiskCache_Invalidate();
+
 	return CommandSuccess;
 }
 
@@ -42,7 +42,8 @@
 		#include "Webserver.h"
 		#include "Descriptors.h"
 		#include "Lib/uIPManagement.h"
-		#include "Lib/SCSI.h"
+		#include "Lib/DataflashManager.h"
+		#include "Lib/DiskCache.h"
 		#include "Config/AppConfig.h"
 		
 	/* External Variables: */
@@ -60,6 +60,7 @@ USB_ClassInfo_RNDIS_Host_t Ethernet_RNDIS_Interface_Host =
 						.Banks          = 1,
 					},
 				.HostMaxPacketSize      = UIP_CONF_BUFFER_SIZE,
+				.MaxPacketsPerTransfer  = 4,
 			},
 	};
 